@@ -0,0 +1,71 @@
+/**
+ * @file bench_append.c
+ * @brief Trames par seconde d'une série temporelle face à un dataset par trame
+ *
+ * Une matrice de capteur 32x32 est loguée à chaque cycle, soit dans une série
+ * (hdf5_log_array_append), soit sous un nom unique par cycle
+ * (hdf5_log_array_2d), ce qui crée un dataset et un attribut à chaque appel.
+ *
+ * Usage : bench_append [trames]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define SIDE 32
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Logue frames trames et renvoie le nombre de trames par seconde, fermeture comprise */
+static double run(int append, long frames) {
+    const char* filename = "bench_append.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL) {
+        return 0.0;
+    }
+
+    float frame[SIDE * SIDE];
+    size_t dims[2] = {SIDE, SIDE};
+    char name[32];
+    double start = now_seconds();
+    for (long i = 0; i < frames; i++) {
+        for (int j = 0; j < SIDE * SIDE; j++) {
+            frame[j] = (float)(i % 100) + (float)j * 0.01f;
+        }
+        if (append) {
+            hdf5_log_array_append(logger, "/bench", "sensor", frame, 2, dims, 0);
+        } else {
+            snprintf(name, sizeof(name), "sensor_%ld", i);
+            hdf5_log_array_2d(logger, "/bench", name, frame, SIDE, SIDE, 0);
+        }
+    }
+    hdf5_logger_close(logger);
+    double seconds = now_seconds() - start;
+
+    remove(filename);
+    return (double)frames / seconds;
+}
+
+int main(int argc, char** argv) {
+    long frames = (argc > 1) ? atol(argv[1]) : 20000;
+    if (frames < 1) {
+        fprintf(stderr, "Usage : %s [trames]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    printf("%-28s %14s\n", "matrice 32x32", "trames/s");
+    printf("%-28s %14.0f\n", "un dataset par trame", run(0, frames));
+    printf("%-28s %14.0f\n", "série temporelle", run(1, frames));
+    return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file bench_arena.c
+ * @brief Débit du mode asynchrone et allocations système de 1 à N threads
+ *
+ * Chaque thread dépose des logs texte dans la file asynchrone. Affiche le
+ * débit, la part des enregistrements servis par un bloc réutilisé et le
+ * nombre de blocs demandés au système : il reste de l'ordre de la capacité
+ * de la file, quel que soit le nombre d'entrées.
+ *
+ * Usage : bench_arena [threads_max] [entrées_par_thread]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+typedef struct {
+    hdf5_logger_t* logger;
+    int index;
+    long entries;
+} worker_t;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void* worker_main(void* arg) {
+    worker_t* worker = (worker_t*)arg;
+    char message[64];
+
+    /* La pile d'erreurs HDF5 est propre à chaque thread */
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    for (long i = 0; i < worker->entries; i++) {
+        snprintf(message, sizeof(message), "thread %d entrée %ld", worker->index, i);
+        hdf5_log_text_to_group(worker->logger, "/bench/arena", HDF5_LOG_INFO, message);
+    }
+    return NULL;
+}
+
+/* Renvoie le débit en entrées par seconde et les compteurs de l'allocateur */
+static double run(int thread_count, long entries, hdf5_arena_stats_t* stats) {
+    const char* filename = "bench_arena.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init_async(filename, NULL);
+    if (logger == NULL) {
+        return 0.0;
+    }
+
+    pthread_t* threads = malloc((size_t)thread_count * sizeof(pthread_t));
+    worker_t* workers = malloc((size_t)thread_count * sizeof(worker_t));
+
+    double start = now_seconds();
+    for (int t = 0; t < thread_count; t++) {
+        workers[t].logger = logger;
+        workers[t].index = t;
+        workers[t].entries = entries;
+        pthread_create(&threads[t], NULL, worker_main, &workers[t]);
+    }
+    for (int t = 0; t < thread_count; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    hdf5_logger_flush(logger);
+    hdf5_logger_get_arena_stats(logger, stats);
+    hdf5_logger_close(logger);
+    double elapsed = now_seconds() - start;
+
+    free(workers);
+    free(threads);
+    remove(filename);
+
+    return (double)thread_count * (double)entries / elapsed;
+}
+
+int main(int argc, char** argv) {
+    int max_threads = (argc > 1) ? atoi(argv[1]) : 8;
+    long entries = (argc > 2) ? atol(argv[2]) : 100000;
+    if (max_threads < 1 || entries < 1) {
+        fprintf(stderr, "Usage : %s [threads_max] [entrées_par_thread]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    printf("%8s %16s %12s %16s %14s\n", "threads", "entrées/s", "réutilisés", "blocs système",
+           "pic (Kio)");
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        hdf5_arena_stats_t stats;
+        double rate = run(threads, entries, &stats);
+        double reused = (stats.allocations > 0)
+                        ? 100.0 * (double)stats.reused / (double)stats.allocations : 0.0;
+        printf("%8d %16.0f %11.2f%% %16llu %14zu\n", threads, rate, reused,
+               stats.system_allocations, stats.peak_bytes / 1024);
+
+        /* Toujours mesurer N lui-même, même s'il n'est pas une puissance de deux */
+        if (threads < max_threads && threads * 2 > max_threads) {
+            threads = max_threads / 2;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file bench_chunks.c
+ * @brief Débit d'écriture et de lecture des tableaux selon la forme des chunks
+ *
+ * Compare l'ancien découpage (20 éléments par dimension) aux formes choisies
+ * d'après une taille cible, pour un vecteur et une matrice de flottants.
+ *
+ * Usage : bench_chunks [côté_de_la_matrice]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Mesure l'écriture puis la relecture complète d'un tableau ; débits en Mo/s */
+static void run(const char* label, const float* data, int rank, const size_t* dims,
+                const hdf5_array_layout_t* layout) {
+    const char* filename = "bench_chunks.h5";
+    remove(filename);
+
+    size_t bytes = sizeof(float);
+    for (int i = 0; i < rank; i++) {
+        bytes *= dims[i];
+    }
+
+    double start = now_seconds();
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL) {
+        return;
+    }
+    hdf5_log_array_nd(logger, "/bench", "array", data, rank, dims, 0, layout);
+    hdf5_logger_close(logger);
+    double write_seconds = now_seconds() - start;
+
+    float* read_back = malloc(bytes);
+    start = now_seconds();
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t dataset_id = H5Dopen2(file_id, "/bench/array", H5P_DEFAULT);
+    H5Dread(dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_back);
+    H5Dclose(dataset_id);
+    H5Fclose(file_id);
+    double read_seconds = now_seconds() - start;
+    free(read_back);
+
+    double megabytes = (double)bytes / (1024.0 * 1024.0);
+    printf("%-32s %12.1f %12.1f\n", label, megabytes / write_seconds, megabytes / read_seconds);
+    remove(filename);
+}
+
+int main(int argc, char** argv) {
+    size_t side = (argc > 1) ? (size_t)atol(argv[1]) : 2048;
+    if (side < 16) {
+        fprintf(stderr, "Usage : %s [côté_de_la_matrice]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    /* Données faiblement compressibles, comme un signal de capteur */
+    size_t elements = side * side;
+    float* data = malloc(elements * sizeof(float));
+    unsigned int state = 12345u;
+    for (size_t i = 0; i < elements; i++) {
+        state = state * 1103515245u + 12345u;
+        data[i] = (float)(i % 512) + (float)(state >> 16) * 1e-4f;
+    }
+
+    hdf5_array_layout_t legacy = {HDF5_ACCESS_LEGACY, 0};
+    hdf5_array_layout_t row_scan = {HDF5_ACCESS_ROW_SCAN, 0};
+    hdf5_array_layout_t row_scan_1m = {HDF5_ACCESS_ROW_SCAN, 1 << 20};
+    hdf5_array_layout_t tile = {HDF5_ACCESS_TILE, 0};
+
+    printf("Mo/s, fermeture et ouverture du fichier comprises\n");
+    printf("%-32s %12s %12s\n", "tableau", "écriture", "lecture");
+
+    size_t vector[1] = {elements};
+    run("vecteur, ancien découpage", data, 1, vector, &legacy);
+    run("vecteur, 256 Kio", data, 1, vector, &row_scan);
+    run("vecteur, 1 Mio", data, 1, vector, &row_scan_1m);
+
+    size_t matrix[2] = {side, side};
+    run("matrice, ancien découpage", data, 2, matrix, &legacy);
+    run("matrice, lignes 256 Kio", data, 2, matrix, &row_scan);
+    run("matrice, tuiles 256 Kio", data, 2, matrix, &tile);
+
+    free(data);
+    return 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file bench_codecs.c
+ * @brief Débit et taux de compression de chaque codec sur des données représentatives
+ *
+ * Trois jeux de données : des logs texte, un signal de capteur en flottants et
+ * une image RGB. Pour chaque codec disponible, le débit est rapporté aux
+ * octets bruts (Mo/s) et le taux est le rapport entre octets bruts et octets
+ * stockés. LZ4 et Zstd ne sont mesurés que si leur greffon est trouvé
+ * (HDF5_PLUGIN_PATH).
+ *
+ * Usage : bench_codecs [entrées_texte]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define SIGNAL_ELEMENTS (4 * 1024 * 1024)
+#define IMAGE_SIDE 1024
+
+typedef struct {
+    const char* label;
+    hdf5_codec_policy_t policy;
+} codec_case_t;
+
+static const codec_case_t cases[] = {
+    {"aucun", {HDF5_CODEC_NONE, 0, 0, HDF5_PREDICT_NONE}},
+    {"deflate 1", {HDF5_CODEC_DEFLATE, 1, 0, HDF5_PREDICT_NONE}},
+    {"deflate 6", {HDF5_CODEC_DEFLATE, 6, 0, HDF5_PREDICT_NONE}},
+    {"shuffle + deflate 1", {HDF5_CODEC_DEFLATE, 1, 1, HDF5_PREDICT_NONE}},
+    {"shuffle + deflate 4", {HDF5_CODEC_DEFLATE, 4, 1, HDF5_PREDICT_NONE}},
+    {"lz4", {HDF5_CODEC_LZ4, 0, 0, HDF5_PREDICT_NONE}},
+    {"shuffle + lz4", {HDF5_CODEC_LZ4, 0, 1, HDF5_PREDICT_NONE}},
+    {"zstd 3", {HDF5_CODEC_ZSTD, 3, 0, HDF5_PREDICT_NONE}},
+    {"shuffle + zstd 3", {HDF5_CODEC_ZSTD, 3, 1, HDF5_PREDICT_NONE}},
+};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Octets stockés par les datasets d'un objet (groupe parcouru récursivement) */
+static herr_t add_storage(hid_t object_id, const char* name, const H5O_info_t* info, void* user_data) {
+    if (info->type == H5O_TYPE_DATASET) {
+        hid_t dataset_id = H5Dopen2(object_id, name, H5P_DEFAULT);
+        *(hsize_t*)user_data += H5Dget_storage_size(dataset_id);
+        H5Dclose(dataset_id);
+    }
+    return 0;
+}
+
+static hsize_t stored_bytes(const char* filename, const char* path) {
+    hsize_t total = 0;
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t object_id = H5Oopen(file_id, path, H5P_DEFAULT);
+    H5Ovisit(object_id, H5_INDEX_NAME, H5_ITER_INC, add_storage, &total);
+    H5Oclose(object_id);
+    H5Fclose(file_id);
+    return total;
+}
+
+static void print_result(const char* label, double raw_bytes, double seconds, hsize_t stored) {
+    printf("  %-22s %10.1f %8.2f\n", label, raw_bytes / (1024.0 * 1024.0) / seconds,
+           stored > 0 ? raw_bytes / (double)stored : 0.0);
+}
+
+static void run_text(const codec_case_t* c, long entries) {
+    const char* filename = "bench_codecs.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    hdf5_logger_set_codec(logger, HDF5_DATA_TEXT, &c->policy);
+
+    char message[128];
+    double raw = 0.0;
+    double start = now_seconds();
+    for (long i = 0; i < entries; i++) {
+        int length = snprintf(message, sizeof(message),
+                              "capteur %ld : température %.2f °C, état %s", i % 64,
+                              20.0 + (double)(i % 1000) * 0.01, (i % 7 == 0) ? "alerte" : "nominal");
+        hdf5_log_text_to_group(logger, "/bench/text", HDF5_LOG_INFO, message);
+        raw += (double)length;
+    }
+    hdf5_logger_close(logger);
+    double seconds = now_seconds() - start;
+
+    print_result(c->label, raw, seconds, stored_bytes(filename, "/bench/text"));
+    remove(filename);
+}
+
+static void run_dataset(const codec_case_t* c, hdf5_data_kind_t kind, const void* data) {
+    const char* filename = "bench_codecs.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    hdf5_logger_set_codec(logger, kind, &c->policy);
+
+    double raw;
+    double start = now_seconds();
+    if (kind == HDF5_DATA_NUMERIC) {
+        raw = (double)SIGNAL_ELEMENTS * sizeof(float);
+        hdf5_log_array_1d(logger, "/bench", "data", data, SIGNAL_ELEMENTS, 0);
+    } else {
+        raw = (double)IMAGE_SIDE * IMAGE_SIDE * 3;
+        hdf5_log_image(logger, "/bench", "data", data, IMAGE_SIDE, IMAGE_SIDE, 3);
+    }
+    hdf5_logger_close(logger);
+    double seconds = now_seconds() - start;
+
+    print_result(c->label, raw, seconds, stored_bytes(filename, "/bench"));
+    remove(filename);
+}
+
+int main(int argc, char** argv) {
+    long entries = (argc > 1) ? atol(argv[1]) : 200000;
+    if (entries < 1) {
+        fprintf(stderr, "Usage : %s [entrées_texte]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    /* Signal : sinusoïde lente quantifiée plus un bruit faible */
+    float* signal = malloc(SIGNAL_ELEMENTS * sizeof(float));
+    unsigned int state = 12345u;
+    for (long i = 0; i < SIGNAL_ELEMENTS; i++) {
+        state = state * 1103515245u + 12345u;
+        long phase = i % 4096;
+        float triangle = (float)((phase < 2048) ? phase : 4096 - phase);
+        signal[i] = triangle * 0.01f + (float)(state >> 24) * 1e-3f;
+    }
+
+    /* Image : dégradés et bruit de capteur sur les bits de poids faible */
+    unsigned char* image = malloc((size_t)IMAGE_SIDE * IMAGE_SIDE * 3);
+    for (size_t y = 0; y < IMAGE_SIDE; y++) {
+        for (size_t x = 0; x < IMAGE_SIDE; x++) {
+            state = state * 1103515245u + 12345u;
+            unsigned char* pixel = image + (y * IMAGE_SIDE + x) * 3;
+            pixel[0] = (unsigned char)((x / 4 + ((state >> 16) & 3)) & 0xFF);
+            pixel[1] = (unsigned char)((y / 4 + ((state >> 18) & 3)) & 0xFF);
+            pixel[2] = (unsigned char)(((x + y) / 8) & 0xFF);
+        }
+    }
+
+    size_t case_count = sizeof(cases) / sizeof(cases[0]);
+    const char* titles[3] = {"Logs texte", "Signal de capteur (float)", "Image RGB"};
+    for (int kind = 0; kind < HDF5_DATA_KIND_COUNT; kind++) {
+        printf("%s\n  %-22s %10s %8s\n", titles[kind], "codec", "Mo/s", "taux");
+        for (size_t i = 0; i < case_count; i++) {
+            if (!hdf5_codec_available(cases[i].policy.codec)) {
+                printf("  %-22s %19s\n", cases[i].label, "indisponible");
+                continue;
+            }
+            if (kind == HDF5_DATA_TEXT) {
+                run_text(&cases[i], entries);
+            } else {
+                run_dataset(&cases[i], (hdf5_data_kind_t)kind,
+                            (kind == HDF5_DATA_NUMERIC) ? (const void*)signal : (const void*)image);
+            }
+        }
+    }
+
+    free(image);
+    free(signal);
+    return 0;
+}
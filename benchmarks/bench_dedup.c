@@ -0,0 +1,95 @@
+/**
+ * @file bench_dedup.c
+ * @brief Déduplication : caméra immobile et étalonnage relogué
+ *
+ * Des images 640x480 RGB sont loguées sous des noms successifs ; la scène
+ * change toutes les N images (N = 1 : jamais deux images identiques). Une
+ * matrice d'étalonnage est reloguée à chaque image. Affiche le débit en
+ * images par seconde et la taille du fichier, avec et sans déduplication.
+ *
+ * Usage : bench_dedup [images] [images par scène]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define WIDTH 640
+#define HEIGHT 480
+#define CALIB 256
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void run(const char* label, int dedup, long images, long per_scene) {
+    const char* filename = "bench_dedup.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL || hdf5_logger_set_dedup(logger, dedup) < 0) {
+        return;
+    }
+
+    unsigned char* pixels = malloc((size_t)WIDTH * HEIGHT * 3);
+    double* calib = malloc(sizeof(double) * CALIB * CALIB);
+    if (pixels == NULL || calib == NULL) {
+        free(pixels);
+        free(calib);
+        hdf5_logger_close(logger);
+        return;
+    }
+    for (size_t i = 0; i < (size_t)CALIB * CALIB; i++) {
+        calib[i] = (double)i * 1e-3;
+    }
+
+    char name[32];
+    double start = now_seconds();
+    for (long n = 0; n < images; n++) {
+        /* Nouvelle scène : bruit de capteur différent */
+        if (n % per_scene == 0) {
+            unsigned int noise = (unsigned int)n * 2654435761u + 1;
+            for (size_t i = 0; i < (size_t)WIDTH * HEIGHT * 3; i++) {
+                noise = noise * 1103515245u + 12345u;
+                pixels[i] = (unsigned char)((i / 3 % WIDTH) / 3 + (noise >> 29));
+            }
+        }
+        snprintf(name, sizeof(name), "frame_%06ld", n);
+        hdf5_log_image(logger, "/camera", name, pixels, WIDTH, HEIGHT, 3);
+        hdf5_log_array_2d(logger, "/calib", "matrix", calib, CALIB, CALIB, HDF5_DTYPE_FLOAT64);
+    }
+    hdf5_dedup_stats_t stats = {0};
+    hdf5_logger_get_dedup_stats(logger, &stats);
+    hdf5_logger_close(logger);
+    double elapsed = now_seconds() - start;
+
+    struct stat info;
+    double size = (stat(filename, &info) == 0) ? (double)info.st_size / (1024.0 * 1024.0) : 0.0;
+    printf("  %-16s %10.1f %10.1f %10llu %12.1f\n", label, (double)images / elapsed, size,
+           stats.duplicates, (double)stats.bytes_saved / (1024.0 * 1024.0));
+
+    free(pixels);
+    free(calib);
+    remove(filename);
+}
+
+int main(int argc, char** argv) {
+    long images = (argc > 1) ? atol(argv[1]) : 200;
+    long per_scene = (argc > 2) ? atol(argv[2]) : 20;
+    if (images < 1 || per_scene < 1) {
+        fprintf(stderr, "Usage : %s [images] [images par scène]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    printf("%-18s %10s %10s %10s %12s\n", "", "images/s", "Mo", "doublons", "Mo évités");
+    run("sans", 0, images, per_scene);
+    run("déduplication", 1, images, per_scene);
+    return 0;
+}
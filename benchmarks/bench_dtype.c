@@ -0,0 +1,98 @@
+/**
+ * @file bench_dtype.c
+ * @brief Échantillons int16 stockés tels quels face à leur conversion en float
+ *
+ * Un convertisseur produit des blocs de 4096 échantillons int16 ajoutés à une
+ * série (hdf5_log_array_append), soit directement en HDF5_DTYPE_INT16, soit
+ * après conversion en float comme le demandait l'ancienne interface. Affiche
+ * le débit en échantillons par seconde et la taille du fichier, avec la
+ * compression par défaut.
+ *
+ * Usage : bench_dtype [blocs]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define BLOCK 4096
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Taille du fichier, en octets */
+static long file_size(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+/* Logue blocks blocs et renvoie les échantillons par seconde, fermeture comprise */
+static double run(int widen, long blocks, long* bytes) {
+    const char* filename = "bench_dtype.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL) {
+        return 0.0;
+    }
+
+    int16_t samples[BLOCK];
+    float widened[BLOCK];
+    size_t dims[1] = {BLOCK};
+    unsigned int noise = 12345;
+    double start = now_seconds();
+    for (long b = 0; b < blocks; b++) {
+        /* Signal lent et bruit sur les bits de poids faible, comme un ADC réel */
+        for (int i = 0; i < BLOCK; i++) {
+            noise = noise * 1103515245u + 12345u;
+            samples[i] = (int16_t)(((b * BLOCK + i) % 2048) * 8 + (int)((noise >> 16) & 15));
+        }
+        if (widen) {
+            for (int i = 0; i < BLOCK; i++) {
+                widened[i] = (float)samples[i];
+            }
+            hdf5_log_array_append(logger, "/adc", "samples", widened, 1, dims,
+                                  HDF5_DTYPE_FLOAT32);
+        } else {
+            hdf5_log_array_append(logger, "/adc", "samples", samples, 1, dims, HDF5_DTYPE_INT16);
+        }
+    }
+    hdf5_logger_close(logger);
+    double seconds = now_seconds() - start;
+
+    *bytes = file_size(filename);
+    remove(filename);
+    return (double)blocks * BLOCK / seconds;
+}
+
+int main(int argc, char** argv) {
+    long blocks = (argc > 1) ? atol(argv[1]) : 2000;
+    if (blocks < 1) {
+        fprintf(stderr, "Usage : %s [blocs]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    long native_bytes = 0;
+    long widened_bytes = 0;
+    double native = run(0, blocks, &native_bytes);
+    double widened = run(1, blocks, &widened_bytes);
+
+    printf("%-14s %18s %16s\n", "stockage", "échantillons/s", "fichier (Kio)");
+    printf("%-14s %18.0f %16ld\n", "int16 natif", native, native_bytes / 1024);
+    printf("%-14s %18.0f %16ld\n", "float converti", widened, widened_bytes / 1024);
+    return 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file bench_format.c
+ * @brief Compare snprintf + hdf5_log_text au formatage différé de hdf5_log_textf
+ *
+ * Mesure le temps par appel (fermeture du fichier comprise) et la taille du
+ * fichier produit pour un même message à plusieurs arguments.
+ *
+ * Usage : bench_format [entrées]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define MESSAGE_FORMAT "capteur %d : température %.2f °C, pression %u Pa, état %s"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static long file_size(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+/* Renvoie le temps moyen par appel en nanosecondes et la taille du fichier */
+static double run(long entries, int deferred, long* size) {
+    const char* filename = "bench_format.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL) {
+        return 0.0;
+    }
+
+    char message[256];
+    double start = now_seconds();
+    for (long i = 0; i < entries; i++) {
+        int sensor = (int)(i % 64);
+        double temperature = 20.0 + (double)(i % 1000) * 0.01;
+        unsigned int pressure = 101325u + (unsigned int)(i % 500);
+        const char* state = (i % 7 == 0) ? "alerte" : "nominal";
+        if (deferred) {
+            hdf5_log_textf_to_group(logger, "/bench/format", HDF5_LOG_INFO, MESSAGE_FORMAT,
+                                    sensor, temperature, pressure, state);
+        } else {
+            snprintf(message, sizeof(message), MESSAGE_FORMAT, sensor, temperature, pressure, state);
+            hdf5_log_text_to_group(logger, "/bench/format", HDF5_LOG_INFO, message);
+        }
+    }
+    hdf5_logger_close(logger);
+    double elapsed = now_seconds() - start;
+
+    *size = file_size(filename);
+    remove(filename);
+    return elapsed * 1e9 / (double)entries;
+}
+
+int main(int argc, char** argv) {
+    long entries = (argc > 1) ? atol(argv[1]) : 200000;
+    if (entries < 1) {
+        fprintf(stderr, "Usage : %s [entrées]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    long formatted_size = 0;
+    long deferred_size = 0;
+    double formatted = run(entries, 0, &formatted_size);
+    double deferred = run(entries, 1, &deferred_size);
+
+    printf("%ld entrées\n", entries);
+    printf("%-28s %12s %14s\n", "mode", "ns/appel", "octets fichier");
+    printf("%-28s %12.1f %14ld\n", "snprintf + hdf5_log_text", formatted, formatted_size);
+    printf("%-28s %12.1f %14ld\n", "hdf5_log_textf", deferred, deferred_size);
+    return 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file bench_image_stream.c
+ * @brief Images par seconde d'une séquence d'images face à un dataset par image
+ *
+ * Écrit des images RGB 160x120, d'abord une par dataset avec hdf5_log_image
+ * (création du dataset et de ses attributs à chaque image), puis dans une
+ * séquence extensible avec hdf5_log_image_frame. Affiche aussi la taille des
+ * fichiers obtenus. Sur de grandes images, la compression domine et les deux
+ * modes se rejoignent.
+ *
+ * Usage : bench_image_stream [images]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define FRAME_WIDTH 160
+#define FRAME_HEIGHT 120
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static double file_megabytes(const char* filename) {
+    struct stat st;
+    return (stat(filename, &st) == 0) ? (double)st.st_size / (1024.0 * 1024.0) : 0.0;
+}
+
+/* Écrit frames images et renvoie le nombre d'images par seconde */
+static double run(int sequence, const unsigned char* pixels, long frames, double* megabytes) {
+    const char* filename = "bench_image_stream.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL) {
+        return 0.0;
+    }
+
+    char name[32];
+    double start = now_seconds();
+    for (long i = 0; i < frames; i++) {
+        /* Décalage de la même image : chaque image diffère de la précédente */
+        const unsigned char* frame = pixels + (size_t)(i % 16) * 3;
+        if (sequence) {
+            hdf5_log_image_frame(logger, "/bench", "video", frame, FRAME_WIDTH, FRAME_HEIGHT, 3);
+        } else {
+            snprintf(name, sizeof(name), "frame_%ld", i);
+            hdf5_log_image(logger, "/bench", name, frame, FRAME_WIDTH, FRAME_HEIGHT, 3);
+        }
+    }
+    hdf5_logger_close(logger);
+    double seconds = now_seconds() - start;
+
+    *megabytes = file_megabytes(filename);
+    remove(filename);
+    return (double)frames / seconds;
+}
+
+int main(int argc, char** argv) {
+    long frames = (argc > 1) ? atol(argv[1]) : 500;
+    if (frames < 1) {
+        fprintf(stderr, "Usage : %s [images]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    /* Image de caméra : dégradés et bruit de capteur sur les bits de poids faible */
+    size_t bytes = (size_t)FRAME_WIDTH * FRAME_HEIGHT * 3 + 16 * 3;
+    unsigned char* pixels = malloc(bytes);
+    unsigned int state = 12345u;
+    for (size_t i = 0; i < bytes; i++) {
+        state = state * 1103515245u + 12345u;
+        size_t x = (i / 3) % FRAME_WIDTH;
+        size_t y = (i / 3) / FRAME_WIDTH;
+        pixels[i] = (unsigned char)(((x + y * (i % 3 + 1)) / 8 + ((state >> 16) & 3)) & 0xFF);
+    }
+
+    double per_image_mb = 0.0;
+    double sequence_mb = 0.0;
+    double per_image = run(0, pixels, frames, &per_image_mb);
+    double sequence = run(1, pixels, frames, &sequence_mb);
+
+    printf("%-22s %14s %12s\n", "mode", "images/s", "Mio");
+    printf("%-22s %14.1f %12.2f\n", "dataset par image", per_image, per_image_mb);
+    printf("%-22s %14.1f %12.2f\n", "séquence", sequence, sequence_mb);
+    printf("accélération : %.2fx\n", (per_image > 0.0) ? sequence / per_image : 0.0);
+
+    free(pixels);
+    return 0;
+}
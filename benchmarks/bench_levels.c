@@ -0,0 +1,91 @@
+/**
+ * @file bench_levels.c
+ * @brief Coût d'un site de log désactivé
+ *
+ * Compare, en nanosecondes par appel, un log écrit, un log rejeté par le seuil
+ * à l'appel de hdf5_log_textf, le même log derrière la macro HDF5_LOGF (un appel
+ * de hdf5_logger_is_enabled et une lecture atomique, arguments non évalués) et
+ * une boucle vide, ce à quoi se réduit une macro retirée à la compilation par
+ * HDF5_LOGGER_MIN_LEVEL.
+ *
+ * Usage : bench_levels [appels]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Argument coûteux à préparer : évité par la macro quand le log est rejeté */
+static double expensive(long i) {
+    return sqrt((double)i) * 1.5;
+}
+
+enum { MODE_WRITTEN, MODE_FILTERED_CALL, MODE_FILTERED_MACRO, MODE_EMPTY };
+
+static double run(hdf5_logger_t* logger, long calls, int mode) {
+    volatile long sink = 0;
+    double start = now_seconds();
+    for (long i = 0; i < calls; i++) {
+        switch (mode) {
+            case MODE_WRITTEN:
+                hdf5_log_textf(logger, HDF5_LOG_ERROR, "itération %ld valeur %f", i, expensive(i));
+                break;
+            case MODE_FILTERED_CALL:
+                hdf5_log_textf(logger, HDF5_LOG_DEBUG, "itération %ld valeur %f", i, expensive(i));
+                break;
+            case MODE_FILTERED_MACRO:
+                HDF5_LOGF(logger, HDF5_LOG_DEBUG, "itération %ld valeur %f", i, expensive(i));
+                break;
+            default:
+                break;
+        }
+        sink = i;
+    }
+    (void)sink;
+    return (now_seconds() - start) * 1e9 / (double)calls;
+}
+
+int main(int argc, char** argv) {
+    long calls = (argc > 1) ? atol(argv[1]) : 1000000;
+    if (calls < 1) {
+        fprintf(stderr, "Usage : %s [appels]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    const char* filename = "bench_levels.h5";
+    remove(filename);
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL) {
+        return 1;
+    }
+    hdf5_logger_set_min_level(logger, HDF5_LOG_INFO);
+
+    /* Les logs écrits sont moins nombreux : leur coût par appel ne dépend pas du nombre */
+    long written_calls = (calls > 100000) ? 100000 : calls;
+    double written = run(logger, written_calls, MODE_WRITTEN);
+    double filtered_call = run(logger, calls, MODE_FILTERED_CALL);
+    double filtered_macro = run(logger, calls, MODE_FILTERED_MACRO);
+    double empty = run(logger, calls, MODE_EMPTY);
+
+    hdf5_logger_close(logger);
+    remove(filename);
+
+    printf("%ld appels (niveau minimal compilé : %d)\n", calls, HDF5_LOGGER_MIN_LEVEL);
+    printf("%-36s %10s\n", "site de log", "ns/appel");
+    printf("%-36s %10.2f\n", "écrit (hdf5_log_textf)", written);
+    printf("%-36s %10.2f\n", "rejeté à l'appel (hdf5_log_textf)", filtered_call);
+    printf("%-36s %10.2f\n", "rejeté par la macro (HDF5_LOGF)", filtered_macro);
+    printf("%-36s %10.2f\n", "retiré à la compilation", empty);
+    return 0;
+}
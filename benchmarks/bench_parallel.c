@@ -0,0 +1,84 @@
+/**
+ * @file bench_parallel.c
+ * @brief Trames 4K par seconde selon le nombre de threads de compression
+ *
+ * Écrit des images RGB 3840x2160 compressées en deflate, d'abord par le
+ * pipeline HDF5 (1 thread), puis par les threads de compression et l'écriture
+ * directe des chunks. L'accélération attendue est presque linéaire jusqu'au
+ * nombre de cœurs.
+ *
+ * Usage : bench_parallel [trames] [threads_max]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define FRAME_WIDTH 3840
+#define FRAME_HEIGHT 2160
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Écrit frames trames et renvoie le nombre de trames par seconde */
+static double run(size_t threads, const unsigned char* pixels, long frames) {
+    const char* filename = "bench_parallel.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL || hdf5_logger_set_compression_threads(logger, threads) < 0) {
+        return 0.0;
+    }
+
+    char name[32];
+    double start = now_seconds();
+    for (long i = 0; i < frames; i++) {
+        snprintf(name, sizeof(name), "frame_%ld", i);
+        hdf5_log_image(logger, "/bench", name, pixels, FRAME_WIDTH, FRAME_HEIGHT, 3);
+    }
+    hdf5_logger_close(logger);
+    double seconds = now_seconds() - start;
+
+    remove(filename);
+    return (double)frames / seconds;
+}
+
+int main(int argc, char** argv) {
+    long frames = (argc > 1) ? atol(argv[1]) : 8;
+    long max_threads = (argc > 2) ? atol(argv[2]) : 8;
+    if (frames < 1 || max_threads < 1 || max_threads > HDF5_LOGGER_MAX_COMPRESSION_THREADS) {
+        fprintf(stderr, "Usage : %s [trames] [threads_max]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    /* Image de caméra : dégradés et bruit de capteur sur les bits de poids faible */
+    size_t bytes = (size_t)FRAME_WIDTH * FRAME_HEIGHT * 3;
+    unsigned char* pixels = malloc(bytes);
+    unsigned int state = 12345u;
+    for (size_t i = 0; i < bytes; i++) {
+        state = state * 1103515245u + 12345u;
+        size_t x = (i / 3) % FRAME_WIDTH;
+        size_t y = (i / 3) / FRAME_WIDTH;
+        pixels[i] = (unsigned char)(((x + y * (i % 3 + 1)) / 8 + ((state >> 16) & 3)) & 0xFF);
+    }
+
+    printf("%8s %14s %14s\n", "threads", "trames/s", "accélération");
+    double reference = 0.0;
+    for (long threads = 1; threads <= max_threads; threads *= 2) {
+        double rate = run((size_t)threads, pixels, frames);
+        if (threads == 1) {
+            reference = rate;
+        }
+        printf("%8ld %14.2f %13.2fx\n", threads, rate, (reference > 0.0) ? rate / reference : 0.0);
+    }
+
+    free(pixels);
+    return 0;
+}
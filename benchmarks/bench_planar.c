@@ -0,0 +1,118 @@
+/**
+ * @file bench_planar.c
+ * @brief Images en plans ou entrelacées : débit et taux de compression
+ *
+ * Des images 1280x720 RGB (dégradés propres à chaque canal, bruit de capteur)
+ * sont loguées avec les canaux entrelacés puis en plans, avec la compression
+ * par défaut (deflate 1) puis avec une prédiction par écart. Une dernière
+ * passe logue les mêmes images en YUYV, converties par la bibliothèque.
+ * Affiche le débit en Mo de pixels RGB par seconde et le taux de compression
+ * (pixels RGB / taille du fichier).
+ *
+ * Usage : bench_planar [images]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define WIDTH 1280
+#define HEIGHT 720
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void run(const char* label, hdf5_image_layout_t layout, hdf5_predictor_t predictor,
+                int yuyv, const unsigned char* pixels, const unsigned char* packed, long images) {
+    const char* filename = "bench_planar.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL) {
+        return;
+    }
+    hdf5_codec_policy_t policy = {HDF5_CODEC_DEFLATE, 1, 0, predictor};
+    if (hdf5_logger_set_image_layout(logger, "/camera", layout) < 0 ||
+        hdf5_logger_set_group_codec(logger, "/camera", HDF5_DATA_IMAGE, &policy) < 0) {
+        hdf5_logger_close(logger);
+        return;
+    }
+
+    char name[32];
+    double start = now_seconds();
+    for (long n = 0; n < images; n++) {
+        snprintf(name, sizeof(name), "frame_%06ld", n);
+        if (yuyv) {
+            hdf5_log_image_format(logger, "/camera", name, packed, WIDTH, HEIGHT,
+                                  HDF5_PIXEL_YUYV, 0);
+        } else {
+            hdf5_log_image(logger, "/camera", name, pixels, WIDTH, HEIGHT, 3);
+        }
+    }
+    hdf5_logger_close(logger);
+    double elapsed = now_seconds() - start;
+
+    double raw = (double)WIDTH * HEIGHT * 3 * (double)images;
+    struct stat info;
+    double size = (stat(filename, &info) == 0) ? (double)info.st_size : 0.0;
+    printf("  %-22s %10.1f %10.2f\n", label, raw / (1024.0 * 1024.0) / elapsed,
+           (size > 0) ? raw / size : 0.0);
+
+    remove(filename);
+}
+
+int main(int argc, char** argv) {
+    long images = (argc > 1) ? atol(argv[1]) : 30;
+    if (images < 1) {
+        fprintf(stderr, "Usage : %s [images]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    unsigned char* pixels = malloc((size_t)WIDTH * HEIGHT * 3);
+    unsigned char* packed = malloc((size_t)WIDTH * HEIGHT * 2);
+    if (pixels == NULL || packed == NULL) {
+        free(pixels);
+        free(packed);
+        return 1;
+    }
+
+    /* Dégradés différents par canal, bruit sur les deux bits de poids faible */
+    unsigned int noise = 1;
+    for (size_t y = 0; y < HEIGHT; y++) {
+        for (size_t x = 0; x < WIDTH; x++) {
+            unsigned char* p = pixels + (y * WIDTH + x) * 3;
+            noise = noise * 1103515245u + 12345u;
+            p[0] = (unsigned char)(x / 6 + (noise >> 30));
+            p[1] = (unsigned char)(y / 3 + ((noise >> 28) & 3));
+            p[2] = (unsigned char)((x + y) / 8 + ((noise >> 26) & 3));
+        }
+    }
+    for (size_t i = 0; i < (size_t)WIDTH * HEIGHT; i += 2) {
+        const unsigned char* p = pixels + i * 3;
+        unsigned char* q = packed + i * 2;
+        q[0] = (unsigned char)(16 + (p[0] * 66 + p[1] * 129 + p[2] * 25) / 256);
+        q[1] = (unsigned char)(128 + (p[2] * 112 - p[0] * 38 - p[1] * 74) / 256);
+        q[2] = (unsigned char)(16 + (p[3] * 66 + p[4] * 129 + p[5] * 25) / 256);
+        q[3] = (unsigned char)(128 + (p[0] * 112 - p[1] * 94 - p[2] * 18) / 256);
+    }
+
+    printf("%-24s %10s %10s\n", "", "Mo/s", "taux");
+    run("entrelacée", HDF5_IMAGE_INTERLEAVED, HDF5_PREDICT_NONE, 0, pixels, packed, images);
+    run("plans", HDF5_IMAGE_PLANAR, HDF5_PREDICT_NONE, 0, pixels, packed, images);
+    run("entrelacée + écart", HDF5_IMAGE_INTERLEAVED, HDF5_PREDICT_DELTA, 0, pixels, packed,
+        images);
+    run("plans + écart", HDF5_IMAGE_PLANAR, HDF5_PREDICT_DELTA, 0, pixels, packed, images);
+    run("YUYV -> plans", HDF5_IMAGE_PLANAR, HDF5_PREDICT_NONE, 1, pixels, packed, images);
+
+    free(pixels);
+    free(packed);
+    return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file bench_png.c
+ * @brief Prédiction PNG des images : temps par image et taux de compression
+ *
+ * Une séquence d'images 1280x720 RGB (dégradés, bruit de capteur, objet en
+ * mouvement sur un fond fixe) est loguée avec deflate 7 puis deflate 1 sans
+ * prédiction, avec la prédiction PNG par ligne, et avec la prédiction par
+ * l'image précédente. Affiche le temps moyen par image (écriture comprise)
+ * et le taux de compression (pixels / taille du fichier).
+ *
+ * Usage : bench_png [images] [threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define WIDTH 1280
+#define HEIGHT 720
+#define SPRITE 96
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Image n : fond fixe et un carré qui avance de 8 pixels par image */
+static void paint(unsigned char* pixels, const unsigned char* background, long n) {
+    memcpy(pixels, background, (size_t)WIDTH * HEIGHT * 3);
+    size_t x0 = (size_t)(n * 8) % (WIDTH - SPRITE);
+    for (size_t y = HEIGHT / 3; y < HEIGHT / 3 + SPRITE; y++) {
+        for (size_t x = x0; x < x0 + SPRITE; x++) {
+            unsigned char* p = pixels + (y * WIDTH + x) * 3;
+            p[0] = (unsigned char)(200 + (x - x0) / 4);
+            p[1] = (unsigned char)(40 + (y % 32));
+            p[2] = 90;
+        }
+    }
+}
+
+static void run(const char* label, int level, hdf5_predictor_t predictor, size_t threads,
+                const unsigned char* background, unsigned char* pixels, long images) {
+    const char* filename = "bench_png.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL) {
+        return;
+    }
+    hdf5_codec_policy_t policy = {HDF5_CODEC_DEFLATE, level, 0, predictor};
+    if (hdf5_logger_set_group_codec(logger, "/camera", HDF5_DATA_IMAGE, &policy) < 0 ||
+        hdf5_logger_set_compression_threads(logger, threads) < 0) {
+        hdf5_logger_close(logger);
+        return;
+    }
+
+    /* Le dessin des images est hors de la mesure */
+    double elapsed = 0.0;
+    for (long n = 0; n < images; n++) {
+        paint(pixels, background, n);
+        double start = now_seconds();
+        hdf5_log_image_frame(logger, "/camera", "video", pixels, WIDTH, HEIGHT, 3);
+        elapsed += now_seconds() - start;
+    }
+    double start = now_seconds();
+    hdf5_logger_close(logger);
+    elapsed += now_seconds() - start;
+
+    double raw = (double)WIDTH * HEIGHT * 3 * (double)images;
+    struct stat info;
+    double size = (stat(filename, &info) == 0) ? (double)info.st_size : 0.0;
+    printf("  %-24s %10.2f %10.2f\n", label, elapsed * 1000.0 / (double)images,
+           (size > 0) ? raw / size : 0.0);
+
+    remove(filename);
+}
+
+int main(int argc, char** argv) {
+    long images = (argc > 1) ? atol(argv[1]) : 32;
+    size_t threads = (argc > 2) ? (size_t)atol(argv[2]) : 1;
+    if (images < 1 || threads < 1) {
+        fprintf(stderr, "Usage : %s [images] [threads]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    unsigned char* background = malloc((size_t)WIDTH * HEIGHT * 3);
+    unsigned char* pixels = malloc((size_t)WIDTH * HEIGHT * 3);
+    if (background == NULL || pixels == NULL) {
+        free(background);
+        free(pixels);
+        return 1;
+    }
+
+    /* Dégradés différents par canal, bruit sur les deux bits de poids faible */
+    unsigned int noise = 1;
+    for (size_t y = 0; y < HEIGHT; y++) {
+        for (size_t x = 0; x < WIDTH; x++) {
+            unsigned char* p = background + (y * WIDTH + x) * 3;
+            noise = noise * 1103515245u + 12345u;
+            p[0] = (unsigned char)(x / 6 + (noise >> 30));
+            p[1] = (unsigned char)(y / 3 + ((noise >> 28) & 3));
+            p[2] = (unsigned char)((x + y) / 8 + ((noise >> 26) & 3));
+        }
+    }
+
+    printf("%-26s %10s %10s\n", "", "ms/image", "taux");
+    run("deflate 7", 7, HDF5_PREDICT_NONE, threads, background, pixels, images);
+    run("deflate 1", 1, HDF5_PREDICT_NONE, threads, background, pixels, images);
+    run("PNG + deflate 1", 1, HDF5_PREDICT_PNG, threads, background, pixels, images);
+    run("PNG image + deflate 1", 1, HDF5_PREDICT_PNG_FRAME, threads, background, pixels, images);
+
+    free(background);
+    free(pixels);
+    return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file bench_predict.c
+ * @brief Prédiction avant compression : taux et débit sur une télémétrie lente
+ *
+ * Des trames de 4096 mesures (sinusoïdes lentes et bruit faible, en float et
+ * en int16) sont ajoutées à des séries avec shuffle + deflate 1, sans
+ * prédiction, avec l'écart (DELTA) puis avec le ou exclusif (XOR). Affiche
+ * le débit rapporté aux octets bruts et le taux de compression.
+ *
+ * Usage : bench_predict [trames] [threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define FRAME 4096
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static hsize_t stored_bytes(const char* filename, const char* path) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    hsize_t stored = H5Dget_storage_size(dataset_id);
+    H5Dclose(dataset_id);
+    H5Fclose(file_id);
+    return stored;
+}
+
+/* Ajoute frames trames et affiche débit et taux */
+static void run(const char* label, hdf5_dtype_t dtype, hdf5_predictor_t predictor, long frames,
+                size_t threads) {
+    const char* filename = "bench_predict.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    hdf5_codec_policy_t policy = {HDF5_CODEC_DEFLATE, 1, 1, predictor};
+    if (logger == NULL || hdf5_logger_set_codec(logger, HDF5_DATA_NUMERIC, &policy) < 0 ||
+        hdf5_logger_set_compression_threads(logger, threads) < 0) {
+        return;
+    }
+
+    int is_float = (dtype == HDF5_DTYPE_FLOAT32);
+    float floats[FRAME];
+    int16_t shorts[FRAME];
+    size_t dims[1] = {FRAME};
+    unsigned int noise = 12345;
+    double elapsed = 0.0;
+    for (long f = 0; f < frames; f++) {
+        /* Chaque colonne est une voie lente ; le bruit ne touche que les bits de poids faible */
+        for (int i = 0; i < FRAME; i++) {
+            noise = noise * 1103515245u + 12345u;
+            double t = (double)(f * FRAME + i) * 1e-4;
+            double value = 100.0 * sin(t) + 1e-3 * (double)((noise >> 16) & 255);
+            floats[i] = (float)value;
+            shorts[i] = (int16_t)(value * 100.0);
+        }
+        double start = now_seconds();
+        hdf5_log_array_append(logger, "/telemetry", "samples", is_float ? (void*)floats
+                              : (void*)shorts, 1, dims, dtype);
+        elapsed += now_seconds() - start;
+    }
+    double start = now_seconds();
+    hdf5_logger_close(logger);
+    elapsed += now_seconds() - start;
+
+    double raw = (double)frames * FRAME * (is_float ? sizeof(float) : sizeof(int16_t));
+    hsize_t stored = stored_bytes(filename, "/telemetry/samples");
+    printf("  %-20s %10.1f %8.2f\n", label, raw / (1024.0 * 1024.0) / elapsed,
+           stored > 0 ? raw / (double)stored : 0.0);
+    remove(filename);
+}
+
+int main(int argc, char** argv) {
+    long frames = (argc > 1) ? atol(argv[1]) : 2000;
+    size_t threads = (argc > 2) ? (size_t)atol(argv[2]) : 1;
+    if (frames < 1) {
+        fprintf(stderr, "Usage : %s [trames] [threads]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    printf("%-22s %10s %8s\n", "float32", "Mo/s", "taux");
+    run("shuffle + deflate 1", HDF5_DTYPE_FLOAT32, HDF5_PREDICT_NONE, frames, threads);
+    run("delta", HDF5_DTYPE_FLOAT32, HDF5_PREDICT_DELTA, frames, threads);
+    run("xor", HDF5_DTYPE_FLOAT32, HDF5_PREDICT_XOR, frames, threads);
+    printf("%-22s %10s %8s\n", "int16", "Mo/s", "taux");
+    run("shuffle + deflate 1", HDF5_DTYPE_INT16, HDF5_PREDICT_NONE, frames, threads);
+    run("delta", HDF5_DTYPE_INT16, HDF5_PREDICT_DELTA, frames, threads);
+    run("xor", HDF5_DTYPE_INT16, HDF5_PREDICT_XOR, frames, threads);
+    return 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file bench_pyramid.c
+ * @brief Vignettes des images : coût à l'écriture et lecture d'un aperçu
+ *
+ * Des images 3840x2160 RGB (dégradés, bruit de capteur) sont loguées sans
+ * vignettes, puis avec des vignettes jusqu'à 256 pixels sur 1 puis plusieurs
+ * threads de compression. Affiche le temps moyen d'écriture par image, puis
+ * le temps de lecture d'un aperçu d'au plus 256 pixels : dernier niveau de
+ * vignettes, ou image entière réduite par le lecteur quand il n'y en a pas.
+ *
+ * Usage : bench_pyramid [images] [threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define WIDTH 3840
+#define HEIGHT 2160
+#define PREVIEW 256
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Lecture d'un aperçu : le dernier niveau s'il existe, l'image entière sinon */
+static double read_preview(const char* filename, long images, unsigned char* buffer) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file_id < 0) {
+        return 0.0;
+    }
+    char path[64];
+    double start = now_seconds();
+    for (long n = 0; n < images; n++) {
+        snprintf(path, sizeof(path), "/camera/frame_%06ld", n);
+        hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+        unsigned int levels = 0;
+        if (H5Aexists(dataset_id, "pyramid_levels") > 0) {
+            hid_t attr_id = H5Aopen(dataset_id, "pyramid_levels", H5P_DEFAULT);
+            H5Aread(attr_id, H5T_NATIVE_UINT, &levels);
+            H5Aclose(attr_id);
+        }
+        if (levels > 0) {
+            H5Dclose(dataset_id);
+            snprintf(path, sizeof(path), "/camera/frame_%06ld_level%u", n, levels);
+            dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+        }
+        H5Dread(dataset_id, H5T_NATIVE_UCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer);
+        H5Dclose(dataset_id);
+    }
+    double elapsed = now_seconds() - start;
+    H5Fclose(file_id);
+    return elapsed;
+}
+
+static void run(const char* label, size_t min_size, size_t threads,
+                const unsigned char* pixels, unsigned char* buffer, long images) {
+    const char* filename = "bench_pyramid.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL) {
+        return;
+    }
+    if (hdf5_logger_set_image_pyramid(logger, "/camera", min_size) < 0 ||
+        hdf5_logger_set_compression_threads(logger, threads) < 0) {
+        hdf5_logger_close(logger);
+        return;
+    }
+
+    char name[32];
+    double start = now_seconds();
+    for (long n = 0; n < images; n++) {
+        snprintf(name, sizeof(name), "frame_%06ld", n);
+        hdf5_log_image(logger, "/camera", name, pixels, WIDTH, HEIGHT, 3);
+    }
+    hdf5_logger_close(logger);
+    double elapsed = now_seconds() - start;
+
+    double preview = read_preview(filename, images, buffer);
+    printf("  %-26s %12.1f %12.2f\n", label, elapsed * 1000.0 / (double)images,
+           preview * 1000.0 / (double)images);
+
+    remove(filename);
+}
+
+int main(int argc, char** argv) {
+    long images = (argc > 1) ? atol(argv[1]) : 8;
+    size_t threads = (argc > 2) ? (size_t)atol(argv[2]) : 4;
+    if (images < 1 || threads < 1) {
+        fprintf(stderr, "Usage : %s [images] [threads]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    unsigned char* pixels = malloc((size_t)WIDTH * HEIGHT * 3);
+    unsigned char* buffer = malloc((size_t)WIDTH * HEIGHT * 3);
+    if (pixels == NULL || buffer == NULL) {
+        free(pixels);
+        free(buffer);
+        return 1;
+    }
+
+    /* Dégradés différents par canal, bruit sur les deux bits de poids faible */
+    unsigned int noise = 1;
+    for (size_t y = 0; y < HEIGHT; y++) {
+        for (size_t x = 0; x < WIDTH; x++) {
+            unsigned char* p = pixels + (y * WIDTH + x) * 3;
+            noise = noise * 1103515245u + 12345u;
+            p[0] = (unsigned char)(x / 16 + (noise >> 30));
+            p[1] = (unsigned char)(y / 9 + ((noise >> 28) & 3));
+            p[2] = (unsigned char)((x + y) / 24 + ((noise >> 26) & 3));
+        }
+    }
+
+    char label[64];
+    printf("%-28s %12s %12s\n", "", "ms/écriture", "ms/aperçu");
+    run("sans vignettes", 0, 1, pixels, buffer, images);
+    run("vignettes, 1 thread", PREVIEW, 1, pixels, buffer, images);
+    snprintf(label, sizeof(label), "vignettes, %zu threads", threads);
+    run(label, PREVIEW, threads, pixels, buffer, images);
+
+    free(pixels);
+    free(buffer);
+    return 0;
+}
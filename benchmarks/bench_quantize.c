@@ -0,0 +1,106 @@
+/**
+ * @file bench_quantize.c
+ * @brief Quantification des flottants : taux et débit sur une télémétrie bruitée
+ *
+ * Des trames de 4096 mesures float (sinusoïde et bruit de mesure) sont
+ * ajoutées à une série avec shuffle + deflate 1, exactes, à 3 et 4 chiffres
+ * significatifs puis à une erreur absolue de 1e-2. Affiche le débit rapporté
+ * aux octets bruts, le taux de compression et l'erreur maximale relevée.
+ *
+ * Usage : bench_quantize [trames] [threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define FRAME 4096
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static float sample(long f, int i) {
+    unsigned int noise = (unsigned int)(f * FRAME + i) * 2654435761u;
+    return (float)(100.0 * sin((double)(f * FRAME + i) * 1e-4) + 1e-3 * (double)(noise >> 20));
+}
+
+/* Ajoute frames trames et affiche débit, taux et erreur maximale */
+static void run(const char* label, const hdf5_quantize_t* quantize, long frames, size_t threads) {
+    const char* filename = "bench_quantize.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    hdf5_codec_policy_t policy = {HDF5_CODEC_DEFLATE, 1, 1, HDF5_PREDICT_NONE};
+    if (logger == NULL || hdf5_logger_set_codec(logger, HDF5_DATA_NUMERIC, &policy) < 0 ||
+        hdf5_logger_set_compression_threads(logger, threads) < 0 ||
+        hdf5_logger_set_quantize(logger, "/telemetry", NULL, quantize) < 0) {
+        return;
+    }
+
+    float values[FRAME];
+    size_t dims[1] = {FRAME};
+    double elapsed = 0.0;
+    for (long f = 0; f < frames; f++) {
+        for (int i = 0; i < FRAME; i++) {
+            values[i] = sample(f, i);
+        }
+        double start = now_seconds();
+        hdf5_log_array_append(logger, "/telemetry", "samples", values, 1, dims,
+                              HDF5_DTYPE_FLOAT32);
+        elapsed += now_seconds() - start;
+    }
+    double start = now_seconds();
+    hdf5_logger_close(logger);
+    elapsed += now_seconds() - start;
+
+    /* Relecture pour l'erreur maximale */
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t dataset_id = H5Dopen2(file_id, "/telemetry/samples", H5P_DEFAULT);
+    hsize_t stored = H5Dget_storage_size(dataset_id);
+    float* stored_values = malloc((size_t)frames * FRAME * sizeof(float));
+    double max_error = 0.0;
+    if (stored_values != NULL &&
+        H5Dread(dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, stored_values) >= 0) {
+        for (long f = 0; f < frames; f++) {
+            for (int i = 0; i < FRAME; i++) {
+                double error = fabs((double)stored_values[f * FRAME + i] - sample(f, i));
+                max_error = (error > max_error) ? error : max_error;
+            }
+        }
+    }
+    free(stored_values);
+    H5Dclose(dataset_id);
+    H5Fclose(file_id);
+
+    double raw = (double)frames * FRAME * sizeof(float);
+    printf("  %-20s %10.1f %8.2f %12.2e\n", label, raw / (1024.0 * 1024.0) / elapsed,
+           stored > 0 ? raw / (double)stored : 0.0, max_error);
+    remove(filename);
+}
+
+int main(int argc, char** argv) {
+    long frames = (argc > 1) ? atol(argv[1]) : 2000;
+    size_t threads = (argc > 2) ? (size_t)atol(argv[2]) : 1;
+    if (frames < 1) {
+        fprintf(stderr, "Usage : %s [trames] [threads]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    hdf5_quantize_t digits3 = {HDF5_QUANTIZE_DIGITS, 3};
+    hdf5_quantize_t digits4 = {HDF5_QUANTIZE_DIGITS, 4};
+    hdf5_quantize_t absolute = {HDF5_QUANTIZE_ABSOLUTE, 1e-2};
+    printf("%-22s %10s %8s %12s\n", "float32", "Mo/s", "taux", "erreur max");
+    run("exact", NULL, frames, threads);
+    run("4 chiffres", &digits4, frames, threads);
+    run("3 chiffres", &digits3, frames, threads);
+    run("erreur 1e-2", &absolute, frames, threads);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file bench_strided.c
+ * @brief Images à lignes espacées : compactage par l'appelant face à la lecture en place
+ *
+ * Une relecture GPU livre des images RGBA 1920x1080 dont chaque ligne est
+ * alignée sur 512 octets. Elles sont ajoutées à une séquence, sans
+ * compression, soit après recopie dans un tampon compact
+ * (hdf5_log_image_frame), soit directement avec leur pas
+ * (hdf5_log_image_frame_pitched). Mesure les images par seconde.
+ *
+ * Usage : bench_strided [images]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define FRAME_WIDTH 1920
+#define FRAME_HEIGHT 1080
+#define ROW_BYTES (FRAME_WIDTH * 4)
+#define ROW_PITCH ((ROW_BYTES + 511) / 512 * 512)
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Écrit frames images et renvoie les images par seconde, fermeture comprise */
+static double run(int pitched, const unsigned char* padded, long frames) {
+    const char* filename = "bench_strided.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    hdf5_codec_policy_t none = {HDF5_CODEC_NONE, 0, 0, HDF5_PREDICT_NONE};
+    if (logger == NULL || hdf5_logger_set_codec(logger, HDF5_DATA_IMAGE, &none) < 0) {
+        return 0.0;
+    }
+
+    unsigned char* packed = malloc((size_t)ROW_BYTES * FRAME_HEIGHT);
+    double start = now_seconds();
+    for (long i = 0; i < frames; i++) {
+        if (pitched) {
+            hdf5_log_image_frame_pitched(logger, "/bench", "video", padded, FRAME_WIDTH,
+                                         FRAME_HEIGHT, 4, HDF5_DTYPE_UINT8, ROW_PITCH);
+        } else {
+            for (int y = 0; y < FRAME_HEIGHT; y++) {
+                memcpy(packed + (size_t)y * ROW_BYTES, padded + (size_t)y * ROW_PITCH, ROW_BYTES);
+            }
+            hdf5_log_image_frame(logger, "/bench", "video", packed, FRAME_WIDTH, FRAME_HEIGHT, 4);
+        }
+    }
+    hdf5_logger_close(logger);
+    double seconds = now_seconds() - start;
+
+    free(packed);
+    remove(filename);
+    return (double)frames / seconds;
+}
+
+int main(int argc, char** argv) {
+    long frames = (argc > 1) ? atol(argv[1]) : 60;
+    if (frames < 1) {
+        fprintf(stderr, "Usage : %s [images]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    unsigned char* padded = malloc((size_t)ROW_PITCH * FRAME_HEIGHT);
+    for (size_t i = 0; i < (size_t)ROW_PITCH * FRAME_HEIGHT; i++) {
+        padded[i] = (unsigned char)(i * 31);
+    }
+
+    double packed = run(0, padded, frames);
+    double pitched = run(1, padded, frames);
+
+    printf("%-18s %14s\n", "mode", "images/s");
+    printf("%-18s %14.2f\n", "compactage", packed);
+    printf("%-18s %14.2f\n", "lecture en place", pitched);
+
+    free(padded);
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file bench_submit.c
+ * @brief Images 4K non compressées : dépôt avec copie face au dépôt sans copie
+ *
+ * Ajoute des images RGB 3840x2160 (24 Mio) à une séquence en mode asynchrone,
+ * sans compression : d'abord avec hdf5_log_image_frame, qui recopie chaque
+ * image dans la file, puis avec hdf5_log_image_frame_submit, qui écrit
+ * directement depuis les tampons de l'appelant et les rend par rappel. Mesure
+ * le débit total et le temps passé dans l'appel de dépôt.
+ *
+ * Usage : bench_submit [images]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define FRAME_WIDTH 3840
+#define FRAME_HEIGHT 2160
+#define BUFFERS 2
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Tampon rendu par le thread d'écriture */
+static void on_written(void* user_data, int status) {
+    (void)status;
+    *(volatile int*)user_data = 0;
+}
+
+/* Écrit frames images ; renvoie les images par seconde et le temps moyen d'un dépôt (ms) */
+static double run(int zero_copy, unsigned char** buffers, long frames, double* submit_ms) {
+    const char* filename = "bench_submit.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init_async(filename, NULL);
+    hdf5_codec_policy_t none = {HDF5_CODEC_NONE, 0, 0, HDF5_PREDICT_NONE};
+    if (logger == NULL || hdf5_logger_set_codec(logger, HDF5_DATA_IMAGE, &none) < 0) {
+        return 0.0;
+    }
+
+    volatile int busy[BUFFERS] = {0};
+    double in_submit = 0.0;
+    double start = now_seconds();
+    for (long i = 0; i < frames; i++) {
+        int index = (int)(i % BUFFERS);
+        double before = now_seconds();
+        if (zero_copy) {
+            /* Le tampon redevient disponible au rappel */
+            while (busy[index]) {
+                hdf5_logger_flush(logger);
+            }
+            busy[index] = 1;
+            hdf5_log_image_frame_submit(logger, "/bench", "video", buffers[index], FRAME_WIDTH,
+                                        FRAME_HEIGHT, 3, HDF5_DTYPE_UINT8, on_written,
+                                        (void*)&busy[index]);
+        } else {
+            hdf5_log_image_frame(logger, "/bench", "video", buffers[index], FRAME_WIDTH,
+                                 FRAME_HEIGHT, 3);
+        }
+        in_submit += now_seconds() - before;
+    }
+    hdf5_logger_close(logger);
+    double seconds = now_seconds() - start;
+
+    remove(filename);
+    *submit_ms = in_submit * 1000.0 / (double)frames;
+    return (double)frames / seconds;
+}
+
+int main(int argc, char** argv) {
+    long frames = (argc > 1) ? atol(argv[1]) : 16;
+    if (frames < 1) {
+        fprintf(stderr, "Usage : %s [images]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    size_t bytes = (size_t)FRAME_WIDTH * FRAME_HEIGHT * 3;
+    unsigned char* buffers[BUFFERS];
+    for (int b = 0; b < BUFFERS; b++) {
+        buffers[b] = malloc(bytes);
+        memset(buffers[b], 0x40 + b, bytes);
+    }
+
+    double copy_ms = 0.0;
+    double zero_copy_ms = 0.0;
+    double copy = run(0, buffers, frames, &copy_ms);
+    double zero_copy = run(1, buffers, frames, &zero_copy_ms);
+
+    printf("%-12s %14s %18s\n", "mode", "images/s", "ms par dépôt");
+    printf("%-12s %14.2f %18.3f\n", "copie", copy, copy_ms);
+    printf("%-12s %14.2f %18.3f\n", "sans copie", zero_copy, zero_copy_ms);
+
+    for (int b = 0; b < BUFFERS; b++) {
+        free(buffers[b]);
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file bench_threads.c
+ * @brief Mesure du débit de log texte quand le nombre de threads passe de 1 à N
+ *
+ * Compare les appels concurrents natifs (tampons par thread) à l'ancienne
+ * pratique : chaque appel entouré d'un verrou global par l'application.
+ *
+ * Usage : bench_threads [threads_max] [entrées_par_thread]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+typedef struct {
+    hdf5_logger_t* logger;
+    pthread_mutex_t* global_lock; /* NULL pour les appels concurrents natifs */
+    int index;
+    long entries;
+} worker_t;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void* worker_main(void* arg) {
+    worker_t* worker = (worker_t*)arg;
+    char message[64];
+
+    /* La pile d'erreurs HDF5 est propre à chaque thread */
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    for (long i = 0; i < worker->entries; i++) {
+        snprintf(message, sizeof(message), "thread %d entrée %ld", worker->index, i);
+        if (worker->global_lock != NULL) {
+            pthread_mutex_lock(worker->global_lock);
+        }
+        hdf5_log_text_to_group(worker->logger, "/bench/threads", HDF5_LOG_INFO, message);
+        if (worker->global_lock != NULL) {
+            pthread_mutex_unlock(worker->global_lock);
+        }
+    }
+    return NULL;
+}
+
+/* Renvoie le débit en entrées par seconde, fermeture du fichier comprise */
+static double run(int thread_count, long entries, int use_global_lock) {
+    const char* filename = "bench_threads.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL) {
+        return 0.0;
+    }
+
+    pthread_mutex_t global_lock;
+    pthread_mutex_init(&global_lock, NULL);
+
+    pthread_t* threads = malloc((size_t)thread_count * sizeof(pthread_t));
+    worker_t* workers = malloc((size_t)thread_count * sizeof(worker_t));
+
+    double start = now_seconds();
+    for (int t = 0; t < thread_count; t++) {
+        workers[t].logger = logger;
+        workers[t].global_lock = use_global_lock ? &global_lock : NULL;
+        workers[t].index = t;
+        workers[t].entries = entries;
+        pthread_create(&threads[t], NULL, worker_main, &workers[t]);
+    }
+    for (int t = 0; t < thread_count; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    hdf5_logger_close(logger);
+    double elapsed = now_seconds() - start;
+
+    free(workers);
+    free(threads);
+    pthread_mutex_destroy(&global_lock);
+    remove(filename);
+
+    return (double)thread_count * (double)entries / elapsed;
+}
+
+int main(int argc, char** argv) {
+    int max_threads = (argc > 1) ? atoi(argv[1]) : 8;
+    long entries = (argc > 2) ? atol(argv[2]) : 100000;
+    if (max_threads < 1 || entries < 1) {
+        fprintf(stderr, "Usage : %s [threads_max] [entrées_par_thread]\n", argv[0]);
+        return 1;
+    }
+
+    /* Les fichiers sont recréés à chaque mesure : taire les diagnostics d'absence */
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    printf("Entrées par seconde, %ld entrées par thread\n", entries);
+    printf("%8s %16s %16s\n", "threads", "natif", "verrou global");
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        double native = run(threads, entries, 0);
+        double locked = run(threads, entries, 1);
+        printf("%8d %16.0f %16.0f\n", threads, native, locked);
+
+        /* Toujours mesurer N lui-même, même s'il n'est pas une puissance de deux */
+        if (threads < max_threads && threads * 2 > max_threads) {
+            threads = max_threads / 2;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file bench_tile.c
+ * @brief Mise à jour par tuiles : scène fixe avec un petit objet en mouvement
+ *
+ * Une image 1920x1080 RGB est réécrite sous le même nom à chaque pas ; seul
+ * un carré de 64 pixels se déplace sur un fond fixe. Compare la réécriture
+ * complète (hdf5_log_image), la comparaison avec l'image précédente et les
+ * régions fournies par l'appelant. Affiche le débit en images par seconde.
+ *
+ * Usage : bench_tile [images]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define WIDTH 1920
+#define HEIGHT 1080
+#define SPRITE 64
+
+enum { MODE_FULL, MODE_DETECT, MODE_RECTS };
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void paint(unsigned char* pixels, const unsigned char* background, size_t x, size_t y,
+                  unsigned char value) {
+    for (size_t r = y; r < y + SPRITE; r++) {
+        if (value == 0) {
+            memcpy(pixels + (r * WIDTH + x) * 3, background + (r * WIDTH + x) * 3, SPRITE * 3);
+        } else {
+            memset(pixels + (r * WIDTH + x) * 3, value, SPRITE * 3);
+        }
+    }
+}
+
+static void run(const char* label, int mode, long images) {
+    const char* filename = "bench_tile.h5";
+    remove(filename);
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL) {
+        return;
+    }
+
+    unsigned char* background = malloc((size_t)WIDTH * HEIGHT * 3);
+    unsigned char* pixels = malloc((size_t)WIDTH * HEIGHT * 3);
+    if (background == NULL || pixels == NULL) {
+        free(background);
+        free(pixels);
+        hdf5_logger_close(logger);
+        return;
+    }
+    unsigned int noise = 1;
+    for (size_t i = 0; i < (size_t)WIDTH * HEIGHT * 3; i++) {
+        noise = noise * 1103515245u + 12345u;
+        background[i] = (unsigned char)((i / 3 % WIDTH) / 8 + (noise >> 29));
+    }
+    memcpy(pixels, background, (size_t)WIDTH * HEIGHT * 3);
+    hdf5_log_image_update(logger, "/camera", "live", pixels, WIDTH, HEIGHT, 3, HDF5_DTYPE_UINT8,
+                          NULL, 0);
+
+    size_t x = 0;
+    size_t y = 0;
+    double start = now_seconds();
+    for (long n = 0; n < images; n++) {
+        /* Le carré efface sa position précédente et avance en diagonale */
+        hdf5_image_rect_t rects[2] = {{x, y, SPRITE, SPRITE}, {0, 0, 0, 0}};
+        paint(pixels, background, x, y, 0);
+        x = (x + 16) % (WIDTH - SPRITE);
+        y = (y + 9) % (HEIGHT - SPRITE);
+        paint(pixels, background, x, y, 255);
+        rects[1] = (hdf5_image_rect_t){x, y, SPRITE, SPRITE};
+
+        if (mode == MODE_FULL) {
+            hdf5_log_image(logger, "/camera", "live", pixels, WIDTH, HEIGHT, 3);
+        } else {
+            hdf5_log_image_update(logger, "/camera", "live", pixels, WIDTH, HEIGHT, 3,
+                                  HDF5_DTYPE_UINT8, (mode == MODE_RECTS) ? rects : NULL,
+                                  (mode == MODE_RECTS) ? 2 : 0);
+        }
+    }
+    hdf5_logger_close(logger);
+    double elapsed = now_seconds() - start;
+
+    printf("  %-16s %10.1f\n", label, (double)images / elapsed);
+
+    free(background);
+    free(pixels);
+    remove(filename);
+}
+
+int main(int argc, char** argv) {
+    long images = (argc > 1) ? atol(argv[1]) : 100;
+    if (images < 1) {
+        fprintf(stderr, "Usage : %s [images]\n", argv[0]);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    printf("%-18s %10s\n", "", "images/s");
+    run("image entière", MODE_FULL, images);
+    run("comparaison", MODE_DETECT, images);
+    run("régions", MODE_RECTS, images);
+    return 0;
+}
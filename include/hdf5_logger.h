@@ -24,13 +24,279 @@ typedef enum {
 /* Structure principale du logger (opaque) */
 typedef struct hdf5_logger_s hdf5_logger_t;
 
+/* Canal de log texte associé à un groupe (opaque, appartient au logger) */
+typedef struct hdf5_log_channel_s hdf5_log_channel_t;
+
+/* Entrée de log texte pour l'écriture par lots */
+typedef struct {
+    hdf5_log_level_t level;  /* Niveau du log */
+    double timestamp;        /* Horodatage Unix en secondes (0 = heure courante) */
+    const char* message;     /* Message de log */
+    unsigned long long sequence; /* Numéro de séquence global à la relecture (ignoré à l'écriture) */
+} hdf5_text_entry_t;
+
+/* Fonction appelée pour chaque entrée lue ; une valeur non nulle arrête le parcours */
+typedef int (*hdf5_text_callback_t)(const hdf5_text_entry_t* entry, void* user_data);
+
+/* Rang maximal d'un tableau */
+#define HDF5_LOGGER_MAX_RANK 8
+
+/* Nombre maximal de threads de compression */
+#define HDF5_LOGGER_MAX_COMPRESSION_THREADS 64
+
+/* Type des éléments d'un tableau ou des canaux d'une image, stockés tels quels dans le fichier ;
+ * 0 et 1 sont les valeurs de l'ancien paramètre is_double (flottants, doubles) */
+typedef enum {
+    HDF5_DTYPE_FLOAT32 = 0, /* float */
+    HDF5_DTYPE_FLOAT64 = 1, /* double */
+    HDF5_DTYPE_INT8 = 2,    /* int8_t */
+    HDF5_DTYPE_INT16 = 3,   /* int16_t */
+    HDF5_DTYPE_INT32 = 4,   /* int32_t */
+    HDF5_DTYPE_INT64 = 5,   /* int64_t */
+    HDF5_DTYPE_UINT8 = 6,   /* uint8_t */
+    HDF5_DTYPE_UINT16 = 7,  /* uint16_t */
+    HDF5_DTYPE_UINT32 = 8,  /* uint32_t */
+    HDF5_DTYPE_UINT64 = 9,  /* uint64_t */
+    HDF5_DTYPE_FLOAT16 = 10 /* Demi-précision IEEE 754, bits passés dans des uint16_t */
+} hdf5_dtype_t;
+
+/* Motif d'accès attendu à un tableau, qui guide la forme de ses chunks */
+typedef enum {
+    HDF5_ACCESS_ROW_SCAN = 0, /* Lecture séquentielle : chunks de lignes complètes */
+    HDF5_ACCESS_FRAME = 1,    /* Lecture par trame (premier axe) : une trame par chunk */
+    HDF5_ACCESS_TILE = 2,     /* Lecture de tuiles quelconques : chunks aux côtés égaux */
+    HDF5_ACCESS_LEGACY = 3    /* Ancien comportement : 20 éléments par dimension au plus */
+} hdf5_access_pattern_t;
+
+/* Indication de disposition d'un tableau */
+typedef struct {
+    hdf5_access_pattern_t pattern; /* Motif d'accès */
+    size_t chunk_bytes;            /* Taille cible d'un chunk (0 = 256 Kio, de 4 Kio à 64 Mio) */
+} hdf5_array_layout_t;
+
+/* Tableau pris dans un tampon plus grand (sous-bloc, canal entrelacé...), en éléments et dans
+ * le rang du tableau : l'élément i est lu à offset + i * stride dans chaque dimension */
+typedef struct {
+    size_t extent[HDF5_LOGGER_MAX_RANK]; /* Dimensions du tampon complet */
+    size_t offset[HDF5_LOGGER_MAX_RANK]; /* Position du premier élément lu */
+    size_t stride[HDF5_LOGGER_MAX_RANK]; /* Pas entre deux éléments lus (0 = 1) */
+} hdf5_source_layout_t;
+
+/* Rectangle d'une image, en pixels */
+typedef struct {
+    size_t x;      /* Première colonne */
+    size_t y;      /* Première ligne */
+    size_t width;  /* Largeur */
+    size_t height; /* Hauteur */
+} hdf5_image_rect_t;
+
+/* Disposition des canaux d'une image dans son dataset */
+typedef enum {
+    HDF5_IMAGE_INTERLEAVED = 0, /* [hauteur, largeur, canaux] : canaux entrelacés (par défaut) */
+    HDF5_IMAGE_PLANAR = 1       /* [canaux, hauteur, largeur] : un plan par canal */
+} hdf5_image_layout_t;
+
+/* Format des pixels fournis par une caméra, converti en RGB (RGBA pour BGRA) 8 bits */
+typedef enum {
+    HDF5_PIXEL_BGR8 = 0,       /* B, G, R : 3 octets par pixel */
+    HDF5_PIXEL_BGRA8 = 1,      /* B, G, R, A : 4 octets par pixel, alpha gardé */
+    HDF5_PIXEL_YUYV = 2,       /* YUV 4:2:2 entrelacé Y0 U Y1 V, BT.601 (largeur paire) */
+    HDF5_PIXEL_NV12 = 3,       /* YUV 4:2:0 : plan Y puis plan UV entrelacé, BT.601 (côtés pairs) */
+    HDF5_PIXEL_BAYER_RGGB = 4, /* Mosaïque de Bayer 8 bits, lignes R G puis G B */
+    HDF5_PIXEL_BAYER_BGGR = 5, /* Mosaïque de Bayer 8 bits, lignes B G puis G R */
+    HDF5_PIXEL_BAYER_GRBG = 6, /* Mosaïque de Bayer 8 bits, lignes G R puis B G */
+    HDF5_PIXEL_BAYER_GBRG = 7  /* Mosaïque de Bayer 8 bits, lignes G B puis R G */
+} hdf5_pixel_format_t;
+
+/* Codec de compression des datasets */
+typedef enum {
+    HDF5_CODEC_NONE = 0,    /* Aucune compression */
+    HDF5_CODEC_DEFLATE = 1, /* gzip, niveaux 0 à 9 (intégré à HDF5) */
+    HDF5_CODEC_LZ4 = 2,     /* LZ4 (filtre 32004, greffon HDF5), sans niveau */
+    HDF5_CODEC_ZSTD = 3     /* Zstandard (filtre 32015, greffon HDF5), niveaux 1 à 22 */
+} hdf5_codec_t;
+
+/* Nature des données, chacune avec sa politique de compression */
+typedef enum {
+    HDF5_DATA_TEXT = 0,    /* Logs texte (tables records et tas message_heap) */
+    HDF5_DATA_NUMERIC = 1, /* Tableaux */
+    HDF5_DATA_IMAGE = 2,   /* Images */
+    HDF5_DATA_KIND_COUNT = 3
+} hdf5_data_kind_t;
+
+/* Identifiant du filtre HDF5 de prédiction (plage des filtres non enregistrés) */
+#define HDF5_LOGGER_FILTER_PREDICT 311
+
+/* Prédiction réversible des éléments avant le réarrangement et le codec */
+typedef enum {
+    HDF5_PREDICT_NONE = 0,  /* Éléments stockés tels quels */
+    HDF5_PREDICT_DELTA = 1, /* Différence avec l'élément précédent (entiers lentement variables) */
+    HDF5_PREDICT_XOR = 2,   /* Ou exclusif avec l'élément précédent (flottants, à la Gorilla) */
+    HDF5_PREDICT_PNG = 3,   /* Images : prédicteur PNG (Sub, Up, Paeth) choisi ligne par ligne */
+    HDF5_PREDICT_PNG_FRAME = 4 /* Images : PNG, ou même ligne de l'image précédente d'une série */
+} hdf5_predictor_t;
+
+/* Politique de compression */
+typedef struct {
+    hdf5_codec_t codec;         /* Codec */
+    int level;                  /* Niveau du codec (0 = défaut du codec pour Zstd) */
+    int shuffle;                /* 1 = réarranger les octets des éléments avant le codec */
+    hdf5_predictor_t predictor; /* Prédiction (tableaux et images, éléments de 1 à 8 octets ;
+                                   PNG : images seulement, éléments de 1 ou 2 octets, un
+                                   écart simple au-delà) */
+} hdf5_codec_policy_t;
+
+/* Quantification des tableaux flottants : bits de mantisse non significatifs mis à zéro */
+typedef enum {
+    HDF5_QUANTIZE_NONE = 0,    /* Valeurs exactes */
+    HDF5_QUANTIZE_DIGITS = 1,  /* Chiffres décimaux significatifs conservés */
+    HDF5_QUANTIZE_ABSOLUTE = 2 /* Erreur absolue maximale */
+} hdf5_quantize_mode_t;
+
+/* Précision conservée par la quantification */
+typedef struct {
+    hdf5_quantize_mode_t mode; /* Mode */
+    double precision;          /* Chiffres significatifs (entier de 1 à 17) ou erreur absolue (> 0) */
+} hdf5_quantize_t;
+
+/* Comportement d'un dépôt asynchrone quand la file est pleine */
+typedef enum {
+    HDF5_ASYNC_BLOCK = 0,        /* Attendre qu'une place se libère */
+    HDF5_ASYNC_DROP_OLDEST = 1,  /* Abandonner l'enregistrement le plus ancien de la file */
+    HDF5_ASYNC_DROP_BY_LEVEL = 2 /* Abandonner les entrées sous drop_level, attendre pour les autres */
+} hdf5_async_full_policy_t;
+
+/* Configuration du mode asynchrone */
+typedef struct {
+    size_t queue_capacity;                /* Places dans la file (0 = 8192, arrondi à une puissance de deux) */
+    hdf5_async_full_policy_t full_policy; /* Politique de file pleine */
+    hdf5_log_level_t drop_level;          /* Seuil de HDF5_ASYNC_DROP_BY_LEVEL */
+} hdf5_async_config_t;
+
+/* Options de création d'un nouveau fichier (combinables par |) */
+typedef enum {
+    HDF5_FILE_DEFAULT = 0,           /* Fichier lisible par les outils HDF5 1.8 */
+    HDF5_FILE_PERSIST_FREE_SPACE = 1 /* Espace libéré suivi d'une session à l'autre (HDF5 >= 1.10) */
+} hdf5_file_option_t;
+
+/* Fonction appelée quand le tampon d'un dépôt sans copie est rendu à l'appelant ;
+ * status vaut 0 si les données sont écrites, -1 en cas d'échec ou d'abandon.
+ * En mode asynchrone, elle est appelée par le thread d'écriture, hors de tout
+ * verrou du logger, y compris pour un enregistrement abandonné par
+ * HDF5_ASYNC_DROP_OLDEST. Elle peut appeler les fonctions du logger, sauf
+ * hdf5_logger_close : un vidage ou une opération synchrone y écrit les entrées
+ * en attente sans attendre la file, et un dépôt y échoue (-1) plutôt que
+ * d'attendre une place. Un dépôt abandonné par HDF5_ASYNC_DROP_BY_LEVEL, et tout
+ * dépôt en mode synchrone, rendent le tampon avant le retour de l'appel, dans le
+ * thread appelant. */
+typedef void (*hdf5_write_callback_t)(void* user_data, int status);
+
+/* Compteurs du mode asynchrone */
+typedef struct {
+    unsigned long long enqueued;         /* Enregistrements déposés */
+    unsigned long long written;          /* Enregistrements écrits par le thread d'écriture */
+    unsigned long long dropped_oldest;   /* Abandonnés par HDF5_ASYNC_DROP_OLDEST */
+    unsigned long long dropped_by_level; /* Abandonnés par HDF5_ASYNC_DROP_BY_LEVEL */
+    unsigned long long blocked;          /* Dépôts ayant dû attendre une place */
+    unsigned long long write_errors;     /* Écritures en échec dans le thread d'écriture */
+} hdf5_async_stats_t;
+
+/* Compteurs de l'allocateur des tampons de travail (file asynchrone, compression) */
+typedef struct {
+    unsigned long long allocations;        /* Tampons demandés */
+    unsigned long long reused;             /* Demandes servies par un bloc déjà alloué */
+    unsigned long long system_allocations; /* Blocs obtenus du système (malloc) */
+    unsigned long long failures;           /* Demandes refusées par la limite mémoire */
+    size_t bytes_in_use;                   /* Octets des blocs en service */
+    size_t bytes_reserved;                 /* Octets obtenus du système et non rendus */
+    size_t peak_bytes;                     /* Maximum de bytes_reserved */
+    size_t limit;                          /* Limite mémoire (0 = aucune) */
+} hdf5_arena_stats_t;
+
+/* Compteurs de la déduplication des tableaux et des images */
+typedef struct {
+    unsigned long long checked;     /* Tableaux et images hachés */
+    unsigned long long duplicates;  /* Écritures remplacées par un lien vers un dataset identique */
+    unsigned long long bytes_saved; /* Octets bruts non réécrits */
+    size_t indexed;                 /* Empreintes connues */
+} hdf5_dedup_stats_t;
+
 /**
  * @brief Initialise un nouveau logger HDF5
+ *
+ * Un même logger peut être partagé entre threads : chaque thread logue ses
+ * textes dans son propre tampon, sans verrou commun, et les tampons sont
+ * fusionnés dans le fichier par un seul thread à la fois. Chaque entrée texte
+ * reçoit un numéro de séquence global strictement croissant (attribut
+ * text_sequence de la racine entre deux sessions), qui donne l'ordre des
+ * appels entre threads même quand les entrées d'un groupe sont écrites dans
+ * un autre ordre. Seule la fermeture ne doit pas être concurrente d'autres appels.
  * @param filename Nom du fichier HDF5 à créer/ouvrir
  * @return Pointeur vers le logger ou NULL en cas d'erreur
  */
 hdf5_logger_t* hdf5_logger_init(const char* filename);
 
+/**
+ * @brief Initialise un nouveau logger HDF5 avec des options de création du fichier
+ *
+ * Comme hdf5_logger_init. Avec HDF5_FILE_PERSIST_FREE_SPACE, l'espace libéré
+ * par la purge des groupes limités en durée (segments supprimés) est noté
+ * dans le fichier et réutilisé par les sessions suivantes au lieu de faire
+ * grossir le fichier. Ce suivi relève la version du format (superbloc) : le
+ * fichier n'est plus lisible par les outils HDF5 1.8. Les options ne
+ * s'appliquent qu'à la création ; un fichier existant garde les siennes.
+ * @param filename Nom du fichier HDF5 à créer/ouvrir
+ * @param options Combinaison de hdf5_file_option_t
+ * @return Pointeur vers le logger ou NULL en cas d'erreur
+ */
+hdf5_logger_t* hdf5_logger_init_with_options(const char* filename, unsigned int options);
+
+/**
+ * @brief Initialise un nouveau logger HDF5 en mode asynchrone
+ *
+ * Les logs texte, tableaux et images sont recopiés dans une file bornée sans
+ * verrou et écrits par un thread dédié : l'appelant ne fait aucune
+ * entrée/sortie. Les autres fonctions attendent que la file soit écrite avant
+ * d'accéder au fichier. Tableaux et images sont de niveau HDF5_LOG_INFO pour
+ * la politique HDF5_ASYNC_DROP_BY_LEVEL.
+ *
+ * @param filename Nom du fichier HDF5 à créer/ouvrir
+ * @param config Configuration, ou NULL pour une file bloquante de 8192 places
+ * @return Pointeur vers le logger ou NULL en cas d'erreur
+ */
+hdf5_logger_t* hdf5_logger_init_async(const char* filename, const hdf5_async_config_t* config);
+
+/**
+ * @brief Lit les compteurs du mode asynchrone
+ * @param logger Pointeur vers un logger asynchrone
+ * @param stats Compteurs lus
+ * @return 0 en cas de succès, code d'erreur sinon (notamment en mode synchrone)
+ */
+int hdf5_logger_get_async_stats(hdf5_logger_t* logger, hdf5_async_stats_t* stats);
+
+/**
+ * @brief Borne la mémoire des tampons de travail
+ *
+ * Les enregistrements de la file asynchrone (avec leurs copies de données) et
+ * les tampons de compression sont pris dans des blocs réutilisés d'une
+ * écriture à l'autre. Au-delà de la limite, les blocs libres sont d'abord
+ * rendus au système ; si cela ne suffit pas, un dépôt asynchrone attend que
+ * le thread d'écriture libère de la place (HDF5_ASYNC_BLOCK) ou échoue (autres
+ * politiques), et une compression parallèle repasse par le pipeline HDF5.
+ * @param logger Pointeur vers le logger
+ * @param max_bytes Octets au plus obtenus du système (0 = aucune limite, par défaut)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int hdf5_logger_set_memory_limit(hdf5_logger_t* logger, size_t max_bytes);
+
+/**
+ * @brief Lit les compteurs de l'allocateur des tampons de travail
+ * @param logger Pointeur vers le logger
+ * @param stats Compteurs lus
+ * @return 0 en cas de succès, -1 sinon
+ */
+int hdf5_logger_get_arena_stats(hdf5_logger_t* logger, hdf5_arena_stats_t* stats);
+
 /**
  * @brief Ferme le logger et libère les ressources
  * @param logger Pointeur vers le logger
@@ -38,8 +304,47 @@ hdf5_logger_t* hdf5_logger_init(const char* filename);
  */
 int hdf5_logger_close(hdf5_logger_t* logger);
 
+/**
+ * @brief Définit la politique de regroupement des écritures texte
+ *
+ * Les messages texte sont accumulés en mémoire par groupe puis écrits en une
+ * seule écriture d'hyperslab dès qu'un des seuils est atteint. Par défaut :
+ * 1024 entrées, 256 Kio de messages ou 1 seconde.
+ *
+ * En mode synchrone, aucun minuteur n'écrit les entrées en attente : le délai
+ * n'est vérifié qu'au prochain appel de log, de vidage ou de fermeture. Un
+ * programme qui cesse de loguer doit appeler hdf5_logger_flush pour que ses
+ * dernières entrées atteignent le fichier. En mode asynchrone, le thread
+ * d'écriture applique le délai de lui-même.
+ * @param logger Pointeur vers le logger
+ * @param max_entries Nombre d'entrées par groupe déclenchant l'écriture (1 = écriture immédiate)
+ * @param max_bytes Volume de messages par groupe déclenchant l'écriture (0 = pas de limite)
+ * @param max_delay_seconds Délai maximal avant écriture d'une entrée (0 = pas de limite)
+ * @return 0 en cas de succès, code d'erreur sinon
+ */
+int hdf5_logger_set_batch_policy(hdf5_logger_t* logger, size_t max_entries, size_t max_bytes,
+                                 double max_delay_seconds);
+
+/**
+ * @brief Écrit toutes les entrées en attente et vide les tampons HDF5 sur disque
+ *
+ * En mode asynchrone, attend que tout ce qui a été déposé avant l'appel soit écrit,
+ * et renvoie -1 si une écriture a échoué depuis le vidage précédent.
+ *
+ * @param logger Pointeur vers le logger
+ * @return 0 en cas de succès, code d'erreur sinon
+ */
+int hdf5_logger_flush(hdf5_logger_t* logger);
+
 /**
  * @brief Définit la limite de temps pour la conservation des logs
+ *
+ * Les entrées plus anciennes que max_time_seconds sont oubliées par une purge
+ * qui ne lit que le début expiré du groupe ; les entrées encore valides sont
+ * toutes conservées.
+ * L'espace libéré n'est réutilisé d'une session à l'autre que dans un
+ * fichier créé avec HDF5_FILE_PERSIST_FREE_SPACE.
+ *
  * @param logger Pointeur vers le logger
  * @param group_path Chemin du groupe à limiter dans le fichier HDF5
  * @param max_time_seconds Durée maximale de conservation en secondes
@@ -47,6 +352,18 @@ int hdf5_logger_close(hdf5_logger_t* logger);
  */
 int hdf5_logger_set_time_limit(hdf5_logger_t* logger, const char* group_path, double max_time_seconds);
 
+/**
+ * @brief Définit le délai minimal entre deux purges par durée d'un même groupe
+ *
+ * La purge s'exécute lors des écritures groupées, au plus une fois par délai ;
+ * une lecture applique toujours la fenêtre exacte.
+ *
+ * @param logger Pointeur vers le logger
+ * @param interval_seconds Délai en secondes (0 = à chaque écriture groupée)
+ * @return 0 en cas de succès, code d'erreur sinon
+ */
+int hdf5_logger_set_retention_interval(hdf5_logger_t* logger, double interval_seconds);
+
 /**
  * @brief Définit la limite de taille pour la conservation des logs
  * @param logger Pointeur vers le logger
@@ -56,6 +373,206 @@ int hdf5_logger_set_time_limit(hdf5_logger_t* logger, const char* group_path, do
  */
 int hdf5_logger_set_size_limit(hdf5_logger_t* logger, const char* group_path, size_t max_entries);
 
+/**
+ * @brief Fixe le niveau minimal des logs texte du logger
+ *
+ * Un log de niveau inférieur est rejeté dès l'appel, avant toute copie ou
+ * tout appel HDF5, et la fonction de log renvoie 0. Le seuil est lu sans
+ * verrou : il peut être changé à tout moment depuis n'importe quel thread.
+ * Valeur initiale : HDF5_LOG_DEBUG. HDF5_LOGGER_MIN_LEVEL ne concerne que les macros.
+ * @param logger Pointeur vers le logger
+ * @param level Niveau minimal écrit
+ * @return 0 en cas de succès, code d'erreur sinon
+ */
+int hdf5_logger_set_min_level(hdf5_logger_t* logger, hdf5_log_level_t level);
+
+/**
+ * @brief Renvoie le niveau minimal des logs texte du logger
+ * @param logger Pointeur vers le logger
+ * @return Niveau minimal écrit (HDF5_LOG_DEBUG si logger est NULL)
+ */
+hdf5_log_level_t hdf5_logger_get_min_level(const hdf5_logger_t* logger);
+
+/**
+ * @brief Fixe le niveau minimal des logs texte d'un groupe
+ *
+ * Le seuil du groupe remplace celui du logger pour ce chemin exact (les
+ * sous-groupes n'en héritent pas), qu'il soit plus strict ou plus permissif.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param level Niveau minimal écrit dans ce groupe
+ * @return 0 en cas de succès, code d'erreur sinon
+ */
+int hdf5_logger_set_group_min_level(hdf5_logger_t* logger, const char* group_path,
+                                    hdf5_log_level_t level);
+
+/**
+ * @brief Indique si un log de ce niveau peut être écrit dans au moins un groupe
+ *
+ * Permet d'éviter de préparer les arguments d'un log qui serait rejeté (voir
+ * HDF5_LOGF). Le logger étant opaque, c'est un appel de fonction de la
+ * bibliothèque partagée (indirection par la PLT) suivi d'une lecture atomique
+ * du seuil : quelques nanosecondes, sans verrou ni appel système, mais pas une
+ * comparaison en ligne (voir bench_levels).
+ * @param logger Pointeur vers le logger
+ * @param level Niveau du log
+ * @return 1 si le niveau passe le plus petit seuil en vigueur, 0 sinon
+ */
+int hdf5_logger_is_enabled(const hdf5_logger_t* logger, hdf5_log_level_t level);
+
+/**
+ * @brief Fixe la politique de compression d'une nature de données
+ *
+ * S'applique aux datasets créés ensuite (ceux d'un groupe de texte le sont
+ * à sa première écriture sur disque) ; les datasets existants gardent leurs
+ * filtres. Par défaut : texte et tableaux en shuffle + deflate 1,
+ * images en deflate 1.
+ * @param logger Pointeur vers le logger
+ * @param kind Nature des données
+ * @param policy Politique (NULL = rétablir celle par défaut)
+ * @return 0 en cas de succès, -1 si la politique est invalide (prédiction du texte,
+ *         prédiction PNG hors images, prédiction ou réarrangement sans codec compris)
+ *         ou le codec indisponible
+ */
+int hdf5_logger_set_codec(hdf5_logger_t* logger, hdf5_data_kind_t kind,
+                          const hdf5_codec_policy_t* policy);
+
+/**
+ * @brief Fixe la politique de compression d'une nature de données dans un groupe
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin exact du groupe (les sous-groupes n'en héritent pas)
+ * @param kind Nature des données
+ * @param policy Politique (NULL = revenir à celle du logger)
+ * @return 0 en cas de succès, -1 si la politique est invalide (prédiction du texte,
+ *         prédiction PNG hors images, prédiction ou réarrangement sans codec compris)
+ *         ou le codec indisponible
+ */
+int hdf5_logger_set_group_codec(hdf5_logger_t* logger, const char* group_path,
+                                hdf5_data_kind_t kind, const hdf5_codec_policy_t* policy);
+
+/**
+ * @brief Indique si un codec est utilisable (greffon trouvé pour LZ4 et Zstd)
+ * @param codec Codec
+ * @return 1 si le codec est disponible, 0 sinon
+ */
+int hdf5_codec_available(hdf5_codec_t codec);
+
+/**
+ * @brief Enregistre auprès de HDF5 les filtres propres au logger
+ *
+ * hdf5_logger_init les enregistre : seul un programme qui lit un fichier
+ * sans créer de logger doit appeler cette fonction avant de lire un dataset
+ * écrit avec une prédiction (HDF5_LOGGER_FILTER_PREDICT).
+ * @return 0 en cas de succès, -1 sinon
+ */
+int hdf5_logger_register_filters(void);
+
+/**
+ * @brief Fixe la quantification des tableaux flottants d'un groupe ou d'un dataset
+ *
+ * Avant le réarrangement et le codec, chaque valeur float ou double est
+ * arrondie à la précision demandée : ses bits de mantisse suivants sont mis à
+ * zéro et se compressent presque entièrement. Avec HDF5_QUANTIZE_DIGITS,
+ * l'écart relatif reste sous une demi-unité du dernier chiffre conservé ;
+ * avec HDF5_QUANTIZE_ABSOLUTE, l'écart reste sous precision. Les valeurs non
+ * finies sont gardées. S'applique aux tableaux et aux séries créés ensuite ;
+ * la précision est notée dans les attributs quantize_significant_digits ou
+ * quantize_max_error du dataset, et une série prolongée garde la sienne.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe
+ * @param dataset_name Nom du dataset (NULL = tous les tableaux flottants du groupe)
+ * @param quantize Précision (NULL = celle du groupe pour un dataset, valeurs exactes pour un
+ *                 groupe ; HDF5_QUANTIZE_NONE = valeurs exactes)
+ * @return 0 en cas de succès, -1 si la précision est invalide
+ */
+int hdf5_logger_set_quantize(hdf5_logger_t* logger, const char* group_path,
+                             const char* dataset_name, const hdf5_quantize_t* quantize);
+
+/**
+ * @brief Active la déduplication des tableaux et des images
+ *
+ * Chaque tableau (hdf5_log_array_*, hors séries) et chaque image
+ * (hdf5_log_image*, hors séquences) est haché sur 128 bits, avec son type,
+ * ses dimensions et sa quantification. Si un dataset de même empreinte existe
+ * déjà dans le fichier, l'écriture est remplacée par un lien dur vers lui :
+ * aucune donnée n'est compressée ni réécrite, et un dataset réécrit à
+ * l'identique sous son propre nom n'est pas touché. Les datasets liés
+ * partagent donc leurs attributs (horodatage de la première écriture).
+ * L'empreinte est notée dans l'attribut content_hash de chaque dataset écrit ;
+ * à l'activation, le fichier est parcouru pour retrouver celles des sessions
+ * précédentes.
+ * @param logger Pointeur vers le logger
+ * @param enabled 1 pour activer, 0 pour désactiver (par défaut)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int hdf5_logger_set_dedup(hdf5_logger_t* logger, int enabled);
+
+/**
+ * @brief Fixe la disposition des canaux des images d'un groupe
+ *
+ * En HDF5_IMAGE_PLANAR, les images couleur sont écrites [canaux, hauteur,
+ * largeur] avec des chunks [canaux, 128, 128] : chaque canal forme un plan
+ * continu, qui se compresse mieux que les canaux entrelacés, surtout avec une
+ * prédiction. Les plans sont séparés à l'écriture, sans copie préalable par
+ * l'appelant, et le dataset reçoit l'attribut layout = "planar". S'applique
+ * aux images écrites ensuite par hdf5_log_image* (hors séquences, qui restent
+ * entrelacées) ; les images à un seul canal restent [hauteur, largeur].
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin exact du groupe (les sous-groupes n'en héritent pas)
+ * @param layout Disposition (HDF5_IMAGE_INTERLEAVED = revenir à celle par défaut)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int hdf5_logger_set_image_layout(hdf5_logger_t* logger, const char* group_path,
+                                 hdf5_image_layout_t layout);
+
+/**
+ * @brief Fait écrire des vignettes de plus en plus petites à côté des images d'un groupe
+ *
+ * Chaque image écrite ensuite par hdf5_log_image* (hors séquences) est
+ * suivie des datasets <nom>_level1, <nom>_level2... : chaque niveau divise
+ * la largeur et la hauteur du précédent par deux (arrondies au-dessus), un
+ * pixel valant la moyenne arrondie des 2 x 2 pixels qu'il couvre, jusqu'au
+ * premier niveau dont le plus grand côté ne dépasse pas min_size. Un niveau
+ * d'au plus 1 Mo forme un seul chunk : une vignette se lit d'une seule
+ * lecture. Les niveaux ont le type, les canaux, la disposition et la
+ * compression de l'image, et les attributs pyramid_level (numéro) et
+ * pyramid_source (nom de l'image) ; l'image reçoit pyramid_levels (nombre de
+ * niveaux). Une mise à jour par hdf5_log_image_update recalcule les niveaux.
+ * Les niveaux ne sont jamais dédupliqués (hdf5_logger_set_dedup) ; une image
+ * ne partage son dataset qu'avec des images de même nombre de niveaux.
+ * Les réductions sont réparties sur les threads de compression
+ * (hdf5_logger_set_compression_threads) et faites par le thread d'écriture en
+ * mode asynchrone. Les images HDF5_DTYPE_FLOAT16 n'ont pas de vignettes.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin exact du groupe (les sous-groupes n'en héritent pas)
+ * @param min_size Côté maximal du dernier niveau en pixels (0 = pas de vignettes)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int hdf5_logger_set_image_pyramid(hdf5_logger_t* logger, const char* group_path,
+                                  size_t min_size);
+
+/**
+ * @brief Lit les compteurs de la déduplication
+ * @param logger Pointeur vers le logger
+ * @param stats Compteurs lus (cumulés depuis l'initialisation du logger)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int hdf5_logger_get_dedup_stats(hdf5_logger_t* logger, hdf5_dedup_stats_t* stats);
+
+/**
+ * @brief Fixe le nombre de threads qui compressent les chunks des tableaux et des images
+ *
+ * Au-delà d'un thread, les chunks compressés en deflate sont découpés et
+ * compressés en parallèle puis écrits directement (H5Dwrite_chunk), avec la
+ * même disposition et les mêmes filtres que le pipeline HDF5 : tout lecteur
+ * HDF5 les décode. Les autres codecs passent toujours par le pipeline HDF5.
+ * @param logger Pointeur vers le logger
+ * @param threads Nombre de threads, appelant compris (0 ou 1 = pipeline HDF5 sur le
+ *                thread qui écrit, par défaut ; au plus HDF5_LOGGER_MAX_COMPRESSION_THREADS)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int hdf5_logger_set_compression_threads(hdf5_logger_t* logger, size_t threads);
+
 /**
  * @brief Ajoute un log texte
  * @param logger Pointeur vers le logger
@@ -76,6 +593,103 @@ int hdf5_log_text(hdf5_logger_t* logger, hdf5_log_level_t level, const char* mes
 int hdf5_log_text_to_group(hdf5_logger_t* logger, const char* group_path, 
                           hdf5_log_level_t level, const char* message);
 
+/**
+ * @brief Ajoute un log texte à formatage différé
+ *
+ * Le message n'est pas formaté à l'appel : la chaîne de format est internée une
+ * fois (dataset /text_formats du fichier) et seuls ses arguments sont encodés en
+ * binaire compact dans le tas des messages. hdf5_logger_read_text reconstitue le
+ * texte à la relecture. Les conversions de printf sont acceptées, sauf %n et les
+ * caractères larges (%lc, %ls) ; un long double est conservé comme double.
+ * @param logger Pointeur vers le logger
+ * @param level Niveau du log
+ * @param fmt Chaîne de format printf
+ * @return 0 en cas de succès, -1 si le format est invalide ou en cas d'erreur
+ */
+int hdf5_log_textf(hdf5_logger_t* logger, hdf5_log_level_t level, const char* fmt, ...);
+
+/**
+ * @brief Ajoute un log texte à formatage différé dans un groupe spécifique
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param level Niveau du log
+ * @param fmt Chaîne de format printf (voir hdf5_log_textf)
+ * @return 0 en cas de succès, -1 si le format est invalide ou en cas d'erreur
+ */
+int hdf5_log_textf_to_group(hdf5_logger_t* logger, const char* group_path,
+                            hdf5_log_level_t level, const char* fmt, ...);
+
+/**
+ * @brief Ajoute un lot de logs texte dans un groupe spécifique
+ *
+ * Les horodatages stockés d'un groupe ne décroissent jamais : une entrée plus
+ * ancienne que la précédente du groupe reçoit l'horodatage de celle-ci.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param entries Entrées à ajouter, dans l'ordre chronologique
+ * @param n Nombre d'entrées
+ * @return 0 en cas de succès, code d'erreur sinon
+ */
+int hdf5_log_text_batch(hdf5_logger_t* logger, const char* group_path,
+                        const hdf5_text_entry_t* entries, size_t n);
+
+/**
+ * @brief Relit les logs texte d'un groupe dans l'ordre d'écriture
+ *
+ * Les entrées en attente sont d'abord écrites. Les groupes créés par une version
+ * antérieure (dataset log_entries à message de 1024 octets) restent lisibles :
+ * leurs entrées sont renvoyées avant celles de la disposition compacte
+ * (table records et tas message_heap, attribut text_layout_version = 2).
+ * Le message passé à callback n'est valide que pendant l'appel. Le numéro de
+ * séquence vaut 0 pour les entrées écrites par une version qui n'en attribuait pas.
+ * Les messages des entrées à formatage différé sont reconstitués avant l'appel.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param callback Fonction appelée pour chaque entrée
+ * @param user_data Donnée transmise à callback
+ * @return 0 si tout a été lu, valeur non nulle renvoyée par callback, -1 en cas d'erreur
+ */
+int hdf5_logger_read_text(hdf5_logger_t* logger, const char* group_path,
+                          hdf5_text_callback_t callback, void* user_data);
+
+/**
+ * @brief Relit les logs texte d'un groupe d'un fichier ouvert en lecture seule
+ *
+ * Le fichier n'est pas modifié : aucun groupe ni attribut n'est créé et les
+ * entrées expirées ne sont pas purgées. Les entrées sont renvoyées comme par
+ * hdf5_logger_read_text, y compris celles dont la durée de conservation est
+ * dépassée mais que le logger n'a pas encore supprimées.
+ * @param filename Chemin du fichier HDF5
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param callback Fonction appelée pour chaque entrée
+ * @param user_data Donnée transmise à callback
+ * @return 0 si tout a été lu, valeur non nulle renvoyée par callback, -1 en cas d'erreur
+ */
+int hdf5_logger_read_text_file(const char* filename, const char* group_path,
+                               hdf5_text_callback_t callback, void* user_data);
+
+/**
+ * @brief Ouvre un canal de log texte sur un groupe
+ *
+ * Le canal garde le groupe et le dataset ouverts entre les écritures : chaque
+ * message ne coûte plus qu'une écriture d'hyperslab. Les appels à hdf5_log_text
+ * et hdf5_log_text_to_group passent par les mêmes canaux. Ouvrir deux fois le
+ * même chemin renvoie le même canal, qui reste valide jusqu'à hdf5_logger_close.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @return Pointeur vers le canal ou NULL en cas d'erreur
+ */
+hdf5_log_channel_t* hdf5_logger_open_channel(hdf5_logger_t* logger, const char* group_path);
+
+/**
+ * @brief Ajoute un log texte via un canal ouvert
+ * @param channel Canal obtenu par hdf5_logger_open_channel
+ * @param level Niveau du log
+ * @param message Message de log
+ * @return 0 en cas de succès, code d'erreur sinon
+ */
+int hdf5_log_channel_text(hdf5_log_channel_t* channel, hdf5_log_level_t level, const char* message);
+
 /**
  * @brief Ajoute un tableau à une dimension
  * @param logger Pointeur vers le logger
@@ -83,11 +697,11 @@ int hdf5_log_text_to_group(hdf5_logger_t* logger, const char* group_path,
  * @param dataset_name Nom du dataset pour ce tableau
  * @param data Données à enregistrer
  * @param size Taille du tableau
- * @param is_double 1 si les données sont des doubles, 0 si flottants
+ * @param dtype Type des éléments
  * @return 0 en cas de succès, code d'erreur sinon
  */
 int hdf5_log_array_1d(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
-                     const void* data, size_t size, int is_double);
+                     const void* data, size_t size, hdf5_dtype_t dtype);
 
 /**
  * @brief Ajoute un tableau à deux dimensions
@@ -97,11 +711,11 @@ int hdf5_log_array_1d(hdf5_logger_t* logger, const char* group_path, const char*
  * @param data Données à enregistrer
  * @param rows Nombre de lignes
  * @param cols Nombre de colonnes
- * @param is_double 1 si les données sont des doubles, 0 si flottants
+ * @param dtype Type des éléments
  * @return 0 en cas de succès, code d'erreur sinon
  */
 int hdf5_log_array_2d(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
-                     const void* data, size_t rows, size_t cols, int is_double);
+                     const void* data, size_t rows, size_t cols, hdf5_dtype_t dtype);
 
 /**
  * @brief Ajoute un tableau à trois dimensions
@@ -112,11 +726,113 @@ int hdf5_log_array_2d(hdf5_logger_t* logger, const char* group_path, const char*
  * @param dim1 Première dimension
  * @param dim2 Deuxième dimension
  * @param dim3 Troisième dimension
- * @param is_double 1 si les données sont des doubles, 0 si flottants
+ * @param dtype Type des éléments
  * @return 0 en cas de succès, code d'erreur sinon
  */
 int hdf5_log_array_3d(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
-                     const void* data, size_t dim1, size_t dim2, size_t dim3, int is_double);
+                     const void* data, size_t dim1, size_t dim2, size_t dim3, hdf5_dtype_t dtype);
+
+/**
+ * @brief Ajoute un tableau de rang quelconque avec une indication de disposition
+ *
+ * La forme des chunks est choisie d'après la taille cible et le motif
+ * d'accès, de sorte que le coût fixe par chunk reste négligeable devant les
+ * octets transférés. Un tableau de moins de 4 Kio est stocké sans chunks ni
+ * compression. HDF5_ACCESS_LEGACY reproduit l'ancien découpage.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param dataset_name Nom du dataset pour ce tableau
+ * @param data Données à enregistrer, en ordre C
+ * @param rank Rang du tableau (1 à HDF5_LOGGER_MAX_RANK)
+ * @param dims Dimensions du tableau
+ * @param dtype Type des éléments
+ * @param layout Indication de disposition (NULL = celle du logger)
+ * @return 0 en cas de succès, code d'erreur sinon
+ */
+int hdf5_log_array_nd(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
+                      const void* data, int rank, const size_t* dims, hdf5_dtype_t dtype,
+                      const hdf5_array_layout_t* layout);
+
+/**
+ * @brief Ajoute un tableau lu directement dans un tampon non contigu
+ *
+ * Comme hdf5_log_array_nd, mais les éléments sont pris dans un tampon plus
+ * grand décrit par source : sous-bloc d'une matrice, un canal d'un tampon
+ * entrelacé (pas de 3 sur la dernière dimension), etc. HDF5 lit le tampon au
+ * travers d'une sélection mémoire, sans copie intermédiaire ; en mode
+ * asynchrone, seuls les éléments sélectionnés sont recopiés dans la file.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param dataset_name Nom du dataset pour ce tableau
+ * @param data Début du tampon source
+ * @param rank Rang du tableau et du tampon (1 à HDF5_LOGGER_MAX_RANK)
+ * @param dims Dimensions du tableau écrit
+ * @param dtype Type des éléments
+ * @param source Disposition du tampon (NULL = tableau dense, comme hdf5_log_array_nd)
+ * @param layout Indication de disposition des chunks (NULL = celle du logger)
+ * @return 0 en cas de succès, -1 si la sélection sort du tampon ou en cas d'erreur
+ */
+int hdf5_log_array_strided(hdf5_logger_t* logger, const char* group_path,
+                           const char* dataset_name, const void* data, int rank,
+                           const size_t* dims, hdf5_dtype_t dtype,
+                           const hdf5_source_layout_t* source, const hdf5_array_layout_t* layout);
+
+/**
+ * @brief Ajoute une trame à une série temporelle de tableaux
+ *
+ * Au premier appel, crée un dataset extensible de rang rank + 1 dont le
+ * premier axe (illimité) compte les trames, et le dataset
+ * <dataset_name>_timestamps qui reçoit l'horodatage de chaque trame ; une
+ * série d'une session précédente est prolongée. Les trames sont regroupées en
+ * mémoire et écrites par chunks complets, ainsi qu'à chaque vidage du logger
+ * et selon le délai de la politique de regroupement.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param dataset_name Nom du dataset des trames
+ * @param data Trame à ajouter, en ordre C
+ * @param rank Rang d'une trame (1 à HDF5_LOGGER_MAX_RANK - 1)
+ * @param dims Dimensions d'une trame, identiques pour toute la série
+ * @param dtype Type des éléments (fixé par la première trame)
+ * @return 0 en cas de succès, -1 si la trame ne correspond pas à la série ou en cas d'erreur
+ */
+int hdf5_log_array_append(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
+                          const void* data, int rank, const size_t* dims, hdf5_dtype_t dtype);
+
+/**
+ * @brief Dépose un tableau sans le recopier ; le tampon reste à l'appelant jusqu'au rappel
+ *
+ * Écrit comme hdf5_log_array_nd avec la disposition par défaut. En mode
+ * asynchrone, le thread d'écriture lit directement le tampon de l'appelant,
+ * qui ne doit être ni modifié ni libéré avant l'appel de done. En mode
+ * synchrone, l'écriture a lieu pendant l'appel et done est appelé avant son
+ * retour. done est appelé exactement une fois si la fonction renvoie 0, et
+ * jamais si elle renvoie -1 ; hdf5_write_callback_t précise depuis quel thread
+ * et ce qu'il peut appeler.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param dataset_name Nom du dataset
+ * @param data Données du tableau, en ordre C, empruntées jusqu'au rappel
+ * @param rank Rang du tableau (1 à HDF5_LOGGER_MAX_RANK)
+ * @param dims Dimensions du tableau
+ * @param dtype Type des éléments
+ * @param done Fonction appelée quand le tampon est rendu (obligatoire)
+ * @param user_data Donnée transmise à done
+ * @return 0 si le tableau est pris en charge, -1 sinon (tampon rendu immédiatement)
+ */
+int hdf5_log_array_submit(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
+                          const void* data, int rank, const size_t* dims, hdf5_dtype_t dtype,
+                          hdf5_write_callback_t done, void* user_data);
+
+/**
+ * @brief Fixe la disposition des tableaux écrits sans indication
+ *
+ * S'applique à hdf5_log_array_1d, _2d, _3d et à hdf5_log_array_nd sans layout.
+ * Par défaut : HDF5_ACCESS_ROW_SCAN et des chunks de 256 Kio.
+ * @param logger Pointeur vers le logger
+ * @param layout Disposition par défaut (NULL = rétablir celle d'origine)
+ * @return 0 en cas de succès, code d'erreur sinon
+ */
+int hdf5_logger_set_array_layout(hdf5_logger_t* logger, const hdf5_array_layout_t* layout);
 
 /**
  * @brief Ajoute une image
@@ -132,6 +848,205 @@ int hdf5_log_array_3d(hdf5_logger_t* logger, const char* group_path, const char*
 int hdf5_log_image(hdf5_logger_t* logger, const char* group_path, const char* image_name,
                   const unsigned char* pixel_data, size_t width, size_t height, size_t channels);
 
+/**
+ * @brief Ajoute une image dont les canaux sont d'un type quelconque
+ *
+ * Comme hdf5_log_image, pour des capteurs 12 ou 16 bits (HDF5_DTYPE_UINT16),
+ * des images signées ou flottantes : les pixels sont écrits dans leur type,
+ * sans conversion. hdf5_log_image équivaut à HDF5_DTYPE_UINT8.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param image_name Nom du dataset pour cette image
+ * @param pixel_data Données de pixels de l'image (hauteur x largeur x canaux)
+ * @param width Largeur de l'image
+ * @param height Hauteur de l'image
+ * @param channels Nombre de canaux (1 à 4)
+ * @param dtype Type d'un canal
+ * @return 0 en cas de succès, code d'erreur sinon
+ */
+int hdf5_log_image_typed(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                         const void* pixel_data, size_t width, size_t height, size_t channels,
+                         hdf5_dtype_t dtype);
+
+/**
+ * @brief Ajoute une image dont les lignes sont espacées d'un pas (row pitch)
+ *
+ * Comme hdf5_log_image_typed, pour un tampon dont chaque ligne est suivie
+ * d'une marge (relecture GPU, alignement des caméras) : les pixels sont lus
+ * en place, sans compacter l'image au préalable.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param image_name Nom du dataset pour cette image
+ * @param pixel_data Première ligne de l'image
+ * @param width Largeur de l'image
+ * @param height Hauteur de l'image
+ * @param channels Nombre de canaux (1 à 4)
+ * @param dtype Type d'un canal
+ * @param row_pitch Octets entre le début de deux lignes (multiple de la taille d'un canal,
+ *        au moins width x channels canaux)
+ * @return 0 en cas de succès, code d'erreur sinon
+ */
+int hdf5_log_image_pitched(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                           const void* pixel_data, size_t width, size_t height, size_t channels,
+                           hdf5_dtype_t dtype, size_t row_pitch);
+
+/**
+ * @brief Ajoute une image fournie dans un format de caméra
+ *
+ * L'image est convertie en RGB 8 bits (RGBA pour HDF5_PIXEL_BGRA8) par la
+ * bibliothèque, puis écrite comme par hdf5_log_image dans la disposition du
+ * groupe. En mode asynchrone, l'image brute est recopiée (une image YUV ou
+ * Bayer est plus petite que sa conversion) et convertie par le thread
+ * d'écriture.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param image_name Nom du dataset pour cette image
+ * @param frame Première ligne de l'image (NV12 : le plan UV suit les height lignes du plan Y)
+ * @param width Largeur de l'image
+ * @param height Hauteur de l'image
+ * @param format Format des pixels
+ * @param row_pitch Octets entre le début de deux lignes (0 = lignes contiguës)
+ * @return 0 en cas de succès, -1 si le format, les dimensions ou le pas sont invalides
+ *         ou en cas d'erreur
+ */
+int hdf5_log_image_format(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                          const void* frame, size_t width, size_t height,
+                          hdf5_pixel_format_t format, size_t row_pitch);
+
+/**
+ * @brief Met à jour les tuiles modifiées d'une image déjà loguée
+ *
+ * pixel_data est l'image complète ; seuls les chunks (tuiles de 128 x 128
+ * pixels) qui couvrent une région modifiée sont recompressés et réécrits en
+ * place, les autres restent tels quels dans le fichier. Les régions sont
+ * données par rects, ou, sans rects, trouvées en comparant l'image à la
+ * précédente mise à jour (gardée en mémoire ; relue une fois du fichier au
+ * premier appel). Un dataset absent, de forme ou de type différent,
+ * stocké en plans (hdf5_logger_set_image_layout) ou partagé par la
+ * déduplication est écrit en entier comme par hdf5_log_image_typed.
+ * L'attribut timestamp est celui de la dernière mise à jour qui a modifié
+ * l'image.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param image_name Nom du dataset de l'image
+ * @param pixel_data Image complète (hauteur x largeur x canaux)
+ * @param width Largeur de l'image
+ * @param height Hauteur de l'image
+ * @param channels Nombre de canaux (1 à 4)
+ * @param dtype Type d'un canal
+ * @param rects Régions modifiées (NULL = comparaison avec l'image précédente)
+ * @param rect_count Nombre de régions (0 avec rects NULL ; une image inchangée n'écrit rien)
+ * @return 0 en cas de succès, -1 si une région sort de l'image ou en cas d'erreur
+ */
+int hdf5_log_image_update(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                          const void* pixel_data, size_t width, size_t height, size_t channels,
+                          hdf5_dtype_t dtype, const hdf5_image_rect_t* rects,
+                          size_t rect_count);
+
+/**
+ * @brief Ajoute une image à une séquence d'images (vidéo)
+ *
+ * Au premier appel, crée un dataset extensible [images, hauteur, largeur,
+ * canaux] dont le premier axe est illimité, avec les attributs width, height
+ * et channels, et la table <stream_name>_frames qui reçoit l'horodatage et le
+ * numéro de séquence de chaque image ; une séquence d'une session précédente
+ * est prolongée. Chaque chunk contient une seule image (ou une tuile d'une
+ * grande image) : l'image est écrite dès l'appel et se relit seule. Avec la
+ * prédiction HDF5_PREDICT_PNG_FRAME, un chunk regroupe plusieurs images
+ * successives, mises en attente comme les trames de hdf5_log_array_append.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param stream_name Nom du dataset de la séquence
+ * @param pixel_data Données de pixels de l'image
+ * @param width Largeur de l'image
+ * @param height Hauteur de l'image
+ * @param channels Nombre de canaux (1 à 4)
+ * @return 0 en cas de succès, -1 si l'image ne correspond pas à la séquence ou en cas d'erreur
+ */
+int hdf5_log_image_frame(hdf5_logger_t* logger, const char* group_path, const char* stream_name,
+                         const unsigned char* pixel_data, size_t width, size_t height,
+                         size_t channels);
+
+/**
+ * @brief Ajoute une image dont les canaux sont d'un type quelconque à une séquence
+ *
+ * Comme hdf5_log_image_frame ; le type est fixé par la première image de la séquence.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param stream_name Nom du dataset de la séquence
+ * @param pixel_data Données de pixels de l'image
+ * @param width Largeur de l'image
+ * @param height Hauteur de l'image
+ * @param channels Nombre de canaux (1 à 4)
+ * @param dtype Type d'un canal
+ * @return 0 en cas de succès, -1 si l'image ne correspond pas à la séquence ou en cas d'erreur
+ */
+int hdf5_log_image_frame_typed(hdf5_logger_t* logger, const char* group_path,
+                               const char* stream_name, const void* pixel_data, size_t width,
+                               size_t height, size_t channels, hdf5_dtype_t dtype);
+
+/**
+ * @brief Ajoute à une séquence une image dont les lignes sont espacées d'un pas
+ *
+ * Comme hdf5_log_image_frame_typed, avec le pas de hdf5_log_image_pitched.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param stream_name Nom du dataset de la séquence
+ * @param pixel_data Première ligne de l'image
+ * @param width Largeur de l'image
+ * @param height Hauteur de l'image
+ * @param channels Nombre de canaux (1 à 4)
+ * @param dtype Type d'un canal
+ * @param row_pitch Octets entre le début de deux lignes
+ * @return 0 en cas de succès, -1 si l'image ne correspond pas à la séquence ou en cas d'erreur
+ */
+int hdf5_log_image_frame_pitched(hdf5_logger_t* logger, const char* group_path,
+                                 const char* stream_name, const void* pixel_data, size_t width,
+                                 size_t height, size_t channels, hdf5_dtype_t dtype,
+                                 size_t row_pitch);
+
+/**
+ * @brief Ajoute une image sans la recopier ; le tampon reste à l'appelant jusqu'au rappel
+ *
+ * Même contrat que hdf5_log_array_submit, pour hdf5_log_image_typed.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param image_name Nom du dataset pour cette image
+ * @param pixel_data Données de pixels de l'image, empruntées jusqu'au rappel
+ * @param width Largeur de l'image
+ * @param height Hauteur de l'image
+ * @param channels Nombre de canaux (1 à 4)
+ * @param dtype Type d'un canal
+ * @param done Fonction appelée quand le tampon est rendu (obligatoire)
+ * @param user_data Donnée transmise à done
+ * @return 0 si l'image est prise en charge, -1 sinon (tampon rendu immédiatement)
+ */
+int hdf5_log_image_submit(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                          const void* pixel_data, size_t width, size_t height, size_t channels,
+                          hdf5_dtype_t dtype, hdf5_write_callback_t done, void* user_data);
+
+/**
+ * @brief Ajoute une image à une séquence sans la recopier
+ *
+ * Même contrat que hdf5_log_array_submit, pour hdf5_log_image_frame_typed.
+ * L'image est horodatée et numérotée à l'appel.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe dans le fichier HDF5
+ * @param stream_name Nom du dataset de la séquence
+ * @param pixel_data Données de pixels de l'image, empruntées jusqu'au rappel
+ * @param width Largeur de l'image
+ * @param height Hauteur de l'image
+ * @param channels Nombre de canaux (1 à 4)
+ * @param dtype Type d'un canal
+ * @param done Fonction appelée quand le tampon est rendu (obligatoire)
+ * @param user_data Donnée transmise à done
+ * @return 0 si l'image est prise en charge, -1 sinon (tampon rendu immédiatement)
+ */
+int hdf5_log_image_frame_submit(hdf5_logger_t* logger, const char* group_path,
+                                const char* stream_name, const void* pixel_data, size_t width,
+                                size_t height, size_t channels, hdf5_dtype_t dtype,
+                                hdf5_write_callback_t done, void* user_data);
+
 /**
  * @brief Ajoute un attribut à un groupe ou dataset
  * @param logger Pointeur vers le logger
@@ -144,6 +1059,70 @@ int hdf5_log_image(hdf5_logger_t* logger, const char* group_path, const char* im
 int hdf5_add_attribute(hdf5_logger_t* logger, const char* path, const char* attr_name,
                       const void* attr_value, int is_string);
 
+/*
+ * Macros de log à formatage différé
+ *
+ * Le logger et le niveau sont évalués une seule fois ; les autres arguments
+ * ne le sont que si le niveau passe le seuil du logger.
+ * Sous HDF5_LOGGER_MIN_LEVEL (option CMake du même nom, 0 = DEBUG à
+ * 4 = CRITICAL), les macros de niveau disparaissent à la compilation :
+ * ni appel, ni évaluation des arguments, ni chaîne de format dans le binaire.
+ */
+#ifndef HDF5_LOGGER_MIN_LEVEL
+#define HDF5_LOGGER_MIN_LEVEL 0
+#endif
+
+#define HDF5_LOGF(logger, level, ...)                                            \
+    do {                                                                         \
+        hdf5_logger_t* hdf5_logf_logger_ = (logger);                             \
+        hdf5_log_level_t hdf5_logf_level_ = (level);                             \
+        if ((int)hdf5_logf_level_ >= HDF5_LOGGER_MIN_LEVEL &&                    \
+            hdf5_logger_is_enabled(hdf5_logf_logger_, hdf5_logf_level_)) {       \
+            hdf5_log_textf(hdf5_logf_logger_, hdf5_logf_level_, __VA_ARGS__);    \
+        }                                                                        \
+    } while (0)
+
+#define HDF5_LOGF_TO_GROUP(logger, group_path, level, ...)                       \
+    do {                                                                         \
+        hdf5_logger_t* hdf5_logf_logger_ = (logger);                             \
+        hdf5_log_level_t hdf5_logf_level_ = (level);                             \
+        if ((int)hdf5_logf_level_ >= HDF5_LOGGER_MIN_LEVEL &&                    \
+            hdf5_logger_is_enabled(hdf5_logf_logger_, hdf5_logf_level_)) {       \
+            hdf5_log_textf_to_group(hdf5_logf_logger_, (group_path), hdf5_logf_level_, \
+                                    __VA_ARGS__);                                \
+        }                                                                        \
+    } while (0)
+
+#if HDF5_LOGGER_MIN_LEVEL <= 0
+#define HDF5_LOGF_DEBUG(logger, ...) HDF5_LOGF((logger), HDF5_LOG_DEBUG, __VA_ARGS__)
+#else
+#define HDF5_LOGF_DEBUG(logger, ...) do { } while (0)
+#endif
+
+#if HDF5_LOGGER_MIN_LEVEL <= 1
+#define HDF5_LOGF_INFO(logger, ...) HDF5_LOGF((logger), HDF5_LOG_INFO, __VA_ARGS__)
+#else
+#define HDF5_LOGF_INFO(logger, ...) do { } while (0)
+#endif
+
+#if HDF5_LOGGER_MIN_LEVEL <= 2
+#define HDF5_LOGF_WARNING(logger, ...) HDF5_LOGF((logger), HDF5_LOG_WARNING, __VA_ARGS__)
+#else
+#define HDF5_LOGF_WARNING(logger, ...) do { } while (0)
+#endif
+
+#if HDF5_LOGGER_MIN_LEVEL <= 3
+#define HDF5_LOGF_ERROR(logger, ...) HDF5_LOGF((logger), HDF5_LOG_ERROR, __VA_ARGS__)
+#else
+#define HDF5_LOGF_ERROR(logger, ...) do { } while (0)
+#endif
+
+#if HDF5_LOGGER_MIN_LEVEL <= 4
+#define HDF5_LOGF_CRITICAL(logger, ...) HDF5_LOGF((logger), HDF5_LOG_CRITICAL, __VA_ARGS__)
+#else
+#define HDF5_LOGF_CRITICAL(logger, ...) do { } while (0)
+#endif
+
 /**
  * @brief Récupère la version de la bibliothèque
  * @return Chaîne de caractères décrivant la version
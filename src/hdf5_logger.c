@@ -8,32 +8,27 @@
 #include <string.h>
 #include <time.h>
 #include "hdf5.h"
-#include "../include/hdf5_logger.h"
+#include "hdf5_logger_internal.h"
 
 /* Version de la bibliothèque */
 #define HDF5_LOGGER_VERSION "0.1.0"
 
-/* Définition de la structure interne du logger */
-struct hdf5_logger_s {
-    hid_t file_id;            /* ID du fichier HDF5 */
-    char* filename;           /* Nom du fichier */
-    int is_open;              /* Indicateur si le fichier est ouvert */
-};
-
-/**
- * @brief Crée un groupe HDF5 s'il n'existe pas déjà
- * @param file_id ID du fichier HDF5
- * @param group_path Chemin du groupe à créer
- * @return ID du groupe ou négatif en cas d'erreur
- */
-hid_t create_group_if_not_exists(hid_t file_id, const char* group_path);
+/* Enregistre le dernier numéro de séquence attribué (attribut text_sequence de la racine) */
+static int write_sequence(hdf5_logger_t* logger) {
+    unsigned long long sequence = atomic_load_u64(&logger->sequence);
+    return write_scalar_attribute(logger->file_id, "text_sequence", H5T_NATIVE_ULLONG, &sequence);
+}
 
 hdf5_logger_t* hdf5_logger_init(const char* filename) {
+    return hdf5_logger_init_with_options(filename, HDF5_FILE_DEFAULT);
+}
+
+hdf5_logger_t* hdf5_logger_init_with_options(const char* filename, unsigned int options) {
     if (filename == NULL || filename[0] == '\0') {
         return NULL;
     }
     
-    hdf5_logger_t* logger = (hdf5_logger_t*)malloc(sizeof(hdf5_logger_t));
+    hdf5_logger_t* logger = (hdf5_logger_t*)calloc(1, sizeof(hdf5_logger_t));
     if (logger == NULL) {
         return NULL;
     }
@@ -51,8 +46,14 @@ hdf5_logger_t* hdf5_logger_init(const char* filename) {
         /* Le fichier existe et est au format HDF5, l'ouvrir */
         file_id = H5Fopen(filename, H5F_ACC_RDWR, H5P_DEFAULT);
     } else {
-        /* Créer un nouveau fichier */
-        file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+        /* Créer un nouveau fichier ; sur demande, l'espace libéré par la purge des logs
+         * est suivi d'une session à l'autre pour être réutilisé (format 1.10) */
+        hid_t fcpl_id = H5Pcreate(H5P_FILE_CREATE);
+        if (options & HDF5_FILE_PERSIST_FREE_SPACE) {
+            H5Pset_file_space_strategy(fcpl_id, H5F_FSPACE_STRATEGY_FSM_AGGR, 1, 1);
+        }
+        file_id = H5Fcreate(filename, H5F_ACC_TRUNC, fcpl_id, H5P_DEFAULT);
+        H5Pclose(fcpl_id);
     }
     
     if (file_id < 0) {
@@ -64,6 +65,78 @@ hdf5_logger_t* hdf5_logger_init(const char* filename) {
     logger->file_id = file_id;
     logger->is_open = 1;
     
+    /* Le type composé des enregistrements texte est partagé par tous les canaux */
+    logger->record_type_id = create_text_record_type();
+    if (logger->record_type_id < 0) {
+        H5Fclose(file_id);
+        free(logger->filename);
+        free(logger);
+        return NULL;
+    }
+    
+    /* Verrous des appels concurrents */
+    if (stage_init(logger) < 0) {
+        H5Tclose(logger->record_type_id);
+        H5Fclose(file_id);
+        free(logger->filename);
+        free(logger);
+        return NULL;
+    }
+    
+    /* Formats des logs texte à formatage différé déjà internés dans le fichier */
+    if (format_table_open(logger) < 0) {
+        stage_destroy(logger);
+        H5Tclose(logger->record_type_id);
+        H5Fclose(file_id);
+        free(logger->filename);
+        free(logger);
+        return NULL;
+    }
+    
+    /* Niveaux minimaux des logs texte */
+    if (level_init(logger) < 0) {
+        format_table_close(logger);
+        stage_destroy(logger);
+        H5Tclose(logger->record_type_id);
+        H5Fclose(file_id);
+        free(logger->filename);
+        free(logger);
+        return NULL;
+    }
+    
+    /* Tampons de travail réutilisés */
+    logger->arena = arena_create(logger->id);
+    if (logger->arena == NULL) {
+        level_destroy(logger);
+        format_table_close(logger);
+        stage_destroy(logger);
+        H5Tclose(logger->record_type_id);
+        H5Fclose(file_id);
+        free(logger->filename);
+        free(logger);
+        return NULL;
+    }
+    
+    /* Les numéros de séquence continuent ceux de la session précédente */
+    read_scalar_attribute(file_id, "text_sequence", H5T_NATIVE_ULLONG,
+                          (void*)&logger->sequence);
+    
+    logger->batch_max_entries = HDF5_LOGGER_DEFAULT_BATCH_ENTRIES;
+    logger->batch_max_bytes = HDF5_LOGGER_DEFAULT_BATCH_BYTES;
+    logger->batch_max_delay = HDF5_LOGGER_DEFAULT_BATCH_DELAY;
+    logger->retention_interval = HDF5_LOGGER_DEFAULT_RETENTION_INTERVAL;
+    logger->array_layout.pattern = HDF5_ACCESS_ROW_SCAN;
+    logger->array_layout.chunk_bytes = HDF5_LOGGER_DEFAULT_CHUNK_BYTES;
+    logger->half_type_id = -1;
+    codec_init(logger);
+    logger->quantize_overrides = NULL;
+    logger->image_layouts = NULL;
+    logger->image_pyramids = NULL;
+    /* Les datasets prédits d'une session précédente sont relus au travers du filtre */
+    predict_register();
+    logger->compress_pool = NULL;
+    logger->streams = NULL;
+    
     /* Créer les groupes de base s'ils n'existent pas */
     hid_t group_id;
     
@@ -87,8 +160,46 @@ int hdf5_logger_close(hdf5_logger_t* logger) {
     int status = 0;
     
     if (logger->is_open) {
-        status = H5Fclose(logger->file_id);
+        /* Les threads qui se terminent ne fusionnent plus leurs tampons dans ce logger */
+        stage_detach(logger);
+        
+        /* En mode asynchrone, le thread d'écriture vide d'abord toute la file */
+        async_stop(logger);
+        
+        /* Les tampons des threads sont fusionnés avant la fermeture des canaux */
+        logger_mutex_lock(&logger->io_lock);
+        if (stage_merge(logger) < 0) {
+            status = -1;
+        }
+        
+        /* Fermer les canaux avant le fichier pour libérer leurs handles */
+        channel_table_close(logger);
+        if (stream_table_close(logger) < 0) {
+            status = -1;
+        }
+        if (format_table_sync(logger) < 0) {
+            status = -1;
+        }
+        format_table_close(logger);
+        write_sequence(logger);
+        dtype_close(logger);
+        H5Tclose(logger->record_type_id);
+        if (H5Fclose(logger->file_id) < 0) {
+            status = -1;
+        }
         logger->is_open = 0;
+        logger_mutex_unlock(&logger->io_lock);
+        
+        stage_destroy(logger);
+        level_destroy(logger);
+        codec_destroy(logger);
+        quantize_destroy(logger);
+        dedup_destroy(logger);
+        tile_destroy(logger);
+        image_layout_destroy(logger);
+        image_pyramid_destroy(logger);
+        pool_stop(logger->compress_pool);
+        arena_destroy(logger->arena);
     }
     
     free(logger->filename);
@@ -101,7 +212,78 @@ const char* hdf5_logger_version() {
     return HDF5_LOGGER_VERSION;
 }
 
-int hdf5_logger_set_time_limit(hdf5_logger_t* logger, const char* group_path, double max_time_seconds) {
+static int set_batch_policy(hdf5_logger_t* logger, size_t max_entries, size_t max_bytes,
+                            double max_delay_seconds) {
+    if (logger == NULL || !logger->is_open || max_entries == 0 || max_delay_seconds < 0) {
+        return -1;
+    }
+    
+    /* Écrire ce qui a été accumulé sous l'ancienne politique */
+    int status = channel_table_flush(logger);
+    
+    logger->batch_max_entries = max_entries;
+    logger->batch_max_bytes = max_bytes;
+    logger->batch_max_delay = max_delay_seconds;
+    
+    return status;
+}
+
+int hdf5_logger_set_batch_policy(hdf5_logger_t* logger, size_t max_entries, size_t max_bytes,
+                                 double max_delay_seconds) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+    
+    int status = set_batch_policy(logger, max_entries, max_bytes, max_delay_seconds);
+    
+    logger_unlock(logger);
+    return status;
+}
+
+int hdf5_logger_flush(hdf5_logger_t* logger) {
+    if (logger == NULL || !logger->is_open) {
+        return -1;
+    }
+    
+    /* Le thread d'écriture vide lui-même les canaux et le fichier */
+    if (logger->async != NULL) {
+        return async_flush(logger, 1);
+    }
+    
+    /* Les tampons des threads sont fusionnés, puis les canaux écrits */
+    logger_mutex_lock(&logger->io_lock);
+    int status = stage_merge(logger);
+    
+    if (channel_table_flush(logger) < 0 || write_sequence(logger) < 0 ||
+        H5Fflush(logger->file_id, H5F_SCOPE_LOCAL) < 0) {
+        status = -1;
+    }
+    
+    logger_mutex_unlock(&logger->io_lock);
+    return status;
+}
+
+static int set_retention_interval(hdf5_logger_t* logger, double interval_seconds) {
+    if (logger == NULL || !logger->is_open || interval_seconds < 0) {
+        return -1;
+    }
+    
+    logger->retention_interval = interval_seconds;
+    return 0;
+}
+
+int hdf5_logger_set_retention_interval(hdf5_logger_t* logger, double interval_seconds) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+    
+    int status = set_retention_interval(logger, interval_seconds);
+    
+    logger_unlock(logger);
+    return status;
+}
+
+static int set_time_limit(hdf5_logger_t* logger, const char* group_path, double max_time_seconds) {
     if (logger == NULL || !logger->is_open || group_path == NULL) {
         return -1;
     }
@@ -141,10 +323,27 @@ int hdf5_logger_set_time_limit(hdf5_logger_t* logger, const char* group_path, do
     H5Aclose(attr_id);
     H5Gclose(group_id);
     
+    /* Un canal ouvert convertit son stockage en segments temporels si nécessaire */
+    hdf5_log_channel_t* channel = channel_find(logger, group_path);
+    if (channel != NULL && status >= 0 && channel_set_max_time(channel, max_time_seconds) < 0) {
+        status = -1;
+    }
+    
     return (status < 0) ? -1 : 0;
 }
 
-int hdf5_logger_set_size_limit(hdf5_logger_t* logger, const char* group_path, size_t max_entries) {
+int hdf5_logger_set_time_limit(hdf5_logger_t* logger, const char* group_path, double max_time_seconds) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+    
+    int status = set_time_limit(logger, group_path, max_time_seconds);
+    
+    logger_unlock(logger);
+    return status;
+}
+
+static int set_size_limit(hdf5_logger_t* logger, const char* group_path, size_t max_entries) {
     if (logger == NULL || !logger->is_open || group_path == NULL) {
         return -1;
     }
@@ -185,11 +384,29 @@ int hdf5_logger_set_size_limit(hdf5_logger_t* logger, const char* group_path, si
     H5Aclose(attr_id);
     H5Gclose(group_id);
     
+    /* Mettre à jour la limite en cache si le canal est déjà ouvert */
+    /* Un canal ouvert convertit son stockage en anneau de la nouvelle capacité */
+    hdf5_log_channel_t* channel = channel_find(logger, group_path);
+    if (channel != NULL && status >= 0 && channel_set_max_entries(channel, hsize_max_entries) < 0) {
+        status = -1;
+    }
+    
     return (status < 0) ? -1 : 0;
 }
 
-int hdf5_add_attribute(hdf5_logger_t* logger, const char* path, const char* attr_name,
-                      const void* attr_value, int is_string) {
+int hdf5_logger_set_size_limit(hdf5_logger_t* logger, const char* group_path, size_t max_entries) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+    
+    int status = set_size_limit(logger, group_path, max_entries);
+    
+    logger_unlock(logger);
+    return status;
+}
+
+static int add_attribute(hdf5_logger_t* logger, const char* path, const char* attr_name,
+                         const void* attr_value, int is_string) {
     if (logger == NULL || !logger->is_open || path == NULL || attr_name == NULL || attr_value == NULL) {
         return -1;
     }
@@ -256,7 +473,21 @@ int hdf5_add_attribute(hdf5_logger_t* logger, const char* path, const char* attr
         case H5O_TYPE_DATASET:
             H5Dclose(obj_id);
             break;
+        default:
+            break;
     }
     
     return (status < 0) ? -1 : 0;
+}
+
+int hdf5_add_attribute(hdf5_logger_t* logger, const char* path, const char* attr_name,
+                      const void* attr_value, int is_string) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+    
+    int status = add_attribute(logger, path, attr_name, attr_value, is_string);
+    
+    logger_unlock(logger);
+    return status;
 }
\ No newline at end of file
@@ -0,0 +1,515 @@
+/**
+ * @file hdf5_logger_arena.c
+ * @brief Allocateur par classes de taille des tampons de travail
+ *
+ * Les enregistrements de la file asynchrone (logs texte, tableaux, images) et
+ * les tampons de compression des chunks sont pris dans des blocs dont la taille
+ * est une puissance de deux, de 64 octets à 64 Mio. Un bloc libéré n'est pas
+ * rendu au système : il retourne dans la liste de sa classe et sert à la
+ * demande suivante de même classe. En régime établi, aucune écriture n'alloue
+ * de mémoire.
+ *
+ * Chaque thread garde quelques petits blocs par classe, qu'il prend et rend
+ * sous le seul verrou de son cache, que personne d'autre ne dispute en temps
+ * normal ; il échange des lots avec les listes communes, protégées par le
+ * verrou de l'allocateur, quand son cache est vide ou plein. Les blocs libres
+ * sont rendus au système seulement pour respecter la limite mémoire : les
+ * caches des threads sont alors vidés eux aussi. À la sortie d'un thread, une
+ * clé de thread rend son cache aux listes communes.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5_logger_internal.h"
+#include "hdf5_logger_platform.h"
+
+/* Classes : ARENA_MIN_BLOCK << k octets de données, k de 0 à ARENA_CLASS_COUNT - 1 */
+#define ARENA_MIN_SHIFT 6
+#define ARENA_CLASS_COUNT 21
+#define ARENA_MIN_BLOCK ((size_t)1 << ARENA_MIN_SHIFT)
+#define ARENA_MAX_BLOCK (ARENA_MIN_BLOCK << (ARENA_CLASS_COUNT - 1))
+
+/* Classes gardées par les caches des threads (jusqu'à 64 Kio) */
+#define ARENA_CACHED_CLASSES 11
+
+/* Octets au plus gardés par classe dans le cache d'un thread, et blocs au plus */
+#define ARENA_CACHE_CLASS_BYTES (64 * 1024)
+#define ARENA_CACHE_MAX_BLOCKS 32
+
+/* Bloc plus grand que la dernière classe : alloué et libéré à chaque fois */
+#define ARENA_OVERSIZE (-1)
+
+/* En-tête d'un bloc, devant ses données ; 32 octets gardent les données alignées */
+typedef union arena_block_u {
+    struct {
+        union arena_block_u* next; /* Bloc libre suivant */
+        size_t capacity;           /* Octets de données */
+        int size_class;            /* Classe, ou ARENA_OVERSIZE */
+    } h;
+    char align[32];
+} arena_block_t;
+
+/* Cache d'un thread : son thread le remplit et le vide, la limite mémoire le reprend */
+typedef struct arena_cache_s {
+    const void* owner;                            /* Jeton du thread propriétaire */
+    struct memory_arena_s* arena;                 /* Allocateur du cache */
+    logger_mutex_t lock;                          /* Protège blocks et counts */
+    arena_block_t* blocks[ARENA_CACHED_CLASSES];  /* Blocs libres par classe */
+    size_t counts[ARENA_CACHED_CLASSES];          /* Nombre de blocs par classe */
+    volatile unsigned long long allocations;      /* Demandes du thread */
+    volatile unsigned long long reused;           /* Demandes servies sans le système */
+    volatile unsigned long long bytes_out;        /* Octets pris moins octets rendus par le thread */
+    struct arena_cache_s* next;                   /* Liste des caches de l'allocateur (sous son verrou) */
+
+    /* Caches du même thread, tous allocateurs confondus (sous threads_lock) */
+    struct arena_cache_s* thread_next;
+    struct arena_cache_s** thread_link;           /* Lien qui désigne ce cache (NULL = détaché) */
+} arena_cache_t;
+
+struct memory_arena_s {
+    unsigned long id;                             /* Identifiant du logger (caches par thread) */
+    logger_mutex_t lock;                          /* Protège tout ce qui suit */
+    arena_block_t* free_lists[ARENA_CLASS_COUNT]; /* Blocs libres communs par classe */
+    arena_cache_t* caches;                        /* Caches des threads */
+    size_t limit;                                 /* Octets au plus obtenus du système (0 = aucune limite) */
+    size_t reserved;                              /* Octets obtenus du système et non rendus */
+    size_t peak;                                  /* Maximum de reserved */
+    unsigned long long system_allocations;        /* Blocs obtenus du système */
+    unsigned long long failures;                  /* Demandes refusées par la limite */
+    unsigned long long allocations;               /* Demandes sans cache de thread */
+    unsigned long long reused;
+    unsigned long long bytes_out;
+};
+
+/* Dernier cache utilisé par le thread ; son adresse sert aussi de jeton de thread */
+typedef struct {
+    unsigned long arena_id;
+    arena_cache_t* cache;
+    arena_cache_t* owned;                         /* Caches créés par le thread (sous threads_lock) */
+} arena_tls_t;
+
+static LOGGER_THREAD_LOCAL arena_tls_t tls_arena;
+
+/* Clé dont le destructeur rend le cache d'un thread qui se termine */
+static logger_once_t arena_once = LOGGER_ONCE_INIT;
+static logger_key_t arena_key;
+static int arena_key_ready;
+
+/* Protège les listes de caches par thread ; pris avant le verrou d'un allocateur */
+static logger_mutex_t threads_lock;
+
+/* Classe d'une demande, ou ARENA_OVERSIZE */
+static int size_class(size_t bytes) {
+    if (bytes > ARENA_MAX_BLOCK) {
+        return ARENA_OVERSIZE;
+    }
+    int k = 0;
+    while ((ARENA_MIN_BLOCK << k) < bytes) {
+        k++;
+    }
+    return k;
+}
+
+/* Blocs au plus gardés dans le cache d'un thread pour une classe */
+static size_t cache_capacity(int k) {
+    size_t blocks = ARENA_CACHE_CLASS_BYTES / (ARENA_MIN_BLOCK << k);
+    return (blocks > ARENA_CACHE_MAX_BLOCKS) ? ARENA_CACHE_MAX_BLOCKS : blocks;
+}
+
+/* Rend tous les blocs d'un cache aux listes communes ; verrous de l'allocateur et du cache tenus */
+static void cache_drain(memory_arena_t* arena, arena_cache_t* cache) {
+    for (int k = 0; k < ARENA_CACHED_CLASSES; k++) {
+        while (cache->blocks[k] != NULL) {
+            arena_block_t* block = cache->blocks[k];
+            cache->blocks[k] = block->h.next;
+            block->h.next = arena->free_lists[k];
+            arena->free_lists[k] = block;
+        }
+        cache->counts[k] = 0;
+    }
+}
+
+/* Retire un cache de la liste de son thread (sous threads_lock) */
+static void cache_unlink_thread(arena_cache_t* cache) {
+    *cache->thread_link = cache->thread_next;
+    if (cache->thread_next != NULL) {
+        cache->thread_next->thread_link = cache->thread_link;
+    }
+    cache->thread_next = NULL;
+    cache->thread_link = NULL;
+}
+
+/* Rend le cache d'un thread terminé et reporte ses compteurs sur l'allocateur */
+static void cache_release(arena_cache_t* cache) {
+    memory_arena_t* arena = cache->arena;
+
+    logger_mutex_lock(&arena->lock);
+    logger_mutex_lock(&cache->lock);
+    cache_drain(arena, cache);
+    logger_mutex_unlock(&cache->lock);
+
+    arena->allocations += atomic_load_u64(&cache->allocations);
+    arena->reused += atomic_load_u64(&cache->reused);
+    arena->bytes_out += atomic_load_u64(&cache->bytes_out);
+
+    arena_cache_t** link = &arena->caches;
+    while (*link != cache) {
+        link = &(*link)->next;
+    }
+    *link = cache->next;
+    logger_mutex_unlock(&arena->lock);
+
+    logger_mutex_destroy(&cache->lock);
+    free(cache);
+}
+
+static void LOGGER_KEY_CALLBACK arena_thread_exit(void* value) {
+    arena_tls_t* tls = (arena_tls_t*)value;
+
+    logger_mutex_lock(&threads_lock);
+    while (tls->owned != NULL) {
+        arena_cache_t* cache = tls->owned;
+        cache_unlink_thread(cache);
+        cache_release(cache);
+    }
+    tls->arena_id = 0;
+    tls->cache = NULL;
+    logger_mutex_unlock(&threads_lock);
+}
+
+static void arena_key_init(void) {
+    if (logger_mutex_init(&threads_lock) < 0) {
+        return;
+    }
+    if (logger_key_create(&arena_key, arena_thread_exit) < 0) {
+        logger_mutex_destroy(&threads_lock);
+        return;
+    }
+    arena_key_ready = 1;
+}
+
+/* Inscrit un nouveau cache dans la liste du thread appelant */
+static void cache_attach_thread(arena_cache_t* cache) {
+    logger_once(&arena_once, arena_key_init);
+    if (!arena_key_ready) {
+        return; /* Sans clé, le cache vit jusqu'à la destruction de l'allocateur */
+    }
+
+    logger_mutex_lock(&threads_lock);
+    if (tls_arena.owned == NULL && logger_key_set(arena_key, &tls_arena) < 0) {
+        logger_mutex_unlock(&threads_lock);
+        return;
+    }
+    cache->thread_next = tls_arena.owned;
+    cache->thread_link = &tls_arena.owned;
+    if (tls_arena.owned != NULL) {
+        tls_arena.owned->thread_link = &cache->thread_next;
+    }
+    tls_arena.owned = cache;
+    logger_mutex_unlock(&threads_lock);
+}
+
+/* Retrouve ou crée le cache du thread appelant ; NULL si la mémoire manque */
+static arena_cache_t* cache_get(memory_arena_t* arena) {
+    if (tls_arena.arena_id == arena->id) {
+        return tls_arena.cache;
+    }
+
+    logger_mutex_lock(&arena->lock);
+    arena_cache_t* cache = arena->caches;
+    while (cache != NULL && cache->owner != (const void*)&tls_arena) {
+        cache = cache->next;
+    }
+    int created = 0;
+    if (cache == NULL) {
+        cache = (arena_cache_t*)calloc(1, sizeof(arena_cache_t));
+        if (cache != NULL && logger_mutex_init(&cache->lock) < 0) {
+            free(cache);
+            cache = NULL;
+        }
+        if (cache != NULL) {
+            cache->owner = &tls_arena;
+            cache->arena = arena;
+            cache->next = arena->caches;
+            arena->caches = cache;
+            created = 1;
+        }
+    }
+    logger_mutex_unlock(&arena->lock);
+
+    /* threads_lock se prend avant le verrou de l'allocateur : inscription une fois ce dernier relâché */
+    if (created) {
+        cache_attach_thread(cache);
+    }
+
+    if (cache != NULL) {
+        tls_arena.arena_id = arena->id;
+        tls_arena.cache = cache;
+    }
+    return cache;
+}
+
+/* Rend au système des blocs libres communs jusqu'à ce que need octets tiennent sous la limite */
+static void arena_release_free(memory_arena_t* arena, size_t need) {
+    for (int k = ARENA_CLASS_COUNT - 1; k >= 0; k--) {
+        while (arena->reserved + need > arena->limit && arena->free_lists[k] != NULL) {
+            arena_block_t* block = arena->free_lists[k];
+            arena->free_lists[k] = block->h.next;
+            arena->reserved -= sizeof(arena_block_t) + block->h.capacity;
+            free(block);
+        }
+    }
+}
+
+/* Fait tenir need octets de plus sous la limite, en reprenant au besoin les blocs gardés
+ * par les caches des threads ; verrou tenu. Renvoie 1 si la place est faite */
+static int arena_make_room(memory_arena_t* arena, size_t need) {
+    arena_release_free(arena, need);
+    if (arena->reserved + need > arena->limit) {
+        for (arena_cache_t* cache = arena->caches; cache != NULL; cache = cache->next) {
+            logger_mutex_lock(&cache->lock);
+            cache_drain(arena, cache);
+            logger_mutex_unlock(&cache->lock);
+        }
+        arena_release_free(arena, need);
+    }
+    return arena->reserved + need <= arena->limit;
+}
+
+/* Prend un bloc de classe k dans les listes communes ou au système ; verrou tenu */
+static arena_block_t* arena_take(memory_arena_t* arena, int k, size_t bytes, int* reused) {
+    if (k != ARENA_OVERSIZE && arena->free_lists[k] != NULL) {
+        arena_block_t* block = arena->free_lists[k];
+        arena->free_lists[k] = block->h.next;
+        *reused = 1;
+        return block;
+    }
+
+    size_t capacity = (k == ARENA_OVERSIZE) ? bytes : (ARENA_MIN_BLOCK << k);
+    size_t need = sizeof(arena_block_t) + capacity;
+    if (arena->limit > 0 && !arena_make_room(arena, need)) {
+        arena->failures++;
+        return NULL;
+    }
+
+    arena_block_t* block = (arena_block_t*)malloc(need);
+    if (block == NULL) {
+        arena->failures++;
+        return NULL;
+    }
+    block->h.capacity = capacity;
+    block->h.size_class = k;
+    arena->reserved += need;
+    if (arena->reserved > arena->peak) {
+        arena->peak = arena->reserved;
+    }
+    arena->system_allocations++;
+    *reused = 0;
+    return block;
+}
+
+memory_arena_t* arena_create(unsigned long id) {
+    memory_arena_t* arena = (memory_arena_t*)calloc(1, sizeof(memory_arena_t));
+    if (arena == NULL) {
+        return NULL;
+    }
+    if (logger_mutex_init(&arena->lock) < 0) {
+        free(arena);
+        return NULL;
+    }
+    arena->id = id;
+    return arena;
+}
+
+void arena_destroy(memory_arena_t* arena) {
+    if (arena == NULL) {
+        return;
+    }
+
+    /* Les threads encore vivants ne rendront plus leur cache à cet allocateur */
+    logger_once(&arena_once, arena_key_init);
+    if (arena_key_ready) {
+        logger_mutex_lock(&threads_lock);
+        for (arena_cache_t* cache = arena->caches; cache != NULL; cache = cache->next) {
+            if (cache->thread_link != NULL) {
+                cache_unlink_thread(cache);
+            }
+        }
+        logger_mutex_unlock(&threads_lock);
+    }
+
+    /* Tous les blocs ont été rendus : il ne reste que ceux des listes et des caches */
+    while (arena->caches != NULL) {
+        arena_cache_t* cache = arena->caches;
+        for (int k = 0; k < ARENA_CACHED_CLASSES; k++) {
+            while (cache->blocks[k] != NULL) {
+                arena_block_t* block = cache->blocks[k];
+                cache->blocks[k] = block->h.next;
+                free(block);
+            }
+        }
+        arena->caches = cache->next;
+        logger_mutex_destroy(&cache->lock);
+        free(cache);
+    }
+    for (int k = 0; k < ARENA_CLASS_COUNT; k++) {
+        while (arena->free_lists[k] != NULL) {
+            arena_block_t* block = arena->free_lists[k];
+            arena->free_lists[k] = block->h.next;
+            free(block);
+        }
+    }
+    logger_mutex_destroy(&arena->lock);
+    free(arena);
+}
+
+void* arena_alloc(memory_arena_t* arena, size_t bytes) {
+    int k = size_class(bytes);
+    arena_cache_t* cache = cache_get(arena);
+    int cached = (cache != NULL && k != ARENA_OVERSIZE && k < ARENA_CACHED_CLASSES);
+    arena_block_t* block = NULL;
+    int reused = 1;
+
+    /* Chemin courant : un bloc du cache du thread, sous son seul verrou */
+    if (cached) {
+        logger_mutex_lock(&cache->lock);
+        block = cache->blocks[k];
+        if (block != NULL) {
+            cache->blocks[k] = block->h.next;
+            cache->counts[k]--;
+        }
+        logger_mutex_unlock(&cache->lock);
+    }
+
+    if (block == NULL) {
+        logger_mutex_lock(&arena->lock);
+        block = arena_take(arena, k, bytes, &reused);
+
+        /* Cache vide : le remplir à moitié d'un coup pour les demandes suivantes */
+        if (block != NULL && cached) {
+            size_t refill = cache_capacity(k) / 2;
+            logger_mutex_lock(&cache->lock);
+            while (cache->counts[k] < refill && arena->free_lists[k] != NULL) {
+                arena_block_t* spare = arena->free_lists[k];
+                arena->free_lists[k] = spare->h.next;
+                spare->h.next = cache->blocks[k];
+                cache->blocks[k] = spare;
+                cache->counts[k]++;
+            }
+            logger_mutex_unlock(&cache->lock);
+        }
+        if (cache == NULL) {
+            arena->allocations++;
+            arena->reused += (block != NULL && reused);
+            arena->bytes_out += (block != NULL) ? block->h.capacity : 0;
+        }
+        logger_mutex_unlock(&arena->lock);
+    }
+
+    if (cache != NULL) {
+        atomic_add_u64(&cache->allocations, 1);
+        if (block != NULL) {
+            atomic_add_u64(&cache->reused, (unsigned long long)reused);
+            atomic_add_u64(&cache->bytes_out, (unsigned long long)block->h.capacity);
+        }
+    }
+    return (block != NULL) ? (void*)(block + 1) : NULL;
+}
+
+void arena_free(memory_arena_t* arena, void* data) {
+    if (data == NULL) {
+        return;
+    }
+
+    arena_block_t* block = (arena_block_t*)data - 1;
+    int k = block->h.size_class;
+    arena_cache_t* cache = cache_get(arena);
+    if (cache != NULL) {
+        atomic_add_u64(&cache->bytes_out, (unsigned long long)0 - block->h.capacity);
+    }
+
+    /* Chemin courant : retour dans le cache du thread, sous son seul verrou */
+    if (cache != NULL && k != ARENA_OVERSIZE && k < ARENA_CACHED_CLASSES) {
+        logger_mutex_lock(&cache->lock);
+        if (cache->counts[k] < cache_capacity(k)) {
+            block->h.next = cache->blocks[k];
+            cache->blocks[k] = block;
+            cache->counts[k]++;
+            logger_mutex_unlock(&cache->lock);
+            return;
+        }
+        logger_mutex_unlock(&cache->lock);
+    }
+
+    logger_mutex_lock(&arena->lock);
+    if (cache == NULL) {
+        arena->bytes_out -= block->h.capacity;
+    }
+    if (k == ARENA_OVERSIZE) {
+        arena->reserved -= sizeof(arena_block_t) + block->h.capacity;
+        free(block);
+    } else {
+        block->h.next = arena->free_lists[k];
+        arena->free_lists[k] = block;
+
+        /* Cache plein : en rendre la moitié aux listes communes d'un coup */
+        if (cache != NULL && k < ARENA_CACHED_CLASSES) {
+            size_t keep = cache_capacity(k) / 2;
+            logger_mutex_lock(&cache->lock);
+            while (cache->counts[k] > keep) {
+                arena_block_t* spare = cache->blocks[k];
+                cache->blocks[k] = spare->h.next;
+                cache->counts[k]--;
+                spare->h.next = arena->free_lists[k];
+                arena->free_lists[k] = spare;
+            }
+            logger_mutex_unlock(&cache->lock);
+        }
+    }
+    logger_mutex_unlock(&arena->lock);
+}
+
+/* Implémentation des fonctions publiques */
+
+int hdf5_logger_set_memory_limit(hdf5_logger_t* logger, size_t max_bytes) {
+    if (logger == NULL || !logger->is_open) {
+        return -1;
+    }
+
+    memory_arena_t* arena = logger->arena;
+    logger_mutex_lock(&arena->lock);
+    arena->limit = max_bytes;
+    if (max_bytes > 0) {
+        arena_make_room(arena, 0);
+    }
+    logger_mutex_unlock(&arena->lock);
+    return 0;
+}
+
+int hdf5_logger_get_arena_stats(hdf5_logger_t* logger, hdf5_arena_stats_t* stats) {
+    if (logger == NULL || !logger->is_open || stats == NULL) {
+        return -1;
+    }
+
+    memory_arena_t* arena = logger->arena;
+    logger_mutex_lock(&arena->lock);
+    unsigned long long allocations = arena->allocations;
+    unsigned long long reused = arena->reused;
+    unsigned long long bytes_out = arena->bytes_out;
+    for (arena_cache_t* cache = arena->caches; cache != NULL; cache = cache->next) {
+        allocations += atomic_load_u64(&cache->allocations);
+        reused += atomic_load_u64(&cache->reused);
+        bytes_out += atomic_load_u64(&cache->bytes_out);
+    }
+
+    stats->allocations = allocations;
+    stats->reused = reused;
+    stats->system_allocations = arena->system_allocations;
+    stats->failures = arena->failures;
+    stats->bytes_in_use = (size_t)bytes_out;
+    stats->bytes_reserved = arena->reserved;
+    stats->peak_bytes = arena->peak;
+    stats->limit = arena->limit;
+    logger_mutex_unlock(&arena->lock);
+    return 0;
+}
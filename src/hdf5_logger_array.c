@@ -8,23 +8,27 @@
 #include <string.h>
 #include <time.h>
 #include "hdf5.h"
-#include "../include/hdf5_logger.h"
-
-/* Fonction interne pour créer un groupe s'il n'existe pas */
-extern hid_t create_group_if_not_exists(hid_t file_id, const char* group_path);
+#include "hdf5_logger_internal.h"
 
 /* Implémentation interne pour les tableaux */
-static int log_array_internal(hid_t file_id, const char* group_path, const char* dataset_name,
-                            const void* data, int rank, hsize_t* dims, int is_double) {
-    if (file_id < 0 || group_path == NULL || dataset_name == NULL || data == NULL || dims == NULL) {
+int array_write(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
+                const void* data, int rank, const hsize_t* dims, hdf5_dtype_t dtype,
+                const hdf5_array_layout_t* layout, const source_view_t* view) {
+    if (group_path == NULL || dataset_name == NULL || data == NULL || dims == NULL) {
         return -1;
     }
     
     herr_t status;
     hid_t group_id, dataset_id, dataspace_id, datatype_id;
     
+    /* Type des éléments, identique en mémoire et dans le fichier (aucune conversion) */
+    datatype_id = dtype_type(logger, dtype);
+    if (datatype_id < 0) {
+        return -1;
+    }
+    
     /* Créer le groupe s'il n'existe pas */
-    group_id = create_group_if_not_exists(file_id, group_path);
+    group_id = create_group_if_not_exists(logger->file_id, group_path);
     if (group_id < 0) {
         return -1;
     }
@@ -36,31 +40,45 @@ static int log_array_internal(hid_t file_id, const char* group_path, const char*
         return -1;
     }
     
-    /* Déterminer le type de données (float ou double) */
-    datatype_id = is_double ? H5T_NATIVE_DOUBLE : H5T_NATIVE_FLOAT;
-    
     /* Créer le dataset avec compression */
     hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
     
-    /* Configurer la compression si le tableau est assez grand */
-    size_t total_elements = 1;
+    /* Forme des chunks choisie d'après la taille cible et le motif d'accès */
+    hsize_t chunk_dims[HDF5_LOGGER_MAX_RANK];
+    size_t element_size = dtype_size(dtype);
+    const hdf5_codec_policy_t* codec = codec_resolve(logger, group_path, HDF5_DATA_NUMERIC);
+    int chunked = (chunk_plan(rank, dims, element_size, layout, chunk_dims) > 0);
+    if (chunked) {
+        status = H5Pset_chunk(plist_id, rank, chunk_dims);
+        
+        /* Compression choisie pour les tableaux de ce groupe */
+        status = codec_apply(plist_id, codec, element_size, 0);
+    }
+    
+    /* Une série ouverte sous ce nom est écrite et fermée avant d'être remplacée */
+    stream_close(logger, group_path, dataset_name);
+    tile_forget(logger, group_path, dataset_name);
+    
+    size_t count = 1;
     for (int i = 0; i < rank; i++) {
-        total_elements *= dims[i];
+        count *= (size_t)dims[i];
     }
+    const hdf5_quantize_t* quantize = quantize_resolve(logger, group_path, dataset_name, dtype);
     
-    if (total_elements > 100) {
-        /* Configurer le chunking pour les tableaux volumineux */
-        hsize_t chunk_dims[3] = {1, 1, 1};  /* Valeurs par défaut */
-        
-        /* Ajuster les dimensions de chunk selon la taille et le rang */
-        for (int i = 0; i < rank && i < 3; i++) {
-            chunk_dims[i] = (dims[i] > 20) ? 20 : dims[i];
+    /* Contenu déjà écrit : lien dur vers son dataset, sans rien compresser ni écrire */
+    uint64_t hash[2];
+    int hashed = logger->dedup.enabled &&
+                 dedup_hash(logger, HDF5_DATA_NUMERIC, data, view, rank, dims, dtype, quantize,
+                            hash) == 0;
+    if (hashed) {
+        int linked = dedup_link(logger, group_id, group_path, dataset_name, hash,
+                                count * element_size);
+        if (linked != 0) {
+            H5Pclose(plist_id);
+            H5Sclose(dataspace_id);
+            H5Gclose(group_id);
+            return (linked < 0) ? -1 : 0;
         }
-        
-        status = H5Pset_chunk(plist_id, rank, chunk_dims);
-        
-        /* Activer la compression GZIP niveau 6 */
-        status = H5Pset_deflate(plist_id, 6);
     }
     
     /* Vérifier si le dataset existe déjà */
@@ -78,8 +96,46 @@ static int log_array_internal(hid_t file_id, const char* group_path, const char*
         return -1;
     }
     
-    /* Écrire les données */
-    status = H5Dwrite(dataset_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    /* Flottants quantifiés : valeurs arrondies dans un tampon de travail, qui remplace aussi
+     * la sélection d'un tampon non contigu */
+    void* quantized = NULL;
+    if (quantize != NULL) {
+        quantized = arena_alloc(logger->arena, count * element_size);
+        if (quantized == NULL || quantize_write_attributes(dataset_id, quantize) < 0) {
+            arena_free(logger->arena, quantized);
+            H5Dclose(dataset_id);
+            H5Pclose(plist_id);
+            H5Sclose(dataspace_id);
+            H5Gclose(group_id);
+            return -1;
+        }
+        if (view != NULL) {
+            view_gather(view, data, element_size, 0, count, quantized);
+            quantize_copy(quantize, dtype, quantized, quantized, count);
+        } else {
+            quantize_copy(quantize, dtype, data, quantized, count);
+        }
+        data = quantized;
+        view = NULL;
+    }
+    
+    /* Écrire les données, chunks compressés en parallèle si possible ; un tampon non contigu
+     * est lu au travers de sa sélection */
+    if (chunked) {
+        status = chunks_write(logger, dataset_id, datatype_id, rank, NULL, dims, chunk_dims, codec,
+                              data, view);
+    } else if (view != NULL) {
+        hid_t mem_space = view_space(view);
+        status = (mem_space < 0) ? -1 : H5Dwrite(dataset_id, datatype_id, mem_space, H5S_ALL,
+                                                 H5P_DEFAULT, data);
+        if (mem_space >= 0) H5Sclose(mem_space);
+    } else {
+        status = H5Dwrite(dataset_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+    }
+    arena_free(logger->arena, quantized);
+    if (hashed && status >= 0) {
+        dedup_record(logger, dataset_id, group_path, dataset_name, hash);
+    }
     
     /* Ajouter un attribut pour l'horodatage */
     hid_t attr_space = H5Screate(H5S_SCALAR);
@@ -100,37 +156,210 @@ static int log_array_internal(hid_t file_id, const char* group_path, const char*
     return (status < 0) ? -1 : 0;
 }
 
+/* Écrit le tableau sous le verrou du logger, ou le dépose dans la file en mode asynchrone ;
+ * avec done, les données sont empruntées et rendues par done une fois écrites */
+static int log_array(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
+                     const void* data, int rank, const hsize_t* dims, hdf5_dtype_t dtype,
+                     const hdf5_array_layout_t* layout, const source_view_t* view,
+                     hdf5_write_callback_t done, void* user_data) {
+    if (dtype_size(dtype) == 0) {
+        return -1;
+    }
+    
+    if (logger->async != NULL) {
+        hdf5_array_layout_t chosen = (layout != NULL) ? *layout : logger->array_layout;
+        return async_submit_array(logger, group_path, dataset_name, data, rank, dims, dtype,
+                                  &chosen, view, done, user_data);
+    }
+
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+    int status = array_write(logger, group_path, dataset_name, data, rank, dims, dtype,
+                             (layout != NULL) ? layout : &logger->array_layout, view);
+    logger_unlock(logger);
+
+    if (done != NULL) {
+        done(user_data, status);
+        return 0;
+    }
+    return status;
+}
+
 /* Implémentation des fonctions publiques */
 
 int hdf5_log_array_1d(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
-                     const void* data, size_t size, int is_double) {
+                     const void* data, size_t size, hdf5_dtype_t dtype) {
     if (logger == NULL || !logger->is_open || group_path == NULL || 
         dataset_name == NULL || data == NULL || size == 0) {
         return -1;
     }
     
     hsize_t dims[1] = {size};
-    return log_array_internal(logger->file_id, group_path, dataset_name, data, 1, dims, is_double);
+    return log_array(logger, group_path, dataset_name, data, 1, dims, dtype, NULL, NULL, NULL,
+                     NULL);
 }
 
 int hdf5_log_array_2d(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
-                     const void* data, size_t rows, size_t cols, int is_double) {
+                     const void* data, size_t rows, size_t cols, hdf5_dtype_t dtype) {
     if (logger == NULL || !logger->is_open || group_path == NULL || 
         dataset_name == NULL || data == NULL || rows == 0 || cols == 0) {
         return -1;
     }
     
     hsize_t dims[2] = {rows, cols};
-    return log_array_internal(logger->file_id, group_path, dataset_name, data, 2, dims, is_double);
+    return log_array(logger, group_path, dataset_name, data, 2, dims, dtype, NULL, NULL, NULL,
+                     NULL);
 }
 
 int hdf5_log_array_3d(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
-                     const void* data, size_t dim1, size_t dim2, size_t dim3, int is_double) {
+                     const void* data, size_t dim1, size_t dim2, size_t dim3, hdf5_dtype_t dtype) {
     if (logger == NULL || !logger->is_open || group_path == NULL || 
         dataset_name == NULL || data == NULL || dim1 == 0 || dim2 == 0 || dim3 == 0) {
         return -1;
     }
     
     hsize_t dims[3] = {dim1, dim2, dim3};
-    return log_array_internal(logger->file_id, group_path, dataset_name, data, 3, dims, is_double);
-}
\ No newline at end of file
+    return log_array(logger, group_path, dataset_name, data, 3, dims, dtype, NULL, NULL, NULL,
+                     NULL);
+}
+
+int hdf5_log_array_nd(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
+                      const void* data, int rank, const size_t* dims, hdf5_dtype_t dtype,
+                      const hdf5_array_layout_t* layout) {
+    if (logger == NULL || !logger->is_open || group_path == NULL || dataset_name == NULL ||
+        data == NULL || dims == NULL || rank < 1 || rank > HDF5_LOGGER_MAX_RANK) {
+        return -1;
+    }
+    
+    if (layout != NULL && (layout->pattern < HDF5_ACCESS_ROW_SCAN ||
+                           layout->pattern > HDF5_ACCESS_LEGACY)) {
+        return -1;
+    }
+    
+    hsize_t hdims[HDF5_LOGGER_MAX_RANK];
+    for (int i = 0; i < rank; i++) {
+        if (dims[i] == 0) {
+            return -1;
+        }
+        hdims[i] = dims[i];
+    }
+    return log_array(logger, group_path, dataset_name, data, rank, hdims, dtype, layout, NULL,
+                     NULL, NULL);
+}
+
+int hdf5_log_array_strided(hdf5_logger_t* logger, const char* group_path,
+                           const char* dataset_name, const void* data, int rank,
+                           const size_t* dims, hdf5_dtype_t dtype,
+                           const hdf5_source_layout_t* source, const hdf5_array_layout_t* layout) {
+    if (logger == NULL || !logger->is_open || group_path == NULL || dataset_name == NULL ||
+        data == NULL || dims == NULL || rank < 1 || rank > HDF5_LOGGER_MAX_RANK) {
+        return -1;
+    }
+    
+    if (layout != NULL && (layout->pattern < HDF5_ACCESS_ROW_SCAN ||
+                           layout->pattern > HDF5_ACCESS_LEGACY)) {
+        return -1;
+    }
+    
+    hsize_t hdims[HDF5_LOGGER_MAX_RANK];
+    for (int i = 0; i < rank; i++) {
+        if (dims[i] == 0) {
+            return -1;
+        }
+        hdims[i] = dims[i];
+    }
+    
+    /* Un tableau dense dans son tampon s'écrit comme hdf5_log_array_nd */
+    source_view_t view;
+    int dense = 1;
+    if (source != NULL) {
+        dense = view_from_layout(&view, rank, hdims, source);
+        if (dense < 0) {
+            return -1;
+        }
+    }
+    
+    /* Le début du tampon reste l'origine de la sélection */
+    return log_array(logger, group_path, dataset_name, data, rank, hdims, dtype, layout,
+                     dense ? NULL : &view, NULL, NULL);
+}
+
+int hdf5_log_array_submit(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
+                          const void* data, int rank, const size_t* dims, hdf5_dtype_t dtype,
+                          hdf5_write_callback_t done, void* user_data) {
+    if (logger == NULL || !logger->is_open || group_path == NULL || dataset_name == NULL ||
+        data == NULL || dims == NULL || done == NULL || rank < 1 || rank > HDF5_LOGGER_MAX_RANK) {
+        return -1;
+    }
+    
+    hsize_t hdims[HDF5_LOGGER_MAX_RANK];
+    for (int i = 0; i < rank; i++) {
+        if (dims[i] == 0) {
+            return -1;
+        }
+        hdims[i] = dims[i];
+    }
+    return log_array(logger, group_path, dataset_name, data, rank, hdims, dtype, NULL, NULL, done,
+                     user_data);
+}
+
+int hdf5_log_array_append(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
+                          const void* data, int rank, const size_t* dims, hdf5_dtype_t dtype) {
+    if (logger == NULL || !logger->is_open || group_path == NULL || dataset_name == NULL ||
+        data == NULL || dims == NULL || rank < 1 || rank >= HDF5_LOGGER_MAX_RANK ||
+        dtype_size(dtype) == 0) {
+        return -1;
+    }
+    
+    hsize_t hdims[HDF5_LOGGER_MAX_RANK];
+    for (int i = 0; i < rank; i++) {
+        if (dims[i] == 0) {
+            return -1;
+        }
+        hdims[i] = dims[i];
+    }
+    
+    /* En mode asynchrone, la trame est horodatée au dépôt */
+    if (logger->async != NULL) {
+        return async_submit_array_append(logger, group_path, dataset_name, data, rank, hdims,
+                                         dtype);
+    }
+    
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+    int status = stream_append(logger, group_path, dataset_name, data, rank, hdims, dtype,
+                               get_current_time());
+    logger_unlock(logger);
+    return status;
+}
+
+static int set_array_layout(hdf5_logger_t* logger, const hdf5_array_layout_t* layout) {
+    if (logger == NULL || !logger->is_open) {
+        return -1;
+    }
+    
+    if (layout == NULL) {
+        logger->array_layout.pattern = HDF5_ACCESS_ROW_SCAN;
+        logger->array_layout.chunk_bytes = HDF5_LOGGER_DEFAULT_CHUNK_BYTES;
+        return 0;
+    }
+    
+    if (layout->pattern < HDF5_ACCESS_ROW_SCAN || layout->pattern > HDF5_ACCESS_LEGACY) {
+        return -1;
+    }
+    logger->array_layout = *layout;
+    return 0;
+}
+
+int hdf5_logger_set_array_layout(hdf5_logger_t* logger, const hdf5_array_layout_t* layout) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+    
+    int status = set_array_layout(logger, layout);
+    
+    logger_unlock(logger);
+    return status;
+}
@@ -0,0 +1,882 @@
+/**
+ * @file hdf5_logger_async.c
+ * @brief Mode asynchrone : file bornée sans verrou et thread d'écriture dédié
+ *
+ * En mode asynchrone, les appels de log copient leurs données dans un
+ * enregistrement et le déposent dans une file circulaire bornée à plusieurs
+ * producteurs (algorithme de D. Vyukov : un numéro de séquence par case, une
+ * seule instruction atomique par dépôt). Un unique thread d'écriture vide la
+ * file et fait toutes les entrées/sorties HDF5 sous le verrou io_lock du logger,
+ * que les appels synchrones (limites, relecture, attributs) prennent aussi après
+ * avoir attendu que la file soit écrite. Les logs texte reçoivent leur numéro
+ * de séquence au dépôt.
+ *
+ * Les rappels des dépôts sans copie sont appelés par le thread d'écriture une
+ * fois io_lock relâché, y compris pour les enregistrements abandonnés par
+ * HDF5_ASYNC_DROP_OLDEST : un rappel peut donc appeler le logger. Depuis le
+ * thread d'écriture, un vidage n'attend pas la file et un dépôt n'attend jamais
+ * de place.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+#include "hdf5_logger_platform.h"
+
+/* Capacité par défaut de la file (en enregistrements) */
+#define ASYNC_DEFAULT_QUEUE_CAPACITY 8192
+
+/* Nombre maximal d'enregistrements traités par le thread d'écriture sous un même verrou */
+#define WRITER_BATCH_RECORDS 256
+
+/* Attente maximale du thread d'écriture inactif, pour appliquer le délai de vidage (s) */
+#define WRITER_IDLE_WAIT 0.05
+
+/* Attente maximale d'un producteur bloqué avant de revérifier la file (s) */
+#define PRODUCER_WAIT 0.01
+
+/* Nature d'un enregistrement de la file */
+typedef enum {
+    RECORD_TEXT,
+    RECORD_TEXT_BATCH,
+    RECORD_ARRAY,
+    RECORD_ARRAY_APPEND,
+    RECORD_IMAGE,
+    RECORD_IMAGE_FRAME,
+    RECORD_IMAGE_UPDATE,
+    RECORD_IMAGE_FORMAT
+} record_kind_t;
+
+/* Enregistrement en file : les données copiées suivent la structure dans la même allocation */
+typedef struct async_record_s {
+    record_kind_t kind;
+    int level;                    /* Niveau (HDF5_LOG_INFO pour tableaux et images) */
+    double timestamp;             /* Horodatage pris au dépôt */
+    unsigned long long sequence;  /* Numéro de séquence (du premier élément pour un lot) */
+    hdf5_log_channel_t* channel;  /* Canal cible, ou NULL pour passer par group_path */
+    const char* group_path;       /* Chemin du groupe */
+    const char* name;             /* Nom du dataset (tableaux et images) */
+    const void* data;             /* Message, entrées du lot, valeurs ou pixels */
+    size_t count;                 /* Entrées du lot, octets d'un log texte ou régions d'une image */
+    const hdf5_image_rect_t* rects; /* Régions modifiées d'une mise à jour d'image (NULL = toutes) */
+    unsigned int format_id;       /* Format interné d'un log texte (0 = message formaté) */
+    hsize_t dims[HDF5_LOGGER_MAX_RANK]; /* Dimensions (tableaux) ou hauteur, largeur, canaux (images) */
+    int rank;                     /* Rang du tableau */
+    hdf5_dtype_t dtype;           /* Type des éléments (tableaux) ou des canaux (images) */
+    hdf5_array_layout_t layout;   /* Disposition des chunks du tableau */
+    hdf5_pixel_format_t pixel_format; /* Format d'une image brute de caméra */
+    size_t row_pitch;             /* Octets entre deux lignes de l'image brute (0 = contiguës) */
+    hdf5_write_callback_t done;   /* Rend les données empruntées (NULL = données recopiées) */
+    void* user_data;              /* Donnée transmise à done */
+    struct async_record_s* next;  /* Chaînage des enregistrements abandonnés */
+} async_record_t;
+
+/* Case de la file : le numéro de séquence indique si elle est libre ou pleine */
+typedef struct {
+    volatile size_t sequence;
+    async_record_t* record;
+} queue_cell_t;
+
+/* File bornée à plusieurs producteurs et plusieurs consommateurs */
+typedef struct {
+    queue_cell_t* cells;
+    size_t mask;
+    char pad0[LOGGER_CACHE_LINE];
+    volatile size_t enqueue_pos;
+    char pad1[LOGGER_CACHE_LINE];
+    volatile size_t dequeue_pos;
+    char pad2[LOGGER_CACHE_LINE];
+} async_queue_t;
+
+struct async_writer_s {
+    async_queue_t queue;
+    hdf5_async_full_policy_t full_policy;
+    hdf5_log_level_t drop_level;
+    memory_arena_t* arena;        /* Blocs des enregistrements */
+
+    logger_thread_t thread;       /* Thread d'écriture */
+    logger_mutex_t mutex;         /* Protège les attentes ci-dessous */
+    logger_cond_t work;           /* Réveille le thread d'écriture */
+    logger_cond_t space;          /* Réveille les producteurs bloqués */
+    logger_cond_t done;           /* Réveille les appels en attente d'un vidage */
+
+    volatile size_t sleeping;     /* Le thread d'écriture attend du travail */
+    volatile size_t waiters;      /* Producteurs bloqués sur une file pleine */
+    volatile size_t stop;         /* Arrêt demandé */
+    async_record_t* dropped;      /* Abandonnés par HDF5_ASYNC_DROP_OLDEST, à rendre (sous mutex) */
+
+    /* Vidages demandés (sous mutex) */
+    unsigned long long flush_request; /* Numéro de la dernière demande */
+    unsigned long long flush_served;  /* Numéro de la dernière demande satisfaite */
+    unsigned long long flush_target;  /* Enregistrements à avoir retirés de la file */
+    int flush_persist;                /* Vider aussi les tampons HDF5 sur disque */
+    unsigned long long flush_errors;  /* write_errors déjà signalés par un vidage */
+
+    /* Compteurs */
+    volatile unsigned long long enqueued;
+    volatile unsigned long long retired;   /* Écrits ou abandonnés après dépôt */
+    volatile unsigned long long written;
+    volatile unsigned long long dropped_oldest;
+    volatile unsigned long long dropped_by_level;
+    volatile unsigned long long blocked;
+    volatile unsigned long long write_errors;
+};
+
+/* Thread d'écriture du thread courant (NULL hors d'un thread d'écriture) */
+static LOGGER_THREAD_LOCAL async_writer_t* current_writer;
+
+static int queue_init(async_queue_t* queue, size_t capacity) {
+    memset(queue, 0, sizeof(*queue));
+    queue->cells = (queue_cell_t*)malloc(capacity * sizeof(queue_cell_t));
+    if (queue->cells == NULL) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < capacity; i++) {
+        queue->cells[i].sequence = i;
+        queue->cells[i].record = NULL;
+    }
+    queue->mask = capacity - 1;
+    return 0;
+}
+
+/* Dépose un enregistrement ; renvoie 0 si la file est pleine */
+static int queue_push(async_queue_t* queue, async_record_t* record) {
+    size_t pos = atomic_load_size(&queue->enqueue_pos);
+
+    for (;;) {
+        queue_cell_t* cell = &queue->cells[pos & queue->mask];
+        size_t sequence = atomic_load_size(&cell->sequence);
+        ptrdiff_t diff = (ptrdiff_t)sequence - (ptrdiff_t)pos;
+
+        if (diff == 0) {
+            if (atomic_cas_size(&queue->enqueue_pos, pos, pos + 1)) {
+                cell->record = record;
+                atomic_store_size(&cell->sequence, pos + 1);
+                return 1;
+            }
+            pos = atomic_load_size(&queue->enqueue_pos);
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_size(&queue->enqueue_pos);
+        }
+    }
+}
+
+/* Retire l'enregistrement le plus ancien ; renvoie NULL si la file est vide */
+static async_record_t* queue_pop(async_queue_t* queue) {
+    size_t pos = atomic_load_size(&queue->dequeue_pos);
+
+    for (;;) {
+        queue_cell_t* cell = &queue->cells[pos & queue->mask];
+        size_t sequence = atomic_load_size(&cell->sequence);
+        ptrdiff_t diff = (ptrdiff_t)sequence - (ptrdiff_t)(pos + 1);
+
+        if (diff == 0) {
+            if (atomic_cas_size(&queue->dequeue_pos, pos, pos + 1)) {
+                async_record_t* record = cell->record;
+                atomic_store_size(&cell->sequence, pos + queue->mask + 1);
+                return record;
+            }
+            pos = atomic_load_size(&queue->dequeue_pos);
+        } else if (diff < 0) {
+            return NULL;
+        } else {
+            pos = atomic_load_size(&queue->dequeue_pos);
+        }
+    }
+}
+
+static int queue_is_empty(async_queue_t* queue) {
+    size_t pos = atomic_load_size(&queue->dequeue_pos);
+    return atomic_load_size(&queue->cells[pos & queue->mask].sequence) != pos + 1;
+}
+
+/* Alloue un enregistrement suivi de payload octets de données ; à la limite mémoire, un
+ * producteur en mode bloquant attend que le thread d'écriture libère des enregistrements */
+static async_record_t* record_alloc(async_writer_t* async, record_kind_t kind,
+                                    const char* group_path, size_t payload) {
+    size_t path_length = (group_path != NULL) ? strlen(group_path) + 1 : 0;
+    size_t bytes = sizeof(async_record_t) + payload + path_length;
+    async_record_t* record = (async_record_t*)arena_alloc(async->arena, bytes);
+    if (record == NULL && async->full_policy == HDF5_ASYNC_BLOCK && current_writer != async) {
+        atomic_add_u64(&async->blocked, 1);
+        logger_mutex_lock(&async->mutex);
+        atomic_add_size(&async->waiters, 1);
+        while ((record = (async_record_t*)arena_alloc(async->arena, bytes)) == NULL &&
+               atomic_load_u64(&async->retired) < atomic_load_u64(&async->enqueued)) {
+            logger_cond_signal(&async->work);
+            logger_cond_timedwait(&async->space, &async->mutex, PRODUCER_WAIT);
+        }
+        atomic_add_size(&async->waiters, (size_t)-1);
+        logger_mutex_unlock(&async->mutex);
+    }
+    if (record == NULL) {
+        return NULL;
+    }
+
+    memset(record, 0, sizeof(*record));
+    record->kind = kind;
+    record->level = HDF5_LOG_INFO;
+
+    /* Le chemin est rangé après les données, qui restent alignées derrière la structure */
+    if (group_path != NULL) {
+        char* path = (char*)(record + 1) + payload;
+        memcpy(path, group_path, path_length);
+        record->group_path = path;
+    }
+    return record;
+}
+
+/* Données d'un enregistrement : recopiées derrière la structure (data_bytes octets), ou
+ * empruntées à l'appelant jusqu'à l'appel de done */
+static void record_set_data(async_record_t* record, const void* data, size_t data_bytes,
+                          hdf5_write_callback_t done, void* user_data) {
+    if (done != NULL) {
+        record->data = data;
+        record->done = done;
+        record->user_data = user_data;
+    } else {
+        memcpy(record + 1, data, data_bytes);
+        record->data = record + 1;
+    }
+}
+
+/* Recopie les éléments sélectionnés d'un tampon non contigu, de façon contiguë */
+static void record_gather(async_record_t* record, const void* data, const source_view_t* view,
+                          size_t element_size, size_t data_bytes) {
+    view_gather(view, data, element_size, 0, data_bytes / element_size, record + 1);
+    record->data = record + 1;
+}
+
+/* Libère un enregistrement écrit ou abandonné, après avoir rendu ses données empruntées */
+static void record_release(async_writer_t* async, async_record_t* record, int status) {
+    if (record->done != NULL) {
+        record->done(record->user_data, status);
+    }
+    arena_free(async->arena, record);
+}
+
+/* Réveille le thread d'écriture s'il s'est endormi */
+static void writer_wake(async_writer_t* async) {
+    if (atomic_load_size(&async->sleeping)) {
+        logger_mutex_lock(&async->mutex);
+        logger_cond_signal(&async->work);
+        logger_mutex_unlock(&async->mutex);
+    }
+}
+
+/* Confie un enregistrement abandonné au thread d'écriture, qui appellera son rappel */
+static void record_drop(async_writer_t* async, async_record_t* record) {
+    logger_mutex_lock(&async->mutex);
+    record->next = async->dropped;
+    async->dropped = record;
+    logger_mutex_unlock(&async->mutex);
+}
+
+/* Dépose un enregistrement en appliquant la politique de file pleine */
+static int async_push(async_writer_t* async, async_record_t* record) {
+    if (!queue_push(&async->queue, record)) {
+        int must_wait = 1;
+
+        if (async->full_policy == HDF5_ASYNC_DROP_BY_LEVEL && record->level < (int)async->drop_level) {
+            record_release(async, record, -1);
+            atomic_add_u64(&async->dropped_by_level, 1);
+            return 0;
+        }
+
+        if (async->full_policy == HDF5_ASYNC_DROP_OLDEST) {
+            /* Faire de la place en abandonnant le plus ancien enregistrement en file */
+            must_wait = 0;
+            while (!queue_push(&async->queue, record)) {
+                async_record_t* oldest = queue_pop(&async->queue);
+                if (oldest != NULL) {
+                    record_drop(async, oldest);
+                    atomic_add_u64(&async->dropped_oldest, 1);
+                }
+            }
+        }
+
+        /* Le thread d'écriture ne peut attendre une place qu'il est seul à libérer */
+        if (must_wait && current_writer == async) {
+            arena_free(async->arena, record);
+            return -1;
+        }
+
+        if (must_wait) {
+            atomic_add_u64(&async->blocked, 1);
+            logger_mutex_lock(&async->mutex);
+            atomic_add_size(&async->waiters, 1);
+            while (!queue_push(&async->queue, record)) {
+                logger_cond_signal(&async->work);
+                logger_cond_timedwait(&async->space, &async->mutex, PRODUCER_WAIT);
+            }
+            atomic_add_size(&async->waiters, (size_t)-1);
+            logger_mutex_unlock(&async->mutex);
+        }
+    }
+
+    atomic_add_u64(&async->enqueued, 1);
+    writer_wake(async);
+    return 0;
+}
+
+/* Écrit un enregistrement dans le fichier (thread d'écriture, sous io_lock) */
+static int async_apply(hdf5_logger_t* logger, const async_record_t* record) {
+    hdf5_log_channel_t* channel = record->channel;
+
+    switch (record->kind) {
+        case RECORD_TEXT:
+            if (channel == NULL) {
+                channel = channel_get(logger, record->group_path);
+            }
+            return (channel == NULL) ? -1
+                : channel_append(channel, (hdf5_log_level_t)record->level, record->timestamp,
+                                 record->sequence, record->format_id,
+                                 (const char*)record->data, record->count);
+        case RECORD_TEXT_BATCH:
+            channel = channel_get(logger, record->group_path);
+            return (channel == NULL) ? -1
+                : channel_append_batch(channel, (const hdf5_text_entry_t*)record->data,
+                                       record->count, record->sequence);
+        case RECORD_ARRAY:
+            return array_write(logger, record->group_path, record->name, record->data,
+                               record->rank, record->dims, record->dtype, &record->layout,
+                               NULL);
+        case RECORD_ARRAY_APPEND:
+            return stream_append(logger, record->group_path, record->name, record->data,
+                                 record->rank, record->dims, record->dtype, record->timestamp);
+        case RECORD_IMAGE:
+            return image_write(logger, record->group_path, record->name, record->data,
+                               (size_t)record->dims[1], (size_t)record->dims[0],
+                               (size_t)record->dims[2], record->dtype, NULL);
+        case RECORD_IMAGE_FRAME:
+            return stream_append_image(logger, record->group_path, record->name, record->data,
+                                       (size_t)record->dims[1], (size_t)record->dims[0],
+                                       (size_t)record->dims[2], record->dtype, NULL,
+                                       record->timestamp, record->sequence);
+        case RECORD_IMAGE_UPDATE:
+            return image_update(logger, record->group_path, record->name, record->data,
+                                (size_t)record->dims[1], (size_t)record->dims[0],
+                                (size_t)record->dims[2], record->dtype, record->rects,
+                                record->count);
+
+        case RECORD_IMAGE_FORMAT:
+            return image_write_format(logger, record->group_path, record->name, record->data,
+                                      (size_t)record->dims[1], (size_t)record->dims[0],
+                                      record->pixel_format, record->row_pitch);
+    }
+    return -1;
+}
+
+/* Rend les enregistrements retirés de la file, hors de io_lock : leurs rappels peuvent
+ * appeler le logger */
+static void writer_release(async_writer_t* async, async_record_t** records, const int* statuses,
+                           size_t count) {
+    logger_mutex_lock(&async->mutex);
+    async_record_t* dropped = async->dropped;
+    async->dropped = NULL;
+    logger_mutex_unlock(&async->mutex);
+
+    for (size_t i = 0; i < count; i++) {
+        record_release(async, records[i], statuses[i]);
+    }
+
+    size_t released = count;
+    while (dropped != NULL) {
+        async_record_t* next = dropped->next;
+        record_release(async, dropped, -1);
+        dropped = next;
+        released++;
+    }
+
+    /* Un vidage n'est satisfait qu'une fois les rappels de ce qui le précède appelés */
+    if (released > 0) {
+        atomic_add_u64(&async->retired, released);
+    }
+}
+
+/* Boucle du thread d'écriture : vide la file, applique les délais et répond aux vidages */
+static void writer_main(void* arg) {
+    hdf5_logger_t* logger = (hdf5_logger_t*)arg;
+    async_writer_t* async = logger->async;
+    async_record_t* finished[WRITER_BATCH_RECORDS];
+    int statuses[WRITER_BATCH_RECORDS];
+
+    current_writer = async;
+    for (;;) {
+        size_t applied = 0;
+
+        logger_mutex_lock(&logger->io_lock);
+        async_record_t* record;
+        while (applied < WRITER_BATCH_RECORDS && (record = queue_pop(&async->queue)) != NULL) {
+            int status = async_apply(logger, record);
+            if (status < 0) {
+                atomic_add_u64(&async->write_errors, 1);
+            } else {
+                atomic_add_u64(&async->written, 1);
+            }
+            finished[applied] = record;
+            statuses[applied] = status;
+            applied++;
+        }
+
+        /* Les entrées en attente depuis trop longtemps sont écrites même sans nouvel appel */
+        double now = get_current_time();
+        if (logger->pending_since > 0 && logger->batch_max_delay > 0 &&
+            now - logger->pending_since >= logger->batch_max_delay) {
+            channel_table_flush(logger);
+        }
+
+        /* Vidage demandé : répondre dès que tout ce qui le précède a été retiré de la file */
+        logger_mutex_lock(&async->mutex);
+        if (async->flush_request > async->flush_served &&
+            atomic_load_u64(&async->retired) >= async->flush_target) {
+            unsigned long long request = async->flush_request;
+            int persist = async->flush_persist;
+            async->flush_persist = 0;
+            logger_mutex_unlock(&async->mutex);
+
+            if (channel_table_flush(logger) < 0 ||
+                (persist && H5Fflush(logger->file_id, H5F_SCOPE_LOCAL) < 0)) {
+                atomic_add_u64(&async->write_errors, 1);
+            }
+
+            logger_mutex_lock(&async->mutex);
+            async->flush_served = request;
+            logger_cond_broadcast(&async->done);
+        }
+        int idle = (applied == 0 && async->dropped == NULL);
+        logger_mutex_unlock(&async->mutex);
+        logger_mutex_unlock(&logger->io_lock);
+
+        writer_release(async, finished, statuses, applied);
+
+        if (!idle && atomic_load_size(&async->waiters) > 0) {
+            logger_mutex_lock(&async->mutex);
+            logger_cond_broadcast(&async->space);
+            logger_mutex_unlock(&async->mutex);
+        }
+
+        if (idle) {
+            if (atomic_load_size(&async->stop) && queue_is_empty(&async->queue)) {
+                break;
+            }
+
+            /* S'endormir ; un producteur qui voit sleeping prend le verrou avant de signaler */
+            logger_mutex_lock(&async->mutex);
+            atomic_store_size(&async->sleeping, 1);
+            if (queue_is_empty(&async->queue) && !atomic_load_size(&async->stop) &&
+                async->flush_request == async->flush_served && async->dropped == NULL) {
+                logger_cond_timedwait(&async->work, &async->mutex, WRITER_IDLE_WAIT);
+            }
+            atomic_store_size(&async->sleeping, 0);
+            logger_mutex_unlock(&async->mutex);
+        }
+    }
+    current_writer = NULL;
+}
+
+int async_start(hdf5_logger_t* logger, const hdf5_async_config_t* config) {
+    async_writer_t* async = (async_writer_t*)calloc(1, sizeof(async_writer_t));
+    if (async == NULL) {
+        return -1;
+    }
+
+    /* La capacité est arrondie à une puissance de deux pour un indice par masque */
+    size_t requested = (config != NULL && config->queue_capacity > 0) ? config->queue_capacity
+                                                                      : ASYNC_DEFAULT_QUEUE_CAPACITY;
+    size_t capacity = 2;
+    while (capacity < requested) {
+        capacity *= 2;
+    }
+
+    async->full_policy = (config != NULL) ? config->full_policy : HDF5_ASYNC_BLOCK;
+    async->drop_level = (config != NULL) ? config->drop_level : HDF5_LOG_DEBUG;
+    async->arena = logger->arena;
+
+    if (queue_init(&async->queue, capacity) < 0) {
+        free(async);
+        return -1;
+    }
+
+    logger_mutex_init(&async->mutex);
+    logger_cond_init(&async->work);
+    logger_cond_init(&async->space);
+    logger_cond_init(&async->done);
+
+    logger->async = async;
+    if (logger_thread_start(&async->thread, writer_main, logger) < 0) {
+        logger->async = NULL;
+        logger_cond_destroy(&async->done);
+        logger_cond_destroy(&async->space);
+        logger_cond_destroy(&async->work);
+        logger_mutex_destroy(&async->mutex);
+        free(async->queue.cells);
+        free(async);
+        return -1;
+    }
+
+    return 0;
+}
+
+void async_stop(hdf5_logger_t* logger) {
+    async_writer_t* async = logger->async;
+    if (async == NULL) {
+        return;
+    }
+
+    /* Le thread d'écriture vide toute la file avant de se terminer */
+    logger_mutex_lock(&async->mutex);
+    atomic_store_size(&async->stop, 1);
+    logger_cond_signal(&async->work);
+    logger_mutex_unlock(&async->mutex);
+    logger_thread_join(async->thread);
+
+    logger->async = NULL;
+    logger_cond_destroy(&async->done);
+    logger_cond_destroy(&async->space);
+    logger_cond_destroy(&async->work);
+    logger_mutex_destroy(&async->mutex);
+    free(async->queue.cells);
+    free(async);
+}
+
+/* Seules les écritures en échec depuis le vidage précédent sont signalées */
+static int flush_status(async_writer_t* async) {
+    logger_mutex_lock(&async->mutex);
+    unsigned long long errors = atomic_load_u64(&async->write_errors);
+    int failed = errors > async->flush_errors;
+    async->flush_errors = errors;
+    logger_mutex_unlock(&async->mutex);
+
+    return failed ? -1 : 0;
+}
+
+int async_flush(hdf5_logger_t* logger, int persist) {
+    async_writer_t* async = logger->async;
+
+    /* Depuis un rappel, le thread d'écriture ne peut s'attendre lui-même : il écrit
+     * directement les entrées en attente, la file restant à vider après le rappel */
+    if (current_writer == async) {
+        logger_mutex_lock(&logger->io_lock);
+        if (channel_table_flush(logger) < 0 ||
+            (persist && H5Fflush(logger->file_id, H5F_SCOPE_LOCAL) < 0)) {
+            atomic_add_u64(&async->write_errors, 1);
+        }
+        logger_mutex_unlock(&logger->io_lock);
+        return flush_status(async);
+    }
+
+    unsigned long long target = atomic_load_u64(&async->enqueued);
+
+    logger_mutex_lock(&async->mutex);
+    unsigned long long request = ++async->flush_request;
+    if (target > async->flush_target) {
+        async->flush_target = target;
+    }
+    if (persist) {
+        async->flush_persist = 1;
+    }
+
+    while (async->flush_served < request) {
+        logger_cond_signal(&async->work);
+        logger_cond_timedwait(&async->done, &async->mutex, WRITER_IDLE_WAIT);
+    }
+    logger_mutex_unlock(&async->mutex);
+
+    return flush_status(async);
+}
+
+int async_submit_text(hdf5_logger_t* logger, hdf5_log_channel_t* channel, const char* group_path,
+                      hdf5_log_level_t level, unsigned int format_id, const char* data,
+                      size_t length) {
+    async_record_t* record = record_alloc(logger->async, RECORD_TEXT, group_path, length);
+    if (record == NULL) {
+        return -1;
+    }
+
+    record->level = (int)level;
+    record->timestamp = get_current_time();
+    record->sequence = logger_next_sequence(logger, 1);
+    record->channel = channel;
+    record->format_id = format_id;
+    record->count = length;
+    memcpy(record + 1, data, length);
+    record->data = record + 1;
+
+    return async_push(logger->async, record);
+}
+
+int async_submit_text_batch(hdf5_logger_t* logger, const char* group_path,
+                            const hdf5_text_entry_t* entries, size_t n) {
+    size_t payload = n * sizeof(hdf5_text_entry_t);
+    int level = HDF5_LOG_DEBUG;
+    for (size_t i = 0; i < n; i++) {
+        if (entries[i].message == NULL) {
+            return -1;
+        }
+        payload += strlen(entries[i].message) + 1;
+        if ((int)entries[i].level > level) {
+            level = (int)entries[i].level;
+        }
+    }
+
+    async_record_t* record = record_alloc(logger->async, RECORD_TEXT_BATCH, group_path, payload);
+    if (record == NULL) {
+        return -1;
+    }
+
+    /* Les entrées, puis leurs messages, sont recopiés dans l'enregistrement */
+    double now = get_current_time();
+    record->sequence = logger_next_sequence(logger, n);
+    hdf5_text_entry_t* copies = (hdf5_text_entry_t*)(record + 1);
+    char* bytes = (char*)(copies + n);
+    for (size_t i = 0; i < n; i++) {
+        size_t length = strlen(entries[i].message) + 1;
+        memcpy(bytes, entries[i].message, length);
+        copies[i].level = entries[i].level;
+        copies[i].timestamp = (entries[i].timestamp > 0) ? entries[i].timestamp : now;
+        copies[i].message = bytes;
+        copies[i].sequence = record->sequence + i;
+        bytes += length;
+    }
+
+    /* Un lot n'est abandonné par niveau que si toutes ses entrées sont sous le seuil */
+    record->level = level;
+    record->data = copies;
+    record->count = n;
+
+    return async_push(logger->async, record);
+}
+
+int async_submit_array(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
+                       const void* data, int rank, const hsize_t* dims, hdf5_dtype_t dtype,
+                       const hdf5_array_layout_t* layout, const source_view_t* view,
+                       hdf5_write_callback_t done, void* user_data) {
+    size_t elements = 1;
+    for (int i = 0; i < rank; i++) {
+        elements *= (size_t)dims[i];
+    }
+    size_t data_bytes = (done != NULL) ? 0 : elements * dtype_size(dtype);
+    size_t name_length = strlen(dataset_name) + 1;
+
+    async_record_t* record = record_alloc(logger->async, RECORD_ARRAY, group_path,
+                                          data_bytes + name_length);
+    if (record == NULL) {
+        return -1;
+    }
+
+    if (view != NULL) {
+        record_gather(record, data, view, dtype_size(dtype), data_bytes);
+    } else {
+        record_set_data(record, data, data_bytes, done, user_data);
+    }
+    char* name = (char*)(record + 1) + data_bytes;
+    memcpy(name, dataset_name, name_length);
+
+    record->name = name;
+    record->rank = rank;
+    record->dtype = dtype;
+    record->layout = *layout;
+    memcpy(record->dims, dims, (size_t)rank * sizeof(hsize_t));
+
+    return async_push(logger->async, record);
+}
+
+int async_submit_array_append(hdf5_logger_t* logger, const char* group_path,
+                              const char* dataset_name, const void* data, int rank,
+                              const hsize_t* dims, hdf5_dtype_t dtype) {
+    size_t elements = 1;
+    for (int i = 0; i < rank; i++) {
+        elements *= (size_t)dims[i];
+    }
+    size_t data_bytes = elements * dtype_size(dtype);
+    size_t name_length = strlen(dataset_name) + 1;
+
+    async_record_t* record = record_alloc(logger->async, RECORD_ARRAY_APPEND, group_path,
+                                          data_bytes + name_length);
+    if (record == NULL) {
+        return -1;
+    }
+
+    memcpy(record + 1, data, data_bytes);
+    char* name = (char*)(record + 1) + data_bytes;
+    memcpy(name, dataset_name, name_length);
+
+    record->timestamp = get_current_time();
+    record->data = record + 1;
+    record->name = name;
+    record->rank = rank;
+    record->dtype = dtype;
+    memcpy(record->dims, dims, (size_t)rank * sizeof(hsize_t));
+
+    return async_push(logger->async, record);
+}
+
+int async_submit_image(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                       const void* pixel_data, size_t width, size_t height, size_t channels,
+                       hdf5_dtype_t dtype, const source_view_t* view, hdf5_write_callback_t done,
+                       void* user_data) {
+    size_t data_bytes = (done != NULL) ? 0 : width * height * channels * dtype_size(dtype);
+    size_t name_length = strlen(image_name) + 1;
+
+    async_record_t* record = record_alloc(logger->async, RECORD_IMAGE, group_path,
+                                          data_bytes + name_length);
+    if (record == NULL) {
+        return -1;
+    }
+
+    if (view != NULL) {
+        record_gather(record, pixel_data, view, dtype_size(dtype), data_bytes);
+    } else {
+        record_set_data(record, pixel_data, data_bytes, done, user_data);
+    }
+    char* name = (char*)(record + 1) + data_bytes;
+    memcpy(name, image_name, name_length);
+
+    record->name = name;
+    record->dims[0] = height;
+    record->dims[1] = width;
+    record->dims[2] = channels;
+    record->dtype = dtype;
+
+    return async_push(logger->async, record);
+}
+
+int async_submit_image_update(hdf5_logger_t* logger, const char* group_path,
+                              const char* image_name, const void* pixel_data, size_t width,
+                              size_t height, size_t channels, hdf5_dtype_t dtype,
+                              const hdf5_image_rect_t* rects, size_t rect_count) {
+    size_t rect_bytes = rect_count * sizeof(hdf5_image_rect_t);
+    size_t data_bytes = width * height * channels * dtype_size(dtype);
+    size_t name_length = strlen(image_name) + 1;
+
+    async_record_t* record = record_alloc(logger->async, RECORD_IMAGE_UPDATE, group_path,
+                                          rect_bytes + data_bytes + name_length);
+    if (record == NULL) {
+        return -1;
+    }
+
+    /* Régions, pixels puis nom */
+    hdf5_image_rect_t* copies = (hdf5_image_rect_t*)(record + 1);
+    if (rects != NULL) {
+        memcpy(copies, rects, rect_bytes);
+    }
+    unsigned char* pixels = (unsigned char*)copies + rect_bytes;
+    memcpy(pixels, pixel_data, data_bytes);
+    char* name = (char*)pixels + data_bytes;
+    memcpy(name, image_name, name_length);
+
+    record->rects = (rects != NULL) ? copies : NULL;
+    record->count = rect_count;
+    record->data = pixels;
+    record->name = name;
+    record->dims[0] = height;
+    record->dims[1] = width;
+    record->dims[2] = channels;
+    record->dtype = dtype;
+
+    return async_push(logger->async, record);
+}
+
+int async_submit_image_format(hdf5_logger_t* logger, const char* group_path,
+                              const char* image_name, const void* frame, size_t width,
+                              size_t height, hdf5_pixel_format_t format, size_t row_pitch,
+                              size_t frame_bytes) {
+    size_t name_length = strlen(image_name) + 1;
+
+    async_record_t* record = record_alloc(logger->async, RECORD_IMAGE_FORMAT, group_path,
+                                          frame_bytes + name_length);
+    if (record == NULL) {
+        return -1;
+    }
+
+    /* Image brute, avec la marge de ses lignes, puis nom */
+    unsigned char* pixels = (unsigned char*)(record + 1);
+    memcpy(pixels, frame, frame_bytes);
+    char* name = (char*)pixels + frame_bytes;
+    memcpy(name, image_name, name_length);
+
+    record->data = pixels;
+    record->name = name;
+    record->dims[0] = height;
+    record->dims[1] = width;
+    record->pixel_format = format;
+    record->row_pitch = row_pitch;
+
+    return async_push(logger->async, record);
+}
+
+int async_submit_image_frame(hdf5_logger_t* logger, const char* group_path,
+                             const char* stream_name, const void* pixel_data, size_t width,
+                             size_t height, size_t channels, hdf5_dtype_t dtype,
+                             const source_view_t* view, hdf5_write_callback_t done,
+                             void* user_data) {
+    size_t data_bytes = (done != NULL) ? 0 : width * height * channels * dtype_size(dtype);
+    size_t name_length = strlen(stream_name) + 1;
+
+    async_record_t* record = record_alloc(logger->async, RECORD_IMAGE_FRAME, group_path,
+                                          data_bytes + name_length);
+    if (record == NULL) {
+        return -1;
+    }
+
+    if (view != NULL) {
+        record_gather(record, pixel_data, view, dtype_size(dtype), data_bytes);
+    } else {
+        record_set_data(record, pixel_data, data_bytes, done, user_data);
+    }
+    char* name = (char*)(record + 1) + data_bytes;
+    memcpy(name, stream_name, name_length);
+
+    record->timestamp = get_current_time();
+    record->sequence = logger_next_sequence(logger, 1);
+    record->name = name;
+    record->dims[0] = height;
+    record->dims[1] = width;
+    record->dims[2] = channels;
+    record->dtype = dtype;
+
+    return async_push(logger->async, record);
+}
+
+/* Implémentation des fonctions publiques */
+
+hdf5_logger_t* hdf5_logger_init_async(const char* filename, const hdf5_async_config_t* config) {
+    if (config != NULL && (config->full_policy < HDF5_ASYNC_BLOCK ||
+                           config->full_policy > HDF5_ASYNC_DROP_BY_LEVEL)) {
+        return NULL;
+    }
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    if (logger == NULL) {
+        return NULL;
+    }
+
+    if (async_start(logger, config) < 0) {
+        hdf5_logger_close(logger);
+        return NULL;
+    }
+
+    return logger;
+}
+
+int hdf5_logger_get_async_stats(hdf5_logger_t* logger, hdf5_async_stats_t* stats) {
+    if (logger == NULL || stats == NULL || logger->async == NULL) {
+        return -1;
+    }
+
+    async_writer_t* async = logger->async;
+    stats->enqueued = atomic_load_u64(&async->enqueued);
+    stats->written = atomic_load_u64(&async->written);
+    stats->dropped_oldest = atomic_load_u64(&async->dropped_oldest);
+    stats->dropped_by_level = atomic_load_u64(&async->dropped_by_level);
+    stats->blocked = atomic_load_u64(&async->blocked);
+    stats->write_errors = atomic_load_u64(&async->write_errors);
+
+    return 0;
+}
@@ -0,0 +1,587 @@
+/**
+ * @file hdf5_logger_channel.c
+ * @brief Canaux de log texte : handles HDF5 gardés ouverts entre les écritures
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+/* Taille initiale de la table de hachage (puissance de deux) */
+#define CHANNEL_TABLE_INITIAL_SIZE 16
+
+static int channel_migrate(hdf5_log_channel_t* channel);
+
+/* Vrai si le groupe a déjà un stockage compact (anneau, linéaire ou segmenté) */
+static int channel_has_layout(const hdf5_log_channel_t* channel) {
+    return channel->segmented || channel->store.records_id >= 0;
+}
+
+/* Vrai si la disposition du stockage correspond aux limites courantes du canal */
+static int channel_layout_matches(const hdf5_log_channel_t* channel) {
+    /* Seuls les groupes limités en temps mais pas en taille sont découpés en segments */
+    int wants_segments = (channel->max_entries == 0 && channel->max_time_seconds > 0);
+    if (channel->segmented != wants_segments) {
+        return 0;
+    }
+    return channel->segmented || channel->store.ring_capacity == channel->max_entries;
+}
+
+/* Crée le stockage correspondant aux limites courantes du canal */
+static int channel_create_layout(hdf5_log_channel_t* channel) {
+    if (channel->max_entries == 0 && channel->max_time_seconds > 0) {
+        return segments_create(channel);
+    }
+    return store_create(&channel->store, channel->group_id, channel->logger->record_type_id,
+                        channel->max_entries,
+                        codec_resolve(channel->logger, channel->group_path, HDF5_DATA_TEXT));
+}
+
+/* Ferme le stockage du canal sans vider son tampon */
+static void channel_close_layout(hdf5_log_channel_t* channel) {
+    if (channel->segmented) {
+        segments_close(channel);
+    } else {
+        store_close(&channel->store);
+    }
+}
+
+/* Hachage FNV-1a du chemin du groupe */
+static unsigned long hash_path(const char* path) {
+    unsigned long hash = 2166136261UL;
+    for (const unsigned char* p = (const unsigned char*)path; *p != '\0'; p++) {
+        hash ^= *p;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+/* Relit l'horodatage de la plus récente entrée du groupe, plancher des entrées suivantes */
+static int channel_load_last_timestamp(hdf5_log_channel_t* channel) {
+    if (channel->segmented) {
+        if (channel->segment_count > 0) {
+            channel->last_timestamp = channel->segments[channel->segment_count - 1].max_time;
+        }
+        return 0;
+    }
+
+    text_store_t* store = &channel->store;
+    if (store->records_id < 0 || store->count == 0) {
+        return 0;
+    }
+    return store_read_timestamp(store, store->count - 1, &channel->last_timestamp);
+}
+
+/* Ouvre un nouveau canal sur un groupe */
+static hdf5_log_channel_t* channel_open(hdf5_logger_t* logger, const char* group_path,
+                                        unsigned long hash) {
+    hdf5_log_channel_t* channel = (hdf5_log_channel_t*)calloc(1, sizeof(hdf5_log_channel_t));
+    if (channel == NULL) {
+        return NULL;
+    }
+
+    channel->group_path = strdup(group_path);
+    if (channel->group_path == NULL) {
+        free(channel);
+        return NULL;
+    }
+
+    channel->logger = logger;
+    channel->hash = hash;
+    channel->segment_group_id = -1;
+    store_init(&channel->store);
+
+    /* Créer le groupe s'il n'existe pas */
+    channel->group_id = create_group_if_not_exists(logger->file_id, group_path);
+    if (channel->group_id == logger->file_id) {
+        /* Le groupe racine est renvoyé sous la forme du fichier : l'ouvrir pour de bon */
+        channel->group_id = H5Gopen2(logger->file_id, "/", H5P_DEFAULT);
+    }
+    if (channel->group_id < 0) {
+        free(channel->group_path);
+        free(channel);
+        return NULL;
+    }
+
+    /* Mettre en cache les limites de conservation */
+    read_scalar_attribute(channel->group_id, "max_entries", H5T_NATIVE_HSIZE, &channel->max_entries);
+    read_scalar_attribute(channel->group_id, "max_time_seconds", H5T_NATIVE_DOUBLE,
+                          &channel->max_time_seconds);
+
+    /* Ouvrir les segments ou le stockage compact existant ; les anciens log_entries restent en lecture seule */
+    int segmented = segments_open(channel);
+    if (segmented < 0 ||
+        (segmented == 0 && store_open(&channel->store, channel->group_id, logger->record_type_id) < 0)) {
+        channel_close_layout(channel);
+        H5Gclose(channel->group_id);
+        free(channel->group_path);
+        free(channel);
+        return NULL;
+    }
+
+    /* Convertir le stockage si les limites ont changé depuis sa création */
+    if ((channel_has_layout(channel) && !channel_layout_matches(channel) &&
+         channel_migrate(channel) < 0) ||
+        channel_load_last_timestamp(channel) < 0) {
+        /* Les entrées copiées en attente sont abandonnées avec le canal */
+        channel_close_layout(channel);
+        H5Gclose(channel->group_id);
+        free(channel->staged);
+        free(channel->staged_bytes);
+        free(channel->scratch);
+        free(channel->group_path);
+        free(channel);
+        return NULL;
+    }
+
+    return channel;
+}
+
+/* Vide un canal, ferme ses handles HDF5 et libère sa mémoire */
+static void channel_free(hdf5_log_channel_t* channel) {
+    channel_flush(channel);
+    channel_close_layout(channel);
+    H5Gclose(channel->group_id);
+    free(channel->staged);
+    free(channel->staged_bytes);
+    free(channel->scratch);
+    free(channel->group_path);
+    free(channel);
+}
+
+/* Double la taille de la table de hachage */
+static int channel_table_grow(channel_table_t* table) {
+    size_t new_count = table->bucket_count * 2;
+    hdf5_log_channel_t** new_buckets = (hdf5_log_channel_t**)calloc(new_count,
+                                                                    sizeof(hdf5_log_channel_t*));
+    if (new_buckets == NULL) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < table->bucket_count; i++) {
+        hdf5_log_channel_t* channel = table->buckets[i];
+        while (channel != NULL) {
+            hdf5_log_channel_t* next = channel->next;
+            size_t index = channel->hash & (new_count - 1);
+            channel->next = new_buckets[index];
+            new_buckets[index] = channel;
+            channel = next;
+        }
+    }
+
+    free(table->buckets);
+    table->buckets = new_buckets;
+    table->bucket_count = new_count;
+    return 0;
+}
+
+hdf5_log_channel_t* channel_find(hdf5_logger_t* logger, const char* group_path) {
+    channel_table_t* table = &logger->channels;
+    if (table->buckets == NULL) {
+        return NULL;
+    }
+
+    unsigned long hash = hash_path(group_path);
+    hdf5_log_channel_t* channel = table->buckets[hash & (table->bucket_count - 1)];
+    while (channel != NULL) {
+        if (channel->hash == hash && strcmp(channel->group_path, group_path) == 0) {
+            return channel;
+        }
+        channel = channel->next;
+    }
+
+    return NULL;
+}
+
+hdf5_log_channel_t* channel_get(hdf5_logger_t* logger, const char* group_path) {
+    hdf5_log_channel_t* channel = channel_find(logger, group_path);
+    if (channel != NULL) {
+        return channel;
+    }
+
+    channel_table_t* table = &logger->channels;
+    if (table->buckets == NULL) {
+        table->buckets = (hdf5_log_channel_t**)calloc(CHANNEL_TABLE_INITIAL_SIZE,
+                                                      sizeof(hdf5_log_channel_t*));
+        if (table->buckets == NULL) {
+            return NULL;
+        }
+        table->bucket_count = CHANNEL_TABLE_INITIAL_SIZE;
+    } else if (table->count >= table->bucket_count) {
+        /* Facteur de charge de 1 : agrandir avant d'insérer */
+        channel_table_grow(table);
+    }
+
+    unsigned long hash = hash_path(group_path);
+    channel = channel_open(logger, group_path, hash);
+    if (channel == NULL) {
+        return NULL;
+    }
+
+    size_t index = hash & (table->bucket_count - 1);
+    channel->next = table->buckets[index];
+    table->buckets[index] = channel;
+    table->count++;
+
+    return channel;
+}
+
+void channel_table_close(hdf5_logger_t* logger) {
+    channel_table_t* table = &logger->channels;
+
+    for (size_t i = 0; i < table->bucket_count; i++) {
+        hdf5_log_channel_t* channel = table->buckets[i];
+        while (channel != NULL) {
+            hdf5_log_channel_t* next = channel->next;
+            channel_free(channel);
+            channel = next;
+        }
+    }
+
+    free(table->buckets);
+    table->buckets = NULL;
+    table->bucket_count = 0;
+    table->count = 0;
+}
+
+int channel_table_flush(hdf5_logger_t* logger) {
+    channel_table_t* table = &logger->channels;
+    int result = 0;
+
+    for (size_t i = 0; i < table->bucket_count; i++) {
+        for (hdf5_log_channel_t* channel = table->buckets[i]; channel != NULL;
+             channel = channel->next) {
+            if (channel_flush(channel) < 0) {
+                result = -1;
+            }
+        }
+    }
+
+    /* Les trames en attente des séries suivent la même politique */
+    if (stream_table_flush(logger) < 0) {
+        result = -1;
+    }
+
+    logger->pending_since = 0.0;
+    return result;
+}
+
+/* Construit les enregistrements des entrées en attente, positions relatives au premier message.
+ * Les horodatages sont ramenés au maximum courant : horodatages fournis par l'appelant, dépôts
+ * concurrents ou fusions de tampons peuvent arriver dans le désordre, et les purges par durée
+ * cherchent par dichotomie dans des horodatages supposés croissants */
+static int channel_fill_scratch(hdf5_log_channel_t* channel, size_t first, size_t n) {
+    if (n > channel->scratch_capacity) {
+        text_record_t* scratch = realloc(channel->scratch, n * sizeof(text_record_t));
+        if (scratch == NULL) {
+            return -1;
+        }
+        channel->scratch = scratch;
+        channel->scratch_capacity = n;
+    }
+
+    size_t base = channel->staged[first].offset;
+    for (size_t i = 0; i < n; i++) {
+        const staged_entry_t* staged = &channel->staged[first + i];
+        text_record_t* record = &channel->scratch[i];
+
+        record->log_level = staged->log_level;
+        record->length = (unsigned int)staged->length;
+        if (staged->timestamp > channel->last_timestamp) {
+            channel->last_timestamp = staged->timestamp;
+        }
+        record->timestamp = channel->last_timestamp;
+        record->offset = staged->offset - base;
+        record->sequence = staged->sequence;
+        record->format_id = staged->format_id;
+    }
+
+    return 0;
+}
+
+int channel_flush(hdf5_log_channel_t* channel) {
+    if (channel->staged_count == 0) {
+        return 0;
+    }
+
+    hid_t record_type_id = channel->logger->record_type_id;
+    text_store_t* store = &channel->store;
+    size_t first = 0;
+    size_t n = channel->staged_count;
+
+    /* Les formats référencés par ces entrées sont écrits avant elles */
+    if (format_table_sync(channel->logger) < 0) {
+        return -1;
+    }
+
+    /* Créer les datasets à la première écriture : anneau si le groupe est limité en taille,
+     * segments s'il n'est limité qu'en temps */
+    if (!channel_has_layout(channel) && channel_create_layout(channel) < 0) {
+        return -1;
+    }
+
+    /* Purge par durée, au plus une fois par intervalle : jamais de lecture à chaque écriture */
+    double now = get_current_time();
+    if (channel->max_time_seconds > 0 &&
+        now - channel->last_retention >= channel->logger->retention_interval &&
+        retention_apply(channel, now) < 0) {
+        return -1;
+    }
+
+    /* Un lot plus grand que l'anneau : seules les dernières entrées seront conservées */
+    if (store->ring_capacity > 0 && n > store->ring_capacity) {
+        first = n - (size_t)store->ring_capacity;
+        n = (size_t)store->ring_capacity;
+    }
+
+    if (channel_fill_scratch(channel, first, n) < 0) {
+        return -1;
+    }
+
+    /* Écrire tout le lot : une écriture pour les messages, une pour les enregistrements */
+    size_t base = channel->staged[first].offset;
+    const staged_entry_t* last = &channel->staged[first + n - 1];
+    int status;
+    if (channel->segmented) {
+        status = segments_append(channel, channel->scratch, n, channel->staged_bytes + base);
+    } else {
+        status = store_append(store, record_type_id, channel->scratch, n,
+                              channel->staged_bytes + base, last->offset + last->length - base);
+    }
+
+    /* Les entrées ne quittent le tampon qu'une fois écrites : en cas d'échec, elles restent
+     * en attente pour le prochain vidage */
+    if (status < 0) {
+        return -1;
+    }
+    channel->staged_count = 0;
+    channel->staged_bytes_used = 0;
+    return 0;
+}
+
+/* Copie une entrée dans le tampon du canal, sans vider */
+static int channel_stage(hdf5_log_channel_t* channel, int level, double timestamp,
+                         unsigned long long sequence, unsigned int format_id, const char* data,
+                         size_t length) {
+    if (channel->staged_count == channel->staged_capacity) {
+        size_t capacity = channel->staged_capacity ? channel->staged_capacity * 2 : 64;
+        staged_entry_t* staged = realloc(channel->staged, capacity * sizeof(staged_entry_t));
+        if (staged == NULL) {
+            return -1;
+        }
+        channel->staged = staged;
+        channel->staged_capacity = capacity;
+    }
+
+    if (channel->staged_bytes_used + length > channel->staged_bytes_capacity) {
+        size_t capacity = channel->staged_bytes_capacity ? channel->staged_bytes_capacity : 4096;
+        while (capacity < channel->staged_bytes_used + length) {
+            capacity *= 2;
+        }
+        char* bytes = realloc(channel->staged_bytes, capacity);
+        if (bytes == NULL) {
+            return -1;
+        }
+        channel->staged_bytes = bytes;
+        channel->staged_bytes_capacity = capacity;
+    }
+
+    staged_entry_t* entry = &channel->staged[channel->staged_count++];
+    entry->log_level = level;
+    entry->timestamp = timestamp;
+    entry->sequence = sequence;
+    entry->format_id = format_id;
+    entry->offset = channel->staged_bytes_used;
+    entry->length = length;
+    memcpy(channel->staged_bytes + channel->staged_bytes_used, data, length);
+    channel->staged_bytes_used += length;
+
+    return 0;
+}
+
+/* Rappel de parcours : recopie une entrée de l'ancien stockage dans le tampon du canal,
+ * sans reformater les entrées à formatage différé */
+static int migrate_callback(const text_record_t* record, const char* message, void* user_data) {
+    hdf5_log_channel_t* channel = (hdf5_log_channel_t*)user_data;
+    return channel_stage(channel, record->log_level, record->timestamp, record->sequence,
+                         record->format_id, message, record->length);
+}
+
+int channel_iterate(hdf5_log_channel_t* channel, text_visit_t visit, void* user_data) {
+    if (channel->segmented) {
+        return segments_iterate(channel, visit, user_data);
+    }
+
+    text_store_t* store = &channel->store;
+    if (store->records_id < 0 || store->count == 0) {
+        return 0;
+    }
+    return store_iterate(store, channel->logger->record_type_id, 0, store->count,
+                         visit, user_data);
+}
+
+/* Recrée le stockage dans la disposition correspondant aux limites courantes en recopiant les entrées */
+static int channel_migrate(hdf5_log_channel_t* channel) {
+    hid_t record_type_id = channel->logger->record_type_id;
+    text_store_t* store = &channel->store;
+
+    /* Les entrées en attente sont d'abord écrites dans l'ancien stockage */
+    if (channel_flush(channel) < 0) {
+        return -1;
+    }
+
+    /* Seules les max_entries entrées les plus récentes survivent à la conversion ;
+     * pour un groupe segmenté, le vidage vers l'anneau ne garde que les dernières */
+    int result;
+    if (channel->segmented) {
+        result = segments_iterate(channel, migrate_callback, channel);
+    } else {
+        hsize_t start = 0;
+        if (channel->max_entries > 0 && store->count > channel->max_entries) {
+            start = store->count - channel->max_entries;
+        }
+        result = store_iterate(store, record_type_id, start, store->count - start,
+                               migrate_callback, channel);
+    }
+
+    if (result != 0) {
+        channel->staged_count = 0;
+        channel->staged_bytes_used = 0;
+        return -1;
+    }
+
+    int status = channel->segmented ? segments_delete(channel)
+                                    : store_delete(store, channel->group_id);
+    if (status < 0 || channel_create_layout(channel) < 0) {
+        return -1;
+    }
+
+    return channel_flush(channel);
+}
+
+int channel_set_max_entries(hdf5_log_channel_t* channel, hsize_t max_entries) {
+    /* Les entrées en attente sont écrites sous l'ancienne limite */
+    if (channel_flush(channel) < 0) {
+        return -1;
+    }
+
+    channel->max_entries = max_entries;
+    if (channel_has_layout(channel) && !channel_layout_matches(channel)) {
+        return channel_migrate(channel);
+    }
+
+    return 0;
+}
+
+int channel_set_max_time(hdf5_log_channel_t* channel, double max_time_seconds) {
+    if (channel_flush(channel) < 0) {
+        return -1;
+    }
+
+    channel->max_time_seconds = max_time_seconds;
+    channel->last_retention = 0.0;
+    if (channel_has_layout(channel) && !channel_layout_matches(channel)) {
+        return channel_migrate(channel);
+    }
+
+    return channel->segmented ? segments_resize(channel) : 0;
+}
+
+/* Vide le canal ou tous les canaux si un seuil de la politique est atteint */
+static int channel_apply_policy(hdf5_log_channel_t* channel, double now) {
+    hdf5_logger_t* logger = channel->logger;
+
+    if (logger->pending_since == 0.0) {
+        logger->pending_since = now;
+    }
+
+    /* Échéance dépassée : vider tous les canaux, pas seulement celui-ci */
+    if (logger->batch_max_delay > 0 && now - logger->pending_since >= logger->batch_max_delay) {
+        return channel_table_flush(logger);
+    }
+
+    if (channel->staged_count >= logger->batch_max_entries ||
+        (logger->batch_max_bytes > 0 && channel->staged_bytes_used >= logger->batch_max_bytes)) {
+        return channel_flush(channel);
+    }
+
+    return 0;
+}
+
+int channel_append(hdf5_log_channel_t* channel, hdf5_log_level_t level, double timestamp,
+                   unsigned long long sequence, unsigned int format_id, const char* data,
+                   size_t length) {
+    if (channel == NULL || data == NULL) {
+        return -1;
+    }
+
+    if (channel_stage(channel, (int)level, timestamp, sequence, format_id, data, length) < 0) {
+        return -1;
+    }
+
+    return channel_apply_policy(channel, timestamp);
+}
+
+int channel_append_batch(hdf5_log_channel_t* channel, const hdf5_text_entry_t* entries, size_t n,
+                         unsigned long long first_sequence) {
+    double now = get_current_time();
+
+    for (size_t i = 0; i < n; i++) {
+        if (entries[i].message == NULL) {
+            return -1;
+        }
+
+        double timestamp = (entries[i].timestamp > 0) ? entries[i].timestamp : now;
+        if (channel_stage(channel, (int)entries[i].level, timestamp, first_sequence + i, 0,
+                          entries[i].message, strlen(entries[i].message)) < 0) {
+            return -1;
+        }
+
+        /* Un lot plus grand que la politique est écrit en plusieurs morceaux */
+        if (channel->staged_count >= channel->logger->batch_max_entries &&
+            channel_flush(channel) < 0) {
+            return -1;
+        }
+    }
+
+    return channel_apply_policy(channel, now);
+}
+
+/* Implémentation des fonctions publiques */
+
+hdf5_log_channel_t* hdf5_logger_open_channel(hdf5_logger_t* logger, const char* group_path) {
+    if (logger == NULL || !logger->is_open || group_path == NULL || group_path[0] == '\0') {
+        return NULL;
+    }
+
+    if (logger_lock(logger) < 0) {
+        return NULL;
+    }
+
+    hdf5_log_channel_t* channel = channel_get(logger, group_path);
+
+    logger_unlock(logger);
+    return channel;
+}
+
+int hdf5_log_channel_text(hdf5_log_channel_t* channel, hdf5_log_level_t level, const char* message) {
+    if (channel == NULL || message == NULL || !channel->logger->is_open) {
+        return -1;
+    }
+
+    /* Log filtré : rien n'est copié ni écrit */
+    if (!level_enabled(channel->logger, channel->group_path, level)) {
+        return 0;
+    }
+
+    if (channel->logger->async != NULL) {
+        return async_submit_text(channel->logger, channel, channel->group_path, level, 0, message,
+                                 strlen(message));
+    }
+
+    /* Le tampon du thread appelant sera fusionné dans le canal */
+    return stage_text(channel->logger, channel, NULL, level, 0, message, strlen(message));
+}
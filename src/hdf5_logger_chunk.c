@@ -0,0 +1,153 @@
+/**
+ * @file hdf5_logger_chunk.c
+ * @brief Choix de la forme des chunks des tableaux
+ *
+ * La forme est déduite d'une taille cible en octets, de la taille d'un
+ * élément et du motif d'accès déclaré : des chunks de quelques centaines de
+ * kilo-octets amortissent le coût fixe par chunk (index B-tree, appel du
+ * filtre, entrée du cache) sans dépasser le cache de chunks de HDF5.
+ */
+
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+/* Ancien comportement : au plus 20 éléments par dimension, au-delà de 100 éléments */
+#define LEGACY_CHUNK_EDGE 20
+#define LEGACY_MIN_ELEMENTS 100
+
+/* Forme des chunks de l'ancien comportement */
+static int plan_legacy(int rank, const hsize_t* dims, hsize_t* chunk_dims) {
+    hsize_t elements = 1;
+    for (int i = 0; i < rank; i++) {
+        elements *= dims[i];
+    }
+    if (elements <= LEGACY_MIN_ELEMENTS) {
+        return 0;
+    }
+
+    for (int i = 0; i < rank; i++) {
+        chunk_dims[i] = (i < 3 && dims[i] > LEGACY_CHUNK_EDGE) ? LEGACY_CHUNK_EDGE
+                      : (i < 3) ? dims[i] : 1;
+    }
+    return 1;
+}
+
+/* Parcours ligne par ligne : dimensions complètes en partant de la dernière,
+ * la première qui ne tient plus dans le budget est coupée */
+static void plan_row_scan(int rank, const hsize_t* dims, hsize_t budget, hsize_t* chunk_dims) {
+    int i = rank - 1;
+    for (; i >= 0 && dims[i] <= budget; i--) {
+        chunk_dims[i] = dims[i];
+        budget /= dims[i];
+    }
+    if (i >= 0) {
+        chunk_dims[i] = (budget > 0) ? budget : 1;
+        for (i--; i >= 0; i--) {
+            chunk_dims[i] = 1;
+        }
+    }
+}
+
+/* Plus grand côté dont la puissance n ne dépasse pas budget */
+static hsize_t integer_root(hsize_t budget, int n) {
+    if (n == 1) {
+        return budget;
+    }
+    hsize_t edge = 1;
+    for (;;) {
+        hsize_t volume = 1;
+        for (int i = 0; i < n && volume <= budget; i++) {
+            volume *= edge + 1;
+        }
+        if (volume > budget) {
+            return edge;
+        }
+        edge++;
+    }
+}
+
+/* Tuiles : côtés égaux, le budget laissé par les dimensions trop courtes
+ * est redistribué aux autres */
+static void plan_tile(int rank, const hsize_t* dims, hsize_t budget, hsize_t* chunk_dims) {
+    int fixed[HDF5_LOGGER_MAX_RANK] = {0};
+    int free_count = rank;
+
+    for (int changed = 1; changed && free_count > 0; ) {
+        changed = 0;
+        hsize_t edge = integer_root(budget, free_count);
+        for (int i = 0; i < rank; i++) {
+            if (!fixed[i] && dims[i] <= edge) {
+                chunk_dims[i] = dims[i];
+                budget /= dims[i];
+                fixed[i] = 1;
+                free_count--;
+                changed = 1;
+            }
+        }
+        if (!changed) {
+            for (int i = 0; i < rank; i++) {
+                if (!fixed[i]) {
+                    chunk_dims[i] = (edge > 0) ? edge : 1;
+                }
+            }
+        }
+    }
+}
+
+size_t chunk_target_bytes(const hdf5_array_layout_t* layout) {
+    size_t bytes = (layout != NULL && layout->chunk_bytes > 0) ? layout->chunk_bytes
+                                                               : HDF5_LOGGER_DEFAULT_CHUNK_BYTES;
+    if (bytes < HDF5_LOGGER_MIN_CHUNK_BYTES) {
+        return HDF5_LOGGER_MIN_CHUNK_BYTES;
+    }
+    if (bytes > HDF5_LOGGER_MAX_CHUNK_BYTES) {
+        return HDF5_LOGGER_MAX_CHUNK_BYTES;
+    }
+    return bytes;
+}
+
+int chunk_plan(int rank, const hsize_t* dims, size_t element_size,
+               const hdf5_array_layout_t* layout, hsize_t* chunk_dims) {
+    if (rank < 1 || rank > HDF5_LOGGER_MAX_RANK || dims == NULL || element_size == 0 ||
+        chunk_dims == NULL) {
+        return -1;
+    }
+
+    hdf5_access_pattern_t pattern = (layout != NULL) ? layout->pattern : HDF5_ACCESS_ROW_SCAN;
+    if (pattern == HDF5_ACCESS_LEGACY) {
+        return plan_legacy(rank, dims, chunk_dims);
+    }
+
+    /* Sous une page, la compression ne peut rien gagner : stockage contigu */
+    hsize_t bytes = (hsize_t)element_size;
+    for (int i = 0; i < rank; i++) {
+        bytes *= dims[i];
+    }
+    if (bytes < HDF5_LOGGER_MIN_CHUNK_BYTES) {
+        return 0;
+    }
+
+    hsize_t budget = (hsize_t)(chunk_target_bytes(layout) / element_size);
+    if (budget == 0) {
+        budget = 1;
+    }
+
+    switch (pattern) {
+        case HDF5_ACCESS_FRAME:
+            /* Une trame (premier axe) par chunk, découpée si elle dépasse la cible */
+            chunk_dims[0] = 1;
+            if (rank > 1) {
+                plan_row_scan(rank - 1, dims + 1, budget, chunk_dims + 1);
+            } else {
+                plan_row_scan(1, dims, budget, chunk_dims);
+            }
+            break;
+        case HDF5_ACCESS_TILE:
+            plan_tile(rank, dims, budget, chunk_dims);
+            break;
+        default:
+            plan_row_scan(rank, dims, budget, chunk_dims);
+            break;
+    }
+    return 1;
+}
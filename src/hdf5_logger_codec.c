@@ -0,0 +1,246 @@
+/**
+ * @file hdf5_logger_codec.c
+ * @brief Politique de compression par nature de données, par logger et par groupe
+ *
+ * Chaque nature de données (texte, tableaux, images) a sa politique par
+ * défaut ; un groupe peut la remplacer. La politique est résolue à la
+ * création d'un dataset, sous le verrou d'entrées/sorties : les datasets déjà
+ * créés gardent leurs filtres. LZ4 et Zstd passent par les filtres enregistrés
+ * auprès de The HDF Group, chargés par HDF5 depuis HDF5_PLUGIN_PATH : un
+ * fichier ainsi compressé reste lisible par tout lecteur disposant du greffon.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+/* Identifiants des filtres enregistrés */
+#define FILTER_LZ4 32004
+#define FILTER_ZSTD 32015
+
+/* Niveau Zstd quand la politique n'en précise pas */
+#define ZSTD_DEFAULT_LEVEL 3
+
+/* Politiques par défaut (voir bench_codecs) : les niveaux élevés de deflate
+ * coûtent deux à trois fois plus de temps pour quelques pour cent de taux ; le
+ * réarrangement des octets profite aux tables d'enregistrements et aux
+ * flottants, pas aux pixels d'un octet */
+static const hdf5_codec_policy_t default_policies[HDF5_DATA_KIND_COUNT] = {
+    {HDF5_CODEC_DEFLATE, 1, 1, HDF5_PREDICT_NONE}, /* HDF5_DATA_TEXT */
+    {HDF5_CODEC_DEFLATE, 1, 1, HDF5_PREDICT_NONE}, /* HDF5_DATA_NUMERIC */
+    {HDF5_CODEC_DEFLATE, 1, 0, HDF5_PREDICT_NONE}  /* HDF5_DATA_IMAGE */
+};
+
+/* Identifiant du filtre HDF5 d'un codec (négatif pour HDF5_CODEC_NONE) */
+static H5Z_filter_t codec_filter(hdf5_codec_t codec) {
+    switch (codec) {
+        case HDF5_CODEC_DEFLATE: return H5Z_FILTER_DEFLATE;
+        case HDF5_CODEC_LZ4: return FILTER_LZ4;
+        case HDF5_CODEC_ZSTD: return FILTER_ZSTD;
+        default: return -1;
+    }
+}
+
+/* Vérifie une politique : codec connu et disponible, niveau dans ses bornes, prédiction
+ * connue et réservée aux tableaux et aux images (les enregistrements texte sont composés),
+ * prédiction PNG réservée aux images (elle suit leurs lignes), ni prédiction ni
+ * réarrangement sans codec (ils ne servent qu'à préparer la compression) */
+static int codec_validate(const hdf5_codec_policy_t* policy, hdf5_data_kind_t kind) {
+    if (policy->codec == HDF5_CODEC_NONE &&
+        (policy->predictor != HDF5_PREDICT_NONE || policy->shuffle)) {
+        return -1;
+    }
+    if (policy->predictor != HDF5_PREDICT_NONE &&
+        ((policy->predictor != HDF5_PREDICT_DELTA && policy->predictor != HDF5_PREDICT_XOR &&
+          !predict_by_rows(policy->predictor)) ||
+         kind == HDF5_DATA_TEXT)) {
+        return -1;
+    }
+    if (predict_by_rows(policy->predictor) && kind != HDF5_DATA_IMAGE) {
+        return -1;
+    }
+    switch (policy->codec) {
+        case HDF5_CODEC_NONE:
+            break;
+        case HDF5_CODEC_DEFLATE:
+            if (policy->level < 0 || policy->level > 9) {
+                return -1;
+            }
+            break;
+        case HDF5_CODEC_LZ4:
+            break;
+        case HDF5_CODEC_ZSTD:
+            if (policy->level < 0 || policy->level > 22) {
+                return -1;
+            }
+            break;
+        default:
+            return -1;
+    }
+    return hdf5_codec_available(policy->codec) ? 0 : -1;
+}
+
+int codec_init(hdf5_logger_t* logger) {
+    memcpy(logger->codecs, default_policies, sizeof(default_policies));
+    logger->codec_overrides = NULL;
+    return 0;
+}
+
+void codec_destroy(hdf5_logger_t* logger) {
+    codec_override_t* override = logger->codec_overrides;
+    while (override != NULL) {
+        codec_override_t* next = override->next;
+        free(override->group_path);
+        free(override);
+        override = next;
+    }
+    logger->codec_overrides = NULL;
+}
+
+const hdf5_codec_policy_t* codec_resolve(hdf5_logger_t* logger, const char* group_path,
+                                         hdf5_data_kind_t kind) {
+    for (codec_override_t* override = logger->codec_overrides; override != NULL;
+         override = override->next) {
+        if (override->kind == kind && strcmp(override->group_path, group_path) == 0) {
+            return &override->policy;
+        }
+    }
+    return &logger->codecs[kind];
+}
+
+int codec_apply(hid_t plist_id, const hdf5_codec_policy_t* policy, size_t element_size,
+                int pixel_rank) {
+    if (policy->codec == HDF5_CODEC_NONE) {
+        return 0;
+    }
+
+    /* La prédiction précède le réarrangement : il regroupe les octets nuls qu'elle laisse */
+    hdf5_predictor_t predictor = predict_select(policy, element_size);
+    if (predictor != HDF5_PREDICT_NONE && predict_apply(plist_id, predictor, element_size, pixel_rank) < 0) {
+        return -1;
+    }
+
+    /* Le réarrangement des octets est inutile pour des éléments d'un octet */
+    if (policy->shuffle && element_size > 1 && H5Pset_shuffle(plist_id) < 0) {
+        return -1;
+    }
+
+    herr_t status;
+    if (policy->codec == HDF5_CODEC_DEFLATE) {
+        status = H5Pset_deflate(plist_id, (unsigned)policy->level);
+    } else if (policy->codec == HDF5_CODEC_LZ4) {
+        unsigned int block_size = 0; /* Taille de bloc par défaut du greffon */
+        status = H5Pset_filter(plist_id, FILTER_LZ4, H5Z_FLAG_MANDATORY, 1, &block_size);
+    } else {
+        unsigned int level = (policy->level > 0) ? (unsigned)policy->level : ZSTD_DEFAULT_LEVEL;
+        status = H5Pset_filter(plist_id, FILTER_ZSTD, H5Z_FLAG_MANDATORY, 1, &level);
+    }
+    return (status < 0) ? -1 : 0;
+}
+
+static int set_codec(hdf5_logger_t* logger, hdf5_data_kind_t kind,
+                     const hdf5_codec_policy_t* policy) {
+    if (logger == NULL || !logger->is_open || kind < 0 || kind >= HDF5_DATA_KIND_COUNT) {
+        return -1;
+    }
+
+    if (policy == NULL) {
+        logger->codecs[kind] = default_policies[kind];
+        return 0;
+    }
+    if (codec_validate(policy, kind) < 0) {
+        return -1;
+    }
+
+    logger->codecs[kind] = *policy;
+    return 0;
+}
+
+static int set_group_codec(hdf5_logger_t* logger, const char* group_path, hdf5_data_kind_t kind,
+                           const hdf5_codec_policy_t* policy) {
+    if (logger == NULL || !logger->is_open || group_path == NULL || kind < 0 ||
+        kind >= HDF5_DATA_KIND_COUNT) {
+        return -1;
+    }
+    if (policy != NULL && codec_validate(policy, kind) < 0) {
+        return -1;
+    }
+
+    codec_override_t** link = &logger->codec_overrides;
+    for (; *link != NULL; link = &(*link)->next) {
+        if ((*link)->kind == kind && strcmp((*link)->group_path, group_path) == 0) {
+            break;
+        }
+    }
+
+    /* Sans politique, le groupe revient à celle du logger */
+    if (policy == NULL) {
+        if (*link != NULL) {
+            codec_override_t* override = *link;
+            *link = override->next;
+            free(override->group_path);
+            free(override);
+        }
+        return 0;
+    }
+
+    if (*link == NULL) {
+        codec_override_t* override = (codec_override_t*)malloc(sizeof(codec_override_t));
+        char* path = (override != NULL) ? strdup(group_path) : NULL;
+        if (path == NULL) {
+            free(override);
+            return -1;
+        }
+        override->group_path = path;
+        override->kind = kind;
+        override->next = NULL;
+        *link = override;
+    }
+    (*link)->policy = *policy;
+    return 0;
+}
+
+/* Implémentation des fonctions publiques */
+
+int hdf5_codec_available(hdf5_codec_t codec) {
+    if (codec == HDF5_CODEC_NONE) {
+        return 1;
+    }
+
+    H5Z_filter_t filter = codec_filter(codec);
+    if (filter < 0) {
+        return 0;
+    }
+
+    /* Le chargement d'un greffon absent empile une erreur : ne pas l'afficher */
+    htri_t available = 0;
+    H5E_BEGIN_TRY {
+        available = H5Zfilter_avail(filter);
+    } H5E_END_TRY;
+    return available > 0;
+}
+
+int hdf5_logger_set_codec(hdf5_logger_t* logger, hdf5_data_kind_t kind,
+                          const hdf5_codec_policy_t* policy) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+
+    int status = set_codec(logger, kind, policy);
+
+    logger_unlock(logger);
+    return status;
+}
+
+int hdf5_logger_set_group_codec(hdf5_logger_t* logger, const char* group_path,
+                                hdf5_data_kind_t kind, const hdf5_codec_policy_t* policy) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+
+    int status = set_group_codec(logger, group_path, kind, policy);
+
+    logger_unlock(logger);
+    return status;
+}
@@ -0,0 +1,485 @@
+/**
+ * @file hdf5_logger_dedup.c
+ * @brief Déduplication des tableaux et des images : empreinte du contenu et liens durs
+ *
+ * Une matrice d'étalonnage relogguée à chaque cycle, ou l'image d'une caméra
+ * dont la scène ne bouge pas, serait compressée et écrite à nouveau à chaque
+ * appel. Avec la déduplication, chaque contenu est haché (MurmurHash3 x64 sur
+ * 128 bits, avec le type, les dimensions et la quantification) ; un contenu
+ * déjà écrit devient un lien dur vers son dataset, sans aucune donnée écrite.
+ *
+ * L'index en mémoire associe les empreintes aux chemins des datasets ; dans
+ * le fichier, l'empreinte est l'attribut content_hash de chaque dataset. Un
+ * chemin est vérifié (dataset présent, même attribut) avant d'être lié : un
+ * dataset supprimé ou remplacé depuis n'est jamais pris pour un autre.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+/* Attribut qui porte l'empreinte d'un dataset */
+#define DEDUP_ATTRIBUTE "content_hash"
+
+/* Cases initiales de l'index */
+#define DEDUP_TABLE_INITIAL_SIZE 64
+
+/* Taille des morceaux recopiés depuis un tampon non contigu pour le hachage */
+#define DEDUP_GATHER_BYTES (64 * 1024)
+
+/* Constantes de MurmurHash3 x64 128 */
+#define MURMUR_C1 0x87c37b91114253d5ULL
+#define MURMUR_C2 0x4cf5ad432745937fULL
+
+/* Hachage incrémental : blocs de 16 octets, reste gardé pour l'appel suivant */
+typedef struct {
+    uint64_t h1;
+    uint64_t h2;
+    unsigned char tail[16];   /* Octets en attente d'un bloc complet */
+    size_t tail_size;         /* Nombre d'octets en attente */
+    uint64_t length;          /* Octets hachés */
+} murmur_state_t;
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+/* Lecture petit-boutiste : même empreinte sur toutes les plateformes */
+static inline uint64_t load64(const unsigned char* p) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+static inline void store64(unsigned char* p, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static inline uint64_t fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+static void murmur_block(murmur_state_t* state, const unsigned char* block) {
+    uint64_t k1 = load64(block);
+    uint64_t k2 = load64(block + 8);
+
+    k1 *= MURMUR_C1;
+    k1 = rotl64(k1, 31);
+    k1 *= MURMUR_C2;
+    state->h1 ^= k1;
+    state->h1 = rotl64(state->h1, 27);
+    state->h1 += state->h2;
+    state->h1 = state->h1 * 5 + 0x52dce729;
+
+    k2 *= MURMUR_C2;
+    k2 = rotl64(k2, 33);
+    k2 *= MURMUR_C1;
+    state->h2 ^= k2;
+    state->h2 = rotl64(state->h2, 31);
+    state->h2 += state->h1;
+    state->h2 = state->h2 * 5 + 0x38495ab5;
+}
+
+static void murmur_update(murmur_state_t* state, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    state->length += size;
+
+    /* Compléter le bloc en attente */
+    if (state->tail_size > 0) {
+        size_t take = 16 - state->tail_size;
+        if (take > size) {
+            take = size;
+        }
+        memcpy(state->tail + state->tail_size, bytes, take);
+        state->tail_size += take;
+        bytes += take;
+        size -= take;
+        if (state->tail_size < 16) {
+            return;
+        }
+        murmur_block(state, state->tail);
+        state->tail_size = 0;
+    }
+
+    for (; size >= 16; bytes += 16, size -= 16) {
+        murmur_block(state, bytes);
+    }
+    memcpy(state->tail, bytes, size);
+    state->tail_size = size;
+}
+
+static void murmur_final(murmur_state_t* state, uint64_t hash[2]) {
+    unsigned char tail[16] = {0};
+    memcpy(tail, state->tail, state->tail_size);
+    uint64_t k1 = load64(tail);
+    uint64_t k2 = load64(tail + 8);
+    if (state->tail_size > 8) {
+        k2 *= MURMUR_C2;
+        k2 = rotl64(k2, 33);
+        k2 *= MURMUR_C1;
+        state->h2 ^= k2;
+    }
+    if (state->tail_size > 0) {
+        k1 *= MURMUR_C1;
+        k1 = rotl64(k1, 31);
+        k1 *= MURMUR_C2;
+        state->h1 ^= k1;
+    }
+
+    uint64_t h1 = state->h1 ^ state->length;
+    uint64_t h2 = state->h2 ^ state->length;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+    hash[0] = h1;
+    hash[1] = h2;
+}
+
+/* Chemin absolu d'un dataset, sans barre finale ni barre doublée */
+static char* dedup_path(const char* group_path, const char* name) {
+    size_t group_length = strlen(group_path);
+    while (group_length > 0 && group_path[group_length - 1] == '/') {
+        group_length--;
+    }
+    int rooted = (group_path[0] == '/');
+    size_t size = (rooted ? 0 : 1) + group_length + 1 + strlen(name) + 1;
+    char* path = (char*)malloc(size);
+    if (path == NULL) {
+        return NULL;
+    }
+    snprintf(path, size, "%s%.*s/%s", rooted ? "" : "/", (int)group_length, group_path, name);
+    return path;
+}
+
+/* Case de l'empreinte dans l'index (pointe sur NULL si elle est absente) */
+static dedup_entry_t** dedup_find(dedup_table_t* table, const uint64_t hash[2]) {
+    dedup_entry_t** link = &table->buckets[hash[0] & (table->bucket_count - 1)];
+    while (*link != NULL && ((*link)->hash[0] != hash[0] || (*link)->hash[1] != hash[1])) {
+        link = &(*link)->next;
+    }
+    return link;
+}
+
+/* Double la taille de l'index */
+static int dedup_grow(dedup_table_t* table) {
+    size_t new_count = table->bucket_count * 2;
+    dedup_entry_t** new_buckets = (dedup_entry_t**)calloc(new_count, sizeof(dedup_entry_t*));
+    if (new_buckets == NULL) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < table->bucket_count; i++) {
+        dedup_entry_t* entry = table->buckets[i];
+        while (entry != NULL) {
+            dedup_entry_t* next = entry->next;
+            size_t index = entry->hash[0] & (new_count - 1);
+            entry->next = new_buckets[index];
+            new_buckets[index] = entry;
+            entry = next;
+        }
+    }
+
+    free(table->buckets);
+    table->buckets = new_buckets;
+    table->bucket_count = new_count;
+    return 0;
+}
+
+/* Associe une empreinte à un chemin (repris par l'index), en remplaçant l'ancien */
+static int dedup_insert(dedup_table_t* table, const uint64_t hash[2], char* path) {
+    if (table->buckets == NULL) {
+        table->buckets = (dedup_entry_t**)calloc(DEDUP_TABLE_INITIAL_SIZE,
+                                                 sizeof(dedup_entry_t*));
+        if (table->buckets == NULL) {
+            free(path);
+            return -1;
+        }
+        table->bucket_count = DEDUP_TABLE_INITIAL_SIZE;
+    }
+
+    dedup_entry_t** link = dedup_find(table, hash);
+    if (*link != NULL) {
+        free((*link)->path);
+        (*link)->path = path;
+        return 0;
+    }
+
+    /* Facteur de charge de 1 : agrandir avant d'insérer */
+    if (table->count >= table->bucket_count) {
+        dedup_grow(table);
+    }
+    dedup_entry_t* entry = (dedup_entry_t*)malloc(sizeof(dedup_entry_t));
+    if (entry == NULL) {
+        free(path);
+        return -1;
+    }
+    entry->hash[0] = hash[0];
+    entry->hash[1] = hash[1];
+    entry->path = path;
+    size_t index = hash[0] & (table->bucket_count - 1);
+    entry->next = table->buckets[index];
+    table->buckets[index] = entry;
+    table->count++;
+    return 0;
+}
+
+/* Libère toutes les empreintes ; les compteurs sont gardés */
+static void dedup_clear(dedup_table_t* table) {
+    for (size_t i = 0; i < table->bucket_count; i++) {
+        dedup_entry_t* entry = table->buckets[i];
+        while (entry != NULL) {
+            dedup_entry_t* next = entry->next;
+            free(entry->path);
+            free(entry);
+            entry = next;
+        }
+    }
+    free(table->buckets);
+    table->buckets = NULL;
+    table->bucket_count = 0;
+    table->count = 0;
+}
+
+/* Lit l'empreinte notée sur un objet ; -1 s'il n'en porte pas */
+static int dedup_read_attribute(hid_t obj_id, uint64_t hash[2]) {
+    if (H5Aexists(obj_id, DEDUP_ATTRIBUTE) <= 0) {
+        return -1;
+    }
+    hid_t attr_id = H5Aopen(obj_id, DEDUP_ATTRIBUTE, H5P_DEFAULT);
+    if (attr_id < 0) {
+        return -1;
+    }
+    herr_t status = H5Aread(attr_id, H5T_NATIVE_UINT64, hash);
+    H5Aclose(attr_id);
+    return (status < 0) ? -1 : 0;
+}
+
+/* Vérifie que le chemin mène toujours à un dataset de cette empreinte */
+static int dedup_matches(hid_t file_id, const char* path, const uint64_t hash[2]) {
+    hid_t dataset_id;
+    H5E_BEGIN_TRY {
+        dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if (dataset_id < 0) {
+        return 0;
+    }
+    uint64_t stored[2];
+    int matches = (dedup_read_attribute(dataset_id, stored) == 0 && stored[0] == hash[0] &&
+                   stored[1] == hash[1]);
+    H5Dclose(dataset_id);
+    return matches;
+}
+
+/* Ajoute à l'index chaque dataset du fichier qui porte une empreinte */
+static herr_t dedup_scan_link(hid_t group_id, const char* name, const H5L_info_t* info,
+                              void* op_data) {
+    dedup_table_t* table = (dedup_table_t*)op_data;
+    if (info->type != H5L_TYPE_HARD) {
+        return 0;
+    }
+
+    /* Les groupes et les types nommés ne s'ouvrent pas comme des datasets */
+    hid_t dataset_id;
+    H5E_BEGIN_TRY {
+        dataset_id = H5Dopen2(group_id, name, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if (dataset_id < 0) {
+        return 0;
+    }
+    uint64_t hash[2];
+    int found = (dedup_read_attribute(dataset_id, hash) == 0);
+    H5Dclose(dataset_id);
+
+    /* Le premier nom rencontré d'un contenu est gardé */
+    if (found && (table->buckets == NULL || *dedup_find(table, hash) == NULL)) {
+        char* path = dedup_path("/", name);
+        if (path == NULL || dedup_insert(table, hash, path) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int dedup_hash(hdf5_logger_t* logger, hdf5_data_kind_t kind, const void* data,
+               const source_view_t* view, int rank, const hsize_t* dims, hdf5_dtype_t dtype,
+               const hdf5_quantize_t* quantize, uint64_t hash[2]) {
+    murmur_state_t state;
+    memset(&state, 0, sizeof(state));
+
+    /* Description du contenu : nature, type, dimensions et quantification */
+    unsigned char header[8 * (HDF5_LOGGER_MAX_RANK + 5)];
+    size_t header_size = 0;
+    uint64_t precision = 0;
+    if (quantize != NULL) {
+        memcpy(&precision, &quantize->precision, sizeof(precision));
+    }
+    uint64_t fields[5] = {(uint64_t)kind, (uint64_t)dtype, (uint64_t)rank,
+                          (quantize != NULL) ? (uint64_t)quantize->mode : 0, precision};
+    for (int i = 0; i < 5; i++, header_size += 8) {
+        store64(header + header_size, fields[i]);
+    }
+    size_t count = 1;
+    for (int i = 0; i < rank; i++, header_size += 8) {
+        store64(header + header_size, (uint64_t)dims[i]);
+        count *= (size_t)dims[i];
+    }
+    murmur_update(&state, header, header_size);
+
+    /* Données, recopiées par morceaux depuis un tampon non contigu */
+    size_t element_size = dtype_size(dtype);
+    if (view == NULL) {
+        murmur_update(&state, data, count * element_size);
+    } else {
+        size_t block = DEDUP_GATHER_BYTES / element_size;
+        void* gathered = arena_alloc(logger->arena, block * element_size);
+        if (gathered == NULL) {
+            return -1;
+        }
+        for (size_t first = 0; first < count; first += block) {
+            size_t n = (count - first < block) ? count - first : block;
+            view_gather(view, data, element_size, first, n, gathered);
+            murmur_update(&state, gathered, n * element_size);
+        }
+        arena_free(logger->arena, gathered);
+    }
+
+    murmur_final(&state, hash);
+    logger->dedup.checked++;
+    return 0;
+}
+
+int dedup_link(hdf5_logger_t* logger, hid_t group_id, const char* group_path, const char* name,
+               const uint64_t hash[2], size_t bytes) {
+    dedup_table_t* table = &logger->dedup;
+    if (table->buckets == NULL) {
+        return 0;
+    }
+    dedup_entry_t** link = dedup_find(table, hash);
+    if (*link == NULL) {
+        return 0;
+    }
+
+    /* Dataset supprimé ou remplacé depuis : empreinte oubliée */
+    dedup_entry_t* entry = *link;
+    if (!dedup_matches(logger->file_id, entry->path, hash)) {
+        *link = entry->next;
+        free(entry->path);
+        free(entry);
+        table->count--;
+        return 0;
+    }
+
+    /* Le dataset visé porte déjà ce contenu : rien à écrire */
+    char* path = dedup_path(group_path, name);
+    if (path == NULL) {
+        return -1;
+    }
+    int status = 0;
+    if (strcmp(path, entry->path) != 0) {
+        if (H5Lexists(group_id, name, H5P_DEFAULT) > 0 &&
+            H5Ldelete(group_id, name, H5P_DEFAULT) < 0) {
+            status = -1;
+        } else if (H5Lcreate_hard(logger->file_id, entry->path, group_id, name, H5P_DEFAULT,
+                                  H5P_DEFAULT) < 0) {
+            status = -1;
+        }
+    }
+    free(path);
+    if (status < 0) {
+        return -1;
+    }
+
+    table->duplicates++;
+    table->bytes_saved += bytes;
+    return 1;
+}
+
+void dedup_record(hdf5_logger_t* logger, hid_t dataset_id, const char* group_path,
+                  const char* name, const uint64_t hash[2]) {
+    hsize_t size = 2;
+    hid_t space_id = H5Screate_simple(1, &size, NULL);
+    hid_t attr_id = H5Acreate2(dataset_id, DEDUP_ATTRIBUTE, H5T_STD_U64LE, space_id,
+                               H5P_DEFAULT, H5P_DEFAULT);
+    herr_t status = (attr_id < 0) ? -1 : H5Awrite(attr_id, H5T_NATIVE_UINT64, hash);
+    if (attr_id >= 0) H5Aclose(attr_id);
+    H5Sclose(space_id);
+
+    /* Sans attribut, le dataset ne pourrait pas être vérifié avant d'être lié */
+    char* path = (status < 0) ? NULL : dedup_path(group_path, name);
+    if (path != NULL) {
+        dedup_insert(&logger->dedup, hash, path);
+    }
+}
+
+void dedup_destroy(hdf5_logger_t* logger) {
+    dedup_clear(&logger->dedup);
+}
+
+static int set_dedup(hdf5_logger_t* logger, int enabled) {
+    if (logger == NULL || !logger->is_open) {
+        return -1;
+    }
+
+    dedup_table_t* table = &logger->dedup;
+    if (!enabled) {
+        dedup_clear(table);
+        table->enabled = 0;
+        return 0;
+    }
+    if (table->enabled) {
+        return 0;
+    }
+
+    /* Empreintes notées par les sessions précédentes */
+    if (H5Lvisit(logger->file_id, H5_INDEX_NAME, H5_ITER_NATIVE, dedup_scan_link, table) < 0) {
+        dedup_clear(table);
+        return -1;
+    }
+    table->enabled = 1;
+    return 0;
+}
+
+/* Implémentation des fonctions publiques */
+
+int hdf5_logger_set_dedup(hdf5_logger_t* logger, int enabled) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+
+    int status = set_dedup(logger, enabled);
+
+    logger_unlock(logger);
+    return status;
+}
+
+int hdf5_logger_get_dedup_stats(hdf5_logger_t* logger, hdf5_dedup_stats_t* stats) {
+    if (logger == NULL || !logger->is_open || stats == NULL) {
+        return -1;
+    }
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+
+    stats->checked = logger->dedup.checked;
+    stats->duplicates = logger->dedup.duplicates;
+    stats->bytes_saved = logger->dedup.bytes_saved;
+    stats->indexed = logger->dedup.count;
+
+    logger_unlock(logger);
+    return 0;
+}
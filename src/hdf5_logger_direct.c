@@ -0,0 +1,318 @@
+/**
+ * @file hdf5_logger_direct.c
+ * @brief Compression parallèle des chunks et écriture directe (H5Dwrite_chunk)
+ *
+ * Le pipeline de filtres HDF5 compresse les chunks l'un après l'autre sur le
+ * thread qui écrit. Ici, les chunks sont découpés, réarrangés et compressés
+ * par le groupe de threads, puis écrits tels quels dans l'ordre. Le résultat
+ * est octet pour octet celui du pipeline : mêmes filtres déclarés, chunks de
+ * bord complétés par la valeur de remplissage (zéro), prédiction, shuffle
+ * puis deflate zlib au même niveau. Tout lecteur HDF5 les décode donc normalement.
+ * La prédiction PNG reprend la géométrie des lignes rangée dans le filtre du
+ * dataset.
+ *
+ * Seul deflate est compressé ainsi : LZ4 et Zstd sont des greffons chargés
+ * par HDF5 et restent dans son pipeline.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+/* Chunks compressés par thread et par lot : borne la mémoire des chunks en attente */
+#define DIRECT_CHUNKS_PER_THREAD 4
+
+/* Tampons d'un chunk en cours de compression */
+typedef struct {
+    unsigned char* raw;       /* Chunk découpé, complété par des zéros */
+    unsigned char* predicted; /* Chunk codé par la prédiction PNG (NULL sans elle) */
+    unsigned char* shuffled;  /* Chunk réarrangé (NULL sans shuffle) */
+    unsigned char* packed;    /* Chunk compressé */
+    size_t packed_size;       /* Octets utiles de packed */
+    hsize_t offset[HDF5_LOGGER_MAX_RANK]; /* Position du chunk (en éléments) */
+    int status;               /* 0 si la compression a réussi */
+} direct_slot_t;
+
+/* Lot de chunks compressés en parallèle */
+typedef struct {
+    const unsigned char* data; /* Bloc écrit */
+    const source_view_t* view; /* Sélection du bloc dans son tampon (NULL = dense) */
+    int rank;
+    const hsize_t* origin;     /* Position du bloc dans le dataset (NULL = origine) */
+    const hsize_t* dims;       /* Dimensions du bloc */
+    const hsize_t* chunk_dims; /* Dimensions d'un chunk */
+    hsize_t grid[HDF5_LOGGER_MAX_RANK]; /* Nombre de chunks par dimension */
+    size_t element_size;
+    size_t chunk_bytes;        /* Taille brute d'un chunk */
+    size_t encoded_bytes;      /* Taille d'un chunk après la prédiction */
+    uLong packed_capacity;     /* Taille maximale d'un chunk compressé */
+    hdf5_predictor_t predictor; /* Prédiction avant le réarrangement */
+    predict_rows_t rows;       /* Géométrie des lignes de la prédiction PNG */
+    int shuffle;               /* Réarrangement des octets avant deflate */
+    int level;                 /* Niveau deflate */
+    size_t first;              /* Indice du premier chunk du lot */
+    direct_slot_t* slots;      /* Un jeu de tampons par chunk du lot */
+} direct_batch_t;
+
+/* Recopie un chunk du tableau ; les éléments hors du tableau restent à zéro */
+static void chunk_gather(const direct_batch_t* batch, const hsize_t* offset, unsigned char* out) {
+    int rank = batch->rank;
+    hsize_t extent[HDF5_LOGGER_MAX_RANK];
+    int partial = 0;
+    for (int i = 0; i < rank; i++) {
+        hsize_t remaining = batch->dims[i] - offset[i];
+        extent[i] = (remaining < batch->chunk_dims[i]) ? remaining : batch->chunk_dims[i];
+        partial |= (extent[i] < batch->chunk_dims[i]);
+    }
+    if (partial) {
+        memset(out, 0, batch->chunk_bytes);
+    }
+
+    /* Une ligne (dernière dimension) par copie, les indices des autres dimensions en compteur */
+    size_t row_bytes = (size_t)extent[rank - 1] * batch->element_size;
+    hsize_t index[HDF5_LOGGER_MAX_RANK] = {0};
+    for (;;) {
+        hsize_t source = 0;
+        hsize_t target = 0;
+        for (int i = 0; i < rank; i++) {
+            source = source * batch->dims[i] + offset[i] + index[i];
+            target = target * batch->chunk_dims[i] + index[i];
+        }
+        if (batch->view != NULL) {
+            view_gather(batch->view, batch->data, batch->element_size, (size_t)source,
+                        (size_t)extent[rank - 1], out + target * batch->element_size);
+        } else {
+            memcpy(out + target * batch->element_size, batch->data + source * batch->element_size,
+                   row_bytes);
+        }
+
+        int dim = rank - 2;
+        while (dim >= 0 && ++index[dim] == extent[dim]) {
+            index[dim] = 0;
+            dim--;
+        }
+        if (dim < 0) {
+            break;
+        }
+    }
+}
+
+/* Réarrangement des octets du filtre shuffle de HDF5 : l'octet j de chaque élément, puis j + 1 */
+static void chunk_shuffle(const unsigned char* in, size_t bytes, size_t element_size,
+                          unsigned char* out) {
+    size_t count = bytes / element_size;
+    for (size_t j = 0; j < element_size; j++) {
+        const unsigned char* source = in + j;
+        unsigned char* target = out + j * count;
+        for (size_t i = 0; i < count; i++) {
+            target[i] = source[i * element_size];
+        }
+    }
+    memcpy(out + count * element_size, in + count * element_size, bytes - count * element_size);
+}
+
+/* Tâche du groupe de threads : découpe, prédit, réarrange et compresse un chunk du lot */
+static void compress_task(void* arg, size_t index) {
+    direct_batch_t* batch = (direct_batch_t*)arg;
+    direct_slot_t* slot = &batch->slots[index];
+
+    size_t chunk = batch->first + index;
+    for (int i = batch->rank - 1; i >= 0; i--) {
+        slot->offset[i] = (chunk % batch->grid[i]) * batch->chunk_dims[i];
+        chunk /= batch->grid[i];
+    }
+
+    chunk_gather(batch, slot->offset, slot->raw);
+    if (batch->origin != NULL) {
+        for (int i = 0; i < batch->rank; i++) {
+            slot->offset[i] += batch->origin[i];
+        }
+    }
+    const unsigned char* input = slot->raw;
+    if (slot->predicted != NULL) {
+        predict_rows_encode(&batch->rows, slot->raw, batch->chunk_bytes, slot->predicted);
+        input = slot->predicted;
+    } else if (batch->predictor != HDF5_PREDICT_NONE) {
+        predict_encode(slot->raw, batch->chunk_bytes, batch->element_size, batch->predictor);
+    }
+    if (batch->shuffle) {
+        chunk_shuffle(input, batch->encoded_bytes, batch->element_size, slot->shuffled);
+        input = slot->shuffled;
+    }
+
+    uLongf packed_size = batch->packed_capacity;
+    int status = compress2(slot->packed, &packed_size, input, (uLong)batch->encoded_bytes,
+                           batch->level);
+    slot->packed_size = (size_t)packed_size;
+    slot->status = (status == Z_OK) ? 0 : -1;
+}
+
+static void free_slots(memory_arena_t* arena, direct_slot_t* slots, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        arena_free(arena, slots[i].raw);
+        arena_free(arena, slots[i].predicted);
+        arena_free(arena, slots[i].shuffled);
+        arena_free(arena, slots[i].packed);
+    }
+    arena_free(arena, slots);
+}
+
+/* Compresse et écrit tous les chunks par lots ; renvoie 0 en cas de succès, -1 en cas
+ * d'erreur, 1 si les tampons n'ont pas pu être pris (rien n'a été écrit) */
+static int direct_write(hdf5_logger_t* logger, hid_t dataset_id, direct_batch_t* batch,
+                        size_t chunk_count) {
+    size_t slot_count = pool_size(logger->compress_pool) * DIRECT_CHUNKS_PER_THREAD;
+    if (slot_count > chunk_count) {
+        slot_count = chunk_count;
+    }
+
+    /* Tampons réutilisés d'une écriture à l'autre */
+    memory_arena_t* arena = logger->arena;
+    batch->slots = (direct_slot_t*)arena_alloc(arena, slot_count * sizeof(direct_slot_t));
+    if (batch->slots == NULL) {
+        return 1;
+    }
+    memset(batch->slots, 0, slot_count * sizeof(direct_slot_t));
+    for (size_t i = 0; i < slot_count; i++) {
+        direct_slot_t* slot = &batch->slots[i];
+        int by_rows = predict_by_rows(batch->predictor);
+        slot->raw = (unsigned char*)arena_alloc(arena, batch->chunk_bytes);
+        slot->predicted = by_rows ? (unsigned char*)arena_alloc(arena, batch->encoded_bytes) : NULL;
+        slot->shuffled = batch->shuffle ? (unsigned char*)arena_alloc(arena, batch->encoded_bytes)
+                                        : NULL;
+        slot->packed = (unsigned char*)arena_alloc(arena, batch->packed_capacity);
+        if (slot->raw == NULL || slot->packed == NULL || (by_rows && slot->predicted == NULL) ||
+            (batch->shuffle && slot->shuffled == NULL)) {
+            free_slots(arena, batch->slots, slot_count);
+            return 1;
+        }
+    }
+
+    int status = 0;
+    for (batch->first = 0; batch->first < chunk_count && status == 0; batch->first += slot_count) {
+        size_t count = chunk_count - batch->first;
+        if (count > slot_count) {
+            count = slot_count;
+        }
+        pool_run(logger->compress_pool, count, compress_task, batch);
+
+        /* Filtre 0 : tous les filtres déclarés ont été appliqués */
+        for (size_t i = 0; i < count && status == 0; i++) {
+            direct_slot_t* slot = &batch->slots[i];
+            if (slot->status < 0 ||
+                H5Dwrite_chunk(dataset_id, H5P_DEFAULT, 0, slot->offset, slot->packed_size,
+                               slot->packed) < 0) {
+                status = -1;
+            }
+        }
+    }
+
+    free_slots(arena, batch->slots, slot_count);
+    return status;
+}
+
+/* Écrit un bloc par le pipeline HDF5, qui lit un tampon non contigu au travers de sa sélection */
+static int pipeline_write(hid_t dataset_id, hid_t mem_type_id, int rank, const hsize_t* origin,
+                          const hsize_t* dims, const void* data, const source_view_t* view) {
+    if (origin == NULL && view == NULL) {
+        return (H5Dwrite(dataset_id, mem_type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) ? -1 : 0;
+    }
+
+    herr_t status = -1;
+    hid_t file_space = (origin != NULL) ? H5Dget_space(dataset_id) : H5S_ALL;
+    hid_t mem_space = (view != NULL) ? view_space(view) : H5Screate_simple(rank, dims, NULL);
+    if (mem_space >= 0 && (origin == NULL ||
+                           H5Sselect_hyperslab(file_space, H5S_SELECT_SET, origin, NULL, dims,
+                                               NULL) >= 0)) {
+        status = H5Dwrite(dataset_id, mem_type_id, mem_space, file_space, H5P_DEFAULT, data);
+    }
+    if (mem_space >= 0) H5Sclose(mem_space);
+    if (origin != NULL) H5Sclose(file_space);
+    return (status < 0) ? -1 : 0;
+}
+
+int chunks_write(hdf5_logger_t* logger, hid_t dataset_id, hid_t mem_type_id, int rank,
+                 const hsize_t* origin, const hsize_t* dims, const hsize_t* chunk_dims,
+                 const hdf5_codec_policy_t* policy, const void* data, const source_view_t* view) {
+    size_t element_size = H5Tget_size(mem_type_id);
+    size_t chunk_count = 1;
+    size_t chunk_bytes = element_size;
+    int aligned = 1;
+    direct_batch_t batch;
+    for (int i = 0; i < rank; i++) {
+        batch.grid[i] = (dims[i] + chunk_dims[i] - 1) / chunk_dims[i];
+        chunk_count *= (size_t)batch.grid[i];
+        chunk_bytes *= (size_t)chunk_dims[i];
+        aligned &= (origin == NULL || origin[i] % chunk_dims[i] == 0);
+    }
+
+    /* Le pipeline HDF5 reste le chemin normal : sans groupe de threads, pour les codecs qu'il
+     * est seul à connaître, quand il n'y a qu'un chunk à compresser, et quand le bloc commence
+     * au milieu d'un chunk (il faut alors relire la partie déjà écrite) */
+    if (logger->compress_pool == NULL || policy->codec != HDF5_CODEC_DEFLATE || chunk_count < 2 ||
+        !aligned) {
+        return pipeline_write(dataset_id, mem_type_id, rank, origin, dims, data, view);
+    }
+
+    batch.data = (const unsigned char*)data;
+    batch.view = view;
+    batch.rank = rank;
+    batch.origin = origin;
+    batch.dims = dims;
+    batch.chunk_dims = chunk_dims;
+    batch.element_size = element_size;
+    batch.chunk_bytes = chunk_bytes;
+    batch.encoded_bytes = chunk_bytes;
+    batch.predictor = predict_select(policy, element_size); /* Comme codec_apply */
+    if (predict_by_rows(batch.predictor)) {
+        /* Géométrie des lignes fixée à la création du dataset */
+        if (predict_rows_read(dataset_id, &batch.rows) < 0) {
+            return pipeline_write(dataset_id, mem_type_id, rank, origin, dims, data, view);
+        }
+        batch.encoded_bytes = predict_rows_encoded_bytes(&batch.rows, chunk_bytes);
+    }
+    batch.packed_capacity = compressBound((uLong)batch.encoded_bytes);
+    batch.shuffle = (policy->shuffle && element_size > 1);
+    batch.level = policy->level;
+    batch.first = 0;
+    batch.slots = NULL;
+    int status = direct_write(logger, dataset_id, &batch, chunk_count);
+
+    /* Limite mémoire atteinte : le pipeline compresse sans tampons supplémentaires */
+    if (status > 0) {
+        return pipeline_write(dataset_id, mem_type_id, rank, origin, dims, data, view);
+    }
+    return status;
+}
+
+static int set_compression_threads(hdf5_logger_t* logger, size_t threads) {
+    if (logger == NULL || !logger->is_open || threads > HDF5_LOGGER_MAX_COMPRESSION_THREADS) {
+        return -1;
+    }
+
+    /* Le thread qui écrit compresse aussi : threads - 1 threads de travail */
+    compress_pool_t* pool = NULL;
+    if (threads > 1) {
+        pool = pool_start(threads - 1);
+        if (pool == NULL) {
+            return -1;
+        }
+    }
+
+    pool_stop(logger->compress_pool);
+    logger->compress_pool = pool;
+    return 0;
+}
+
+int hdf5_logger_set_compression_threads(hdf5_logger_t* logger, size_t threads) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+
+    int status = set_compression_threads(logger, threads);
+
+    logger_unlock(logger);
+    return status;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file hdf5_logger_dtype.c
+ * @brief Types des éléments des tableaux et des images
+ *
+ * Le type de la mémoire est aussi celui du dataset : HDF5 copie les éléments
+ * sans conversion. La demi-précision, absente des types natifs de HDF5 1.10,
+ * est décrite une fois par logger comme un flottant IEEE 754 de 16 bits
+ * (1 bit de signe, 5 d'exposant, 10 de mantisse), relu comme tel par h5py et
+ * NumPy.
+ */
+
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+/* Crée le type demi-précision dans l'ordre des octets de la machine */
+static hid_t create_half_type(void) {
+    hid_t type_id = H5Tcopy(H5T_NATIVE_FLOAT);
+    if (type_id < 0) {
+        return -1;
+    }
+    if (H5Tset_fields(type_id, 15, 10, 5, 0, 10) < 0 || H5Tset_size(type_id, 2) < 0 ||
+        H5Tset_ebias(type_id, 15) < 0) {
+        H5Tclose(type_id);
+        return -1;
+    }
+    return type_id;
+}
+
+size_t dtype_size(hdf5_dtype_t dtype) {
+    switch (dtype) {
+        case HDF5_DTYPE_INT8:
+        case HDF5_DTYPE_UINT8:
+            return 1;
+        case HDF5_DTYPE_INT16:
+        case HDF5_DTYPE_UINT16:
+        case HDF5_DTYPE_FLOAT16:
+            return 2;
+        case HDF5_DTYPE_INT32:
+        case HDF5_DTYPE_UINT32:
+        case HDF5_DTYPE_FLOAT32:
+            return 4;
+        case HDF5_DTYPE_INT64:
+        case HDF5_DTYPE_UINT64:
+        case HDF5_DTYPE_FLOAT64:
+            return 8;
+    }
+    return 0;
+}
+
+hid_t dtype_type(hdf5_logger_t* logger, hdf5_dtype_t dtype) {
+    switch (dtype) {
+        case HDF5_DTYPE_FLOAT32: return H5T_NATIVE_FLOAT;
+        case HDF5_DTYPE_FLOAT64: return H5T_NATIVE_DOUBLE;
+        case HDF5_DTYPE_INT8:    return H5T_NATIVE_INT8;
+        case HDF5_DTYPE_INT16:   return H5T_NATIVE_INT16;
+        case HDF5_DTYPE_INT32:   return H5T_NATIVE_INT32;
+        case HDF5_DTYPE_INT64:   return H5T_NATIVE_INT64;
+        case HDF5_DTYPE_UINT8:   return H5T_NATIVE_UINT8;
+        case HDF5_DTYPE_UINT16:  return H5T_NATIVE_UINT16;
+        case HDF5_DTYPE_UINT32:  return H5T_NATIVE_UINT32;
+        case HDF5_DTYPE_UINT64:  return H5T_NATIVE_UINT64;
+        case HDF5_DTYPE_FLOAT16:
+            if (logger->half_type_id < 0) {
+                logger->half_type_id = create_half_type();
+            }
+            return logger->half_type_id;
+    }
+    return -1;
+}
+
+void dtype_close(hdf5_logger_t* logger) {
+    if (logger->half_type_id >= 0) {
+        H5Tclose(logger->half_type_id);
+        logger->half_type_id = -1;
+    }
+}
@@ -0,0 +1,860 @@
+/**
+ * @file hdf5_logger_format.c
+ * @brief Logs texte à formatage différé : formats internés et arguments binaires
+ *
+ * hdf5_log_textf ne formate rien au moment du log. Chaque chaîne de format
+ * distincte est internée une fois dans le dataset /text_formats du fichier
+ * (une chaîne par ligne, identifiant = rang + 1) ; chaque entrée ne stocke que
+ * l'identifiant du format et ses arguments encodés : entiers en varint
+ * (zigzag pour les signés), flottants sur 8 octets, chaînes précédées de leur
+ * longueur. Le message n'est reconstitué qu'à la relecture.
+ *
+ * Chaque thread garde un petit cache adresse du format -> format interné :
+ * seule la première rencontre d'un format par un thread prend le verrou de
+ * la table, où le format est retrouvé par son hachage.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+#include "hdf5_logger_platform.h"
+
+/* Nom du dataset des formats internés */
+#define FORMATS_DATASET "/text_formats"
+
+/* Taille des chunks du dataset des formats */
+#define FORMATS_CHUNK 64
+
+/* Nombre de cases du cache de formats de chaque thread (puissance de deux) */
+#define FORMAT_CACHE_SIZE 64
+
+/* Longueur maximale d'une conversion (%-+#0 largeur . précision longueur type) */
+#define SPEC_MAX_LENGTH 32
+
+/* Type d'un argument, tel que lu par va_arg */
+enum {
+    KIND_INT = 1,   /* int (d, i, c, et largeurs ou précisions *) */
+    KIND_UINT,      /* unsigned int */
+    KIND_LONG,
+    KIND_ULONG,
+    KIND_LLONG,
+    KIND_ULLONG,
+    KIND_SIZE,      /* size_t (z) */
+    KIND_INTMAX,    /* intmax_t (j) */
+    KIND_UINTMAX,
+    KIND_PTRDIFF,   /* ptrdiff_t (t) */
+    KIND_DOUBLE,
+    KIND_LDOUBLE,   /* long double, conservé comme double */
+    KIND_STRING,
+    KIND_POINTER
+};
+
+/* Conversion trouvée dans un format */
+typedef struct {
+    const char* start;       /* Premier caractère (le %) */
+    size_t length;           /* Longueur de la conversion */
+    int stars;               /* Largeur et précision passées en argument (0 à 2) */
+    unsigned char kind;      /* Type de la valeur */
+} format_spec_t;
+
+/* Cache de formats par thread */
+typedef struct {
+    unsigned long logger_id;
+    const char* fmt;
+    text_format_t* format;
+} format_cache_entry_t;
+
+static LOGGER_THREAD_LOCAL format_cache_entry_t format_cache[FORMAT_CACHE_SIZE];
+
+/* Hachage FNV-1a d'une chaîne */
+static unsigned long hash_string(const char* text) {
+    unsigned long hash = 2166136261UL;
+    for (const unsigned char* p = (const unsigned char*)text; *p != '\0'; p++) {
+        hash ^= *p;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+/* Cherche la prochaine conversion à partir de p et renvoie la position qui la suit ;
+ * renvoie NULL s'il n'y en a plus, avec invalid à 1 si elle n'est pas reconnue */
+static const char* next_spec(const char* p, format_spec_t* spec, int* invalid) {
+    *invalid = 0;
+    for (;;) {
+        p = strchr(p, '%');
+        if (p == NULL) {
+            return NULL;
+        }
+        if (p[1] == '%') {
+            p += 2;
+            continue;
+        }
+        break;
+    }
+
+    const char* start = p++;
+    spec->start = start;
+    spec->stars = 0;
+
+    while (*p != '\0' && strchr("-+ #0'", *p) != NULL) {
+        p++;
+    }
+    if (*p == '*') {
+        spec->stars++;
+        p++;
+    } else {
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->stars++;
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9') {
+                p++;
+            }
+        }
+    }
+
+    /* Modificateur de longueur */
+    char modifier = 0;
+    if (p[0] == 'h' && p[1] == 'h') {
+        modifier = 'H';
+        p += 2;
+    } else if (p[0] == 'l' && p[1] == 'l') {
+        modifier = 'q';
+        p += 2;
+    } else if (*p != '\0' && strchr("hlLzjt", *p) != NULL) {
+        modifier = *p++;
+    }
+
+    switch (*p) {
+        case 'd': case 'i':
+            switch (modifier) {
+                case 'l': spec->kind = KIND_LONG; break;
+                case 'q': spec->kind = KIND_LLONG; break;
+                case 'z': spec->kind = KIND_PTRDIFF; break;
+                case 'j': spec->kind = KIND_INTMAX; break;
+                case 't': spec->kind = KIND_PTRDIFF; break;
+                case 'L': *invalid = 1; return NULL;
+                default: spec->kind = KIND_INT; break;
+            }
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            switch (modifier) {
+                case 'l': spec->kind = KIND_ULONG; break;
+                case 'q': spec->kind = KIND_ULLONG; break;
+                case 'z': spec->kind = KIND_SIZE; break;
+                case 'j': spec->kind = KIND_UINTMAX; break;
+                case 't': spec->kind = KIND_PTRDIFF; break;
+                case 'L': *invalid = 1; return NULL;
+                default: spec->kind = KIND_UINT; break;
+            }
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if (modifier != 0 && modifier != 'l' && modifier != 'L') {
+                *invalid = 1;
+                return NULL;
+            }
+            spec->kind = (modifier == 'L') ? KIND_LDOUBLE : KIND_DOUBLE;
+            break;
+        case 'c':
+        case 's':
+        case 'p':
+            /* Caractères larges non pris en charge */
+            if (modifier != 0) {
+                *invalid = 1;
+                return NULL;
+            }
+            spec->kind = (*p == 'c') ? KIND_INT : (*p == 's') ? KIND_STRING : KIND_POINTER;
+            break;
+        default:
+            /* %n et conversions inconnues */
+            *invalid = 1;
+            return NULL;
+    }
+
+    p++;
+    spec->length = (size_t)(p - start);
+    if (spec->length >= SPEC_MAX_LENGTH) {
+        *invalid = 1;
+        return NULL;
+    }
+    return p;
+}
+
+/* Crée un format : chaîne recopiée et types de ses arguments ; kinds reste NULL si invalide */
+static text_format_t* format_create(const char* text, unsigned long hash) {
+    text_format_t* format = (text_format_t*)calloc(1, sizeof(text_format_t));
+    if (format == NULL) {
+        return NULL;
+    }
+    format->text = strdup(text);
+    format->hash = hash;
+    if (format->text == NULL) {
+        free(format);
+        return NULL;
+    }
+
+    size_t capacity = 0;
+    const char* p = text;
+    format_spec_t spec;
+    int invalid = 0;
+    unsigned char* kinds = (unsigned char*)malloc(1);
+    while (kinds != NULL && (p = next_spec(p, &spec, &invalid)) != NULL) {
+        if (format->kind_count + 3 > capacity) {
+            capacity = capacity ? capacity * 2 : 8;
+            unsigned char* grown = realloc(kinds, capacity);
+            if (grown == NULL) {
+                free(kinds);
+                kinds = NULL;
+                break;
+            }
+            kinds = grown;
+        }
+        for (int i = 0; i < spec.stars; i++) {
+            kinds[format->kind_count++] = KIND_INT;
+        }
+        kinds[format->kind_count++] = spec.kind;
+    }
+
+    if (invalid || kinds == NULL) {
+        free(kinds);
+        format->kinds = NULL;
+        format->kind_count = 0;
+    } else {
+        format->kinds = kinds;
+    }
+    return format;
+}
+
+static void format_free(text_format_t* format) {
+    free(format->kinds);
+    free(format->text);
+    free(format);
+}
+
+/* Range un format dans l'index : première case libre à partir de son hachage */
+static void index_place(text_format_t** index, size_t size, text_format_t* format) {
+    size_t slot = format->hash & (size - 1);
+    while (index[slot] != NULL) {
+        slot = (slot + 1) & (size - 1);
+    }
+    index[slot] = format;
+}
+
+/* Double l'index pour qu'il reste au plus à moitié plein */
+static int index_grow(format_table_t* table) {
+    size_t size = table->index_size ? table->index_size * 2 : 64;
+    text_format_t** index = (text_format_t**)calloc(size, sizeof(text_format_t*));
+    if (index == NULL) {
+        return -1;
+    }
+    for (size_t i = 0; i < table->index_size; i++) {
+        if (table->index[i] != NULL) {
+            index_place(index, size, table->index[i]);
+        }
+    }
+    free(table->index);
+    table->index = index;
+    table->index_size = size;
+    return 0;
+}
+
+/* Cherche un format interné par son texte (sous le verrou de la table) */
+static text_format_t* index_find(const format_table_t* table, const char* fmt,
+                                 unsigned long hash) {
+    if (table->index_size == 0) {
+        return NULL;
+    }
+    size_t slot = hash & (table->index_size - 1);
+    while (table->index[slot] != NULL) {
+        text_format_t* format = table->index[slot];
+        if (format->hash == hash && strcmp(format->text, fmt) == 0) {
+            return format;
+        }
+        slot = (slot + 1) & (table->index_size - 1);
+    }
+    return NULL;
+}
+
+/* Ajoute un format à la table et à son index (sous le verrou de la table) */
+static int table_push(format_table_t* table, text_format_t* format) {
+    if ((table->count + 1) * 2 > table->index_size && index_grow(table) < 0) {
+        return -1;
+    }
+    if (table->count == table->capacity) {
+        size_t capacity = table->capacity ? table->capacity * 2 : 32;
+        text_format_t** formats = realloc(table->formats, capacity * sizeof(text_format_t*));
+        if (formats == NULL) {
+            return -1;
+        }
+        table->formats = formats;
+        table->capacity = capacity;
+    }
+    table->formats[table->count++] = format;
+    format->id = (unsigned int)table->count;
+    index_place(table->index, table->index_size, format);
+    return 0;
+}
+
+/* Retrouve ou interne un format (premier passage d'un thread sur un format) */
+static text_format_t* format_intern(hdf5_logger_t* logger, const char* fmt) {
+    format_table_t* table = &logger->formats;
+    unsigned long hash = hash_string(fmt);
+
+    logger_mutex_lock(&table->lock);
+    text_format_t* format = index_find(table, fmt, hash);
+    if (format == NULL) {
+        format = format_create(fmt, hash);
+        if (format != NULL && format->kinds == NULL) {
+            /* Un format invalide n'est pas interné */
+            format_free(format);
+            format = NULL;
+        } else if (format != NULL && table_push(table, format) < 0) {
+            format_free(format);
+            format = NULL;
+        }
+    }
+    logger_mutex_unlock(&table->lock);
+
+    return (format != NULL && format->kinds != NULL) ? format : NULL;
+}
+
+/* Retrouve un format par identifiant */
+static text_format_t* format_find(hdf5_logger_t* logger, unsigned int format_id) {
+    format_table_t* table = &logger->formats;
+    text_format_t* format = NULL;
+
+    logger_mutex_lock(&table->lock);
+    if (format_id >= 1 && format_id <= table->count) {
+        format = table->formats[format_id - 1];
+    }
+    logger_mutex_unlock(&table->lock);
+    return format;
+}
+
+/* Type des chaînes de longueur variable du dataset des formats */
+static hid_t create_string_type(void) {
+    hid_t type_id = H5Tcopy(H5T_C_S1);
+    H5Tset_size(type_id, H5T_VARIABLE);
+    H5Tset_cset(type_id, H5T_CSET_UTF8);
+    return type_id;
+}
+
+/* Charge les formats déjà internés dans le fichier */
+static int format_table_load(hdf5_logger_t* logger) {
+    format_table_t* table = &logger->formats;
+    if (H5Lexists(logger->file_id, FORMATS_DATASET, H5P_DEFAULT) <= 0) {
+        return 0;
+    }
+
+    hid_t dataset_id = H5Dopen2(logger->file_id, FORMATS_DATASET, H5P_DEFAULT);
+    if (dataset_id < 0) {
+        return -1;
+    }
+
+    hid_t dataspace_id = H5Dget_space(dataset_id);
+    hsize_t dims[1] = {0};
+    H5Sget_simple_extent_dims(dataspace_id, dims, NULL);
+
+    int result = 0;
+    if (dims[0] > 0) {
+        hid_t type_id = create_string_type();
+        char** texts = (char**)calloc((size_t)dims[0], sizeof(char*));
+        if (texts == NULL ||
+            H5Dread(dataset_id, type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, texts) < 0) {
+            result = -1;
+        }
+
+        /* Les identifiants sont les rangs : les formats invalides gardent leur place */
+        for (hsize_t i = 0; i < dims[0] && result == 0; i++) {
+            const char* text = (texts[i] != NULL) ? texts[i] : "";
+            text_format_t* format = format_create(text, hash_string(text));
+            if (format == NULL || table_push(table, format) < 0) {
+                if (format != NULL) {
+                    format_free(format);
+                }
+                result = -1;
+            }
+        }
+
+        if (texts != NULL) {
+            H5Dvlen_reclaim(type_id, dataspace_id, H5P_DEFAULT, texts);
+            free(texts);
+        }
+        H5Tclose(type_id);
+    }
+
+    table->written = table->count;
+    H5Sclose(dataspace_id);
+    H5Dclose(dataset_id);
+    return result;
+}
+
+int format_table_open(hdf5_logger_t* logger) {
+    format_table_t* table = &logger->formats;
+    memset(table, 0, sizeof(*table));
+    if (logger_mutex_init(&table->lock) < 0) {
+        return -1;
+    }
+
+    /* En cas d'échec, rien ne reste à fermer pour l'appelant */
+    if (format_table_load(logger) < 0) {
+        format_table_close(logger);
+        return -1;
+    }
+    return 0;
+}
+
+void format_table_close(hdf5_logger_t* logger) {
+    format_table_t* table = &logger->formats;
+    for (size_t i = 0; i < table->count; i++) {
+        format_free(table->formats[i]);
+    }
+    free(table->formats);
+    free(table->index);
+    table->formats = NULL;
+    table->index = NULL;
+    table->count = 0;
+    table->capacity = 0;
+    table->index_size = 0;
+    logger_mutex_destroy(&table->lock);
+}
+
+int format_table_sync(hdf5_logger_t* logger) {
+    format_table_t* table = &logger->formats;
+
+    /* Les formats ne sont jamais déplacés : copier les pointeurs à écrire sous le verrou */
+    logger_mutex_lock(&table->lock);
+    size_t first = table->written;
+    size_t n = table->count - first;
+    const char** texts = NULL;
+    if (n > 0) {
+        texts = (const char**)malloc(n * sizeof(char*));
+        for (size_t i = 0; texts != NULL && i < n; i++) {
+            texts[i] = table->formats[first + i]->text;
+        }
+    }
+    logger_mutex_unlock(&table->lock);
+
+    if (n == 0) {
+        return 0;
+    }
+    if (texts == NULL) {
+        return -1;
+    }
+
+    hid_t type_id = create_string_type();
+    hid_t dataset_id;
+    if (H5Lexists(logger->file_id, FORMATS_DATASET, H5P_DEFAULT) > 0) {
+        dataset_id = H5Dopen2(logger->file_id, FORMATS_DATASET, H5P_DEFAULT);
+    } else {
+        hsize_t dims[1] = {0};
+        hsize_t max_dims[1] = {H5S_UNLIMITED};
+        hsize_t chunk_dims[1] = {FORMATS_CHUNK};
+        hid_t space_id = H5Screate_simple(1, dims, max_dims);
+        hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
+        H5Pset_chunk(plist_id, 1, chunk_dims);
+        dataset_id = H5Dcreate2(logger->file_id, FORMATS_DATASET, type_id, space_id,
+                                H5P_DEFAULT, plist_id, H5P_DEFAULT);
+        H5Pclose(plist_id);
+        H5Sclose(space_id);
+    }
+
+    herr_t status = -1;
+    if (dataset_id >= 0) {
+        hsize_t new_dims[1] = {first + n};
+        hsize_t start[1] = {first};
+        hsize_t count[1] = {n};
+        status = H5Dset_extent(dataset_id, new_dims);
+        if (status >= 0) {
+            hid_t file_space = H5Dget_space(dataset_id);
+            hid_t mem_space = H5Screate_simple(1, count, NULL);
+            H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+            status = H5Dwrite(dataset_id, type_id, mem_space, file_space, H5P_DEFAULT, texts);
+            H5Sclose(mem_space);
+            H5Sclose(file_space);
+        }
+        H5Dclose(dataset_id);
+    }
+
+    H5Tclose(type_id);
+    free(texts);
+
+    if (status < 0) {
+        return -1;
+    }
+    table->written = first + n;
+    return 0;
+}
+
+/* Tampon d'encodage : commence dans le tampon de l'appelant, passe sur le tas si nécessaire */
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    char* initial;
+} encode_buffer_t;
+
+static int buffer_grow(encode_buffer_t* buffer, size_t extra) {
+    if (buffer->length + extra <= buffer->capacity) {
+        return 0;
+    }
+
+    size_t capacity = buffer->capacity * 2;
+    while (capacity < buffer->length + extra) {
+        capacity *= 2;
+    }
+
+    char* data = (buffer->data == buffer->initial) ? malloc(capacity) : realloc(buffer->data, capacity);
+    if (data == NULL) {
+        return -1;
+    }
+    if (buffer->data == buffer->initial) {
+        memcpy(data, buffer->data, buffer->length);
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+static int put_varint(encode_buffer_t* buffer, unsigned long long value) {
+    if (buffer_grow(buffer, 10) < 0) {
+        return -1;
+    }
+    unsigned char* out = (unsigned char*)buffer->data + buffer->length;
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (unsigned char)value;
+    buffer->length += n;
+    return 0;
+}
+
+static int put_signed(encode_buffer_t* buffer, long long value) {
+    /* Zigzag : les petites valeurs négatives restent courtes */
+    unsigned long long zigzag = ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63);
+    return put_varint(buffer, zigzag);
+}
+
+static int put_bytes(encode_buffer_t* buffer, const void* bytes, size_t n) {
+    if (buffer_grow(buffer, n) < 0) {
+        return -1;
+    }
+    memcpy(buffer->data + buffer->length, bytes, n);
+    buffer->length += n;
+    return 0;
+}
+
+int format_encode(hdf5_logger_t* logger, const char* fmt, va_list args, unsigned int* format_id,
+                  char** data, size_t capacity, size_t* length) {
+    /* Cache du thread : seule une première rencontre prend le verrou de la table */
+    format_cache_entry_t* cached = &format_cache[((uintptr_t)fmt >> 3) & (FORMAT_CACHE_SIZE - 1)];
+    text_format_t* format;
+    if (cached->logger_id == logger->id && cached->fmt == fmt &&
+        strcmp(cached->format->text, fmt) == 0) {
+        format = cached->format;
+    } else {
+        format = format_intern(logger, fmt);
+        if (format == NULL) {
+            return -1;
+        }
+        cached->logger_id = logger->id;
+        cached->fmt = fmt;
+        cached->format = format;
+    }
+
+    encode_buffer_t buffer = {*data, 0, capacity, *data};
+    int status = 0;
+
+    for (size_t i = 0; i < format->kind_count && status == 0; i++) {
+        switch (format->kinds[i]) {
+            case KIND_INT: status = put_signed(&buffer, va_arg(args, int)); break;
+            case KIND_UINT: status = put_varint(&buffer, va_arg(args, unsigned int)); break;
+            case KIND_LONG: status = put_signed(&buffer, va_arg(args, long)); break;
+            case KIND_ULONG: status = put_varint(&buffer, va_arg(args, unsigned long)); break;
+            case KIND_LLONG: status = put_signed(&buffer, va_arg(args, long long)); break;
+            case KIND_ULLONG: status = put_varint(&buffer, va_arg(args, unsigned long long)); break;
+            case KIND_SIZE: status = put_varint(&buffer, va_arg(args, size_t)); break;
+            case KIND_INTMAX: status = put_signed(&buffer, (long long)va_arg(args, intmax_t)); break;
+            case KIND_UINTMAX:
+                status = put_varint(&buffer, (unsigned long long)va_arg(args, uintmax_t));
+                break;
+            case KIND_PTRDIFF: status = put_signed(&buffer, (long long)va_arg(args, ptrdiff_t)); break;
+            case KIND_DOUBLE: {
+                double value = va_arg(args, double);
+                status = put_bytes(&buffer, &value, sizeof(value));
+                break;
+            }
+            case KIND_LDOUBLE: {
+                double value = (double)va_arg(args, long double);
+                status = put_bytes(&buffer, &value, sizeof(value));
+                break;
+            }
+            case KIND_STRING: {
+                const char* text = va_arg(args, const char*);
+                if (text == NULL) {
+                    text = "(null)";
+                }
+                size_t n = strlen(text);
+                status = put_varint(&buffer, n);
+                if (status == 0) {
+                    status = put_bytes(&buffer, text, n);
+                }
+                break;
+            }
+            case KIND_POINTER:
+                status = put_varint(&buffer, (unsigned long long)(uintptr_t)va_arg(args, void*));
+                break;
+            default:
+                status = -1;
+                break;
+        }
+    }
+
+    if (status < 0) {
+        if (buffer.data != buffer.initial) {
+            free(buffer.data);
+        }
+        return -1;
+    }
+
+    *format_id = format->id;
+    *data = buffer.data;
+    *length = buffer.length;
+    return 0;
+}
+
+/* Lecture des arguments encodés */
+typedef struct {
+    const unsigned char* p;
+    const unsigned char* end;
+} decode_cursor_t;
+
+static int get_varint(decode_cursor_t* cursor, unsigned long long* value) {
+    unsigned long long result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (cursor->p >= cursor->end) {
+            return -1;
+        }
+        unsigned char byte = *cursor->p++;
+        result |= (unsigned long long)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int get_signed(decode_cursor_t* cursor, long long* value) {
+    unsigned long long zigzag;
+    if (get_varint(cursor, &zigzag) < 0) {
+        return -1;
+    }
+    *value = (long long)(zigzag >> 1) ^ -(long long)(zigzag & 1);
+    return 0;
+}
+
+/* Ajoute au message le texte formaté d'une conversion */
+static int render_append(char** buffer, size_t* capacity, size_t* used, const char* spec, ...) {
+    va_list args;
+    for (;;) {
+        va_start(args, spec);
+        int n = vsnprintf(*buffer + *used, *capacity - *used, spec, args);
+        va_end(args);
+        if (n < 0) {
+            return -1;
+        }
+        if ((size_t)n < *capacity - *used) {
+            *used += (size_t)n;
+            return 0;
+        }
+
+        size_t new_capacity = *capacity * 2;
+        while (new_capacity < *used + (size_t)n + 1) {
+            new_capacity *= 2;
+        }
+        char* grown = realloc(*buffer, new_capacity);
+        if (grown == NULL) {
+            return -1;
+        }
+        *buffer = grown;
+        *capacity = new_capacity;
+    }
+}
+
+/* Ajoute des octets bruts au message */
+static int render_literal(char** buffer, size_t* capacity, size_t* used, const char* text, size_t n) {
+    if (*used + n + 1 > *capacity) {
+        size_t new_capacity = *capacity * 2;
+        while (new_capacity < *used + n + 1) {
+            new_capacity *= 2;
+        }
+        char* grown = realloc(*buffer, new_capacity);
+        if (grown == NULL) {
+            return -1;
+        }
+        *buffer = grown;
+        *capacity = new_capacity;
+    }
+    memcpy(*buffer + *used, text, n);
+    *used += n;
+    (*buffer)[*used] = '\0';
+    return 0;
+}
+
+/* Appelle render_append avec zéro, une ou deux largeurs/précisions avant la valeur */
+#define RENDER_VALUE(value)                                                                   \
+    ((spec.stars == 0) ? render_append(buffer, capacity, &used, conversion, value)           \
+     : (spec.stars == 1) ? render_append(buffer, capacity, &used, conversion, (int)star[0], value) \
+     : render_append(buffer, capacity, &used, conversion, (int)star[0], (int)star[1], value))
+
+int format_render(hdf5_logger_t* logger, unsigned int format_id, const char* data, size_t length,
+                  char** buffer, size_t* capacity) {
+    if (*buffer == NULL || *capacity == 0) {
+        *capacity = 256;
+        *buffer = malloc(*capacity);
+        if (*buffer == NULL) {
+            return -1;
+        }
+    }
+    size_t used = 0;
+    (*buffer)[0] = '\0';
+
+    text_format_t* format = format_find(logger, format_id);
+    if (format == NULL || format->kinds == NULL) {
+        return render_append(buffer, capacity, &used, "[format %u inconnu]", format_id);
+    }
+
+    decode_cursor_t cursor = {(const unsigned char*)data, (const unsigned char*)data + length};
+    char* string = NULL;
+    const char* p = format->text;
+    int status = 0;
+
+    while (status == 0) {
+        format_spec_t spec;
+        int invalid;
+        const char* next = next_spec(p, &spec, &invalid);
+        const char* literal_end = (next != NULL) ? spec.start : p + strlen(p);
+
+        /* Texte littéral, avec %% ramené à % */
+        while (p < literal_end && status == 0) {
+            const char* percent = memchr(p, '%', (size_t)(literal_end - p));
+            size_t n = (percent != NULL) ? (size_t)(percent - p) + 1 : (size_t)(literal_end - p);
+            status = render_literal(buffer, capacity, &used, p, n);
+            p += (percent != NULL) ? n + 1 : n;
+        }
+        if (next == NULL || status < 0) {
+            break;
+        }
+
+        char conversion[SPEC_MAX_LENGTH];
+        memcpy(conversion, spec.start, spec.length);
+        conversion[spec.length] = '\0';
+
+        long long star[2] = {0, 0};
+        for (int i = 0; i < spec.stars && status == 0; i++) {
+            status = get_signed(&cursor, &star[i]);
+        }
+
+        long long s = 0;
+        unsigned long long u = 0;
+        double d = 0.0;
+        switch (spec.kind) {
+            case KIND_INT:
+                status = (status == 0) ? get_signed(&cursor, &s) : -1;
+                if (status == 0) status = RENDER_VALUE((int)s);
+                break;
+            case KIND_UINT:
+                status = (status == 0) ? get_varint(&cursor, &u) : -1;
+                if (status == 0) status = RENDER_VALUE((unsigned int)u);
+                break;
+            case KIND_LONG:
+                status = (status == 0) ? get_signed(&cursor, &s) : -1;
+                if (status == 0) status = RENDER_VALUE((long)s);
+                break;
+            case KIND_ULONG:
+                status = (status == 0) ? get_varint(&cursor, &u) : -1;
+                if (status == 0) status = RENDER_VALUE((unsigned long)u);
+                break;
+            case KIND_LLONG:
+                status = (status == 0) ? get_signed(&cursor, &s) : -1;
+                if (status == 0) status = RENDER_VALUE(s);
+                break;
+            case KIND_ULLONG:
+                status = (status == 0) ? get_varint(&cursor, &u) : -1;
+                if (status == 0) status = RENDER_VALUE(u);
+                break;
+            case KIND_SIZE:
+                status = (status == 0) ? get_varint(&cursor, &u) : -1;
+                if (status == 0) status = RENDER_VALUE((size_t)u);
+                break;
+            case KIND_INTMAX:
+                status = (status == 0) ? get_signed(&cursor, &s) : -1;
+                if (status == 0) status = RENDER_VALUE((intmax_t)s);
+                break;
+            case KIND_UINTMAX:
+                status = (status == 0) ? get_varint(&cursor, &u) : -1;
+                if (status == 0) status = RENDER_VALUE((uintmax_t)u);
+                break;
+            case KIND_PTRDIFF:
+                status = (status == 0) ? get_signed(&cursor, &s) : -1;
+                if (status == 0) status = RENDER_VALUE((ptrdiff_t)s);
+                break;
+            case KIND_DOUBLE:
+            case KIND_LDOUBLE:
+                if (status == 0 && cursor.end - cursor.p >= (ptrdiff_t)sizeof(double)) {
+                    memcpy(&d, cursor.p, sizeof(double));
+                    cursor.p += sizeof(double);
+                } else {
+                    status = -1;
+                }
+                if (status == 0 && spec.kind == KIND_LDOUBLE) {
+                    status = RENDER_VALUE((long double)d);
+                } else if (status == 0) {
+                    status = RENDER_VALUE(d);
+                }
+                break;
+            case KIND_STRING:
+                status = (status == 0) ? get_varint(&cursor, &u) : -1;
+                if (status == 0 && u <= (unsigned long long)(cursor.end - cursor.p)) {
+                    char* copy = realloc(string, (size_t)u + 1);
+                    if (copy == NULL) {
+                        status = -1;
+                        break;
+                    }
+                    string = copy;
+                    memcpy(string, cursor.p, (size_t)u);
+                    string[u] = '\0';
+                    cursor.p += u;
+                    status = RENDER_VALUE(string);
+                } else {
+                    status = -1;
+                }
+                break;
+            case KIND_POINTER:
+                status = (status == 0) ? get_varint(&cursor, &u) : -1;
+                if (status == 0) status = RENDER_VALUE((void*)(uintptr_t)u);
+                break;
+            default:
+                status = -1;
+                break;
+        }
+
+        p = next;
+    }
+
+    free(string);
+    return status;
+}
@@ -8,21 +8,22 @@
 #include <string.h>
 #include <time.h>
 #include "hdf5.h"
-#include "../include/hdf5_logger.h"
+#include "hdf5_logger_internal.h"
 
-/* Fonction interne pour créer un groupe s'il n'existe pas */
-extern hid_t create_group_if_not_exists(hid_t file_id, const char* group_path);
-
-int hdf5_log_image(hdf5_logger_t* logger, const char* group_path, const char* image_name,
-                  const unsigned char* pixel_data, size_t width, size_t height, size_t channels) {
-    if (logger == NULL || !logger->is_open || group_path == NULL || image_name == NULL ||
-        pixel_data == NULL || width == 0 || height == 0 || channels == 0 || channels > 4) {
-        return -1;
-    }
-    
+/* Implémentation interne pour les images ; planar indique des pixels déjà séparés en plans,
+ * écrits [canaux, hauteur, largeur] */
+int image_store(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                const void* pixel_data, size_t width, size_t height, size_t channels,
+                hdf5_dtype_t dtype, const source_view_t* view, int planar, size_t chunk_side) {
     herr_t status;
     hid_t group_id, dataset_id, dataspace_id;
     
+    /* Type d'un canal, écrit sans conversion */
+    hid_t datatype_id = dtype_type(logger, dtype);
+    if (datatype_id < 0) {
+        return -1;
+    }
+    
     /* Créer le groupe s'il n'existe pas */
     group_id = create_group_if_not_exists(logger->file_id, group_path);
     if (group_id < 0) {
@@ -38,6 +39,12 @@ int hdf5_log_image(hdf5_logger_t* logger, const char* group_path, const char* im
         dims[0] = height;
         dims[1] = width;
         rank = 2;
+    } else if (planar) {
+        /* Image couleur en plans (3D) */
+        dims[0] = channels;
+        dims[1] = height;
+        dims[2] = width;
+        rank = 3;
     } else {
         /* Image couleur (3D) */
         dims[0] = height;
@@ -60,26 +67,50 @@ int hdf5_log_image(hdf5_logger_t* logger, const char* group_path, const char* im
     hsize_t chunk_dims[3];
     
     if (rank == 2) {
-        chunk_dims[0] = (height > 128) ? 128 : height;
-        chunk_dims[1] = (width > 128) ? 128 : width;
+        chunk_dims[0] = (height > chunk_side) ? chunk_side : height;
+        chunk_dims[1] = (width > chunk_side) ? chunk_side : width;
+    } else if (planar) {
+        chunk_dims[0] = channels;
+        chunk_dims[1] = (height > chunk_side) ? chunk_side : height;
+        chunk_dims[2] = (width > chunk_side) ? chunk_side : width;
     } else {
-        chunk_dims[0] = (height > 128) ? 128 : height;
-        chunk_dims[1] = (width > 128) ? 128 : width;
+        chunk_dims[0] = (height > chunk_side) ? chunk_side : height;
+        chunk_dims[1] = (width > chunk_side) ? chunk_side : width;
         chunk_dims[2] = channels;
     }
     
     status = H5Pset_chunk(plist_id, rank, chunk_dims);
     
-    /* Activer la compression GZIP niveau 7 (plus agressive pour les images) */
-    status = H5Pset_deflate(plist_id, 7);
+    /* Compression choisie pour les images de ce groupe ; les canaux entrelacés forment le pixel */
+    const hdf5_codec_policy_t* codec = codec_resolve(logger, group_path, HDF5_DATA_IMAGE);
+    status = codec_apply(plist_id, codec, dtype_size(dtype), (rank == 3 && !planar) ? 1 : 0);
+    
+    /* Vérifier si le dataset existe déjà (une séquence ouverte est d'abord fermée) */
+    stream_close(logger, group_path, image_name);
+    tile_forget(logger, group_path, image_name);
+    
+    /* Image déjà écrite : lien dur vers son dataset, sans rien compresser ni écrire */
+    uint64_t hash[2];
+    int hashed = logger->dedup.enabled &&
+                 dedup_hash(logger, HDF5_DATA_IMAGE, pixel_data, view, rank, dims, dtype, NULL,
+                            hash) == 0;
+    if (hashed) {
+        int linked = dedup_link(logger, group_id, group_path, image_name, hash,
+                                (size_t)(width * height * channels) * dtype_size(dtype));
+        if (linked != 0) {
+            H5Pclose(plist_id);
+            H5Sclose(dataspace_id);
+            H5Gclose(group_id);
+            return (linked < 0) ? -1 : 0;
+        }
+    }
     
-    /* Vérifier si le dataset existe déjà */
     if (H5Lexists(group_id, image_name, H5P_DEFAULT) > 0) {
         H5Ldelete(group_id, image_name, H5P_DEFAULT);  /* Supprimer l'ancien dataset */
     }
     
     /* Créer le dataset */
-    dataset_id = H5Dcreate2(group_id, image_name, H5T_NATIVE_UCHAR, dataspace_id,
+    dataset_id = H5Dcreate2(group_id, image_name, datatype_id, dataspace_id,
                           H5P_DEFAULT, plist_id, H5P_DEFAULT);
     if (dataset_id < 0) {
         H5Pclose(plist_id);
@@ -88,8 +119,12 @@ int hdf5_log_image(hdf5_logger_t* logger, const char* group_path, const char* im
         return -1;
     }
     
-    /* Écrire les données de l'image */
-    status = H5Dwrite(dataset_id, H5T_NATIVE_UCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, pixel_data);
+    /* Écrire les données de l'image, chunks compressés en parallèle si possible */
+    status = chunks_write(logger, dataset_id, datatype_id, rank, NULL, dims, chunk_dims, codec,
+                          pixel_data, view);
+    if (hashed && status >= 0) {
+        dedup_record(logger, dataset_id, group_path, image_name, hash);
+    }
     
     /* Ajouter des attributs pour les métadonnées de l'image */
     hid_t attr_space = H5Screate(H5S_SCALAR);
@@ -122,6 +157,16 @@ int hdf5_log_image(hdf5_logger_t* logger, const char* group_path, const char* im
     H5Awrite(timestamp_attr, H5T_NATIVE_DOUBLE, &timestamp);
     H5Aclose(timestamp_attr);
     
+    /* Layout : noté pour les seules images en plans */
+    if (planar && rank == 3) {
+        hid_t layout_type = H5Tcopy(H5T_C_S1);
+        H5Tset_size(layout_type, sizeof("planar"));
+        if (write_scalar_attribute(dataset_id, "layout", layout_type, "planar") < 0) {
+            status = -1;
+        }
+        H5Tclose(layout_type);
+    }
+    
     /* Nettoyage */
     H5Sclose(attr_space);
     H5Dclose(dataset_id);
@@ -130,4 +175,310 @@ int hdf5_log_image(hdf5_logger_t* logger, const char* group_path, const char* im
     H5Gclose(group_id);
     
     return (status < 0) ? -1 : 0;
-}
\ No newline at end of file
+}
+
+int image_write(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                const void* pixel_data, size_t width, size_t height, size_t channels,
+                hdf5_dtype_t dtype, const source_view_t* view) {
+    if (channels == 1 || image_layout_resolve(logger, group_path) != HDF5_IMAGE_PLANAR) {
+        if (image_store(logger, group_path, image_name, pixel_data, width, height, channels,
+                        dtype, view, 0, IMAGE_CHUNK_SIDE) < 0) {
+            return -1;
+        }
+        return image_pyramid_write(logger, group_path, image_name, pixel_data, width, height,
+                                   channels, dtype, view, 0);
+    }
+    
+    /* Groupe stocké en plans : les canaux sont séparés avant l'écriture */
+    size_t element_size = dtype_size(dtype);
+    size_t area = width * height;
+    size_t bytes = area * channels * element_size;
+    unsigned char* planes = (unsigned char*)arena_alloc(logger->arena, bytes);
+    void* gathered = (view != NULL) ? arena_alloc(logger->arena, bytes) : NULL;
+    if (planes == NULL || (view != NULL && gathered == NULL)) {
+        arena_free(logger->arena, planes);
+        arena_free(logger->arena, gathered);
+        return -1;
+    }
+    
+    const void* source = pixel_data;
+    if (view != NULL) {
+        view_gather(view, pixel_data, element_size, 0, area * channels, gathered);
+        source = gathered;
+    }
+    void* plane[4];
+    for (size_t k = 0; k < channels; k++) {
+        plane[k] = planes + k * area * element_size;
+    }
+    pixels_deinterleave(source, plane, area, channels, element_size);
+    arena_free(logger->arena, gathered);
+    
+    int status = image_store(logger, group_path, image_name, planes, width, height, channels,
+                             dtype, NULL, 1, IMAGE_CHUNK_SIDE);
+    if (status == 0) {
+        status = image_pyramid_write(logger, group_path, image_name, planes, width, height,
+                                     channels, dtype, NULL, 1);
+    }
+    arena_free(logger->arena, planes);
+    return status;
+}
+
+int image_write_format(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                       const void* frame, size_t width, size_t height,
+                       hdf5_pixel_format_t format, size_t row_pitch) {
+    size_t channels = pixel_format_channels(format);
+    size_t area = width * height;
+    unsigned char* planes = (unsigned char*)arena_alloc(logger->arena, area * channels);
+    if (planes == NULL) {
+        return -1;
+    }
+    
+    /* Les conversions produisent des plans, écrits tels quels ou entrelacés */
+    int status = pixels_convert(frame, width, height, row_pitch, format, planes);
+    if (status > 0 && image_layout_resolve(logger, group_path) == HDF5_IMAGE_PLANAR) {
+        status = image_store(logger, group_path, image_name, planes, width, height, channels,
+                             HDF5_DTYPE_UINT8, NULL, 1, IMAGE_CHUNK_SIDE);
+        if (status == 0) {
+            status = image_pyramid_write(logger, group_path, image_name, planes, width, height,
+                                         channels, HDF5_DTYPE_UINT8, NULL, 1);
+        }
+    } else if (status > 0) {
+        unsigned char* pixels = (unsigned char*)arena_alloc(logger->arena, area * channels);
+        if (pixels == NULL) {
+            status = -1;
+        } else {
+            const void* plane[4];
+            for (size_t k = 0; k < channels; k++) {
+                plane[k] = planes + k * area;
+            }
+            pixels_interleave(plane, pixels, area, channels, 1);
+            status = image_store(logger, group_path, image_name, pixels, width, height,
+                                 channels, HDF5_DTYPE_UINT8, NULL, 0, IMAGE_CHUNK_SIDE);
+            if (status == 0) {
+                status = image_pyramid_write(logger, group_path, image_name, pixels, width,
+                                             height, channels, HDF5_DTYPE_UINT8, NULL, 0);
+            }
+            arena_free(logger->arena, pixels);
+        }
+    }
+    arena_free(logger->arena, planes);
+    return (status < 0) ? -1 : 0;
+}
+
+/* Écrit l'image sous le verrou du logger, ou la dépose dans la file en mode asynchrone ;
+ * avec done, les pixels sont empruntés et rendus par done une fois écrits ; un row_pitch
+ * non nul donne l'écart en octets entre deux lignes */
+static int log_image(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                     const void* pixel_data, size_t width, size_t height, size_t channels,
+                     hdf5_dtype_t dtype, size_t row_pitch, hdf5_write_callback_t done,
+                     void* user_data) {
+    if (logger == NULL || !logger->is_open || group_path == NULL || image_name == NULL ||
+        pixel_data == NULL || width == 0 || height == 0 || channels == 0 || channels > 4 ||
+        dtype_size(dtype) == 0) {
+        return -1;
+    }
+    
+    /* Lignes espacées : lues en place au travers d'une sélection */
+    source_view_t view;
+    int dense = 1;
+    if (row_pitch != 0) {
+        dense = view_from_pitch(&view, width, height, channels, dtype_size(dtype), row_pitch);
+        if (dense < 0) {
+            return -1;
+        }
+    }
+    
+    /* En mode asynchrone, la compression est faite par le thread d'écriture */
+    if (logger->async != NULL) {
+        return async_submit_image(logger, group_path, image_name, pixel_data, width, height,
+                                  channels, dtype, dense ? NULL : &view, done, user_data);
+    }
+    
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+    
+    int status = image_write(logger, group_path, image_name, pixel_data, width, height, channels,
+                             dtype, dense ? NULL : &view);
+    
+    logger_unlock(logger);
+    
+    if (done != NULL) {
+        done(user_data, status);
+        return 0;
+    }
+    return status;
+}
+
+/* Ajoute l'image à sa séquence, comme log_image */
+static int log_image_frame(hdf5_logger_t* logger, const char* group_path, const char* stream_name,
+                           const void* pixel_data, size_t width, size_t height, size_t channels,
+                           hdf5_dtype_t dtype, size_t row_pitch, hdf5_write_callback_t done,
+                           void* user_data) {
+    if (logger == NULL || !logger->is_open || group_path == NULL || stream_name == NULL ||
+        pixel_data == NULL || width == 0 || height == 0 || channels == 0 || channels > 4 ||
+        dtype_size(dtype) == 0) {
+        return -1;
+    }
+    
+    source_view_t view;
+    int dense = 1;
+    if (row_pitch != 0) {
+        dense = view_from_pitch(&view, width, height, channels, dtype_size(dtype), row_pitch);
+        if (dense < 0) {
+            return -1;
+        }
+    }
+    
+    /* En mode asynchrone, l'image est horodatée et numérotée au dépôt */
+    if (logger->async != NULL) {
+        return async_submit_image_frame(logger, group_path, stream_name, pixel_data, width,
+                                        height, channels, dtype, dense ? NULL : &view, done,
+                                        user_data);
+    }
+    
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+    int status = stream_append_image(logger, group_path, stream_name, pixel_data, width, height,
+                                     channels, dtype, dense ? NULL : &view, get_current_time(),
+                                     logger_next_sequence(logger, 1));
+    logger_unlock(logger);
+    
+    if (done != NULL) {
+        done(user_data, status);
+        return 0;
+    }
+    return status;
+}
+
+/* Implémentation des fonctions publiques */
+
+int hdf5_log_image(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                  const unsigned char* pixel_data, size_t width, size_t height, size_t channels) {
+    return log_image(logger, group_path, image_name, pixel_data, width, height, channels,
+                     HDF5_DTYPE_UINT8, 0, NULL, NULL);
+}
+
+int hdf5_log_image_typed(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                         const void* pixel_data, size_t width, size_t height, size_t channels,
+                         hdf5_dtype_t dtype) {
+    return log_image(logger, group_path, image_name, pixel_data, width, height, channels, dtype,
+                     0, NULL, NULL);
+}
+
+int hdf5_log_image_pitched(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                           const void* pixel_data, size_t width, size_t height, size_t channels,
+                           hdf5_dtype_t dtype, size_t row_pitch) {
+    if (row_pitch == 0) {
+        return -1;
+    }
+    return log_image(logger, group_path, image_name, pixel_data, width, height, channels, dtype,
+                     row_pitch, NULL, NULL);
+}
+
+int hdf5_log_image_format(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                          const void* frame, size_t width, size_t height,
+                          hdf5_pixel_format_t format, size_t row_pitch) {
+    if (logger == NULL || !logger->is_open || group_path == NULL || image_name == NULL ||
+        frame == NULL) {
+        return -1;
+    }
+    size_t frame_bytes = pixel_frame_bytes(format, width, height, row_pitch);
+    if (frame_bytes == 0) {
+        return -1;
+    }
+    
+    /* En mode asynchrone, la conversion est faite par le thread d'écriture */
+    if (logger->async != NULL) {
+        return async_submit_image_format(logger, group_path, image_name, frame, width, height,
+                                         format, row_pitch, frame_bytes);
+    }
+    
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+    int status = image_write_format(logger, group_path, image_name, frame, width, height,
+                                    format, row_pitch);
+    logger_unlock(logger);
+    return status;
+}
+
+int hdf5_log_image_update(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                          const void* pixel_data, size_t width, size_t height, size_t channels,
+                          hdf5_dtype_t dtype, const hdf5_image_rect_t* rects,
+                          size_t rect_count) {
+    if (logger == NULL || !logger->is_open || group_path == NULL || image_name == NULL ||
+        pixel_data == NULL || width == 0 || height == 0 || channels == 0 || channels > 4 ||
+        dtype_size(dtype) == 0 || (rects == NULL && rect_count != 0)) {
+        return -1;
+    }
+    
+    /* Les régions sont vérifiées avant la file d'attente pour que l'erreur revienne à l'appelant */
+    for (size_t i = 0; i < rect_count; i++) {
+        if (rects[i].x > width || rects[i].width > width - rects[i].x ||
+            rects[i].y > height || rects[i].height > height - rects[i].y) {
+            return -1;
+        }
+    }
+    
+    /* En mode asynchrone, la comparaison et l'écriture sont faites par le thread d'écriture */
+    if (logger->async != NULL) {
+        return async_submit_image_update(logger, group_path, image_name, pixel_data, width,
+                                         height, channels, dtype, rects, rect_count);
+    }
+    
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+    int status = image_update(logger, group_path, image_name, pixel_data, width, height,
+                              channels, dtype, rects, rect_count);
+    logger_unlock(logger);
+    return status;
+}
+
+int hdf5_log_image_submit(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                          const void* pixel_data, size_t width, size_t height, size_t channels,
+                          hdf5_dtype_t dtype, hdf5_write_callback_t done, void* user_data) {
+    if (done == NULL) {
+        return -1;
+    }
+    return log_image(logger, group_path, image_name, pixel_data, width, height, channels, dtype,
+                     0, done, user_data);
+}
+
+int hdf5_log_image_frame(hdf5_logger_t* logger, const char* group_path, const char* stream_name,
+                         const unsigned char* pixel_data, size_t width, size_t height,
+                         size_t channels) {
+    return log_image_frame(logger, group_path, stream_name, pixel_data, width, height, channels,
+                           HDF5_DTYPE_UINT8, 0, NULL, NULL);
+}
+
+int hdf5_log_image_frame_typed(hdf5_logger_t* logger, const char* group_path,
+                               const char* stream_name, const void* pixel_data, size_t width,
+                               size_t height, size_t channels, hdf5_dtype_t dtype) {
+    return log_image_frame(logger, group_path, stream_name, pixel_data, width, height, channels,
+                           dtype, 0, NULL, NULL);
+}
+
+int hdf5_log_image_frame_pitched(hdf5_logger_t* logger, const char* group_path,
+                                 const char* stream_name, const void* pixel_data, size_t width,
+                                 size_t height, size_t channels, hdf5_dtype_t dtype,
+                                 size_t row_pitch) {
+    if (row_pitch == 0) {
+        return -1;
+    }
+    return log_image_frame(logger, group_path, stream_name, pixel_data, width, height, channels,
+                           dtype, row_pitch, NULL, NULL);
+}
+
+int hdf5_log_image_frame_submit(hdf5_logger_t* logger, const char* group_path,
+                                const char* stream_name, const void* pixel_data, size_t width,
+                                size_t height, size_t channels, hdf5_dtype_t dtype,
+                                hdf5_write_callback_t done, void* user_data) {
+    if (done == NULL) {
+        return -1;
+    }
+    return log_image_frame(logger, group_path, stream_name, pixel_data, width, height, channels,
+                           dtype, 0, done, user_data);
+}
@@ -0,0 +1,1591 @@
+/**
+ * @file hdf5_logger_internal.h
+ * @brief Structures et fonctions internes partagées entre les modules de HDF5 Logger
+ */
+
+#ifndef HDF5_LOGGER_INTERNAL_H
+#define HDF5_LOGGER_INTERNAL_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+#include "hdf5_logger_platform.h"
+
+/* Disposition des logs texte d'un groupe (attribut text_layout_version) */
+#define TEXT_LAYOUT_LEGACY 1   /* Dataset log_entries à message de taille fixe */
+#define TEXT_LAYOUT_COMPACT 2  /* Table records et tas d'octets message_heap */
+
+/* Noms des datasets de logs texte dans chaque groupe */
+#define TEXT_LEGACY_DATASET "log_entries"
+#define TEXT_RECORDS_DATASET "records"
+#define TEXT_HEAP_DATASET "message_heap"
+
+/* Structure pour les entrées de log texte de l'ancienne disposition (lecture seule) */
+typedef struct {
+    int log_level;       /* Niveau de log */
+    double timestamp;    /* Horodatage */
+    char message[1024];  /* Message (taille fixe pour simplifier) */
+} text_log_entry_t;
+
+/* Enregistrement de taille fixe de la disposition compacte */
+typedef struct {
+    int log_level;             /* Niveau de log */
+    unsigned int length;       /* Longueur du message dans le tas */
+    double timestamp;          /* Horodatage */
+    unsigned long long offset; /* Position du message dans le tas */
+    unsigned long long sequence; /* Numéro de séquence global (0 = inconnu) */
+    unsigned int format_id;    /* Format interné (0 = message déjà formaté) */
+} text_record_t;
+
+/* Fonction appelée pour chaque enregistrement parcouru ; message pointe sur ses length octets */
+typedef int (*text_visit_t)(const text_record_t* record, const char* message, void* user_data);
+
+/* Stockage compact d'un groupe : table d'enregistrements et tas de messages */
+typedef struct {
+    hid_t records_id;     /* Dataset records */
+    hid_t heap_id;        /* Dataset message_heap */
+    hsize_t extent;       /* Étendue allouée de records (multiple du chunk) */
+    hsize_t count;        /* Nombre logique d'enregistrements */
+    hsize_t heap_extent;  /* Étendue allouée du tas */
+    hsize_t heap_size;    /* Nombre logique d'octets du tas (position logique de fin) */
+    hsize_t ring_capacity; /* Capacité de l'anneau (0 = mode linéaire) */
+    hsize_t ring_head;    /* Prochaine case écrite dans l'anneau */
+    hsize_t heap_tail;    /* Position logique du plus ancien message vivant (anneau) */
+    double first_timestamp; /* Horodatage de l'enregistrement le plus ancien */
+    int appended;         /* Des entrées ont été ajoutées depuis l'ouverture */
+} text_store_t;
+
+/* Segment temporel d'un groupe limité en temps (sous-groupe segment_<n>) */
+typedef struct {
+    unsigned long index;  /* Numéro du sous-groupe */
+    double start_time;    /* Début de la tranche couverte par le segment */
+    double min_time;      /* Horodatage de la plus ancienne entrée valide */
+    double max_time;      /* Horodatage de la plus récente entrée */
+    hsize_t valid_from;   /* Indice de la première entrée non expirée */
+} text_segment_t;
+
+/* Entrée en attente dans le tampon d'un canal */
+typedef struct {
+    int log_level;       /* Niveau de log */
+    double timestamp;    /* Horodatage */
+    unsigned long long sequence; /* Numéro de séquence global */
+    unsigned int format_id; /* Format interné (0 = message déjà formaté) */
+    size_t offset;       /* Position du message dans le tampon d'octets */
+    size_t length;       /* Longueur du message (sans le zéro final) */
+} staged_entry_t;
+
+/* Canal de log texte : garde ouverts le groupe et le dataset d'un chemin */
+struct hdf5_log_channel_s {
+    hdf5_logger_t* logger;        /* Logger propriétaire */
+    char* group_path;             /* Chemin du groupe */
+    unsigned long hash;           /* Hachage du chemin */
+    hid_t group_id;               /* Groupe ouvert */
+    text_store_t store;           /* Datasets records et message_heap (segment courant) */
+    hsize_t max_entries;          /* Limite de taille (0 = aucune) */
+    double max_time_seconds;      /* Limite de temps (0 = aucune) */
+    double last_retention;        /* Heure de la dernière purge par durée */
+    double last_timestamp;        /* Plus récent horodatage écrit : les suivants n'y sont jamais inférieurs */
+
+    /* Segments temporels (groupes limités en temps seulement) */
+    int segmented;                /* Le groupe est découpé en segments */
+    double segment_seconds;       /* Durée couverte par un segment */
+    text_segment_t* segments;     /* Segments vivants, du plus ancien au plus récent */
+    size_t segment_count;         /* Nombre de segments vivants */
+    size_t segment_capacity;      /* Capacité du tableau segments */
+    unsigned long segment_next;   /* Numéro du prochain segment créé */
+    hid_t segment_group_id;       /* Sous-groupe du segment courant (négatif si aucun) */
+
+    /* Tampon des entrées en attente d'écriture */
+    staged_entry_t* staged;       /* Entrées en attente */
+    size_t staged_count;          /* Nombre d'entrées en attente */
+    size_t staged_capacity;       /* Capacité du tableau staged */
+    char* staged_bytes;           /* Messages en attente, bout à bout */
+    size_t staged_bytes_used;     /* Octets utilisés dans staged_bytes */
+    size_t staged_bytes_capacity; /* Capacité de staged_bytes */
+    text_record_t* scratch;       /* Enregistrements construits au vidage */
+    size_t scratch_capacity;      /* Capacité de scratch (en entrées) */
+
+    struct hdf5_log_channel_s* next; /* Chaînage dans la table de hachage */
+};
+
+/* Table de hachage chemin -> canal */
+typedef struct {
+    hdf5_log_channel_t** buckets; /* Tableau des listes chaînées */
+    size_t bucket_count;          /* Nombre de cases */
+    size_t count;                 /* Nombre de canaux */
+} channel_table_t;
+
+/* Format interné : jamais déplacé ni libéré avant la fermeture du logger */
+typedef struct {
+    unsigned int id;          /* Identifiant (rang dans le dataset text_formats + 1) */
+    unsigned long hash;       /* Hachage de la chaîne */
+    char* text;               /* Chaîne de format */
+    unsigned char* kinds;     /* Types des arguments, dans l'ordre (NULL si format invalide) */
+    size_t kind_count;        /* Nombre d'arguments */
+} text_format_t;
+
+/* Table des formats internés du fichier (dataset /text_formats) */
+typedef struct {
+    logger_mutex_t lock;      /* Pris à la première rencontre d'un format par un thread */
+    text_format_t** formats;  /* Formats, par identifiant - 1 */
+    size_t count;             /* Nombre de formats */
+    size_t capacity;          /* Capacité de formats */
+    text_format_t** index;    /* Formats par hachage (adressage ouvert, NULL = case libre) */
+    size_t index_size;        /* Cases de index (puissance de deux, au plus à moitié pleine) */
+    size_t written;           /* Formats déjà écrits dans le fichier (sous io_lock) */
+} format_table_t;
+
+/* Seuil propre à un groupe : jamais retiré ni déplacé avant la fermeture du logger */
+typedef struct group_level_s {
+    char* group_path;             /* Chemin du groupe */
+    volatile int level;           /* Niveau minimal du groupe */
+    struct group_level_s* next;   /* Seuil suivant (publié après initialisation) */
+} group_level_t;
+
+/* Niveaux minimaux des logs texte, lus sans verrou par les appelants */
+typedef struct {
+    volatile int floor;           /* Plus petit seuil en vigueur : rejet sans recherche */
+    volatile int ceiling;         /* Plus grand seuil en vigueur : acceptation sans recherche */
+    volatile int min_level;       /* Seuil du logger */
+    group_level_t* volatile groups; /* Seuils des groupes */
+    logger_mutex_t lock;          /* Sérialise les changements de seuil */
+} level_table_t;
+
+/* Politique de compression propre à un groupe */
+typedef struct codec_override_s {
+    char* group_path;             /* Chemin du groupe */
+    hdf5_data_kind_t kind;        /* Nature des données concernées */
+    hdf5_codec_policy_t policy;   /* Politique */
+    struct codec_override_s* next;
+} codec_override_t;
+
+/* Quantification propre à un groupe ou à un dataset */
+typedef struct quantize_override_s {
+    char* group_path;             /* Chemin du groupe */
+    char* dataset_name;           /* Nom du dataset (NULL = tout le groupe) */
+    hdf5_quantize_t quantize;     /* Précision */
+    struct quantize_override_s* next;
+} quantize_override_t;
+
+/* Disposition des images propre à un groupe */
+typedef struct image_layout_override_s {
+    char* group_path;             /* Chemin du groupe */
+    hdf5_image_layout_t layout;   /* Disposition des canaux */
+    struct image_layout_override_s* next;
+} image_layout_override_t;
+
+/* Vignettes des images propres à un groupe */
+typedef struct image_pyramid_override_s {
+    char* group_path;             /* Chemin du groupe */
+    size_t min_size;              /* Côté maximal du dernier niveau */
+    struct image_pyramid_override_s* next;
+} image_pyramid_override_t;
+
+/* Empreinte connue : dataset écrit avec ce contenu */
+typedef struct dedup_entry_s {
+    uint64_t hash[2];             /* Empreinte sur 128 bits */
+    char* path;                   /* Chemin absolu du dataset */
+    struct dedup_entry_s* next;   /* Chaînage dans la table de hachage */
+} dedup_entry_t;
+
+/* Index des contenus déjà écrits (sous io_lock) */
+typedef struct {
+    int enabled;                  /* Déduplication active */
+    dedup_entry_t** buckets;      /* Tableau des listes chaînées */
+    size_t bucket_count;          /* Nombre de cases (puissance de deux) */
+    size_t count;                 /* Nombre d'empreintes */
+    unsigned long long checked;   /* Tableaux et images hachés */
+    unsigned long long duplicates; /* Écritures remplacées par un lien */
+    unsigned long long bytes_saved; /* Octets bruts non réécrits */
+} dedup_table_t;
+
+/* Géométrie des lignes d'un chunk pour la prédiction PNG (paramètres du filtre) */
+typedef struct {
+    hdf5_predictor_t predictor;   /* HDF5_PREDICT_PNG ou HDF5_PREDICT_PNG_FRAME */
+    size_t element_size;          /* Taille d'un élément (1 ou 2) */
+    size_t pixel_elements;        /* Éléments d'un pixel : écart du prédicteur Sub */
+    size_t row_elements;          /* Éléments d'une ligne */
+    size_t frame_rows;            /* Lignes d'une image : écart de la prédiction par image */
+} predict_rows_t;
+
+/* Tampon source non contigu : hyperslab sur un dataspace mémoire couvrant tout le tampon, dont
+ * les éléments sélectionnés, dans l'ordre C, forment le bloc écrit (rang propre au tampon) */
+typedef struct {
+    int rank;                               /* Rang du tampon */
+    hsize_t extent[HDF5_LOGGER_MAX_RANK];   /* Dimensions du tampon complet */
+    hsize_t offset[HDF5_LOGGER_MAX_RANK];   /* Premier élément sélectionné */
+    hsize_t stride[HDF5_LOGGER_MAX_RANK];   /* Pas entre deux éléments sélectionnés */
+    hsize_t count[HDF5_LOGGER_MAX_RANK];    /* Éléments sélectionnés par dimension */
+} source_view_t;
+
+/* Dernière image écrite d'un dataset mis à jour par tuiles */
+typedef struct image_shadow_s {
+    char* group_path;             /* Chemin du groupe */
+    char* name;                   /* Nom du dataset */
+    size_t width;                 /* Largeur */
+    size_t height;                /* Hauteur */
+    size_t channels;              /* Nombre de canaux */
+    hdf5_dtype_t dtype;           /* Type d'un canal */
+    unsigned char* pixels;        /* Image telle qu'elle est dans le fichier */
+    struct image_shadow_s* next;  /* Image suivante du logger */
+} image_shadow_t;
+
+/* Série de trames (tableaux ou images) : datasets gardés ouverts et trames en attente */
+typedef struct frame_stream_s {
+    hdf5_logger_t* logger;        /* Logger propriétaire */
+    hdf5_data_kind_t kind;        /* HDF5_DATA_NUMERIC (tableaux) ou HDF5_DATA_IMAGE */
+    char* group_path;             /* Chemin du groupe */
+    char* name;                   /* Nom du dataset des trames */
+    hid_t dataset_id;             /* Trames, premier axe illimité */
+    hid_t index_id;               /* Index : une entrée (horodatage...) par trame */
+    hid_t index_type_id;          /* Type d'une entrée d'index */
+    hdf5_dtype_t dtype;           /* Type des éléments */
+    hid_t type_id;                /* Type natif des éléments */
+    int rank;                     /* Rang d'une trame */
+    hsize_t dims[HDF5_LOGGER_MAX_RANK]; /* Dimensions d'une trame */
+    size_t frame_bytes;           /* Taille d'une trame en octets */
+    hsize_t chunk_dims[HDF5_LOGGER_MAX_RANK]; /* Chunk du dataset des trames (trames d'abord) */
+    hdf5_codec_policy_t codec;    /* Compression du dataset des trames */
+    hdf5_quantize_t quantize;     /* Quantification des trames (fixée à la création) */
+    hsize_t written;              /* Trames écrites dans le fichier */
+    unsigned char* staged;        /* Trames en attente, bout à bout (un chunk au plus) */
+    unsigned char* staged_index;  /* Entrées d'index des trames en attente */
+    size_t staged_count;          /* Nombre de trames en attente */
+    struct frame_stream_s* next;  /* Série suivante du logger */
+} frame_stream_t;
+
+/* État du mode asynchrone (défini dans hdf5_logger_async.c) */
+typedef struct async_writer_s async_writer_t;
+
+/* Tampon d'un thread producteur (défini dans hdf5_logger_stage.c) */
+typedef struct thread_stage_s thread_stage_t;
+
+/* Groupe de threads de compression (défini dans hdf5_logger_pool.c) */
+typedef struct compress_pool_s compress_pool_t;
+
+/* Allocateur des tampons de travail (défini dans hdf5_logger_arena.c) */
+typedef struct memory_arena_s memory_arena_t;
+
+/* Tâche d'un lot du groupe de threads, appelée pour chaque indice du lot */
+typedef void (*pool_task_t)(void* arg, size_t index);
+
+/* Définition de la structure interne du logger */
+struct hdf5_logger_s {
+    hid_t file_id;            /* ID du fichier HDF5 */
+    char* filename;           /* Nom du fichier */
+    int is_open;              /* Indicateur si le fichier est ouvert */
+    hid_t record_type_id;     /* Type composé des enregistrements texte */
+    channel_table_t channels; /* Canaux texte ouverts */
+    format_table_t formats;   /* Formats des logs texte à formatage différé */
+    level_table_t levels;     /* Niveaux minimaux des logs texte */
+
+    /* Politique de regroupement des écritures texte */
+    size_t batch_max_entries; /* Vidage après N entrées par canal */
+    size_t batch_max_bytes;   /* Vidage après N octets de messages par canal */
+    double batch_max_delay;   /* Vidage quand l'entrée la plus ancienne dépasse ce délai (s) */
+    double pending_since;     /* Arrivée de la plus ancienne entrée en attente (0 = aucune) */
+    double retention_interval; /* Délai minimal entre deux purges par durée d'un canal (s) */
+    hdf5_array_layout_t array_layout; /* Disposition des tableaux écrits sans indication */
+    hdf5_codec_policy_t codecs[HDF5_DATA_KIND_COUNT]; /* Compression par nature de données */
+    codec_override_t* codec_overrides; /* Compression propre à des groupes (sous io_lock) */
+    quantize_override_t* quantize_overrides; /* Quantification des flottants (sous io_lock) */
+    image_layout_override_t* image_layouts; /* Images stockées en plans (sous io_lock) */
+    image_pyramid_override_t* image_pyramids; /* Groupes dont les images ont des vignettes */
+    dedup_table_t dedup;      /* Contenus déjà écrits, pour la déduplication (sous io_lock) */
+    compress_pool_t* compress_pool; /* Threads de compression des chunks (NULL = pipeline HDF5) */
+    frame_stream_t* streams;  /* Séries de trames ouvertes (sous io_lock) */
+    image_shadow_t* shadows;  /* Images mises à jour par tuiles (sous io_lock) */
+    async_writer_t* async;    /* File et thread d'écriture (NULL en mode synchrone) */
+    memory_arena_t* arena;    /* Tampons de travail réutilisés */
+    hid_t half_type_id;       /* Type demi-précision (-1 = pas encore créé, sous io_lock) */
+
+    /* Appels concurrents */
+    unsigned long id;         /* Identifiant unique, jamais réutilisé (caches par thread) */
+    logger_mutex_t io_lock;   /* Sérialise les entrées/sorties HDF5 et la table des canaux */
+    logger_mutex_t stages_lock; /* Protège la liste des tampons par thread */
+    thread_stage_t* stages;   /* Tampons des threads producteurs (mode synchrone) */
+    struct stage_item_s* merge_items; /* Entrées triées lors de la fusion des tampons (sous io_lock) */
+    size_t merge_capacity;    /* Capacité de merge_items */
+    char pad[LOGGER_CACHE_LINE];
+    volatile unsigned long long sequence; /* Dernier numéro de séquence attribué */
+};
+
+/* Valeurs par défaut de la politique de regroupement */
+#define HDF5_LOGGER_DEFAULT_BATCH_ENTRIES 1024
+#define HDF5_LOGGER_DEFAULT_BATCH_BYTES (256 * 1024)
+#define HDF5_LOGGER_DEFAULT_BATCH_DELAY 1.0
+
+/* Délai par défaut entre deux purges par durée */
+#define HDF5_LOGGER_DEFAULT_RETENTION_INTERVAL 1.0
+
+/* Taille cible des chunks des tableaux, et ses bornes */
+#define HDF5_LOGGER_DEFAULT_CHUNK_BYTES (256 * 1024)
+#define HDF5_LOGGER_MIN_CHUNK_BYTES 4096
+#define HDF5_LOGGER_MAX_CHUNK_BYTES (64 * 1024 * 1024)
+
+/* Côté maximal des chunks d'une image */
+#define IMAGE_CHUNK_SIDE 128
+
+/**
+ * @brief Réserve n numéros de séquence consécutifs
+ * @param logger Pointeur vers le logger
+ * @param n Nombre de numéros réservés
+ * @return Premier numéro réservé
+ */
+static inline unsigned long long logger_next_sequence(hdf5_logger_t* logger, size_t n) {
+    return atomic_add_u64(&logger->sequence, (unsigned long long)n) + 1;
+}
+
+/**
+ * @brief Initialise les niveaux minimaux (tous les niveaux sont écrits)
+ * @param logger Pointeur vers le logger
+ * @return 0 en cas de succès, -1 sinon
+ */
+int level_init(hdf5_logger_t* logger);
+
+/**
+ * @brief Libère les seuils des groupes
+ * @param logger Pointeur vers le logger
+ */
+void level_destroy(hdf5_logger_t* logger);
+
+/**
+ * @brief Cherche le seuil du groupe (ou celui du logger) et le compare au niveau
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe
+ * @param level Niveau du log
+ * @return 1 si le log passe le seuil, 0 sinon
+ */
+int level_group_enabled(hdf5_logger_t* logger, const char* group_path, int level);
+
+/**
+ * @brief Indique si un log texte de ce niveau doit être écrit dans ce groupe
+ *
+ * Sans seuil de groupe intermédiaire, une seule comparaison suffit :
+ * aucune recherche, aucune allocation, aucun appel HDF5.
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe
+ * @param level Niveau du log
+ * @return 1 si le log passe le seuil, 0 sinon
+ */
+static inline int level_enabled(hdf5_logger_t* logger, const char* group_path, int level) {
+    if (level < atomic_load_int(&logger->levels.floor)) {
+        return 0;
+    }
+    if (level >= atomic_load_int(&logger->levels.ceiling)) {
+        return 1;
+    }
+    return level_group_enabled(logger, group_path, level);
+}
+
+/**
+ * @brief Crée un groupe HDF5 s'il n'existe pas déjà
+ * @param file_id ID du fichier HDF5
+ * @param group_path Chemin du groupe à créer
+ * @return ID du groupe ou négatif en cas d'erreur
+ */
+hid_t create_group_if_not_exists(hid_t file_id, const char* group_path);
+
+/**
+ * @brief Renvoie l'heure courante en secondes Unix, avec une précision sub-seconde
+ * @return Horodatage courant
+ */
+double get_current_time(void);
+
+/**
+ * @brief Lit un attribut scalaire s'il existe
+ * @param obj_id Groupe ou dataset portant l'attribut
+ * @param name Nom de l'attribut
+ * @param mem_type Type mémoire de la valeur
+ * @param value Valeur lue (inchangée si l'attribut n'existe pas)
+ * @return 0 si l'attribut a été lu, -1 sinon
+ */
+int read_scalar_attribute(hid_t obj_id, const char* name, hid_t mem_type, void* value);
+
+/**
+ * @brief Crée ou met à jour un attribut scalaire
+ * @param obj_id Groupe ou dataset portant l'attribut
+ * @param name Nom de l'attribut
+ * @param mem_type Type mémoire de la valeur
+ * @param value Valeur à écrire
+ * @return 0 en cas de succès, -1 sinon
+ */
+int write_scalar_attribute(hid_t obj_id, const char* name, hid_t mem_type, const void* value);
+
+/**
+ * @brief Crée le type composé HDF5 correspondant à text_record_t
+ * @return ID du type ou négatif en cas d'erreur
+ */
+hid_t create_text_record_type(void);
+
+/**
+ * @brief Initialise un stockage vide (aucun dataset ouvert)
+ * @param store Stockage à initialiser
+ */
+void store_init(text_store_t* store);
+
+/**
+ * @brief Ouvre le stockage compact d'un groupe s'il existe
+ * @param store Stockage à remplir
+ * @param group_id Groupe contenant les datasets
+ * @param record_type_id Type composé des enregistrements
+ * @return 1 si le stockage existe, 0 s'il n'existe pas, -1 en cas d'erreur
+ */
+int store_open(text_store_t* store, hid_t group_id, hid_t record_type_id);
+
+/**
+ * @brief Crée les datasets vides du stockage compact dans un groupe
+ * @param store Stockage à remplir
+ * @param group_id Groupe cible
+ * @param record_type_id Type composé des enregistrements
+ * @param ring_capacity Capacité de l'anneau, ou 0 pour un stockage linéaire
+ * @param codec Compression des deux datasets
+ * @return 0 en cas de succès, -1 sinon
+ */
+int store_create(text_store_t* store, hid_t group_id, hid_t record_type_id,
+                 hsize_t ring_capacity, const hdf5_codec_policy_t* codec);
+
+/**
+ * @brief Ferme les datasets d'un stockage en ramenant leurs étendues aux longueurs logiques
+ * @param store Stockage à fermer
+ */
+void store_close(text_store_t* store);
+
+/**
+ * @brief Ferme puis supprime les datasets d'un stockage
+ * @param store Stockage à supprimer
+ * @param group_id Groupe contenant les datasets
+ * @return 0 en cas de succès, -1 sinon
+ */
+int store_delete(text_store_t* store, hid_t group_id);
+
+/**
+ * @brief Ajoute des enregistrements et leurs messages à la fin du stockage
+ * @param store Stockage cible
+ * @param record_type_id Type composé des enregistrements
+ * @param records Enregistrements, positions relatives à bytes (modifiés en place)
+ * @param n Nombre d'enregistrements
+ * @param bytes Messages bout à bout
+ * @param nbytes Nombre d'octets de bytes
+ * @return 0 en cas de succès, -1 sinon
+ */
+int store_append(text_store_t* store, hid_t record_type_id, text_record_t* records, size_t n,
+                 const char* bytes, size_t nbytes);
+
+/**
+ * @brief Lit l'horodatage d'un enregistrement
+ * @param store Stockage source
+ * @param index Indice chronologique de l'enregistrement (0 = le plus ancien)
+ * @param timestamp Horodatage lu
+ * @return 0 en cas de succès, -1 sinon
+ */
+int store_read_timestamp(const text_store_t* store, hsize_t index, double* timestamp);
+
+/**
+ * @brief Cherche par dichotomie le premier enregistrement d'horodatage >= cutoff
+ * @param store Stockage source, trié par horodatage
+ * @param first Indice chronologique du début de la recherche
+ * @param last Indice chronologique de fin (exclu)
+ * @param cutoff Horodatage recherché
+ * @param index Indice trouvé, ou last si tous les enregistrements sont plus anciens
+ * @return 0 en cas de succès, -1 sinon
+ */
+int store_find_time(const text_store_t* store, hsize_t first, hsize_t last, double cutoff,
+                    hsize_t* index);
+
+/**
+ * @brief Oublie les n enregistrements les plus anciens d'un anneau
+ * @param store Stockage en mode anneau
+ * @param record_type_id Type composé des enregistrements
+ * @param n Nombre d'enregistrements à oublier
+ * @return 0 en cas de succès, -1 sinon
+ */
+int store_drop_front(text_store_t* store, hid_t record_type_id, hsize_t n);
+
+/**
+ * @brief Parcourt une plage d'enregistrements dans l'ordre chronologique
+ * @param store Stockage source
+ * @param record_type_id Type composé des enregistrements
+ * @param start Indice chronologique du premier enregistrement
+ * @param count Nombre d'enregistrements
+ * @param visit Fonction appelée pour chaque enregistrement
+ * @param user_data Donnée transmise à visit
+ * @return 0 si tout a été parcouru, valeur non nulle de visit, ou -1 en cas d'erreur
+ */
+int store_iterate(const text_store_t* store, hid_t record_type_id, hsize_t start, hsize_t count,
+                  text_visit_t visit, void* user_data);
+
+/**
+ * @brief Charge les segments temporels d'un groupe et ouvre le segment courant
+ * @param channel Canal dont le groupe est ouvert
+ * @return 1 si le groupe est segmenté, 0 sinon, -1 en cas d'erreur
+ */
+int segments_open(hdf5_log_channel_t* channel);
+
+/**
+ * @brief Marque le groupe d'un canal comme segmenté, sans segment
+ * @param channel Canal cible, limité en temps
+ * @return 0 en cas de succès, -1 sinon
+ */
+int segments_create(hdf5_log_channel_t* channel);
+
+/**
+ * @brief Recalcule la durée des prochains segments après un changement de limite de temps
+ * @param channel Canal segmenté
+ * @return 0 en cas de succès, -1 sinon
+ */
+int segments_resize(hdf5_log_channel_t* channel);
+
+/**
+ * @brief Ferme le segment courant et libère la liste des segments
+ * @param channel Canal segmenté
+ */
+void segments_close(hdf5_log_channel_t* channel);
+
+/**
+ * @brief Supprime tous les segments et les attributs de segmentation d'un groupe
+ * @param channel Canal segmenté
+ * @return 0 en cas de succès, -1 sinon
+ */
+int segments_delete(hdf5_log_channel_t* channel);
+
+/**
+ * @brief Ajoute des enregistrements en les répartissant dans les segments de leur tranche
+ * @param channel Canal segmenté
+ * @param records Enregistrements, positions relatives à bytes (modifiés en place)
+ * @param n Nombre d'enregistrements
+ * @param bytes Messages bout à bout
+ * @return 0 en cas de succès, -1 sinon
+ */
+int segments_append(hdf5_log_channel_t* channel, text_record_t* records, size_t n,
+                    const char* bytes);
+
+/**
+ * @brief Parcourt les entrées valides de tous les segments dans l'ordre chronologique
+ * @param channel Canal segmenté
+ * @param visit Fonction appelée pour chaque enregistrement
+ * @param user_data Donnée transmise à visit
+ * @return 0 si tout a été parcouru, valeur non nulle de visit, ou -1 en cas d'erreur
+ */
+int segments_iterate(hdf5_log_channel_t* channel, text_visit_t visit, void* user_data);
+
+/**
+ * @brief Applique la limite de temps d'un canal : oublie exactement les entrées expirées
+ * @param channel Canal cible
+ * @param now Heure courante
+ * @return 0 en cas de succès, -1 sinon
+ */
+int retention_apply(hdf5_log_channel_t* channel, double now);
+
+/**
+ * @brief Recherche un canal ouvert sans le créer
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe
+ * @return Canal ou NULL s'il n'est pas ouvert
+ */
+hdf5_log_channel_t* channel_find(hdf5_logger_t* logger, const char* group_path);
+
+/**
+ * @brief Recherche un canal, en l'ouvrant si nécessaire
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe
+ * @return Canal ou NULL en cas d'erreur
+ */
+hdf5_log_channel_t* channel_get(hdf5_logger_t* logger, const char* group_path);
+
+/**
+ * @brief Ajoute une entrée au tampon d'un canal et le vide si la politique l'exige
+ * @param channel Canal cible
+ * @param level Niveau du log
+ * @param timestamp Horodatage de l'entrée
+ * @param sequence Numéro de séquence de l'entrée
+ * @param format_id Format interné, ou 0 si data est le message formaté
+ * @param data Message, ou arguments encodés du format
+ * @param length Nombre d'octets de data
+ * @return 0 en cas de succès, -1 sinon
+ */
+int channel_append(hdf5_log_channel_t* channel, hdf5_log_level_t level, double timestamp,
+                   unsigned long long sequence, unsigned int format_id, const char* data,
+                   size_t length);
+
+/**
+ * @brief Ajoute un lot d'entrées au tampon d'un canal
+ * @param channel Canal cible
+ * @param entries Entrées à ajouter
+ * @param n Nombre d'entrées
+ * @param first_sequence Numéro de séquence de la première entrée, les suivantes étant consécutives
+ * @return 0 en cas de succès, -1 sinon
+ */
+int channel_append_batch(hdf5_log_channel_t* channel, const hdf5_text_entry_t* entries, size_t n,
+                         unsigned long long first_sequence);
+
+/**
+ * @brief Change la limite de taille d'un canal et convertit son stockage si nécessaire
+ * @param channel Canal cible
+ * @param max_entries Nouvelle limite (0 = aucune)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int channel_set_max_entries(hdf5_log_channel_t* channel, hsize_t max_entries);
+
+/**
+ * @brief Change la limite de temps d'un canal et convertit son stockage si nécessaire
+ * @param channel Canal cible
+ * @param max_time_seconds Nouvelle limite (0 = aucune)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int channel_set_max_time(hdf5_log_channel_t* channel, double max_time_seconds);
+
+/**
+ * @brief Parcourt les entrées du stockage compact d'un canal, quelle que soit sa disposition
+ * @param channel Canal source (vidé au préalable)
+ * @param visit Fonction appelée pour chaque enregistrement
+ * @param user_data Donnée transmise à visit
+ * @return 0 si tout a été parcouru, valeur non nulle de visit, ou -1 en cas d'erreur
+ */
+int channel_iterate(hdf5_log_channel_t* channel, text_visit_t visit, void* user_data);
+
+/**
+ * @brief Écrit les entrées en attente d'un canal en une seule écriture d'hyperslab
+ * @param channel Canal à vider
+ * @return 0 en cas de succès, -1 sinon
+ */
+int channel_flush(hdf5_log_channel_t* channel);
+
+/**
+ * @brief Vide les tampons de tous les canaux et de toutes les séries de trames d'un logger
+ * @param logger Pointeur vers le logger
+ * @return 0 en cas de succès, -1 si au moins un canal a échoué
+ */
+int channel_table_flush(hdf5_logger_t* logger);
+
+/**
+ * @brief Vide puis ferme tous les canaux d'un logger et libère la table
+ * @param logger Pointeur vers le logger
+ */
+void channel_table_close(hdf5_logger_t* logger);
+
+/**
+ * @brief Écrit un tableau dans un nouveau dataset (remplace un dataset de même nom)
+ * @param logger Pointeur vers le logger (sous io_lock)
+ * @param group_path Chemin du groupe
+ * @param dataset_name Nom du dataset
+ * @param data Données à écrire
+ * @param rank Rang du tableau (1 à HDF5_LOGGER_MAX_RANK)
+ * @param dims Dimensions du tableau
+ * @param dtype Type des éléments
+ * @param layout Disposition des chunks
+ * @param view Sélection des données dans leur tampon (NULL = tableau dense)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int array_write(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
+                const void* data, int rank, const hsize_t* dims, hdf5_dtype_t dtype,
+                const hdf5_array_layout_t* layout, const source_view_t* view);
+
+/**
+ * @brief Ajoute une trame à une série, en créant ou prolongeant ses datasets
+ * @param logger Pointeur vers le logger (sous io_lock)
+ * @param group_path Chemin du groupe
+ * @param name Nom du dataset des trames
+ * @param data Trame
+ * @param rank Rang d'une trame (1 à HDF5_LOGGER_MAX_RANK - 1)
+ * @param dims Dimensions d'une trame
+ * @param dtype Type des éléments
+ * @param timestamp Horodatage de la trame
+ * @return 0 en cas de succès, -1 si la trame ne correspond pas à la série ou en cas d'erreur
+ */
+int stream_append(hdf5_logger_t* logger, const char* group_path, const char* name,
+                  const void* data, int rank, const hsize_t* dims, hdf5_dtype_t dtype,
+                  double timestamp);
+
+/**
+ * @brief Ajoute une image à une série d'images, en créant ou prolongeant ses datasets
+ * @param logger Pointeur vers le logger (sous io_lock)
+ * @param group_path Chemin du groupe
+ * @param name Nom du dataset des images
+ * @param pixel_data Pixels de l'image (hauteur x largeur x canaux)
+ * @param width Largeur de l'image
+ * @param height Hauteur de l'image
+ * @param channels Nombre de canaux
+ * @param dtype Type d'un canal
+ * @param view Sélection des pixels dans leur tampon (NULL = image dense)
+ * @param timestamp Horodatage de l'image
+ * @param sequence Numéro de séquence de l'image
+ * @return 0 en cas de succès, -1 si l'image ne correspond pas à la série ou en cas d'erreur
+ */
+int stream_append_image(hdf5_logger_t* logger, const char* group_path, const char* name,
+                        const void* pixel_data, size_t width, size_t height, size_t channels,
+                        hdf5_dtype_t dtype, const source_view_t* view, double timestamp,
+                        unsigned long long sequence);
+
+/**
+ * @brief Écrit les trames en attente de toutes les séries
+ * @param logger Pointeur vers le logger
+ * @return 0 en cas de succès, -1 si au moins une série a échoué
+ */
+int stream_table_flush(hdf5_logger_t* logger);
+
+/**
+ * @brief Écrit puis ferme une série si elle est ouverte
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe
+ * @param name Nom du dataset des trames
+ * @return 0 en cas de succès ou si la série n'est pas ouverte, -1 sinon
+ */
+int stream_close(hdf5_logger_t* logger, const char* group_path, const char* name);
+
+/**
+ * @brief Écrit puis ferme toutes les séries
+ * @param logger Pointeur vers le logger
+ * @return 0 en cas de succès, -1 si au moins une série a échoué
+ */
+int stream_table_close(hdf5_logger_t* logger);
+
+/**
+ * @brief Renvoie la taille cible d'un chunk, bornée
+ * @param layout Disposition (NULL = taille par défaut)
+ * @return Taille cible en octets
+ */
+size_t chunk_target_bytes(const hdf5_array_layout_t* layout);
+
+/**
+ * @brief Initialise les politiques de compression par défaut
+ * @param logger Pointeur vers le logger
+ * @return 0 en cas de succès, -1 sinon
+ */
+int codec_init(hdf5_logger_t* logger);
+
+/**
+ * @brief Libère les politiques de compression des groupes
+ * @param logger Pointeur vers le logger
+ */
+void codec_destroy(hdf5_logger_t* logger);
+
+/**
+ * @brief Renvoie la politique de compression d'un groupe (sous io_lock)
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe
+ * @param kind Nature des données
+ * @return Politique du groupe, ou à défaut celle du logger
+ */
+const hdf5_codec_policy_t* codec_resolve(hdf5_logger_t* logger, const char* group_path,
+                                         hdf5_data_kind_t kind);
+
+/**
+ * @brief Ajoute les filtres d'une politique à une liste de propriétés de création chunkée
+ * @param plist_id Propriétés de création du dataset (chunks déjà définis)
+ * @param policy Politique de compression
+ * @param element_size Taille d'un élément en octets
+ * @param pixel_rank Dernières dimensions formant un pixel (1 pour des canaux entrelacés, 0 sinon),
+ *        pour la prédiction PNG
+ * @return 0 en cas de succès, -1 sinon
+ */
+int codec_apply(hid_t plist_id, const hdf5_codec_policy_t* policy, size_t element_size,
+                int pixel_rank);
+
+/**
+ * @brief Enregistre le filtre de prédiction auprès de HDF5 (une fois par processus)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int predict_register(void);
+
+/**
+ * @brief Prédiction appliquée par une politique à des éléments d'une taille donnée
+ * @param policy Politique de compression
+ * @param element_size Taille d'un élément en octets
+ * @return Prédiction, HDF5_PREDICT_NONE sans codec ou pour une taille autre que 1, 2, 4 ou 8 ;
+ *         HDF5_PREDICT_DELTA à la place de la prédiction PNG pour une taille de 4 ou 8
+ */
+hdf5_predictor_t predict_select(const hdf5_codec_policy_t* policy, size_t element_size);
+
+/**
+ * @brief Indique si une prédiction travaille ligne par ligne (PNG)
+ * @param predictor Prédiction
+ * @return 1 pour HDF5_PREDICT_PNG et HDF5_PREDICT_PNG_FRAME, 0 sinon
+ */
+int predict_by_rows(hdf5_predictor_t predictor);
+
+/**
+ * @brief Ajoute le filtre de prédiction à une liste de propriétés de création chunkée
+ *
+ * Pour la prédiction PNG, la géométrie des lignes est déduite des chunks et
+ * rangée dans les paramètres du filtre.
+ * @param plist_id Propriétés de création du dataset (chunks définis, avant les autres filtres)
+ * @param predictor Prédiction choisie par predict_select
+ * @param element_size Taille d'un élément (1, 2, 4 ou 8)
+ * @param pixel_rank Dernières dimensions formant un pixel (voir codec_apply)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int predict_apply(hid_t plist_id, hdf5_predictor_t predictor, size_t element_size,
+                  int pixel_rank);
+
+/**
+ * @brief Lit la géométrie des lignes du filtre de prédiction PNG d'un dataset
+ * @param dataset_id Dataset
+ * @param rows Géométrie remplie
+ * @return 0 en cas de succès, -1 si le dataset n'a pas de prédiction PNG
+ */
+int predict_rows_read(hid_t dataset_id, predict_rows_t* rows);
+
+/**
+ * @brief Taille d'un chunk codé par la prédiction PNG : les écarts puis un octet par ligne
+ * @param rows Géométrie des lignes
+ * @param bytes Taille brute du chunk (un nombre entier de lignes)
+ * @return Taille codée
+ */
+size_t predict_rows_encoded_bytes(const predict_rows_t* rows, size_t bytes);
+
+/**
+ * @brief Code un chunk par la prédiction PNG, ligne par ligne
+ *
+ * Chaque ligne est codée par le prédicteur dont les écarts ont la plus
+ * petite somme absolue ; son numéro est rangé à la fin du chunk codé. Même
+ * résultat que le filtre HDF5_LOGGER_FILTER_PREDICT.
+ * @param rows Géométrie des lignes
+ * @param data Chunk brut
+ * @param bytes Taille du chunk (un nombre entier de lignes)
+ * @param out Chunk codé (predict_rows_encoded_bytes octets)
+ * @return Taille codée
+ */
+size_t predict_rows_encode(const predict_rows_t* rows, const void* data, size_t bytes,
+                           void* out);
+
+/**
+ * @brief Inverse predict_rows_encode en place
+ * @param rows Géométrie des lignes
+ * @param data Chunk codé, brut en sortie
+ * @param bytes Taille codée
+ * @return Taille brute, 0 si le chunk codé est invalide
+ */
+size_t predict_rows_decode(const predict_rows_t* rows, void* data, size_t bytes);
+
+/**
+ * @brief Remplace en place chaque élément par son écart à l'élément précédent
+ *
+ * Le premier élément est gardé ; les octets après le dernier élément entier
+ * ne sont pas modifiés. Même résultat que le filtre HDF5_LOGGER_FILTER_PREDICT.
+ * @param data Éléments
+ * @param bytes Taille de data en octets
+ * @param element_size Taille d'un élément (1, 2, 4 ou 8)
+ * @param predictor Prédiction (DELTA ou XOR)
+ */
+void predict_encode(void* data, size_t bytes, size_t element_size, hdf5_predictor_t predictor);
+
+/**
+ * @brief Inverse predict_encode en place
+ * @param data Écarts
+ * @param bytes Taille de data en octets
+ * @param element_size Taille d'un élément (1, 2, 4 ou 8)
+ * @param predictor Prédiction (DELTA ou XOR)
+ */
+void predict_decode(void* data, size_t bytes, size_t element_size, hdf5_predictor_t predictor);
+
+/**
+ * @brief Libère les quantifications des groupes et des datasets
+ * @param logger Pointeur vers le logger
+ */
+void quantize_destroy(hdf5_logger_t* logger);
+
+/**
+ * @brief Renvoie la quantification d'un dataset (sous io_lock)
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe
+ * @param dataset_name Nom du dataset
+ * @param dtype Type des éléments
+ * @return Précision du dataset, ou à défaut celle du groupe ; NULL pour des valeurs exactes
+ *         (aucune précision, ou éléments autres que float et double)
+ */
+const hdf5_quantize_t* quantize_resolve(hdf5_logger_t* logger, const char* group_path,
+                                        const char* dataset_name, hdf5_dtype_t dtype);
+
+/**
+ * @brief Recopie des valeurs en les arrondissant à une précision
+ * @param quantize Précision (mode autre que HDF5_QUANTIZE_NONE)
+ * @param dtype HDF5_DTYPE_FLOAT32 ou HDF5_DTYPE_FLOAT64
+ * @param in Valeurs
+ * @param out Valeurs arrondies (peut être in)
+ * @param count Nombre de valeurs
+ */
+void quantize_copy(const hdf5_quantize_t* quantize, hdf5_dtype_t dtype, const void* in,
+                   void* out, size_t count);
+
+/**
+ * @brief Note une précision dans les attributs d'un dataset
+ * @param dataset_id Dataset
+ * @param quantize Précision
+ * @return 0 en cas de succès, -1 sinon
+ */
+int quantize_write_attributes(hid_t dataset_id, const hdf5_quantize_t* quantize);
+
+/**
+ * @brief Relit la précision notée dans les attributs d'un dataset
+ * @param dataset_id Dataset
+ * @param quantize Précision lue (mode HDF5_QUANTIZE_NONE sans attribut)
+ */
+void quantize_read_attributes(hid_t dataset_id, hdf5_quantize_t* quantize);
+
+/**
+ * @brief Libère l'index de la déduplication
+ * @param logger Pointeur vers le logger
+ */
+void dedup_destroy(hdf5_logger_t* logger);
+
+/**
+ * @brief Calcule l'empreinte d'un tableau ou d'une image (sous io_lock, déduplication active)
+ * @param logger Pointeur vers le logger
+ * @param kind HDF5_DATA_NUMERIC ou HDF5_DATA_IMAGE
+ * @param data Données, en ordre C
+ * @param view Sélection des données dans leur tampon (NULL = bloc dense)
+ * @param rank Rang
+ * @param dims Dimensions
+ * @param dtype Type des éléments
+ * @param quantize Quantification appliquée à l'écriture (NULL = valeurs exactes)
+ * @param hash Empreinte calculée
+ * @return 0 en cas de succès, -1 si un tampon de travail manque
+ */
+int dedup_hash(hdf5_logger_t* logger, hdf5_data_kind_t kind, const void* data,
+               const source_view_t* view, int rank, const hsize_t* dims, hdf5_dtype_t dtype,
+               const hdf5_quantize_t* quantize, uint64_t hash[2]);
+
+/**
+ * @brief Remplace l'écriture d'un contenu déjà présent par un lien dur vers son dataset
+ *
+ * Un dataset existant sous le nom visé est supprimé, sauf s'il porte déjà ce
+ * contenu. Une empreinte dont le dataset a disparu ou changé est oubliée.
+ * @param logger Pointeur vers le logger
+ * @param group_id Groupe visé
+ * @param group_path Chemin du groupe
+ * @param name Nom du dataset
+ * @param hash Empreinte du contenu
+ * @param bytes Taille brute du contenu, comptée comme économisée
+ * @return 1 si le dataset est lié, 0 si le contenu est inconnu, -1 en cas d'erreur
+ */
+int dedup_link(hdf5_logger_t* logger, hid_t group_id, const char* group_path, const char* name,
+               const uint64_t hash[2], size_t bytes);
+
+/**
+ * @brief Note l'empreinte d'un dataset qui vient d'être écrit
+ * @param logger Pointeur vers le logger
+ * @param dataset_id Dataset
+ * @param group_path Chemin du groupe
+ * @param name Nom du dataset
+ * @param hash Empreinte du contenu
+ */
+void dedup_record(hdf5_logger_t* logger, hid_t dataset_id, const char* group_path,
+                  const char* name, const uint64_t hash[2]);
+
+/**
+ * @brief Écrit un bloc d'un dataset chunké
+ *
+ * Avec un groupe de threads, deflate et un bloc qui commence sur un chunk, les
+ * chunks sont compressés en parallèle puis écrits par H5Dwrite_chunk ; sinon
+ * par le pipeline de filtres HDF5.
+ * @param logger Pointeur vers le logger (sous io_lock)
+ * @param dataset_id Dataset créé avec ces chunks et les filtres de policy
+ * @param mem_type_id Type natif des données, identique à celui du dataset
+ * @param rank Rang du dataset
+ * @param origin Position du bloc (NULL = dataset entier)
+ * @param dims Dimensions du bloc ; un chunk qu'il remplit en partie doit être au bord du dataset
+ * @param chunk_dims Dimensions d'un chunk
+ * @param policy Politique de compression du dataset
+ * @param data Données complètes, en ordre C
+ * @param view Sélection des données dans leur tampon (NULL = bloc dense)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int chunks_write(hdf5_logger_t* logger, hid_t dataset_id, hid_t mem_type_id, int rank,
+                 const hsize_t* origin, const hsize_t* dims, const hsize_t* chunk_dims,
+                 const hdf5_codec_policy_t* policy, const void* data, const source_view_t* view);
+
+/**
+ * @brief Décrit un tableau pris dans un tampon plus grand
+ * @param view Vue remplie
+ * @param rank Rang du tableau et du tampon
+ * @param dims Dimensions du tableau
+ * @param source Dimensions du tampon, position et pas des éléments lus
+ * @return 0 pour une vue, 1 si le tableau est dense dans le tampon (vue inutile), -1 si la
+ *         sélection sort du tampon
+ */
+int view_from_layout(source_view_t* view, int rank, const hsize_t* dims,
+                     const hdf5_source_layout_t* source);
+
+/**
+ * @brief Décrit une image dont les lignes sont espacées de row_pitch octets
+ * @param view Vue remplie
+ * @param width Largeur
+ * @param height Hauteur
+ * @param channels Nombre de canaux
+ * @param element_size Taille d'un canal en octets
+ * @param row_pitch Octets entre le début de deux lignes
+ * @return 0 pour une vue, 1 si les lignes sont jointives (vue inutile), -1 si le pas est
+ *         plus court qu'une ligne ou n'est pas un multiple de element_size
+ */
+int view_from_pitch(source_view_t* view, size_t width, size_t height, size_t channels,
+                    size_t element_size, size_t row_pitch);
+
+/**
+ * @brief Crée le dataspace mémoire d'une vue, avec sa sélection
+ * @param view Vue
+ * @return Dataspace à fermer par l'appelant, ou -1 en cas d'erreur
+ */
+hid_t view_space(const source_view_t* view);
+
+/**
+ * @brief Recopie des éléments consécutifs de la sélection, de façon contiguë
+ * @param view Vue
+ * @param data Tampon source
+ * @param element_size Taille d'un élément en octets
+ * @param first Rang (ordre C) du premier élément recopié dans la sélection
+ * @param count Nombre d'éléments recopiés
+ * @param out Destination de count éléments
+ */
+void view_gather(const source_view_t* view, const void* data, size_t element_size,
+                 size_t first, size_t count, void* out);
+
+/**
+ * @brief Démarre un groupe de threads de compression
+ * @param thread_count Nombre de threads de travail (l'appelant de pool_run s'y ajoute)
+ * @return Groupe de threads, ou NULL en cas d'erreur
+ */
+compress_pool_t* pool_start(size_t thread_count);
+
+/**
+ * @brief Arrête les threads d'un groupe et le libère
+ * @param pool Groupe de threads (peut être NULL)
+ */
+void pool_stop(compress_pool_t* pool);
+
+/**
+ * @brief Renvoie le nombre de threads qui exécutent un lot, appelant compris
+ * @param pool Groupe de threads (NULL = l'appelant seul)
+ * @return Nombre de threads
+ */
+size_t pool_size(const compress_pool_t* pool);
+
+/**
+ * @brief Exécute les count tâches d'un lot en parallèle et attend qu'elles soient terminées
+ * @param pool Groupe de threads (NULL = exécution sur l'appelant)
+ * @param count Nombre de tâches
+ * @param task Fonction appelée pour chaque indice de 0 à count - 1
+ * @param arg Argument transmis à task
+ */
+void pool_run(compress_pool_t* pool, size_t count, pool_task_t task, void* arg);
+
+/**
+ * @brief Crée l'allocateur des tampons de travail d'un logger
+ * @param id Identifiant unique du logger (caches par thread)
+ * @return Allocateur, ou NULL en cas d'erreur
+ */
+memory_arena_t* arena_create(unsigned long id);
+
+/**
+ * @brief Libère l'allocateur et ses blocs libres (tous les blocs doivent avoir été rendus)
+ * @param arena Allocateur (NULL accepté)
+ */
+void arena_destroy(memory_arena_t* arena);
+
+/**
+ * @brief Prend un tampon, réutilisé si un bloc de même classe est libre
+ * @param arena Allocateur
+ * @param bytes Taille demandée
+ * @return Tampon aligné comme malloc, ou NULL si la limite mémoire ou le système le refuse
+ */
+void* arena_alloc(memory_arena_t* arena, size_t bytes);
+
+/**
+ * @brief Rend un tampon pris par arena_alloc, depuis n'importe quel thread
+ * @param arena Allocateur
+ * @param data Tampon (NULL accepté)
+ */
+void arena_free(memory_arena_t* arena, void* data);
+
+/**
+ * @brief Choisit la forme des chunks d'un dataset
+ * @param rank Rang du dataset (1 à HDF5_LOGGER_MAX_RANK)
+ * @param dims Dimensions du dataset
+ * @param element_size Taille d'un élément en octets
+ * @param layout Motif d'accès et taille cible (NULL = parcours ligne par ligne, 256 Kio)
+ * @param chunk_dims Forme choisie (rank valeurs)
+ * @return 1 si le dataset doit être découpé en chunks, 0 s'il reste contigu, -1 en cas d'erreur
+ */
+int chunk_plan(int rank, const hsize_t* dims, size_t element_size,
+               const hdf5_array_layout_t* layout, hsize_t* chunk_dims);
+
+/**
+ * @brief Renvoie la taille d'un élément
+ * @param dtype Type des éléments
+ * @return Taille en octets, 0 si le type est inconnu
+ */
+size_t dtype_size(hdf5_dtype_t dtype);
+
+/**
+ * @brief Renvoie le type HDF5 natif d'un élément, en mémoire comme dans le fichier
+ * @param logger Pointeur vers le logger (sous io_lock, qui garde le type demi-précision)
+ * @param dtype Type des éléments
+ * @return Type HDF5, à ne pas fermer, ou -1 si le type est inconnu
+ */
+hid_t dtype_type(hdf5_logger_t* logger, hdf5_dtype_t dtype);
+
+/**
+ * @brief Ferme le type demi-précision du logger s'il a été créé
+ * @param logger Pointeur vers le logger
+ */
+void dtype_close(hdf5_logger_t* logger);
+
+/**
+ * @brief Sépare des pixels entrelacés en plans
+ * @param src Pixels entrelacés (count x channels éléments)
+ * @param planes Destination de chaque canal (count éléments chacune)
+ * @param count Nombre de pixels
+ * @param channels Nombre de canaux (1 à 4)
+ * @param element_size Taille d'un canal (1, 2, 4 ou 8 octets)
+ */
+void pixels_deinterleave(const void* src, void* const* planes, size_t count, size_t channels,
+                         size_t element_size);
+
+/**
+ * @brief Entrelace des plans, inverse de pixels_deinterleave
+ * @param planes Source de chaque canal (count éléments chacune)
+ * @param dst Pixels entrelacés (count x channels éléments)
+ * @param count Nombre de pixels
+ * @param channels Nombre de canaux (1 à 4)
+ * @param element_size Taille d'un canal (1, 2, 4 ou 8 octets)
+ */
+void pixels_interleave(const void* const* planes, void* dst, size_t count, size_t channels,
+                       size_t element_size);
+
+/**
+ * @brief Nombre de canaux de l'image convertie depuis un format de caméra
+ * @param format Format des pixels
+ * @return 3 ou 4, 0 si le format est inconnu
+ */
+size_t pixel_format_channels(hdf5_pixel_format_t format);
+
+/**
+ * @brief Octets lus dans une image d'un format de caméra
+ * @param format Format des pixels
+ * @param width Largeur
+ * @param height Hauteur
+ * @param row_pitch Octets entre deux lignes (0 = lignes contiguës)
+ * @return Octets de la première ligne à la fin de la dernière, 0 si l'image est invalide
+ */
+size_t pixel_frame_bytes(hdf5_pixel_format_t format, size_t width, size_t height,
+                         size_t row_pitch);
+
+/**
+ * @brief Convertit une image d'un format de caméra en plans RGB (et A) 8 bits
+ * @param frame Image source
+ * @param width Largeur
+ * @param height Hauteur
+ * @param row_pitch Octets entre deux lignes (0 = lignes contiguës)
+ * @param format Format des pixels
+ * @param planes Destination : plans consécutifs de width x height octets
+ * @return Nombre de canaux écrits, -1 si l'image est invalide
+ */
+int pixels_convert(const void* frame, size_t width, size_t height, size_t row_pitch,
+                   hdf5_pixel_format_t format, void* planes);
+
+/**
+ * @brief Disposition des images d'un groupe
+ * @param logger Pointeur vers le logger (sous io_lock)
+ * @param group_path Chemin du groupe
+ * @return Disposition fixée par hdf5_logger_set_image_layout, entrelacée par défaut
+ */
+hdf5_image_layout_t image_layout_resolve(hdf5_logger_t* logger, const char* group_path);
+
+/**
+ * @brief Libère les dispositions propres aux groupes
+ * @param logger Pointeur vers le logger
+ */
+void image_layout_destroy(hdf5_logger_t* logger);
+
+/**
+ * @brief Côté maximal du dernier niveau de vignettes des images d'un groupe
+ * @param logger Pointeur vers le logger (sous io_lock)
+ * @param group_path Chemin du groupe
+ * @return Taille fixée par hdf5_logger_set_image_pyramid, 0 sans vignettes
+ */
+size_t image_pyramid_resolve(hdf5_logger_t* logger, const char* group_path);
+
+/**
+ * @brief Libère les réglages de vignettes des groupes
+ * @param logger Pointeur vers le logger
+ */
+void image_pyramid_destroy(hdf5_logger_t* logger);
+
+/**
+ * @brief Écrit les vignettes d'une image qui vient d'être écrite, si son groupe en a
+ * @param logger Pointeur vers le logger (sous io_lock)
+ * @param group_path Chemin du groupe
+ * @param image_name Nom du dataset de l'image
+ * @param pixel_data Pixels de l'image
+ * @param width Largeur
+ * @param height Hauteur
+ * @param channels Nombre de canaux
+ * @param dtype Type d'un canal
+ * @param view Sélection des pixels dans leur tampon (NULL = image dense)
+ * @param planar 1 si les pixels sont séparés en plans (niveaux écrits en plans)
+ * @return 0 en cas de succès ou sans vignettes, -1 sinon
+ */
+int image_pyramid_write(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                        const void* pixel_data, size_t width, size_t height, size_t channels,
+                        hdf5_dtype_t dtype, const source_view_t* view, int planar);
+
+/**
+ * @brief Écrit des pixels dans un nouveau dataset d'image (remplace un dataset de même nom)
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe
+ * @param image_name Nom du dataset
+ * @param pixel_data Pixels de l'image
+ * @param width Largeur
+ * @param height Hauteur
+ * @param channels Nombre de canaux
+ * @param dtype Type d'un canal
+ * @param view Sélection des pixels dans leur tampon (NULL = image dense)
+ * @param planar 1 si les pixels sont séparés en plans, écrits [canaux, hauteur, largeur]
+ * @param chunk_side Côté maximal d'un chunk en pixels (IMAGE_CHUNK_SIDE par défaut)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int image_store(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                const void* pixel_data, size_t width, size_t height, size_t channels,
+                hdf5_dtype_t dtype, const source_view_t* view, int planar, size_t chunk_side);
+
+/**
+ * @brief Écrit une image dans un nouveau dataset (remplace un dataset de même nom)
+ * @param logger Pointeur vers le logger
+ * @param group_path Chemin du groupe
+ * @param image_name Nom du dataset
+ * @param pixel_data Pixels de l'image
+ * @param width Largeur
+ * @param height Hauteur
+ * @param channels Nombre de canaux
+ * @param dtype Type d'un canal
+ * @param view Sélection des pixels dans leur tampon (NULL = image dense)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int image_write(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                const void* pixel_data, size_t width, size_t height, size_t channels,
+                hdf5_dtype_t dtype, const source_view_t* view);
+
+/**
+ * @brief Convertit une image d'un format de caméra et l'écrit comme image_write
+ * @param logger Pointeur vers le logger (sous io_lock)
+ * @param group_path Chemin du groupe
+ * @param image_name Nom du dataset
+ * @param frame Image source
+ * @param width Largeur
+ * @param height Hauteur
+ * @param format Format des pixels
+ * @param row_pitch Octets entre deux lignes (0 = lignes contiguës)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int image_write_format(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                       const void* frame, size_t width, size_t height,
+                       hdf5_pixel_format_t format, size_t row_pitch);
+
+/**
+ * @brief Réécrit les tuiles modifiées d'une image (voir hdf5_log_image_update)
+ * @param logger Pointeur vers le logger (sous io_lock)
+ * @param group_path Chemin du groupe
+ * @param image_name Nom du dataset
+ * @param pixel_data Image complète
+ * @param width Largeur
+ * @param height Hauteur
+ * @param channels Nombre de canaux
+ * @param dtype Type d'un canal
+ * @param rects Régions modifiées, dans l'image (NULL = comparaison avec l'image précédente)
+ * @param rect_count Nombre de régions
+ * @return 0 en cas de succès, -1 sinon
+ */
+int image_update(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                 const void* pixel_data, size_t width, size_t height, size_t channels,
+                 hdf5_dtype_t dtype, const hdf5_image_rect_t* rects, size_t rect_count);
+
+/**
+ * @brief Oublie l'image gardée pour un dataset qui va être remplacé
+ * @param logger Pointeur vers le logger (sous io_lock)
+ * @param group_path Chemin du groupe
+ * @param name Nom du dataset
+ */
+void tile_forget(hdf5_logger_t* logger, const char* group_path, const char* name);
+
+/**
+ * @brief Libère les images gardées pour les mises à jour par tuiles
+ * @param logger Pointeur vers le logger
+ */
+void tile_destroy(hdf5_logger_t* logger);
+
+/**
+ * @brief Démarre la file et le thread d'écriture du mode asynchrone
+ * @param logger Logger ouvert en mode synchrone
+ * @param config Configuration, ou NULL pour les valeurs par défaut
+ * @return 0 en cas de succès, -1 sinon
+ */
+int async_start(hdf5_logger_t* logger, const hdf5_async_config_t* config);
+
+/**
+ * @brief Écrit tout ce qui est en file puis arrête le thread d'écriture
+ * @param logger Logger en mode asynchrone (sans effet sinon)
+ */
+void async_stop(hdf5_logger_t* logger);
+
+/**
+ * @brief Attend que tout ce qui a été déposé avant l'appel soit écrit
+ * @param logger Logger en mode asynchrone
+ * @param persist 1 pour vider aussi les tampons HDF5 sur disque
+ * @return 0 en cas de succès, -1 si une écriture a échoué
+ */
+int async_flush(hdf5_logger_t* logger, int persist);
+
+/**
+ * @brief Réserve l'accès au fichier pour une opération qui lit ou modifie les datasets
+ *
+ * Prend le verrou d'entrées/sorties après avoir rendu visible tout ce qui a été
+ * logué avant l'appel : en mode asynchrone en attendant que la file soit écrite,
+ * en mode synchrone en fusionnant les tampons des threads producteurs.
+ *
+ * @param logger Pointeur vers le logger (peut être NULL)
+ * @return 0 en cas de succès (verrou tenu), -1 si logger est NULL ou si l'écriture des
+ *         entrées précédentes a échoué (verrou relâché)
+ */
+int logger_lock(hdf5_logger_t* logger);
+
+/**
+ * @brief Libère l'accès réservé par logger_lock
+ * @param logger Pointeur vers le logger
+ */
+void logger_unlock(hdf5_logger_t* logger);
+
+/**
+ * @brief Initialise les verrous et l'identifiant d'un nouveau logger
+ * @param logger Logger en cours d'initialisation
+ * @return 0 en cas de succès, -1 sinon
+ */
+int stage_init(hdf5_logger_t* logger);
+
+/**
+ * @brief Détache les tampons d'un logger de leurs threads, avant sa fermeture
+ *
+ * La sortie ultérieure de ces threads ne touche plus au logger.
+ * @param logger Logger en cours de fermeture (io_lock non tenu)
+ */
+void stage_detach(hdf5_logger_t* logger);
+
+/**
+ * @brief Libère les tampons par thread et les verrous d'un logger (après stage_merge)
+ * @param logger Logger en cours de fermeture
+ */
+void stage_destroy(hdf5_logger_t* logger);
+
+/**
+ * @brief Ajoute un log texte au tampon du thread appelant, sans contention entre threads
+ *
+ * Le tampon est fusionné dans les canaux quand la politique de regroupement
+ * l'exige, par le thread qui obtient le verrou d'entrées/sorties.
+ *
+ * @param logger Logger en mode synchrone
+ * @param channel Canal cible, ou NULL pour utiliser group_path
+ * @param group_path Chemin du groupe (ignoré si channel est fourni)
+ * @param level Niveau du log
+ * @param format_id Format interné, ou 0 si data est le message formaté
+ * @param data Message, ou arguments encodés du format (recopiés)
+ * @param length Nombre d'octets de data
+ * @return 0 en cas de succès, -1 sinon
+ */
+int stage_text(hdf5_logger_t* logger, hdf5_log_channel_t* channel, const char* group_path,
+               hdf5_log_level_t level, unsigned int format_id, const char* data, size_t length);
+
+/**
+ * @brief Fusionne les tampons de tous les threads dans les canaux, par numéro de séquence
+ * @param logger Pointeur vers le logger (appelant détenteur de io_lock)
+ * @return 0 en cas de succès, -1 si un ajout a échoué
+ */
+int stage_merge(hdf5_logger_t* logger);
+
+/**
+ * @brief Dépose un log texte dans la file asynchrone
+ * @param logger Logger en mode asynchrone
+ * @param channel Canal cible, ou NULL pour utiliser group_path
+ * @param group_path Chemin du groupe (ignoré si channel est fourni)
+ * @param level Niveau du log
+ * @param format_id Format interné, ou 0 si data est le message formaté
+ * @param data Message, ou arguments encodés du format (recopiés)
+ * @param length Nombre d'octets de data
+ * @return 0 en cas de succès (y compris abandon par politique), -1 sinon
+ */
+int async_submit_text(hdf5_logger_t* logger, hdf5_log_channel_t* channel, const char* group_path,
+                      hdf5_log_level_t level, unsigned int format_id, const char* data,
+                      size_t length);
+
+/**
+ * @brief Dépose un lot de logs texte dans la file asynchrone
+ * @param logger Logger en mode asynchrone
+ * @param group_path Chemin du groupe
+ * @param entries Entrées, recopiées avec leurs messages
+ * @param n Nombre d'entrées
+ * @return 0 en cas de succès, -1 sinon
+ */
+int async_submit_text_batch(hdf5_logger_t* logger, const char* group_path,
+                            const hdf5_text_entry_t* entries, size_t n);
+
+/**
+ * @brief Dépose un tableau dans la file asynchrone
+ * @param logger Logger en mode asynchrone
+ * @param group_path Chemin du groupe
+ * @param dataset_name Nom du dataset
+ * @param data Données, recopiées sauf si done est fourni
+ * @param rank Rang du tableau
+ * @param dims Dimensions
+ * @param dtype Type des éléments
+ * @param layout Disposition des chunks, recopiée
+ * @param view Sélection des données recopiées (NULL = tableau dense ; sans done seulement)
+ * @param done NULL pour recopier les données, sinon fonction qui rend les données empruntées
+ * @param user_data Donnée transmise à done
+ * @return 0 en cas de succès, -1 sinon (done n'est alors pas appelé)
+ */
+int async_submit_array(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
+                       const void* data, int rank, const hsize_t* dims, hdf5_dtype_t dtype,
+                       const hdf5_array_layout_t* layout, const source_view_t* view,
+                       hdf5_write_callback_t done, void* user_data);
+
+/**
+ * @brief Dépose une trame de série temporelle dans la file asynchrone
+ * @param logger Logger en mode asynchrone
+ * @param group_path Chemin du groupe
+ * @param dataset_name Nom du dataset des trames
+ * @param data Trame, recopiée
+ * @param rank Rang d'une trame
+ * @param dims Dimensions d'une trame
+ * @param dtype Type des éléments
+ * @return 0 en cas de succès, -1 sinon
+ */
+int async_submit_array_append(hdf5_logger_t* logger, const char* group_path,
+                              const char* dataset_name, const void* data, int rank,
+                              const hsize_t* dims, hdf5_dtype_t dtype);
+
+/**
+ * @brief Dépose une image dans la file asynchrone
+ * @param logger Logger en mode asynchrone
+ * @param group_path Chemin du groupe
+ * @param image_name Nom du dataset
+ * @param pixel_data Pixels, recopiés sauf si done est fourni
+ * @param width Largeur
+ * @param height Hauteur
+ * @param channels Nombre de canaux
+ * @param dtype Type d'un canal
+ * @param view Sélection des pixels recopiés (NULL = image dense ; sans done seulement)
+ * @param done NULL pour recopier les pixels, sinon fonction qui rend les pixels empruntés
+ * @param user_data Donnée transmise à done
+ * @return 0 en cas de succès, -1 sinon (done n'est alors pas appelé)
+ */
+int async_submit_image(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                       const void* pixel_data, size_t width, size_t height, size_t channels,
+                       hdf5_dtype_t dtype, const source_view_t* view, hdf5_write_callback_t done,
+                       void* user_data);
+
+/**
+ * @brief Dépose une mise à jour d'image dans la file asynchrone
+ * @param logger Logger en mode asynchrone
+ * @param group_path Chemin du groupe
+ * @param image_name Nom du dataset
+ * @param pixel_data Image complète, recopiée
+ * @param width Largeur
+ * @param height Hauteur
+ * @param channels Nombre de canaux
+ * @param dtype Type d'un canal
+ * @param rects Régions modifiées, recopiées (NULL = comparaison avec l'image précédente)
+ * @param rect_count Nombre de régions
+ * @return 0 en cas de succès, -1 sinon
+ */
+int async_submit_image_update(hdf5_logger_t* logger, const char* group_path,
+                              const char* image_name, const void* pixel_data, size_t width,
+                              size_t height, size_t channels, hdf5_dtype_t dtype,
+                              const hdf5_image_rect_t* rects, size_t rect_count);
+
+/**
+ * @brief Dépose une image d'un format de caméra, convertie par le thread d'écriture
+ * @param logger Logger en mode asynchrone
+ * @param group_path Chemin du groupe
+ * @param image_name Nom du dataset
+ * @param frame Image brute, recopiée
+ * @param width Largeur
+ * @param height Hauteur
+ * @param format Format des pixels
+ * @param row_pitch Octets entre deux lignes (0 = lignes contiguës)
+ * @param frame_bytes Octets de l'image brute (pixel_frame_bytes)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int async_submit_image_format(hdf5_logger_t* logger, const char* group_path,
+                              const char* image_name, const void* frame, size_t width,
+                              size_t height, hdf5_pixel_format_t format, size_t row_pitch,
+                              size_t frame_bytes);
+
+/**
+ * @brief Dépose une image de séquence dans la file asynchrone
+ * @param logger Logger en mode asynchrone
+ * @param group_path Chemin du groupe
+ * @param stream_name Nom du dataset de la séquence
+ * @param pixel_data Pixels, recopiés sauf si done est fourni
+ * @param width Largeur
+ * @param height Hauteur
+ * @param channels Nombre de canaux
+ * @param dtype Type d'un canal
+ * @param view Sélection des pixels recopiés (NULL = image dense ; sans done seulement)
+ * @param done NULL pour recopier les pixels, sinon fonction qui rend les pixels empruntés
+ * @param user_data Donnée transmise à done
+ * @return 0 en cas de succès, -1 sinon (done n'est alors pas appelé)
+ */
+int async_submit_image_frame(hdf5_logger_t* logger, const char* group_path,
+                             const char* stream_name, const void* pixel_data, size_t width,
+                             size_t height, size_t channels, hdf5_dtype_t dtype,
+                             const source_view_t* view, hdf5_write_callback_t done,
+                             void* user_data);
+
+/**
+ * @brief Initialise la table des formats et charge ceux déjà internés dans le fichier
+ * @param logger Logger dont le fichier est ouvert
+ * @return 0 en cas de succès, -1 sinon (la table n'est alors pas à fermer)
+ */
+int format_table_open(hdf5_logger_t* logger);
+
+/**
+ * @brief Libère la table des formats
+ * @param logger Pointeur vers le logger
+ */
+void format_table_close(hdf5_logger_t* logger);
+
+/**
+ * @brief Écrit dans le dataset text_formats les formats internés depuis le dernier appel
+ * @param logger Pointeur vers le logger (appelant détenteur de io_lock)
+ * @return 0 en cas de succès, -1 sinon
+ */
+int format_table_sync(hdf5_logger_t* logger);
+
+/**
+ * @brief Interne un format et encode ses arguments en binaire, sans formater
+ * @param logger Pointeur vers le logger
+ * @param fmt Format de type printf (%n n'est pas accepté)
+ * @param args Arguments du format
+ * @param format_id Identifiant du format
+ * @param data Tampon initial en entrée ; en sortie, arguments encodés (allocation à libérer
+ *             par l'appelant si elle diffère du tampon initial)
+ * @param capacity Capacité du tampon initial
+ * @param length Nombre d'octets encodés
+ * @return 0 en cas de succès, -1 si le format est invalide ou en cas d'erreur
+ */
+int format_encode(hdf5_logger_t* logger, const char* fmt, va_list args, unsigned int* format_id,
+                  char** data, size_t capacity, size_t* length);
+
+/**
+ * @brief Reconstitue le message d'une entrée à formatage différé
+ * @param logger Pointeur vers le logger
+ * @param format_id Identifiant du format
+ * @param data Arguments encodés
+ * @param length Nombre d'octets de data
+ * @param buffer Tampon du message, agrandi si nécessaire (à libérer par l'appelant)
+ * @param capacity Capacité de buffer
+ * @return 0 en cas de succès, -1 sinon
+ */
+int format_render(hdf5_logger_t* logger, unsigned int format_id, const char* data, size_t length,
+                  char** buffer, size_t* capacity);
+
+#endif /* HDF5_LOGGER_INTERNAL_H */
@@ -0,0 +1,151 @@
+/**
+ * @file hdf5_logger_level.c
+ * @brief Filtrage des logs texte par niveau : seuil du logger et seuils des groupes
+ *
+ * Les seuils sont lus sans verrou par les appelants. Deux bornes résument
+ * l'ensemble des seuils en vigueur : un niveau inférieur au plus petit est
+ * rejeté, un niveau supérieur ou égal au plus grand est accepté, sans
+ * rechercher le groupe. La liste des seuils de groupes n'est parcourue que
+ * pour un niveau compris entre les deux. Les changements de seuil sont rares :
+ * ils sont sérialisés par un verrou et recalculent les bornes.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5_logger_internal.h"
+#include "hdf5_logger_platform.h"
+
+/* Ramène un niveau dans l'intervalle des niveaux définis */
+static int clamp_level(int level) {
+    if (level < HDF5_LOG_DEBUG) {
+        return HDF5_LOG_DEBUG;
+    }
+    if (level > HDF5_LOG_CRITICAL) {
+        return HDF5_LOG_CRITICAL;
+    }
+    return level;
+}
+
+/* Recalcule les bornes après un changement de seuil (sous levels.lock) */
+static void update_bounds(level_table_t* levels) {
+    int floor = levels->min_level;
+    int ceiling = levels->min_level;
+    for (group_level_t* group = levels->groups; group != NULL; group = group->next) {
+        if (group->level < floor) {
+            floor = group->level;
+        }
+        if (group->level > ceiling) {
+            ceiling = group->level;
+        }
+    }
+
+    /* Élargir d'abord, resserrer ensuite : un lecteur concurrent ne tranche jamais à tort */
+    if (floor < levels->floor) {
+        atomic_store_int(&levels->floor, floor);
+    }
+    if (ceiling > levels->ceiling) {
+        atomic_store_int(&levels->ceiling, ceiling);
+    }
+    atomic_store_int(&levels->floor, floor);
+    atomic_store_int(&levels->ceiling, ceiling);
+}
+
+static group_level_t* find_group(level_table_t* levels, const char* group_path) {
+    group_level_t* group = (group_level_t*)atomic_load_ptr((void* volatile*)&levels->groups);
+    for (; group != NULL; group = group->next) {
+        if (strcmp(group->group_path, group_path) == 0) {
+            return group;
+        }
+    }
+    return NULL;
+}
+
+int level_init(hdf5_logger_t* logger) {
+    level_table_t* levels = &logger->levels;
+
+    /* Tous les niveaux sont écrits tant qu'aucun seuil n'est fixé */
+    levels->floor = HDF5_LOG_DEBUG;
+    levels->ceiling = HDF5_LOG_DEBUG;
+    levels->min_level = HDF5_LOG_DEBUG;
+    levels->groups = NULL;
+    return logger_mutex_init(&levels->lock);
+}
+
+void level_destroy(hdf5_logger_t* logger) {
+    level_table_t* levels = &logger->levels;
+    group_level_t* group = levels->groups;
+    while (group != NULL) {
+        group_level_t* next = group->next;
+        free(group->group_path);
+        free(group);
+        group = next;
+    }
+    levels->groups = NULL;
+    logger_mutex_destroy(&levels->lock);
+}
+
+int level_group_enabled(hdf5_logger_t* logger, const char* group_path, int level) {
+    group_level_t* group = find_group(&logger->levels, group_path);
+    int threshold = (group != NULL) ? atomic_load_int(&group->level)
+                                    : atomic_load_int(&logger->levels.min_level);
+    return level >= threshold;
+}
+
+int hdf5_logger_set_min_level(hdf5_logger_t* logger, hdf5_log_level_t level) {
+    if (logger == NULL || !logger->is_open) {
+        return -1;
+    }
+
+    level_table_t* levels = &logger->levels;
+    logger_mutex_lock(&levels->lock);
+    atomic_store_int(&levels->min_level, clamp_level((int)level));
+    update_bounds(levels);
+    logger_mutex_unlock(&levels->lock);
+    return 0;
+}
+
+hdf5_log_level_t hdf5_logger_get_min_level(const hdf5_logger_t* logger) {
+    if (logger == NULL) {
+        return HDF5_LOG_DEBUG;
+    }
+    return (hdf5_log_level_t)atomic_load_int((volatile int*)&logger->levels.min_level);
+}
+
+int hdf5_logger_set_group_min_level(hdf5_logger_t* logger, const char* group_path,
+                                    hdf5_log_level_t level) {
+    if (logger == NULL || !logger->is_open || group_path == NULL) {
+        return -1;
+    }
+
+    level_table_t* levels = &logger->levels;
+    int status = 0;
+    logger_mutex_lock(&levels->lock);
+
+    group_level_t* group = find_group(levels, group_path);
+    if (group != NULL) {
+        atomic_store_int(&group->level, clamp_level((int)level));
+    } else {
+        /* Le seuil est complet avant d'être publié en tête de liste */
+        group = (group_level_t*)malloc(sizeof(group_level_t));
+        char* path = (group != NULL) ? strdup(group_path) : NULL;
+        if (path == NULL) {
+            free(group);
+            status = -1;
+        } else {
+            group->group_path = path;
+            group->level = clamp_level((int)level);
+            group->next = levels->groups;
+            atomic_store_ptr((void* volatile*)&levels->groups, group);
+        }
+    }
+
+    if (status == 0) {
+        update_bounds(levels);
+    }
+    logger_mutex_unlock(&levels->lock);
+    return status;
+}
+
+int hdf5_logger_is_enabled(const hdf5_logger_t* logger, hdf5_log_level_t level) {
+    return logger != NULL && (int)level >= atomic_load_int((volatile int*)&logger->levels.floor);
+}
@@ -0,0 +1,648 @@
+/**
+ * @file hdf5_logger_pixel.c
+ * @brief Disposition des canaux des images et conversion des formats de caméra
+ *
+ * Une image entrelacée mêle R, G et B octet par octet : le codec voit un
+ * signal qui saute d'un canal à l'autre et la prédiction compare des canaux
+ * différents. Stockée en plans ([canaux, hauteur, largeur]), chaque canal
+ * est une surface lisse. La séparation des plans traite 16 pixels à la fois :
+ * en SSSE3 (pshufb) pour 3 canaux de 8 bits quand le processeur le permet,
+ * en SSE2 pour 4 canaux ; les autres tailles passent par les boucles
+ * scalaires.
+ *
+ * Les formats de caméra (BGR, BGRA, YUYV, NV12, Bayer) sont convertis en
+ * plans R, G, B (et A), 16 pixels à la fois en SSE2. La conversion YUV suit
+ * BT.601 en plage limitée, avec des coefficients sur 6 bits ; le
+ * dématriçage Bayer est bilinéaire, les bords étant complétés par symétrie.
+ * Les boucles scalaires calculent exactement les mêmes valeurs.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXEL_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(PIXEL_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PIXEL_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+/* Couleurs d'une mosaïque de Bayer */
+enum { BAYER_R = 0, BAYER_G = 1, BAYER_B = 2 };
+
+/* Valeur d'un pixel dématricé : lue ou moyenne de voisins */
+enum { SOURCE_RAW, SOURCE_H, SOURCE_V, SOURCE_CROSS, SOURCE_DIAGONAL };
+
+/* Boucles scalaires sur les pixels [first, count) */
+#define DEINTERLEAVE_SCALAR(type)                                            \
+    do {                                                                     \
+        const type* s = (const type*)src;                                    \
+        for (size_t i = first; i < count; i++) {                             \
+            for (size_t k = 0; k < channels; k++) {                          \
+                ((type*)planes[k])[i] = s[i * channels + k];                 \
+            }                                                                \
+        }                                                                    \
+    } while (0)
+
+#define INTERLEAVE_SCALAR(type)                                              \
+    do {                                                                     \
+        type* d = (type*)dst;                                                \
+        for (size_t i = first; i < count; i++) {                             \
+            for (size_t k = 0; k < channels; k++) {                          \
+                d[i * channels + k] = ((const type*)planes[k])[i];           \
+            }                                                                \
+        }                                                                    \
+    } while (0)
+
+static void deinterleave_scalar(const void* src, void* const* planes, size_t first,
+                                size_t count, size_t channels, size_t element_size) {
+    switch (element_size) {
+        case 1: DEINTERLEAVE_SCALAR(uint8_t); break;
+        case 2: DEINTERLEAVE_SCALAR(uint16_t); break;
+        case 4: DEINTERLEAVE_SCALAR(uint32_t); break;
+        default: DEINTERLEAVE_SCALAR(uint64_t); break;
+    }
+}
+
+static void interleave_scalar(const void* const* planes, void* dst, size_t first, size_t count,
+                              size_t channels, size_t element_size) {
+    switch (element_size) {
+        case 1: INTERLEAVE_SCALAR(uint8_t); break;
+        case 2: INTERLEAVE_SCALAR(uint16_t); break;
+        case 4: INTERLEAVE_SCALAR(uint32_t); break;
+        default: INTERLEAVE_SCALAR(uint64_t); break;
+    }
+}
+
+static unsigned char clamp_u8(int value) {
+    return (unsigned char)((value < 0) ? 0 : (value > 255) ? 255 : value);
+}
+
+/* BT.601 plage limitée : R = 1,164 (Y - 16) + 1,596 (V - 128)..., coefficients x 64 */
+static void yuv_pixel(int y, int u, int v, unsigned char* r, unsigned char* g, unsigned char* b) {
+    int c = 74 * (y - 16) + 32;
+    int d = u - 128;
+    int e = v - 128;
+    *r = clamp_u8((c + 102 * e) >> 6);
+    *g = clamp_u8((c - 25 * d - 52 * e) >> 6);
+    *b = clamp_u8((c + 129 * d) >> 6);
+}
+
+static unsigned char average_u8(unsigned char a, unsigned char b) {
+    return (unsigned char)((a + b + 1) >> 1);
+}
+
+#ifdef PIXEL_SSE2
+
+/* 4 canaux de 8 bits : chaque pixel est un mot de 32 bits dont on isole les octets */
+static size_t deinterleave4_sse2(const unsigned char* src, unsigned char* const* planes,
+                                 size_t count) {
+    const __m128i low = _mm_set1_epi32(0xFF);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v[4];
+        for (int j = 0; j < 4; j++) {
+            v[j] = _mm_loadu_si128((const __m128i*)(src + 4 * i + 16 * j));
+        }
+        for (int k = 0; k < 4; k++) {
+            __m128i c[4];
+            for (int j = 0; j < 4; j++) {
+                c[j] = _mm_and_si128(_mm_srli_epi32(v[j], 8 * k), low);
+            }
+            __m128i packed = _mm_packus_epi16(_mm_packs_epi32(c[0], c[1]),
+                                              _mm_packs_epi32(c[2], c[3]));
+            _mm_storeu_si128((__m128i*)(planes[k] + i), packed);
+        }
+    }
+    return i;
+}
+
+static size_t interleave4_sse2(const unsigned char* const* planes, unsigned char* dst,
+                               size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i r = _mm_loadu_si128((const __m128i*)(planes[0] + i));
+        __m128i g = _mm_loadu_si128((const __m128i*)(planes[1] + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(planes[2] + i));
+        __m128i a = _mm_loadu_si128((const __m128i*)(planes[3] + i));
+        __m128i rg_low = _mm_unpacklo_epi8(r, g);
+        __m128i rg_high = _mm_unpackhi_epi8(r, g);
+        __m128i ba_low = _mm_unpacklo_epi8(b, a);
+        __m128i ba_high = _mm_unpackhi_epi8(b, a);
+        unsigned char* out = dst + 4 * i;
+        _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi16(rg_low, ba_low));
+        _mm_storeu_si128((__m128i*)(out + 16), _mm_unpackhi_epi16(rg_low, ba_low));
+        _mm_storeu_si128((__m128i*)(out + 32), _mm_unpacklo_epi16(rg_high, ba_high));
+        _mm_storeu_si128((__m128i*)(out + 48), _mm_unpackhi_epi16(rg_high, ba_high));
+    }
+    return i;
+}
+
+/* Conversion YUV sur 8 pixels en entiers de 16 bits, comme yuv_pixel ; les sommes saturées
+ * ne dépassent 16 bits que pour des valeurs ramenées à 255 de toute façon */
+static void yuv_sse2(__m128i y, __m128i u, __m128i v, __m128i* r, __m128i* g, __m128i* b) {
+    __m128i c = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(y, _mm_set1_epi16(16)),
+                                              _mm_set1_epi16(74)),
+                              _mm_set1_epi16(32));
+    __m128i d = _mm_sub_epi16(u, _mm_set1_epi16(128));
+    __m128i e = _mm_sub_epi16(v, _mm_set1_epi16(128));
+    *r = _mm_srai_epi16(_mm_adds_epi16(c, _mm_mullo_epi16(e, _mm_set1_epi16(102))), 6);
+    *g = _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(c, _mm_mullo_epi16(d, _mm_set1_epi16(-25))),
+                                       _mm_mullo_epi16(e, _mm_set1_epi16(-52))),
+                        6);
+    *b = _mm_srai_epi16(_mm_adds_epi16(c, _mm_mullo_epi16(d, _mm_set1_epi16(129))), 6);
+}
+
+/* Range 16 pixels calculés en deux moitiés de 8 dans les trois plans */
+static void yuv_store_sse2(__m128i y0, __m128i u0, __m128i v0, __m128i y1, __m128i u1,
+                           __m128i v1, unsigned char* r, unsigned char* g, unsigned char* b) {
+    __m128i r0, g0, b0, r1, g1, b1;
+    yuv_sse2(y0, u0, v0, &r0, &g0, &b0);
+    yuv_sse2(y1, u1, v1, &r1, &g1, &b1);
+    _mm_storeu_si128((__m128i*)r, _mm_packus_epi16(r0, r1));
+    _mm_storeu_si128((__m128i*)g, _mm_packus_epi16(g0, g1));
+    _mm_storeu_si128((__m128i*)b, _mm_packus_epi16(b0, b1));
+}
+
+/* Ligne YUYV : Y0 U Y1 V ; chaque U et V est dupliqué sur ses deux pixels */
+static size_t yuyv_row_sse2(const unsigned char* row, size_t width, unsigned char* r,
+                            unsigned char* g, unsigned char* b) {
+    const __m128i low = _mm_set1_epi16(0xFF);
+    const __m128i half = _mm_set1_epi32(0xFFFF);
+    size_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i p[2];
+        __m128i y[2];
+        __m128i u[2];
+        __m128i v[2];
+        for (int j = 0; j < 2; j++) {
+            p[j] = _mm_loadu_si128((const __m128i*)(row + 2 * x + 16 * j));
+            y[j] = _mm_and_si128(p[j], low);
+            __m128i uv = _mm_srli_epi16(p[j], 8);
+            u[j] = _mm_and_si128(uv, half);
+            u[j] = _mm_or_si128(u[j], _mm_slli_epi32(u[j], 16));
+            v[j] = _mm_srli_epi32(uv, 16);
+            v[j] = _mm_or_si128(v[j], _mm_slli_epi32(v[j], 16));
+        }
+        yuv_store_sse2(y[0], u[0], v[0], y[1], u[1], v[1], r + x, g + x, b + x);
+    }
+    return x;
+}
+
+/* Ligne NV12 : luminance d'une ligne, couples U V de la ligne de chrominance */
+static size_t nv12_row_sse2(const unsigned char* luma, const unsigned char* chroma,
+                            size_t width, unsigned char* r, unsigned char* g, unsigned char* b) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i low = _mm_set1_epi16(0xFF);
+    size_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i y = _mm_loadu_si128((const __m128i*)(luma + x));
+        __m128i uv = _mm_loadu_si128((const __m128i*)(chroma + x));
+        __m128i u = _mm_and_si128(uv, low);
+        __m128i v = _mm_srli_epi16(uv, 8);
+        yuv_store_sse2(_mm_unpacklo_epi8(y, zero), _mm_unpacklo_epi16(u, u),
+                       _mm_unpacklo_epi16(v, v), _mm_unpackhi_epi8(y, zero),
+                       _mm_unpackhi_epi16(u, u), _mm_unpackhi_epi16(v, v), r + x, g + x, b + x);
+    }
+    return x;
+}
+
+/* Dématriçage des colonnes [1, fin) d'une ligne, 16 à la fois ; sources[k][p] donne la valeur du
+ * plan k pour une colonne de parité p. Renvoie la première colonne non traitée */
+static size_t bayer_row_sse2(const unsigned char* up, const unsigned char* row,
+                             const unsigned char* down, size_t width, int sources[3][2],
+                             unsigned char* const* planes) {
+    /* Colonnes impaires sur les octets pairs (x part de 1) */
+    const __m128i odd = _mm_set1_epi16(0xFF);
+    size_t x = 1;
+    for (; x + 16 < width; x += 16) {
+        __m128i values[5];
+        values[SOURCE_RAW] = _mm_loadu_si128((const __m128i*)(row + x));
+        values[SOURCE_H] = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(row + x - 1)),
+                                        _mm_loadu_si128((const __m128i*)(row + x + 1)));
+        values[SOURCE_V] = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(up + x)),
+                                        _mm_loadu_si128((const __m128i*)(down + x)));
+        values[SOURCE_CROSS] = _mm_avg_epu8(values[SOURCE_H], values[SOURCE_V]);
+        values[SOURCE_DIAGONAL] = _mm_avg_epu8(
+            _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(up + x - 1)),
+                         _mm_loadu_si128((const __m128i*)(up + x + 1))),
+            _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(down + x - 1)),
+                         _mm_loadu_si128((const __m128i*)(down + x + 1))));
+        for (int k = 0; k < 3; k++) {
+            __m128i out = _mm_or_si128(_mm_and_si128(odd, values[sources[k][1]]),
+                                       _mm_andnot_si128(odd, values[sources[k][0]]));
+            _mm_storeu_si128((__m128i*)(planes[k] + x), out);
+        }
+    }
+    return x;
+}
+
+#endif /* PIXEL_SSE2 */
+
+#ifdef PIXEL_SSSE3
+
+/* Masques pshufb de 3 canaux : deinterleave[k][j] prend le canal k dans le vecteur source j,
+ * interleave[j][k] place le plan k dans le vecteur destination j */
+typedef struct {
+    __m128i deinterleave[3][3];
+    __m128i interleave[3][3];
+} shuffle3_t;
+
+static void shuffle3_init(shuffle3_t* masks) {
+    for (int k = 0; k < 3; k++) {
+        for (int j = 0; j < 3; j++) {
+            char split[16];
+            char merge[16];
+            for (int p = 0; p < 16; p++) {
+                int index = 3 * p + k;
+                split[p] = (char)((index / 16 == j) ? index % 16 : 0x80);
+                index = 16 * j + p;
+                merge[p] = (char)((index % 3 == k) ? index / 3 : 0x80);
+            }
+            masks->deinterleave[k][j] = _mm_loadu_si128((const __m128i*)split);
+            masks->interleave[j][k] = _mm_loadu_si128((const __m128i*)merge);
+        }
+    }
+}
+
+__attribute__((target("ssse3")))
+static size_t deinterleave3_ssse3(const unsigned char* src, unsigned char* const* planes,
+                                  size_t count) {
+    shuffle3_t masks;
+    shuffle3_init(&masks);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v[3];
+        for (int j = 0; j < 3; j++) {
+            v[j] = _mm_loadu_si128((const __m128i*)(src + 3 * i + 16 * j));
+        }
+        for (int k = 0; k < 3; k++) {
+            __m128i out = _mm_or_si128(
+                _mm_or_si128(_mm_shuffle_epi8(v[0], masks.deinterleave[k][0]),
+                             _mm_shuffle_epi8(v[1], masks.deinterleave[k][1])),
+                _mm_shuffle_epi8(v[2], masks.deinterleave[k][2]));
+            _mm_storeu_si128((__m128i*)(planes[k] + i), out);
+        }
+    }
+    return i;
+}
+
+__attribute__((target("ssse3")))
+static size_t interleave3_ssse3(const unsigned char* const* planes, unsigned char* dst,
+                                size_t count) {
+    shuffle3_t masks;
+    shuffle3_init(&masks);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v[3];
+        for (int k = 0; k < 3; k++) {
+            v[k] = _mm_loadu_si128((const __m128i*)(planes[k] + i));
+        }
+        for (int j = 0; j < 3; j++) {
+            __m128i out = _mm_or_si128(
+                _mm_or_si128(_mm_shuffle_epi8(v[0], masks.interleave[j][0]),
+                             _mm_shuffle_epi8(v[1], masks.interleave[j][1])),
+                _mm_shuffle_epi8(v[2], masks.interleave[j][2]));
+            _mm_storeu_si128((__m128i*)(dst + 3 * i + 16 * j), out);
+        }
+    }
+    return i;
+}
+
+/* Détecté une fois : la réponse ne change pas pendant la vie du processus */
+static int has_ssse3(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("ssse3") ? 1 : 0;
+    }
+    return cached;
+}
+
+#endif /* PIXEL_SSSE3 */
+
+void pixels_deinterleave(const void* src, void* const* planes, size_t count, size_t channels,
+                         size_t element_size) {
+    size_t first = 0;
+#if defined(PIXEL_SSSE3)
+    if (element_size == 1 && channels == 3 && has_ssse3()) {
+        first = deinterleave3_ssse3((const unsigned char*)src, (unsigned char* const*)planes,
+                                    count);
+    }
+#endif
+#if defined(PIXEL_SSE2)
+    if (element_size == 1 && channels == 4) {
+        first = deinterleave4_sse2((const unsigned char*)src, (unsigned char* const*)planes,
+                                   count);
+    }
+#endif
+    deinterleave_scalar(src, planes, first, count, channels, element_size);
+}
+
+void pixels_interleave(const void* const* planes, void* dst, size_t count, size_t channels,
+                       size_t element_size) {
+    size_t first = 0;
+#if defined(PIXEL_SSSE3)
+    if (element_size == 1 && channels == 3 && has_ssse3()) {
+        first = interleave3_ssse3((const unsigned char* const*)planes, (unsigned char*)dst,
+                                  count);
+    }
+#endif
+#if defined(PIXEL_SSE2)
+    if (element_size == 1 && channels == 4) {
+        first = interleave4_sse2((const unsigned char* const*)planes, (unsigned char*)dst,
+                                 count);
+    }
+#endif
+    interleave_scalar(planes, dst, first, count, channels, element_size);
+}
+
+size_t pixel_format_channels(hdf5_pixel_format_t format) {
+    switch (format) {
+        case HDF5_PIXEL_BGRA8:
+            return 4;
+        case HDF5_PIXEL_BGR8:
+        case HDF5_PIXEL_YUYV:
+        case HDF5_PIXEL_NV12:
+        case HDF5_PIXEL_BAYER_RGGB:
+        case HDF5_PIXEL_BAYER_BGGR:
+        case HDF5_PIXEL_BAYER_GRBG:
+        case HDF5_PIXEL_BAYER_GBRG:
+            return 3;
+    }
+    return 0;
+}
+
+size_t pixel_frame_bytes(hdf5_pixel_format_t format, size_t width, size_t height,
+                         size_t row_pitch) {
+    /* Octets d'une ligne et lignes du tampon (NV12 : plan Y puis une ligne UV pour deux) */
+    size_t row_bytes;
+    size_t rows = height;
+    switch (format) {
+        case HDF5_PIXEL_BGR8:
+            row_bytes = width * 3;
+            break;
+        case HDF5_PIXEL_BGRA8:
+            row_bytes = width * 4;
+            break;
+        case HDF5_PIXEL_YUYV:
+            if (width % 2 != 0) {
+                return 0;
+            }
+            row_bytes = width * 2;
+            break;
+        case HDF5_PIXEL_NV12:
+            if (width % 2 != 0 || height % 2 != 0) {
+                return 0;
+            }
+            row_bytes = width;
+            rows = height + height / 2;
+            break;
+        case HDF5_PIXEL_BAYER_RGGB:
+        case HDF5_PIXEL_BAYER_BGGR:
+        case HDF5_PIXEL_BAYER_GRBG:
+        case HDF5_PIXEL_BAYER_GBRG:
+            if (width < 2 || height < 2) {
+                return 0;
+            }
+            row_bytes = width;
+            break;
+        default:
+            return 0;
+    }
+    if (width == 0 || height == 0 || (row_pitch != 0 && row_pitch < row_bytes)) {
+        return 0;
+    }
+    size_t pitch = (row_pitch != 0) ? row_pitch : row_bytes;
+    return (rows - 1) * pitch + row_bytes;
+}
+
+/* Couleurs de la mosaïque selon la parité de la ligne et de la colonne */
+static const int* bayer_pattern(hdf5_pixel_format_t format) {
+    static const int patterns[4][4] = {
+        {BAYER_R, BAYER_G, BAYER_G, BAYER_B},
+        {BAYER_B, BAYER_G, BAYER_G, BAYER_R},
+        {BAYER_G, BAYER_R, BAYER_B, BAYER_G},
+        {BAYER_G, BAYER_B, BAYER_R, BAYER_G}
+    };
+    return patterns[format - HDF5_PIXEL_BAYER_RGGB];
+}
+
+/* Valeur du plan k sur un site de couleur site, dont les voisins horizontaux sont de couleur
+ * across : le site lui-même, la moyenne de deux voisins du même axe, ou de quatre */
+static int bayer_source(int k, int site, int across) {
+    if (k == site) {
+        return SOURCE_RAW;
+    }
+    if (site == BAYER_G) {
+        return (k == across) ? SOURCE_H : SOURCE_V;
+    }
+    return (k == BAYER_G) ? SOURCE_CROSS : SOURCE_DIAGONAL;
+}
+
+/* Colonne voisine, complétée par symétrie au bord (même parité que l'intérieur) */
+static size_t mirror(size_t index, int step, size_t size) {
+    if (step < 0) {
+        return (index == 0) ? 1 : index - 1;
+    }
+    return (index + 1 == size) ? size - 2 : index + 1;
+}
+
+static void bayer_pixel(const unsigned char* up, const unsigned char* row,
+                        const unsigned char* down, size_t x, size_t width, int sources[3][2],
+                        unsigned char* const* planes) {
+    size_t left = mirror(x, -1, width);
+    size_t right = mirror(x, 1, width);
+    unsigned char values[5];
+    values[SOURCE_RAW] = row[x];
+    values[SOURCE_H] = average_u8(row[left], row[right]);
+    values[SOURCE_V] = average_u8(up[x], down[x]);
+    values[SOURCE_CROSS] = average_u8(values[SOURCE_H], values[SOURCE_V]);
+    values[SOURCE_DIAGONAL] = average_u8(average_u8(up[left], up[right]),
+                                         average_u8(down[left], down[right]));
+    for (int k = 0; k < 3; k++) {
+        planes[k][x] = values[sources[k][x & 1]];
+    }
+}
+
+static void convert_bayer(const unsigned char* frame, size_t width, size_t height, size_t pitch,
+                          hdf5_pixel_format_t format, unsigned char* const* planes) {
+    const int* pattern = bayer_pattern(format);
+    for (size_t y = 0; y < height; y++) {
+        const unsigned char* row = frame + y * pitch;
+        const unsigned char* up = frame + mirror(y, -1, height) * pitch;
+        const unsigned char* down = frame + mirror(y, 1, height) * pitch;
+        unsigned char* out[3];
+        int sources[3][2];
+        for (int k = 0; k < 3; k++) {
+            out[k] = planes[k] + y * width;
+            for (int parity = 0; parity < 2; parity++) {
+                sources[k][parity] = bayer_source(k, pattern[(y & 1) * 2 + parity],
+                                                  pattern[(y & 1) * 2 + (1 - parity)]);
+            }
+        }
+
+        bayer_pixel(up, row, down, 0, width, sources, out);
+        size_t x = 1;
+#if defined(PIXEL_SSE2)
+        x = bayer_row_sse2(up, row, down, width, sources, out);
+#endif
+        for (; x < width; x++) {
+            bayer_pixel(up, row, down, x, width, sources, out);
+        }
+    }
+}
+
+int pixels_convert(const void* frame, size_t width, size_t height, size_t row_pitch,
+                   hdf5_pixel_format_t format, void* planes) {
+    size_t channels = pixel_format_channels(format);
+    if (channels == 0 || pixel_frame_bytes(format, width, height, row_pitch) == 0) {
+        return -1;
+    }
+
+    const unsigned char* src = (const unsigned char*)frame;
+    size_t area = width * height;
+    unsigned char* plane[4];
+    for (size_t k = 0; k < channels; k++) {
+        plane[k] = (unsigned char*)planes + k * area;
+    }
+
+    switch (format) {
+        case HDF5_PIXEL_BGR8:
+        case HDF5_PIXEL_BGRA8: {
+            size_t pitch = (row_pitch != 0) ? row_pitch : width * channels;
+            for (size_t y = 0; y < height; y++) {
+                /* B et R échangés : le canal 0 lu va dans le plan 2 */
+                void* rows[4] = {plane[2] + y * width, plane[1] + y * width,
+                                 plane[0] + y * width, (channels == 4) ? plane[3] + y * width
+                                                                       : NULL};
+                pixels_deinterleave(src + y * pitch, rows, width, channels, 1);
+            }
+            break;
+        }
+        case HDF5_PIXEL_YUYV: {
+            size_t pitch = (row_pitch != 0) ? row_pitch : width * 2;
+            for (size_t y = 0; y < height; y++) {
+                const unsigned char* row = src + y * pitch;
+                unsigned char* r = plane[0] + y * width;
+                unsigned char* g = plane[1] + y * width;
+                unsigned char* b = plane[2] + y * width;
+                size_t x = 0;
+#if defined(PIXEL_SSE2)
+                x = yuyv_row_sse2(row, width, r, g, b);
+#endif
+                for (; x < width; x++) {
+                    yuv_pixel(row[2 * x], row[4 * (x / 2) + 1], row[4 * (x / 2) + 3], &r[x],
+                              &g[x], &b[x]);
+                }
+            }
+            break;
+        }
+        case HDF5_PIXEL_NV12: {
+            size_t pitch = (row_pitch != 0) ? row_pitch : width;
+            const unsigned char* chroma_plane = src + height * pitch;
+            for (size_t y = 0; y < height; y++) {
+                const unsigned char* luma = src + y * pitch;
+                const unsigned char* chroma = chroma_plane + (y / 2) * pitch;
+                unsigned char* r = plane[0] + y * width;
+                unsigned char* g = plane[1] + y * width;
+                unsigned char* b = plane[2] + y * width;
+                size_t x = 0;
+#if defined(PIXEL_SSE2)
+                x = nv12_row_sse2(luma, chroma, width, r, g, b);
+#endif
+                for (; x < width; x++) {
+                    yuv_pixel(luma[x], chroma[x & ~(size_t)1], chroma[x | 1], &r[x], &g[x],
+                              &b[x]);
+                }
+            }
+            break;
+        }
+        default:
+            convert_bayer(src, width, height, (row_pitch != 0) ? row_pitch : width, format,
+                          plane);
+            break;
+    }
+    return (int)channels;
+}
+
+/* Disposition des images d'un groupe */
+
+hdf5_image_layout_t image_layout_resolve(hdf5_logger_t* logger, const char* group_path) {
+    for (image_layout_override_t* override = logger->image_layouts; override != NULL;
+         override = override->next) {
+        if (strcmp(override->group_path, group_path) == 0) {
+            return override->layout;
+        }
+    }
+    return HDF5_IMAGE_INTERLEAVED;
+}
+
+void image_layout_destroy(hdf5_logger_t* logger) {
+    image_layout_override_t* override = logger->image_layouts;
+    while (override != NULL) {
+        image_layout_override_t* next = override->next;
+        free(override->group_path);
+        free(override);
+        override = next;
+    }
+    logger->image_layouts = NULL;
+}
+
+static int set_image_layout(hdf5_logger_t* logger, const char* group_path,
+                            hdf5_image_layout_t layout) {
+    if (logger == NULL || !logger->is_open || group_path == NULL ||
+        (layout != HDF5_IMAGE_INTERLEAVED && layout != HDF5_IMAGE_PLANAR)) {
+        return -1;
+    }
+
+    image_layout_override_t** link = &logger->image_layouts;
+    while (*link != NULL && strcmp((*link)->group_path, group_path) != 0) {
+        link = &(*link)->next;
+    }
+
+    /* Disposition par défaut : le réglage du groupe est retiré */
+    if (layout == HDF5_IMAGE_INTERLEAVED) {
+        if (*link != NULL) {
+            image_layout_override_t* override = *link;
+            *link = override->next;
+            free(override->group_path);
+            free(override);
+        }
+        return 0;
+    }
+
+    if (*link == NULL) {
+        image_layout_override_t* override =
+            (image_layout_override_t*)calloc(1, sizeof(image_layout_override_t));
+        char* path = (override != NULL) ? strdup(group_path) : NULL;
+        if (path == NULL) {
+            free(override);
+            return -1;
+        }
+        override->group_path = path;
+        *link = override;
+    }
+    (*link)->layout = layout;
+    return 0;
+}
+
+/* Implémentation des fonctions publiques */
+
+int hdf5_logger_set_image_layout(hdf5_logger_t* logger, const char* group_path,
+                                 hdf5_image_layout_t layout) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+
+    int status = set_image_layout(logger, group_path, layout);
+
+    logger_unlock(logger);
+    return status;
+}
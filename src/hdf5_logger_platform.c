@@ -0,0 +1,196 @@
+/**
+ * @file hdf5_logger_platform.c
+ * @brief Threads, verrous et conditions : implémentations POSIX et Windows
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include "hdf5_logger_platform.h"
+
+/* Fonction et argument transmis au nouveau thread */
+typedef struct {
+    logger_thread_func_t func;
+    void* arg;
+} thread_start_t;
+
+#ifdef _WIN32
+
+static DWORD WINAPI thread_entry(LPVOID param) {
+    thread_start_t start = *(thread_start_t*)param;
+    free(param);
+    start.func(start.arg);
+    return 0;
+}
+
+int logger_thread_start(logger_thread_t* thread, logger_thread_func_t func, void* arg) {
+    thread_start_t* start = (thread_start_t*)malloc(sizeof(thread_start_t));
+    if (start == NULL) {
+        return -1;
+    }
+    start->func = func;
+    start->arg = arg;
+
+    *thread = CreateThread(NULL, 0, thread_entry, start, 0, NULL);
+    if (*thread == NULL) {
+        free(start);
+        return -1;
+    }
+    return 0;
+}
+
+void logger_thread_join(logger_thread_t thread) {
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+int logger_mutex_init(logger_mutex_t* mutex) {
+    InitializeCriticalSection(mutex);
+    return 0;
+}
+
+void logger_mutex_destroy(logger_mutex_t* mutex) {
+    DeleteCriticalSection(mutex);
+}
+
+void logger_mutex_lock(logger_mutex_t* mutex) {
+    EnterCriticalSection(mutex);
+}
+
+int logger_mutex_trylock(logger_mutex_t* mutex) {
+    return TryEnterCriticalSection(mutex) ? 1 : 0;
+}
+
+void logger_mutex_unlock(logger_mutex_t* mutex) {
+    LeaveCriticalSection(mutex);
+}
+
+int logger_cond_init(logger_cond_t* cond) {
+    InitializeConditionVariable(cond);
+    return 0;
+}
+
+void logger_cond_destroy(logger_cond_t* cond) {
+    (void)cond;
+}
+
+void logger_cond_signal(logger_cond_t* cond) {
+    WakeConditionVariable(cond);
+}
+
+void logger_cond_broadcast(logger_cond_t* cond) {
+    WakeAllConditionVariable(cond);
+}
+
+void logger_cond_timedwait(logger_cond_t* cond, logger_mutex_t* mutex, double timeout_seconds) {
+    SleepConditionVariableCS(cond, mutex, (DWORD)(timeout_seconds * 1000.0));
+}
+
+static BOOL CALLBACK once_entry(PINIT_ONCE once, PVOID param, PVOID* context) {
+    (void)once;
+    (void)context;
+    ((void (*)(void))param)();
+    return TRUE;
+}
+
+void logger_once(logger_once_t* once, void (*func)(void)) {
+    InitOnceExecuteOnce(once, once_entry, (PVOID)func, NULL);
+}
+
+/* Les données propres aux fibres appellent leur destructeur à la sortie du thread */
+int logger_key_create(logger_key_t* key, logger_key_destructor_t destructor) {
+    *key = FlsAlloc(destructor);
+    return (*key == FLS_OUT_OF_INDEXES) ? -1 : 0;
+}
+
+int logger_key_set(logger_key_t key, void* value) {
+    return FlsSetValue(key, value) ? 0 : -1;
+}
+
+#else
+
+static void* thread_entry(void* param) {
+    thread_start_t start = *(thread_start_t*)param;
+    free(param);
+    start.func(start.arg);
+    return NULL;
+}
+
+int logger_thread_start(logger_thread_t* thread, logger_thread_func_t func, void* arg) {
+    thread_start_t* start = (thread_start_t*)malloc(sizeof(thread_start_t));
+    if (start == NULL) {
+        return -1;
+    }
+    start->func = func;
+    start->arg = arg;
+
+    if (pthread_create(thread, NULL, thread_entry, start) != 0) {
+        free(start);
+        return -1;
+    }
+    return 0;
+}
+
+void logger_thread_join(logger_thread_t thread) {
+    pthread_join(thread, NULL);
+}
+
+int logger_mutex_init(logger_mutex_t* mutex) {
+    return (pthread_mutex_init(mutex, NULL) == 0) ? 0 : -1;
+}
+
+void logger_mutex_destroy(logger_mutex_t* mutex) {
+    pthread_mutex_destroy(mutex);
+}
+
+void logger_mutex_lock(logger_mutex_t* mutex) {
+    pthread_mutex_lock(mutex);
+}
+
+int logger_mutex_trylock(logger_mutex_t* mutex) {
+    return (pthread_mutex_trylock(mutex) == 0) ? 1 : 0;
+}
+
+void logger_mutex_unlock(logger_mutex_t* mutex) {
+    pthread_mutex_unlock(mutex);
+}
+
+int logger_cond_init(logger_cond_t* cond) {
+    return (pthread_cond_init(cond, NULL) == 0) ? 0 : -1;
+}
+
+void logger_cond_destroy(logger_cond_t* cond) {
+    pthread_cond_destroy(cond);
+}
+
+void logger_cond_signal(logger_cond_t* cond) {
+    pthread_cond_signal(cond);
+}
+
+void logger_cond_broadcast(logger_cond_t* cond) {
+    pthread_cond_broadcast(cond);
+}
+
+void logger_cond_timedwait(logger_cond_t* cond, logger_mutex_t* mutex, double timeout_seconds) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+
+    long long nanoseconds = deadline.tv_nsec + (long long)(timeout_seconds * 1e9);
+    deadline.tv_sec += (time_t)(nanoseconds / 1000000000LL);
+    deadline.tv_nsec = (long)(nanoseconds % 1000000000LL);
+
+    pthread_cond_timedwait(cond, mutex, &deadline);
+}
+
+void logger_once(logger_once_t* once, void (*func)(void)) {
+    pthread_once(once, func);
+}
+
+int logger_key_create(logger_key_t* key, logger_key_destructor_t destructor) {
+    return (pthread_key_create(key, destructor) == 0) ? 0 : -1;
+}
+
+int logger_key_set(logger_key_t key, void* value) {
+    return (pthread_setspecific(key, value) == 0) ? 0 : -1;
+}
+
+#endif
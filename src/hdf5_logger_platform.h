@@ -0,0 +1,186 @@
+/**
+ * @file hdf5_logger_platform.h
+ * @brief Couche de portabilité : threads, verrous et opérations atomiques
+ */
+
+#ifndef HDF5_LOGGER_PLATFORM_H
+#define HDF5_LOGGER_PLATFORM_H
+
+#include <stddef.h>
+
+#ifdef _WIN32
+#include <windows.h>
+typedef HANDLE logger_thread_t;
+typedef CRITICAL_SECTION logger_mutex_t;
+typedef CONDITION_VARIABLE logger_cond_t;
+typedef DWORD logger_key_t;
+typedef INIT_ONCE logger_once_t;
+#define LOGGER_ONCE_INIT INIT_ONCE_STATIC_INIT
+#define LOGGER_KEY_CALLBACK WINAPI
+#else
+#include <pthread.h>
+typedef pthread_t logger_thread_t;
+typedef pthread_mutex_t logger_mutex_t;
+typedef pthread_cond_t logger_cond_t;
+typedef pthread_key_t logger_key_t;
+typedef pthread_once_t logger_once_t;
+#define LOGGER_ONCE_INIT PTHREAD_ONCE_INIT
+#define LOGGER_KEY_CALLBACK
+#endif
+
+/* Variable propre à chaque thread */
+#if defined(_MSC_VER)
+#define LOGGER_THREAD_LOCAL __declspec(thread)
+#else
+#define LOGGER_THREAD_LOCAL __thread
+#endif
+
+/* Taille d'une ligne de cache, pour séparer les compteurs très sollicités */
+#define LOGGER_CACHE_LINE 64
+
+/* Fonction exécutée par un thread */
+typedef void (*logger_thread_func_t)(void* arg);
+
+/**
+ * @brief Démarre un thread
+ * @param thread Thread créé
+ * @param func Fonction exécutée
+ * @param arg Argument transmis à func
+ * @return 0 en cas de succès, -1 sinon
+ */
+int logger_thread_start(logger_thread_t* thread, logger_thread_func_t func, void* arg);
+
+/**
+ * @brief Attend la fin d'un thread
+ * @param thread Thread à attendre
+ */
+void logger_thread_join(logger_thread_t thread);
+
+/* Verrous et conditions : les fonctions d'initialisation renvoient 0 en cas de succès */
+int logger_mutex_init(logger_mutex_t* mutex);
+void logger_mutex_destroy(logger_mutex_t* mutex);
+void logger_mutex_lock(logger_mutex_t* mutex);
+int logger_mutex_trylock(logger_mutex_t* mutex); /* 1 si le verrou a été pris */
+void logger_mutex_unlock(logger_mutex_t* mutex);
+
+int logger_cond_init(logger_cond_t* cond);
+void logger_cond_destroy(logger_cond_t* cond);
+void logger_cond_signal(logger_cond_t* cond);
+void logger_cond_broadcast(logger_cond_t* cond);
+
+/**
+ * @brief Attend un signal sur une condition, au plus timeout_seconds
+ * @param cond Condition attendue
+ * @param mutex Verrou tenu par l'appelant, relâché pendant l'attente
+ * @param timeout_seconds Durée maximale d'attente
+ */
+void logger_cond_timedwait(logger_cond_t* cond, logger_mutex_t* mutex, double timeout_seconds);
+
+/**
+ * @brief Exécute func une seule fois pour tout le processus, quel que soit le nombre d'appelants
+ * @param once Jeton initialisé à LOGGER_ONCE_INIT
+ * @param func Fonction exécutée
+ */
+void logger_once(logger_once_t* once, void (*func)(void));
+
+/* Fonction appelée à la sortie d'un thread avec la valeur non nulle de sa clé */
+typedef void (LOGGER_KEY_CALLBACK* logger_key_destructor_t)(void* value);
+
+/**
+ * @brief Crée une clé de valeur propre à chaque thread
+ * @param key Clé créée
+ * @param destructor Fonction appelée à la sortie de chaque thread dont la valeur n'est pas nulle
+ * @return 0 en cas de succès, -1 sinon
+ */
+int logger_key_create(logger_key_t* key, logger_key_destructor_t destructor);
+
+/**
+ * @brief Fixe la valeur de la clé pour le thread appelant
+ * @param key Clé créée par logger_key_create
+ * @param value Valeur transmise au destructeur à la sortie du thread
+ * @return 0 en cas de succès, -1 sinon
+ */
+int logger_key_set(logger_key_t key, void* value);
+
+/* Opérations atomiques séquentiellement cohérentes sur int, size_t, unsigned long long
+ * et pointeurs */
+#if defined(_MSC_VER)
+#include <intrin.h>
+#if defined(_WIN64)
+#define LOGGER_INTERLOCKED_SIZE(name) name##64
+#define LOGGER_SIZE_CAST __int64
+#else
+#define LOGGER_INTERLOCKED_SIZE(name) name
+#define LOGGER_SIZE_CAST long
+#endif
+
+static __inline int atomic_load_int(volatile int* p) {
+    return (int)_InterlockedOr((volatile long*)p, 0);
+}
+static __inline void atomic_store_int(volatile int* p, int v) {
+    _InterlockedExchange((volatile long*)p, (long)v);
+}
+static __inline void* atomic_load_ptr(void* volatile* p) {
+    return _InterlockedCompareExchangePointer(p, NULL, NULL);
+}
+static __inline void atomic_store_ptr(void* volatile* p, void* v) {
+    _InterlockedExchangePointer(p, v);
+}
+static __inline size_t atomic_load_size(volatile size_t* p) {
+    return (size_t)LOGGER_INTERLOCKED_SIZE(_InterlockedOr)((volatile LOGGER_SIZE_CAST*)p, 0);
+}
+static __inline void atomic_store_size(volatile size_t* p, size_t v) {
+    LOGGER_INTERLOCKED_SIZE(_InterlockedExchange)((volatile LOGGER_SIZE_CAST*)p, (LOGGER_SIZE_CAST)v);
+}
+static __inline int atomic_cas_size(volatile size_t* p, size_t expected, size_t desired) {
+    return LOGGER_INTERLOCKED_SIZE(_InterlockedCompareExchange)(
+               (volatile LOGGER_SIZE_CAST*)p, (LOGGER_SIZE_CAST)desired,
+               (LOGGER_SIZE_CAST)expected) == (LOGGER_SIZE_CAST)expected;
+}
+static __inline size_t atomic_add_size(volatile size_t* p, size_t v) {
+    return (size_t)LOGGER_INTERLOCKED_SIZE(_InterlockedExchangeAdd)((volatile LOGGER_SIZE_CAST*)p,
+                                                                    (LOGGER_SIZE_CAST)v);
+}
+static __inline unsigned long long atomic_load_u64(volatile unsigned long long* p) {
+    return (unsigned long long)_InterlockedOr64((volatile __int64*)p, 0);
+}
+static __inline unsigned long long atomic_add_u64(volatile unsigned long long* p,
+                                                  unsigned long long v) {
+    return (unsigned long long)_InterlockedExchangeAdd64((volatile __int64*)p, (__int64)v);
+}
+#else
+static inline int atomic_load_int(volatile int* p) {
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+static inline void atomic_store_int(volatile int* p, int v) {
+    __atomic_store_n(p, v, __ATOMIC_SEQ_CST);
+}
+static inline void* atomic_load_ptr(void* volatile* p) {
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+static inline void atomic_store_ptr(void* volatile* p, void* v) {
+    __atomic_store_n(p, v, __ATOMIC_SEQ_CST);
+}
+static inline size_t atomic_load_size(volatile size_t* p) {
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+static inline void atomic_store_size(volatile size_t* p, size_t v) {
+    __atomic_store_n(p, v, __ATOMIC_SEQ_CST);
+}
+static inline int atomic_cas_size(volatile size_t* p, size_t expected, size_t desired) {
+    return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_SEQ_CST,
+                                       __ATOMIC_SEQ_CST);
+}
+static inline size_t atomic_add_size(volatile size_t* p, size_t v) {
+    return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST);
+}
+static inline unsigned long long atomic_load_u64(volatile unsigned long long* p) {
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+static inline unsigned long long atomic_add_u64(volatile unsigned long long* p,
+                                                unsigned long long v) {
+    return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST);
+}
+#endif
+
+#endif /* HDF5_LOGGER_PLATFORM_H */
@@ -0,0 +1,167 @@
+/**
+ * @file hdf5_logger_pool.c
+ * @brief Groupe de threads de compression : exécute en parallèle les tâches d'un lot
+ *
+ * Un seul lot est en cours à la fois (pool_run est appelé sous io_lock). Les
+ * tâches sont distribuées une par une : chacune compresse un chunk entier, le
+ * coût de la distribution sous verrou est négligeable devant elle. Le thread
+ * appelant participe au lot au lieu d'attendre.
+ */
+
+#include <stdlib.h>
+#include "hdf5_logger_internal.h"
+#include "hdf5_logger_platform.h"
+
+/* Attente maximale d'un thread inactif avant de revérifier l'arrêt (s) */
+#define POOL_IDLE_WAIT 1.0
+
+struct compress_pool_s {
+    logger_thread_t* threads;  /* Threads de travail */
+    size_t thread_count;       /* Nombre de threads de travail */
+    logger_mutex_t lock;       /* Protège l'état du lot */
+    logger_cond_t work_cond;   /* Signalée quand un lot commence ou à l'arrêt */
+    logger_cond_t done_cond;   /* Signalée quand la dernière tâche d'un lot se termine */
+    int stopping;              /* Arrêt demandé */
+
+    /* Lot en cours */
+    pool_task_t task;          /* Fonction exécutée pour chaque tâche (NULL = aucun lot) */
+    void* arg;                 /* Argument transmis à task */
+    size_t count;              /* Nombre de tâches du lot */
+    size_t next;               /* Prochaine tâche à distribuer */
+    size_t done;               /* Tâches terminées */
+};
+
+/* Prend la prochaine tâche du lot en cours ; verrou tenu, renvoie 0 s'il n'en reste pas */
+static int pool_take(compress_pool_t* pool, size_t* index) {
+    if (pool->task == NULL || pool->next >= pool->count) {
+        return 0;
+    }
+    *index = pool->next++;
+    return 1;
+}
+
+/* Exécute une tâche hors verrou puis la compte ; verrou tenu à l'entrée et à la sortie */
+static void pool_execute(compress_pool_t* pool, size_t index) {
+    pool_task_t task = pool->task;
+    void* arg = pool->arg;
+
+    logger_mutex_unlock(&pool->lock);
+    task(arg, index);
+    logger_mutex_lock(&pool->lock);
+
+    if (++pool->done == pool->count) {
+        logger_cond_signal(&pool->done_cond);
+    }
+}
+
+static void pool_worker(void* arg) {
+    compress_pool_t* pool = (compress_pool_t*)arg;
+
+    logger_mutex_lock(&pool->lock);
+    while (!pool->stopping) {
+        size_t index;
+        if (pool_take(pool, &index)) {
+            pool_execute(pool, index);
+        } else {
+            logger_cond_timedwait(&pool->work_cond, &pool->lock, POOL_IDLE_WAIT);
+        }
+    }
+    logger_mutex_unlock(&pool->lock);
+}
+
+compress_pool_t* pool_start(size_t thread_count) {
+    compress_pool_t* pool = (compress_pool_t*)calloc(1, sizeof(compress_pool_t));
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    pool->threads = (logger_thread_t*)calloc(thread_count, sizeof(logger_thread_t));
+    if (pool->threads == NULL) {
+        free(pool);
+        return NULL;
+    }
+    if (logger_mutex_init(&pool->lock) != 0) {
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+    if (logger_cond_init(&pool->work_cond) != 0) {
+        logger_mutex_destroy(&pool->lock);
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+    if (logger_cond_init(&pool->done_cond) != 0) {
+        logger_cond_destroy(&pool->work_cond);
+        logger_mutex_destroy(&pool->lock);
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+
+    for (; pool->thread_count < thread_count; pool->thread_count++) {
+        if (logger_thread_start(&pool->threads[pool->thread_count], pool_worker, pool) < 0) {
+            pool_stop(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+void pool_stop(compress_pool_t* pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    logger_mutex_lock(&pool->lock);
+    pool->stopping = 1;
+    logger_cond_broadcast(&pool->work_cond);
+    logger_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->thread_count; i++) {
+        logger_thread_join(pool->threads[i]);
+    }
+
+    logger_cond_destroy(&pool->done_cond);
+    logger_cond_destroy(&pool->work_cond);
+    logger_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool);
+}
+
+size_t pool_size(const compress_pool_t* pool) {
+    return (pool != NULL) ? pool->thread_count + 1 : 1;
+}
+
+void pool_run(compress_pool_t* pool, size_t count, pool_task_t task, void* arg) {
+    if (count == 0) {
+        return;
+    }
+
+    /* Sans thread de travail, le lot est exécuté sur place */
+    if (pool == NULL) {
+        for (size_t i = 0; i < count; i++) {
+            task(arg, i);
+        }
+        return;
+    }
+
+    logger_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->arg = arg;
+    pool->count = count;
+    pool->next = 0;
+    pool->done = 0;
+    logger_cond_broadcast(&pool->work_cond);
+
+    size_t index;
+    while (pool_take(pool, &index)) {
+        pool_execute(pool, index);
+    }
+    while (pool->done < pool->count) {
+        logger_cond_timedwait(&pool->done_cond, &pool->lock, POOL_IDLE_WAIT);
+    }
+
+    pool->task = NULL;
+    logger_mutex_unlock(&pool->lock);
+}
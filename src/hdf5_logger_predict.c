@@ -0,0 +1,763 @@
+/**
+ * @file hdf5_logger_predict.c
+ * @brief Filtre de prédiction : écart ou ou exclusif avec l'élément précédent
+ *
+ * Un signal qui varie lentement se compresse mal tel quel : les octets de
+ * poids faible des flottants semblent aléatoires. Remplacer chaque élément
+ * par sa différence (entiers) ou son ou exclusif (flottants, comme Gorilla)
+ * avec le précédent laisse surtout des octets nuls, que le réarrangement
+ * regroupe avant le codec. Le filtre est placé en tête du pipeline HDF5 ;
+ * ses paramètres (prédiction, taille d'un élément) sont stockés avec le
+ * dataset, qui reste lisible par tout programme ayant enregistré le filtre.
+ * L'écart est calculé sur les éléments dans l'ordre des octets du fichier,
+ * celui de la machine qui écrit ; le ou exclusif n'en dépend pas.
+ *
+ * Le codage traite 16 octets à la fois en SSE2, 32 en AVX2 quand le
+ * processeur le permet ; le décodage, une somme préfixe, reste en SSE2. Les
+ * autres plateformes passent par les boucles scalaires.
+ *
+ * Les images ont en plus la prédiction de PNG : chaque ligne d'un chunk est
+ * codée par le prédicteur (aucun, pixel de gauche, ligne du dessus, Paeth)
+ * dont les écarts ont la plus petite somme absolue, et, dans une série dont
+ * les chunks groupent plusieurs images, par la même ligne de l'image
+ * précédente. Le numéro du prédicteur de chaque ligne suit les écarts, à la
+ * fin du chunk codé ; la géométrie des lignes (pixel, ligne, image) est dans
+ * les paramètres du filtre. Le codage est vectorisé en SSE2 ; au décodage,
+ * les prédictions par le dessus et par l'image précédente le sont aussi, la
+ * prédiction par la gauche pour des pixels de 1, 2, 4 ou 8 octets, Paeth
+ * reste scalaire (chaque pixel dépend du précédent décodé).
+ */
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PREDICT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(PREDICT_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PREDICT_AVX2 1
+#include <immintrin.h>
+#endif
+
+/* Paramètres du filtre : prédiction, taille d'un élément ; pour PNG, éléments d'un pixel,
+ * d'une ligne et lignes d'une image */
+#define PREDICT_CD_VALUES 2
+#define PREDICT_ROWS_CD_VALUES 5
+
+/* Prédicteurs d'une ligne (prédiction PNG), numérotés comme dans PNG */
+enum {
+    ROW_NONE = 0,  /* Éléments tels quels */
+    ROW_SUB = 1,   /* Écart avec le pixel de gauche */
+    ROW_UP = 2,    /* Écart avec la ligne du dessus */
+    ROW_PAETH = 3, /* Écart avec le plus proche de gauche + dessus - diagonale */
+    ROW_FRAME = 4  /* Écart avec la même ligne de l'image précédente */
+};
+
+/* Boucles scalaires sur les éléments [first, end), entiers non signés : l'écart boucle */
+#define ENCODE_SCALAR(type)                                                  \
+    do {                                                                     \
+        type* x = (type*)data;                                               \
+        for (size_t i = end; i-- > first;) {                                 \
+            x[i] = use_xor ? (type)(x[i] ^ x[i - 1]) : (type)(x[i] - x[i - 1]); \
+        }                                                                    \
+    } while (0)
+
+#define DECODE_SCALAR(type)                                                  \
+    do {                                                                     \
+        type* x = (type*)data;                                               \
+        for (size_t i = first; i < end; i++) {                               \
+            x[i] = use_xor ? (type)(x[i] ^ x[i - 1]) : (type)(x[i] + x[i - 1]); \
+        }                                                                    \
+    } while (0)
+
+/* Code les éléments [first, end), en partant de la fin pour lire des voisins intacts */
+static void encode_scalar(unsigned char* data, size_t first, size_t end, size_t element_size,
+                          int use_xor) {
+    switch (element_size) {
+        case 1: ENCODE_SCALAR(uint8_t); break;
+        case 2: ENCODE_SCALAR(uint16_t); break;
+        case 4: ENCODE_SCALAR(uint32_t); break;
+        default: ENCODE_SCALAR(uint64_t); break;
+    }
+}
+
+/* Décode les éléments [first, end), first >= 1 */
+static void decode_scalar(unsigned char* data, size_t first, size_t end, size_t element_size,
+                          int use_xor) {
+    switch (element_size) {
+        case 1: DECODE_SCALAR(uint8_t); break;
+        case 2: DECODE_SCALAR(uint16_t); break;
+        case 4: DECODE_SCALAR(uint32_t); break;
+        default: DECODE_SCALAR(uint64_t); break;
+    }
+}
+
+#ifdef PREDICT_SSE2
+
+static __m128i sub_sse2(__m128i a, __m128i b, size_t element_size) {
+    switch (element_size) {
+        case 1: return _mm_sub_epi8(a, b);
+        case 2: return _mm_sub_epi16(a, b);
+        case 4: return _mm_sub_epi32(a, b);
+        default: return _mm_sub_epi64(a, b);
+    }
+}
+
+static __m128i add_sse2(__m128i a, __m128i b, size_t element_size) {
+    switch (element_size) {
+        case 1: return _mm_add_epi8(a, b);
+        case 2: return _mm_add_epi16(a, b);
+        case 4: return _mm_add_epi32(a, b);
+        default: return _mm_add_epi64(a, b);
+    }
+}
+
+static __m128i undo_sse2(__m128i a, __m128i b, size_t element_size, int use_xor) {
+    return use_xor ? _mm_xor_si128(a, b) : add_sse2(a, b, element_size);
+}
+
+/* Somme préfixe d'un registre : décalages d'un, deux, quatre puis huit octets selon la taille */
+static __m128i prefix_sse2(__m128i v, size_t element_size, int use_xor) {
+    switch (element_size) {
+        case 1:
+            v = undo_sse2(v, _mm_slli_si128(v, 1), element_size, use_xor);
+            /* fall through */
+        case 2:
+            v = undo_sse2(v, _mm_slli_si128(v, 2), element_size, use_xor);
+            /* fall through */
+        case 4:
+            v = undo_sse2(v, _mm_slli_si128(v, 4), element_size, use_xor);
+            /* fall through */
+        default:
+            v = undo_sse2(v, _mm_slli_si128(v, 8), element_size, use_xor);
+    }
+    return v;
+}
+
+/* Dernier élément d'un registre, répété dans tous ses éléments */
+static __m128i last_sse2(__m128i v, size_t element_size) {
+    switch (element_size) {
+        case 1: {
+            __m128i t = _mm_srli_si128(v, 15);
+            t = _mm_unpacklo_epi8(t, t);
+            t = _mm_unpacklo_epi16(t, t);
+            return _mm_shuffle_epi32(t, 0x00);
+        }
+        case 2: return _mm_shuffle_epi32(_mm_shufflehi_epi16(v, 0xFF), 0xFF);
+        case 4: return _mm_shuffle_epi32(v, 0xFF);
+        default: return _mm_unpackhi_epi64(v, v);
+    }
+}
+
+/* Code les derniers éléments par registres entiers ; renvoie le premier élément restant */
+static size_t encode_sse2(unsigned char* data, size_t count, size_t element_size, int use_xor) {
+    size_t lanes = 16 / element_size;
+    size_t i = count;
+    while (i > lanes) {
+        i -= lanes;
+        unsigned char* p = data + i * element_size;
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        __m128i prev = _mm_loadu_si128((const __m128i*)(p - element_size));
+        v = use_xor ? _mm_xor_si128(v, prev) : sub_sse2(v, prev, element_size);
+        _mm_storeu_si128((__m128i*)p, v);
+    }
+    return i;
+}
+
+/* Décode les premiers éléments par registres entiers ; renvoie le premier élément restant */
+static size_t decode_sse2(unsigned char* data, size_t count, size_t element_size, int use_xor) {
+    size_t lanes = 16 / element_size;
+    __m128i carry = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        unsigned char* p = data + i * element_size;
+        __m128i v = prefix_sse2(_mm_loadu_si128((const __m128i*)p), element_size, use_xor);
+        v = undo_sse2(v, carry, element_size, use_xor);
+        _mm_storeu_si128((__m128i*)p, v);
+        carry = last_sse2(v, element_size);
+    }
+    return i;
+}
+
+/* Décalage d'un registre vers les éléments suivants de 1, 2, 4 ou 8 octets */
+static __m128i shift_sse2(__m128i v, size_t bytes) {
+    switch (bytes) {
+        case 1: return _mm_slli_si128(v, 1);
+        case 2: return _mm_slli_si128(v, 2);
+        case 4: return _mm_slli_si128(v, 4);
+        default: return _mm_slli_si128(v, 8);
+    }
+}
+
+/* Paeth sur des éléments de 16 bits signés sans débordement (octets ou entiers 16 bits) */
+static __m128i paeth_epi16(__m128i a, __m128i b, __m128i c) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i pa = _mm_sub_epi16(b, c);
+    __m128i pb = _mm_sub_epi16(a, c);
+    __m128i pc = _mm_add_epi16(pa, pb);
+    pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+    pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+    pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+    __m128i not_a = _mm_or_si128(_mm_cmpgt_epi16(pa, pb), _mm_cmpgt_epi16(pa, pc));
+    __m128i not_b = _mm_cmpgt_epi16(pb, pc);
+    __m128i bc = _mm_or_si128(_mm_and_si128(not_b, c), _mm_andnot_si128(not_b, b));
+    return _mm_or_si128(_mm_and_si128(not_a, bc), _mm_andnot_si128(not_a, a));
+}
+
+static __m128i abs_epi32(__m128i v) {
+    __m128i sign = _mm_srai_epi32(v, 31);
+    return _mm_sub_epi32(_mm_xor_si128(v, sign), sign);
+}
+
+static __m128i paeth_epi32(__m128i a, __m128i b, __m128i c) {
+    __m128i pa = _mm_sub_epi32(b, c);
+    __m128i pb = _mm_sub_epi32(a, c);
+    __m128i pc = abs_epi32(_mm_add_epi32(pa, pb));
+    pa = abs_epi32(pa);
+    pb = abs_epi32(pb);
+    __m128i not_a = _mm_or_si128(_mm_cmpgt_epi32(pa, pb), _mm_cmpgt_epi32(pa, pc));
+    __m128i not_b = _mm_cmpgt_epi32(pb, pc);
+    __m128i bc = _mm_or_si128(_mm_and_si128(not_b, c), _mm_andnot_si128(not_b, b));
+    return _mm_or_si128(_mm_and_si128(not_a, bc), _mm_andnot_si128(not_a, a));
+}
+
+/* Prédiction de Paeth d'un registre : a à gauche, b au-dessus, c en diagonale */
+static __m128i paeth_sse2(__m128i a, __m128i b, __m128i c, size_t element_size) {
+    __m128i zero = _mm_setzero_si128();
+    if (element_size == 1) {
+        __m128i lo = paeth_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero),
+                                 _mm_unpacklo_epi8(c, zero));
+        __m128i hi = paeth_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero),
+                                 _mm_unpackhi_epi8(c, zero));
+        return _mm_packus_epi16(lo, hi);
+    }
+
+    /* Pas de pack non signé 32 -> 16 bits en SSE2 : décalage de 32768 autour du pack signé */
+    __m128i bias = _mm_set1_epi32(32768);
+    __m128i lo = paeth_epi32(_mm_unpacklo_epi16(a, zero), _mm_unpacklo_epi16(b, zero),
+                             _mm_unpacklo_epi16(c, zero));
+    __m128i hi = paeth_epi32(_mm_unpackhi_epi16(a, zero), _mm_unpackhi_epi16(b, zero),
+                             _mm_unpackhi_epi16(c, zero));
+    __m128i packed = _mm_packs_epi32(_mm_sub_epi32(lo, bias), _mm_sub_epi32(hi, bias));
+    return _mm_xor_si128(packed, _mm_set1_epi16((short)0x8000));
+}
+
+/* Écarts au prédicteur des éléments [first, count) d'une ligne par registres entiers,
+ * first >= un pixel ; ajoute leur somme absolue à *cost et renvoie le premier élément restant */
+static size_t row_encode_sse2(int type, const unsigned char* cur, const unsigned char* up,
+                              const unsigned char* frame, size_t first, size_t count,
+                              size_t pixel, size_t element_size, unsigned char* out,
+                              uint64_t* cost) {
+    size_t lanes = 16 / element_size;
+    size_t left = pixel * element_size;
+    __m128i zero = _mm_setzero_si128();
+    __m128i sum = zero;
+    size_t x = first;
+    for (; x + lanes <= count; x += lanes) {
+        size_t at = x * element_size;
+        __m128i v = _mm_loadu_si128((const __m128i*)(cur + at));
+        __m128i predicted;
+        switch (type) {
+            case ROW_SUB:
+                predicted = _mm_loadu_si128((const __m128i*)(cur + at - left));
+                break;
+            case ROW_UP:
+                predicted = _mm_loadu_si128((const __m128i*)(up + at));
+                break;
+            case ROW_PAETH:
+                predicted = paeth_sse2(_mm_loadu_si128((const __m128i*)(cur + at - left)),
+                                       _mm_loadu_si128((const __m128i*)(up + at)),
+                                       _mm_loadu_si128((const __m128i*)(up + at - left)),
+                                       element_size);
+                break;
+            case ROW_FRAME:
+                predicted = _mm_loadu_si128((const __m128i*)(frame + at));
+                break;
+            default:
+                predicted = zero;
+                break;
+        }
+        __m128i r = sub_sse2(v, predicted, element_size);
+        if (out != NULL) {
+            _mm_storeu_si128((__m128i*)(out + at), r);
+        }
+
+        /* Somme des valeurs absolues des écarts vus comme signés */
+        if (element_size == 1) {
+            __m128i magnitude = _mm_min_epu8(r, _mm_sub_epi8(zero, r));
+            sum = _mm_add_epi64(sum, _mm_sad_epu8(magnitude, zero));
+        } else {
+            __m128i magnitude = _mm_max_epi16(r, _mm_sub_epi16(zero, r));
+            __m128i pairs = _mm_add_epi32(_mm_unpacklo_epi16(magnitude, zero),
+                                          _mm_unpackhi_epi16(magnitude, zero));
+            sum = _mm_add_epi64(sum, _mm_add_epi64(_mm_unpacklo_epi32(pairs, zero),
+                                                   _mm_unpackhi_epi32(pairs, zero)));
+        }
+    }
+
+    uint64_t lanes_sum[2];
+    _mm_storeu_si128((__m128i*)lanes_sum, sum);
+    *cost += lanes_sum[0] + lanes_sum[1];
+    return x;
+}
+
+/* Ajoute une ligne de référence à une ligne par registres entiers ; renvoie l'élément restant */
+static size_t row_add_sse2(unsigned char* row, const unsigned char* reference, size_t count,
+                           size_t element_size) {
+    size_t lanes = 16 / element_size;
+    size_t x = 0;
+    for (; x + lanes <= count; x += lanes) {
+        size_t at = x * element_size;
+        __m128i v = _mm_loadu_si128((const __m128i*)(row + at));
+        __m128i r = _mm_loadu_si128((const __m128i*)(reference + at));
+        _mm_storeu_si128((__m128i*)(row + at), add_sse2(v, r, element_size));
+    }
+    return x;
+}
+
+/* Somme préfixe de pixel en pixel (prédiction par la gauche) pour des pixels de 1, 2, 4 ou
+ * 8 octets, qui découpent exactement un registre ; renvoie le premier élément restant */
+static size_t row_sub_decode_sse2(unsigned char* row, size_t count, size_t pixel,
+                                  size_t element_size) {
+    size_t pixel_bytes = pixel * element_size;
+    if (pixel_bytes != 1 && pixel_bytes != 2 && pixel_bytes != 4 && pixel_bytes != 8) {
+        return 0;
+    }
+    size_t lanes = 16 / element_size;
+    __m128i carry = _mm_setzero_si128();
+    size_t x = 0;
+    for (; x + lanes <= count; x += lanes) {
+        unsigned char* p = row + x * element_size;
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        for (size_t shift = pixel_bytes; shift < 16; shift *= 2) {
+            v = add_sse2(v, shift_sse2(v, shift), element_size);
+        }
+        v = add_sse2(v, carry, element_size);
+        _mm_storeu_si128((__m128i*)p, v);
+        carry = last_sse2(v, pixel_bytes);
+    }
+    return x;
+}
+
+#endif /* PREDICT_SSE2 */
+
+#ifdef PREDICT_AVX2
+
+__attribute__((target("avx2")))
+static size_t encode_avx2(unsigned char* data, size_t count, size_t element_size, int use_xor) {
+    size_t lanes = 32 / element_size;
+    size_t i = count;
+    while (i > lanes) {
+        i -= lanes;
+        unsigned char* p = data + i * element_size;
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        __m256i prev = _mm256_loadu_si256((const __m256i*)(p - element_size));
+        if (use_xor) {
+            v = _mm256_xor_si256(v, prev);
+        } else {
+            switch (element_size) {
+                case 1: v = _mm256_sub_epi8(v, prev); break;
+                case 2: v = _mm256_sub_epi16(v, prev); break;
+                case 4: v = _mm256_sub_epi32(v, prev); break;
+                default: v = _mm256_sub_epi64(v, prev); break;
+            }
+        }
+        _mm256_storeu_si256((__m256i*)p, v);
+    }
+    return i;
+}
+
+/* Détecté une fois : la réponse ne change pas pendant la vie du processus */
+static int has_avx2(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return cached;
+}
+
+#endif /* PREDICT_AVX2 */
+
+void predict_encode(void* data, size_t bytes, size_t element_size, hdf5_predictor_t predictor) {
+    size_t count = bytes / element_size;
+    int use_xor = (predictor == HDF5_PREDICT_XOR);
+    size_t end = count;
+#if defined(PREDICT_AVX2)
+    if (has_avx2()) {
+        end = encode_avx2((unsigned char*)data, end, element_size, use_xor);
+    }
+#endif
+#if defined(PREDICT_SSE2)
+    end = encode_sse2((unsigned char*)data, end, element_size, use_xor);
+#endif
+    if (end > 1) {
+        encode_scalar((unsigned char*)data, 1, end, element_size, use_xor);
+    }
+}
+
+void predict_decode(void* data, size_t bytes, size_t element_size, hdf5_predictor_t predictor) {
+    size_t count = bytes / element_size;
+    int use_xor = (predictor == HDF5_PREDICT_XOR);
+    size_t first = 0;
+#if defined(PREDICT_SSE2)
+    first = decode_sse2((unsigned char*)data, count, element_size, use_xor);
+#endif
+    if (first == 0) {
+        first = 1;
+    }
+    if (first < count) {
+        decode_scalar((unsigned char*)data, first, count, element_size, use_xor);
+    }
+}
+
+/* Élément x d'une ligne d'éléments de 1 ou 2 octets */
+static unsigned int row_load(const unsigned char* row, size_t x, size_t element_size) {
+    if (element_size == 1) {
+        return row[x];
+    }
+    uint16_t value;
+    memcpy(&value, row + x * 2, sizeof(value));
+    return value;
+}
+
+static void row_store(unsigned char* row, size_t x, size_t element_size, unsigned int value) {
+    if (element_size == 1) {
+        row[x] = (unsigned char)value;
+    } else {
+        uint16_t element = (uint16_t)value;
+        memcpy(row + x * 2, &element, sizeof(element));
+    }
+}
+
+/* Prédicteur de Paeth : celui de a (gauche), b (dessus), c (diagonale) le plus proche de a + b - c */
+static unsigned int paeth(unsigned int a, unsigned int b, unsigned int c) {
+    int pa = abs((int)b - (int)c);
+    int pb = abs((int)a - (int)c);
+    int pc = abs((int)a + (int)b - 2 * (int)c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return (pb <= pc) ? b : c;
+}
+
+/* Prédiction de l'élément x d'une ligne ; le pixel de gauche vaut zéro sur le premier pixel */
+static unsigned int row_predict(int type, const unsigned char* cur, const unsigned char* up,
+                                const unsigned char* frame, size_t x, size_t pixel,
+                                size_t element_size) {
+    unsigned int left = (x >= pixel) ? row_load(cur, x - pixel, element_size) : 0;
+    switch (type) {
+        case ROW_SUB:
+            return left;
+        case ROW_UP:
+            return row_load(up, x, element_size);
+        case ROW_PAETH:
+            return paeth(left, row_load(up, x, element_size),
+                         (x >= pixel) ? row_load(up, x - pixel, element_size) : 0);
+        case ROW_FRAME:
+            return row_load(frame, x, element_size);
+        default:
+            return 0;
+    }
+}
+
+/* Écarts au prédicteur des éléments [first, end) d'une ligne ; renvoie leur somme absolue */
+static uint64_t row_encode_scalar(int type, const unsigned char* cur, const unsigned char* up,
+                                  const unsigned char* frame, size_t first, size_t end,
+                                  size_t pixel, size_t element_size, unsigned char* out) {
+    unsigned int mask = (element_size == 1) ? 0xFFu : 0xFFFFu;
+    uint64_t cost = 0;
+    for (size_t x = first; x < end; x++) {
+        unsigned int r = (row_load(cur, x, element_size) -
+                          row_predict(type, cur, up, frame, x, pixel, element_size)) & mask;
+        cost += (r <= mask / 2) ? r : mask + 1 - r;
+        if (out != NULL) {
+            row_store(out, x, element_size, r);
+        }
+    }
+    return cost;
+}
+
+/* Écarts d'une ligne à un prédicteur (out = NULL : somme seulement) ; renvoie la somme des
+ * valeurs absolues des écarts vus comme signés, critère de choix de PNG */
+static uint64_t row_encode(int type, const unsigned char* cur, const unsigned char* up,
+                           const unsigned char* frame, size_t count, size_t pixel,
+                           size_t element_size, unsigned char* out) {
+    size_t head = (pixel < count) ? pixel : count;
+    uint64_t cost = row_encode_scalar(type, cur, up, frame, 0, head, pixel, element_size, out);
+    size_t x = head;
+#if defined(PREDICT_SSE2)
+    x = row_encode_sse2(type, cur, up, frame, x, count, pixel, element_size, out, &cost);
+#endif
+    return cost + row_encode_scalar(type, cur, up, frame, x, count, pixel, element_size, out);
+}
+
+/* Décode une ligne en place ; up et frame sont déjà décodées */
+static void row_decode(int type, unsigned char* row, const unsigned char* up,
+                       const unsigned char* frame, size_t count, size_t pixel,
+                       size_t element_size) {
+    unsigned int mask = (element_size == 1) ? 0xFFu : 0xFFFFu;
+    size_t x = 0;
+    if (type == ROW_UP || type == ROW_FRAME) {
+        const unsigned char* reference = (type == ROW_UP) ? up : frame;
+#if defined(PREDICT_SSE2)
+        x = row_add_sse2(row, reference, count, element_size);
+#endif
+        for (; x < count; x++) {
+            row_store(row, x, element_size,
+                      (row_load(row, x, element_size) + row_load(reference, x, element_size)) & mask);
+        }
+        return;
+    }
+    if (type == ROW_SUB) {
+#if defined(PREDICT_SSE2)
+        x = row_sub_decode_sse2(row, count, pixel, element_size);
+#endif
+        if (x < pixel) {
+            x = pixel;
+        }
+    } else if (type != ROW_PAETH) {
+        return;
+    }
+
+    /* Chaque pixel dépend du précédent décodé : scalaire */
+    for (; x < count; x++) {
+        unsigned int predicted = row_predict(type, row, up, frame, x, pixel, element_size);
+        row_store(row, x, element_size, (row_load(row, x, element_size) + predicted) & mask);
+    }
+}
+
+int predict_by_rows(hdf5_predictor_t predictor) {
+    return predictor == HDF5_PREDICT_PNG || predictor == HDF5_PREDICT_PNG_FRAME;
+}
+
+size_t predict_rows_encoded_bytes(const predict_rows_t* rows, size_t bytes) {
+    return bytes + bytes / (rows->row_elements * rows->element_size);
+}
+
+size_t predict_rows_encode(const predict_rows_t* rows, const void* data, size_t bytes,
+                           void* out) {
+    size_t element_size = rows->element_size;
+    size_t row_bytes = rows->row_elements * element_size;
+    size_t frame_bytes = rows->frame_rows * row_bytes;
+    size_t count = bytes / row_bytes;
+    int use_frame = (rows->predictor == HDF5_PREDICT_PNG_FRAME);
+    const unsigned char* source = (const unsigned char*)data;
+    unsigned char* target = (unsigned char*)out;
+    unsigned char* types = target + count * row_bytes;
+
+    for (size_t r = 0; r < count; r++) {
+        /* Lignes de référence absentes en haut d'une image et dans la première image */
+        const unsigned char* cur = source + r * row_bytes;
+        const unsigned char* up = (r % rows->frame_rows != 0) ? cur - row_bytes : NULL;
+        const unsigned char* frame = (use_frame && r >= rows->frame_rows) ? cur - frame_bytes
+                                                                          : NULL;
+        int best = ROW_NONE;
+        uint64_t best_cost = row_encode(ROW_NONE, cur, up, frame, rows->row_elements,
+                                        rows->pixel_elements, element_size, NULL);
+        for (int type = ROW_SUB; type <= ROW_FRAME && best_cost > 0; type++) {
+            if (((type == ROW_UP || type == ROW_PAETH) && up == NULL) ||
+                (type == ROW_FRAME && frame == NULL)) {
+                continue;
+            }
+            uint64_t cost = row_encode(type, cur, up, frame, rows->row_elements,
+                                       rows->pixel_elements, element_size, NULL);
+            if (cost < best_cost) {
+                best = type;
+                best_cost = cost;
+            }
+        }
+        row_encode(best, cur, up, frame, rows->row_elements, rows->pixel_elements, element_size,
+                   target + r * row_bytes);
+        types[r] = (unsigned char)best;
+    }
+    return count * row_bytes + count;
+}
+
+size_t predict_rows_decode(const predict_rows_t* rows, void* data, size_t bytes) {
+    size_t row_bytes = rows->row_elements * rows->element_size;
+    size_t frame_bytes = rows->frame_rows * row_bytes;
+    size_t count = bytes / (row_bytes + 1);
+    if (count * (row_bytes + 1) != bytes) {
+        return 0;
+    }
+    int use_frame = (rows->predictor == HDF5_PREDICT_PNG_FRAME);
+    unsigned char* base = (unsigned char*)data;
+    const unsigned char* types = base + count * row_bytes;
+
+    for (size_t r = 0; r < count; r++) {
+        unsigned char* row = base + r * row_bytes;
+        const unsigned char* up = (r % rows->frame_rows != 0) ? row - row_bytes : NULL;
+        const unsigned char* frame = (use_frame && r >= rows->frame_rows) ? row - frame_bytes
+                                                                          : NULL;
+        int type = types[r];
+        if (type > ROW_FRAME || ((type == ROW_UP || type == ROW_PAETH) && up == NULL) ||
+            (type == ROW_FRAME && frame == NULL)) {
+            return 0;
+        }
+        row_decode(type, row, up, frame, rows->row_elements, rows->pixel_elements,
+                   rows->element_size);
+    }
+    return count * row_bytes;
+}
+
+hdf5_predictor_t predict_select(const hdf5_codec_policy_t* policy, size_t element_size) {
+    if (policy->codec == HDF5_CODEC_NONE) {
+        return HDF5_PREDICT_NONE;
+    }
+    if (element_size != 1 && element_size != 2 && element_size != 4 && element_size != 8) {
+        return HDF5_PREDICT_NONE;
+    }
+    if (predict_by_rows(policy->predictor) && element_size > 2) {
+        return HDF5_PREDICT_DELTA;
+    }
+    return policy->predictor;
+}
+
+/* Géométrie des lignes lue dans les paramètres du filtre ; renvoie -1 s'ils sont invalides */
+static int rows_from_cd_values(size_t cd_nelmts, const unsigned int cd_values[],
+                               predict_rows_t* rows) {
+    if (cd_nelmts < PREDICT_ROWS_CD_VALUES || !predict_by_rows((hdf5_predictor_t)cd_values[0]) ||
+        (cd_values[1] != 1 && cd_values[1] != 2) || cd_values[2] == 0 || cd_values[3] == 0 ||
+        cd_values[4] == 0) {
+        return -1;
+    }
+    rows->predictor = (hdf5_predictor_t)cd_values[0];
+    rows->element_size = cd_values[1];
+    rows->pixel_elements = cd_values[2];
+    rows->row_elements = cd_values[3];
+    rows->frame_rows = cd_values[4];
+    return 0;
+}
+
+/* Filtre de la prédiction PNG : le chunk codé grandit d'un octet par ligne */
+static size_t rows_filter(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[],
+                          size_t nbytes, size_t* buf_size, void** buf) {
+    predict_rows_t rows;
+    if (rows_from_cd_values(cd_nelmts, cd_values, &rows) < 0) {
+        return 0;
+    }
+    if (flags & H5Z_FLAG_REVERSE) {
+        return predict_rows_decode(&rows, *buf, nbytes);
+    }
+
+    if (nbytes % (rows.row_elements * rows.element_size) != 0) {
+        return 0;
+    }
+    size_t encoded_bytes = predict_rows_encoded_bytes(&rows, nbytes);
+    void* encoded = H5allocate_memory(encoded_bytes, 0);
+    if (encoded == NULL) {
+        return 0;
+    }
+    predict_rows_encode(&rows, *buf, nbytes, encoded);
+    H5free_memory(*buf);
+    *buf = encoded;
+    *buf_size = encoded_bytes;
+    return encoded_bytes;
+}
+
+/* Fonction du filtre HDF5 : pour l'écart et le ou exclusif, le chunk garde sa taille et la
+ * prédiction est faite en place */
+static size_t predict_filter(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[],
+                             size_t nbytes, size_t* buf_size, void** buf) {
+    if (cd_nelmts < PREDICT_CD_VALUES) {
+        return 0;
+    }
+    hdf5_predictor_t predictor = (hdf5_predictor_t)cd_values[0];
+    if (predict_by_rows(predictor)) {
+        return rows_filter(flags, cd_nelmts, cd_values, nbytes, buf_size, buf);
+    }
+    size_t element_size = cd_values[1];
+    if ((predictor != HDF5_PREDICT_DELTA && predictor != HDF5_PREDICT_XOR) ||
+        (element_size != 1 && element_size != 2 && element_size != 4 && element_size != 8)) {
+        return 0;
+    }
+
+    if (flags & H5Z_FLAG_REVERSE) {
+        predict_decode(*buf, nbytes, element_size, predictor);
+    } else {
+        predict_encode(*buf, nbytes, element_size, predictor);
+    }
+    return nbytes;
+}
+
+static const H5Z_class2_t predict_class = {
+    H5Z_CLASS_T_VERS,
+    (H5Z_filter_t)HDF5_LOGGER_FILTER_PREDICT,
+    1, /* Codage présent */
+    1, /* Décodage présent */
+    "hdf5_logger predict",
+    NULL,
+    NULL,
+    predict_filter
+};
+
+int predict_register(void) {
+    /* Enregistrer à nouveau le même filtre remplace simplement sa classe */
+    return (H5Zregister(&predict_class) < 0) ? -1 : 0;
+}
+
+int predict_apply(hid_t plist_id, hdf5_predictor_t predictor, size_t element_size,
+                  int pixel_rank) {
+    unsigned int cd_values[PREDICT_ROWS_CD_VALUES] = {(unsigned int)predictor,
+                                                      (unsigned int)element_size};
+    size_t cd_nelmts = PREDICT_CD_VALUES;
+
+    /* PNG : une ligne couvre la dimension qui précède le pixel, une image la dimension
+     * d'avant (une image par chunk sans elle) */
+    if (predict_by_rows(predictor)) {
+        hsize_t chunk_dims[HDF5_LOGGER_MAX_RANK];
+        int rank = H5Pget_chunk(plist_id, HDF5_LOGGER_MAX_RANK, chunk_dims);
+        int column = rank - 1 - pixel_rank;
+        if (rank < 1 || column < 0) {
+            return -1;
+        }
+        hsize_t pixel_elements = 1;
+        for (int i = column + 1; i < rank; i++) {
+            pixel_elements *= chunk_dims[i];
+        }
+        hsize_t row_elements = chunk_dims[column] * pixel_elements;
+        if (row_elements > UINT_MAX) {
+            return -1;
+        }
+        cd_values[2] = (unsigned int)pixel_elements;
+        cd_values[3] = (unsigned int)row_elements;
+        cd_values[4] = (column > 0) ? (unsigned int)chunk_dims[column - 1] : 1;
+        cd_nelmts = PREDICT_ROWS_CD_VALUES;
+    }
+
+    if (predict_register() < 0) {
+        return -1;
+    }
+    return (H5Pset_filter(plist_id, HDF5_LOGGER_FILTER_PREDICT, H5Z_FLAG_MANDATORY,
+                          cd_nelmts, cd_values) < 0) ? -1 : 0;
+}
+
+int predict_rows_read(hid_t dataset_id, predict_rows_t* rows) {
+    hid_t plist_id = H5Dget_create_plist(dataset_id);
+    if (plist_id < 0) {
+        return -1;
+    }
+    unsigned int flags = 0;
+    size_t cd_nelmts = PREDICT_ROWS_CD_VALUES;
+    unsigned int cd_values[PREDICT_ROWS_CD_VALUES] = {0};
+    herr_t status = H5Pget_filter_by_id2(plist_id, HDF5_LOGGER_FILTER_PREDICT, &flags,
+                                         &cd_nelmts, cd_values, 0, NULL, NULL);
+    H5Pclose(plist_id);
+    if (status < 0) {
+        return -1;
+    }
+    return rows_from_cd_values(cd_nelmts, cd_values, rows);
+}
+
+/* Implémentation des fonctions publiques */
+
+int hdf5_logger_register_filters(void) {
+    return predict_register();
+}
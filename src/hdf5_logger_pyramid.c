@@ -0,0 +1,526 @@
+/**
+ * @file hdf5_logger_pyramid.c
+ * @brief Vignettes des images : niveaux réduits de moitié écrits avec l'image
+ *
+ * Pour un groupe réglé par hdf5_logger_set_image_pyramid, chaque image écrite
+ * est suivie de ses niveaux <nom>_level1, <nom>_level2... Un pixel d'un
+ * niveau est la moyenne arrondie des 2 x 2 pixels qu'il couvre au niveau
+ * précédent ; la dernière colonne ou ligne d'une taille impaire est moyennée
+ * avec elle-même. Un niveau d'au plus PYRAMID_CHUNK_BYTES octets forme un
+ * seul chunk, lu d'une seule lecture par un visualiseur.
+ *
+ * Les lignes d'un niveau sont réparties en bandes sur les threads de
+ * compression. Pour les canaux de 8 et 16 bits, les sommes de quatre pixels
+ * voisins sont calculées 16 ou 8 canaux à la fois en SSE2, puis une colonne
+ * sur deux est gardée ; les autres types passent par une boucle scalaire
+ * qui donne exactement les mêmes valeurs.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PYRAMID_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/* Nombre maximal de niveaux sous l'image */
+#define PYRAMID_MAX_LEVELS 16
+
+/* Taille maximale d'un niveau écrit en un seul chunk */
+#define PYRAMID_CHUNK_BYTES (1024 * 1024)
+
+/* Lignes minimales d'une bande */
+#define PYRAMID_BAND_ROWS 16
+
+/* Moyenne arrondie de quatre entiers, sans dépassement : floor((a + b + c + d + 2) / 4) */
+#define AVERAGE_INT(a, b, c, d)                                                               \
+    (((a) >> 2) + ((b) >> 2) + ((c) >> 2) + ((d) >> 2) +                                      \
+     ((((a) & 3) + ((b) & 3) + ((c) & 3) + ((d) & 3) + 2) >> 2))
+
+#define AVERAGE_FLOAT(a, b, c, d) (((a) + (b) + (c) + (d)) / 4)
+
+/* Réduction d'une ligne : out[x] moyenne des pixels 2x et 2x + 1 des lignes r0 et r1 */
+#define REDUCE_ROW(type, average)                                                             \
+    do {                                                                                      \
+        const type* a = (const type*)r0;                                                      \
+        const type* b = (const type*)r1;                                                      \
+        type* o = (type*)out;                                                                 \
+        for (size_t x = first; x < out_width; x++) {                                          \
+            size_t i = 2 * x * lanes;                                                         \
+            size_t j = (2 * x + 1 < width) ? i + lanes : i;                                   \
+            for (size_t k = 0; k < lanes; k++) {                                              \
+                o[x * lanes + k] = (type)average(a[i + k], b[i + k], a[j + k], b[j + k]);     \
+            }                                                                                 \
+        }                                                                                     \
+    } while (0)
+
+/* Réduction d'un niveau, répartie en bandes de lignes (par plan pour une image en plans) */
+typedef struct {
+    const unsigned char* source; /* Niveau précédent */
+    unsigned char* out;          /* Niveau calculé */
+    size_t width;                /* Largeur du niveau précédent */
+    size_t height;               /* Hauteur du niveau précédent */
+    size_t lanes;                /* Canaux entrelacés d'un pixel */
+    hdf5_dtype_t dtype;          /* Type d'un canal */
+    size_t element_size;         /* Taille d'un canal */
+    size_t bands;                /* Bandes d'un plan */
+    size_t band_rows;            /* Lignes réduites par bande */
+    unsigned char* scratch;      /* Une ligne de sommes par tâche */
+} pyramid_job_t;
+
+#ifdef PYRAMID_SSE2
+/* Sommes des canaux i et i + lanes de deux lignes, 16 canaux de 8 bits à la fois */
+static size_t sums_u8_sse2(const uint8_t* r0, const uint8_t* r1, size_t lanes, size_t count,
+                           uint8_t* sums) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(r0 + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(r1 + i));
+        __m128i c = _mm_loadu_si128((const __m128i*)(r0 + i + lanes));
+        __m128i d = _mm_loadu_si128((const __m128i*)(r1 + i + lanes));
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a, zero),
+                                                 _mm_unpacklo_epi8(b, zero)),
+                                   _mm_add_epi16(_mm_unpacklo_epi8(c, zero),
+                                                 _mm_unpacklo_epi8(d, zero)));
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a, zero),
+                                                 _mm_unpackhi_epi8(b, zero)),
+                                   _mm_add_epi16(_mm_unpackhi_epi8(c, zero),
+                                                 _mm_unpackhi_epi8(d, zero)));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, two), 2);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, two), 2);
+        _mm_storeu_si128((__m128i*)(sums + i), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+/* Même calcul pour 8 canaux de 16 bits, sommés sur 32 bits ; le décalage de 32768 ramène
+ * les moyennes dans la plage signée de packs */
+static size_t sums_u16_sse2(const uint16_t* r0, const uint16_t* r1, size_t lanes, size_t count,
+                            uint16_t* sums) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi32(2);
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i flip = _mm_set1_epi16((short)0x8000);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(r0 + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(r1 + i));
+        __m128i c = _mm_loadu_si128((const __m128i*)(r0 + i + lanes));
+        __m128i d = _mm_loadu_si128((const __m128i*)(r1 + i + lanes));
+        __m128i lo = _mm_add_epi32(_mm_add_epi32(_mm_unpacklo_epi16(a, zero),
+                                                 _mm_unpacklo_epi16(b, zero)),
+                                   _mm_add_epi32(_mm_unpacklo_epi16(c, zero),
+                                                 _mm_unpacklo_epi16(d, zero)));
+        __m128i hi = _mm_add_epi32(_mm_add_epi32(_mm_unpackhi_epi16(a, zero),
+                                                 _mm_unpackhi_epi16(b, zero)),
+                                   _mm_add_epi32(_mm_unpackhi_epi16(c, zero),
+                                                 _mm_unpackhi_epi16(d, zero)));
+        lo = _mm_sub_epi32(_mm_srli_epi32(_mm_add_epi32(lo, two), 2), bias);
+        hi = _mm_sub_epi32(_mm_srli_epi32(_mm_add_epi32(hi, two), 2), bias);
+        _mm_storeu_si128((__m128i*)(sums + i), _mm_xor_si128(_mm_packs_epi32(lo, hi), flip));
+    }
+    return i;
+}
+
+/* Moyennes des paires de colonnes voisines en SSE2, puis une colonne sur deux gardée ;
+ * la dernière colonne d'une largeur impaire reste à calculer (first) */
+#define REDUCE_ROW_SSE2(type, kernel)                                                         \
+    do {                                                                                      \
+        const type* a = (const type*)r0;                                                      \
+        const type* b = (const type*)r1;                                                      \
+        type* s = (type*)scratch;                                                             \
+        type* o = (type*)out;                                                                 \
+        size_t count = (width - 1) * lanes;                                                   \
+        size_t i = kernel(a, b, lanes, count, s);                                             \
+        for (; i < count; i++) {                                                              \
+            s[i] = (type)AVERAGE_INT(a[i], b[i], a[i + lanes], b[i + lanes]);                 \
+        }                                                                                     \
+        for (size_t x = 0; x < width / 2; x++) {                                              \
+            for (size_t k = 0; k < lanes; k++) {                                              \
+                o[x * lanes + k] = s[2 * x * lanes + k];                                      \
+            }                                                                                 \
+        }                                                                                     \
+        first = width / 2;                                                                    \
+    } while (0)
+#endif
+
+/* Réduit deux lignes du niveau précédent en une ligne */
+static void reduce_row(const pyramid_job_t* job, const unsigned char* r0,
+                       const unsigned char* r1, unsigned char* out, unsigned char* scratch) {
+    size_t width = job->width;
+    size_t lanes = job->lanes;
+    size_t out_width = (width + 1) / 2;
+    size_t first = 0;
+    (void)scratch;
+
+    switch (job->dtype) {
+        case HDF5_DTYPE_UINT8:
+#ifdef PYRAMID_SSE2
+            REDUCE_ROW_SSE2(uint8_t, sums_u8_sse2);
+#endif
+            REDUCE_ROW(uint8_t, AVERAGE_INT);
+            break;
+        case HDF5_DTYPE_UINT16:
+#ifdef PYRAMID_SSE2
+            REDUCE_ROW_SSE2(uint16_t, sums_u16_sse2);
+#endif
+            REDUCE_ROW(uint16_t, AVERAGE_INT);
+            break;
+        case HDF5_DTYPE_INT8:
+            REDUCE_ROW(int8_t, AVERAGE_INT);
+            break;
+        case HDF5_DTYPE_INT16:
+            REDUCE_ROW(int16_t, AVERAGE_INT);
+            break;
+        case HDF5_DTYPE_INT32:
+            REDUCE_ROW(int32_t, AVERAGE_INT);
+            break;
+        case HDF5_DTYPE_UINT32:
+            REDUCE_ROW(uint32_t, AVERAGE_INT);
+            break;
+        case HDF5_DTYPE_INT64:
+            REDUCE_ROW(int64_t, AVERAGE_INT);
+            break;
+        case HDF5_DTYPE_UINT64:
+            REDUCE_ROW(uint64_t, AVERAGE_INT);
+            break;
+        case HDF5_DTYPE_FLOAT32:
+            REDUCE_ROW(float, AVERAGE_FLOAT);
+            break;
+        case HDF5_DTYPE_FLOAT64:
+            REDUCE_ROW(double, AVERAGE_FLOAT);
+            break;
+        default:
+            break;
+    }
+}
+
+/* Tâche index : bande index % bands du plan index / bands */
+static void reduce_task(void* arg, size_t index) {
+    const pyramid_job_t* job = (const pyramid_job_t*)arg;
+    size_t plane = index / job->bands;
+    size_t band = index % job->bands;
+    size_t out_width = (job->width + 1) / 2;
+    size_t out_height = (job->height + 1) / 2;
+    size_t row_bytes = job->width * job->lanes * job->element_size;
+    size_t out_row_bytes = out_width * job->lanes * job->element_size;
+
+    const unsigned char* source = job->source + plane * job->height * row_bytes;
+    unsigned char* out = job->out + plane * out_height * out_row_bytes;
+    unsigned char* scratch = job->scratch + index * row_bytes;
+
+    size_t first = band * job->band_rows;
+    size_t last = (first + job->band_rows < out_height) ? first + job->band_rows : out_height;
+    for (size_t y = first; y < last; y++) {
+        size_t y1 = (2 * y + 1 < job->height) ? 2 * y + 1 : 2 * y;
+        reduce_row(job, source + 2 * y * row_bytes, source + y1 * row_bytes,
+                   out + y * out_row_bytes, scratch);
+    }
+}
+
+/* Réduit un niveau de moitié ; les plans d'une image en plans sont réduits séparément */
+static int reduce_level(hdf5_logger_t* logger, const void* source, size_t width, size_t height,
+                        size_t planes, size_t lanes, hdf5_dtype_t dtype, void* out) {
+    pyramid_job_t job;
+    job.source = (const unsigned char*)source;
+    job.out = (unsigned char*)out;
+    job.width = width;
+    job.height = height;
+    job.lanes = lanes;
+    job.dtype = dtype;
+    job.element_size = dtype_size(dtype);
+
+    /* Deux bandes par thread, pour équilibrer la charge */
+    size_t out_height = (height + 1) / 2;
+    size_t workers = pool_size(logger->compress_pool);
+    size_t band_rows = (out_height + 2 * workers - 1) / (2 * workers);
+    job.band_rows = (band_rows < PYRAMID_BAND_ROWS) ? PYRAMID_BAND_ROWS : band_rows;
+    job.bands = (out_height + job.band_rows - 1) / job.band_rows;
+
+    size_t count = planes * job.bands;
+    job.scratch = (unsigned char*)arena_alloc(logger->arena,
+                                              count * width * lanes * job.element_size);
+    if (job.scratch == NULL) {
+        return -1;
+    }
+    pool_run(logger->compress_pool, count, reduce_task, &job);
+    arena_free(logger->arena, job.scratch);
+    return 0;
+}
+
+/* Note le numéro d'un niveau et l'image dont il provient */
+static int level_attributes(hid_t group_id, const char* level_name, const char* image_name,
+                            unsigned int level) {
+    hid_t dataset_id = H5Dopen2(group_id, level_name, H5P_DEFAULT);
+    if (dataset_id < 0) {
+        return -1;
+    }
+    int status = write_scalar_attribute(dataset_id, "pyramid_level", H5T_NATIVE_UINT, &level);
+    hid_t name_type = H5Tcopy(H5T_C_S1);
+    H5Tset_size(name_type, strlen(image_name) + 1);
+    if (write_scalar_attribute(dataset_id, "pyramid_source", name_type, image_name) < 0) {
+        status = -1;
+    }
+    H5Tclose(name_type);
+    H5Dclose(dataset_id);
+    return status;
+}
+
+/* Écrit une image sans passer par la déduplication : ses attributs ne concernent qu'elle */
+static int store_private(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                         const void* pixel_data, size_t width, size_t height, size_t channels,
+                         hdf5_dtype_t dtype, const source_view_t* view, int planar,
+                         size_t chunk_side) {
+    int enabled = logger->dedup.enabled;
+    logger->dedup.enabled = 0;
+    int status = image_store(logger, group_path, image_name, pixel_data, width, height, channels,
+                             dtype, view, planar, chunk_side);
+    logger->dedup.enabled = enabled;
+    return status;
+}
+
+/* 1 si l'image est un lien dur partagé avec un dataset dont l'attribut pyramid_levels ne la
+ * décrit pas (levels < 0 : l'image n'a pas de vignettes), 0 sinon, -1 en cas d'erreur */
+static int shared_base_differs(hid_t group_id, const char* image_name, long levels) {
+    H5O_info_t info;
+    if (H5Oget_info_by_name(group_id, image_name, &info, H5P_DEFAULT) < 0) {
+        return -1;
+    }
+    if (info.rc <= 1) {
+        return 0;
+    }
+    hid_t dataset_id = H5Dopen2(group_id, image_name, H5P_DEFAULT);
+    if (dataset_id < 0) {
+        return -1;
+    }
+    unsigned int stored = 0;
+    int exists = H5Aexists(dataset_id, "pyramid_levels") > 0 &&
+                 read_scalar_attribute(dataset_id, "pyramid_levels", H5T_NATIVE_UINT,
+                                       &stored) >= 0;
+    H5Dclose(dataset_id);
+    if (levels < 0) {
+        return exists;
+    }
+    return !exists || stored != (unsigned int)levels;
+}
+
+/* Groupe sans vignettes : une image dédupliquée vers un dataset qui en porte est réécrite */
+static int pyramid_unshare(hdf5_logger_t* logger, const char* group_path,
+                           const char* image_name, const void* pixel_data, size_t width,
+                           size_t height, size_t channels, hdf5_dtype_t dtype,
+                           const source_view_t* view, int planar) {
+    if (!logger->dedup.enabled) {
+        return 0;
+    }
+    hid_t group_id = create_group_if_not_exists(logger->file_id, group_path);
+    if (group_id < 0) {
+        return -1;
+    }
+    int differs = shared_base_differs(group_id, image_name, -1);
+    if (group_id != logger->file_id) {
+        H5Gclose(group_id);
+    }
+    if (differs <= 0) {
+        return differs;
+    }
+    return store_private(logger, group_path, image_name, pixel_data, width, height, channels,
+                         dtype, view, planar, IMAGE_CHUNK_SIDE);
+}
+
+int image_pyramid_write(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                        const void* pixel_data, size_t width, size_t height, size_t channels,
+                        hdf5_dtype_t dtype, const source_view_t* view, int planar) {
+    size_t min_size = image_pyramid_resolve(logger, group_path);
+    if (min_size == 0 || dtype == HDF5_DTYPE_FLOAT16) {
+        return pyramid_unshare(logger, group_path, image_name, pixel_data, width, height,
+                               channels, dtype, view, planar);
+    }
+    size_t base_width = width;
+    size_t base_height = height;
+
+    /* Une image en plans est réduite comme des images grayscale de même taille */
+    size_t element_size = dtype_size(dtype);
+    size_t planes = (planar) ? channels : 1;
+    size_t lanes = (planar) ? 1 : channels;
+    size_t name_size = strlen(image_name) + sizeof("_level") + 10;
+    char* level_name = (char*)malloc(name_size);
+    if (level_name == NULL) {
+        return -1;
+    }
+
+    /* Pixels denses, puis deux tampons alternés : le premier niveau est le plus grand */
+    size_t first_bytes = ((width + 1) / 2) * ((height + 1) / 2) * channels * element_size;
+    void* gathered = NULL;
+    void* buffers[2];
+    buffers[0] = arena_alloc(logger->arena, first_bytes);
+    buffers[1] = arena_alloc(logger->arena, first_bytes);
+    if (view != NULL) {
+        gathered = arena_alloc(logger->arena, width * height * channels * element_size);
+    }
+    int status = (buffers[0] != NULL && buffers[1] != NULL && (view == NULL || gathered != NULL))
+                     ? 0
+                     : -1;
+
+    const void* source = pixel_data;
+    if (status == 0 && view != NULL) {
+        view_gather(view, pixel_data, element_size, 0, width * height * channels, gathered);
+        source = gathered;
+    }
+
+    hid_t group_id = (status == 0) ? create_group_if_not_exists(logger->file_id, group_path) : -1;
+    if (group_id < 0) {
+        status = -1;
+    }
+
+    unsigned int levels = 0;
+    while (status == 0 && levels < PYRAMID_MAX_LEVELS &&
+           ((width > height) ? width : height) > min_size) {
+        void* out = buffers[levels & 1];
+        if (reduce_level(logger, source, width, height, planes, lanes, dtype, out) < 0) {
+            status = -1;
+            break;
+        }
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        levels++;
+
+        /* Un niveau assez petit tient dans un seul chunk */
+        size_t side = (width > height) ? width : height;
+        size_t chunk_side = (width * height * channels * element_size <= PYRAMID_CHUNK_BYTES)
+                                ? side
+                                : IMAGE_CHUNK_SIDE;
+        snprintf(level_name, name_size, "%s_level%u", image_name, levels);
+        status = store_private(logger, group_path, level_name, out, width, height, channels,
+                               dtype, NULL, planar, chunk_side);
+        if (status == 0) {
+            status = level_attributes(group_id, level_name, image_name, levels);
+        }
+        source = out;
+    }
+
+    /* Niveaux d'une image précédente plus grande */
+    if (status == 0) {
+        for (unsigned int level = levels + 1; level <= PYRAMID_MAX_LEVELS; level++) {
+            snprintf(level_name, name_size, "%s_level%u", image_name, level);
+            if (H5Lexists(group_id, level_name, H5P_DEFAULT) <= 0) {
+                break;
+            }
+            if (H5Ldelete(group_id, level_name, H5P_DEFAULT) < 0) {
+                status = -1;
+                break;
+            }
+        }
+    }
+
+    /* Image dédupliquée vers un dataset d'un autre nombre de niveaux : copie propre */
+    if (status == 0 && logger->dedup.enabled) {
+        int differs = shared_base_differs(group_id, image_name, (long)levels);
+        if (differs > 0) {
+            differs = store_private(logger, group_path, image_name, pixel_data, base_width,
+                                    base_height, channels, dtype, view, planar,
+                                    IMAGE_CHUNK_SIDE);
+        }
+        status = (differs < 0) ? -1 : 0;
+    }
+
+    /* Nombre de niveaux, noté sur l'image */
+    if (status == 0) {
+        hid_t dataset_id = H5Dopen2(group_id, image_name, H5P_DEFAULT);
+        if (dataset_id < 0 ||
+            write_scalar_attribute(dataset_id, "pyramid_levels", H5T_NATIVE_UINT, &levels) < 0) {
+            status = -1;
+        }
+        if (dataset_id >= 0) {
+            H5Dclose(dataset_id);
+        }
+    }
+
+    if (group_id >= 0 && group_id != logger->file_id) {
+        H5Gclose(group_id);
+    }
+    arena_free(logger->arena, gathered);
+    arena_free(logger->arena, buffers[0]);
+    arena_free(logger->arena, buffers[1]);
+    free(level_name);
+    return status;
+}
+
+/* Vignettes des images d'un groupe */
+
+size_t image_pyramid_resolve(hdf5_logger_t* logger, const char* group_path) {
+    for (image_pyramid_override_t* override = logger->image_pyramids; override != NULL;
+         override = override->next) {
+        if (strcmp(override->group_path, group_path) == 0) {
+            return override->min_size;
+        }
+    }
+    return 0;
+}
+
+void image_pyramid_destroy(hdf5_logger_t* logger) {
+    image_pyramid_override_t* override = logger->image_pyramids;
+    while (override != NULL) {
+        image_pyramid_override_t* next = override->next;
+        free(override->group_path);
+        free(override);
+        override = next;
+    }
+    logger->image_pyramids = NULL;
+}
+
+static int set_image_pyramid(hdf5_logger_t* logger, const char* group_path, size_t min_size) {
+    if (logger == NULL || !logger->is_open || group_path == NULL) {
+        return -1;
+    }
+
+    image_pyramid_override_t** link = &logger->image_pyramids;
+    while (*link != NULL && strcmp((*link)->group_path, group_path) != 0) {
+        link = &(*link)->next;
+    }
+
+    /* Pas de vignettes : le réglage du groupe est retiré */
+    if (min_size == 0) {
+        if (*link != NULL) {
+            image_pyramid_override_t* override = *link;
+            *link = override->next;
+            free(override->group_path);
+            free(override);
+        }
+        return 0;
+    }
+
+    if (*link == NULL) {
+        image_pyramid_override_t* override =
+            (image_pyramid_override_t*)calloc(1, sizeof(image_pyramid_override_t));
+        char* path = (override != NULL) ? strdup(group_path) : NULL;
+        if (path == NULL) {
+            free(override);
+            return -1;
+        }
+        override->group_path = path;
+        *link = override;
+    }
+    (*link)->min_size = min_size;
+    return 0;
+}
+
+/* Implémentation des fonctions publiques */
+
+int hdf5_logger_set_image_pyramid(hdf5_logger_t* logger, const char* group_path,
+                                  size_t min_size) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+
+    int status = set_image_pyramid(logger, group_path, min_size);
+
+    logger_unlock(logger);
+    return status;
+}
@@ -0,0 +1,407 @@
+/**
+ * @file hdf5_logger_quantize.c
+ * @brief Quantification des tableaux flottants : précision bornée, bits suivants à zéro
+ *
+ * Une mesure qui porte une douzaine de bits d'information est stockée avec
+ * les 23 bits de mantisse d'un float : les derniers sont du bruit que deflate
+ * ne sait pas réduire. Les valeurs sont arrondies à la précision demandée
+ * avant d'être écrites, ce qui met à zéro les bits de mantisse suivants.
+ *
+ * - Chiffres significatifs : la mantisse est arrondie au plus proche sur
+ *   ceil(chiffres x log2(10)) bits (arrondi de bits, plutôt que le bit
+ *   grooming qui alterne troncature et mise à un, pour une erreur centrée).
+ * - Erreur absolue : chaque valeur est arrondie au multiple le plus proche
+ *   de la plus grande puissance de deux au plus égale à deux fois l'erreur ;
+ *   l'addition puis la soustraction d'une constante 1,5 x 2^(mantisse + k)
+ *   fait l'arrondi dans l'unité flottante.
+ *
+ * Les noyaux traitent 16 octets à la fois en SSE2, les autres plateformes
+ * passent par les boucles scalaires. Les valeurs non finies sont gardées.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QUANTIZE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/* Attributs qui notent la précision d'un dataset */
+#define QUANTIZE_DIGITS_ATTRIBUTE "quantize_significant_digits"
+#define QUANTIZE_ERROR_ATTRIBUTE "quantize_max_error"
+
+/* Chiffres significatifs acceptés (17 suffisent à un double) */
+#define QUANTIZE_MAX_DIGITS 17
+
+/* log2(10) : bits de mantisse par chiffre décimal */
+#define QUANTIZE_BITS_PER_DIGIT 3.321928094887362
+
+/* Paramètres des noyaux pour un format flottant */
+typedef struct {
+    int active;         /* 0 si la précision demandée dépasse celle du format */
+    uint64_t half;      /* Chiffres : demi-unité du dernier bit gardé */
+    uint64_t mask;      /* Chiffres : bits gardés */
+    double bias;        /* Erreur absolue : constante d'arrondi 1,5 x 2^(mantisse + k) */
+    double limit;       /* Erreur absolue : au-delà, la valeur est déjà un multiple du pas */
+} quantize_plan_t;
+
+/* Paramètres des noyaux ; mantissa = 23 (float) ou 52 (double) */
+static void quantize_plan(const hdf5_quantize_t* quantize, int mantissa, quantize_plan_t* plan) {
+    memset(plan, 0, sizeof(*plan));
+    if (quantize->mode == HDF5_QUANTIZE_DIGITS) {
+        int keep = (int)ceil(quantize->precision * QUANTIZE_BITS_PER_DIGIT);
+        if (keep >= mantissa) {
+            return;
+        }
+        int drop = mantissa - keep;
+        plan->active = 1;
+        plan->half = (uint64_t)1 << (drop - 1);
+        plan->mask = ~(((uint64_t)1 << drop) - 1);
+        return;
+    }
+
+    /* Pas 2^k : plus grande puissance de deux au plus égale à deux fois l'erreur */
+    int exponent;
+    frexp(2.0 * quantize->precision, &exponent);
+    int k = exponent - 1;
+    int min_k = (mantissa == 23) ? -149 : -1074; /* Plus petit dénormalisé */
+    int max_k = (mantissa == 23) ? 127 - 24 : 1023 - 53; /* bias reste représentable */
+    if (k < min_k) {
+        return;
+    }
+    if (k > max_k) {
+        k = max_k;
+    }
+    plan->active = 1;
+    plan->bias = ldexp(1.5, mantissa + k);
+    plan->limit = ldexp(1.0, mantissa - 1 + k);
+}
+
+/* Arrondi d'une valeur à ses bits gardés ; renvoie les bits de la valeur arrondie */
+static uint32_t round_bits32(uint32_t u, const quantize_plan_t* plan) {
+    const uint32_t exponent = 0x7F800000u;
+    if ((u & exponent) == exponent) {
+        return u;
+    }
+    uint32_t r = (u + (uint32_t)plan->half) & (uint32_t)plan->mask;
+    /* Arrondi du plus grand fini vers l'infini : troncature */
+    return ((r & exponent) == exponent) ? (u & (uint32_t)plan->mask) : r;
+}
+
+static uint64_t round_bits64(uint64_t u, const quantize_plan_t* plan) {
+    const uint64_t exponent = 0x7FF0000000000000ULL;
+    if ((u & exponent) == exponent) {
+        return u;
+    }
+    uint64_t r = (u + plan->half) & plan->mask;
+    return ((r & exponent) == exponent) ? (u & plan->mask) : r;
+}
+
+/* Boucles scalaires sur les valeurs [first, count) */
+static void digits32_scalar(const float* in, float* out, size_t first, size_t count,
+                            const quantize_plan_t* plan) {
+    for (size_t i = first; i < count; i++) {
+        uint32_t u;
+        memcpy(&u, &in[i], sizeof(u));
+        u = round_bits32(u, plan);
+        memcpy(&out[i], &u, sizeof(u));
+    }
+}
+
+static void digits64_scalar(const double* in, double* out, size_t first, size_t count,
+                            const quantize_plan_t* plan) {
+    for (size_t i = first; i < count; i++) {
+        uint64_t u;
+        memcpy(&u, &in[i], sizeof(u));
+        u = round_bits64(u, plan);
+        memcpy(&out[i], &u, sizeof(u));
+    }
+}
+
+static void absolute32_scalar(const float* in, float* out, size_t first, size_t count,
+                              const quantize_plan_t* plan) {
+    volatile float bias = (float)plan->bias; /* Empêche de simplifier (x + b) - b */
+    float limit = (float)plan->limit;
+    for (size_t i = first; i < count; i++) {
+        float x = in[i];
+        out[i] = (fabsf(x) < limit) ? (x + bias) - bias : x;
+    }
+}
+
+static void absolute64_scalar(const double* in, double* out, size_t first, size_t count,
+                              const quantize_plan_t* plan) {
+    volatile double bias = plan->bias;
+    double limit = plan->limit;
+    for (size_t i = first; i < count; i++) {
+        double x = in[i];
+        out[i] = (fabs(x) < limit) ? (x + bias) - bias : x;
+    }
+}
+
+#ifdef QUANTIZE_SSE2
+
+/* Choisit a là où mask est à un, b ailleurs */
+static __m128i select_si128(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/* Noyaux SSE2 : renvoient la première valeur non traitée */
+static size_t digits32_sse2(const float* in, float* out, size_t count,
+                            const quantize_plan_t* plan) {
+    const __m128i exponent = _mm_set1_epi32(0x7F800000);
+    const __m128i half = _mm_set1_epi32((int)(uint32_t)plan->half);
+    const __m128i mask = _mm_set1_epi32((int)(uint32_t)plan->mask);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i u = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i special = _mm_cmpeq_epi32(_mm_and_si128(u, exponent), exponent);
+        __m128i truncated = _mm_and_si128(u, mask);
+        __m128i r = _mm_and_si128(_mm_add_epi32(u, half), mask);
+        __m128i overflow = _mm_cmpeq_epi32(_mm_and_si128(r, exponent), exponent);
+        r = select_si128(overflow, truncated, r);
+        _mm_storeu_si128((__m128i*)(out + i), select_si128(special, u, r));
+    }
+    return i;
+}
+
+/* Égalité de mots de 64 bits en SSE2 : les deux moitiés doivent être égales */
+static __m128i cmpeq_epi64_sse2(__m128i a, __m128i b) {
+    __m128i equal = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(equal, _mm_shuffle_epi32(equal, 0xB1));
+}
+
+static size_t digits64_sse2(const double* in, double* out, size_t count,
+                            const quantize_plan_t* plan) {
+    const __m128i exponent = _mm_set1_epi64x((long long)0x7FF0000000000000ULL);
+    const __m128i half = _mm_set1_epi64x((long long)plan->half);
+    const __m128i mask = _mm_set1_epi64x((long long)plan->mask);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128i u = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i special = cmpeq_epi64_sse2(_mm_and_si128(u, exponent), exponent);
+        __m128i truncated = _mm_and_si128(u, mask);
+        __m128i r = _mm_and_si128(_mm_add_epi64(u, half), mask);
+        __m128i overflow = cmpeq_epi64_sse2(_mm_and_si128(r, exponent), exponent);
+        r = select_si128(overflow, truncated, r);
+        _mm_storeu_si128((__m128i*)(out + i), select_si128(special, u, r));
+    }
+    return i;
+}
+
+static size_t absolute32_sse2(const float* in, float* out, size_t count,
+                              const quantize_plan_t* plan) {
+    const __m128 magnitude = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 bias = _mm_set1_ps((float)plan->bias);
+    const __m128 limit = _mm_set1_ps((float)plan->limit);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(in + i);
+        __m128 small = _mm_cmplt_ps(_mm_and_ps(x, magnitude), limit); /* Faux pour NaN */
+        __m128 r = _mm_sub_ps(_mm_add_ps(x, bias), bias);
+        _mm_storeu_ps(out + i, _mm_or_ps(_mm_and_ps(small, r), _mm_andnot_ps(small, x)));
+    }
+    return i;
+}
+
+static size_t absolute64_sse2(const double* in, double* out, size_t count,
+                              const quantize_plan_t* plan) {
+    const __m128d magnitude = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+    const __m128d bias = _mm_set1_pd(plan->bias);
+    const __m128d limit = _mm_set1_pd(plan->limit);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d x = _mm_loadu_pd(in + i);
+        __m128d small = _mm_cmplt_pd(_mm_and_pd(x, magnitude), limit);
+        __m128d r = _mm_sub_pd(_mm_add_pd(x, bias), bias);
+        _mm_storeu_pd(out + i, _mm_or_pd(_mm_and_pd(small, r), _mm_andnot_pd(small, x)));
+    }
+    return i;
+}
+
+#endif /* QUANTIZE_SSE2 */
+
+void quantize_copy(const hdf5_quantize_t* quantize, hdf5_dtype_t dtype, const void* in,
+                   void* out, size_t count) {
+    int is_double = (dtype == HDF5_DTYPE_FLOAT64);
+    quantize_plan_t plan;
+    quantize_plan(quantize, is_double ? 52 : 23, &plan);
+    if (!plan.active) {
+        if (out != in) {
+            memcpy(out, in, count * (is_double ? sizeof(double) : sizeof(float)));
+        }
+        return;
+    }
+
+    size_t first = 0;
+    if (quantize->mode == HDF5_QUANTIZE_DIGITS) {
+        if (is_double) {
+#ifdef QUANTIZE_SSE2
+            first = digits64_sse2((const double*)in, (double*)out, count, &plan);
+#endif
+            digits64_scalar((const double*)in, (double*)out, first, count, &plan);
+        } else {
+#ifdef QUANTIZE_SSE2
+            first = digits32_sse2((const float*)in, (float*)out, count, &plan);
+#endif
+            digits32_scalar((const float*)in, (float*)out, first, count, &plan);
+        }
+    } else {
+        if (is_double) {
+#ifdef QUANTIZE_SSE2
+            first = absolute64_sse2((const double*)in, (double*)out, count, &plan);
+#endif
+            absolute64_scalar((const double*)in, (double*)out, first, count, &plan);
+        } else {
+#ifdef QUANTIZE_SSE2
+            first = absolute32_sse2((const float*)in, (float*)out, count, &plan);
+#endif
+            absolute32_scalar((const float*)in, (float*)out, first, count, &plan);
+        }
+    }
+}
+
+const hdf5_quantize_t* quantize_resolve(hdf5_logger_t* logger, const char* group_path,
+                                        const char* dataset_name, hdf5_dtype_t dtype) {
+    if (dtype != HDF5_DTYPE_FLOAT32 && dtype != HDF5_DTYPE_FLOAT64) {
+        return NULL;
+    }
+
+    /* Le réglage du dataset l'emporte sur celui du groupe */
+    const hdf5_quantize_t* found = NULL;
+    for (quantize_override_t* override = logger->quantize_overrides; override != NULL;
+         override = override->next) {
+        if (strcmp(override->group_path, group_path) != 0) {
+            continue;
+        }
+        if (override->dataset_name == NULL) {
+            found = &override->quantize;
+        } else if (strcmp(override->dataset_name, dataset_name) == 0) {
+            found = &override->quantize;
+            break;
+        }
+    }
+    return (found != NULL && found->mode != HDF5_QUANTIZE_NONE) ? found : NULL;
+}
+
+int quantize_write_attributes(hid_t dataset_id, const hdf5_quantize_t* quantize) {
+    if (quantize->mode == HDF5_QUANTIZE_DIGITS) {
+        int digits = (int)quantize->precision;
+        return write_scalar_attribute(dataset_id, QUANTIZE_DIGITS_ATTRIBUTE, H5T_NATIVE_INT,
+                                      &digits);
+    }
+    return write_scalar_attribute(dataset_id, QUANTIZE_ERROR_ATTRIBUTE, H5T_NATIVE_DOUBLE,
+                                  &quantize->precision);
+}
+
+void quantize_read_attributes(hid_t dataset_id, hdf5_quantize_t* quantize) {
+    int digits = 0;
+    double error = 0.0;
+    quantize->mode = HDF5_QUANTIZE_NONE;
+    quantize->precision = 0.0;
+    if (read_scalar_attribute(dataset_id, QUANTIZE_DIGITS_ATTRIBUTE, H5T_NATIVE_INT,
+                              &digits) == 0) {
+        quantize->mode = HDF5_QUANTIZE_DIGITS;
+        quantize->precision = digits;
+    } else if (read_scalar_attribute(dataset_id, QUANTIZE_ERROR_ATTRIBUTE, H5T_NATIVE_DOUBLE,
+                                     &error) == 0) {
+        quantize->mode = HDF5_QUANTIZE_ABSOLUTE;
+        quantize->precision = error;
+    }
+}
+
+void quantize_destroy(hdf5_logger_t* logger) {
+    quantize_override_t* override = logger->quantize_overrides;
+    while (override != NULL) {
+        quantize_override_t* next = override->next;
+        free(override->group_path);
+        free(override->dataset_name);
+        free(override);
+        override = next;
+    }
+    logger->quantize_overrides = NULL;
+}
+
+/* Vérifie une précision : entier de chiffres ou erreur finie et positive */
+static int quantize_validate(const hdf5_quantize_t* quantize) {
+    switch (quantize->mode) {
+        case HDF5_QUANTIZE_NONE:
+            return 0;
+        case HDF5_QUANTIZE_DIGITS:
+            return (quantize->precision >= 1 && quantize->precision <= QUANTIZE_MAX_DIGITS &&
+                    quantize->precision == floor(quantize->precision)) ? 0 : -1;
+        case HDF5_QUANTIZE_ABSOLUTE:
+            return (quantize->precision > 0 && isfinite(quantize->precision)) ? 0 : -1;
+        default:
+            return -1;
+    }
+}
+
+static int set_quantize(hdf5_logger_t* logger, const char* group_path, const char* dataset_name,
+                        const hdf5_quantize_t* quantize) {
+    if (logger == NULL || !logger->is_open || group_path == NULL) {
+        return -1;
+    }
+    if (quantize != NULL && quantize_validate(quantize) < 0) {
+        return -1;
+    }
+
+    quantize_override_t** link = &logger->quantize_overrides;
+    for (; *link != NULL; link = &(*link)->next) {
+        quantize_override_t* override = *link;
+        if (strcmp(override->group_path, group_path) == 0 &&
+            ((override->dataset_name == NULL && dataset_name == NULL) ||
+             (override->dataset_name != NULL && dataset_name != NULL &&
+              strcmp(override->dataset_name, dataset_name) == 0))) {
+            break;
+        }
+    }
+
+    /* Sans précision, le dataset revient à celle du groupe et le groupe aux valeurs exactes ;
+     * HDF5_QUANTIZE_NONE garde exact un dataset d'un groupe quantifié */
+    if (quantize == NULL || (quantize->mode == HDF5_QUANTIZE_NONE && dataset_name == NULL)) {
+        if (*link != NULL) {
+            quantize_override_t* override = *link;
+            *link = override->next;
+            free(override->group_path);
+            free(override->dataset_name);
+            free(override);
+        }
+        return 0;
+    }
+
+    if (*link == NULL) {
+        quantize_override_t* override = (quantize_override_t*)calloc(1,
+                                                                     sizeof(quantize_override_t));
+        char* path = (override != NULL) ? strdup(group_path) : NULL;
+        char* name = (path != NULL && dataset_name != NULL) ? strdup(dataset_name) : NULL;
+        if (path == NULL || (dataset_name != NULL && name == NULL)) {
+            free(path);
+            free(override);
+            return -1;
+        }
+        override->group_path = path;
+        override->dataset_name = name;
+        *link = override;
+    }
+    (*link)->quantize = *quantize;
+    return 0;
+}
+
+/* Implémentation des fonctions publiques */
+
+int hdf5_logger_set_quantize(hdf5_logger_t* logger, const char* group_path,
+                             const char* dataset_name, const hdf5_quantize_t* quantize) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+
+    int status = set_quantize(logger, group_path, dataset_name, quantize);
+
+    logger_unlock(logger);
+    return status;
+}
@@ -0,0 +1,427 @@
+/**
+ * @file hdf5_logger_retention.c
+ * @brief Conservation par durée : segments temporels et purge incrémentale
+ *
+ * Un groupe limité en temps (sans limite de taille) range ses entrées dans des
+ * sous-groupes segment_<n>, chacun couvrant une tranche de max_time_seconds / 8.
+ * Chaque segment porte ses horodatages min_time et max_time : la purge supprime
+ * les segments entièrement expirés sans rien lire, puis cherche par dichotomie
+ * la première entrée valide du plus ancien segment restant (attribut valid_from).
+ * Un groupe limité en taille et en temps garde son anneau, dont le début est
+ * avancé de la même façon.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+/* Nombre de segments couvrant une fenêtre de conservation */
+#define TIME_SEGMENTS_PER_WINDOW 8
+
+/* Longueur maximale d'un nom de segment */
+#define SEGMENT_NAME_SIZE 32
+
+static void segment_name(char* buffer, unsigned long index) {
+    snprintf(buffer, SEGMENT_NAME_SIZE, "segment_%lu", index);
+}
+
+/* Ajoute un descripteur vide à la liste des segments du canal */
+static text_segment_t* segment_push(hdf5_log_channel_t* channel) {
+    if (channel->segment_count == channel->segment_capacity) {
+        size_t capacity = channel->segment_capacity ? channel->segment_capacity * 2 : 16;
+        text_segment_t* segments = realloc(channel->segments, capacity * sizeof(text_segment_t));
+        if (segments == NULL) {
+            return NULL;
+        }
+        channel->segments = segments;
+        channel->segment_capacity = capacity;
+    }
+
+    text_segment_t* segment = &channel->segments[channel->segment_count++];
+    memset(segment, 0, sizeof(*segment));
+    return segment;
+}
+
+/* Écrit les métadonnées d'un segment sur son groupe */
+static int segment_write_meta(hid_t segment_group_id, const text_segment_t* segment) {
+    if (write_scalar_attribute(segment_group_id, "start_time", H5T_NATIVE_DOUBLE,
+                               &segment->start_time) < 0 ||
+        write_scalar_attribute(segment_group_id, "min_time", H5T_NATIVE_DOUBLE,
+                               &segment->min_time) < 0 ||
+        write_scalar_attribute(segment_group_id, "max_time", H5T_NATIVE_DOUBLE,
+                               &segment->max_time) < 0 ||
+        write_scalar_attribute(segment_group_id, "valid_from", H5T_NATIVE_HSIZE,
+                               &segment->valid_from) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Ferme le segment courant et son stockage */
+static void segment_close_current(hdf5_log_channel_t* channel) {
+    if (channel->segment_group_id >= 0) {
+        store_close(&channel->store);
+        H5Gclose(channel->segment_group_id);
+        channel->segment_group_id = -1;
+    }
+}
+
+/* Donne accès au stockage d'un segment : le courant est déjà ouvert, les autres le sont ici */
+static int segment_open_store(hdf5_log_channel_t* channel, size_t position, text_store_t* store,
+                              hid_t* segment_group_id) {
+    if (position == channel->segment_count - 1 && channel->segment_group_id >= 0) {
+        *store = channel->store;
+        *segment_group_id = -1;
+        return 0;
+    }
+
+    char name[SEGMENT_NAME_SIZE];
+    segment_name(name, channel->segments[position].index);
+    *segment_group_id = H5Gopen2(channel->group_id, name, H5P_DEFAULT);
+    if (*segment_group_id < 0) {
+        return -1;
+    }
+
+    if (store_open(store, *segment_group_id, channel->logger->record_type_id) <= 0) {
+        H5Gclose(*segment_group_id);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Referme un stockage obtenu par segment_open_store */
+static void segment_close_store(text_store_t* store, hid_t segment_group_id) {
+    if (segment_group_id >= 0) {
+        store_close(store);
+        H5Gclose(segment_group_id);
+    }
+}
+
+int segments_open(hdf5_log_channel_t* channel) {
+    channel->segment_group_id = -1;
+
+    if (read_scalar_attribute(channel->group_id, "segment_seconds", H5T_NATIVE_DOUBLE,
+                              &channel->segment_seconds) < 0) {
+        return 0;
+    }
+    channel->segmented = 1;
+
+    unsigned long first = 0;
+    read_scalar_attribute(channel->group_id, "segment_first", H5T_NATIVE_ULONG, &first);
+    read_scalar_attribute(channel->group_id, "segment_next", H5T_NATIVE_ULONG,
+                          &channel->segment_next);
+
+    /* Charger les métadonnées des segments vivants, sans lire leurs enregistrements */
+    for (unsigned long index = first; index < channel->segment_next; index++) {
+        char name[SEGMENT_NAME_SIZE];
+        segment_name(name, index);
+        if (H5Lexists(channel->group_id, name, H5P_DEFAULT) <= 0) {
+            continue;
+        }
+
+        hid_t segment_group_id = H5Gopen2(channel->group_id, name, H5P_DEFAULT);
+        if (segment_group_id < 0) {
+            return -1;
+        }
+
+        text_segment_t* segment = segment_push(channel);
+        if (segment == NULL) {
+            H5Gclose(segment_group_id);
+            return -1;
+        }
+        segment->index = index;
+        read_scalar_attribute(segment_group_id, "min_time", H5T_NATIVE_DOUBLE, &segment->min_time);
+        segment->start_time = segment->min_time;
+        read_scalar_attribute(segment_group_id, "start_time", H5T_NATIVE_DOUBLE,
+                              &segment->start_time);
+        read_scalar_attribute(segment_group_id, "max_time", H5T_NATIVE_DOUBLE, &segment->max_time);
+        read_scalar_attribute(segment_group_id, "valid_from", H5T_NATIVE_HSIZE,
+                              &segment->valid_from);
+        H5Gclose(segment_group_id);
+    }
+
+    /* Le dernier segment redevient le segment courant */
+    if (channel->segment_count > 0) {
+        char name[SEGMENT_NAME_SIZE];
+        segment_name(name, channel->segments[channel->segment_count - 1].index);
+        channel->segment_group_id = H5Gopen2(channel->group_id, name, H5P_DEFAULT);
+        if (channel->segment_group_id < 0 ||
+            store_open(&channel->store, channel->segment_group_id,
+                       channel->logger->record_type_id) <= 0) {
+            return -1;
+        }
+    }
+
+    return 1;
+}
+
+int segments_create(hdf5_log_channel_t* channel) {
+    channel->segmented = 1;
+    channel->segment_group_id = -1;
+    channel->segment_count = 0;
+    channel->segment_next = 0;
+    channel->segment_seconds = channel->max_time_seconds / TIME_SEGMENTS_PER_WINDOW;
+
+    unsigned long first = 0;
+    int version = TEXT_LAYOUT_COMPACT;
+    if (write_scalar_attribute(channel->group_id, "segment_seconds", H5T_NATIVE_DOUBLE,
+                               &channel->segment_seconds) < 0 ||
+        write_scalar_attribute(channel->group_id, "segment_first", H5T_NATIVE_ULONG, &first) < 0 ||
+        write_scalar_attribute(channel->group_id, "segment_next", H5T_NATIVE_ULONG,
+                               &channel->segment_next) < 0 ||
+        write_scalar_attribute(channel->group_id, "text_layout_version", H5T_NATIVE_INT,
+                               &version) < 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int segments_resize(hdf5_log_channel_t* channel) {
+    /* Les segments existants gardent leur tranche ; seuls les suivants utilisent la nouvelle */
+    channel->segment_seconds = channel->max_time_seconds / TIME_SEGMENTS_PER_WINDOW;
+    return write_scalar_attribute(channel->group_id, "segment_seconds", H5T_NATIVE_DOUBLE,
+                                  &channel->segment_seconds);
+}
+
+void segments_close(hdf5_log_channel_t* channel) {
+    segment_close_current(channel);
+    free(channel->segments);
+    channel->segments = NULL;
+    channel->segment_count = 0;
+    channel->segment_capacity = 0;
+}
+
+int segments_delete(hdf5_log_channel_t* channel) {
+    int status = 0;
+
+    segment_close_current(channel);
+    for (size_t i = 0; i < channel->segment_count; i++) {
+        char name[SEGMENT_NAME_SIZE];
+        segment_name(name, channel->segments[i].index);
+        if (H5Ldelete(channel->group_id, name, H5P_DEFAULT) < 0) {
+            status = -1;
+        }
+    }
+
+    H5Adelete(channel->group_id, "segment_seconds");
+    H5Adelete(channel->group_id, "segment_first");
+    H5Adelete(channel->group_id, "segment_next");
+
+    segments_close(channel);
+    channel->segmented = 0;
+    return status;
+}
+
+/* Démarre un nouveau segment dont la tranche commence à timestamp */
+static int segment_start(hdf5_log_channel_t* channel, double timestamp) {
+    segment_close_current(channel);
+
+    char name[SEGMENT_NAME_SIZE];
+    unsigned long index = channel->segment_next;
+    segment_name(name, index);
+
+    channel->segment_group_id = H5Gcreate2(channel->group_id, name, H5P_DEFAULT,
+                                           H5P_DEFAULT, H5P_DEFAULT);
+    if (channel->segment_group_id < 0) {
+        return -1;
+    }
+
+    if (store_create(&channel->store, channel->segment_group_id,
+                     channel->logger->record_type_id, 0,
+                     codec_resolve(channel->logger, channel->group_path, HDF5_DATA_TEXT)) < 0) {
+        segment_close_current(channel);
+        return -1;
+    }
+
+    text_segment_t* segment = segment_push(channel);
+    if (segment == NULL) {
+        return -1;
+    }
+    segment->index = index;
+    segment->start_time = timestamp;
+    segment->min_time = timestamp;
+    segment->max_time = timestamp;
+
+    channel->segment_next = index + 1;
+    if (segment_write_meta(channel->segment_group_id, segment) < 0 ||
+        write_scalar_attribute(channel->group_id, "segment_next", H5T_NATIVE_ULONG,
+                               &channel->segment_next) < 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int segments_append(hdf5_log_channel_t* channel, text_record_t* records, size_t n,
+                    const char* bytes) {
+    hid_t record_type_id = channel->logger->record_type_id;
+    size_t i = 0;
+
+    while (i < n) {
+        /* Ouvrir un nouveau segment quand l'entrée sort de la tranche courante */
+        if (channel->segment_group_id < 0 ||
+            records[i].timestamp >= channel->segments[channel->segment_count - 1].start_time +
+                                    channel->segment_seconds) {
+            if (segment_start(channel, records[i].timestamp) < 0) {
+                return -1;
+            }
+        }
+
+        text_segment_t* segment = &channel->segments[channel->segment_count - 1];
+        double limit = segment->start_time + channel->segment_seconds;
+
+        /* Plus longue suite d'entrées appartenant à la tranche de ce segment */
+        size_t j = i + 1;
+        while (j < n && records[j].timestamp < limit) {
+            j++;
+        }
+
+        double oldest = segment->min_time;
+        double newest = segment->max_time;
+        for (size_t k = i; k < j; k++) {
+            if (records[k].timestamp < oldest) {
+                oldest = records[k].timestamp;
+            }
+            if (records[k].timestamp > newest) {
+                newest = records[k].timestamp;
+            }
+        }
+
+        /* Positions relatives au premier message de la suite */
+        size_t base = (size_t)records[i].offset;
+        size_t end = (size_t)(records[j - 1].offset + records[j - 1].length);
+        for (size_t k = i; k < j; k++) {
+            records[k].offset -= base;
+        }
+
+        if (store_append(&channel->store, record_type_id, records + i, j - i,
+                         bytes + base, end - base) < 0) {
+            return -1;
+        }
+
+        /* Les bornes temporelles sont tenues en mémoire : aucune lecture n'est nécessaire */
+        if (oldest != segment->min_time || newest != segment->max_time) {
+            segment->min_time = oldest;
+            segment->max_time = newest;
+            if (segment_write_meta(channel->segment_group_id, segment) < 0) {
+                return -1;
+            }
+        }
+
+        i = j;
+    }
+
+    return 0;
+}
+
+int segments_iterate(hdf5_log_channel_t* channel, text_visit_t visit, void* user_data) {
+    int result = 0;
+
+    for (size_t i = 0; i < channel->segment_count && result == 0; i++) {
+        text_store_t store;
+        hid_t segment_group_id;
+        if (segment_open_store(channel, i, &store, &segment_group_id) < 0) {
+            return -1;
+        }
+
+        hsize_t valid_from = channel->segments[i].valid_from;
+        if (store.count > valid_from) {
+            result = store_iterate(&store, channel->logger->record_type_id, valid_from,
+                                   store.count - valid_from, visit, user_data);
+        }
+
+        segment_close_store(&store, segment_group_id);
+    }
+
+    return result;
+}
+
+/* Supprime les segments expirés puis fixe le début exact du plus ancien segment restant */
+static int segments_expire(hdf5_log_channel_t* channel, double cutoff) {
+    size_t expired = 0;
+    int status = 0;
+
+    /* Segments entièrement expirés : supprimés sans aucune lecture */
+    while (expired < channel->segment_count && channel->segments[expired].max_time < cutoff) {
+        if (expired == channel->segment_count - 1) {
+            segment_close_current(channel);
+        }
+
+        char name[SEGMENT_NAME_SIZE];
+        segment_name(name, channel->segments[expired].index);
+        if (H5Ldelete(channel->group_id, name, H5P_DEFAULT) < 0) {
+            status = -1;
+        }
+        expired++;
+    }
+
+    if (expired > 0) {
+        memmove(channel->segments, channel->segments + expired,
+                (channel->segment_count - expired) * sizeof(text_segment_t));
+        channel->segment_count -= expired;
+
+        unsigned long first = (channel->segment_count > 0) ? channel->segments[0].index
+                                                           : channel->segment_next;
+        if (write_scalar_attribute(channel->group_id, "segment_first", H5T_NATIVE_ULONG,
+                                   &first) < 0) {
+            status = -1;
+        }
+    }
+
+    /* Segment partiellement expiré : dichotomie sur ses horodatages */
+    if (channel->segment_count > 0 && channel->segments[0].min_time < cutoff) {
+        text_segment_t* segment = &channel->segments[0];
+        text_store_t store;
+        hid_t segment_group_id;
+        if (segment_open_store(channel, 0, &store, &segment_group_id) < 0) {
+            return -1;
+        }
+
+        hsize_t index;
+        if (store_find_time(&store, segment->valid_from, store.count, cutoff, &index) < 0) {
+            status = -1;
+        } else if (index < store.count) {
+            segment->valid_from = index;
+            if (store_read_timestamp(&store, index, &segment->min_time) < 0 ||
+                segment_write_meta((segment_group_id >= 0) ? segment_group_id
+                                                           : channel->segment_group_id,
+                                   segment) < 0) {
+                status = -1;
+            }
+        }
+
+        segment_close_store(&store, segment_group_id);
+    }
+
+    return status;
+}
+
+int retention_apply(hdf5_log_channel_t* channel, double now) {
+    channel->last_retention = now;
+
+    if (channel->max_time_seconds <= 0) {
+        return 0;
+    }
+
+    double cutoff = now - channel->max_time_seconds;
+
+    if (channel->segmented) {
+        return segments_expire(channel, cutoff);
+    }
+
+    /* Anneau limité aussi en temps : avancer son début jusqu'à la première entrée valide */
+    text_store_t* store = &channel->store;
+    if (store->ring_capacity > 0 && store->count > 0 && store->first_timestamp < cutoff) {
+        hsize_t index;
+        if (store_find_time(store, 0, store->count, cutoff, &index) < 0) {
+            return -1;
+        }
+        return store_drop_front(store, channel->logger->record_type_id, index);
+    }
+
+    return 0;
+}
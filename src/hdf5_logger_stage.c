@@ -0,0 +1,501 @@
+/**
+ * @file hdf5_logger_stage.c
+ * @brief Appels concurrents : tampons par thread et fusion par un seul propriétaire
+ *
+ * En mode synchrone, chaque thread producteur écrit ses logs texte dans son
+ * propre tampon, protégé par un verrou que seul le thread et la fusion
+ * prennent : les producteurs ne se disputent jamais un verrou commun. Chaque
+ * entrée reçoit au dépôt un numéro de séquence global, croissant, qui permet
+ * de reconstituer l'ordre des appels entre threads.
+ *
+ * Quand un tampon atteint un seuil de la politique de regroupement, son thread
+ * tente de prendre le verrou d'entrées/sorties io_lock. Celui qui l'obtient
+ * devient le propriétaire : il échange les tampons de tous les threads contre
+ * des tampons vides, trie leurs entrées par numéro de séquence et les ajoute
+ * aux canaux. Les autres threads continuent de remplir leur tampon ; ils
+ * n'attendent le verrou que si leur tampon déborde largement.
+ *
+ * À la sortie d'un thread, une clé de thread fusionne ses tampons puis les
+ * retire de la liste de leur logger : un programme qui crée et termine des
+ * threads ne fait pas grandir cette liste.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+#include "hdf5_logger_platform.h"
+
+/* Nombre maximal d'entrées d'un tampon avant de tenter une fusion */
+#define STAGE_MAX_ENTRIES 1024
+
+/* Au-delà de ce multiple des seuils, le producteur attend le verrou pour fusionner */
+#define STAGE_BLOCK_FACTOR 8
+
+/* Entrée d'un tampon : le chemin et le message sont rangés dans les octets du tampon */
+typedef struct {
+    unsigned long long sequence;  /* Numéro de séquence global */
+    double timestamp;             /* Horodatage pris au dépôt */
+    int log_level;                /* Niveau de log */
+    unsigned int format_id;       /* Format interné (0 = message déjà formaté) */
+    hdf5_log_channel_t* channel;  /* Canal cible, ou NULL pour passer par le chemin */
+    size_t path_offset;           /* Position du chemin (si channel est NULL) */
+    size_t offset;                /* Position du message ou des arguments encodés */
+    size_t length;                /* Nombre d'octets à offset */
+} stage_entry_t;
+
+/* Entrées et octets d'un tampon */
+typedef struct {
+    stage_entry_t* entries;
+    size_t count;
+    size_t capacity;
+    char* bytes;
+    size_t used;
+    size_t bytes_capacity;
+} stage_buffer_t;
+
+struct thread_stage_s {
+    const void* owner;            /* Jeton du thread propriétaire (NULL après sa sortie) */
+    hdf5_logger_t* logger;        /* Logger du tampon */
+    logger_mutex_t lock;          /* Pris par le propriétaire pour ajouter, par la fusion pour échanger */
+    stage_buffer_t active;        /* Tampon rempli par le thread */
+    stage_buffer_t spare;         /* Tampon vidé par la fusion (sous io_lock) */
+    double first_time;            /* Arrivée de la plus ancienne entrée de active (0 = vide) */
+    struct thread_stage_s* next;  /* Liste des tampons du logger, dont on ne retire que sous io_lock */
+
+    /* Tampons du même thread, tous loggers confondus (sous threads_lock) */
+    struct thread_stage_s* thread_next;
+    struct thread_stage_s** thread_link; /* Lien qui désigne ce tampon (NULL = détaché du thread) */
+};
+
+/* Entrée à fusionner, avec les octets de son tampon */
+struct stage_item_s {
+    const stage_entry_t* entry;
+    const char* bytes;
+};
+
+/* Compteur des identifiants de logger */
+static volatile size_t next_logger_id;
+
+/* Dernier tampon utilisé par le thread ; son adresse sert aussi de jeton de thread */
+typedef struct {
+    unsigned long logger_id;
+    thread_stage_t* stage;
+    thread_stage_t* owned;        /* Tampons créés par le thread (sous threads_lock) */
+} stage_tls_t;
+
+static LOGGER_THREAD_LOCAL stage_tls_t tls_stage;
+
+/* Clé dont le destructeur libère les tampons d'un thread qui se termine */
+static logger_once_t stage_once = LOGGER_ONCE_INIT;
+static logger_key_t stage_key;
+static int stage_key_ready;
+
+/* Protège les listes de tampons par thread ; pris avant io_lock et stages_lock */
+static logger_mutex_t threads_lock;
+
+static void LOGGER_KEY_CALLBACK stage_thread_exit(void* value);
+
+static void stage_key_init(void) {
+    if (logger_mutex_init(&threads_lock) < 0) {
+        return;
+    }
+    if (logger_key_create(&stage_key, stage_thread_exit) < 0) {
+        logger_mutex_destroy(&threads_lock);
+        return;
+    }
+    stage_key_ready = 1;
+}
+
+/* Retire un tampon de la liste de son thread (sous threads_lock) */
+static void stage_unlink_thread(thread_stage_t* stage) {
+    *stage->thread_link = stage->thread_next;
+    if (stage->thread_next != NULL) {
+        stage->thread_next->thread_link = stage->thread_link;
+    }
+    stage->thread_next = NULL;
+    stage->thread_link = NULL;
+}
+
+static void stage_free(thread_stage_t* stage);
+
+/* Fusionne puis libère le tampon d'un thread terminé (sous threads_lock) */
+static void stage_release(thread_stage_t* stage) {
+    hdf5_logger_t* logger = stage->logger;
+
+    logger_mutex_lock(&logger->io_lock);
+    stage_merge(logger);
+
+    /* Un tampon que la fusion n'a pas pu vider reste dans la liste : la fermeture le reprendra */
+    logger_mutex_lock(&logger->stages_lock);
+    stage->owner = NULL;
+    int empty = (stage->active.count == 0 && stage->spare.count == 0);
+    if (empty) {
+        thread_stage_t** link = &logger->stages;
+        while (*link != stage) {
+            link = &(*link)->next;
+        }
+        *link = stage->next;
+    }
+    logger_mutex_unlock(&logger->stages_lock);
+    logger_mutex_unlock(&logger->io_lock);
+
+    if (empty) {
+        stage_free(stage);
+    }
+}
+
+static void LOGGER_KEY_CALLBACK stage_thread_exit(void* value) {
+    stage_tls_t* tls = (stage_tls_t*)value;
+
+    logger_mutex_lock(&threads_lock);
+    while (tls->owned != NULL) {
+        thread_stage_t* stage = tls->owned;
+        stage_unlink_thread(stage);
+        stage_release(stage);
+    }
+    logger_mutex_unlock(&threads_lock);
+}
+
+/* Inscrit un nouveau tampon dans la liste du thread appelant */
+static void stage_attach_thread(thread_stage_t* stage) {
+    logger_once(&stage_once, stage_key_init);
+    if (!stage_key_ready) {
+        return; /* Sans clé, le tampon vit jusqu'à la fermeture du logger */
+    }
+
+    logger_mutex_lock(&threads_lock);
+    if (tls_stage.owned == NULL && logger_key_set(stage_key, &tls_stage) < 0) {
+        logger_mutex_unlock(&threads_lock);
+        return;
+    }
+    stage->thread_next = tls_stage.owned;
+    stage->thread_link = &tls_stage.owned;
+    if (tls_stage.owned != NULL) {
+        tls_stage.owned->thread_link = &stage->thread_next;
+    }
+    tls_stage.owned = stage;
+    logger_mutex_unlock(&threads_lock);
+}
+
+/* Retrouve ou crée le tampon du thread appelant */
+static thread_stage_t* stage_get(hdf5_logger_t* logger) {
+    if (tls_stage.logger_id == logger->id) {
+        return tls_stage.stage;
+    }
+
+    logger_mutex_lock(&logger->stages_lock);
+    thread_stage_t* stage = logger->stages;
+    while (stage != NULL && stage->owner != (const void*)&tls_stage) {
+        stage = stage->next;
+    }
+
+    int created = 0;
+    if (stage == NULL) {
+        stage = (thread_stage_t*)calloc(1, sizeof(thread_stage_t));
+        if (stage != NULL && logger_mutex_init(&stage->lock) < 0) {
+            free(stage);
+            stage = NULL;
+        }
+        if (stage != NULL) {
+            stage->owner = &tls_stage;
+            stage->logger = logger;
+            stage->next = logger->stages;
+            logger->stages = stage;
+            created = 1;
+        }
+    }
+    logger_mutex_unlock(&logger->stages_lock);
+
+    /* threads_lock se prend avant stages_lock : inscription une fois ce dernier relâché */
+    if (created) {
+        stage_attach_thread(stage);
+    }
+
+    if (stage != NULL) {
+        tls_stage.logger_id = logger->id;
+        tls_stage.stage = stage;
+    }
+    return stage;
+}
+
+/* Garantit la place d'une entrée et de nbytes octets dans un tampon */
+static int buffer_reserve(stage_buffer_t* buffer, size_t nbytes) {
+    if (buffer->count == buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : 64;
+        stage_entry_t* entries = realloc(buffer->entries, capacity * sizeof(stage_entry_t));
+        if (entries == NULL) {
+            return -1;
+        }
+        buffer->entries = entries;
+        buffer->capacity = capacity;
+    }
+
+    if (buffer->used + nbytes > buffer->bytes_capacity) {
+        size_t capacity = buffer->bytes_capacity ? buffer->bytes_capacity : 4096;
+        while (capacity < buffer->used + nbytes) {
+            capacity *= 2;
+        }
+        char* bytes = realloc(buffer->bytes, capacity);
+        if (bytes == NULL) {
+            return -1;
+        }
+        buffer->bytes = bytes;
+        buffer->bytes_capacity = capacity;
+    }
+
+    return 0;
+}
+
+static void buffer_free(stage_buffer_t* buffer) {
+    free(buffer->entries);
+    free(buffer->bytes);
+}
+
+static int compare_items(const void* a, const void* b) {
+    unsigned long long sa = ((const struct stage_item_s*)a)->entry->sequence;
+    unsigned long long sb = ((const struct stage_item_s*)b)->entry->sequence;
+    return (sa > sb) - (sa < sb);
+}
+
+int stage_init(hdf5_logger_t* logger) {
+    logger->id = (unsigned long)(atomic_add_size(&next_logger_id, 1) + 1);
+    if (logger_mutex_init(&logger->io_lock) < 0) {
+        return -1;
+    }
+    if (logger_mutex_init(&logger->stages_lock) < 0) {
+        logger_mutex_destroy(&logger->io_lock);
+        return -1;
+    }
+    return 0;
+}
+
+static void stage_free(thread_stage_t* stage) {
+    logger_mutex_destroy(&stage->lock);
+    buffer_free(&stage->active);
+    buffer_free(&stage->spare);
+    free(stage);
+}
+
+void stage_detach(hdf5_logger_t* logger) {
+    logger_once(&stage_once, stage_key_init);
+    if (!stage_key_ready) {
+        return;
+    }
+
+    /* Attend aussi la fin d'un destructeur en train de libérer un tampon de ce logger */
+    logger_mutex_lock(&threads_lock);
+    for (thread_stage_t* stage = logger->stages; stage != NULL; stage = stage->next) {
+        if (stage->thread_link != NULL) {
+            stage_unlink_thread(stage);
+        }
+    }
+    logger_mutex_unlock(&threads_lock);
+}
+
+void stage_destroy(hdf5_logger_t* logger) {
+    thread_stage_t* stage = logger->stages;
+    while (stage != NULL) {
+        thread_stage_t* next = stage->next;
+        stage_free(stage);
+        stage = next;
+    }
+    logger->stages = NULL;
+
+    free(logger->merge_items);
+    logger->merge_items = NULL;
+    logger->merge_capacity = 0;
+
+    logger_mutex_destroy(&logger->stages_lock);
+    logger_mutex_destroy(&logger->io_lock);
+}
+
+int stage_text(hdf5_logger_t* logger, hdf5_log_channel_t* channel, const char* group_path,
+               hdf5_log_level_t level, unsigned int format_id, const char* data, size_t length) {
+    thread_stage_t* stage = stage_get(logger);
+    if (stage == NULL) {
+        return -1;
+    }
+
+    double now = get_current_time();
+
+    logger_mutex_lock(&stage->lock);
+    stage_buffer_t* buffer = &stage->active;
+
+    /* Le chemin n'est recopié que s'il diffère de celui de l'entrée précédente */
+    size_t path_length = 0;
+    size_t path_offset = 0;
+    if (channel == NULL) {
+        const stage_entry_t* previous = (buffer->count > 0) ? &buffer->entries[buffer->count - 1] : NULL;
+        if (previous != NULL && previous->channel == NULL &&
+            strcmp(buffer->bytes + previous->path_offset, group_path) == 0) {
+            path_offset = previous->path_offset;
+        } else {
+            path_length = strlen(group_path) + 1;
+        }
+    }
+
+    if (buffer_reserve(buffer, path_length + length) < 0) {
+        logger_mutex_unlock(&stage->lock);
+        return -1;
+    }
+
+    if (path_length > 0) {
+        path_offset = buffer->used;
+        memcpy(buffer->bytes + buffer->used, group_path, path_length);
+        buffer->used += path_length;
+    }
+
+    stage_entry_t* entry = &buffer->entries[buffer->count++];
+    entry->channel = channel;
+    entry->path_offset = path_offset;
+    entry->log_level = (int)level;
+    entry->timestamp = now;
+    entry->format_id = format_id;
+    entry->offset = buffer->used;
+    entry->length = length;
+    memcpy(buffer->bytes + buffer->used, data, length);
+    buffer->used += length;
+
+    /* Numéro pris sous le verrou du tampon : les entrées d'un tampon restent dans l'ordre */
+    entry->sequence = logger_next_sequence(logger, 1);
+
+    if (stage->first_time == 0.0) {
+        stage->first_time = now;
+    }
+    size_t count = buffer->count;
+    size_t used = buffer->used;
+    double first_time = stage->first_time;
+    logger_mutex_unlock(&stage->lock);
+
+    /* Seuils de la politique de regroupement, appliqués au tampon du thread */
+    size_t max_entries = logger->batch_max_entries;
+    if (max_entries > STAGE_MAX_ENTRIES) {
+        max_entries = STAGE_MAX_ENTRIES;
+    }
+    size_t max_bytes = logger->batch_max_bytes;
+    int due = count >= max_entries || (max_bytes > 0 && used >= max_bytes) ||
+              (logger->batch_max_delay > 0 && now - first_time >= logger->batch_max_delay);
+    if (!due) {
+        return 0;
+    }
+
+    /* Un autre thread qui fusionne déjà prendra aussi ce tampon ; n'attendre que s'il déborde,
+     * ou si la politique demande une écriture immédiate de chaque entrée */
+    if (max_entries == 1 || count >= max_entries * STAGE_BLOCK_FACTOR ||
+        (max_bytes > 0 && used >= max_bytes * STAGE_BLOCK_FACTOR)) {
+        logger_mutex_lock(&logger->io_lock);
+    } else if (!logger_mutex_trylock(&logger->io_lock)) {
+        return 0;
+    }
+
+    int status = stage_merge(logger);
+    logger_mutex_unlock(&logger->io_lock);
+    return status;
+}
+
+int stage_merge(hdf5_logger_t* logger) {
+    /* On n'ajoute que par la tête et on ne retire que sous io_lock, tenu ici : la parcourir
+     * depuis une tête lue sous verrou */
+    logger_mutex_lock(&logger->stages_lock);
+    thread_stage_t* head = logger->stages;
+    logger_mutex_unlock(&logger->stages_lock);
+
+    /* Échanger chaque tampon plein contre le tampon vide : les threads continuent sans attendre.
+     * Un tampon de réserve non vide (fusion précédente en échec) est repris tel quel */
+    size_t total = 0;
+    for (thread_stage_t* stage = head; stage != NULL; stage = stage->next) {
+        logger_mutex_lock(&stage->lock);
+        if (stage->active.count > 0 && stage->spare.count == 0) {
+            stage_buffer_t swap = stage->active;
+            stage->active = stage->spare;
+            stage->spare = swap;
+            stage->first_time = 0.0;
+        }
+        logger_mutex_unlock(&stage->lock);
+        total += stage->spare.count;
+    }
+
+    if (total == 0) {
+        return 0;
+    }
+
+    if (total > logger->merge_capacity) {
+        struct stage_item_s* items = realloc(logger->merge_items, total * sizeof(struct stage_item_s));
+        if (items == NULL) {
+            return -1;
+        }
+        logger->merge_items = items;
+        logger->merge_capacity = total;
+    }
+
+    struct stage_item_s* items = logger->merge_items;
+    size_t n = 0;
+    for (thread_stage_t* stage = head; stage != NULL; stage = stage->next) {
+        for (size_t i = 0; i < stage->spare.count; i++) {
+            items[n].entry = &stage->spare.entries[i];
+            items[n].bytes = stage->spare.bytes;
+            n++;
+        }
+    }
+
+    /* Ordre global des appels, quel que soit le thread */
+    qsort(items, n, sizeof(struct stage_item_s), compare_items);
+
+    int result = 0;
+    const char* last_path = NULL;
+    hdf5_log_channel_t* last_channel = NULL;
+    for (size_t i = 0; i < n; i++) {
+        const stage_entry_t* entry = items[i].entry;
+        hdf5_log_channel_t* channel = entry->channel;
+
+        if (channel == NULL) {
+            const char* path = items[i].bytes + entry->path_offset;
+            if (last_path == NULL || strcmp(last_path, path) != 0) {
+                last_channel = channel_get(logger, path);
+                last_path = path;
+            }
+            channel = last_channel;
+        }
+
+        if (channel == NULL ||
+            channel_append(channel, (hdf5_log_level_t)entry->log_level, entry->timestamp,
+                           entry->sequence, entry->format_id, items[i].bytes + entry->offset,
+                           entry->length) < 0) {
+            result = -1;
+        }
+    }
+
+    for (thread_stage_t* stage = head; stage != NULL; stage = stage->next) {
+        stage->spare.count = 0;
+        stage->spare.used = 0;
+    }
+
+    return result;
+}
+
+int logger_lock(hdf5_logger_t* logger) {
+    if (logger == NULL) {
+        return -1;
+    }
+
+    /* Les opérations synchrones voient tout ce qui a été logué avant elles ; un échec de
+     * l'écriture de ces entrées est signalé à l'appelant, le verrou relâché */
+    int status = 0;
+    if (logger->async != NULL && async_flush(logger, 0) < 0) {
+        status = -1;
+    }
+    logger_mutex_lock(&logger->io_lock);
+    if (logger->async == NULL && stage_merge(logger) < 0) {
+        status = -1;
+    }
+    if (status < 0) {
+        logger_mutex_unlock(&logger->io_lock);
+    }
+    return status;
+}
+
+void logger_unlock(hdf5_logger_t* logger) {
+    logger_mutex_unlock(&logger->io_lock);
+}
@@ -0,0 +1,604 @@
+/**
+ * @file hdf5_logger_store.c
+ * @brief Stockage compact des logs texte : table d'enregistrements et tas d'octets
+ *
+ * Deux modes coexistent. En mode linéaire, records et message_heap croissent à
+ * la fin. En mode anneau (groupes limités par max_entries), records est
+ * préalloué à la capacité et réécrit en place à la position ring_head, et le
+ * tas est un tampon circulaire : les positions des messages sont logiques
+ * (croissantes) et la position physique est leur reste modulo l'étendue du tas.
+ * Les enregistrements sont rangés par horodatage croissant, ce qui permet de
+ * localiser par dichotomie le début des entrées encore valides.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+/* Nombre d'enregistrements par chunk de la table */
+#define RECORDS_CHUNK_ROWS 512
+
+/* Taille des chunks du tas de messages (en octets) */
+#define HEAP_CHUNK_BYTES 65536
+
+/* Nombre d'enregistrements lus à la fois lors d'un parcours */
+#define READ_BLOCK_ROWS 1024
+
+hid_t create_text_record_type(void) {
+    hid_t datatype_id = H5Tcreate(H5T_COMPOUND, sizeof(text_record_t));
+    if (datatype_id < 0) {
+        return -1;
+    }
+
+    H5Tinsert(datatype_id, "log_level", HOFFSET(text_record_t, log_level), H5T_NATIVE_INT);
+    H5Tinsert(datatype_id, "length", HOFFSET(text_record_t, length), H5T_NATIVE_UINT);
+    H5Tinsert(datatype_id, "timestamp", HOFFSET(text_record_t, timestamp), H5T_NATIVE_DOUBLE);
+    H5Tinsert(datatype_id, "offset", HOFFSET(text_record_t, offset), H5T_NATIVE_ULLONG);
+    H5Tinsert(datatype_id, "sequence", HOFFSET(text_record_t, sequence), H5T_NATIVE_ULLONG);
+    H5Tinsert(datatype_id, "format_id", HOFFSET(text_record_t, format_id), H5T_NATIVE_UINT);
+
+    return datatype_id;
+}
+
+/* Crée un dataset 1D chunké d'étendue initiale size, extensible sans limite */
+static hid_t create_chunked_dataset(hid_t group_id, const char* name, hid_t datatype_id,
+                                    hsize_t size, hsize_t chunk_rows,
+                                    const hdf5_codec_policy_t* codec) {
+    hsize_t dims[1] = {size};
+    hsize_t maxdims[1] = {H5S_UNLIMITED};
+    hid_t dataspace_id = H5Screate_simple(1, dims, maxdims);
+
+    hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
+    hsize_t chunk_dims[1] = {chunk_rows};
+    H5Pset_chunk(plist_id, 1, chunk_dims);
+    if (codec_apply(plist_id, codec, H5Tget_size(datatype_id), 0) < 0) {
+        H5Pclose(plist_id);
+        H5Sclose(dataspace_id);
+        return -1;
+    }
+
+    hid_t dataset_id = H5Dcreate2(group_id, name, datatype_id, dataspace_id,
+                                  H5P_DEFAULT, plist_id, H5P_DEFAULT);
+
+    H5Pclose(plist_id);
+    H5Sclose(dataspace_id);
+
+    return dataset_id;
+}
+
+/* Renvoie l'étendue courante d'un dataset 1D */
+static hsize_t dataset_extent(hid_t dataset_id) {
+    hsize_t dims[1] = {0};
+    hid_t dataspace_id = H5Dget_space(dataset_id);
+    H5Sget_simple_extent_dims(dataspace_id, dims, NULL);
+    H5Sclose(dataspace_id);
+    return dims[0];
+}
+
+/* Écrit count éléments à partir de start dans un dataset 1D */
+static herr_t write_range(hid_t dataset_id, hid_t mem_type, hsize_t start, hsize_t count,
+                          const void* buffer) {
+    hsize_t offset[1] = {start};
+    hsize_t size[1] = {count};
+
+    hid_t dataspace_id = H5Dget_space(dataset_id);
+    H5Sselect_hyperslab(dataspace_id, H5S_SELECT_SET, offset, NULL, size, NULL);
+    hid_t mem_space = H5Screate_simple(1, size, NULL);
+
+    herr_t status = H5Dwrite(dataset_id, mem_type, mem_space, dataspace_id, H5P_DEFAULT, buffer);
+
+    H5Sclose(mem_space);
+    H5Sclose(dataspace_id);
+    return status;
+}
+
+/* Lit count éléments à partir de start dans un dataset 1D */
+static herr_t read_range(hid_t dataset_id, hid_t mem_type, hsize_t start, hsize_t count,
+                         void* buffer) {
+    hsize_t offset[1] = {start};
+    hsize_t size[1] = {count};
+
+    hid_t dataspace_id = H5Dget_space(dataset_id);
+    H5Sselect_hyperslab(dataspace_id, H5S_SELECT_SET, offset, NULL, size, NULL);
+    hid_t mem_space = H5Screate_simple(1, size, NULL);
+
+    herr_t status = H5Dread(dataset_id, mem_type, mem_space, dataspace_id, H5P_DEFAULT, buffer);
+
+    H5Sclose(mem_space);
+    H5Sclose(dataspace_id);
+    return status;
+}
+
+/* Agrandit un dataset 1D par pas de chunk pour contenir needed éléments */
+static int ensure_extent(hid_t dataset_id, hsize_t* extent, hsize_t needed, hsize_t step) {
+    if (needed <= *extent) {
+        return 0;
+    }
+
+    hsize_t new_dims[1] = {((needed + step - 1) / step) * step};
+    if (H5Dset_extent(dataset_id, new_dims) < 0) {
+        return -1;
+    }
+
+    *extent = new_dims[0];
+    return 0;
+}
+
+/* Lit ou écrit length octets du tas à partir d'une position logique */
+static herr_t heap_io(const text_store_t* store, hsize_t position, hsize_t length,
+                      void* buffer, int is_write) {
+    hsize_t physical = position;
+    hsize_t first = length;
+
+    /* En mode anneau, une plage peut déborder de la fin du tas et reprendre au début */
+    if (store->ring_capacity > 0) {
+        physical = position % store->heap_extent;
+        if (physical + length > store->heap_extent) {
+            first = store->heap_extent - physical;
+        }
+    }
+
+    herr_t status = is_write
+        ? write_range(store->heap_id, H5T_NATIVE_UCHAR, physical, first, buffer)
+        : read_range(store->heap_id, H5T_NATIVE_UCHAR, physical, first, buffer);
+
+    if (status >= 0 && first < length) {
+        unsigned char* rest = (unsigned char*)buffer + first;
+        status = is_write
+            ? write_range(store->heap_id, H5T_NATIVE_UCHAR, 0, length - first, rest)
+            : read_range(store->heap_id, H5T_NATIVE_UCHAR, 0, length - first, rest);
+    }
+
+    return status;
+}
+
+/* Position physique dans records de l'enregistrement d'indice chronologique index */
+static hsize_t record_slot(const text_store_t* store, hsize_t index) {
+    if (store->ring_capacity == 0) {
+        return index;
+    }
+    return (store->ring_head + store->ring_capacity - store->count + index) % store->ring_capacity;
+}
+
+void store_init(text_store_t* store) {
+    memset(store, 0, sizeof(*store));
+    store->records_id = -1;
+    store->heap_id = -1;
+}
+
+int store_open(text_store_t* store, hid_t group_id, hid_t record_type_id) {
+    store_init(store);
+
+    if (H5Lexists(group_id, TEXT_RECORDS_DATASET, H5P_DEFAULT) <= 0 ||
+        H5Lexists(group_id, TEXT_HEAP_DATASET, H5P_DEFAULT) <= 0) {
+        return 0;
+    }
+
+    store->records_id = H5Dopen2(group_id, TEXT_RECORDS_DATASET, H5P_DEFAULT);
+    store->heap_id = H5Dopen2(group_id, TEXT_HEAP_DATASET, H5P_DEFAULT);
+    if (store->records_id < 0 || store->heap_id < 0) {
+        store_close(store);
+        return -1;
+    }
+
+    store->extent = dataset_extent(store->records_id);
+    store->heap_extent = dataset_extent(store->heap_id);
+
+    /* Les longueurs logiques peuvent être inférieures aux étendues allouées */
+    store->count = store->extent;
+    store->heap_size = store->heap_extent;
+    read_scalar_attribute(store->records_id, "entry_count", H5T_NATIVE_HSIZE, &store->count);
+    read_scalar_attribute(store->heap_id, "heap_size", H5T_NATIVE_HSIZE, &store->heap_size);
+    if (store->count > store->extent) {
+        store->count = store->extent;
+    }
+
+    /* Mode anneau : la capacité est l'étendue de records, ring_head la prochaine case */
+    read_scalar_attribute(store->records_id, "ring_capacity", H5T_NATIVE_HSIZE,
+                          &store->ring_capacity);
+    if (store->ring_capacity > 0) {
+        read_scalar_attribute(store->records_id, "ring_head", H5T_NATIVE_HSIZE, &store->ring_head);
+        if (store->ring_capacity != store->extent || store->ring_head >= store->ring_capacity) {
+            store_close(store);
+            return -1;
+        }
+
+        /* Le début du tas vivant est le message de l'enregistrement le plus ancien */
+        store->heap_tail = store->heap_size;
+        if (store->count > 0) {
+            text_record_t oldest;
+            if (read_range(store->records_id, record_type_id, record_slot(store, 0), 1,
+                           &oldest) < 0) {
+                store_close(store);
+                return -1;
+            }
+            store->heap_tail = oldest.offset;
+            store->first_timestamp = oldest.timestamp;
+        }
+    } else {
+        if (store->heap_size > store->heap_extent) {
+            store->heap_size = store->heap_extent;
+        }
+        if (store->count > 0 && store_read_timestamp(store, 0, &store->first_timestamp) < 0) {
+            store_close(store);
+            return -1;
+        }
+    }
+
+    return 1;
+}
+
+int store_create(text_store_t* store, hid_t group_id, hid_t record_type_id,
+                 hsize_t ring_capacity, const hdf5_codec_policy_t* codec) {
+    store_init(store);
+
+    if (ring_capacity > 0) {
+        /* Anneau : records préalloué à la capacité, tas initial d'un chunk */
+        hsize_t chunk_rows = (ring_capacity < RECORDS_CHUNK_ROWS) ? ring_capacity : RECORDS_CHUNK_ROWS;
+        store->records_id = create_chunked_dataset(group_id, TEXT_RECORDS_DATASET, record_type_id,
+                                                   ring_capacity, chunk_rows, codec);
+        store->heap_id = create_chunked_dataset(group_id, TEXT_HEAP_DATASET, H5T_NATIVE_UCHAR,
+                                                HEAP_CHUNK_BYTES, HEAP_CHUNK_BYTES, codec);
+        store->extent = ring_capacity;
+        store->heap_extent = HEAP_CHUNK_BYTES;
+        store->ring_capacity = ring_capacity;
+    } else {
+        store->records_id = create_chunked_dataset(group_id, TEXT_RECORDS_DATASET, record_type_id,
+                                                   0, RECORDS_CHUNK_ROWS, codec);
+        store->heap_id = create_chunked_dataset(group_id, TEXT_HEAP_DATASET, H5T_NATIVE_UCHAR,
+                                                0, HEAP_CHUNK_BYTES, codec);
+    }
+
+    if (store->records_id < 0 || store->heap_id < 0) {
+        store_close(store);
+        return -1;
+    }
+
+    if (ring_capacity > 0 &&
+        (write_scalar_attribute(store->records_id, "ring_capacity", H5T_NATIVE_HSIZE,
+                                &store->ring_capacity) < 0 ||
+         write_scalar_attribute(store->records_id, "ring_head", H5T_NATIVE_HSIZE,
+                                &store->ring_head) < 0)) {
+        store_close(store);
+        return -1;
+    }
+
+    /* Indiquer aux lecteurs la disposition des logs de ce groupe */
+    int version = TEXT_LAYOUT_COMPACT;
+    return write_scalar_attribute(group_id, "text_layout_version", H5T_NATIVE_INT, &version);
+}
+
+int store_delete(text_store_t* store, hid_t group_id) {
+    store_close(store);
+
+    herr_t status = H5Ldelete(group_id, TEXT_RECORDS_DATASET, H5P_DEFAULT);
+    if (H5Ldelete(group_id, TEXT_HEAP_DATASET, H5P_DEFAULT) < 0) {
+        status = -1;
+    }
+
+    return (status < 0) ? -1 : 0;
+}
+
+void store_close(text_store_t* store) {
+    /* En mode anneau, les étendues portent la géométrie du tampon : ne pas les toucher.
+     * Un stockage seulement relu n'est jamais modifié, même ouvert en lecture seule */
+    int shrink = (store->ring_capacity == 0 && store->appended);
+
+    if (store->records_id >= 0) {
+        /* Ramener les étendues aux longueurs logiques pour les lecteurs */
+        if (shrink && store->extent > store->count) {
+            hsize_t dims[1] = {store->count};
+            H5Dset_extent(store->records_id, dims);
+        }
+        H5Dclose(store->records_id);
+    }
+
+    if (store->heap_id >= 0) {
+        if (shrink && store->heap_extent > store->heap_size) {
+            hsize_t dims[1] = {store->heap_size};
+            H5Dset_extent(store->heap_id, dims);
+        }
+        H5Dclose(store->heap_id);
+    }
+
+    store->records_id = -1;
+    store->heap_id = -1;
+}
+
+/* Agrandit le tas circulaire à new_extent en replaçant les octets vivants */
+static int ring_grow_heap(text_store_t* store, hsize_t new_extent, hsize_t live_start) {
+    hsize_t live = store->heap_size - live_start;
+    unsigned char* bytes = NULL;
+
+    if (live > 0) {
+        bytes = malloc(live);
+        if (bytes == NULL || heap_io(store, live_start, live, bytes, 0) < 0) {
+            free(bytes);
+            return -1;
+        }
+    }
+
+    hsize_t dims[1] = {new_extent};
+    if (H5Dset_extent(store->heap_id, dims) < 0) {
+        free(bytes);
+        return -1;
+    }
+    store->heap_extent = new_extent;
+
+    /* Les positions physiques dépendent de l'étendue : réécrire les octets vivants */
+    herr_t status = (live > 0) ? heap_io(store, live_start, live, bytes, 1) : 0;
+    free(bytes);
+
+    return (status < 0) ? -1 : 0;
+}
+
+/* Ajout en mode anneau : écrase les enregistrements les plus anciens, coût indépendant de la capacité */
+static int ring_append(text_store_t* store, hid_t record_type_id, text_record_t* records,
+                       size_t n, const char* bytes, size_t nbytes) {
+    hsize_t capacity = store->ring_capacity;
+
+    /* Un lot plus grand que l'anneau : seuls les derniers enregistrements survivent */
+    if (n > capacity) {
+        size_t skip = n - (size_t)capacity;
+        size_t skipped_bytes = (size_t)records[skip].offset;
+        records += skip;
+        n = (size_t)capacity;
+        bytes += skipped_bytes;
+        nbytes -= skipped_bytes;
+        for (size_t i = 0; i < n; i++) {
+            records[i].offset -= skipped_bytes;
+        }
+    }
+
+    /* Nouveau début du tas vivant : le plus ancien enregistrement qui survit à l'ajout */
+    hsize_t overwritten = (store->count + n > capacity) ? store->count + n - capacity : 0;
+    hsize_t new_tail = store->heap_size + records[0].offset;
+    double new_first = records[0].timestamp;
+    if (overwritten < store->count) {
+        if (overwritten == 0) {
+            new_tail = store->heap_tail;
+            new_first = store->first_timestamp;
+        } else {
+            text_record_t survivor;
+            if (read_range(store->records_id, record_type_id, record_slot(store, overwritten), 1,
+                           &survivor) < 0) {
+                return -1;
+            }
+            new_tail = survivor.offset;
+            new_first = survivor.timestamp;
+        }
+    }
+
+    /* Agrandir le tas en doublant si les octets vivants ne tiennent plus */
+    hsize_t required = store->heap_size + nbytes - new_tail;
+    if (required > store->heap_extent) {
+        hsize_t new_extent = store->heap_extent * 2;
+        while (new_extent < required) {
+            new_extent *= 2;
+        }
+        if (ring_grow_heap(store, new_extent, new_tail) < 0) {
+            return -1;
+        }
+    }
+
+    if (nbytes > 0 && heap_io(store, store->heap_size, nbytes, (void*)bytes, 1) < 0) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        records[i].offset += store->heap_size;
+    }
+
+    /* Écrire les enregistrements à partir de ring_head, en deux morceaux si l'anneau boucle */
+    hsize_t first = capacity - store->ring_head;
+    if (first > n) {
+        first = n;
+    }
+    if (write_range(store->records_id, record_type_id, store->ring_head, first, records) < 0 ||
+        (first < n &&
+         write_range(store->records_id, record_type_id, 0, n - first, records + first) < 0)) {
+        return -1;
+    }
+
+    store->ring_head = (store->ring_head + n) % capacity;
+    store->count = (store->count + n > capacity) ? capacity : store->count + n;
+    store->heap_size += nbytes;
+    store->heap_tail = new_tail;
+    store->first_timestamp = new_first;
+
+    /* Publier le curseur d'écriture pour les lecteurs */
+    if (write_scalar_attribute(store->heap_id, "heap_size", H5T_NATIVE_HSIZE,
+                               &store->heap_size) < 0 ||
+        write_scalar_attribute(store->records_id, "ring_head", H5T_NATIVE_HSIZE,
+                               &store->ring_head) < 0 ||
+        write_scalar_attribute(store->records_id, "entry_count", H5T_NATIVE_HSIZE,
+                               &store->count) < 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int store_append(text_store_t* store, hid_t record_type_id, text_record_t* records, size_t n,
+                 const char* bytes, size_t nbytes) {
+    if (n == 0) {
+        return 0;
+    }
+
+    if (store->ring_capacity > 0) {
+        return ring_append(store, record_type_id, records, n, bytes, nbytes);
+    }
+
+    if (store->count == 0) {
+        store->first_timestamp = records[0].timestamp;
+    }
+
+    /* Les étendues vont grandir : les ramener aux longueurs logiques à la fermeture */
+    store->appended = 1;
+
+    /* Les positions sont relatives à bytes : les ramener à la fin du tas */
+    for (size_t i = 0; i < n; i++) {
+        records[i].offset += store->heap_size;
+    }
+
+    if (nbytes > 0) {
+        if (ensure_extent(store->heap_id, &store->heap_extent, store->heap_size + nbytes,
+                          HEAP_CHUNK_BYTES) < 0 ||
+            write_range(store->heap_id, H5T_NATIVE_UCHAR, store->heap_size, nbytes, bytes) < 0) {
+            return -1;
+        }
+        store->heap_size += nbytes;
+    }
+
+    if (ensure_extent(store->records_id, &store->extent, store->count + n, RECORDS_CHUNK_ROWS) < 0 ||
+        write_range(store->records_id, record_type_id, store->count, n, records) < 0) {
+        return -1;
+    }
+    store->count += n;
+
+    /* Publier les longueurs logiques pour les lecteurs */
+    if (write_scalar_attribute(store->heap_id, "heap_size", H5T_NATIVE_HSIZE,
+                               &store->heap_size) < 0 ||
+        write_scalar_attribute(store->records_id, "entry_count", H5T_NATIVE_HSIZE,
+                               &store->count) < 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int store_read_timestamp(const text_store_t* store, hsize_t index, double* timestamp) {
+    /* Type mémoire réduit au seul champ timestamp */
+    hid_t ts_type = H5Tcreate(H5T_COMPOUND, sizeof(double));
+    H5Tinsert(ts_type, "timestamp", 0, H5T_NATIVE_DOUBLE);
+
+    herr_t status = read_range(store->records_id, ts_type, record_slot(store, index), 1, timestamp);
+
+    H5Tclose(ts_type);
+    return (status < 0) ? -1 : 0;
+}
+
+int store_find_time(const text_store_t* store, hsize_t first, hsize_t last, double cutoff,
+                    hsize_t* index) {
+    /* log2(n) lectures d'un seul horodatage, au lieu de parcourir la plage */
+    while (first < last) {
+        hsize_t middle = first + (last - first) / 2;
+        double timestamp;
+        if (store_read_timestamp(store, middle, &timestamp) < 0) {
+            return -1;
+        }
+
+        if (timestamp < cutoff) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    *index = first;
+    return 0;
+}
+
+int store_drop_front(text_store_t* store, hid_t record_type_id, hsize_t n) {
+    if (n == 0 || store->ring_capacity == 0) {
+        return 0;
+    }
+
+    if (n >= store->count) {
+        store->count = 0;
+        store->heap_tail = store->heap_size;
+    } else {
+        /* Le nouvel enregistrement le plus ancien fixe le début du tas vivant */
+        text_record_t oldest;
+        if (read_range(store->records_id, record_type_id, record_slot(store, n), 1, &oldest) < 0) {
+            return -1;
+        }
+        store->count -= n;
+        store->heap_tail = oldest.offset;
+        store->first_timestamp = oldest.timestamp;
+    }
+
+    return write_scalar_attribute(store->records_id, "entry_count", H5T_NATIVE_HSIZE,
+                                  &store->count);
+}
+
+int store_iterate(const text_store_t* store, hid_t record_type_id, hsize_t start, hsize_t count,
+                  text_visit_t visit, void* user_data) {
+    text_record_t* records = malloc(READ_BLOCK_ROWS * sizeof(text_record_t));
+    char* bytes = NULL;
+    size_t bytes_capacity = 0;
+    int result = 0;
+
+    if (records == NULL) {
+        return -1;
+    }
+
+    for (hsize_t done = 0; done < count && result == 0; ) {
+        hsize_t n = count - done;
+        if (n > READ_BLOCK_ROWS) {
+            n = READ_BLOCK_ROWS;
+        }
+
+        /* Un bloc ne doit pas franchir la fin de l'anneau */
+        hsize_t slot = record_slot(store, start + done);
+        if (store->ring_capacity > 0 && slot + n > store->ring_capacity) {
+            n = store->ring_capacity - slot;
+        }
+
+        /* Les tables créées avant les numéros de séquence et les formats n'ont pas ces champs :
+         * ils restent nuls */
+        memset(records, 0, (size_t)n * sizeof(text_record_t));
+        if (read_range(store->records_id, record_type_id, slot, n, records) < 0) {
+            result = -1;
+            break;
+        }
+
+        /* Lire d'un bloc tous les messages de ces enregistrements */
+        hsize_t base = records[0].offset;
+        hsize_t end = records[0].offset + records[0].length;
+        for (hsize_t i = 1; i < n; i++) {
+            if (records[i].offset < base) {
+                base = records[i].offset;
+            }
+            if (records[i].offset + records[i].length > end) {
+                end = records[i].offset + records[i].length;
+            }
+        }
+
+        /* Un octet de plus pour terminer le dernier message par un zéro */
+        size_t needed = (size_t)(end - base) + 1;
+        if (needed > bytes_capacity) {
+            char* grown = realloc(bytes, needed);
+            if (grown == NULL) {
+                result = -1;
+                break;
+            }
+            bytes = grown;
+            bytes_capacity = needed;
+        }
+
+        if (end > base && heap_io(store, base, end - base, bytes, 0) < 0) {
+            result = -1;
+            break;
+        }
+
+        for (hsize_t i = 0; i < n && result == 0; i++) {
+            /* Terminer le message par un zéro le temps de l'appel */
+            char* message = bytes + (records[i].offset - base);
+            char saved = message[records[i].length];
+            message[records[i].length] = '\0';
+
+            result = visit(&records[i], message, user_data);
+
+            message[records[i].length] = saved;
+        }
+
+        done += n;
+    }
+
+    free(bytes);
+    free(records);
+    return result;
+}
@@ -0,0 +1,525 @@
+/**
+ * @file hdf5_logger_stream.c
+ * @brief Séries de trames : tableaux et images ajoutés une trame par appel
+ *
+ * Une série est un dataset extensible dont le premier axe (illimité) compte
+ * les trames, accompagné d'un dataset d'index qui décrit chaque trame : son
+ * horodatage (<nom>_timestamps) pour les tableaux, une table horodatage et
+ * numéro de séquence (<nom>_frames) pour les images. Les deux restent ouverts
+ * entre les appels, et rien n'est écrit en attribut à chaque trame.
+ *
+ * Les trames de tableaux sont regroupées en mémoire jusqu'à remplir un chunk,
+ * puis écrites en une seule sélection alignée sur les chunks : HDF5 compresse
+ * chaque chunk une fois, sans relire ni recompresser de chunk partiel. Les
+ * trames en attente suivent la politique de regroupement des logs texte
+ * (délai, vidage explicite). Une image occupe à elle seule un chunk, ou un
+ * rang de tuiles si elle est grande : elle est écrite dès l'appel, par les
+ * threads de compression s'il y en a, et relire une image ne décompresse
+ * qu'elle. Seule la prédiction par l'image précédente regroupe plusieurs
+ * images par chunk, mises en attente comme les trames de tableaux.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+/* Suffixes des datasets d'index */
+#define STREAM_TIMES_SUFFIX "_timestamps"
+#define STREAM_FRAMES_SUFFIX "_frames"
+
+/* Taille minimale des chunks des index (en trames) */
+#define STREAM_MIN_INDEX_CHUNK 1024
+
+/* Une image jusqu'à cette taille forme un chunk ; au-delà, elle est découpée en tuiles */
+#define IMAGE_FRAME_CHUNK_BYTES (4 * 1024 * 1024)
+#define IMAGE_TILE_BYTES (1024 * 1024)
+
+/* Images par chunk quand chacune est prédite par la précédente (HDF5_PREDICT_PNG_FRAME) */
+#define IMAGE_SEQUENCE_FRAMES 8
+
+/* Entrée de la table des images d'une série */
+typedef struct {
+    double timestamp;             /* Horodatage de l'image */
+    unsigned long long sequence;  /* Numéro de séquence, commun avec les logs texte */
+} image_frame_record_t;
+
+static hid_t create_frame_record_type(void) {
+    hid_t type_id = H5Tcreate(H5T_COMPOUND, sizeof(image_frame_record_t));
+    if (type_id < 0) {
+        return -1;
+    }
+    H5Tinsert(type_id, "timestamp", HOFFSET(image_frame_record_t, timestamp), H5T_NATIVE_DOUBLE);
+    H5Tinsert(type_id, "sequence", HOFFSET(image_frame_record_t, sequence), H5T_NATIVE_ULLONG);
+    return type_id;
+}
+
+/* Nombre d'entrées d'un dataset selon son premier axe */
+static hsize_t dataset_frames(hid_t dataset_id) {
+    hsize_t dims[HDF5_LOGGER_MAX_RANK] = {0};
+    hid_t space_id = H5Dget_space(dataset_id);
+    H5Sget_simple_extent_dims(space_id, dims, NULL);
+    H5Sclose(space_id);
+    return dims[0];
+}
+
+/* Crée un dataset 1D ou de trames, premier axe illimité et vide */
+static hid_t create_extendible(hid_t group_id, const char* name, hid_t type_id, int rank,
+                               const hsize_t* frame_dims, const hsize_t* chunk_dims,
+                               const hdf5_codec_policy_t* codec, int pixel_rank) {
+    hsize_t dims[HDF5_LOGGER_MAX_RANK];
+    hsize_t maxdims[HDF5_LOGGER_MAX_RANK];
+    dims[0] = 0;
+    maxdims[0] = H5S_UNLIMITED;
+    for (int i = 1; i < rank; i++) {
+        dims[i] = maxdims[i] = frame_dims[i - 1];
+    }
+
+    hid_t space_id = H5Screate_simple(rank, dims, maxdims);
+    hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
+    hid_t dataset_id = -1;
+    if (space_id >= 0 && plist_id >= 0 && H5Pset_chunk(plist_id, rank, chunk_dims) >= 0 &&
+        codec_apply(plist_id, codec, H5Tget_size(type_id), pixel_rank) == 0) {
+        dataset_id = H5Dcreate2(group_id, name, type_id, space_id, H5P_DEFAULT, plist_id,
+                                H5P_DEFAULT);
+    }
+
+    if (plist_id >= 0) H5Pclose(plist_id);
+    if (space_id >= 0) H5Sclose(space_id);
+    return dataset_id;
+}
+
+/* Ouvre une série existante ; vérifie qu'elle est extensible et de même forme et type */
+static int stream_open_existing(frame_stream_t* stream, hid_t group_id, const char* index_name) {
+    stream->dataset_id = H5Dopen2(group_id, stream->name, H5P_DEFAULT);
+    stream->index_id = H5Dopen2(group_id, index_name, H5P_DEFAULT);
+    if (stream->dataset_id < 0 || stream->index_id < 0) {
+        return -1;
+    }
+
+    hid_t type_id = H5Dget_type(stream->dataset_id);
+    int same_type = (H5Tequal(type_id, stream->type_id) > 0);
+    H5Tclose(type_id);
+
+    hsize_t dims[HDF5_LOGGER_MAX_RANK];
+    hsize_t maxdims[HDF5_LOGGER_MAX_RANK];
+    hid_t space_id = H5Dget_space(stream->dataset_id);
+    int rank = H5Sget_simple_extent_ndims(space_id);
+    if (rank == stream->rank + 1) {
+        H5Sget_simple_extent_dims(space_id, dims, maxdims);
+    }
+    H5Sclose(space_id);
+    if (!same_type || rank != stream->rank + 1 || maxdims[0] != H5S_UNLIMITED) {
+        return -1;
+    }
+    for (int i = 0; i < stream->rank; i++) {
+        if (dims[i + 1] != stream->dims[i]) {
+            return -1;
+        }
+    }
+
+    hid_t plist_id = H5Dget_create_plist(stream->dataset_id);
+    int chunk_rank = H5Pget_chunk(plist_id, HDF5_LOGGER_MAX_RANK, stream->chunk_dims);
+    H5Pclose(plist_id);
+    if (chunk_rank != rank) {
+        return -1;
+    }
+
+    /* Les filtres du dataset peuvent différer de la politique actuelle : stream->codec reste
+     * HDF5_CODEC_NONE et le pipeline HDF5 applique ceux du dataset ; la série garde la
+     * précision notée à sa création */
+    quantize_read_attributes(stream->dataset_id, &stream->quantize);
+    stream->written = dims[0];
+
+    /* Une série interrompue peut avoir plus d'entrées d'index écrites que de trames */
+    hsize_t frames[1] = {stream->written};
+    return (dataset_frames(stream->index_id) == stream->written ||
+            H5Dset_extent(stream->index_id, frames) >= 0) ? 0 : -1;
+}
+
+/* Chunks d'une série de tableaux : trames entières tant qu'elles tiennent dans la taille cible */
+static int plan_array_chunks(frame_stream_t* stream) {
+    /* Premier axe fictif assez long pour que le parcours ligne par ligne y coupe le budget */
+    hdf5_array_layout_t layout = {HDF5_ACCESS_ROW_SCAN, stream->logger->array_layout.chunk_bytes};
+    hsize_t plan_dims[HDF5_LOGGER_MAX_RANK];
+    plan_dims[0] = (hsize_t)chunk_target_bytes(&layout);
+    memcpy(plan_dims + 1, stream->dims, (size_t)stream->rank * sizeof(hsize_t));
+    return (chunk_plan(stream->rank + 1, plan_dims, H5Tget_size(stream->type_id), &layout,
+                       stream->chunk_dims) > 0) ? 0 : -1;
+}
+
+/* Chunks d'une série d'images : une image, ou une tuile de pixels entiers d'une image ; avec
+ * la prédiction par l'image précédente, IMAGE_SEQUENCE_FRAMES images ou tuiles se suivent
+ * dans un chunk de même taille au plus */
+static int plan_image_chunks(frame_stream_t* stream) {
+    size_t element_size = H5Tget_size(stream->type_id);
+    hsize_t frames = (predict_select(&stream->codec, element_size) == HDF5_PREDICT_PNG_FRAME)
+                     ? IMAGE_SEQUENCE_FRAMES : 1;
+    stream->chunk_dims[0] = frames;
+    stream->chunk_dims[3] = stream->dims[2];
+    if (stream->frame_bytes <= IMAGE_FRAME_CHUNK_BYTES / frames) {
+        stream->chunk_dims[1] = stream->dims[0];
+        stream->chunk_dims[2] = stream->dims[1];
+        return 0;
+    }
+
+    /* Un élément = un pixel (tous ses canaux) : la tuile porte sur la hauteur et la largeur */
+    hdf5_array_layout_t layout = {HDF5_ACCESS_TILE, IMAGE_TILE_BYTES / frames};
+    size_t pixel_bytes = (size_t)stream->dims[2] * element_size;
+    return (chunk_plan(2, stream->dims, pixel_bytes, &layout, stream->chunk_dims + 1) > 0) ? 0 : -1;
+}
+
+/* Crée les datasets d'une nouvelle série */
+static int stream_create(frame_stream_t* stream, hid_t group_id, const char* index_name) {
+    int is_image = (stream->kind == HDF5_DATA_IMAGE);
+    stream->codec = *codec_resolve(stream->logger, stream->group_path, stream->kind);
+    if ((is_image ? plan_image_chunks(stream) : plan_array_chunks(stream)) < 0) {
+        return -1;
+    }
+
+    const hdf5_quantize_t* quantize = is_image ? NULL
+        : quantize_resolve(stream->logger, stream->group_path, stream->name, stream->dtype);
+    if (quantize != NULL) {
+        stream->quantize = *quantize;
+    }
+    stream->dataset_id = create_extendible(group_id, stream->name, stream->type_id,
+                                           stream->rank + 1, stream->dims, stream->chunk_dims,
+                                           &stream->codec, is_image ? 1 : 0);
+
+    hsize_t index_chunk[1] = {(stream->chunk_dims[0] > STREAM_MIN_INDEX_CHUNK)
+                              ? stream->chunk_dims[0] : STREAM_MIN_INDEX_CHUNK};
+    const hdf5_codec_policy_t* index_codec = codec_resolve(stream->logger, stream->group_path,
+                                                           HDF5_DATA_NUMERIC);
+    stream->index_id = create_extendible(group_id, index_name, stream->index_type_id, 1, NULL,
+                                         index_chunk, index_codec, 0);
+    if (stream->dataset_id < 0 || stream->index_id < 0) {
+        return -1;
+    }
+
+    /* Précision des trames flottantes, fixée pour toute la série */
+    if (stream->quantize.mode != HDF5_QUANTIZE_NONE &&
+        quantize_write_attributes(stream->dataset_id, &stream->quantize) < 0) {
+        return -1;
+    }
+
+    /* Dimensions d'une image : écrites une fois pour toute la série */
+    if (is_image) {
+        unsigned int height = (unsigned int)stream->dims[0];
+        unsigned int width = (unsigned int)stream->dims[1];
+        unsigned int channels = (unsigned int)stream->dims[2];
+        if (write_scalar_attribute(stream->dataset_id, "width", H5T_NATIVE_UINT, &width) < 0 ||
+            write_scalar_attribute(stream->dataset_id, "height", H5T_NATIVE_UINT, &height) < 0 ||
+            write_scalar_attribute(stream->dataset_id, "channels", H5T_NATIVE_UINT,
+                                   &channels) < 0) {
+            return -1;
+        }
+    }
+
+    stream->written = 0;
+    return 0;
+}
+
+/* Ferme les datasets d'une série et la libère, sans écrire ses trames en attente */
+static void stream_free(frame_stream_t* stream) {
+    if (stream->index_id >= 0) H5Dclose(stream->index_id);
+    if (stream->dataset_id >= 0) H5Dclose(stream->dataset_id);
+    if (stream->kind == HDF5_DATA_IMAGE && stream->index_type_id >= 0) {
+        H5Tclose(stream->index_type_id);
+    }
+    free(stream->staged);
+    free(stream->staged_index);
+    free(stream->group_path);
+    free(stream->name);
+    free(stream);
+}
+
+/* Ouvre ou crée la série d'un groupe et l'ajoute à la liste du logger */
+static frame_stream_t* stream_get(hdf5_logger_t* logger, const char* group_path,
+                                  const char* name, hdf5_data_kind_t kind, hdf5_dtype_t dtype,
+                                  hid_t type_id, int rank, const hsize_t* dims) {
+    for (frame_stream_t* stream = logger->streams; stream != NULL; stream = stream->next) {
+        if (strcmp(stream->name, name) == 0 && strcmp(stream->group_path, group_path) == 0) {
+            return stream;
+        }
+    }
+
+    frame_stream_t* stream = (frame_stream_t*)calloc(1, sizeof(frame_stream_t));
+    if (stream == NULL) {
+        return NULL;
+    }
+    stream->logger = logger;
+    stream->kind = kind;
+    stream->dataset_id = -1;
+    stream->index_id = -1;
+    stream->index_type_id = (kind == HDF5_DATA_IMAGE) ? create_frame_record_type()
+                                                      : H5T_NATIVE_DOUBLE;
+    stream->group_path = strdup(group_path);
+    stream->name = strdup(name);
+    stream->dtype = dtype;
+    stream->type_id = type_id;
+    stream->rank = rank;
+    memcpy(stream->dims, dims, (size_t)rank * sizeof(hsize_t));
+    stream->frame_bytes = H5Tget_size(type_id);
+    for (int i = 0; i < rank; i++) {
+        stream->frame_bytes *= (size_t)dims[i];
+    }
+
+    const char* suffix = (kind == HDF5_DATA_IMAGE) ? STREAM_FRAMES_SUFFIX : STREAM_TIMES_SUFFIX;
+    size_t name_length = strlen(name);
+    size_t suffix_length = strlen(suffix);
+    char* index_name = (char*)malloc(name_length + suffix_length + 1);
+    hid_t group_id = create_group_if_not_exists(logger->file_id, group_path);
+    if (stream->group_path == NULL || stream->name == NULL || index_name == NULL ||
+        stream->index_type_id < 0 || group_id < 0) {
+        free(index_name);
+        if (group_id >= 0) H5Gclose(group_id);
+        stream_free(stream);
+        return NULL;
+    }
+    memcpy(index_name, name, name_length);
+    memcpy(index_name + name_length, suffix, suffix_length + 1);
+
+    /* Une série existante (session précédente) est prolongée ; un dataset ordinaire de même
+     * nom n'est jamais remplacé */
+    int status;
+    if (H5Lexists(group_id, name, H5P_DEFAULT) > 0) {
+        status = stream_open_existing(stream, group_id, index_name);
+    } else {
+        status = stream_create(stream, group_id, index_name);
+    }
+    free(index_name);
+    H5Gclose(group_id);
+
+    if (status < 0) {
+        stream_free(stream);
+        return NULL;
+    }
+
+    stream->next = logger->streams;
+    logger->streams = stream;
+    return stream;
+}
+
+/* Ajoute n trames et leurs entrées d'index à la fin des datasets ; view sélectionne les trames
+ * dans leur tampon (NULL = trames denses) */
+static int stream_write(frame_stream_t* stream, const void* frames, const source_view_t* view,
+                        const void* index_entries, size_t n) {
+    int rank = stream->rank + 1;
+    hsize_t extent[HDF5_LOGGER_MAX_RANK];
+    hsize_t start[HDF5_LOGGER_MAX_RANK] = {0};
+    hsize_t count[HDF5_LOGGER_MAX_RANK];
+    extent[0] = stream->written + n;
+    start[0] = stream->written;
+    count[0] = n;
+    for (int i = 1; i < rank; i++) {
+        extent[i] = count[i] = stream->dims[i - 1];
+    }
+
+    int status = 0;
+    if (H5Dset_extent(stream->dataset_id, extent) < 0 ||
+        H5Dset_extent(stream->index_id, extent) < 0) {
+        status = -1;
+    }
+
+    /* Chunks entiers ou de bord : compressés en parallèle quand c'est possible */
+    if (status == 0) {
+        status = chunks_write(stream->logger, stream->dataset_id, stream->type_id, rank, start,
+                              count, stream->chunk_dims, &stream->codec, frames, view);
+    }
+
+    if (status == 0) {
+        hid_t file_space = H5Dget_space(stream->index_id);
+        hid_t mem_space = H5Screate_simple(1, count, NULL);
+        if (H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL) < 0 ||
+            H5Dwrite(stream->index_id, stream->index_type_id, mem_space, file_space,
+                     H5P_DEFAULT, index_entries) < 0) {
+            status = -1;
+        }
+        H5Sclose(mem_space);
+        H5Sclose(file_space);
+    }
+
+    /* En cas d'échec, la série garde sa longueur : les trames suivantes prennent la place */
+    if (status < 0) {
+        extent[0] = stream->written;
+        H5Dset_extent(stream->dataset_id, extent);
+        H5Dset_extent(stream->index_id, extent);
+        return -1;
+    }
+
+    stream->written += n;
+    return 0;
+}
+
+/* Écrit les trames en attente d'une série */
+static int stream_flush(frame_stream_t* stream) {
+    size_t n = stream->staged_count;
+    if (n == 0) {
+        return 0;
+    }
+    stream->staged_count = 0;
+    return stream_write(stream, stream->staged, NULL, stream->staged_index, n);
+}
+
+/* Met en attente l'entrée d'index d'une trame ; renvoie la place de la trame, NULL en cas
+ * d'erreur */
+static unsigned char* stream_stage(frame_stream_t* stream, const void* index_entry) {
+    size_t chunk_frames = (size_t)stream->chunk_dims[0];
+    size_t entry_size = H5Tget_size(stream->index_type_id);
+    if (stream->staged == NULL) {
+        stream->staged = (unsigned char*)malloc(chunk_frames * stream->frame_bytes);
+        stream->staged_index = (unsigned char*)malloc(chunk_frames * entry_size);
+        if (stream->staged == NULL || stream->staged_index == NULL) {
+            free(stream->staged);
+            free(stream->staged_index);
+            stream->staged = NULL;
+            stream->staged_index = NULL;
+            return NULL;
+        }
+    }
+
+    memcpy(stream->staged_index + stream->staged_count * entry_size, index_entry, entry_size);
+    return stream->staged + stream->staged_count++ * stream->frame_bytes;
+}
+
+/* Écrit le chunk des trames en attente s'il est complet, sinon applique le délai des logs texte */
+static int stream_staged(frame_stream_t* stream) {
+    hdf5_logger_t* logger = stream->logger;
+
+    /* Chunk complet : écriture alignée, même après un vidage partiel */
+    if ((stream->written + stream->staged_count) % stream->chunk_dims[0] == 0) {
+        return stream_flush(stream);
+    }
+
+    /* Trames en attente soumises au même délai que les logs texte */
+    double now = get_current_time();
+    if (logger->pending_since == 0.0) {
+        logger->pending_since = now;
+    }
+    if (logger->batch_max_delay > 0 && now - logger->pending_since >= logger->batch_max_delay) {
+        return channel_table_flush(logger);
+    }
+    return 0;
+}
+
+/* Vérifie qu'une trame a la nature, la forme et le type de la série */
+static int stream_matches(const frame_stream_t* stream, hdf5_data_kind_t kind, hid_t type_id,
+                          int rank, const hsize_t* dims) {
+    return stream->kind == kind && stream->type_id == type_id && stream->rank == rank &&
+           memcmp(stream->dims, dims, (size_t)rank * sizeof(hsize_t)) == 0;
+}
+
+int stream_append(hdf5_logger_t* logger, const char* group_path, const char* name,
+                  const void* data, int rank, const hsize_t* dims, hdf5_dtype_t dtype,
+                  double timestamp) {
+    hid_t type_id = dtype_type(logger, dtype);
+    if (type_id < 0) {
+        return -1;
+    }
+    frame_stream_t* stream = stream_get(logger, group_path, name, HDF5_DATA_NUMERIC, dtype,
+                                        type_id, rank, dims);
+    if (stream == NULL || !stream_matches(stream, HDF5_DATA_NUMERIC, type_id, rank, dims)) {
+        return -1;
+    }
+
+    /* Une trame par chunk : rien à regrouper, écriture directe depuis les données de l'appelant,
+     * ou depuis un tampon de travail pour des trames quantifiées */
+    hsize_t chunk_frames = stream->chunk_dims[0];
+    int quantized = (stream->quantize.mode != HDF5_QUANTIZE_NONE);
+    if (chunk_frames == 1 && stream->staged_count == 0) {
+        if (!quantized) {
+            return stream_write(stream, data, NULL, &timestamp, 1);
+        }
+        void* frame = arena_alloc(logger->arena, stream->frame_bytes);
+        if (frame == NULL) {
+            return -1;
+        }
+        quantize_copy(&stream->quantize, dtype, data, frame,
+                      stream->frame_bytes / H5Tget_size(type_id));
+        int status = stream_write(stream, frame, NULL, &timestamp, 1);
+        arena_free(logger->arena, frame);
+        return status;
+    }
+
+    unsigned char* staged = stream_stage(stream, &timestamp);
+    if (staged == NULL) {
+        return -1;
+    }
+    if (quantized) {
+        quantize_copy(&stream->quantize, dtype, data, staged,
+                      stream->frame_bytes / H5Tget_size(type_id));
+    } else {
+        memcpy(staged, data, stream->frame_bytes);
+    }
+    return stream_staged(stream);
+}
+
+int stream_append_image(hdf5_logger_t* logger, const char* group_path, const char* name,
+                        const void* pixel_data, size_t width, size_t height, size_t channels,
+                        hdf5_dtype_t dtype, const source_view_t* view, double timestamp,
+                        unsigned long long sequence) {
+    hsize_t dims[3] = {height, width, channels};
+    hid_t type_id = dtype_type(logger, dtype);
+    if (type_id < 0) {
+        return -1;
+    }
+    frame_stream_t* stream = stream_get(logger, group_path, name, HDF5_DATA_IMAGE, dtype,
+                                        type_id, 3, dims);
+    if (stream == NULL || !stream_matches(stream, HDF5_DATA_IMAGE, type_id, 3, dims)) {
+        return -1;
+    }
+
+    /* Une image par chunk : écriture directe ; sinon, images regroupées comme les tableaux */
+    image_frame_record_t record = {timestamp, sequence};
+    if (stream->chunk_dims[0] == 1 && stream->staged_count == 0) {
+        return stream_write(stream, pixel_data, view, &record, 1);
+    }
+
+    unsigned char* staged = stream_stage(stream, &record);
+    if (staged == NULL) {
+        return -1;
+    }
+    size_t element_size = H5Tget_size(type_id);
+    if (view != NULL) {
+        view_gather(view, pixel_data, element_size, 0, stream->frame_bytes / element_size, staged);
+    } else {
+        memcpy(staged, pixel_data, stream->frame_bytes);
+    }
+    return stream_staged(stream);
+}
+
+int stream_table_flush(hdf5_logger_t* logger) {
+    int result = 0;
+    for (frame_stream_t* stream = logger->streams; stream != NULL; stream = stream->next) {
+        if (stream_flush(stream) < 0) {
+            result = -1;
+        }
+    }
+    return result;
+}
+
+int stream_close(hdf5_logger_t* logger, const char* group_path, const char* name) {
+    for (frame_stream_t** link = &logger->streams; *link != NULL; link = &(*link)->next) {
+        frame_stream_t* stream = *link;
+        if (strcmp(stream->name, name) == 0 && strcmp(stream->group_path, group_path) == 0) {
+            int status = stream_flush(stream);
+            *link = stream->next;
+            stream_free(stream);
+            return status;
+        }
+    }
+    return 0;
+}
+
+int stream_table_close(hdf5_logger_t* logger) {
+    int result = 0;
+    while (logger->streams != NULL) {
+        frame_stream_t* stream = logger->streams;
+        if (stream_flush(stream) < 0) {
+            result = -1;
+        }
+        logger->streams = stream->next;
+        stream_free(stream);
+    }
+    return result;
+}
@@ -8,37 +8,26 @@
 #include <string.h>
 #include <time.h>
 #include "hdf5.h"
-#include "../include/hdf5_logger.h"
+#include "hdf5_logger_internal.h"
 
-/* Structure pour les entrées de log texte */
-typedef struct {
-    int log_level;       /* Niveau de log */
-    double timestamp;    /* Horodatage */
-    char message[1024];  /* Message (taille fixe pour simplifier) */
-} text_log_entry_t;
+/* Nombre d'entrées de l'ancienne disposition lues à la fois */
+#define LEGACY_READ_BLOCK 256
 
-/* Fonction interne pour créer un groupe s'il n'existe pas */
-extern hid_t create_group_if_not_exists(hid_t file_id, const char* group_path);
+/* Taille du tampon d'encodage sur la pile de hdf5_log_textf */
+#define TEXTF_STACK_BYTES 256
 
-/* Implémentation interne de l'ajout de log texte */
-static int add_text_log_entry(hid_t file_id, const char* group_path, 
-                             hdf5_log_level_t level, const char* message) {
-    if (file_id < 0 || group_path == NULL || message == NULL) {
-        return -1;
-    }
-    
-    herr_t status;
-    hid_t group_id, dataset_id, dataspace_id, datatype_id;
-    hsize_t dims[1], new_dims[1];
-    
-    /* Créer le groupe s'il n'existe pas */
-    group_id = create_group_if_not_exists(file_id, group_path);
-    if (group_id < 0) {
-        return -1;
-    }
-    
-    /* Créer un type composé pour l'entrée de log */
-    datatype_id = H5Tcreate(H5T_COMPOUND, sizeof(text_log_entry_t));
+/* Parcours de relecture : reconstitue les messages à formatage différé pour l'appelant */
+typedef struct {
+    hdf5_logger_t* logger;
+    hdf5_text_callback_t callback;
+    void* user_data;
+    char* rendered;          /* Message reconstitué */
+    size_t rendered_capacity;
+} read_context_t;
+
+/* Crée le type composé de l'ancienne disposition log_entries */
+static hid_t create_legacy_entry_type(void) {
+    hid_t datatype_id = H5Tcreate(H5T_COMPOUND, sizeof(text_log_entry_t));
     H5Tinsert(datatype_id, "log_level", HOFFSET(text_log_entry_t, log_level), H5T_NATIVE_INT);
     H5Tinsert(datatype_id, "timestamp", HOFFSET(text_log_entry_t, timestamp), H5T_NATIVE_DOUBLE);
     
@@ -46,195 +35,165 @@ static int add_text_log_entry(hid_t file_id, const char* group_path,
     hid_t string_type = H5Tcopy(H5T_C_S1);
     H5Tset_size(string_type, sizeof(((text_log_entry_t*)0)->message));
     H5Tinsert(datatype_id, "message", HOFFSET(text_log_entry_t, message), string_type);
+    H5Tclose(string_type);
+    
+    return datatype_id;
+}
+
+/* Parcourt les entrées de l'ancienne disposition log_entries d'un groupe */
+static int read_legacy_entries(hid_t group_id, hdf5_text_callback_t callback, void* user_data) {
+    hid_t dataset_id = H5Dopen2(group_id, TEXT_LEGACY_DATASET, H5P_DEFAULT);
+    if (dataset_id < 0) {
+        return -1;
+    }
     
-    /* Déterminer s'il faut créer ou ouvrir le dataset */
-    const char* dataset_name = "log_entries";
-    htri_t dataset_exists = H5Lexists(group_id, dataset_name, H5P_DEFAULT);
+    hid_t datatype_id = create_legacy_entry_type();
+    hid_t dataspace_id = H5Dget_space(dataset_id);
+    hsize_t dims[1] = {0};
+    H5Sget_simple_extent_dims(dataspace_id, dims, NULL);
     
-    if (dataset_exists > 0) {
-        /* Ouvrir le dataset existant */
-        dataset_id = H5Dopen2(group_id, dataset_name, H5P_DEFAULT);
-        dataspace_id = H5Dget_space(dataset_id);
-        H5Sget_simple_extent_dims(dataspace_id, dims, NULL);
-        H5Sclose(dataspace_id);
-        
-        /* Lire l'attribut de limite de taille si présent */
-        htri_t size_limit_exists = H5Aexists(group_id, "max_entries");
-        if (size_limit_exists > 0) {
-            hid_t attr_id = H5Aopen(group_id, "max_entries", H5P_DEFAULT);
-            hsize_t max_entries;
-            H5Aread(attr_id, H5T_NATIVE_HSIZE, &max_entries);
-            H5Aclose(attr_id);
-            
-            /* Si la limite est atteinte, supprimer l'entrée la plus ancienne */
-            if (dims[0] >= max_entries) {
-                /* Décaler les entrées (supprimer la plus ancienne) */
-                if (dims[0] > 1) {
-                    text_log_entry_t* buffer = malloc((dims[0] - 1) * sizeof(text_log_entry_t));
-                    if (buffer) {
-                        /* Lire toutes les entrées sauf la première */
-                        hsize_t start[1] = {1};
-                        hsize_t count[1] = {dims[0] - 1};
-                        
-                        dataspace_id = H5Dget_space(dataset_id);
-                        status = H5Sselect_hyperslab(dataspace_id, H5S_SELECT_SET, 
-                                                  start, NULL, count, NULL);
-                        
-                        hid_t mem_space = H5Screate_simple(1, count, NULL);
-                        status = H5Dread(dataset_id, datatype_id, mem_space, dataspace_id, 
-                                       H5P_DEFAULT, buffer);
-                        
-                        /* Écrire ces entrées au début */
-                        start[0] = 0;
-                        status = H5Sselect_hyperslab(dataspace_id, H5S_SELECT_SET, 
-                                                  start, NULL, count, NULL);
-                        status = H5Dwrite(dataset_id, datatype_id, mem_space, dataspace_id, 
-                                        H5P_DEFAULT, buffer);
-                        
-                        H5Sclose(mem_space);
-                        H5Sclose(dataspace_id);
-                        free(buffer);
-                    }
-                }
-            } else {
-                /* Augmenter la taille pour la nouvelle entrée */
-                new_dims[0] = dims[0] + 1;
-                status = H5Dset_extent(dataset_id, new_dims);
-            }
-        } else {
-            /* Pas de limite, simplement augmenter la taille */
-            new_dims[0] = dims[0] + 1;
-            status = H5Dset_extent(dataset_id, new_dims);
+    text_log_entry_t* buffer = malloc(LEGACY_READ_BLOCK * sizeof(text_log_entry_t));
+    int result = (buffer == NULL) ? -1 : 0;
+    
+    for (hsize_t done = 0; done < dims[0] && result == 0; ) {
+        hsize_t start[1] = {done};
+        hsize_t count[1] = {dims[0] - done};
+        if (count[0] > LEGACY_READ_BLOCK) {
+            count[0] = LEGACY_READ_BLOCK;
         }
-    } else {
-        /* Créer un nouveau dataset extensible */
-        dims[0] = 0;
-        hsize_t maxdims[1] = {H5S_UNLIMITED};
-        dataspace_id = H5Screate_simple(1, dims, maxdims);
-        
-        /* Utiliser le chunking pour permettre les extensions */
-        hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
-        hsize_t chunk_dims[1] = {64};  /* taille de chunk optimisée */
-        H5Pset_chunk(plist_id, 1, chunk_dims);
-        
-        dataset_id = H5Dcreate2(group_id, dataset_name, datatype_id, dataspace_id, 
-                              H5P_DEFAULT, plist_id, H5P_DEFAULT);
-        
-        H5Pclose(plist_id);
-        H5Sclose(dataspace_id);
-        
-        new_dims[0] = 1;  /* Première entrée */
-        status = H5Dset_extent(dataset_id, new_dims);
-    }
-    
-    /* Préparer l'entrée de log */
-    text_log_entry_t entry;
-    entry.log_level = (int)level;
-    entry.timestamp = (double)time(NULL);  /* Timestamp Unix (secondes) */
-    strncpy(entry.message, message, sizeof(entry.message) - 1);
-    entry.message[sizeof(entry.message) - 1] = '\0';  /* S'assurer que la chaîne est terminée */
-    
-    /* Lire l'attribut de limite de temps si présent */
-    htri_t time_limit_exists = H5Aexists(group_id, "max_time_seconds");
-    if (time_limit_exists > 0 && dims[0] > 0) {
-        hid_t attr_id = H5Aopen(group_id, "max_time_seconds", H5P_DEFAULT);
-        double max_time_seconds;
-        H5Aread(attr_id, H5T_NATIVE_DOUBLE, &max_time_seconds);
-        H5Aclose(attr_id);
-        
-        /* Obtenir le timestamp du premier élément pour vérifier la limite de temps */
-        text_log_entry_t first_entry;
-        hsize_t start[1] = {0};
-        hsize_t count[1] = {1};
-        
-        dataspace_id = H5Dget_space(dataset_id);
-        status = H5Sselect_hyperslab(dataspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
         
+        H5Sselect_hyperslab(dataspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
         hid_t mem_space = H5Screate_simple(1, count, NULL);
-        status = H5Dread(dataset_id, datatype_id, mem_space, dataspace_id, H5P_DEFAULT, &first_entry);
-        
+        herr_t status = H5Dread(dataset_id, datatype_id, mem_space, dataspace_id,
+                                H5P_DEFAULT, buffer);
         H5Sclose(mem_space);
-        H5Sclose(dataspace_id);
+        if (status < 0) {
+            result = -1;
+            break;
+        }
         
-        /* Si la fenêtre de temps est dépassée, supprimer les anciennes entrées */
-        if ((entry.timestamp - first_entry.timestamp) > max_time_seconds) {
-            /* Dans cet exemple simplifié, on supprime tout et on recommence */
-            /* Une implémentation plus sophistiquée analyserait chaque entrée */
-            H5Dclose(dataset_id);
-            H5Ldelete(group_id, dataset_name, H5P_DEFAULT);
-            
-            /* Recréer le dataset */
-            dims[0] = 0;
-            hsize_t maxdims[1] = {H5S_UNLIMITED};
-            dataspace_id = H5Screate_simple(1, dims, maxdims);
-            
-            hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
-            hsize_t chunk_dims[1] = {64};
-            H5Pset_chunk(plist_id, 1, chunk_dims);
-            
-            dataset_id = H5Dcreate2(group_id, dataset_name, datatype_id, dataspace_id, 
-                                  H5P_DEFAULT, plist_id, H5P_DEFAULT);
-            
-            H5Pclose(plist_id);
-            H5Sclose(dataspace_id);
-            
-            new_dims[0] = 1;  /* Nouvelle première entrée */
-            status = H5Dset_extent(dataset_id, new_dims);
+        for (hsize_t i = 0; i < count[0] && result == 0; i++) {
+            hdf5_text_entry_t entry;
+            buffer[i].message[sizeof(buffer[i].message) - 1] = '\0';
+            entry.level = (hdf5_log_level_t)buffer[i].log_level;
+            entry.timestamp = buffer[i].timestamp;
+            entry.message = buffer[i].message;
+            entry.sequence = 0;
+            result = callback(&entry, user_data);
         }
+        
+        done += count[0];
     }
     
-    /* Écrire l'entrée à la position appropriée */
-    hsize_t start[1] = {new_dims[0] - 1};
-    hsize_t count[1] = {1};
-    
-    dataspace_id = H5Dget_space(dataset_id);
-    status = H5Sselect_hyperslab(dataspace_id, H5S_SELECT_SET, start, NULL, count, NULL);
-    
-    hid_t mem_space = H5Screate_simple(1, count, NULL);
-    status = H5Dwrite(dataset_id, datatype_id, mem_space, dataspace_id, H5P_DEFAULT, &entry);
-    
-    /* Nettoyage */
-    H5Sclose(mem_space);
+    free(buffer);
     H5Sclose(dataspace_id);
-    H5Dclose(dataset_id);
-    H5Tclose(string_type);
     H5Tclose(datatype_id);
-    H5Gclose(group_id);
-    
-    return (status < 0) ? -1 : 0;
+    H5Dclose(dataset_id);
+    return result;
 }
 
-/* Implémentation des fonctions publiques */
-
-int hdf5_log_text(hdf5_logger_t* logger, hdf5_log_level_t level, const char* message) {
-    if (logger == NULL || message == NULL) {
+/* Implémentation interne de l'ajout de log texte : message formaté ou arguments encodés */
+static int add_text_log_entry(hdf5_logger_t* logger, const char* group_path, 
+                             hdf5_log_level_t level, unsigned int format_id,
+                             const char* data, size_t length) {
+    if (!logger->is_open || group_path == NULL || data == NULL) {
         return -1;
     }
     
-    /* Déterminer le chemin du groupe en fonction du niveau de log */
-    const char* group_path;
+    /* En mode asynchrone, le thread d'écriture fera l'ajout */
+    if (logger->async != NULL) {
+        return async_submit_text(logger, NULL, group_path, level, format_id, data, length);
+    }
+    
+    /* Le canal du groupe est retrouvé (ou ouvert) à la fusion du tampon du thread */
+    return stage_text(logger, NULL, group_path, level, format_id, data, length);
+}
+
+/* Déterminer le chemin du groupe en fonction du niveau de log */
+static const char* level_group_path(hdf5_log_level_t level) {
     switch (level) {
         case HDF5_LOG_DEBUG:
-            group_path = "/text_logs/debug";
-            break;
+            return "/text_logs/debug";
         case HDF5_LOG_INFO:
-            group_path = "/text_logs/info";
-            break;
+            return "/text_logs/info";
         case HDF5_LOG_WARNING:
-            group_path = "/text_logs/warnings";
-            break;
+            return "/text_logs/warnings";
         case HDF5_LOG_ERROR:
-            group_path = "/text_logs/errors";
-            break;
+            return "/text_logs/errors";
         case HDF5_LOG_CRITICAL:
-            group_path = "/text_logs/critical";
-            break;
+            return "/text_logs/critical";
         default:
-            group_path = "/text_logs/unknown";
-            break;
+            return "/text_logs/unknown";
     }
+}
+
+/* Interne le format, encode ses arguments et ajoute l'entrée, sans formater */
+static int add_textf_entry(hdf5_logger_t* logger, const char* group_path, hdf5_log_level_t level,
+                           const char* fmt, va_list args) {
+    if (!logger->is_open) {
+        return -1;
+    }
+    
+    /* Log filtré : le format n'est ni interné ni encodé */
+    if (!level_enabled(logger, group_path, level)) {
+        return 0;
+    }
+    
+    char stack[TEXTF_STACK_BYTES];
+    char* data = stack;
+    size_t length = 0;
+    unsigned int format_id = 0;
+    if (format_encode(logger, fmt, args, &format_id, &data, sizeof(stack), &length) < 0) {
+        return -1;
+    }
+    
+    int status = add_text_log_entry(logger, group_path, level, format_id, data, length);
     
-    return add_text_log_entry(logger->file_id, group_path, level, message);
+    if (data != stack) {
+        free(data);
+    }
+    return status;
+}
+
+/* Implémentation des fonctions publiques */
+
+int hdf5_log_text(hdf5_logger_t* logger, hdf5_log_level_t level, const char* message) {
+    if (logger == NULL || message == NULL) {
+        return -1;
+    }
+    
+    /* Log filtré : rejeté avant toute copie ou tout appel HDF5 */
+    const char* group_path = level_group_path(level);
+    if (!level_enabled(logger, group_path, level)) {
+        return 0;
+    }
+    
+    return add_text_log_entry(logger, group_path, level, 0, message, strlen(message));
+}
+
+int hdf5_log_textf(hdf5_logger_t* logger, hdf5_log_level_t level, const char* fmt, ...) {
+    if (logger == NULL || fmt == NULL) {
+        return -1;
+    }
+    
+    va_list args;
+    va_start(args, fmt);
+    int status = add_textf_entry(logger, level_group_path(level), level, fmt, args);
+    va_end(args);
+    return status;
+}
+
+int hdf5_log_textf_to_group(hdf5_logger_t* logger, const char* group_path,
+                            hdf5_log_level_t level, const char* fmt, ...) {
+    if (logger == NULL || group_path == NULL || fmt == NULL) {
+        return -1;
+    }
+    
+    va_list args;
+    va_start(args, fmt);
+    int status = add_textf_entry(logger, group_path, level, fmt, args);
+    va_end(args);
+    return status;
 }
 
 int hdf5_log_text_to_group(hdf5_logger_t* logger, const char* group_path, 
@@ -243,5 +202,207 @@ int hdf5_log_text_to_group(hdf5_logger_t* logger, const char* group_path,
         return -1;
     }
     
-    return add_text_log_entry(logger->file_id, group_path, level, message);
-}
\ No newline at end of file
+    if (!level_enabled(logger, group_path, level)) {
+        return 0;
+    }
+    
+    return add_text_log_entry(logger, group_path, level, 0, message, strlen(message));
+}
+
+int hdf5_log_text_batch(hdf5_logger_t* logger, const char* group_path,
+                        const hdf5_text_entry_t* entries, size_t n) {
+    if (logger == NULL || !logger->is_open || group_path == NULL || (entries == NULL && n > 0)) {
+        return -1;
+    }
+    
+    /* Les entrées filtrées sont retirées du lot ; il n'est recopié que s'il en contient */
+    size_t kept = 0;
+    for (size_t i = 0; i < n; i++) {
+        kept += level_enabled(logger, group_path, entries[i].level) ? 1 : 0;
+    }
+    if (kept == 0) {
+        return 0;
+    }
+    
+    hdf5_text_entry_t* filtered = NULL;
+    if (kept < n) {
+        filtered = malloc(kept * sizeof(hdf5_text_entry_t));
+        if (filtered == NULL) {
+            return -1;
+        }
+        /* Un seuil peut changer entre les deux passes : ne jamais dépasser kept */
+        size_t j = 0;
+        for (size_t i = 0; i < n && j < kept; i++) {
+            if (level_enabled(logger, group_path, entries[i].level)) {
+                filtered[j++] = entries[i];
+            }
+        }
+        if (j == 0) {
+            free(filtered);
+            return 0;
+        }
+        entries = filtered;
+        n = j;
+    }
+    
+    int status;
+    if (logger->async != NULL) {
+        status = async_submit_text_batch(logger, group_path, entries, n);
+    } else if (logger_lock(logger) < 0) {
+        /* Le verrou fusionne d'abord les tampons des threads : le lot suit leurs entrées */
+        status = -1;
+    } else {
+        hdf5_log_channel_t* channel = channel_get(logger, group_path);
+        status = (channel == NULL) ? -1
+            : channel_append_batch(channel, entries, n, logger_next_sequence(logger, n));
+        logger_unlock(logger);
+    }
+    
+    free(filtered);
+    return status;
+}
+
+/* Rappel de parcours : présente un enregistrement à l'appelant, message reconstitué */
+static int read_visit(const text_record_t* record, const char* message, void* user_data) {
+    read_context_t* context = (read_context_t*)user_data;
+    hdf5_text_entry_t entry;
+    
+    entry.level = (hdf5_log_level_t)record->log_level;
+    entry.timestamp = record->timestamp;
+    entry.sequence = record->sequence;
+    entry.message = message;
+    
+    if (record->format_id != 0) {
+        if (format_render(context->logger, record->format_id, message, record->length,
+                          &context->rendered, &context->rendered_capacity) < 0) {
+            return -1;
+        }
+        entry.message = context->rendered;
+    }
+    
+    return context->callback(&entry, context->user_data);
+}
+
+static int read_text(hdf5_logger_t* logger, const char* group_path,
+                     hdf5_text_callback_t callback, void* user_data) {
+    if (logger == NULL || !logger->is_open || group_path == NULL || callback == NULL) {
+        return -1;
+    }
+    
+    if (strcmp(group_path, "/") != 0 && H5Lexists(logger->file_id, group_path, H5P_DEFAULT) <= 0) {
+        return -1;
+    }
+    
+    /* Le canal écrit d'abord ses entrées en attente pour que la lecture soit complète,
+     * puis oublie les entrées expirées pour que la fenêtre lue soit exacte */
+    hdf5_log_channel_t* channel = channel_get(logger, group_path);
+    if (channel == NULL || channel_flush(channel) < 0 ||
+        retention_apply(channel, get_current_time()) < 0) {
+        return -1;
+    }
+    
+    /* Entrées antérieures à la disposition compacte, en premier car plus anciennes */
+    int result = 0;
+    if (H5Lexists(channel->group_id, TEXT_LEGACY_DATASET, H5P_DEFAULT) > 0) {
+        result = read_legacy_entries(channel->group_id, callback, user_data);
+    }
+    
+    if (result == 0) {
+        read_context_t context = {logger, callback, user_data, NULL, 0};
+        result = channel_iterate(channel, read_visit, &context);
+        free(context.rendered);
+    }
+    
+    return result;
+}
+
+int hdf5_logger_read_text(hdf5_logger_t* logger, const char* group_path,
+                          hdf5_text_callback_t callback, void* user_data) {
+    if (logger_lock(logger) < 0) {
+        return -1;
+    }
+    
+    int result = read_text(logger, group_path, callback, user_data);
+    
+    logger_unlock(logger);
+    return result;
+}
+
+/* Relit un groupe d'un fichier en lecture seule : ni canal, ni écriture, ni purge */
+static int read_text_read_only(hdf5_logger_t* reader, const char* group_path,
+                               hdf5_text_callback_t callback, void* user_data) {
+    hid_t group_id = H5Gopen2(reader->file_id, group_path, H5P_DEFAULT);
+    if (group_id < 0) {
+        return -1;
+    }
+    
+    /* Entrées antérieures à la disposition compacte, en premier car plus anciennes */
+    int result = 0;
+    if (H5Lexists(group_id, TEXT_LEGACY_DATASET, H5P_DEFAULT) > 0) {
+        result = read_legacy_entries(group_id, callback, user_data);
+    }
+    
+    /* Canal réduit au groupe et à ses segments ou à son stockage, sans tampon */
+    hdf5_log_channel_t channel;
+    memset(&channel, 0, sizeof(channel));
+    channel.logger = reader;
+    channel.group_id = group_id;
+    store_init(&channel.store);
+    
+    if (result == 0) {
+        int opened = segments_open(&channel);
+        if (opened == 0) {
+            opened = store_open(&channel.store, group_id, reader->record_type_id);
+        }
+        if (opened < 0) {
+            result = -1;
+        }
+    }
+    
+    if (result == 0) {
+        read_context_t context = {reader, callback, user_data, NULL, 0};
+        result = channel_iterate(&channel, read_visit, &context);
+        free(context.rendered);
+    }
+    
+    if (channel.segmented) {
+        segments_close(&channel);
+    } else {
+        store_close(&channel.store);
+    }
+    H5Gclose(group_id);
+    return result;
+}
+
+int hdf5_logger_read_text_file(const char* filename, const char* group_path,
+                               hdf5_text_callback_t callback, void* user_data) {
+    if (filename == NULL || group_path == NULL || callback == NULL) {
+        return -1;
+    }
+    
+    /* Lecteur minimal : le fichier, le type des enregistrements et les formats internés */
+    hdf5_logger_t* reader = (hdf5_logger_t*)calloc(1, sizeof(hdf5_logger_t));
+    if (reader == NULL) {
+        return -1;
+    }
+    
+    reader->file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (reader->file_id < 0) {
+        free(reader);
+        return -1;
+    }
+    
+    int result = -1;
+    reader->record_type_id = create_text_record_type();
+    if (reader->record_type_id >= 0) {
+        if (format_table_open(reader) == 0) {
+            result = read_text_read_only(reader, group_path, callback, user_data);
+            format_table_close(reader);
+        }
+        H5Tclose(reader->record_type_id);
+    }
+    
+    H5Fclose(reader->file_id);
+    free(reader);
+    return result;
+}
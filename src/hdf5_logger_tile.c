@@ -0,0 +1,344 @@
+/**
+ * @file hdf5_logger_tile.c
+ * @brief Mise à jour partielle des images : réécriture des seules tuiles modifiées
+ *
+ * Une image est stockée en chunks de 128 x 128 pixels. Quand seule une partie
+ * de la scène change, les chunks qui couvrent les régions modifiées sont
+ * recompressés et réécrits en place dans le dataset existant ; les autres ne
+ * sont ni relus ni réécrits, et le coût suit la surface modifiée.
+ *
+ * Sans régions fournies, chaque tuile est comparée à l'image précédente,
+ * gardée en mémoire par dataset (relue une fois du fichier si le dataset
+ * existait avant). La comparaison porte sur 64 octets à la fois en SSE2 et
+ * s'arrête au premier écart.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TILE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/* Empreinte posée par la déduplication, fausse dès qu'une tuile change */
+#define TILE_DEDUP_ATTRIBUTE "content_hash"
+
+/* Les tuiles sont écrites au travers du pipeline HDF5, qui applique les filtres du dataset :
+ * la politique actuelle du groupe peut différer de celle de sa création */
+static const hdf5_codec_policy_t tile_pipeline = {HDF5_CODEC_NONE, 0, 0, HDF5_PREDICT_NONE};
+
+/* Égalité de deux plages d'octets */
+static int bytes_equal(const unsigned char* a, const unsigned char* b, size_t size) {
+    size_t i = 0;
+#ifdef TILE_SSE2
+    for (; i + 64 <= size; i += 64) {
+        __m128i e0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i)),
+                                    _mm_loadu_si128((const __m128i*)(b + i)));
+        __m128i e1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i + 16)),
+                                    _mm_loadu_si128((const __m128i*)(b + i + 16)));
+        __m128i e2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i + 32)),
+                                    _mm_loadu_si128((const __m128i*)(b + i + 32)));
+        __m128i e3 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i + 48)),
+                                    _mm_loadu_si128((const __m128i*)(b + i + 48)));
+        __m128i all = _mm_and_si128(_mm_and_si128(e0, e1), _mm_and_si128(e2, e3));
+        if (_mm_movemask_epi8(all) != 0xFFFF) {
+            return 0;
+        }
+    }
+    for (; i + 16 <= size; i += 16) {
+        __m128i e = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i)),
+                                   _mm_loadu_si128((const __m128i*)(b + i)));
+        if (_mm_movemask_epi8(e) != 0xFFFF) {
+            return 0;
+        }
+    }
+#endif
+    return memcmp(a + i, b + i, size - i) == 0;
+}
+
+static image_shadow_t* tile_find(hdf5_logger_t* logger, const char* group_path,
+                                 const char* name) {
+    for (image_shadow_t* shadow = logger->shadows; shadow != NULL; shadow = shadow->next) {
+        if (strcmp(shadow->group_path, group_path) == 0 && strcmp(shadow->name, name) == 0) {
+            return shadow;
+        }
+    }
+    return NULL;
+}
+
+/* Garde une copie de l'image (pixels NULL : copie à remplir par l'appelant) */
+static image_shadow_t* tile_keep(hdf5_logger_t* logger, const char* group_path, const char* name,
+                                 size_t width, size_t height, size_t channels, hdf5_dtype_t dtype,
+                                 const void* pixels) {
+    size_t bytes = width * height * channels * dtype_size(dtype);
+    image_shadow_t* shadow = (image_shadow_t*)calloc(1, sizeof(image_shadow_t));
+    if (shadow == NULL) {
+        return NULL;
+    }
+    shadow->group_path = strdup(group_path);
+    shadow->name = strdup(name);
+    shadow->pixels = (unsigned char*)malloc(bytes);
+    if (shadow->group_path == NULL || shadow->name == NULL || shadow->pixels == NULL) {
+        free(shadow->group_path);
+        free(shadow->name);
+        free(shadow->pixels);
+        free(shadow);
+        return NULL;
+    }
+    if (pixels != NULL) {
+        memcpy(shadow->pixels, pixels, bytes);
+    }
+    shadow->width = width;
+    shadow->height = height;
+    shadow->channels = channels;
+    shadow->dtype = dtype;
+    shadow->next = logger->shadows;
+    logger->shadows = shadow;
+    return shadow;
+}
+
+void tile_forget(hdf5_logger_t* logger, const char* group_path, const char* name) {
+    for (image_shadow_t** link = &logger->shadows; *link != NULL; link = &(*link)->next) {
+        image_shadow_t* shadow = *link;
+        if (strcmp(shadow->group_path, group_path) == 0 && strcmp(shadow->name, name) == 0) {
+            *link = shadow->next;
+            free(shadow->group_path);
+            free(shadow->name);
+            free(shadow->pixels);
+            free(shadow);
+            return;
+        }
+    }
+}
+
+void tile_destroy(hdf5_logger_t* logger) {
+    image_shadow_t* shadow = logger->shadows;
+    while (shadow != NULL) {
+        image_shadow_t* next = shadow->next;
+        free(shadow->group_path);
+        free(shadow->name);
+        free(shadow->pixels);
+        free(shadow);
+        shadow = next;
+    }
+    logger->shadows = NULL;
+}
+
+/* Ouvre le dataset de l'image s'il peut être mis à jour en place : même forme, même type,
+ * canaux entrelacés, chunks de pixels entiers et aucun autre nom lié ; sinon renvoie -1 */
+static hid_t tile_open(hid_t group_id, const char* image_name, hid_t datatype_id, int rank,
+                       const hsize_t* dims, hsize_t* chunk_dims) {
+    if (H5Lexists(group_id, image_name, H5P_DEFAULT) <= 0) {
+        return -1;
+    }
+    hid_t dataset_id;
+    H5E_BEGIN_TRY {
+        dataset_id = H5Dopen2(group_id, image_name, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if (dataset_id < 0) {
+        return -1;
+    }
+
+    H5O_info_t info;
+    int usable = (H5Oget_info2(dataset_id, &info, H5O_INFO_BASIC) >= 0 && info.rc == 1 &&
+                  H5Aexists(dataset_id, "layout") == 0);
+
+    hid_t type_id = H5Dget_type(dataset_id);
+    usable = usable && H5Tequal(type_id, datatype_id) > 0;
+    H5Tclose(type_id);
+
+    hsize_t extent[3];
+    hid_t space_id = H5Dget_space(dataset_id);
+    usable = usable && H5Sget_simple_extent_ndims(space_id) == rank;
+    if (usable) {
+        H5Sget_simple_extent_dims(space_id, extent, NULL);
+        for (int i = 0; i < rank; i++) {
+            usable = usable && extent[i] == dims[i];
+        }
+    }
+    H5Sclose(space_id);
+
+    hid_t plist_id = H5Dget_create_plist(dataset_id);
+    usable = usable && H5Pget_layout(plist_id) == H5D_CHUNKED &&
+             H5Pget_chunk(plist_id, rank, chunk_dims) == rank &&
+             (rank == 2 || chunk_dims[2] == dims[2]);
+    H5Pclose(plist_id);
+
+    if (!usable) {
+        H5Dclose(dataset_id);
+        return -1;
+    }
+    return dataset_id;
+}
+
+int image_update(hdf5_logger_t* logger, const char* group_path, const char* image_name,
+                 const void* pixel_data, size_t width, size_t height, size_t channels,
+                 hdf5_dtype_t dtype, const hdf5_image_rect_t* rects, size_t rect_count) {
+    hid_t datatype_id = dtype_type(logger, dtype);
+    if (datatype_id < 0) {
+        return -1;
+    }
+
+    /* Image grayscale (2D) ou couleur (3D), comme image_write */
+    int rank = (channels == 1) ? 2 : 3;
+    hsize_t dims[3] = {height, width, channels};
+    hsize_t chunk_dims[3];
+
+    hid_t group_id = create_group_if_not_exists(logger->file_id, group_path);
+    if (group_id < 0) {
+        return -1;
+    }
+    hid_t dataset_id = tile_open(group_id, image_name, datatype_id, rank, dims, chunk_dims);
+    if (group_id != logger->file_id) {
+        H5Gclose(group_id);
+    }
+
+    /* Première écriture ou dataset qui ne peut pas être mis à jour : image entière */
+    if (dataset_id < 0) {
+        int status = image_write(logger, group_path, image_name, pixel_data, width, height,
+                                 channels, dtype, NULL);
+        if (status == 0 && rects == NULL) {
+            tile_keep(logger, group_path, image_name, width, height, channels, dtype,
+                      pixel_data);
+        }
+        return status;
+    }
+
+    /* Image précédente, relue du fichier si elle n'est pas encore gardée */
+    image_shadow_t* shadow = tile_find(logger, group_path, image_name);
+    if (shadow != NULL && (shadow->width != width || shadow->height != height ||
+                           shadow->channels != channels || shadow->dtype != dtype)) {
+        tile_forget(logger, group_path, image_name);
+        shadow = NULL;
+    }
+    if (rects == NULL && shadow == NULL) {
+        shadow = tile_keep(logger, group_path, image_name, width, height, channels, dtype, NULL);
+        if (shadow == NULL || H5Dread(dataset_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                                      shadow->pixels) < 0) {
+            tile_forget(logger, group_path, image_name);
+            H5Dclose(dataset_id);
+            return -1;
+        }
+    }
+
+    size_t pixel_bytes = channels * dtype_size(dtype);
+    size_t pitch = width * pixel_bytes;
+    size_t tile_height = (size_t)chunk_dims[0];
+    size_t tile_width = (size_t)chunk_dims[1];
+    size_t tiles_y = (height + tile_height - 1) / tile_height;
+    size_t tiles_x = (width + tile_width - 1) / tile_width;
+    unsigned char* dirty = (unsigned char*)calloc(tiles_x * tiles_y, 1);
+    if (dirty == NULL) {
+        H5Dclose(dataset_id);
+        return -1;
+    }
+
+    /* Tuiles modifiées : comparées à l'image précédente, ou couvertes par une région */
+    const unsigned char* pixels = (const unsigned char*)pixel_data;
+    size_t dirty_count = 0;
+    if (rects == NULL) {
+        for (size_t ty = 0; ty < tiles_y; ty++) {
+            size_t y0 = ty * tile_height;
+            size_t rows = (height - y0 < tile_height) ? height - y0 : tile_height;
+            for (size_t tx = 0; tx < tiles_x; tx++) {
+                size_t x0 = tx * tile_width;
+                size_t row_bytes = ((width - x0 < tile_width) ? width - x0 : tile_width) *
+                                   pixel_bytes;
+                size_t offset = y0 * pitch + x0 * pixel_bytes;
+                for (size_t r = 0; r < rows; r++, offset += pitch) {
+                    if (!bytes_equal(pixels + offset, shadow->pixels + offset, row_bytes)) {
+                        dirty[ty * tiles_x + tx] = 1;
+                        dirty_count++;
+                        break;
+                    }
+                }
+            }
+        }
+    } else {
+        for (size_t i = 0; i < rect_count; i++) {
+            if (rects[i].width == 0 || rects[i].height == 0) {
+                continue;
+            }
+            size_t last_y = (rects[i].y + rects[i].height - 1) / tile_height;
+            size_t last_x = (rects[i].x + rects[i].width - 1) / tile_width;
+            for (size_t ty = rects[i].y / tile_height; ty <= last_y; ty++) {
+                for (size_t tx = rects[i].x / tile_width; tx <= last_x; tx++) {
+                    dirty_count += !dirty[ty * tiles_x + tx];
+                    dirty[ty * tiles_x + tx] = 1;
+                }
+            }
+        }
+    }
+
+    /* L'empreinte de la déduplication ne correspond plus au contenu */
+    int status = 0;
+    if (dirty_count > 0 && H5Aexists(dataset_id, TILE_DEDUP_ATTRIBUTE) > 0 &&
+        H5Adelete(dataset_id, TILE_DEDUP_ATTRIBUTE) < 0) {
+        status = -1;
+    }
+
+    /* Tuiles voisines d'une même rangée écrites en un bloc, lu en place dans l'image */
+    for (size_t ty = 0; ty < tiles_y && status == 0; ty++) {
+        size_t tx = 0;
+        while (tx < tiles_x && status == 0) {
+            if (!dirty[ty * tiles_x + tx]) {
+                tx++;
+                continue;
+            }
+            size_t end = tx;
+            while (end < tiles_x && dirty[ty * tiles_x + end]) {
+                end++;
+            }
+
+            hsize_t origin[3] = {ty * tile_height, tx * tile_width, 0};
+            hsize_t block[3] = {tile_height, (end - tx) * tile_width, channels};
+            block[0] = (height - origin[0] < block[0]) ? height - origin[0] : block[0];
+            block[1] = (width - origin[1] < block[1]) ? width - origin[1] : block[1];
+
+            source_view_t view;
+            view.rank = rank;
+            for (int i = 0; i < rank; i++) {
+                view.extent[i] = dims[i];
+                view.offset[i] = origin[i];
+                view.stride[i] = 1;
+                view.count[i] = block[i];
+            }
+            status = chunks_write(logger, dataset_id, datatype_id, rank, origin, block,
+                                  chunk_dims, &tile_pipeline, pixel_data, &view);
+
+            /* L'image gardée suit le fichier */
+            if (status == 0 && shadow != NULL) {
+                size_t offset = (size_t)origin[0] * pitch + (size_t)origin[1] * pixel_bytes;
+                for (hsize_t r = 0; r < block[0]; r++, offset += pitch) {
+                    memcpy(shadow->pixels + offset, pixels + offset,
+                           (size_t)block[1] * pixel_bytes);
+                }
+            }
+            tx = end;
+        }
+    }
+    free(dirty);
+
+    /* Horodatage de la dernière modification */
+    if (status == 0 && dirty_count > 0) {
+        double timestamp = (double)time(NULL);
+        status = write_scalar_attribute(dataset_id, "timestamp", H5T_NATIVE_DOUBLE, &timestamp);
+    }
+
+    /* Les vignettes sont recalculées depuis l'image entière */
+    if (status == 0 && dirty_count > 0) {
+        status = image_pyramid_write(logger, group_path, image_name, pixel_data, width, height,
+                                     channels, dtype, NULL, 0);
+    }
+
+    /* Après un échec, l'image gardée peut ne plus suivre le fichier */
+    if (status < 0) {
+        tile_forget(logger, group_path, image_name);
+    }
+    H5Dclose(dataset_id);
+    return (status < 0) ? -1 : 0;
+}
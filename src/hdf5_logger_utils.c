@@ -6,8 +6,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
 #include "hdf5.h"
-#include "../include/hdf5_logger.h"
+#include "hdf5_logger_internal.h"
 
 /* Implémentation de la fonction interne create_group_if_not_exists */
 hid_t create_group_if_not_exists(hid_t file_id, const char* group_path) {
@@ -44,4 +48,57 @@ hid_t create_group_if_not_exists(hid_t file_id, const char* group_path) {
     return group_id;
 }
 
-/* Fonctions utilitaires supplémentaires pourraient être ajoutées ici */
+double get_current_time(void) {
+#ifdef _WIN32
+    /* FILETIME : intervalles de 100 ns depuis le 1er janvier 1601 */
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    unsigned long long ticks = ((unsigned long long)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+    return (double)(ticks - 116444736000000000ULL) / 1e7;
+#else
+    struct timespec ts;
+    if (clock_gettime(CLOCK_REALTIME, &ts) != 0) {
+        return (double)time(NULL);
+    }
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+}
+
+int read_scalar_attribute(hid_t obj_id, const char* name, hid_t mem_type, void* value) {
+    if (H5Aexists(obj_id, name) <= 0) {
+        return -1;
+    }
+
+    hid_t attr_id = H5Aopen(obj_id, name, H5P_DEFAULT);
+    if (attr_id < 0) {
+        return -1;
+    }
+
+    herr_t status = H5Aread(attr_id, mem_type, value);
+    H5Aclose(attr_id);
+
+    return (status < 0) ? -1 : 0;
+}
+
+int write_scalar_attribute(hid_t obj_id, const char* name, hid_t mem_type, const void* value) {
+    hid_t attr_id;
+
+    if (H5Aexists(obj_id, name) > 0) {
+        /* L'attribut existe, l'ouvrir */
+        attr_id = H5Aopen(obj_id, name, H5P_DEFAULT);
+    } else {
+        /* Créer un nouvel attribut */
+        hid_t dataspace_id = H5Screate(H5S_SCALAR);
+        attr_id = H5Acreate2(obj_id, name, mem_type, dataspace_id, H5P_DEFAULT, H5P_DEFAULT);
+        H5Sclose(dataspace_id);
+    }
+
+    if (attr_id < 0) {
+        return -1;
+    }
+
+    herr_t status = H5Awrite(attr_id, mem_type, value);
+    H5Aclose(attr_id);
+
+    return (status < 0) ? -1 : 0;
+}
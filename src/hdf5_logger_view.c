@@ -0,0 +1,120 @@
+/**
+ * @file hdf5_logger_view.c
+ * @brief Tampons source non contigus : sous-blocs, canaux entrelacés, lignes avec marge
+ *
+ * Un tampon non contigu est décrit par une sélection hyperslab sur un
+ * dataspace mémoire qui couvre tout le tampon. Ses éléments sélectionnés, pris
+ * dans l'ordre C, forment le bloc écrit : HDF5 les lit directement dans le
+ * tampon de l'appelant, et la compression parallèle découpe ses chunks au
+ * même endroit. Le rang du tampon peut différer de celui du bloc : une image
+ * dont les lignes ont une marge est un tampon [hauteur, pas] dont on
+ * sélectionne [hauteur, largeur x canaux].
+ */
+
+#include <string.h>
+#include "hdf5.h"
+#include "hdf5_logger_internal.h"
+
+/* Une sélection qui couvre tout le tampon est un tableau dense : pas de vue */
+static int view_is_dense(const source_view_t* view) {
+    for (int i = 0; i < view->rank; i++) {
+        if (view->offset[i] != 0 || view->count[i] != view->extent[i] ||
+            (view->count[i] > 1 && view->stride[i] != 1)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int view_from_layout(source_view_t* view, int rank, const hsize_t* dims,
+                     const hdf5_source_layout_t* source) {
+    view->rank = rank;
+    for (int i = 0; i < rank; i++) {
+        hsize_t stride = (source->stride[i] == 0) ? 1 : source->stride[i];
+        hsize_t last = source->offset[i] + (dims[i] - 1) * stride;
+        if (dims[i] == 0 || last < source->offset[i] || last >= source->extent[i]) {
+            return -1;
+        }
+        view->extent[i] = source->extent[i];
+        view->offset[i] = source->offset[i];
+        view->stride[i] = stride;
+        view->count[i] = dims[i];
+    }
+    return view_is_dense(view) ? 1 : 0;
+}
+
+int view_from_pitch(source_view_t* view, size_t width, size_t height, size_t channels,
+                    size_t element_size, size_t row_pitch) {
+    size_t row_elements = width * channels;
+    if (row_pitch % element_size != 0 || row_pitch / element_size < row_elements) {
+        return -1;
+    }
+    view->rank = 2;
+    view->extent[0] = height;
+    view->extent[1] = row_pitch / element_size;
+    view->offset[0] = 0;
+    view->offset[1] = 0;
+    view->stride[0] = 1;
+    view->stride[1] = 1;
+    view->count[0] = height;
+    view->count[1] = row_elements;
+    return view_is_dense(view) ? 1 : 0;
+}
+
+hid_t view_space(const source_view_t* view) {
+    hid_t space_id = H5Screate_simple(view->rank, view->extent, NULL);
+    if (space_id < 0) {
+        return -1;
+    }
+    if (H5Sselect_hyperslab(space_id, H5S_SELECT_SET, view->offset, view->stride, view->count,
+                            NULL) < 0) {
+        H5Sclose(space_id);
+        return -1;
+    }
+    return space_id;
+}
+
+void view_gather(const source_view_t* view, const void* data, size_t element_size,
+                 size_t first, size_t count, void* out) {
+    const unsigned char* source = (const unsigned char*)data;
+    unsigned char* target = (unsigned char*)out;
+    int last = view->rank - 1;
+
+    /* Position du premier élément dans la sélection */
+    hsize_t index[HDF5_LOGGER_MAX_RANK];
+    size_t rest = first;
+    for (int i = last; i >= 0; i--) {
+        index[i] = rest % view->count[i];
+        rest /= view->count[i];
+    }
+
+    while (count > 0) {
+        /* Morceau de la dernière dimension : contigu si son pas vaut 1 */
+        hsize_t address = 0;
+        for (int i = 0; i < view->rank; i++) {
+            address = address * view->extent[i] + view->offset[i] + index[i] * view->stride[i];
+        }
+        size_t run = (size_t)(view->count[last] - index[last]);
+        if (run > count) {
+            run = count;
+        }
+        if (view->stride[last] == 1) {
+            memcpy(target, source + address * element_size, run * element_size);
+        } else {
+            size_t step = (size_t)view->stride[last] * element_size;
+            const unsigned char* element = source + address * element_size;
+            for (size_t j = 0; j < run; j++) {
+                memcpy(target + j * element_size, element + j * step, element_size);
+            }
+        }
+        target += run * element_size;
+        count -= run;
+
+        /* Ligne suivante de la sélection */
+        index[last] += run;
+        for (int i = last; i > 0 && index[i] == view->count[i]; i--) {
+            index[i] = 0;
+            index[i - 1]++;
+        }
+    }
+}
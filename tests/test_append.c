@@ -0,0 +1,179 @@
+/**
+ * @file test_append.c
+ * @brief Test des séries temporelles de tableaux (une trame par appel)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define ROWS 16
+#define COLS 8
+#define FRAMES 5000
+#define LARGE_ELEMENTS 100000
+
+static void fill_frame(float* frame, int index) {
+    for (int i = 0; i < ROWS * COLS; i++) {
+        frame[i] = (float)index + (float)i * 0.001f;
+    }
+}
+
+/* Lit les dimensions d'un dataset ; renvoie son rang */
+static int read_dims(hid_t file_id, const char* path, hsize_t* dims, hsize_t* maxdims,
+                     hsize_t* chunk_dims) {
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Ouverture du dataset a échoué");
+    hid_t space_id = H5Dget_space(dataset_id);
+    int rank = H5Sget_simple_extent_dims(space_id, dims, maxdims);
+    hid_t plist_id = H5Dget_create_plist(dataset_id);
+    H5Pget_chunk(plist_id, rank, chunk_dims);
+    H5Pclose(plist_id);
+    H5Sclose(space_id);
+    H5Dclose(dataset_id);
+    return rank;
+}
+
+/* Vérifie une série de trames ROWS x COLS et ses horodatages */
+static void check_series(const char* filename, const char* path, const char* times_path,
+                         hsize_t frames) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+
+    hsize_t dims[3], maxdims[3], chunk_dims[3];
+    int rank = read_dims(file_id, path, dims, maxdims, chunk_dims);
+    assert(rank == 3 && dims[0] == frames && dims[1] == ROWS && dims[2] == COLS &&
+           "Dimensions de la série incorrectes");
+    assert(maxdims[0] == H5S_UNLIMITED && "Le premier axe devrait être illimité");
+    assert(chunk_dims[0] == 512 && chunk_dims[1] == ROWS && chunk_dims[2] == COLS &&
+           "Un chunk devrait regrouper 256 Kio de trames entières");
+
+    float* values = malloc((size_t)frames * ROWS * COLS * sizeof(float));
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    herr_t status = H5Dread(dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, values);
+    assert(status >= 0 && "Relecture des trames a échoué");
+    H5Dclose(dataset_id);
+    float expected[ROWS * COLS];
+    for (hsize_t i = 0; i < frames; i++) {
+        fill_frame(expected, (int)i);
+        assert(memcmp(values + i * ROWS * COLS, expected, sizeof(expected)) == 0 &&
+               "Contenu d'une trame incorrect");
+    }
+    free(values);
+
+    double* times = malloc((size_t)frames * sizeof(double));
+    rank = read_dims(file_id, times_path, dims, maxdims, chunk_dims);
+    assert(rank == 1 && dims[0] == frames && "Un horodatage par trame attendu");
+    dataset_id = H5Dopen2(file_id, times_path, H5P_DEFAULT);
+    status = H5Dread(dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, times);
+    assert(status >= 0 && "Relecture des horodatages a échoué");
+    H5Dclose(dataset_id);
+    for (hsize_t i = 0; i < frames; i++) {
+        assert(times[i] > 0 && (i == 0 || times[i] >= times[i - 1]) &&
+               "Horodatages absents ou non ordonnés");
+    }
+    free(times);
+
+    H5Fclose(file_id);
+}
+
+static void append_frames(hdf5_logger_t* logger, int first, int count) {
+    size_t dims[2] = {ROWS, COLS};
+    float frame[ROWS * COLS];
+    for (int i = first; i < first + count; i++) {
+        fill_frame(frame, i);
+        int status = hdf5_log_array_append(logger, "/series", "matrix", frame, 2, dims, 0);
+        assert(status == 0 && "Ajout d'une trame a échoué");
+    }
+}
+
+int main() {
+    printf("Test des séries temporelles de tableaux\n");
+
+    remove("test_append.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_append.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+
+    // Un vidage au milieu d'un chunk n'empêche pas les écritures suivantes
+    append_frames(logger, 0, 700);
+    assert(hdf5_logger_flush(logger) == 0 && "Le vidage a échoué");
+    append_frames(logger, 700, FRAMES - 700);
+
+    // Trames de forme ou de type différent refusées
+    float frame[ROWS * COLS] = {0};
+    size_t other_dims[2] = {COLS, ROWS};
+    size_t dims[2] = {ROWS, COLS};
+    assert(hdf5_log_array_append(logger, "/series", "matrix", frame, 2, other_dims, 0) == -1 &&
+           "Dimensions différentes devraient être refusées");
+    assert(hdf5_log_array_append(logger, "/series", "matrix", frame, 1, dims, 0) == -1 &&
+           "Rang différent devrait être refusé");
+    assert(hdf5_log_array_append(logger, "/series", "matrix", frame, 2, dims, 1) == -1 &&
+           "Type différent devrait être refusé");
+    assert(hdf5_log_array_append(logger, "/series", "matrix", frame, HDF5_LOGGER_MAX_RANK, dims,
+                                 0) == -1 && "Rang trop grand devrait être refusé");
+
+    // Un tableau ordinaire n'est jamais transformé en série
+    assert(hdf5_log_array_2d(logger, "/series", "plain", frame, ROWS, COLS, 0) == 0 &&
+           "Log d'un tableau a échoué");
+    assert(hdf5_log_array_append(logger, "/series", "plain", frame, 2, dims, 0) == -1 &&
+           "Un tableau ordinaire ne devrait pas être prolongé");
+
+    // Trames plus grandes que la cible : une trame par chunk, écrite sans copie
+    double* large = malloc(LARGE_ELEMENTS * sizeof(double));
+    size_t large_dims[1] = {LARGE_ELEMENTS};
+    for (int frame_index = 0; frame_index < 3; frame_index++) {
+        for (int i = 0; i < LARGE_ELEMENTS; i++) {
+            large[i] = frame_index * 1e6 + i;
+        }
+        assert(hdf5_log_array_append(logger, "/series", "large", large, 1, large_dims, 1) == 0 &&
+               "Ajout d'une grande trame a échoué");
+    }
+
+    // Une série remplacée par un tableau ordinaire de même nom
+    size_t small_dims[1] = {4};
+    assert(hdf5_log_array_append(logger, "/series", "replaced", frame, 1, small_dims, 0) == 0 &&
+           "Ajout d'une trame a échoué");
+    assert(hdf5_log_array_1d(logger, "/series", "replaced", frame, 4, 0) == 0 &&
+           "Remplacement de la série a échoué");
+
+    int status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    check_series("test_append.h5", "/series/matrix", "/series/matrix_timestamps", FRAMES);
+
+    hid_t file_id = H5Fopen("test_append.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    hsize_t shape[2], maxdims[2], chunk_dims[2];
+    assert(read_dims(file_id, "/series/large", shape, maxdims, chunk_dims) == 2 &&
+           shape[0] == 3 && chunk_dims[0] == 1 && "Grandes trames mal découpées");
+    hid_t dataset_id = H5Dopen2(file_id, "/series/large", H5P_DEFAULT);
+    double* large_back = malloc(3 * LARGE_ELEMENTS * sizeof(double));
+    H5Dread(dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, large_back);
+    assert(large_back[2 * LARGE_ELEMENTS + 5] == 2e6 + 5 && "Grande trame relue incorrecte");
+    free(large_back);
+    H5Dclose(dataset_id);
+    assert(read_dims(file_id, "/series/replaced", shape, maxdims, chunk_dims) == 1 &&
+           shape[0] == 4 && "La série aurait dû être remplacée");
+    H5Fclose(file_id);
+    free(large);
+
+    // Une nouvelle session prolonge la série
+    logger = hdf5_logger_init("test_append.h5");
+    assert(logger != NULL && "La réouverture du logger a échoué");
+    append_frames(logger, FRAMES, 10);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    check_series("test_append.h5", "/series/matrix", "/series/matrix_timestamps", FRAMES + 10);
+
+    // Mode asynchrone : la trame est horodatée au dépôt et écrite par le thread d'écriture
+    remove("test_append_async.h5");
+    logger = hdf5_logger_init_async("test_append_async.h5", NULL);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    append_frames(logger, 0, 1500);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+    check_series("test_append_async.h5", "/series/matrix", "/series/matrix_timestamps", 1500);
+
+    printf("Tests des séries temporelles réussis!\n");
+    return 0;
+}
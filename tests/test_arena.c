@@ -0,0 +1,165 @@
+/**
+ * @file test_arena.c
+ * @brief Test de l'allocateur des tampons de travail : réutilisation et limite mémoire
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define ROUND_TEXTS 5000
+#define IMAGE_WIDTH 256
+#define IMAGE_HEIGHT 256
+
+/* Allocations du tas faites par le thread qui logue, comptées quand l'édition de liens
+ * redirige malloc, calloc et realloc (--wrap, voir CMakeLists.txt). Seul ce thread
+ * producteur est compté : le thread d'écriture et HDF5 peuvent encore allouer */
+static unsigned long long heap_calls;
+
+#ifdef TEST_WRAP_MALLOC
+static __thread int counting;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* data, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    heap_calls += counting;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    heap_calls += counting;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* data, size_t size) {
+    heap_calls += counting;
+    return __real_realloc(data, size);
+}
+#endif
+
+/* Une série d'écritures identique d'un tour à l'autre */
+static void log_round(hdf5_logger_t* logger, const double* values, const unsigned char* pixels) {
+    for (int i = 0; i < ROUND_TEXTS; i++) {
+        int status = hdf5_log_text_to_group(logger, "/arena", HDF5_LOG_INFO,
+                                            "Message de longueur constante");
+        assert(status == 0 && "Dépôt d'un log texte a échoué");
+        if (i % 500 == 0) {
+            size_t dims[1] = {256};
+            status = hdf5_log_array_append(logger, "/arena", "series", values, 1, dims,
+                                           HDF5_DTYPE_FLOAT64);
+            assert(status == 0 && "Dépôt d'une trame a échoué");
+            status = hdf5_log_image_frame(logger, "/arena", "video", pixels, IMAGE_WIDTH,
+                                          IMAGE_HEIGHT, 1);
+            assert(status == 0 && "Dépôt d'une image a échoué");
+        }
+    }
+    assert(hdf5_logger_flush(logger) == 0 && "Le vidage a échoué");
+}
+
+int main() {
+    printf("Test de l'allocateur des tampons de travail\n");
+
+    double values[256];
+    for (int i = 0; i < 256; i++) {
+        values[i] = i;
+    }
+    unsigned char* pixels = malloc(IMAGE_WIDTH * IMAGE_HEIGHT);
+    memset(pixels, 7, IMAGE_WIDTH * IMAGE_HEIGHT);
+
+    // Régime établi : après un premier tour, plus aucun bloc n'est demandé au système
+    remove("test_arena.h5");
+    hdf5_async_config_t config = {64, HDF5_ASYNC_BLOCK, HDF5_LOG_DEBUG};
+    hdf5_logger_t* logger = hdf5_logger_init_async("test_arena.h5", &config);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+
+    log_round(logger, values, pixels);
+    log_round(logger, values, pixels);
+    hdf5_arena_stats_t warm;
+    assert(hdf5_logger_get_arena_stats(logger, &warm) == 0 && "Lecture des compteurs a échoué");
+    assert(warm.system_allocations > 0 && warm.reused > 0 && "Blocs attendus après le premier tour");
+
+#ifdef TEST_WRAP_MALLOC
+    counting = 1;
+#endif
+    for (int round = 0; round < 3; round++) {
+        log_round(logger, values, pixels);
+    }
+#ifdef TEST_WRAP_MALLOC
+    counting = 0;
+#endif
+    hdf5_arena_stats_t steady;
+    hdf5_logger_get_arena_stats(logger, &steady);
+    assert(steady.system_allocations == warm.system_allocations &&
+           "Le régime établi ne devrait faire aucune allocation");
+    assert(heap_calls == 0 && "Le thread qui logue ne devrait plus appeler malloc");
+    assert(steady.allocations - warm.allocations == steady.reused - warm.reused &&
+           steady.allocations - warm.allocations >= 3 * ROUND_TEXTS &&
+           "Chaque demande devrait réutiliser un bloc");
+    assert(steady.bytes_in_use == 0 && steady.failures == 0 &&
+           "Tous les blocs devraient être rendus après un vidage");
+    assert(steady.bytes_reserved <= steady.peak_bytes && "Pic mémoire incohérent");
+
+    int status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    // Limite mémoire en mode bloquant : les dépôts attendent, rien n'est perdu
+    size_t image_bytes = 512 * 512;
+    unsigned char* image = malloc(image_bytes);
+    memset(image, 3, image_bytes);
+    remove("test_arena_limit.h5");
+    logger = hdf5_logger_init_async("test_arena_limit.h5", &config);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    assert(hdf5_logger_set_memory_limit(logger, 1024 * 1024) == 0 && "Réglage de la limite a échoué");
+    for (int i = 0; i < 40; i++) {
+        status = hdf5_log_image_frame(logger, "/limit", "video", image, 512, 512, 1);
+        assert(status == 0 && "Un dépôt bloquant ne devrait pas échouer à la limite");
+    }
+    assert(hdf5_logger_flush(logger) == 0 && "Le vidage a échoué");
+    hdf5_arena_stats_t limited;
+    hdf5_logger_get_arena_stats(logger, &limited);
+    assert(limited.peak_bytes <= 1024 * 1024 && limited.limit == 1024 * 1024 &&
+           "La limite mémoire devrait être respectée");
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    // Blocs de 16, 32 et 64 Kio gardés par le cache du thread d'écriture qui les a rendus :
+    // la limite les reprend pour faire place à une image de 256 Kio (bloc de 512 Kio)
+    remove("test_arena_cache.h5");
+    logger = hdf5_logger_init_async("test_arena_cache.h5", &config);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    assert(hdf5_logger_set_memory_limit(logger, 600 * 1024) == 0 && "Réglage de la limite a échoué");
+    status = hdf5_log_array_1d(logger, "/cache", "a16", image, 16000, HDF5_DTYPE_UINT8);
+    status |= hdf5_log_array_1d(logger, "/cache", "a32", image, 30000, HDF5_DTYPE_UINT8);
+    status |= hdf5_log_array_1d(logger, "/cache", "a64", image, 60000, HDF5_DTYPE_UINT8);
+    assert(status == 0 && hdf5_logger_flush(logger) == 0 && "Dépôt des tableaux a échoué");
+    status = hdf5_log_image(logger, "/cache", "image", image, 512, 512, 1);
+    assert(status == 0 && "Les blocs des caches devraient être rendus sous la limite");
+    assert(hdf5_logger_flush(logger) == 0 && "Le vidage a échoué");
+    hdf5_logger_get_arena_stats(logger, &limited);
+    assert(limited.peak_bytes <= 600 * 1024 && "La limite mémoire devrait être respectée");
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    // Limite mémoire sans attente : un dépôt trop grand échoue
+    remove("test_arena_drop.h5");
+    hdf5_async_config_t drop = {64, HDF5_ASYNC_DROP_OLDEST, HDF5_LOG_DEBUG};
+    logger = hdf5_logger_init_async("test_arena_drop.h5", &drop);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    hdf5_logger_set_memory_limit(logger, 128 * 1024);
+    assert(hdf5_log_image(logger, "/limit", "big", image, 512, 512, 1) == -1 &&
+           "Un dépôt au-delà de la limite devrait échouer");
+    hdf5_logger_get_arena_stats(logger, &limited);
+    assert(limited.failures > 0 && "L'échec devrait être compté");
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    free(image);
+    free(pixels);
+    printf("Tests de l'allocateur réussis!\n");
+    return 0;
+}
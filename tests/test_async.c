@@ -0,0 +1,169 @@
+/**
+ * @file test_async.c
+ * @brief Test du mode asynchrone : file bornée et thread d'écriture
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+static int count_callback(const hdf5_text_entry_t* entry, void* user_data) {
+    (void)entry;
+    (*(size_t*)user_data)++;
+    return 0;
+}
+
+static size_t count_entries(hdf5_logger_t* logger, const char* group_path) {
+    size_t count = 0;
+    int status = hdf5_logger_read_text(logger, group_path, count_callback, &count);
+    assert(status == 0 && "Relecture du groupe a échoué");
+    return count;
+}
+
+int main() {
+    printf("Test du mode asynchrone\n");
+
+    // File bloquante : rien n'est perdu
+    remove("test_async.h5");
+    hdf5_async_config_t config = {64, HDF5_ASYNC_BLOCK, HDF5_LOG_DEBUG};
+    hdf5_logger_t* logger = hdf5_logger_init_async("test_async.h5", &config);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+
+    int status;
+    for (int i = 0; i < 5000; i++) {
+        status = hdf5_log_text_to_group(logger, "/async/block", HDF5_LOG_INFO, "Message asynchrone");
+        assert(status == 0 && "Dépôt d'un log texte a échoué");
+    }
+
+    hdf5_log_channel_t* channel = hdf5_logger_open_channel(logger, "/async/channel");
+    assert(channel != NULL && "Ouverture du canal a échoué");
+    for (int i = 0; i < 100; i++) {
+        status = hdf5_log_channel_text(channel, HDF5_LOG_WARNING, "Message via canal");
+        assert(status == 0 && "Dépôt via canal a échoué");
+    }
+
+    hdf5_text_entry_t entries[10];
+    for (int i = 0; i < 10; i++) {
+        entries[i].level = HDF5_LOG_INFO;
+        entries[i].timestamp = 0.0;
+        entries[i].message = "Message du lot";
+    }
+    status = hdf5_log_text_batch(logger, "/async/block", entries, 10);
+    assert(status == 0 && "Dépôt d'un lot a échoué");
+
+    // Les données des tableaux et images sont recopiées : le tampon peut être réutilisé
+    double values[100];
+    unsigned char pixels[32 * 16 * 3];
+    for (int i = 0; i < 100; i++) {
+        values[i] = i * 0.5;
+    }
+    memset(pixels, 200, sizeof(pixels));
+    status = hdf5_log_array_1d(logger, "/async/arrays", "values", values, 100, 1);
+    assert(status == 0 && "Dépôt d'un tableau a échoué");
+    memset(values, 0, sizeof(values));
+    status = hdf5_log_image(logger, "/async/images", "frame", pixels, 32, 16, 3);
+    assert(status == 0 && "Dépôt d'une image a échoué");
+
+    status = hdf5_logger_flush(logger);
+    assert(status == 0 && "Le vidage asynchrone a échoué");
+
+    hdf5_async_stats_t stats;
+    status = hdf5_logger_get_async_stats(logger, &stats);
+    assert(status == 0 && "Lecture des compteurs a échoué");
+    assert(stats.enqueued == 5103 && stats.written == 5103 && "Tous les dépôts devraient être écrits");
+    assert(stats.dropped_oldest == 0 && stats.dropped_by_level == 0 &&
+           "Une file bloquante ne perd rien");
+
+    assert(count_entries(logger, "/async/block") == 5010 && "Nombre d'entrées écrites incorrect");
+    assert(count_entries(logger, "/async/channel") == 100 && "Nombre d'entrées du canal incorrect");
+
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    // Le tableau a été écrit avec les valeurs du dépôt, pas celles modifiées ensuite
+    hid_t file_id = H5Fopen("test_async.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Réouverture du fichier a échoué");
+    double read_values[100];
+    hid_t dataset_id = H5Dopen2(file_id, "/async/arrays/values", H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Le tableau devrait exister");
+    H5Dread(dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_values);
+    assert(read_values[99] == 49.5 && "Le tableau devrait contenir les valeurs déposées");
+    H5Dclose(dataset_id);
+    assert(H5Lexists(file_id, "/async/images/frame", H5P_DEFAULT) > 0 && "L'image devrait exister");
+    H5Fclose(file_id);
+
+    // Abandon du plus ancien : chaque dépôt est soit écrit soit compté comme abandonné
+    remove("test_async_drop.h5");
+    hdf5_async_config_t drop_config = {4, HDF5_ASYNC_DROP_OLDEST, HDF5_LOG_DEBUG};
+    logger = hdf5_logger_init_async("test_async_drop.h5", &drop_config);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+
+    for (int i = 0; i < 2000; i++) {
+        status = hdf5_log_text_to_group(logger, "/async/drop", HDF5_LOG_INFO, "Message abandonnable");
+        assert(status == 0 && "Dépôt avec abandon a échoué");
+    }
+    status = hdf5_logger_flush(logger);
+    assert(status == 0 && "Le vidage asynchrone a échoué");
+
+    hdf5_logger_get_async_stats(logger, &stats);
+    assert(stats.enqueued == 2000 && stats.written + stats.dropped_oldest == 2000 &&
+           "Les dépôts devraient être écrits ou comptés comme abandonnés");
+    assert(count_entries(logger, "/async/drop") == stats.written &&
+           "Toutes les entrées comptées comme écrites devraient être relues");
+
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    // Abandon par niveau : les erreurs ne sont jamais perdues
+    remove("test_async_level.h5");
+    hdf5_async_config_t level_config = {4, HDF5_ASYNC_DROP_BY_LEVEL, HDF5_LOG_WARNING};
+    logger = hdf5_logger_init_async("test_async_level.h5", &level_config);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+
+    for (int i = 0; i < 1000; i++) {
+        hdf5_log_text(logger, HDF5_LOG_DEBUG, "Détail");
+        status = hdf5_log_text(logger, HDF5_LOG_ERROR, "Erreur");
+        assert(status == 0 && "Dépôt d'une erreur a échoué");
+    }
+    status = hdf5_logger_flush(logger);
+    assert(status == 0 && "Le vidage asynchrone a échoué");
+
+    hdf5_logger_get_async_stats(logger, &stats);
+    assert(count_entries(logger, "/text_logs/errors") == 1000 && "Aucune erreur ne doit être perdue");
+    assert(count_entries(logger, "/text_logs/debug") + stats.dropped_by_level == 1000 &&
+           "Les entrées de debug sont écrites ou comptées comme abandonnées");
+
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    // Une écriture en échec n'est signalée que par le vidage qui la suit
+    remove("test_async_errors.h5");
+    logger = hdf5_logger_init_async("test_async_errors.h5", NULL);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    double sample[4] = {1.0, 2.0, 3.0, 4.0};
+    status = hdf5_log_array_1d(logger, "/async/errors", "x", sample, 4, HDF5_DTYPE_FLOAT64);
+    assert(status == 0 && hdf5_logger_flush(logger) == 0 && "Le vidage asynchrone a échoué");
+    status = hdf5_log_array_1d(logger, "/async/errors/x", "y", sample, 4, HDF5_DTYPE_FLOAT64);
+    assert(status == 0 && "Dépôt d'un tableau a échoué");
+    assert(hdf5_logger_flush(logger) == -1 && "Le vidage devrait signaler l'écriture en échec");
+    assert(hdf5_logger_flush(logger) == 0 && "Un échec déjà signalé ne devrait plus l'être");
+    status = hdf5_log_array_1d(logger, "/async/errors", "z", sample, 4, HDF5_DTYPE_FLOAT64);
+    assert(status == 0 && hdf5_logger_flush(logger) == 0 &&
+           "Les vidages suivants devraient réussir");
+    hdf5_logger_get_async_stats(logger, &stats);
+    assert(stats.write_errors == 1 && "L'écriture en échec devrait rester comptée");
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    // Les compteurs n'existent pas en mode synchrone
+    logger = hdf5_logger_init("test_async_sync.h5");
+    assert(hdf5_logger_get_async_stats(logger, &stats) != 0 &&
+           "Un logger synchrone n'a pas de compteurs asynchrones");
+    hdf5_logger_close(logger);
+
+    printf("Tests du mode asynchrone réussis!\n");
+    return 0;
+}
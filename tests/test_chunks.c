@@ -0,0 +1,151 @@
+/**
+ * @file test_chunks.c
+ * @brief Test du choix de la forme des chunks des tableaux
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+/* Lit la forme des chunks d'un dataset ; renvoie le rang, 0 si le dataset est contigu */
+static int read_chunk_dims(hid_t file_id, const char* path, hsize_t* chunk_dims) {
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Ouverture du dataset a échoué");
+    hid_t plist_id = H5Dget_create_plist(dataset_id);
+    int rank = 0;
+    if (H5Pget_layout(plist_id) == H5D_CHUNKED) {
+        rank = H5Pget_chunk(plist_id, HDF5_LOGGER_MAX_RANK, chunk_dims);
+    }
+    H5Pclose(plist_id);
+    H5Dclose(dataset_id);
+    return rank;
+}
+
+static void check_chunks(hid_t file_id, const char* path, int rank, const hsize_t* expected) {
+    hsize_t chunk_dims[HDF5_LOGGER_MAX_RANK];
+    int found = read_chunk_dims(file_id, path, chunk_dims);
+    assert(found == rank && "Rang des chunks incorrect");
+    for (int i = 0; i < rank; i++) {
+        if (chunk_dims[i] != expected[i]) {
+            fprintf(stderr, "%s : chunk[%d] = %llu, attendu %llu\n", path, i,
+                    (unsigned long long)chunk_dims[i], (unsigned long long)expected[i]);
+        }
+        assert(chunk_dims[i] == expected[i] && "Forme des chunks incorrecte");
+    }
+}
+
+static void log_all(hdf5_logger_t* logger, const float* data) {
+    // Parcours ligne par ligne, disposition par défaut : 256 Kio par chunk
+    int status = hdf5_log_array_1d(logger, "/chunks", "vector", data, 1 << 20, 0);
+    status |= hdf5_log_array_2d(logger, "/chunks", "matrix", data, 1024, 1024, 0);
+    status |= hdf5_log_array_1d(logger, "/chunks", "small", data, 10, 0);
+
+    // Une trame par chunk, découpée quand elle dépasse la cible
+    size_t frames[3] = {4, 512, 512};
+    hdf5_array_layout_t frame = {HDF5_ACCESS_FRAME, 0};
+    status |= hdf5_log_array_nd(logger, "/chunks", "frames", data, 3, frames, 0, &frame);
+
+    // Tuiles : côtés égaux, budget des dimensions courtes redistribué
+    size_t square[2] = {1024, 1024};
+    hdf5_array_layout_t tile = {HDF5_ACCESS_TILE, 0};
+    status |= hdf5_log_array_nd(logger, "/chunks", "tiles", data, 2, square, 0, &tile);
+    size_t cube[3] = {4, 500, 500};
+    status |= hdf5_log_array_nd(logger, "/chunks", "cube", data, 3, cube, 0, &tile);
+
+    // Taille cible explicite, doubles
+    size_t rows[2] = {256, 256};
+    hdf5_array_layout_t large = {HDF5_ACCESS_ROW_SCAN, 1 << 20};
+    status |= hdf5_log_array_nd(logger, "/chunks", "large", data, 2, rows, 1, &large);
+
+    // Rang supérieur à 3
+    size_t hyper[4] = {2, 3, 4, 5};
+    status |= hdf5_log_array_nd(logger, "/chunks", "hyper", data, 4, hyper, 0, NULL);
+
+    // Ancien comportement, par indication et par défaut du logger
+    hdf5_array_layout_t legacy = {HDF5_ACCESS_LEGACY, 0};
+    status |= hdf5_log_array_nd(logger, "/chunks", "legacy", data, 2, square, 0, &legacy);
+    status |= hdf5_logger_set_array_layout(logger, &legacy);
+    status |= hdf5_log_array_1d(logger, "/chunks", "legacy_default", data, 1000, 0);
+    status |= hdf5_logger_set_array_layout(logger, NULL);
+    assert(status == 0 && "Log d'un tableau a échoué");
+}
+
+static void check_all(const char* filename, const float* data) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+
+    hsize_t expected[4];
+    expected[0] = 65536;
+    check_chunks(file_id, "/chunks/vector", 1, expected);
+    expected[0] = 64; expected[1] = 1024;
+    check_chunks(file_id, "/chunks/matrix", 2, expected);
+    check_chunks(file_id, "/chunks/small", 0, expected);
+    expected[0] = 1; expected[1] = 128; expected[2] = 512;
+    check_chunks(file_id, "/chunks/frames", 3, expected);
+    expected[0] = 256; expected[1] = 256;
+    check_chunks(file_id, "/chunks/tiles", 2, expected);
+    expected[0] = 4; expected[1] = 128; expected[2] = 128;
+    check_chunks(file_id, "/chunks/cube", 3, expected);
+    expected[0] = 256; expected[1] = 256;
+    check_chunks(file_id, "/chunks/large", 2, expected);
+    check_chunks(file_id, "/chunks/hyper", 0, expected);
+    expected[0] = 20; expected[1] = 20;
+    check_chunks(file_id, "/chunks/legacy", 2, expected);
+    expected[0] = 20;
+    check_chunks(file_id, "/chunks/legacy_default", 1, expected);
+
+    // Les données sont relues à l'identique
+    float* read_back = malloc(1024 * 1024 * sizeof(float));
+    hid_t dataset_id = H5Dopen2(file_id, "/chunks/tiles", H5P_DEFAULT);
+    herr_t status = H5Dread(dataset_id, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_back);
+    assert(status >= 0 && memcmp(read_back, data, 1024 * 1024 * sizeof(float)) == 0 &&
+           "Relecture des tuiles incorrecte");
+    H5Dclose(dataset_id);
+    free(read_back);
+
+    H5Fclose(file_id);
+}
+
+int main() {
+    printf("Test du choix des chunks\n");
+
+    float* data = malloc((1 << 20) * sizeof(double));
+    for (int i = 0; i < (1 << 20) * 2; i++) {
+        data[i] = (float)(i % 1000) * 0.5f;
+    }
+
+    remove("test_chunks.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_chunks.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+    log_all(logger, data);
+
+    // Paramètres invalides
+    size_t dims[1] = {10};
+    hdf5_array_layout_t invalid = {(hdf5_access_pattern_t)7, 0};
+    assert(hdf5_log_array_nd(logger, "/chunks", "bad", data, 0, dims, 0, NULL) == -1 &&
+           "Rang 0 devrait être refusé");
+    assert(hdf5_log_array_nd(logger, "/chunks", "bad", data, HDF5_LOGGER_MAX_RANK + 1, dims, 0,
+                             NULL) == -1 && "Rang trop grand devrait être refusé");
+    assert(hdf5_log_array_nd(logger, "/chunks", "bad", data, 1, dims, 0, &invalid) == -1 &&
+           "Motif inconnu devrait être refusé");
+
+    int status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    check_all("test_chunks.h5", data);
+
+    // Le mode asynchrone applique la même disposition
+    remove("test_chunks_async.h5");
+    logger = hdf5_logger_init_async("test_chunks_async.h5", NULL);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    log_all(logger, data);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+    check_all("test_chunks_async.h5", data);
+
+    free(data);
+    printf("Tests du choix des chunks réussis!\n");
+    return 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file test_codecs.c
+ * @brief Test des politiques de compression par nature de données et par groupe
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define MAX_FILTERS 4
+
+/* Lit les filtres d'un dataset ; renvoie leur nombre */
+static int read_filters(hid_t file_id, const char* path, H5Z_filter_t* filters,
+                        unsigned int* first_values) {
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Ouverture du dataset a échoué");
+    hid_t plist_id = H5Dget_create_plist(dataset_id);
+    int count = H5Pget_nfilters(plist_id);
+    for (int i = 0; i < count && i < MAX_FILTERS; i++) {
+        unsigned int flags = 0;
+        size_t nelmts = 1;
+        unsigned int values[1] = {0};
+        filters[i] = H5Pget_filter2(plist_id, (unsigned)i, &flags, &nelmts, values, 0, NULL, NULL);
+        first_values[i] = (nelmts > 0) ? values[0] : 0;
+    }
+    H5Pclose(plist_id);
+    H5Dclose(dataset_id);
+    return count;
+}
+
+/* Vérifie la suite de filtres : shuffle éventuel puis deflate de ce niveau (-1 = aucun filtre) */
+static void check_deflate(hid_t file_id, const char* path, int shuffle, int level) {
+    H5Z_filter_t filters[MAX_FILTERS];
+    unsigned int values[MAX_FILTERS];
+    int count = read_filters(file_id, path, filters, values);
+    if (level < 0) {
+        assert(count == 0 && "Aucun filtre attendu");
+        return;
+    }
+    assert(count == shuffle + 1 && "Nombre de filtres incorrect");
+    if (shuffle) {
+        assert(filters[0] == H5Z_FILTER_SHUFFLE && "Le shuffle devrait précéder le codec");
+    }
+    assert(filters[shuffle] == H5Z_FILTER_DEFLATE && (int)values[shuffle] == level &&
+           "Filtre deflate ou niveau incorrect");
+}
+
+int main() {
+    printf("Test des politiques de compression\n");
+
+    float values[4096];
+    for (int i = 0; i < 4096; i++) {
+        values[i] = (float)(i % 100) * 0.25f;
+    }
+    unsigned char pixels[256 * 256 * 3];
+    for (int i = 0; i < 256 * 256 * 3; i++) {
+        pixels[i] = (unsigned char)(i / 7);
+    }
+
+    remove("test_codecs.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_codecs.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+
+    // Politiques par défaut
+    int status = hdf5_log_text_to_group(logger, "/codecs/default", HDF5_LOG_INFO, "Message");
+    status |= hdf5_log_array_1d(logger, "/codecs/default", "array", values, 4096, 0);
+    status |= hdf5_log_image(logger, "/codecs/default", "image", pixels, 256, 256, 3);
+    // Les datasets de texte sont créés à la première écriture sur disque
+    status |= hdf5_logger_flush(logger);
+    assert(status == 0 && "Log avec les politiques par défaut a échoué");
+
+    // Politique d'une nature de données pour tout le logger
+    hdf5_codec_policy_t deflate6 = {HDF5_CODEC_DEFLATE, 6, 0, HDF5_PREDICT_NONE};
+    hdf5_codec_policy_t none = {HDF5_CODEC_NONE, 0, 0, HDF5_PREDICT_NONE};
+    status = hdf5_logger_set_codec(logger, HDF5_DATA_NUMERIC, &deflate6);
+    status |= hdf5_logger_set_codec(logger, HDF5_DATA_TEXT, &none);
+    status |= hdf5_log_array_1d(logger, "/codecs/logger", "array", values, 4096, 0);
+    status |= hdf5_log_text_to_group(logger, "/codecs/logger", HDF5_LOG_INFO, "Message");
+    assert(status == 0 && "Réglage des politiques du logger a échoué");
+
+    // Politique propre à un groupe, puis retour à celle du logger
+    hdf5_codec_policy_t shuffle9 = {HDF5_CODEC_DEFLATE, 9, 1, HDF5_PREDICT_NONE};
+    status = hdf5_logger_set_group_codec(logger, "/codecs/group", HDF5_DATA_NUMERIC, &shuffle9);
+    status |= hdf5_logger_set_group_codec(logger, "/codecs/group", HDF5_DATA_IMAGE, &none);
+    status |= hdf5_log_array_1d(logger, "/codecs/group", "array", values, 4096, 0);
+    status |= hdf5_log_image(logger, "/codecs/group", "image", pixels, 256, 256, 3);
+    status |= hdf5_logger_set_group_codec(logger, "/codecs/group", HDF5_DATA_NUMERIC, NULL);
+    status |= hdf5_log_array_1d(logger, "/codecs/group", "array_after", values, 4096, 0);
+    assert(status == 0 && "Réglage des politiques de groupe a échoué");
+
+    // Retour aux politiques par défaut
+    status = hdf5_logger_set_codec(logger, HDF5_DATA_NUMERIC, NULL);
+    status |= hdf5_log_array_1d(logger, "/codecs/reset", "array", values, 4096, 0);
+    assert(status == 0 && "Rétablissement de la politique par défaut a échoué");
+
+    // Politiques invalides ou indisponibles
+    hdf5_codec_policy_t bad_level = {HDF5_CODEC_DEFLATE, 12, 0, HDF5_PREDICT_NONE};
+    hdf5_codec_policy_t bad_codec = {(hdf5_codec_t)42, 0, 0, HDF5_PREDICT_NONE};
+    hdf5_codec_policy_t lz4 = {HDF5_CODEC_LZ4, 0, 1, HDF5_PREDICT_NONE};
+    assert(hdf5_logger_set_codec(logger, HDF5_DATA_IMAGE, &bad_level) == -1 &&
+           "Niveau deflate invalide devrait être refusé");
+    assert(hdf5_logger_set_codec(logger, HDF5_DATA_IMAGE, &bad_codec) == -1 &&
+           "Codec inconnu devrait être refusé");
+    hdf5_codec_policy_t none_delta = {HDF5_CODEC_NONE, 0, 0, HDF5_PREDICT_DELTA};
+    hdf5_codec_policy_t none_shuffle = {HDF5_CODEC_NONE, 0, 1, HDF5_PREDICT_NONE};
+    assert(hdf5_logger_set_codec(logger, HDF5_DATA_NUMERIC, &none_delta) == -1 &&
+           hdf5_logger_set_group_codec(logger, "/codecs/group", HDF5_DATA_NUMERIC,
+                                       &none_delta) == -1 &&
+           "Une prédiction sans codec devrait être refusée");
+    assert(hdf5_logger_set_codec(logger, HDF5_DATA_NUMERIC, &none_shuffle) == -1 &&
+           "Un réarrangement sans codec devrait être refusé");
+    assert(hdf5_logger_set_codec(logger, HDF5_DATA_KIND_COUNT, &none) == -1 &&
+           "Nature de données inconnue devrait être refusée");
+    assert((hdf5_logger_set_codec(logger, HDF5_DATA_IMAGE, &lz4) == 0) ==
+           (hdf5_codec_available(HDF5_CODEC_LZ4) == 1) &&
+           "LZ4 n'est accepté que si son greffon est disponible");
+    assert(hdf5_codec_available(HDF5_CODEC_DEFLATE) && hdf5_codec_available(HDF5_CODEC_NONE) &&
+           "Deflate et l'absence de compression sont toujours disponibles");
+
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    hid_t file_id = H5Fopen("test_codecs.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+
+    check_deflate(file_id, "/codecs/default/records", 1, 1);
+    check_deflate(file_id, "/codecs/default/message_heap", 0, 1);
+    check_deflate(file_id, "/codecs/default/array", 1, 1);
+    check_deflate(file_id, "/codecs/default/image", 0, 1);
+    check_deflate(file_id, "/codecs/logger/array", 0, 6);
+    check_deflate(file_id, "/codecs/logger/records", 0, -1);
+    check_deflate(file_id, "/codecs/group/array", 1, 9);
+    check_deflate(file_id, "/codecs/group/image", 0, -1);
+    check_deflate(file_id, "/codecs/group/array_after", 0, 6);
+    check_deflate(file_id, "/codecs/reset/array", 1, 1);
+
+    // Les données compressées sont relues à l'identique
+    unsigned char read_back[256 * 256 * 3];
+    hid_t dataset_id = H5Dopen2(file_id, "/codecs/default/image", H5P_DEFAULT);
+    status = H5Dread(dataset_id, H5T_NATIVE_UCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_back);
+    assert(status >= 0 && memcmp(read_back, pixels, sizeof(pixels)) == 0 &&
+           "Relecture de l'image compressée incorrecte");
+    H5Dclose(dataset_id);
+    H5Fclose(file_id);
+
+    printf("Tests des politiques de compression réussis!\n");
+    return 0;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file test_dedup.c
+ * @brief Test de la déduplication des tableaux et des images
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define ROWS 64
+#define COLS 48
+#define WIDTH 320
+#define HEIGHT 240
+#define FRAMES 10
+
+/* Adresse d'un objet dans le fichier : deux noms liés au même dataset ont la même */
+static haddr_t object_address(hid_t file_id, const char* path) {
+    H5O_info_t info;
+    assert(H5Oget_info_by_name2(file_id, path, &info, H5O_INFO_BASIC, H5P_DEFAULT) >= 0 &&
+           "Objet introuvable");
+    return info.addr;
+}
+
+static void check_values(hid_t file_id, const char* path, hid_t mem_type_id, const void* expected,
+                         size_t bytes) {
+    void* values = malloc(bytes);
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Dataset introuvable");
+    assert(H5Dread(dataset_id, mem_type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, values) >= 0 &&
+           "Lecture du dataset a échoué");
+    assert(memcmp(values, expected, bytes) == 0 && "Contenu relu différent");
+    H5Dclose(dataset_id);
+    free(values);
+}
+
+static void check_stats(hdf5_logger_t* logger, unsigned long long checked,
+                        unsigned long long duplicates, unsigned long long bytes_saved) {
+    hdf5_dedup_stats_t stats;
+    assert(hdf5_logger_get_dedup_stats(logger, &stats) == 0 && "Lecture des compteurs a échoué");
+    assert(stats.checked == checked && "Nombre de contenus hachés incorrect");
+    assert(stats.duplicates == duplicates && "Nombre de doublons incorrect");
+    assert(stats.bytes_saved == bytes_saved && "Octets économisés incorrects");
+}
+
+/* Étalonnage relogué à chaque cycle, caméra immobile puis scène changée, et cas à écrire */
+static void write_session(hdf5_logger_t* logger, float (*calib)[COLS], unsigned char* scenes) {
+    char name[32];
+    int status = 0;
+    for (int cycle = 0; cycle < 5; cycle++) {
+        status |= hdf5_log_array_2d(logger, "/calib", "matrix", calib, ROWS, COLS,
+                                    HDF5_DTYPE_FLOAT32);
+    }
+    for (int f = 0; f < FRAMES; f++) {
+        snprintf(name, sizeof(name), "frame_%03d", f);
+        const unsigned char* scene = scenes + ((f < 6) ? 0 : (size_t)WIDTH * HEIGHT * 3);
+        status |= hdf5_log_image(logger, "/camera", name, scene, WIDTH, HEIGHT, 3);
+    }
+
+    // Mêmes octets sous un autre type : contenu différent
+    status |= hdf5_log_array_2d(logger, "/calib", "as_int", calib, ROWS, COLS, HDF5_DTYPE_INT32);
+
+    // Colonne prise dans un tampon plus grand, puis la même colonne recopiée
+    float column[ROWS];
+    for (int i = 0; i < ROWS; i++) {
+        column[i] = calib[i][7];
+    }
+    hdf5_source_layout_t source = {{ROWS, COLS}, {0, 7}, {1, 1}};
+    size_t dims[2] = {ROWS, 1};
+    status |= hdf5_log_array_strided(logger, "/calib", "column_view", calib, 2, dims,
+                                     HDF5_DTYPE_FLOAT32, &source, NULL);
+    status |= hdf5_log_array_2d(logger, "/calib", "column_copy", column, ROWS, 1,
+                                HDF5_DTYPE_FLOAT32);
+    assert(status == 0 && "Log de la session a échoué");
+}
+
+static void check_session(const char* filename, const char* matrix_path, float (*calib)[COLS],
+                          unsigned char* scenes) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+
+    check_values(file_id, matrix_path, H5T_NATIVE_FLOAT, calib, sizeof(float) * ROWS * COLS);
+    check_values(file_id, "/calib/as_int", H5T_NATIVE_INT32, calib, sizeof(float) * ROWS * COLS);
+    assert(object_address(file_id, "/calib/as_int") != object_address(file_id, matrix_path) &&
+           "Un autre type ne devrait pas être lié");
+    assert(object_address(file_id, "/calib/column_copy") ==
+           object_address(file_id, "/calib/column_view") &&
+           "Une colonne lue au travers d'une sélection devrait être reconnue");
+
+    char path[64];
+    haddr_t idle = object_address(file_id, "/camera/frame_000");
+    haddr_t moved = object_address(file_id, "/camera/frame_006");
+    assert(idle != moved && "Deux scènes différentes ne devraient pas être liées");
+    for (int f = 0; f < FRAMES; f++) {
+        snprintf(path, sizeof(path), "/camera/frame_%03d", f);
+        assert(object_address(file_id, path) == ((f < 6) ? idle : moved) &&
+               "Image identique non liée");
+        check_values(file_id, path, H5T_NATIVE_UCHAR,
+                     scenes + ((f < 6) ? 0 : (size_t)WIDTH * HEIGHT * 3), WIDTH * HEIGHT * 3);
+    }
+
+    // Les images liées gardent les attributs de la première écriture
+    hid_t dataset_id = H5Dopen2(file_id, "/camera/frame_009", H5P_DEFAULT);
+    assert(H5Aexists(dataset_id, "width") > 0 && H5Aexists(dataset_id, "content_hash") > 0 &&
+           "Attributs de l'image liée manquants");
+    H5Dclose(dataset_id);
+
+    H5Fclose(file_id);
+}
+
+int main() {
+    printf("Test de la déduplication\n");
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    float (*calib)[COLS] = malloc(sizeof(float) * ROWS * COLS);
+    unsigned char* scenes = malloc((size_t)WIDTH * HEIGHT * 3 * 2);
+    for (int i = 0; i < ROWS; i++) {
+        for (int j = 0; j < COLS; j++) {
+            calib[i][j] = (float)(i * COLS + j) * 0.25f;
+        }
+    }
+    for (size_t i = 0; i < (size_t)WIDTH * HEIGHT * 3 * 2; i++) {
+        scenes[i] = (unsigned char)((i * 31) ^ (i >> 9));
+    }
+    scenes[(size_t)WIDTH * HEIGHT * 3 + 12345] ^= 1;
+
+    const unsigned long long matrix_bytes = sizeof(float) * ROWS * COLS;
+    const unsigned long long image_bytes = WIDTH * HEIGHT * 3;
+
+    // Sans déduplication : chaque image est un dataset distinct, sans empreinte
+    remove("test_dedup.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_dedup.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+    int status = hdf5_log_image(logger, "/plain", "a", scenes, WIDTH, HEIGHT, 3);
+    status |= hdf5_log_image(logger, "/plain", "b", scenes, WIDTH, HEIGHT, 3);
+    assert(status == 0 && "Log sans déduplication a échoué");
+    check_stats(logger, 0, 0, 0);
+
+    assert(hdf5_logger_set_dedup(logger, 1) == 0 && "Activation de la déduplication a échoué");
+    write_session(logger, calib, scenes);
+
+    // 4 étalonnages, 8 images et une colonne en double
+    unsigned long long saved = 4 * matrix_bytes + 8 * image_bytes + ROWS * sizeof(float);
+    check_stats(logger, 18, 13, saved);
+
+    // Dataset remplacé par un autre contenu : son ancienne empreinte ne mène plus à rien
+    float (*other)[COLS] = malloc(sizeof(float) * ROWS * COLS);
+    memcpy(other, calib, sizeof(float) * ROWS * COLS);
+    other[3][3] += 1.0f;
+    status = hdf5_log_array_2d(logger, "/calib", "matrix", other, ROWS, COLS, HDF5_DTYPE_FLOAT32);
+    status |= hdf5_log_array_2d(logger, "/calib", "restored", calib, ROWS, COLS,
+                                HDF5_DTYPE_FLOAT32);
+    assert(status == 0 && "Remplacement a échoué");
+    check_stats(logger, 20, 13, saved);
+
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    check_session("test_dedup.h5", "/calib/restored", calib, scenes);
+
+    hid_t file_id = H5Fopen("test_dedup.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(object_address(file_id, "/plain/a") != object_address(file_id, "/plain/b") &&
+           "Images liées sans déduplication");
+    hid_t dataset_id = H5Dopen2(file_id, "/plain/a", H5P_DEFAULT);
+    assert(H5Aexists(dataset_id, "content_hash") == 0 && "Empreinte sans déduplication");
+    H5Dclose(dataset_id);
+    check_values(file_id, "/calib/matrix", H5T_NATIVE_FLOAT, other, matrix_bytes);
+    check_values(file_id, "/calib/restored", H5T_NATIVE_FLOAT, calib, matrix_bytes);
+    H5Fclose(file_id);
+
+    // Nouvelle session : les empreintes du fichier sont retrouvées à l'activation
+    logger = hdf5_logger_init("test_dedup.h5");
+    assert(logger != NULL && "La réouverture du logger a échoué");
+    assert(hdf5_logger_set_dedup(logger, 1) == 0 && "Activation de la déduplication a échoué");
+    hdf5_dedup_stats_t stats;
+    assert(hdf5_logger_get_dedup_stats(logger, &stats) == 0 && stats.indexed >= 5 &&
+           "Empreintes du fichier non retrouvées");
+    status = hdf5_log_image(logger, "/camera", "frame_010", scenes, WIDTH, HEIGHT, 3);
+    assert(status == 0 && "Log d'une image a échoué");
+    check_stats(logger, 1, 1, image_bytes);
+
+    // Désactivée : l'image est réécrite
+    assert(hdf5_logger_set_dedup(logger, 0) == 0 && "Désactivation a échoué");
+    status = hdf5_log_image(logger, "/camera", "frame_011", scenes, WIDTH, HEIGHT, 3);
+    assert(status == 0 && "Log d'une image a échoué");
+    check_stats(logger, 1, 1, image_bytes);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    file_id = H5Fopen("test_dedup.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(object_address(file_id, "/camera/frame_010") ==
+           object_address(file_id, "/camera/frame_000") &&
+           "Image d'une session précédente non liée");
+    assert(object_address(file_id, "/camera/frame_011") !=
+           object_address(file_id, "/camera/frame_000") &&
+           "Image liée après désactivation");
+    H5Fclose(file_id);
+
+    // Mode asynchrone : hachage et liens faits par le thread d'écriture
+    remove("test_dedup_async.h5");
+    logger = hdf5_logger_init_async("test_dedup_async.h5", NULL);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    assert(hdf5_logger_set_dedup(logger, 1) == 0 && "Activation de la déduplication a échoué");
+    write_session(logger, calib, scenes);
+    check_stats(logger, 18, 13, saved);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+    check_session("test_dedup_async.h5", "/calib/matrix", calib, scenes);
+
+    assert(hdf5_logger_set_dedup(NULL, 1) == -1 && "Un logger absent devrait être refusé");
+
+    free(other);
+    free(scenes);
+    free(calib);
+    printf("Tests de la déduplication réussis!\n");
+    return 0;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file test_dtype.c
+ * @brief Test des types d'éléments : entiers, demi-précision, images 16 bits
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define WIDTH 64
+#define HEIGHT 48
+
+/* Vérifie la classe et la taille du type stocké d'un dataset, puis lit ses valeurs */
+static void check_dataset(hid_t file_id, const char* path, H5T_class_t type_class, size_t size,
+                          hid_t mem_type_id, void* values) {
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Dataset introuvable");
+    hid_t type_id = H5Dget_type(dataset_id);
+    assert(H5Tget_class(type_id) == type_class && "Classe du type stocké inattendue");
+    assert(H5Tget_size(type_id) == size && "Largeur du type stocké inattendue");
+    H5Tclose(type_id);
+    assert(H5Dread(dataset_id, mem_type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, values) >= 0 &&
+           "Lecture du dataset a échoué");
+    H5Dclose(dataset_id);
+}
+
+/* Image 12 bits dans des mots de 16 bits */
+static void fill_mono12(uint16_t* pixels, int frame) {
+    for (int i = 0; i < WIDTH * HEIGHT; i++) {
+        pixels[i] = (uint16_t)((i * 7 + frame * 131) & 0x0FFF);
+    }
+}
+
+static void write_all(hdf5_logger_t* logger) {
+    int16_t adc[1000];
+    for (int i = 0; i < 1000; i++) {
+        adc[i] = (int16_t)(i * 37 - 18000);
+    }
+    int status = hdf5_log_array_1d(logger, "/adc", "samples", adc, 1000, HDF5_DTYPE_INT16);
+    assert(status == 0 && "Log d'un tableau int16 a échoué");
+
+    uint64_t counters[4][3];
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 3; j++) {
+            counters[i][j] = 0xFFFFFFFF00000000ULL + (uint64_t)(i * 3 + j);
+        }
+    }
+    status = hdf5_log_array_2d(logger, "/adc", "counters", counters, 4, 3, HDF5_DTYPE_UINT64);
+    assert(status == 0 && "Log d'un tableau uint64 a échoué");
+
+    int8_t small[2][2][2] = {{{-128, -1}, {0, 1}}, {{2, 3}, {4, 127}}};
+    size_t dims[3] = {2, 2, 2};
+    status = hdf5_log_array_nd(logger, "/adc", "small", small, 3, dims, HDF5_DTYPE_INT8, NULL);
+    assert(status == 0 && "Log d'un tableau int8 a échoué");
+
+    /* 1.0, 2.0, -0.5 et 65504 (plus grand demi-précision fini) */
+    uint16_t halves[4] = {0x3C00, 0x4000, 0xB800, 0x7BFF};
+    status = hdf5_log_array_1d(logger, "/adc", "halves", halves, 4, HDF5_DTYPE_FLOAT16);
+    assert(status == 0 && "Log d'un tableau demi-précision a échoué");
+
+    /* Séries temporelles entières, avec et sans regroupement des trames */
+    for (int frame = 0; frame < 10; frame++) {
+        int32_t row[8];
+        for (int i = 0; i < 8; i++) {
+            row[i] = frame * 1000 + i;
+        }
+        size_t row_dims[1] = {8};
+        status = hdf5_log_array_append(logger, "/adc", "series", row, 1, row_dims,
+                                       HDF5_DTYPE_INT32);
+        assert(status == 0 && "Ajout d'une trame int32 a échoué");
+    }
+
+    uint16_t pixels[WIDTH * HEIGHT];
+    fill_mono12(pixels, 0);
+    status = hdf5_log_image_typed(logger, "/camera", "still", pixels, WIDTH, HEIGHT, 1,
+                                  HDF5_DTYPE_UINT16);
+    assert(status == 0 && "Log d'une image 16 bits a échoué");
+
+    for (int frame = 0; frame < 3; frame++) {
+        fill_mono12(pixels, frame);
+        status = hdf5_log_image_frame_typed(logger, "/camera", "video", pixels, WIDTH, HEIGHT, 1,
+                                            HDF5_DTYPE_UINT16);
+        assert(status == 0 && "Ajout d'une image 16 bits a échoué");
+    }
+}
+
+static void check_all(const char* filename, int frames_checked) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+
+    int16_t adc[1000];
+    check_dataset(file_id, "/adc/samples", H5T_INTEGER, 2, H5T_NATIVE_INT16, adc);
+    for (int i = 0; i < 1000; i++) {
+        assert(adc[i] == (int16_t)(i * 37 - 18000) && "Échantillon int16 incorrect");
+    }
+
+    uint64_t counters[4][3];
+    check_dataset(file_id, "/adc/counters", H5T_INTEGER, 8, H5T_NATIVE_UINT64, counters);
+    assert(counters[3][2] == 0xFFFFFFFF0000000BULL && "Compteur uint64 incorrect");
+
+    int8_t small[8];
+    check_dataset(file_id, "/adc/small", H5T_INTEGER, 1, H5T_NATIVE_INT8, small);
+    assert(small[0] == -128 && small[7] == 127 && "Valeur int8 incorrecte");
+
+    /* HDF5 convertit la demi-précision stockée vers float à la lecture */
+    float halves[4];
+    check_dataset(file_id, "/adc/halves", H5T_FLOAT, 2, H5T_NATIVE_FLOAT, halves);
+    assert(halves[0] == 1.0f && halves[1] == 2.0f && halves[2] == -0.5f &&
+           halves[3] == 65504.0f && "Valeurs demi-précision incorrectes");
+
+    int32_t series[10][8];
+    check_dataset(file_id, "/adc/series", H5T_INTEGER, 4, H5T_NATIVE_INT32, series);
+    assert(series[0][0] == 0 && series[9][7] == 9007 && "Trame int32 incorrecte");
+
+    uint16_t expected[WIDTH * HEIGHT];
+    uint16_t* still = malloc(sizeof(expected));
+    fill_mono12(expected, 0);
+    check_dataset(file_id, "/camera/still", H5T_INTEGER, 2, H5T_NATIVE_UINT16, still);
+    assert(memcmp(still, expected, sizeof(expected)) == 0 && "Image 16 bits incorrecte");
+    free(still);
+
+    uint16_t* video = malloc((size_t)frames_checked * sizeof(expected));
+    check_dataset(file_id, "/camera/video", H5T_INTEGER, 2, H5T_NATIVE_UINT16, video);
+    for (int frame = 0; frame < frames_checked; frame++) {
+        fill_mono12(expected, frame);
+        assert(memcmp(video + (size_t)frame * WIDTH * HEIGHT, expected, sizeof(expected)) == 0 &&
+               "Image de séquence 16 bits incorrecte");
+    }
+    free(video);
+
+    H5Fclose(file_id);
+}
+
+int main() {
+    printf("Test des types d'éléments\n");
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    // Mode synchrone
+    remove("test_dtype.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_dtype.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+    write_all(logger);
+
+    // Le type d'une séquence est fixé par sa première image
+    unsigned char bytes[WIDTH * HEIGHT] = {0};
+    assert(hdf5_log_image_frame(logger, "/camera", "video", bytes, WIDTH, HEIGHT, 1) == -1 &&
+           "Une image 8 bits ne devrait pas rejoindre une séquence 16 bits");
+
+    // Type inconnu refusé partout
+    assert(hdf5_log_array_1d(logger, "/adc", "bad", bytes, 4, (hdf5_dtype_t)42) == -1 &&
+           "Un type inconnu devrait être refusé");
+    assert(hdf5_log_image_typed(logger, "/camera", "bad", bytes, 2, 2, 1,
+                                (hdf5_dtype_t)-1) == -1 && "Un type inconnu devrait être refusé");
+
+    int status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    check_all("test_dtype.h5", 3);
+
+    // Séquence prolongée dans une nouvelle session, avec le même type
+    logger = hdf5_logger_init("test_dtype.h5");
+    assert(logger != NULL && "La réouverture du logger a échoué");
+    uint16_t pixels[WIDTH * HEIGHT];
+    fill_mono12(pixels, 3);
+    status = hdf5_log_image_frame_typed(logger, "/camera", "video", pixels, WIDTH, HEIGHT, 1,
+                                        HDF5_DTYPE_UINT16);
+    assert(status == 0 && "Prolongation d'une séquence 16 bits a échoué");
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    check_all("test_dtype.h5", 4);
+
+    // Mode asynchrone : mêmes datasets, écrits par le thread d'écriture
+    remove("test_dtype_async.h5");
+    logger = hdf5_logger_init_async("test_dtype_async.h5", NULL);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    write_all(logger);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+    check_all("test_dtype_async.h5", 3);
+
+    printf("Tests des types d'éléments réussis!\n");
+    return 0;
+}
@@ -0,0 +1,239 @@
+/**
+ * @file test_format.c
+ * @brief Test des logs texte à formatage différé (hdf5_log_textf)
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define MAX_MESSAGES 32
+#define MANY_FORMATS 200
+
+/* Messages relus, dans l'ordre */
+static char messages[MAX_MESSAGES][256];
+static size_t read_count;
+
+static int collect_callback(const hdf5_text_entry_t* entry, void* user_data) {
+    (void)user_data;
+    if (read_count < MAX_MESSAGES) {
+        snprintf(messages[read_count], sizeof(messages[0]), "%s", entry->message);
+    }
+    read_count++;
+    return 0;
+}
+
+static void read_group(hdf5_logger_t* logger, const char* group_path) {
+    read_count = 0;
+    int status = hdf5_logger_read_text(logger, group_path, collect_callback, NULL);
+    assert(status == 0 && "La relecture a échoué");
+}
+
+/* Lit tout le fichier, pour vérifier qu'une relecture seule ne le modifie pas */
+static char* read_file(const char* filename, long* size) {
+    FILE* file = fopen(filename, "rb");
+    assert(file != NULL && "Ouverture du fichier a échoué");
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* bytes = malloc((size_t)*size);
+    assert(bytes != NULL && fread(bytes, 1, (size_t)*size, file) == (size_t)*size &&
+           "Lecture du fichier a échoué");
+    fclose(file);
+    return bytes;
+}
+
+/* Écrit les mêmes messages avec hdf5_log_textf et les références avec snprintf */
+static size_t log_samples(hdf5_logger_t* logger, const char* group_path,
+                          char references[][256]) {
+    int value = 42;
+    size_t n = 0;
+    int status = 0;
+
+    status |= hdf5_log_textf_to_group(logger, group_path, HDF5_LOG_INFO,
+                                      "Entier %d, négatif %i, non signé %u", 17, -123456, 4000000000u);
+    snprintf(references[n++], 256, "Entier %d, négatif %i, non signé %u", 17, -123456, 4000000000u);
+
+    status |= hdf5_log_textf_to_group(logger, group_path, HDF5_LOG_INFO,
+                                      "Longs %ld %lld %llu %zu %zd", -5L, -9000000000LL,
+                                      18446744073709551615ULL, (size_t)12345, (ptrdiff_t)-7);
+    snprintf(references[n++], 256, "Longs %ld %lld %llu %zu %zd", -5L, -9000000000LL,
+             18446744073709551615ULL, (size_t)12345, (ptrdiff_t)-7);
+
+    status |= hdf5_log_textf_to_group(logger, group_path, HDF5_LOG_WARNING,
+                                      "Réels %f %.3e %g %10.2f", 3.14159, -0.000123, 1e100, 2.5);
+    snprintf(references[n++], 256, "Réels %f %.3e %g %10.2f", 3.14159, -0.000123, 1e100, 2.5);
+
+    status |= hdf5_log_textf_to_group(logger, group_path, HDF5_LOG_ERROR,
+                                      "Chaîne [%s] [%-8s] [%.3s] caractère %c", "capteur", "ab",
+                                      "tronqué", 'Z');
+    snprintf(references[n++], 256, "Chaîne [%s] [%-8s] [%.3s] caractère %c", "capteur", "ab",
+             "tronqué", 'Z');
+
+    status |= hdf5_log_textf_to_group(logger, group_path, HDF5_LOG_DEBUG,
+                                      "Étoiles [%*d] [%-*.*f] 100%% %x %#o %p", 6, 99, 9, 2,
+                                      1.005, 255u, 8u, (void*)&value);
+    snprintf(references[n++], 256, "Étoiles [%*d] [%-*.*f] 100%% %x %#o %p", 6, 99, 9, 2,
+             1.005, 255u, 8u, (void*)&value);
+
+    status |= hdf5_log_textf_to_group(logger, group_path, HDF5_LOG_INFO, "Sans argument");
+    snprintf(references[n++], 256, "Sans argument");
+
+    // Messages non formatés et différés se mélangent dans un même groupe
+    status |= hdf5_log_text_to_group(logger, group_path, HDF5_LOG_INFO, "Texte brut");
+    snprintf(references[n++], 256, "Texte brut");
+
+    assert(status == 0 && "Un log à formatage différé a échoué");
+    return n;
+}
+
+static void check_messages(char references[][256], size_t n) {
+    assert(read_count == n && "Nombre d'entrées relues incorrect");
+    for (size_t i = 0; i < n; i++) {
+        if (strcmp(messages[i], references[i]) != 0) {
+            fprintf(stderr, "Attendu \"%s\", relu \"%s\"\n", references[i], messages[i]);
+        }
+        assert(strcmp(messages[i], references[i]) == 0 && "Message reconstitué incorrect");
+    }
+}
+
+int main() {
+    printf("Test des logs texte à formatage différé\n");
+
+    char references[MAX_MESSAGES][256];
+    remove("test_format.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_format.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+
+    // Les messages sont reconstitués à l'identique de snprintf
+    size_t n = log_samples(logger, "/format/samples", references);
+    read_group(logger, "/format/samples");
+    check_messages(references, n);
+
+    // Un format répété n'est interné qu'une fois
+    for (int i = 0; i < 100; i++) {
+        int status = hdf5_log_textf(logger, HDF5_LOG_INFO, "Itération %d sur %d", i, 100);
+        assert(status == 0 && "Log à formatage différé a échoué");
+    }
+
+    // Des formats nombreux sont retrouvés par leur texte, quelle que soit leur adresse
+    static char texts[2][MANY_FORMATS][32];
+    for (int copy = 0; copy < 2; copy++) {
+        for (int i = 0; i < MANY_FORMATS; i++) {
+            snprintf(texts[copy][i], sizeof(texts[copy][i]), "Format %d : %%d", i);
+            int status = hdf5_log_textf_to_group(logger, "/format/many", HDF5_LOG_INFO,
+                                                 texts[copy][i], copy);
+            assert(status == 0 && "Log d'un format parmi beaucoup a échoué");
+        }
+    }
+    read_group(logger, "/format/many");
+    assert(read_count == 2 * MANY_FORMATS && "Tous les formats devraient être relus");
+    assert(strcmp(messages[0], "Format 0 : 0") == 0 && strcmp(messages[31], "Format 31 : 0") == 0 &&
+           "Message d'un format parmi beaucoup mal reconstitué");
+
+    // Les conversions non prises en charge sont refusées
+    int count = 0;
+    assert(hdf5_log_textf(logger, HDF5_LOG_INFO, "Compte %n", &count) == -1 &&
+           "%n devrait être refusé");
+    assert(hdf5_log_textf(logger, HDF5_LOG_INFO, "Large %ls", L"x") == -1 &&
+           "Les chaînes larges devraient être refusées");
+    assert(hdf5_log_textf(NULL, HDF5_LOG_INFO, "%d", 1) == -1 && "Logger NULL devrait être refusé");
+    assert(hdf5_log_textf(logger, HDF5_LOG_INFO, NULL) == -1 && "Format NULL devrait être refusé");
+
+    int status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    // Les formats sont relus depuis le fichier après réouverture
+    logger = hdf5_logger_init("test_format.h5");
+    assert(logger != NULL && "La réouverture du logger a échoué");
+    read_group(logger, "/format/samples");
+    check_messages(references, n);
+
+    read_group(logger, "/text_logs/info");
+    assert(read_count == 100 && "Les itérations devraient être relues");
+    assert(strcmp(messages[7], "Itération 7 sur 100") == 0 && "Itération mal reconstituée");
+
+    // Un format déjà interné est réutilisé, un nouveau prend le rang suivant
+    status = hdf5_log_textf_to_group(logger, "/format/reopened", HDF5_LOG_INFO,
+                                     "Itération %d sur %d", 3, 4);
+    status |= hdf5_log_textf_to_group(logger, "/format/reopened", HDF5_LOG_INFO,
+                                      "Nouveau format %s", "après réouverture");
+    assert(status == 0 && "Log après réouverture a échoué");
+
+    // Un anneau et un groupe découpé en segments, pour la relecture seule
+    status = hdf5_logger_set_size_limit(logger, "/format/ring", 4);
+    status |= hdf5_logger_set_time_limit(logger, "/format/window", 3600.0);
+    for (int i = 0; i < 10; i++) {
+        status |= hdf5_log_textf_to_group(logger, "/format/ring", HDF5_LOG_INFO,
+                                          "Itération %d sur %d", i, 10);
+        status |= hdf5_log_textf_to_group(logger, "/format/window", HDF5_LOG_INFO,
+                                          "Itération %d sur %d", i, 10);
+    }
+    assert(status == 0 && "Log dans les groupes limités a échoué");
+
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    hid_t file_id = H5Fopen("test_format.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t dataset_id = H5Dopen2(file_id, "/text_formats", H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Le dataset des formats devrait exister");
+    hid_t space_id = H5Dget_space(dataset_id);
+    hsize_t dims[1] = {0};
+    H5Sget_simple_extent_dims(space_id, dims, NULL);
+    assert(dims[0] == 8 + MANY_FORMATS && "Chaque format distinct devrait être interné une seule fois");
+    H5Sclose(space_id);
+    H5Dclose(dataset_id);
+    H5Fclose(file_id);
+
+    // La relecture seule reconstitue les messages, voit anneau et segments, et laisse le
+    // fichier intact
+    long size_before = 0;
+    long size_after = 0;
+    char* before = read_file("test_format.h5", &size_before);
+    read_count = 0;
+    status = hdf5_logger_read_text_file("test_format.h5", "/format/samples", collect_callback, NULL);
+    assert(status == 0 && "Relecture seule a échoué");
+    check_messages(references, n);
+    read_count = 0;
+    status = hdf5_logger_read_text_file("test_format.h5", "/format/ring", collect_callback, NULL);
+    assert(status == 0 && read_count == 4 && strcmp(messages[0], "Itération 6 sur 10") == 0 &&
+           "Relecture seule de l'anneau incorrecte");
+    read_count = 0;
+    status = hdf5_logger_read_text_file("test_format.h5", "/format/window", collect_callback, NULL);
+    assert(status == 0 && read_count == 10 && strcmp(messages[9], "Itération 9 sur 10") == 0 &&
+           "Relecture seule des segments incorrecte");
+    assert(hdf5_logger_read_text_file("test_format.h5", "/format/absent", collect_callback,
+                                      NULL) == -1 && "Un groupe absent devrait échouer");
+    assert(hdf5_logger_read_text_file("absent.h5", "/format/samples", collect_callback,
+                                      NULL) == -1 && "Un fichier absent devrait échouer");
+    char* after = read_file("test_format.h5", &size_after);
+    assert(size_before == size_after && memcmp(before, after, (size_t)size_before) == 0 &&
+           "La relecture seule a modifié le fichier");
+    free(before);
+    free(after);
+
+    logger = hdf5_logger_init("test_format.h5");
+    read_group(logger, "/format/reopened");
+    assert(read_count == 2 && strcmp(messages[0], "Itération 3 sur 4") == 0 &&
+           strcmp(messages[1], "Nouveau format après réouverture") == 0 &&
+           "Relecture après réouverture incorrecte");
+    hdf5_logger_close(logger);
+
+    // Le mode asynchrone transporte les arguments encodés
+    remove("test_format_async.h5");
+    hdf5_async_config_t config = {64, HDF5_ASYNC_BLOCK, HDF5_LOG_DEBUG};
+    logger = hdf5_logger_init_async("test_format_async.h5", &config);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    n = log_samples(logger, "/format/async", references);
+    read_group(logger, "/format/async");
+    check_messages(references, n);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+
+    printf("Tests des logs texte à formatage différé réussis!\n");
+    return 0;
+}
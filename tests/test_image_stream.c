@@ -0,0 +1,195 @@
+/**
+ * @file test_image_stream.c
+ * @brief Test des séquences d'images (une image ajoutée par appel)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define WIDTH 64
+#define HEIGHT 48
+#define CHANNELS 3
+#define FRAMES 40
+#define LARGE_WIDTH 2000
+#define LARGE_HEIGHT 1500
+
+/* Entrée de la table <séquence>_frames */
+typedef struct {
+    double timestamp;
+    unsigned long long sequence;
+} frame_entry_t;
+
+static void fill_frame(unsigned char* pixels, size_t bytes, int index) {
+    for (size_t i = 0; i < bytes; i++) {
+        pixels[i] = (unsigned char)((i / 7 + (size_t)index * 13) & 0xFF);
+    }
+}
+
+static void append_frames(hdf5_logger_t* logger, int first, int count) {
+    unsigned char pixels[HEIGHT * WIDTH * CHANNELS];
+    for (int i = first; i < first + count; i++) {
+        fill_frame(pixels, sizeof(pixels), i);
+        int status = hdf5_log_image_frame(logger, "/camera", "video", pixels, WIDTH, HEIGHT,
+                                          CHANNELS);
+        assert(status == 0 && "Ajout d'une image a échoué");
+    }
+}
+
+/* Vérifie la séquence /camera/video, sa table des images et ses attributs */
+static void check_video(const char* filename, hsize_t frames) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+
+    hid_t dataset_id = H5Dopen2(file_id, "/camera/video", H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Ouverture de la séquence a échoué");
+    hsize_t dims[4], maxdims[4], chunk_dims[4];
+    hid_t space_id = H5Dget_space(dataset_id);
+    int rank = H5Sget_simple_extent_dims(space_id, dims, maxdims);
+    H5Sclose(space_id);
+    assert(rank == 4 && dims[0] == frames && dims[1] == HEIGHT && dims[2] == WIDTH &&
+           dims[3] == CHANNELS && "Dimensions de la séquence incorrectes");
+    assert(maxdims[0] == H5S_UNLIMITED && "Le premier axe devrait être illimité");
+    hid_t plist_id = H5Dget_create_plist(dataset_id);
+    H5Pget_chunk(plist_id, 4, chunk_dims);
+    H5Pclose(plist_id);
+    assert(chunk_dims[0] == 1 && chunk_dims[1] == HEIGHT && chunk_dims[2] == WIDTH &&
+           chunk_dims[3] == CHANNELS && "Un chunk devrait contenir exactement une image");
+
+    unsigned int width = 0;
+    hid_t attr_id = H5Aopen(dataset_id, "width", H5P_DEFAULT);
+    H5Aread(attr_id, H5T_NATIVE_UINT, &width);
+    H5Aclose(attr_id);
+    assert(width == WIDTH && "Attribut width incorrect");
+    assert(H5Aexists(dataset_id, "timestamp") == 0 &&
+           "Les horodatages ne devraient pas être des attributs");
+
+    size_t frame_bytes = HEIGHT * WIDTH * CHANNELS;
+    unsigned char* values = malloc((size_t)frames * frame_bytes);
+    herr_t status = H5Dread(dataset_id, H5T_NATIVE_UCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, values);
+    assert(status >= 0 && "Relecture des images a échoué");
+    H5Dclose(dataset_id);
+    unsigned char expected[HEIGHT * WIDTH * CHANNELS];
+    for (hsize_t i = 0; i < frames; i++) {
+        fill_frame(expected, frame_bytes, (int)i);
+        assert(memcmp(values + i * frame_bytes, expected, frame_bytes) == 0 &&
+               "Contenu d'une image incorrect");
+    }
+    free(values);
+
+    dataset_id = H5Dopen2(file_id, "/camera/video_frames", H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Ouverture de la table des images a échoué");
+    space_id = H5Dget_space(dataset_id);
+    H5Sget_simple_extent_dims(space_id, dims, NULL);
+    H5Sclose(space_id);
+    assert(dims[0] == frames && "Une entrée par image attendue");
+
+    hid_t type_id = H5Tcreate(H5T_COMPOUND, sizeof(frame_entry_t));
+    H5Tinsert(type_id, "timestamp", HOFFSET(frame_entry_t, timestamp), H5T_NATIVE_DOUBLE);
+    H5Tinsert(type_id, "sequence", HOFFSET(frame_entry_t, sequence), H5T_NATIVE_ULLONG);
+    frame_entry_t* entries = malloc((size_t)frames * sizeof(frame_entry_t));
+    status = H5Dread(dataset_id, type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, entries);
+    assert(status >= 0 && "Relecture de la table des images a échoué");
+    for (hsize_t i = 0; i < frames; i++) {
+        assert(entries[i].timestamp > 0 &&
+               (i == 0 || (entries[i].timestamp >= entries[i - 1].timestamp &&
+                           entries[i].sequence > entries[i - 1].sequence)) &&
+               "Horodatages ou numéros de séquence non ordonnés");
+    }
+    free(entries);
+    H5Tclose(type_id);
+    H5Dclose(dataset_id);
+
+    H5Fclose(file_id);
+}
+
+int main() {
+    printf("Test des séquences d'images\n");
+
+    remove("test_image_stream.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_image_stream.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+
+    append_frames(logger, 0, FRAMES);
+
+    // Images de forme différente refusées
+    unsigned char pixels[HEIGHT * WIDTH * CHANNELS] = {0};
+    assert(hdf5_log_image_frame(logger, "/camera", "video", pixels, HEIGHT, WIDTH, CHANNELS) == -1 &&
+           "Dimensions différentes devraient être refusées");
+    assert(hdf5_log_image_frame(logger, "/camera", "video", pixels, WIDTH, HEIGHT, 1) == -1 &&
+           "Nombre de canaux différent devrait être refusé");
+    assert(hdf5_log_image_frame(logger, "/camera", "video", pixels, WIDTH, HEIGHT, 5) == -1 &&
+           "Plus de 4 canaux devraient être refusés");
+
+    // Une image ordinaire n'est jamais transformée en séquence
+    assert(hdf5_log_image(logger, "/camera", "still", pixels, WIDTH, HEIGHT, CHANNELS) == 0 &&
+           "Log d'une image a échoué");
+    assert(hdf5_log_image_frame(logger, "/camera", "still", pixels, WIDTH, HEIGHT, CHANNELS) == -1 &&
+           "Une image ordinaire ne devrait pas être prolongée");
+
+    // Grandes images : découpées en tuiles, compressées en parallèle
+    assert(hdf5_logger_set_compression_threads(logger, 3) == 0 &&
+           "Réglage des threads de compression a échoué");
+    size_t large_bytes = (size_t)LARGE_WIDTH * LARGE_HEIGHT * CHANNELS;
+    unsigned char* large = malloc(large_bytes);
+    for (int frame_index = 0; frame_index < 2; frame_index++) {
+        fill_frame(large, large_bytes, frame_index);
+        assert(hdf5_log_image_frame(logger, "/camera", "large", large, LARGE_WIDTH, LARGE_HEIGHT,
+                                    CHANNELS) == 0 && "Ajout d'une grande image a échoué");
+    }
+
+    int status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    check_video("test_image_stream.h5", FRAMES);
+
+    hid_t file_id = H5Fopen("test_image_stream.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t dataset_id = H5Dopen2(file_id, "/camera/large", H5P_DEFAULT);
+    hsize_t chunk_dims[4];
+    hid_t plist_id = H5Dget_create_plist(dataset_id);
+    H5Pget_chunk(plist_id, 4, chunk_dims);
+    H5Pclose(plist_id);
+    assert(chunk_dims[0] == 1 && chunk_dims[3] == CHANNELS &&
+           chunk_dims[1] * chunk_dims[2] < (hsize_t)LARGE_WIDTH * LARGE_HEIGHT &&
+           "Une grande image devrait être découpée en tuiles d'une seule image");
+
+    // Relecture de la seconde image seule
+    hsize_t start[4] = {1, 0, 0, 0};
+    hsize_t count[4] = {1, LARGE_HEIGHT, LARGE_WIDTH, CHANNELS};
+    hid_t file_space = H5Dget_space(dataset_id);
+    H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+    hid_t mem_space = H5Screate_simple(4, count, NULL);
+    unsigned char* large_back = malloc(large_bytes);
+    status = H5Dread(dataset_id, H5T_NATIVE_UCHAR, mem_space, file_space, H5P_DEFAULT, large_back);
+    assert(status >= 0 && "Relecture d'une grande image a échoué");
+    fill_frame(large, large_bytes, 1);
+    assert(memcmp(large, large_back, large_bytes) == 0 && "Grande image relue incorrecte");
+    free(large_back);
+    free(large);
+    H5Sclose(mem_space);
+    H5Sclose(file_space);
+    H5Dclose(dataset_id);
+    H5Fclose(file_id);
+
+    // Une nouvelle session prolonge la séquence
+    logger = hdf5_logger_init("test_image_stream.h5");
+    assert(logger != NULL && "La réouverture du logger a échoué");
+    append_frames(logger, FRAMES, 5);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    check_video("test_image_stream.h5", FRAMES + 5);
+
+    // Mode asynchrone : l'image est horodatée et numérotée au dépôt
+    remove("test_image_stream_async.h5");
+    logger = hdf5_logger_init_async("test_image_stream_async.h5", NULL);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    append_frames(logger, 0, FRAMES);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+    check_video("test_image_stream_async.h5", FRAMES);
+
+    printf("Tests des séquences d'images réussis!\n");
+    return 0;
+}
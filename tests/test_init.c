@@ -7,12 +7,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include "hdf5.h"
 #include "../include/hdf5_logger.h"
 
 int main() {
     printf("Test d'initialisation du logger\n");
     
     // Test d'initialisation
+    remove("test_init.h5");
     hdf5_logger_t* logger = hdf5_logger_init("test_init.h5");
     assert(logger != NULL && "L'initialisation du logger a échoué");
     
@@ -20,6 +22,29 @@ int main() {
     int status = hdf5_logger_close(logger);
     assert(status == 0 && "La fermeture du logger a échoué");
     
+    // Fichier par défaut : superbloc version 0, lisible par les outils HDF5 1.8
+    H5F_info2_t info;
+    hid_t file_id = H5Fopen("test_init.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && H5Fget_info2(file_id, &info) >= 0 && "Lecture du fichier a échoué");
+    assert(info.super.version == 0 && "Un fichier par défaut devrait garder le format 1.8");
+    H5Fclose(file_id);
+    
+    // Suivi de l'espace libéré, demandé à la création
+    remove("test_init_space.h5");
+    logger = hdf5_logger_init_with_options("test_init_space.h5", HDF5_FILE_PERSIST_FREE_SPACE);
+    assert(logger != NULL && "L'initialisation avec options a échoué");
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    file_id = H5Fopen("test_init_space.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t fcpl_id = H5Fget_create_plist(file_id);
+    H5F_fspace_strategy_t strategy;
+    hbool_t persist = 0;
+    hsize_t threshold;
+    H5Pget_file_space_strategy(fcpl_id, &strategy, &persist, &threshold);
+    assert(persist && "L'espace libéré devrait être suivi");
+    H5Pclose(fcpl_id);
+    H5Fclose(file_id);
+    
     // Test d'initialisation avec un chemin invalide
     hdf5_logger_t* invalid_logger = hdf5_logger_init("");
     assert(invalid_logger == NULL && "L'initialisation avec un chemin invalide devrait échouer");
@@ -0,0 +1,140 @@
+/**
+ * @file test_levels.c
+ * @brief Test du filtrage par niveau : seuils du logger et des groupes, macros
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../include/hdf5_logger.h"
+
+/* Nombre d'évaluations des arguments des macros */
+static int evaluations;
+
+static int next_value(void) {
+    evaluations++;
+    return evaluations;
+}
+
+/* Logger et niveau passés aux macros, en comptant leurs évaluations */
+static hdf5_logger_t* macro_logger;
+static int logger_evaluations;
+static int level_evaluations;
+
+static hdf5_logger_t* next_logger(void) {
+    logger_evaluations++;
+    return macro_logger;
+}
+
+static hdf5_log_level_t next_level(hdf5_log_level_t level) {
+    level_evaluations++;
+    return level;
+}
+
+static int count_callback(const hdf5_text_entry_t* entry, void* user_data) {
+    (void)entry;
+    (*(size_t*)user_data)++;
+    return 0;
+}
+
+static size_t count_entries(hdf5_logger_t* logger, const char* group_path) {
+    size_t count = 0;
+    int status = hdf5_logger_read_text(logger, group_path, count_callback, &count);
+    assert(status == 0 && "Relecture du groupe a échoué");
+    return count;
+}
+
+int main() {
+    printf("Test du filtrage par niveau\n");
+
+    remove("test_levels.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_levels.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+    assert(hdf5_logger_get_min_level(logger) == HDF5_LOG_DEBUG &&
+           "Le seuil initial devrait laisser passer tous les niveaux");
+
+    // Seuil du logger : les logs filtrés réussissent sans rien écrire
+    int status = hdf5_logger_set_min_level(logger, HDF5_LOG_WARNING);
+    assert(status == 0 && hdf5_logger_get_min_level(logger) == HDF5_LOG_WARNING &&
+           "Le réglage du seuil a échoué");
+    assert(!hdf5_logger_is_enabled(logger, HDF5_LOG_INFO) &&
+           hdf5_logger_is_enabled(logger, HDF5_LOG_ERROR) && "hdf5_logger_is_enabled incorrect");
+
+    status = hdf5_log_text_to_group(logger, "/levels/main", HDF5_LOG_DEBUG, "Filtré");
+    status |= hdf5_log_text_to_group(logger, "/levels/main", HDF5_LOG_INFO, "Filtré");
+    status |= hdf5_log_textf_to_group(logger, "/levels/main", HDF5_LOG_INFO, "Filtré %d", 1);
+    status |= hdf5_log_text_to_group(logger, "/levels/main", HDF5_LOG_WARNING, "Écrit");
+    status |= hdf5_log_textf_to_group(logger, "/levels/main", HDF5_LOG_ERROR, "Écrit %d", 2);
+    assert(status == 0 && "Un log filtré devrait réussir");
+    assert(count_entries(logger, "/levels/main") == 2 && "Seuls les logs au-dessus du seuil sont écrits");
+
+    // Un groupe plus permissif que le logger
+    status = hdf5_logger_set_group_min_level(logger, "/levels/verbose", HDF5_LOG_DEBUG);
+    assert(status == 0 && "Le réglage du seuil de groupe a échoué");
+    assert(hdf5_logger_is_enabled(logger, HDF5_LOG_DEBUG) &&
+           "Le seuil permissif d'un groupe devrait activer le niveau");
+    hdf5_log_text_to_group(logger, "/levels/verbose", HDF5_LOG_DEBUG, "Écrit");
+    hdf5_log_text_to_group(logger, "/levels/main", HDF5_LOG_DEBUG, "Filtré");
+    hdf5_log_channel_t* channel = hdf5_logger_open_channel(logger, "/levels/verbose");
+    assert(channel != NULL && "Ouverture du canal a échoué");
+    hdf5_log_channel_text(channel, HDF5_LOG_INFO, "Écrit via canal");
+    assert(count_entries(logger, "/levels/verbose") == 2 && "Le seuil du groupe devrait s'appliquer");
+    assert(count_entries(logger, "/levels/main") == 2 && "Le seuil du logger devrait s'appliquer");
+
+    // Un groupe plus strict que le logger
+    hdf5_logger_set_group_min_level(logger, "/levels/strict", HDF5_LOG_CRITICAL);
+    hdf5_log_text_to_group(logger, "/levels/strict", HDF5_LOG_ERROR, "Filtré");
+    hdf5_log_text_to_group(logger, "/levels/strict", HDF5_LOG_CRITICAL, "Écrit");
+    assert(count_entries(logger, "/levels/strict") == 1 && "Le seuil strict devrait s'appliquer");
+
+    // Un seuil de groupe peut être changé
+    hdf5_logger_set_group_min_level(logger, "/levels/verbose", HDF5_LOG_ERROR);
+    hdf5_log_channel_text(channel, HDF5_LOG_WARNING, "Filtré");
+    assert(count_entries(logger, "/levels/verbose") == 2 && "Le nouveau seuil devrait s'appliquer");
+    assert(!hdf5_logger_is_enabled(logger, HDF5_LOG_DEBUG) &&
+           "Plus aucun seuil ne devrait laisser passer DEBUG");
+
+    // Les lots sont filtrés entrée par entrée
+    hdf5_text_entry_t entries[4];
+    for (int i = 0; i < 4; i++) {
+        entries[i].level = (hdf5_log_level_t)(i + 1);
+        entries[i].timestamp = 0.0;
+        entries[i].message = "Entrée du lot";
+    }
+    status = hdf5_log_text_batch(logger, "/levels/batch", entries, 4);
+    assert(status == 0 && count_entries(logger, "/levels/batch") == 3 &&
+           "Les entrées du lot sous le seuil devraient être retirées");
+
+    // Les macros n'évaluent pas leurs arguments sous le seuil
+    evaluations = 0;
+    HDF5_LOGF_INFO(logger, "Valeur %d", next_value());
+    HDF5_LOGF(logger, HDF5_LOG_DEBUG, "Valeur %d", next_value());
+    assert(evaluations == 0 && "Les arguments d'un log filtré ne devraient pas être évalués");
+#if HDF5_LOGGER_MIN_LEVEL <= 3
+    HDF5_LOGF_ERROR(logger, "Valeur %d", next_value());
+    HDF5_LOGF_TO_GROUP(logger, "/levels/macros", HDF5_LOG_CRITICAL, "Valeur %d", next_value());
+    assert(evaluations == 2 && "Les arguments d'un log écrit devraient être évalués une fois");
+    assert(count_entries(logger, "/levels/macros") == 1 && "La macro de groupe devrait écrire");
+
+    // Le logger et le niveau ne sont évalués qu'une fois, log écrit ou filtré
+    macro_logger = logger;
+    HDF5_LOGF(next_logger(), next_level(HDF5_LOG_DEBUG), "Valeur %d", 1);
+    HDF5_LOGF(next_logger(), next_level(HDF5_LOG_CRITICAL), "Valeur %d", 2);
+    HDF5_LOGF_TO_GROUP(next_logger(), "/levels/macros", next_level(HDF5_LOG_CRITICAL),
+                       "Valeur %d", 3);
+    assert(logger_evaluations == 3 && level_evaluations == 3 &&
+           "Le logger et le niveau d'une macro devraient être évalués une fois");
+    assert(count_entries(logger, "/levels/macros") == 2 && "La macro de groupe devrait écrire");
+#endif
+
+    assert(hdf5_logger_set_min_level(NULL, HDF5_LOG_INFO) == -1 && "Logger NULL devrait être refusé");
+    assert(hdf5_logger_set_group_min_level(logger, NULL, HDF5_LOG_INFO) == -1 &&
+           "Groupe NULL devrait être refusé");
+
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    printf("Tests du filtrage par niveau réussis!\n");
+    return 0;
+}
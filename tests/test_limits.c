@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <time.h>
 #ifdef _WIN32
 #include <windows.h>
 #define sleep(x) Sleep((x) * 1000)
@@ -15,10 +16,57 @@
 #endif
 #include "../include/hdf5_logger.h"
 
+/* Messages relus d'un groupe, dans l'ordre chronologique */
+typedef struct {
+    char messages[128][64];
+    double timestamps[128];
+    size_t count;
+} read_result_t;
+
+static int collect_callback(const hdf5_text_entry_t* entry, void* user_data) {
+    read_result_t* result = (read_result_t*)user_data;
+    if (result->count < 128) {
+        snprintf(result->messages[result->count], sizeof(result->messages[0]), "%s", entry->message);
+        result->timestamps[result->count] = entry->timestamp;
+    }
+    result->count++;
+    return 0;
+}
+
+/* Vérifie que le groupe contient exactement les messages first..last */
+static void check_messages(hdf5_logger_t* logger, const char* group_path, int first, int last) {
+    read_result_t result;
+    memset(&result, 0, sizeof(result));
+    
+    int status = hdf5_logger_read_text(logger, group_path, collect_callback, &result);
+    assert(status == 0 && "Relecture du groupe a échoué");
+    assert(result.count == (size_t)(last - first + 1) && "Nombre d'entrées conservées incorrect");
+    
+    for (int i = first; i <= last; i++) {
+        char expected[64];
+        sprintf(expected, "Message numéro %d", i);
+        assert(strcmp(result.messages[i - first], expected) == 0 &&
+               "Les entrées ne sont pas dans l'ordre chronologique");
+    }
+}
+
+/* Vérifie que les horodatages relus d'un groupe ne décroissent jamais */
+static void check_sorted(hdf5_logger_t* logger, const char* group_path) {
+    read_result_t result;
+    memset(&result, 0, sizeof(result));
+    int status = hdf5_logger_read_text(logger, group_path, collect_callback, &result);
+    assert(status == 0 && "Relecture du groupe a échoué");
+    for (size_t i = 1; i < result.count; i++) {
+        assert(result.timestamps[i] >= result.timestamps[i - 1] &&
+               "Les horodatages stockés devraient être croissants");
+    }
+}
+
 int main() {
     printf("Test des limites de logs\n");
     
-    // Initialisation
+    // Initialisation sur un fichier neuf
+    remove("test_limits.h5");
     hdf5_logger_t* logger = hdf5_logger_init("test_limits.h5");
     assert(logger != NULL && "L'initialisation du logger a échoué");
     
@@ -35,6 +83,93 @@ int main() {
                                      HDF5_LOG_INFO, message);
         assert(status == 0 && "Log texte pour test de limite a échoué");
     }
+    check_messages(logger, "/text_logs/limited_size", 5, 9);
+    
+    // L'anneau boucle plusieurs fois sur des lots plus petits que la capacité
+    status = hdf5_logger_set_batch_policy(logger, 3, 0, 0.0);
+    assert(status == 0 && "Définition de la politique de lots a échoué");
+    
+    status = hdf5_logger_set_size_limit(logger, "/text_logs/ring", 7);
+    assert(status == 0 && "Définition de limite de taille a échoué");
+    
+    for (int i = 0; i < 40; i++) {
+        char message[64];
+        sprintf(message, "Message numéro %d", i);
+        status = hdf5_log_text_to_group(logger, "/text_logs/ring", HDF5_LOG_INFO, message);
+        assert(status == 0 && "Log texte dans l'anneau a échoué");
+    }
+    check_messages(logger, "/text_logs/ring", 33, 39);
+    
+    // L'anneau persiste après fermeture et réouverture du fichier
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    logger = hdf5_logger_init("test_limits.h5");
+    assert(logger != NULL && "La réouverture du logger a échoué");
+    
+    for (int i = 40; i < 45; i++) {
+        char message[64];
+        sprintf(message, "Message numéro %d", i);
+        status = hdf5_log_text_to_group(logger, "/text_logs/ring", HDF5_LOG_INFO, message);
+        assert(status == 0 && "Log texte après réouverture a échoué");
+    }
+    check_messages(logger, "/text_logs/ring", 38, 44);
+    
+    // Réduire la capacité convertit l'anneau existant
+    status = hdf5_logger_set_size_limit(logger, "/text_logs/ring", 4);
+    assert(status == 0 && "Réduction de la limite de taille a échoué");
+    check_messages(logger, "/text_logs/ring", 41, 44);
+    
+    // Fenêtre de temps sur des entrées horodatées toutes les 2 secondes :
+    // seules celles des 120 dernières secondes restent
+    status = hdf5_logger_set_time_limit(logger, "/text_logs/window", 120.0);
+    assert(status == 0 && "Définition de limite de temps a échoué");
+    status = hdf5_logger_set_retention_interval(logger, 0.0);
+    assert(status == 0 && "Définition de l'intervalle de purge a échoué");
+    assert(hdf5_logger_set_retention_interval(logger, -1.0) != 0 &&
+           "Un intervalle négatif devrait échouer");
+    
+    static char window_messages[120][64];
+    hdf5_text_entry_t window[120];
+    double now = (double)time(NULL);
+    for (int i = 0; i < 120; i++) {
+        sprintf(window_messages[i], "Message numéro %d", i);
+        window[i].level = HDF5_LOG_INFO;
+        window[i].timestamp = now - 238.5 + 2.0 * i;
+        window[i].message = window_messages[i];
+    }
+    status = hdf5_log_text_batch(logger, "/text_logs/window", window, 120);
+    assert(status == 0 && "Log par lot horodaté a échoué");
+    check_messages(logger, "/text_logs/window", 60, 119);
+    
+    // Lot horodaté dans le désordre : une entrée sur quatre revient 150 secondes en arrière.
+    // Chaque horodatage est ramené au plus récent déjà vu, si bien que la purge ne garde
+    // qu'une suite d'entrées consécutives, à partir de la première de moins de 120 secondes
+    status = hdf5_logger_set_time_limit(logger, "/text_logs/shuffled", 120.0);
+    assert(status == 0 && "Définition de limite de temps a échoué");
+    hdf5_text_entry_t shuffled[60];
+    for (int i = 0; i < 60; i++) {
+        shuffled[i].level = HDF5_LOG_INFO;
+        shuffled[i].timestamp = now - 298.5 + 5.0 * i - ((i % 4 == 3) ? 150.0 : 0.0);
+        shuffled[i].message = window_messages[i];
+    }
+    status = hdf5_log_text_batch(logger, "/text_logs/shuffled", shuffled, 60);
+    assert(status == 0 && "Log par lot dans le désordre a échoué");
+    check_messages(logger, "/text_logs/shuffled", 36, 59);
+    check_sorted(logger, "/text_logs/shuffled");
+    
+    // La fenêtre reste exacte après réouverture du fichier
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    logger = hdf5_logger_init("test_limits.h5");
+    assert(logger != NULL && "La réouverture du logger a échoué");
+    check_messages(logger, "/text_logs/window", 60, 119);
+    
+    // Après réouverture, une entrée plus ancienne que le fichier reste la dernière
+    hdf5_text_entry_t late = {HDF5_LOG_INFO, now - 1000.0, window_messages[60], 0};
+    status = hdf5_log_text_batch(logger, "/text_logs/shuffled", &late, 1);
+    assert(status == 0 && "Log d'une entrée ancienne a échoué");
+    check_messages(logger, "/text_logs/shuffled", 36, 60);
+    check_sorted(logger, "/text_logs/shuffled");
     
     // Définir une limite de temps très courte (2 secondes)
     status = hdf5_logger_set_time_limit(logger, "/text_logs/limited_time", 2.0);
@@ -54,6 +189,14 @@ int main() {
                                  HDF5_LOG_INFO, "Second message après délai");
     assert(status == 0 && "Second log pour test de temps a échoué");
     
+    // Seul le second message est encore dans la fenêtre
+    read_result_t result;
+    memset(&result, 0, sizeof(result));
+    status = hdf5_logger_read_text(logger, "/text_logs/limited_time", collect_callback, &result);
+    assert(status == 0 && result.count == 1 &&
+           strcmp(result.messages[0], "Second message après délai") == 0 &&
+           "Le premier message aurait dû expirer");
+    
     // Fermeture
     status = hdf5_logger_close(logger);
     assert(status == 0 && "La fermeture du logger a échoué");
@@ -0,0 +1,165 @@
+/**
+ * @file test_parallel.c
+ * @brief Test de la compression parallèle des chunks et de leur écriture directe
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define IMAGE_WIDTH 300
+#define IMAGE_HEIGHT 200
+#define MATRIX_ROWS 1000
+#define MATRIX_COLS 37
+
+/* Vérifie que deux datasets ont les mêmes chunks, octet pour octet, avec les mêmes filtres */
+static void check_same_chunks(hid_t file_id, const char* expected_path, const char* path) {
+    hid_t expected_id = H5Dopen2(file_id, expected_path, H5P_DEFAULT);
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(expected_id >= 0 && dataset_id >= 0 && "Ouverture des datasets a échoué");
+
+    hid_t expected_space = H5Dget_space(expected_id);
+    hid_t space = H5Dget_space(dataset_id);
+    hsize_t expected_count = 0;
+    hsize_t count = 0;
+    H5Dget_num_chunks(expected_id, expected_space, &expected_count);
+    H5Dget_num_chunks(dataset_id, space, &count);
+    assert(count == expected_count && count > 1 && "Nombre de chunks différent");
+
+    for (hsize_t i = 0; i < count; i++) {
+        hsize_t offset[3];
+        unsigned filter_mask = 1;
+        haddr_t address;
+        hsize_t size = 0;
+        herr_t status = H5Dget_chunk_info(dataset_id, space, i, offset, &filter_mask, &address,
+                                          &size);
+        assert(status >= 0 && filter_mask == 0 && "Chunk écrit sans tous ses filtres");
+
+        hsize_t expected_size = 0;
+        H5Dget_chunk_storage_size(expected_id, offset, &expected_size);
+        assert(size == expected_size && "Taille compressée d'un chunk différente");
+
+        unsigned char* bytes = malloc(size);
+        unsigned char* expected_bytes = malloc(size);
+        uint32_t filters = 0;
+        status = H5Dread_chunk(dataset_id, H5P_DEFAULT, offset, &filters, bytes);
+        status |= H5Dread_chunk(expected_id, H5P_DEFAULT, offset, &filters, expected_bytes);
+        assert(status >= 0 && memcmp(bytes, expected_bytes, size) == 0 &&
+               "Contenu compressé d'un chunk différent");
+        free(expected_bytes);
+        free(bytes);
+    }
+
+    H5Sclose(space);
+    H5Sclose(expected_space);
+    H5Dclose(dataset_id);
+    H5Dclose(expected_id);
+}
+
+static void read_back(hid_t file_id, const char* path, hid_t mem_type_id, void* out) {
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    herr_t status = H5Dread(dataset_id, mem_type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, out);
+    assert(status >= 0 && "Relecture a échoué");
+    H5Dclose(dataset_id);
+}
+
+/* Écrit les mêmes données avec le pipeline HDF5 puis avec threads threads */
+static void log_all(hdf5_logger_t* logger, size_t threads, const unsigned char* pixels,
+                    const double* matrix) {
+    // Tuiles de 4 Kio : chunks de bord incomplets dans les deux dimensions
+    size_t dims[2] = {MATRIX_ROWS, MATRIX_COLS};
+    hdf5_array_layout_t tile = {HDF5_ACCESS_TILE, 4096};
+    hdf5_codec_policy_t deflate6 = {HDF5_CODEC_DEFLATE, 6, 0, HDF5_PREDICT_NONE};
+    hdf5_codec_policy_t none = {HDF5_CODEC_NONE, 0, 0, HDF5_PREDICT_NONE};
+
+    int status = hdf5_logger_set_compression_threads(logger, 0);
+    status |= hdf5_log_image(logger, "/serial", "image", pixels, IMAGE_WIDTH, IMAGE_HEIGHT, 3);
+    status |= hdf5_log_image(logger, "/serial", "gray", pixels, IMAGE_WIDTH, IMAGE_HEIGHT, 1);
+    status |= hdf5_log_array_nd(logger, "/serial", "matrix", matrix, 2, dims, 1, &tile);
+    status |= hdf5_logger_set_group_codec(logger, "/serial", HDF5_DATA_IMAGE, &deflate6);
+    status |= hdf5_log_image(logger, "/serial", "image6", pixels, IMAGE_WIDTH, IMAGE_HEIGHT, 3);
+    assert(status == 0 && "Écriture par le pipeline HDF5 a échoué");
+
+    status = hdf5_logger_set_compression_threads(logger, threads);
+    status |= hdf5_log_image(logger, "/parallel", "image", pixels, IMAGE_WIDTH, IMAGE_HEIGHT, 3);
+    status |= hdf5_log_image(logger, "/parallel", "gray", pixels, IMAGE_WIDTH, IMAGE_HEIGHT, 1);
+    status |= hdf5_log_array_nd(logger, "/parallel", "matrix", matrix, 2, dims, 1, &tile);
+    status |= hdf5_logger_set_group_codec(logger, "/parallel", HDF5_DATA_IMAGE, &deflate6);
+    status |= hdf5_log_image(logger, "/parallel", "image6", pixels, IMAGE_WIDTH, IMAGE_HEIGHT, 3);
+
+    // Sans compression, le pipeline HDF5 est utilisé même avec des threads
+    status |= hdf5_logger_set_group_codec(logger, "/parallel", HDF5_DATA_IMAGE, &none);
+    status |= hdf5_log_image(logger, "/parallel", "raw", pixels, IMAGE_WIDTH, IMAGE_HEIGHT, 3);
+    assert(status == 0 && "Écriture par les threads de compression a échoué");
+}
+
+static void check_all(const char* filename, const unsigned char* pixels, const double* matrix) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+
+    check_same_chunks(file_id, "/serial/image", "/parallel/image");
+    check_same_chunks(file_id, "/serial/gray", "/parallel/gray");
+    check_same_chunks(file_id, "/serial/matrix", "/parallel/matrix");
+    check_same_chunks(file_id, "/serial/image6", "/parallel/image6");
+
+    // Relecture par le pipeline HDF5 standard
+    size_t pixel_bytes = IMAGE_WIDTH * IMAGE_HEIGHT * 3;
+    unsigned char* image = malloc(pixel_bytes);
+    read_back(file_id, "/parallel/image", H5T_NATIVE_UCHAR, image);
+    assert(memcmp(image, pixels, pixel_bytes) == 0 && "Image relue incorrecte");
+    read_back(file_id, "/parallel/raw", H5T_NATIVE_UCHAR, image);
+    assert(memcmp(image, pixels, pixel_bytes) == 0 && "Image non compressée relue incorrecte");
+    free(image);
+
+    double* values = malloc(MATRIX_ROWS * MATRIX_COLS * sizeof(double));
+    read_back(file_id, "/parallel/matrix", H5T_NATIVE_DOUBLE, values);
+    assert(memcmp(values, matrix, MATRIX_ROWS * MATRIX_COLS * sizeof(double)) == 0 &&
+           "Matrice relue incorrecte");
+    free(values);
+
+    H5Fclose(file_id);
+}
+
+int main() {
+    printf("Test de la compression parallèle des chunks\n");
+
+    unsigned char* pixels = malloc(IMAGE_WIDTH * IMAGE_HEIGHT * 3);
+    for (int i = 0; i < IMAGE_WIDTH * IMAGE_HEIGHT * 3; i++) {
+        pixels[i] = (unsigned char)((i / 3) % IMAGE_WIDTH + (i % 3) * 40);
+    }
+    double* matrix = malloc(MATRIX_ROWS * MATRIX_COLS * sizeof(double));
+    for (int i = 0; i < MATRIX_ROWS * MATRIX_COLS; i++) {
+        matrix[i] = (double)(i % 500) * 0.125;
+    }
+
+    remove("test_parallel.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_parallel.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+    log_all(logger, 4, pixels, matrix);
+
+    // Nombre de threads invalide
+    assert(hdf5_logger_set_compression_threads(logger, HDF5_LOGGER_MAX_COMPRESSION_THREADS + 1) == -1 &&
+           "Trop de threads devrait être refusé");
+    assert(hdf5_logger_set_compression_threads(NULL, 2) == -1 && "Logger NULL devrait être refusé");
+
+    int status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    check_all("test_parallel.h5", pixels, matrix);
+
+    // Le thread d'écriture du mode asynchrone utilise les mêmes threads
+    remove("test_parallel_async.h5");
+    logger = hdf5_logger_init_async("test_parallel_async.h5", NULL);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    log_all(logger, 3, pixels, matrix);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+    check_all("test_parallel_async.h5", pixels, matrix);
+
+    free(matrix);
+    free(pixels);
+    printf("Tests de la compression parallèle réussis!\n");
+    return 0;
+}
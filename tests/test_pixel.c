@@ -0,0 +1,382 @@
+/**
+ * @file test_pixel.c
+ * @brief Test des images en plans et des formats de caméra
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+/* Dimensions choisies pour couvrir les boucles vectorielles et leur fin scalaire */
+#define WIDTH 70
+#define HEIGHT 38
+#define BGR_PITCH 224
+#define YUYV_PITCH 160
+#define AREA (WIDTH * HEIGHT)
+
+static unsigned char clamp_u8(int value) {
+    return (unsigned char)((value < 0) ? 0 : (value > 255) ? 255 : value);
+}
+
+/* BT.601 plage limitée, coefficients x 64 */
+static void yuv_reference(int y, int u, int v, unsigned char* rgb) {
+    int c = 74 * (y - 16) + 32;
+    rgb[0] = clamp_u8((c + 102 * (v - 128)) >> 6);
+    rgb[1] = clamp_u8((c - 25 * (u - 128) - 52 * (v - 128)) >> 6);
+    rgb[2] = clamp_u8((c + 129 * (u - 128)) >> 6);
+}
+
+static unsigned char average(unsigned char a, unsigned char b) {
+    return (unsigned char)((a + b + 1) >> 1);
+}
+
+static size_t mirror(long index, long size) {
+    if (index < 0) {
+        return 1;
+    }
+    if (index >= size) {
+        return (size_t)size - 2;
+    }
+    return (size_t)index;
+}
+
+/* Dématriçage bilinéaire, bords complétés par symétrie ; pattern donne la couleur
+ * (0 = R, 1 = G, 2 = B) selon la parité de la ligne et de la colonne */
+static void bayer_reference(const unsigned char* raw, const int* pattern, unsigned char* rgb) {
+    for (long y = 0; y < HEIGHT; y++) {
+        for (long x = 0; x < WIDTH; x++) {
+            size_t up = mirror(y - 1, HEIGHT) * WIDTH;
+            size_t row = (size_t)y * WIDTH;
+            size_t down = mirror(y + 1, HEIGHT) * WIDTH;
+            size_t left = mirror(x - 1, WIDTH);
+            size_t right = mirror(x + 1, WIDTH);
+            unsigned char h = average(raw[row + left], raw[row + right]);
+            unsigned char v = average(raw[up + x], raw[down + x]);
+            unsigned char cross = average(h, v);
+            unsigned char diagonal = average(average(raw[up + left], raw[up + right]),
+                                             average(raw[down + left], raw[down + right]));
+            int site = pattern[(y & 1) * 2 + (x & 1)];
+            int across = pattern[(y & 1) * 2 + ((x + 1) & 1)];
+            for (int k = 0; k < 3; k++) {
+                unsigned char value;
+                if (k == site) {
+                    value = raw[row + x];
+                } else if (site == 1) {
+                    value = (k == across) ? h : v;
+                } else {
+                    value = (k == 1) ? cross : diagonal;
+                }
+                rgb[(row + x) * 3 + k] = value;
+            }
+        }
+    }
+}
+
+static void read_dataset(hid_t file_id, const char* path, hid_t mem_type, void* values,
+                         int rank, const hsize_t* dims) {
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Dataset introuvable");
+    hid_t space_id = H5Dget_space(dataset_id);
+    hsize_t extent[3];
+    assert(H5Sget_simple_extent_ndims(space_id) == rank && "Rang du dataset incorrect");
+    H5Sget_simple_extent_dims(space_id, extent, NULL);
+    for (int i = 0; i < rank; i++) {
+        assert(extent[i] == dims[i] && "Dimensions du dataset incorrectes");
+    }
+    H5Sclose(space_id);
+    assert(H5Dread(dataset_id, mem_type, H5S_ALL, H5S_ALL, H5P_DEFAULT, values) >= 0 &&
+           "Lecture du dataset a échoué");
+    H5Dclose(dataset_id);
+}
+
+static int is_planar(hid_t file_id, const char* path) {
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    int planar = 0;
+    if (H5Aexists(dataset_id, "layout") > 0) {
+        char value[16] = {0};
+        hid_t attr_id = H5Aopen(dataset_id, "layout", H5P_DEFAULT);
+        hid_t type_id = H5Aget_type(attr_id);
+        assert(H5Tget_size(type_id) < sizeof(value) && "Attribut layout trop long");
+        H5Aread(attr_id, type_id, value);
+        H5Tclose(type_id);
+        H5Aclose(attr_id);
+        planar = (strcmp(value, "planar") == 0);
+        assert(planar && "Attribut layout inattendu");
+    }
+    H5Dclose(dataset_id);
+    return planar;
+}
+
+/* Vérifie une image RGB(A) 8 bits, en plans ou entrelacée, contre les pixels attendus */
+static void check_rgb(hid_t file_id, const char* path, const unsigned char* expected,
+                      size_t channels, int planar) {
+    unsigned char* pixels = malloc(AREA * channels);
+    hsize_t planar_dims[3] = {channels, HEIGHT, WIDTH};
+    hsize_t interleaved_dims[3] = {HEIGHT, WIDTH, channels};
+    read_dataset(file_id, path, H5T_NATIVE_UCHAR, pixels, 3,
+                 planar ? planar_dims : interleaved_dims);
+    assert(is_planar(file_id, path) == planar && "Disposition de l'image incorrecte");
+    for (size_t i = 0; i < AREA; i++) {
+        for (size_t k = 0; k < channels; k++) {
+            unsigned char value = planar ? pixels[k * AREA + i] : pixels[i * channels + k];
+            assert(value == expected[i * channels + k] && "Pixel converti incorrect");
+        }
+    }
+    free(pixels);
+}
+
+/* Images camera : les mêmes pixels bruts sont relus en RGB attendu */
+typedef struct {
+    unsigned char bgr[HEIGHT * BGR_PITCH];
+    unsigned char bgra[AREA * 4];
+    unsigned char yuyv[HEIGHT * YUYV_PITCH];
+    unsigned char nv12[(HEIGHT + HEIGHT / 2) * WIDTH];
+    unsigned char bayer[AREA];
+    unsigned char rgb[AREA * 3];
+    unsigned char rgba[AREA * 4];
+    unsigned char from_yuyv[AREA * 3];
+    unsigned char from_nv12[AREA * 3];
+    unsigned char from_bayer[4][AREA * 3];
+} frames_t;
+
+static const int patterns[4][4] = {
+    {0, 1, 1, 2}, {2, 1, 1, 0}, {1, 0, 2, 1}, {1, 2, 0, 1}
+};
+
+static void make_frames(frames_t* f) {
+    unsigned int noise = 7;
+    for (size_t i = 0; i < AREA; i++) {
+        for (int k = 0; k < 4; k++) {
+            noise = noise * 1103515245u + 12345u;
+            f->rgba[i * 4 + k] = (unsigned char)(noise >> 24);
+        }
+        memcpy(f->rgb + i * 3, f->rgba + i * 4, 3);
+        f->bgra[i * 4] = f->rgba[i * 4 + 2];
+        f->bgra[i * 4 + 1] = f->rgba[i * 4 + 1];
+        f->bgra[i * 4 + 2] = f->rgba[i * 4];
+        f->bgra[i * 4 + 3] = f->rgba[i * 4 + 3];
+    }
+    for (size_t y = 0; y < HEIGHT; y++) {
+        for (size_t x = 0; x < WIDTH; x++) {
+            const unsigned char* rgb = f->rgb + (y * WIDTH + x) * 3;
+            unsigned char* bgr = f->bgr + y * BGR_PITCH + x * 3;
+            bgr[0] = rgb[2];
+            bgr[1] = rgb[1];
+            bgr[2] = rgb[0];
+        }
+    }
+
+    /* YUYV avec marge, NV12 contigu : valeurs extrêmes comprises pour la saturation */
+    for (size_t y = 0; y < HEIGHT; y++) {
+        for (size_t x = 0; x < WIDTH * 2; x++) {
+            noise = noise * 1103515245u + 12345u;
+            f->yuyv[y * YUYV_PITCH + x] = (unsigned char)(noise >> 24);
+        }
+        for (size_t x = 0; x < WIDTH; x++) {
+            const unsigned char* pair = f->yuyv + y * YUYV_PITCH + (x / 2) * 4;
+            yuv_reference(pair[(x & 1) * 2], pair[1], pair[3], f->from_yuyv + (y * WIDTH + x) * 3);
+        }
+    }
+    f->yuyv[0] = 255;
+    f->yuyv[1] = 255;
+    f->yuyv[3] = 0;
+    yuv_reference(255, 255, 0, f->from_yuyv);
+    yuv_reference(f->yuyv[2], 255, 0, f->from_yuyv + 3);
+    for (size_t i = 0; i < sizeof(f->nv12); i++) {
+        noise = noise * 1103515245u + 12345u;
+        f->nv12[i] = (unsigned char)(noise >> 24);
+    }
+    for (size_t y = 0; y < HEIGHT; y++) {
+        for (size_t x = 0; x < WIDTH; x++) {
+            const unsigned char* uv = f->nv12 + AREA + (y / 2) * WIDTH + (x / 2) * 2;
+            yuv_reference(f->nv12[y * WIDTH + x], uv[0], uv[1],
+                          f->from_nv12 + (y * WIDTH + x) * 3);
+        }
+    }
+
+    /* Mosaïque lisse avec des arêtes franches */
+    for (size_t y = 0; y < HEIGHT; y++) {
+        for (size_t x = 0; x < WIDTH; x++) {
+            f->bayer[y * WIDTH + x] = (unsigned char)((x * 5 + y * 3) ^ ((x / 9 + y / 7) * 40));
+        }
+    }
+    for (int p = 0; p < 4; p++) {
+        bayer_reference(f->bayer, patterns[p], f->from_bayer[p]);
+    }
+}
+
+static void log_frames(hdf5_logger_t* logger, const char* group, const frames_t* f) {
+    static const hdf5_pixel_format_t bayers[4] = {
+        HDF5_PIXEL_BAYER_RGGB, HDF5_PIXEL_BAYER_BGGR, HDF5_PIXEL_BAYER_GRBG, HDF5_PIXEL_BAYER_GBRG
+    };
+    char name[16];
+    int status = hdf5_log_image_format(logger, group, "bgr", f->bgr, WIDTH, HEIGHT,
+                                       HDF5_PIXEL_BGR8, BGR_PITCH);
+    status |= hdf5_log_image_format(logger, group, "bgra", f->bgra, WIDTH, HEIGHT,
+                                    HDF5_PIXEL_BGRA8, 0);
+    status |= hdf5_log_image_format(logger, group, "yuyv", f->yuyv, WIDTH, HEIGHT,
+                                    HDF5_PIXEL_YUYV, YUYV_PITCH);
+    status |= hdf5_log_image_format(logger, group, "nv12", f->nv12, WIDTH, HEIGHT,
+                                    HDF5_PIXEL_NV12, 0);
+    for (int p = 0; p < 4; p++) {
+        snprintf(name, sizeof(name), "bayer_%d", p);
+        status |= hdf5_log_image_format(logger, group, name, f->bayer, WIDTH, HEIGHT, bayers[p],
+                                        0);
+    }
+    assert(status == 0 && "Log des formats de caméra a échoué");
+}
+
+static void check_frames(hid_t file_id, const char* group, const frames_t* f, int planar) {
+    char path[64];
+    snprintf(path, sizeof(path), "%s/bgr", group);
+    check_rgb(file_id, path, f->rgb, 3, planar);
+    snprintf(path, sizeof(path), "%s/bgra", group);
+    check_rgb(file_id, path, f->rgba, 4, planar);
+    snprintf(path, sizeof(path), "%s/yuyv", group);
+    check_rgb(file_id, path, f->from_yuyv, 3, planar);
+    snprintf(path, sizeof(path), "%s/nv12", group);
+    check_rgb(file_id, path, f->from_nv12, 3, planar);
+    for (int p = 0; p < 4; p++) {
+        snprintf(path, sizeof(path), "%s/bayer_%d", group, p);
+        check_rgb(file_id, path, f->from_bayer[p], 3, planar);
+    }
+}
+
+int main() {
+    printf("Test des images en plans et des formats de caméra\n");
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    frames_t* frames = calloc(1, sizeof(frames_t));
+    make_frames(frames);
+
+    remove("test_pixel.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_pixel.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+
+    // Images en plans : RGB et RGBA 8 bits, RGB 16 bits, gris, lignes espacées
+    assert(hdf5_logger_set_image_layout(logger, "/planar", HDF5_IMAGE_PLANAR) == 0 &&
+           "Choix de la disposition a échoué");
+    uint16_t* deep = malloc(AREA * 3 * sizeof(uint16_t));
+    for (size_t i = 0; i < AREA * 3; i++) {
+        deep[i] = (uint16_t)(i * 977);
+    }
+    int status = hdf5_log_image(logger, "/planar", "rgb", frames->rgb, WIDTH, HEIGHT, 3);
+    status |= hdf5_log_image(logger, "/planar", "rgba", frames->rgba, WIDTH, HEIGHT, 4);
+    status |= hdf5_log_image_typed(logger, "/planar", "deep", deep, WIDTH, HEIGHT, 3,
+                                   HDF5_DTYPE_UINT16);
+    status |= hdf5_log_image(logger, "/planar", "gray", frames->bayer, WIDTH, HEIGHT, 1);
+    status |= hdf5_log_image_pitched(logger, "/planar", "pitched", frames->bgr, WIDTH, HEIGHT,
+                                     3, HDF5_DTYPE_UINT8, BGR_PITCH);
+    status |= hdf5_log_image(logger, "/interleaved", "rgb", frames->rgb, WIDTH, HEIGHT, 3);
+    assert(status == 0 && "Log des images a échoué");
+
+    // Formats de caméra, dans les deux dispositions
+    log_frames(logger, "/planar/camera", frames);
+    assert(hdf5_logger_set_image_layout(logger, "/planar/camera", HDF5_IMAGE_PLANAR) == 0 &&
+           "Choix de la disposition a échoué");
+    log_frames(logger, "/planar/camera", frames);
+    log_frames(logger, "/camera", frames);
+
+    // Une mise à jour par tuiles réécrit en entier une image en plans
+    unsigned char* changed = malloc(AREA * 3);
+    memcpy(changed, frames->rgb, AREA * 3);
+    changed[1234] ^= 0x55;
+    status = hdf5_log_image_update(logger, "/planar", "rgb", changed, WIDTH, HEIGHT, 3,
+                                   HDF5_DTYPE_UINT8, NULL, 0);
+    assert(status == 0 && "Mise à jour d'une image en plans a échoué");
+
+    // Retour à la disposition par défaut
+    assert(hdf5_logger_set_image_layout(logger, "/planar", HDF5_IMAGE_INTERLEAVED) == 0 &&
+           "Retour à la disposition par défaut a échoué");
+    status = hdf5_log_image(logger, "/planar", "restored", frames->rgb, WIDTH, HEIGHT, 3);
+    assert(status == 0 && "Log d'une image a échoué");
+
+    // Paramètres invalides
+    assert(hdf5_logger_set_image_layout(logger, "/planar", (hdf5_image_layout_t)7) == -1 &&
+           "Une disposition inconnue devrait être refusée");
+    assert(hdf5_logger_set_image_layout(logger, NULL, HDF5_IMAGE_PLANAR) == -1 &&
+           "Un groupe absent devrait être refusé");
+    assert(hdf5_log_image_format(logger, "/camera", "odd", frames->yuyv, WIDTH - 1, HEIGHT,
+                                 HDF5_PIXEL_YUYV, 0) == -1 &&
+           "Une largeur impaire devrait être refusée en YUYV");
+    assert(hdf5_log_image_format(logger, "/camera", "odd", frames->nv12, WIDTH, HEIGHT - 1,
+                                 HDF5_PIXEL_NV12, 0) == -1 &&
+           "Une hauteur impaire devrait être refusée en NV12");
+    assert(hdf5_log_image_format(logger, "/camera", "short", frames->bgr, WIDTH, HEIGHT,
+                                 HDF5_PIXEL_BGR8, WIDTH * 3 - 1) == -1 &&
+           "Un pas trop court devrait être refusé");
+    assert(hdf5_log_image_format(logger, "/camera", "tiny", frames->bayer, 1, HEIGHT,
+                                 HDF5_PIXEL_BAYER_RGGB, 0) == -1 &&
+           "Une mosaïque d'une colonne devrait être refusée");
+    assert(hdf5_log_image_format(logger, "/camera", "unknown", frames->bayer, WIDTH, HEIGHT,
+                                 (hdf5_pixel_format_t)42, 0) == -1 &&
+           "Un format inconnu devrait être refusé");
+
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    hid_t file_id = H5Fopen("test_pixel.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+    check_rgb(file_id, "/planar/rgba", frames->rgba, 4, 1);
+    unsigned char* packed = malloc(AREA * 3);
+    for (size_t y = 0; y < HEIGHT; y++) {
+        memcpy(packed + y * WIDTH * 3, frames->bgr + y * BGR_PITCH, WIDTH * 3);
+    }
+    check_rgb(file_id, "/planar/pitched", packed, 3, 1);
+    free(packed);
+    check_rgb(file_id, "/planar/rgb", changed, 3, 1);
+    check_rgb(file_id, "/planar/restored", frames->rgb, 3, 0);
+    check_rgb(file_id, "/interleaved/rgb", frames->rgb, 3, 0);
+    check_frames(file_id, "/planar/camera", frames, 1);
+    check_frames(file_id, "/camera", frames, 0);
+
+    uint16_t* read_back = malloc(AREA * 3 * sizeof(uint16_t));
+    hsize_t deep_dims[3] = {3, HEIGHT, WIDTH};
+    read_dataset(file_id, "/planar/deep", H5T_NATIVE_UINT16, read_back, 3, deep_dims);
+    for (size_t i = 0; i < AREA; i++) {
+        for (size_t k = 0; k < 3; k++) {
+            assert(read_back[k * AREA + i] == deep[i * 3 + k] && "Plan 16 bits incorrect");
+        }
+    }
+    unsigned char* gray = malloc(AREA);
+    hsize_t gray_dims[2] = {HEIGHT, WIDTH};
+    read_dataset(file_id, "/planar/gray", H5T_NATIVE_UCHAR, gray, 2, gray_dims);
+    assert(memcmp(gray, frames->bayer, AREA) == 0 && !is_planar(file_id, "/planar/gray") &&
+           "Une image grise devrait rester en deux dimensions");
+    H5Fclose(file_id);
+
+    // Mode asynchrone : l'image brute est convertie par le thread d'écriture
+    remove("test_pixel_async.h5");
+    logger = hdf5_logger_init_async("test_pixel_async.h5", NULL);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    assert(hdf5_logger_set_image_layout(logger, "/planar", HDF5_IMAGE_PLANAR) == 0 &&
+           "Choix de la disposition a échoué");
+    log_frames(logger, "/planar", frames);
+    log_frames(logger, "/camera", frames);
+    status = hdf5_log_image(logger, "/planar", "rgb", frames->rgb, WIDTH, HEIGHT, 3);
+    assert(status == 0 && "Log d'une image a échoué");
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+
+    file_id = H5Fopen("test_pixel_async.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    check_frames(file_id, "/planar", frames, 1);
+    check_frames(file_id, "/camera", frames, 0);
+    check_rgb(file_id, "/planar/rgb", frames->rgb, 3, 1);
+    H5Fclose(file_id);
+
+    assert(hdf5_logger_set_image_layout(NULL, "/planar", HDF5_IMAGE_PLANAR) == -1 &&
+           "Un logger absent devrait être refusé");
+
+    free(gray);
+    free(read_back);
+    free(changed);
+    free(deep);
+    free(frames);
+    printf("Tests des images en plans et des formats de caméra réussis!\n");
+    return 0;
+}
@@ -0,0 +1,279 @@
+/**
+ * @file test_png.c
+ * @brief Test de la prédiction PNG des images : prédicteur par ligne et image précédente
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define WIDTH 301
+#define HEIGHT 203
+#define GRAY_WIDTH 150
+#define GRAY_HEIGHT 97
+#define FRAME_WIDTH 64
+#define FRAME_HEIGHT 48
+#define FRAMES 11
+#define MORE_FRAMES 5
+
+typedef struct {
+    uint8_t rgb[HEIGHT * WIDTH * 3];
+    uint8_t rgba[HEIGHT * WIDTH * 4];
+    uint8_t gray[HEIGHT * WIDTH];
+    uint16_t deep[GRAY_HEIGHT * GRAY_WIDTH];
+    uint32_t wide[GRAY_HEIGHT * GRAY_WIDTH];
+    uint8_t frames[FRAMES + MORE_FRAMES][FRAME_HEIGHT * FRAME_WIDTH * 3];
+} images_t;
+
+/* Bandes horizontales favorables à chaque prédicteur : dégradé horizontal (gauche), motif
+ * constant sur la hauteur (dessus), surface lisse (Paeth) et bruit (aucun) */
+static unsigned int band_value(size_t x, size_t y, size_t c, unsigned int* noise) {
+    switch ((y / 24) % 4) {
+        case 0: return (unsigned int)(x * 3 + c * 40);
+        case 1: return (unsigned int)(((x * 7) ^ (x >> 2)) + c * 17);
+        case 2: return (unsigned int)((x * y) / 16 + x + c * 5);
+        default:
+            *noise = *noise * 1103515245u + 12345u;
+            return *noise >> 16;
+    }
+}
+
+static void fill_images(images_t* im) {
+    unsigned int noise = 3;
+    for (size_t y = 0; y < HEIGHT; y++) {
+        for (size_t x = 0; x < WIDTH; x++) {
+            for (size_t c = 0; c < 4; c++) {
+                unsigned int v = band_value(x, y, c, &noise);
+                im->rgba[(y * WIDTH + x) * 4 + c] = (uint8_t)v;
+                if (c < 3) {
+                    im->rgb[(y * WIDTH + x) * 3 + c] = (uint8_t)v;
+                }
+            }
+            im->gray[y * WIDTH + x] = im->rgb[(y * WIDTH + x) * 3 + 1];
+        }
+    }
+    for (size_t y = 0; y < GRAY_HEIGHT; y++) {
+        for (size_t x = 0; x < GRAY_WIDTH; x++) {
+            unsigned int v = band_value(x, y, 0, &noise);
+            im->deep[y * GRAY_WIDTH + x] = (uint16_t)(v * 211u + 40000u);
+            im->wide[y * GRAY_WIDTH + x] = v * 70001u;
+        }
+    }
+
+    /* Fond fixe et bruité, un carré qui se déplace d'image en image */
+    uint8_t background[FRAME_HEIGHT * FRAME_WIDTH * 3];
+    for (size_t i = 0; i < sizeof(background); i++) {
+        noise = noise * 1103515245u + 12345u;
+        background[i] = (uint8_t)((i / 3 % FRAME_WIDTH) * 2 + (noise >> 26));
+    }
+    for (int f = 0; f < FRAMES + MORE_FRAMES; f++) {
+        memcpy(im->frames[f], background, sizeof(background));
+        for (size_t y = 10; y < 20; y++) {
+            for (size_t x = (size_t)f * 3; x < (size_t)f * 3 + 10; x++) {
+                memset(im->frames[f] + (y * FRAME_WIDTH + x) * 3, 250, 3);
+            }
+        }
+    }
+}
+
+static void write_group(hdf5_logger_t* logger, const char* group, const images_t* im) {
+    int status = hdf5_log_image(logger, group, "rgb", im->rgb, WIDTH, HEIGHT, 3);
+    status |= hdf5_log_image(logger, group, "rgba", im->rgba, WIDTH, HEIGHT, 4);
+    status |= hdf5_log_image(logger, group, "gray", im->gray, WIDTH, HEIGHT, 1);
+    status |= hdf5_log_image_typed(logger, group, "deep", im->deep, GRAY_WIDTH, GRAY_HEIGHT, 1,
+                                   HDF5_DTYPE_UINT16);
+    status |= hdf5_log_image_typed(logger, group, "wide", im->wide, GRAY_WIDTH, GRAY_HEIGHT, 1,
+                                   HDF5_DTYPE_UINT32);
+    assert(status == 0 && "Log des images a échoué");
+
+    /* Même image RGB en plans : les plans d'un chunk se suivent comme des images */
+    char planar[64];
+    snprintf(planar, sizeof(planar), "%s/planar", group);
+    assert(hdf5_logger_set_image_layout(logger, planar, HDF5_IMAGE_PLANAR) == 0 &&
+           "Réglage de la disposition a échoué");
+    const hdf5_codec_policy_t* policy = NULL;
+    hdf5_codec_policy_t png = {HDF5_CODEC_DEFLATE, 1, 0, HDF5_PREDICT_PNG_FRAME};
+    if (strcmp(group, "/plain") != 0) {
+        policy = &png;
+    }
+    assert(hdf5_logger_set_group_codec(logger, planar, HDF5_DATA_IMAGE, policy) == 0 &&
+           "Politique des plans refusée");
+    assert(hdf5_log_image(logger, planar, "rgb", im->rgb, WIDTH, HEIGHT, 3) == 0 &&
+           "Log d'une image en plans a échoué");
+
+    for (int f = 0; f < FRAMES; f++) {
+        status = hdf5_log_image_frame(logger, group, "video", im->frames[f], FRAME_WIDTH,
+                                      FRAME_HEIGHT, 3);
+        assert(status == 0 && "Ajout d'une image à la séquence a échoué");
+    }
+}
+
+static hsize_t read_image(hid_t file_id, const char* group, const char* name, hid_t mem_type_id,
+                          void* values) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s", group, name);
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Dataset introuvable");
+    assert(H5Dread(dataset_id, mem_type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, values) >= 0 &&
+           "Lecture du dataset a échoué");
+    hsize_t stored = H5Dget_storage_size(dataset_id);
+    H5Dclose(dataset_id);
+    return stored;
+}
+
+/* Vérifie les paramètres de la prédiction : prédiction, taille, pixel, ligne, lignes d'image */
+static void check_filter(hid_t file_id, const char* group, const char* name,
+                         const unsigned int* expected, size_t count) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s", group, name);
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    hid_t plist_id = H5Dget_create_plist(dataset_id);
+    unsigned int flags = 0;
+    size_t nelmts = 5;
+    unsigned int values[5] = {0};
+    H5Z_filter_t filter = H5Pget_filter2(plist_id, 0, &flags, &nelmts, values, 0, NULL, NULL);
+    assert(filter == HDF5_LOGGER_FILTER_PREDICT && "La prédiction devrait être le premier filtre");
+    assert(nelmts == count && memcmp(values, expected, count * sizeof(unsigned int)) == 0 &&
+           "Paramètres de la prédiction incorrects");
+    H5Pclose(plist_id);
+    H5Dclose(dataset_id);
+}
+
+/* Relit un groupe ; stored reçoit les octets stockés de rgb, rgba, gray, deep et video */
+static void check_group(hid_t file_id, const char* group, const images_t* im, hsize_t* stored) {
+    uint8_t* bytes = malloc(HEIGHT * WIDTH * 4);
+    stored[0] = read_image(file_id, group, "rgb", H5T_NATIVE_UINT8, bytes);
+    assert(memcmp(bytes, im->rgb, sizeof(im->rgb)) == 0 && "Image RGB incorrecte");
+    stored[1] = read_image(file_id, group, "rgba", H5T_NATIVE_UINT8, bytes);
+    assert(memcmp(bytes, im->rgba, sizeof(im->rgba)) == 0 && "Image RGBA incorrecte");
+    stored[2] = read_image(file_id, group, "gray", H5T_NATIVE_UINT8, bytes);
+    assert(memcmp(bytes, im->gray, sizeof(im->gray)) == 0 && "Image grise incorrecte");
+    stored[3] = read_image(file_id, group, "deep", H5T_NATIVE_UINT16, bytes);
+    assert(memcmp(bytes, im->deep, sizeof(im->deep)) == 0 && "Image 16 bits incorrecte");
+    read_image(file_id, group, "wide", H5T_NATIVE_UINT32, bytes);
+    assert(memcmp(bytes, im->wide, sizeof(im->wide)) == 0 && "Image 32 bits incorrecte");
+
+    /* Plans R, G, B relus dans l'ordre des plans */
+    char planar[64];
+    snprintf(planar, sizeof(planar), "%s/planar", group);
+    read_image(file_id, planar, "rgb", H5T_NATIVE_UINT8, bytes);
+    for (size_t i = 0; i < (size_t)WIDTH * HEIGHT * 3; i++) {
+        size_t c = i / ((size_t)WIDTH * HEIGHT);
+        size_t pixel = i % ((size_t)WIDTH * HEIGHT);
+        assert(bytes[i] == im->rgb[pixel * 3 + c] && "Image en plans incorrecte");
+    }
+    free(bytes);
+
+    uint8_t* frames = malloc(sizeof(im->frames));
+    stored[4] = read_image(file_id, group, "video", H5T_NATIVE_UINT8, frames);
+    assert(memcmp(frames, im->frames, FRAMES * sizeof(im->frames[0])) == 0 &&
+           "Séquence d'images incorrecte");
+    free(frames);
+}
+
+static void run(const char* filename, size_t threads, const images_t* im) {
+    remove(filename);
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+    assert(hdf5_logger_set_compression_threads(logger, threads) == 0 &&
+           "Réglage des threads de compression a échoué");
+
+    hdf5_codec_policy_t png = {HDF5_CODEC_DEFLATE, 1, 0, HDF5_PREDICT_PNG};
+    hdf5_codec_policy_t png_frame = {HDF5_CODEC_DEFLATE, 1, 1, HDF5_PREDICT_PNG_FRAME};
+    int status = hdf5_logger_set_group_codec(logger, "/png", HDF5_DATA_IMAGE, &png);
+    status |= hdf5_logger_set_group_codec(logger, "/png_frame", HDF5_DATA_IMAGE, &png_frame);
+    assert(status == 0 && "Politique PNG refusée");
+
+    write_group(logger, "/plain", im);
+    write_group(logger, "/png", im);
+    write_group(logger, "/png_frame", im);
+    assert(hdf5_logger_close(logger) == 0 && "La fermeture du logger a échoué");
+
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+    hsize_t plain[5];
+    hsize_t rows[5];
+    hsize_t frame[5];
+    check_group(file_id, "/plain", im, plain);
+    check_group(file_id, "/png", im, rows);
+    check_group(file_id, "/png_frame", im, frame);
+
+    /* Géométrie rangée avec le filtre : chunks de 128 x 128 pixels au plus */
+    const unsigned int rgb[5] = {HDF5_PREDICT_PNG, 1, 3, 128 * 3, 128};
+    const unsigned int rgba[5] = {HDF5_PREDICT_PNG, 1, 4, 128 * 4, 128};
+    const unsigned int gray[5] = {HDF5_PREDICT_PNG, 1, 1, 128, 128};
+    const unsigned int deep[5] = {HDF5_PREDICT_PNG_FRAME, 2, 1, 128, 97};
+    const unsigned int planar[5] = {HDF5_PREDICT_PNG_FRAME, 1, 1, 128, 128};
+    const unsigned int video[5] = {HDF5_PREDICT_PNG_FRAME, 1, 3, FRAME_WIDTH * 3, FRAME_HEIGHT};
+    const unsigned int wide[2] = {HDF5_PREDICT_DELTA, 4};
+    check_filter(file_id, "/png", "rgb", rgb, 5);
+    check_filter(file_id, "/png", "rgba", rgba, 5);
+    check_filter(file_id, "/png", "gray", gray, 5);
+    check_filter(file_id, "/png_frame", "deep", deep, 5);
+    check_filter(file_id, "/png_frame/planar", "rgb", planar, 5);
+    check_filter(file_id, "/png_frame", "video", video, 5);
+    check_filter(file_id, "/png", "wide", wide, 2);
+
+    /* Huit images par chunk avec la prédiction par l'image précédente */
+    hid_t dataset_id = H5Dopen2(file_id, "/png_frame/video", H5P_DEFAULT);
+    hid_t plist_id = H5Dget_create_plist(dataset_id);
+    hsize_t chunk[4] = {0};
+    assert(H5Pget_chunk(plist_id, 4, chunk) == 4 && chunk[0] == 8 && "Chunk de séquence incorrect");
+    H5Pclose(plist_id);
+    H5Dclose(dataset_id);
+    dataset_id = H5Dopen2(file_id, "/png/video", H5P_DEFAULT);
+    plist_id = H5Dget_create_plist(dataset_id);
+    assert(H5Pget_chunk(plist_id, 4, chunk) == 4 && chunk[0] == 1 && "Chunk de séquence incorrect");
+    H5Pclose(plist_id);
+    H5Dclose(dataset_id);
+
+    for (int i = 0; i < 4; i++) {
+        assert(rows[i] < plain[i] && "La prédiction PNG devrait mieux compresser");
+    }
+    assert(frame[4] < rows[4] && "L'image précédente devrait mieux prédire une scène fixe");
+    H5Fclose(file_id);
+}
+
+int main() {
+    printf("Test de la prédiction PNG des images\n");
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    images_t* im = malloc(sizeof(images_t));
+    fill_images(im);
+
+    // Pipeline HDF5, puis compression parallèle avec écriture directe des chunks
+    run("test_png.h5", 1, im);
+    run("test_png_parallel.h5", 3, im);
+
+    // Prédiction PNG réservée aux images
+    hdf5_logger_t* logger = hdf5_logger_init("test_png.h5");
+    assert(logger != NULL && "La réouverture du logger a échoué");
+    hdf5_codec_policy_t png = {HDF5_CODEC_DEFLATE, 1, 0, HDF5_PREDICT_PNG};
+    assert(hdf5_logger_set_codec(logger, HDF5_DATA_NUMERIC, &png) == -1 &&
+           "Une prédiction PNG des tableaux devrait être refusée");
+    assert(hdf5_logger_set_codec(logger, HDF5_DATA_TEXT, &png) == -1 &&
+           "Une prédiction PNG du texte devrait être refusée");
+
+    // Séquence prolongée dans une nouvelle session : le dernier chunk partiel est relu
+    for (int f = FRAMES; f < FRAMES + MORE_FRAMES; f++) {
+        assert(hdf5_log_image_frame(logger, "/png_frame", "video", im->frames[f], FRAME_WIDTH,
+                                    FRAME_HEIGHT, 3) == 0 && "Prolongation de la séquence a échoué");
+    }
+    assert(hdf5_logger_close(logger) == 0 && "La fermeture du logger a échoué");
+
+    hid_t file_id = H5Fopen("test_png.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    uint8_t* frames = malloc(sizeof(im->frames));
+    read_image(file_id, "/png_frame", "video", H5T_NATIVE_UINT8, frames);
+    assert(memcmp(frames, im->frames, sizeof(im->frames)) == 0 && "Séquence prolongée incorrecte");
+    free(frames);
+    H5Fclose(file_id);
+
+    free(im);
+    printf("Tests de la prédiction PNG réussis!\n");
+    return 0;
+}
@@ -0,0 +1,267 @@
+/**
+ * @file test_predict.c
+ * @brief Test du filtre de prédiction : écart et ou exclusif avec l'élément précédent
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define SIGNAL 200000
+#define RAMP 50000
+#define SHORT_MAX 40
+#define SHORT_FRAMES 3
+#define SIDE 256
+#define FRAMES 20
+#define FRAME 512
+
+typedef struct {
+    float* sine;
+    double* telemetry;
+    int32_t* ramp;
+    uint8_t pixels[SIDE * SIDE];
+    float frames[FRAMES][FRAME];
+} signals_t;
+
+static void fill_signals(signals_t* s) {
+    s->sine = malloc(SIGNAL * sizeof(float));
+    s->telemetry = malloc(SIGNAL * sizeof(double));
+    for (int i = 0; i < SIGNAL; i++) {
+        s->sine[i] = sinf(i * 0.001f);
+        s->telemetry[i] = 20.0 + 0.5 * sin(i * 0.0005);
+    }
+    s->ramp = malloc(RAMP * sizeof(int32_t));
+    unsigned int noise = 7;
+    for (int i = 0; i < RAMP; i++) {
+        noise = noise * 1103515245u + 12345u;
+        s->ramp[i] = -1000000 + i * 41 + (int32_t)((noise >> 16) & 3);
+    }
+    for (int y = 0; y < SIDE; y++) {
+        for (int x = 0; x < SIDE; x++) {
+            s->pixels[y * SIDE + x] = (uint8_t)(x + y);
+        }
+    }
+    for (int f = 0; f < FRAMES; f++) {
+        for (int i = 0; i < FRAME; i++) {
+            s->frames[f][i] = sinf((f * FRAME + i) * 0.01f);
+        }
+    }
+}
+
+/* Valeur d'un élément court : toutes les tailles, queues des registres comprises */
+static uint64_t short_value(int length, int i) {
+    return 0x0123456789ABCDEFULL * (uint64_t)(i + 1) + (uint64_t)length * 977u;
+}
+
+static void write_group(hdf5_logger_t* logger, const char* group, const signals_t* s) {
+    int status = hdf5_log_array_1d(logger, group, "sine", s->sine, SIGNAL, HDF5_DTYPE_FLOAT32);
+    status |= hdf5_log_array_1d(logger, group, "telemetry", s->telemetry, SIGNAL,
+                                HDF5_DTYPE_FLOAT64);
+    status |= hdf5_log_array_1d(logger, group, "ramp", s->ramp, RAMP, HDF5_DTYPE_INT32);
+    assert(status == 0 && "Log des signaux a échoué");
+
+    /* Séries de trames courtes : les chunks de k x length éléments exercent toutes les
+     * queues des registres */
+    static const hdf5_dtype_t types[4] = {HDF5_DTYPE_UINT8, HDF5_DTYPE_UINT16, HDF5_DTYPE_UINT32,
+                                          HDF5_DTYPE_UINT64};
+    for (int t = 0; t < 4; t++) {
+        size_t size = (size_t)1 << t;
+        for (int length = 1; length <= SHORT_MAX; length++) {
+            char name[32];
+            snprintf(name, sizeof(name), "short_%d_%d", (int)size, length);
+            for (int frame = 0; frame < SHORT_FRAMES; frame++) {
+                unsigned char values[SHORT_MAX * 8];
+                for (int i = 0; i < length; i++) {
+                    uint64_t v = short_value(length, frame * length + i);
+                    memcpy(values + i * size, &v, size); /* Octets de poids faible (petit-boutiste) */
+                }
+                size_t dims[1] = {(size_t)length};
+                status = hdf5_log_array_append(logger, group, name, values, 1, dims, types[t]);
+                assert(status == 0 && "Ajout d'une trame courte a échoué");
+            }
+        }
+    }
+
+    for (int f = 0; f < FRAMES; f++) {
+        size_t dims[1] = {FRAME};
+        status = hdf5_log_array_append(logger, group, "series", s->frames[f], 1, dims,
+                                       HDF5_DTYPE_FLOAT32);
+        assert(status == 0 && "Ajout d'une trame a échoué");
+    }
+    status = hdf5_log_image(logger, group, "gradient", s->pixels, SIDE, SIDE, 1);
+    assert(status == 0 && "Log d'une image a échoué");
+}
+
+static hsize_t read_dataset(hid_t file_id, const char* group, const char* name,
+                            hid_t mem_type_id, void* values) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s", group, name);
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Dataset introuvable");
+    assert(H5Dread(dataset_id, mem_type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, values) >= 0 &&
+           "Lecture du dataset a échoué");
+    hsize_t stored = H5Dget_storage_size(dataset_id);
+    H5Dclose(dataset_id);
+    return stored;
+}
+
+/* Vérifie que le premier filtre est la prédiction attendue (0 = aucune) */
+static void check_filter(hid_t file_id, const char* group, const char* name,
+                         unsigned int predictor, unsigned int element_size) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s", group, name);
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    hid_t plist_id = H5Dget_create_plist(dataset_id);
+    unsigned int flags = 0;
+    size_t nelmts = 2;
+    unsigned int values[2] = {0, 0};
+    H5Z_filter_t filter = H5Pget_filter2(plist_id, 0, &flags, &nelmts, values, 0, NULL, NULL);
+    if (predictor == 0) {
+        assert(filter != HDF5_LOGGER_FILTER_PREDICT && "Aucune prédiction attendue");
+    } else {
+        assert(filter == HDF5_LOGGER_FILTER_PREDICT && "La prédiction devrait être le premier filtre");
+        assert(nelmts == 2 && values[0] == predictor && values[1] == element_size &&
+               "Paramètres de la prédiction incorrects");
+    }
+    H5Pclose(plist_id);
+    H5Dclose(dataset_id);
+}
+
+/* Relit un groupe ; renvoie les octets stockés des trois signaux */
+static void check_group(hid_t file_id, const char* group, const signals_t* s, hsize_t* stored) {
+    float* sine = malloc(SIGNAL * sizeof(float));
+    double* telemetry = malloc(SIGNAL * sizeof(double));
+    int32_t* ramp = malloc(RAMP * sizeof(int32_t));
+    stored[0] = read_dataset(file_id, group, "sine", H5T_NATIVE_FLOAT, sine);
+    stored[1] = read_dataset(file_id, group, "telemetry", H5T_NATIVE_DOUBLE, telemetry);
+    stored[2] = read_dataset(file_id, group, "ramp", H5T_NATIVE_INT32, ramp);
+    assert(memcmp(sine, s->sine, SIGNAL * sizeof(float)) == 0 && "Signal float incorrect");
+    assert(memcmp(telemetry, s->telemetry, SIGNAL * sizeof(double)) == 0 &&
+           "Signal double incorrect");
+    assert(memcmp(ramp, s->ramp, RAMP * sizeof(int32_t)) == 0 && "Rampe int32 incorrecte");
+    free(ramp);
+    free(telemetry);
+    free(sine);
+
+    for (int t = 0; t < 4; t++) {
+        size_t size = (size_t)1 << t;
+        hid_t mem_type_id = (size == 1) ? H5T_NATIVE_UINT8 : (size == 2) ? H5T_NATIVE_UINT16
+                          : (size == 4) ? H5T_NATIVE_UINT32 : H5T_NATIVE_UINT64;
+        for (int length = 1; length <= SHORT_MAX; length++) {
+            unsigned char values[SHORT_FRAMES * SHORT_MAX * 8];
+            char name[32];
+            snprintf(name, sizeof(name), "short_%d_%d", (int)size, length);
+            read_dataset(file_id, group, name, mem_type_id, values);
+            for (int i = 0; i < SHORT_FRAMES * length; i++) {
+                uint64_t v = short_value(length, i);
+                assert(memcmp(values + i * size, &v, size) == 0 && "Trame courte incorrecte");
+            }
+        }
+    }
+
+    float frames[FRAMES][FRAME];
+    read_dataset(file_id, group, "series", H5T_NATIVE_FLOAT, frames);
+    assert(memcmp(frames, s->frames, sizeof(frames)) == 0 && "Série incorrecte");
+
+    uint8_t pixels[SIDE * SIDE];
+    read_dataset(file_id, group, "gradient", H5T_NATIVE_UINT8, pixels);
+    assert(memcmp(pixels, s->pixels, sizeof(pixels)) == 0 && "Image incorrecte");
+}
+
+static void run(const char* filename, size_t threads, const signals_t* s) {
+    remove(filename);
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+    assert(hdf5_logger_set_compression_threads(logger, threads) == 0 &&
+           "Réglage des threads de compression a échoué");
+
+    hdf5_codec_policy_t xor_policy = {HDF5_CODEC_DEFLATE, 1, 1, HDF5_PREDICT_XOR};
+    hdf5_codec_policy_t delta_policy = {HDF5_CODEC_DEFLATE, 1, 1, HDF5_PREDICT_DELTA};
+    int status = hdf5_logger_set_group_codec(logger, "/xor", HDF5_DATA_NUMERIC, &xor_policy);
+    status |= hdf5_logger_set_group_codec(logger, "/delta", HDF5_DATA_NUMERIC, &delta_policy);
+    status |= hdf5_logger_set_group_codec(logger, "/delta", HDF5_DATA_IMAGE, &delta_policy);
+    assert(status == 0 && "Politique avec prédiction refusée");
+
+    write_group(logger, "/plain", s);
+    write_group(logger, "/xor", s);
+    write_group(logger, "/delta", s);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+    hsize_t plain[3];
+    hsize_t xor_stored[3];
+    hsize_t delta[3];
+    check_group(file_id, "/plain", s, plain);
+    check_group(file_id, "/xor", s, xor_stored);
+    check_group(file_id, "/delta", s, delta);
+
+    check_filter(file_id, "/plain", "sine", 0, 0);
+    check_filter(file_id, "/xor", "sine", HDF5_PREDICT_XOR, 4);
+    check_filter(file_id, "/xor", "telemetry", HDF5_PREDICT_XOR, 8);
+    check_filter(file_id, "/xor", "series", HDF5_PREDICT_XOR, 4);
+    check_filter(file_id, "/xor", "gradient", 0, 0);
+    check_filter(file_id, "/delta", "ramp", HDF5_PREDICT_DELTA, 4);
+    check_filter(file_id, "/delta", "short_2_7", HDF5_PREDICT_DELTA, 2);
+    check_filter(file_id, "/delta", "gradient", HDF5_PREDICT_DELTA, 1);
+
+    assert(xor_stored[0] < plain[0] && xor_stored[1] < plain[1] &&
+           "Le ou exclusif devrait mieux compresser un signal lent");
+    assert(delta[2] < plain[2] && "L'écart devrait mieux compresser une rampe");
+    H5Fclose(file_id);
+}
+
+int main() {
+    printf("Test du filtre de prédiction\n");
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    signals_t* s = malloc(sizeof(signals_t));
+    fill_signals(s);
+
+    // Pipeline HDF5, puis compression parallèle avec écriture directe des chunks
+    run("test_predict.h5", 1, s);
+    run("test_predict_parallel.h5", 3, s);
+
+    // Politiques invalides refusées
+    hdf5_logger_t* logger = hdf5_logger_init("test_predict.h5");
+    assert(logger != NULL && "La réouverture du logger a échoué");
+    hdf5_codec_policy_t text_policy = {HDF5_CODEC_DEFLATE, 1, 1, HDF5_PREDICT_DELTA};
+    assert(hdf5_logger_set_codec(logger, HDF5_DATA_TEXT, &text_policy) == -1 &&
+           "Une prédiction du texte devrait être refusée");
+    hdf5_codec_policy_t unknown = {HDF5_CODEC_DEFLATE, 1, 1, (hdf5_predictor_t)9};
+    assert(hdf5_logger_set_codec(logger, HDF5_DATA_NUMERIC, &unknown) == -1 &&
+           "Une prédiction inconnue devrait être refusée");
+
+    // Série prolongée dans une nouvelle session : le filtre relit le dernier chunk
+    float frame[FRAME];
+    for (int i = 0; i < FRAME; i++) {
+        frame[i] = s->frames[0][i];
+    }
+    size_t dims[1] = {FRAME};
+    assert(hdf5_log_array_append(logger, "/xor", "series", frame, 1, dims,
+                                 HDF5_DTYPE_FLOAT32) == 0 && "Prolongation d'une série a échoué");
+    assert(hdf5_logger_close(logger) == 0 && "La fermeture du logger a échoué");
+
+    hid_t file_id = H5Fopen("test_predict.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    float* frames = malloc((FRAMES + 1) * FRAME * sizeof(float));
+    read_dataset(file_id, "/xor", "series", H5T_NATIVE_FLOAT, frames);
+    assert(memcmp(frames, s->frames, sizeof(s->frames)) == 0 &&
+           memcmp(frames + FRAMES * FRAME, frame, sizeof(frame)) == 0 &&
+           "Série prolongée incorrecte");
+    free(frames);
+    H5Fclose(file_id);
+
+    free(s->ramp);
+    free(s->telemetry);
+    free(s->sine);
+    free(s);
+    printf("Tests du filtre de prédiction réussis!\n");
+    return 0;
+}
@@ -0,0 +1,372 @@
+/**
+ * @file test_pyramid.c
+ * @brief Test des vignettes écrites à côté des images
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+/* Largeurs impaires pour couvrir les boucles vectorielles, leur fin scalaire et les bords */
+#define WIDTH 301
+#define HEIGHT 203
+#define BIG_WIDTH 2000
+#define BIG_HEIGHT 1200
+
+/* Niveau suivant de référence, en entiers 64 bits ou en float (ordre des sommes du logger) */
+static void reduce_reference(const double* source, size_t width, size_t height,
+                             size_t channels, int integer, double* out) {
+    size_t out_width = (width + 1) / 2;
+    size_t out_height = (height + 1) / 2;
+    for (size_t y = 0; y < out_height; y++) {
+        size_t y1 = (2 * y + 1 < height) ? 2 * y + 1 : 2 * y;
+        for (size_t x = 0; x < out_width; x++) {
+            size_t x1 = (2 * x + 1 < width) ? 2 * x + 1 : 2 * x;
+            for (size_t k = 0; k < channels; k++) {
+                double a = source[((2 * y) * width + 2 * x) * channels + k];
+                double b = source[(y1 * width + 2 * x) * channels + k];
+                double c = source[((2 * y) * width + x1) * channels + k];
+                double d = source[(y1 * width + x1) * channels + k];
+                double value;
+                if (integer) {
+                    int64_t sum = (int64_t)a + (int64_t)b + (int64_t)c + (int64_t)d + 2;
+                    value = (double)((sum >= 0) ? sum / 4 : -((-sum + 3) / 4));
+                } else {
+                    value = (double)(((float)a + (float)b + (float)c + (float)d) / 4);
+                }
+                out[(y * out_width + x) * channels + k] = value;
+            }
+        }
+    }
+}
+
+static unsigned int read_uint_attribute(hid_t dataset_id, const char* name) {
+    unsigned int value = 0;
+    hid_t attr_id = H5Aopen(dataset_id, name, H5P_DEFAULT);
+    assert(attr_id >= 0 && "Attribut de vignette manquant");
+    H5Aread(attr_id, H5T_NATIVE_UINT, &value);
+    H5Aclose(attr_id);
+    return value;
+}
+
+/* Vérifie les niveaux d'une image d'après les pixels loggés (en doubles, entrelacés) */
+static void check_pyramid(hid_t file_id, const char* group, const char* name,
+                          const double* pixels, size_t width, size_t height, size_t channels,
+                          int integer, int planar, unsigned int expected_levels) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", group, name);
+    hid_t base_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(base_id >= 0 && "L'image devrait exister");
+    assert(read_uint_attribute(base_id, "pyramid_levels") == expected_levels &&
+           "Nombre de niveaux incorrect");
+    H5Dclose(base_id);
+
+    double* level = malloc(width * height * channels * sizeof(double));
+    double* next = malloc(width * height * channels * sizeof(double));
+    double* stored = malloc(width * height * channels * sizeof(double));
+    memcpy(level, pixels, width * height * channels * sizeof(double));
+
+    for (unsigned int k = 1; k <= expected_levels; k++) {
+        reduce_reference(level, width, height, channels, integer, next);
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        double* swap = level;
+        level = next;
+        next = swap;
+
+        snprintf(path, sizeof(path), "%s/%s_level%u", group, name, k);
+        hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+        assert(dataset_id >= 0 && "Le niveau devrait exister");
+        assert(read_uint_attribute(dataset_id, "pyramid_level") == k &&
+               "Numéro de niveau incorrect");
+
+        char source[128] = {0};
+        hid_t attr_id = H5Aopen(dataset_id, "pyramid_source", H5P_DEFAULT);
+        assert(attr_id >= 0 && "Source du niveau manquante");
+        hid_t string_type = H5Aget_type(attr_id);
+        assert(H5Tget_size(string_type) <= sizeof(source) && "Source trop longue");
+        H5Aread(attr_id, string_type, source);
+        H5Tclose(string_type);
+        H5Aclose(attr_id);
+        assert(strcmp(source, name) == 0 && "Source du niveau incorrecte");
+
+        /* Dimensions [canaux, hauteur, largeur] en plans, [hauteur, largeur, canaux] sinon */
+        hid_t space_id = H5Dget_space(dataset_id);
+        hsize_t dims[3] = {0, 0, 0};
+        int rank = H5Sget_simple_extent_dims(space_id, dims, NULL);
+        H5Sclose(space_id);
+        if (channels == 1) {
+            assert(rank == 2 && dims[0] == height && dims[1] == width &&
+                   "Dimensions du niveau incorrectes");
+        } else if (planar) {
+            assert(rank == 3 && dims[0] == channels && dims[1] == height &&
+                   dims[2] == width && "Dimensions du niveau en plans incorrectes");
+        } else {
+            assert(rank == 3 && dims[0] == height && dims[1] == width &&
+                   dims[2] == channels && "Dimensions du niveau incorrectes");
+        }
+
+        /* Un petit niveau tient dans un seul chunk */
+        hid_t plist_id = H5Dget_create_plist(dataset_id);
+        hsize_t chunk[3] = {0, 0, 0};
+        H5Pget_chunk(plist_id, 3, chunk);
+        H5Pclose(plist_id);
+        int spatial = (channels > 1 && planar) ? 1 : 0;
+        if (width * height * channels <= 1024 * 1024 / 8) {
+            assert(chunk[spatial] == height && chunk[spatial + 1] == width &&
+                   "Un petit niveau devrait former un seul chunk");
+        }
+
+        H5Dread(dataset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, stored);
+        H5Dclose(dataset_id);
+        for (size_t i = 0; i < width * height; i++) {
+            for (size_t c = 0; c < channels; c++) {
+                double value = (planar) ? stored[c * width * height + i]
+                                        : stored[i * channels + c];
+                assert(value == level[i * channels + c] && "Pixel de vignette incorrect");
+            }
+        }
+    }
+
+    snprintf(path, sizeof(path), "%s/%s_level%u", group, name, expected_levels + 1);
+    assert(H5Lexists(file_id, path, H5P_DEFAULT) <= 0 && "Un niveau de trop a été écrit");
+
+    free(level);
+    free(next);
+    free(stored);
+}
+
+static void to_doubles_u8(const unsigned char* pixels, size_t count, double* out) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = pixels[i];
+    }
+}
+
+int main() {
+    const char* filename = "test_pyramid.h5";
+    remove(filename);
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    size_t area = WIDTH * HEIGHT;
+    unsigned char* rgb = malloc(area * 3);
+    uint16_t* deep = malloc(area * sizeof(uint16_t));
+    float* depth = malloc(64 * 64 * sizeof(float));
+    int16_t* signed_pixels = malloc(33 * 17 * 2 * sizeof(int16_t));
+    unsigned char* big = malloc((size_t)BIG_WIDTH * BIG_HEIGHT * 3);
+    unsigned char* pitched = malloc((WIDTH * 3 + 13) * HEIGHT);
+    double* values = malloc((size_t)BIG_WIDTH * BIG_HEIGHT * 3 * sizeof(double));
+
+    unsigned int noise = 7;
+    for (size_t i = 0; i < area * 3; i++) {
+        noise = noise * 1103515245u + 12345u;
+        rgb[i] = (unsigned char)(noise >> 24);
+    }
+    for (size_t i = 0; i < area; i++) {
+        noise = noise * 1103515245u + 12345u;
+        deep[i] = (uint16_t)(65535 - (noise >> 28));  /* Près du maximum, pour la remise à plage */
+        if (i % 7 == 0) {
+            deep[i] = (uint16_t)(noise >> 16);
+        }
+    }
+    for (size_t i = 0; i < 64 * 64; i++) {
+        depth[i] = (float)i * 0.37f - 200.0f;
+    }
+    for (size_t i = 0; i < 33 * 17 * 2; i++) {
+        noise = noise * 1103515245u + 12345u;
+        signed_pixels[i] = (int16_t)((int)(noise >> 16) - 32768);
+    }
+    for (size_t i = 0; i < (size_t)BIG_WIDTH * BIG_HEIGHT * 3; i++) {
+        big[i] = (unsigned char)((i / 3) % BIG_WIDTH / 8 + (i % 3) * 40 + (i % 5));
+    }
+    for (size_t y = 0; y < HEIGHT; y++) {
+        memcpy(pitched + y * (WIDTH * 3 + 13), rgb + y * WIDTH * 3, WIDTH * 3);
+    }
+
+    hdf5_logger_t* logger = hdf5_logger_init(filename);
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+    assert(hdf5_logger_set_image_pyramid(logger, "/camera", 32) == 0 &&
+           "Choix des vignettes a échoué");
+    assert(hdf5_logger_set_image_pyramid(logger, "/deep", 40) == 0 &&
+           "Choix des vignettes a échoué");
+    assert(hdf5_logger_set_image_pyramid(logger, "/depth", 8) == 0 &&
+           "Choix des vignettes a échoué");
+    assert(hdf5_logger_set_image_pyramid(logger, "/planar", 32) == 0 &&
+           "Choix des vignettes a échoué");
+    assert(hdf5_logger_set_image_layout(logger, "/planar", HDF5_IMAGE_PLANAR) == 0 &&
+           "Choix de la disposition a échoué");
+    assert(hdf5_logger_set_image_pyramid(logger, "/big", 256) == 0 &&
+           "Choix des vignettes a échoué");
+    assert(hdf5_logger_set_image_pyramid(logger, "/plain", 32) == 0 &&
+           hdf5_logger_set_image_pyramid(logger, "/plain", 0) == 0 &&
+           "Retrait des vignettes a échoué");
+
+    int status = hdf5_log_image(logger, "/camera", "rgb", rgb, WIDTH, HEIGHT, 3);
+    assert(status == 0 && "Log d'une image a échoué");
+    status = hdf5_log_image(logger, "/camera", "shrunk", rgb, WIDTH, HEIGHT, 3);
+    assert(status == 0 && "Log d'une image a échoué");
+    status = hdf5_log_image_typed(logger, "/deep", "gray16", deep, WIDTH, HEIGHT, 1,
+                                  HDF5_DTYPE_UINT16);
+    assert(status == 0 && "Log d'une image 16 bits a échoué");
+    status = hdf5_log_image_typed(logger, "/depth", "depth", depth, 64, 64, 1,
+                                  HDF5_DTYPE_FLOAT32);
+    assert(status == 0 && "Log d'une image flottante a échoué");
+    status = hdf5_log_image_typed(logger, "/depth", "signed", signed_pixels, 33, 17, 2,
+                                  HDF5_DTYPE_INT16);
+    assert(status == 0 && "Log d'une image signée a échoué");
+    status = hdf5_log_image_pitched(logger, "/deep", "pitched", pitched, WIDTH, HEIGHT, 3,
+                                    HDF5_DTYPE_UINT8, WIDTH * 3 + 13);
+    assert(status == 0 && "Log d'une image avec pas de ligne a échoué");
+    status = hdf5_log_image(logger, "/planar", "rgb", rgb, WIDTH, HEIGHT, 3);
+    assert(status == 0 && "Log d'une image en plans a échoué");
+    status = hdf5_log_image(logger, "/plain", "rgb", rgb, WIDTH, HEIGHT, 3);
+    assert(status == 0 && "Log d'une image sans vignettes a échoué");
+
+    /* Grande image réduite sur plusieurs threads */
+    assert(hdf5_logger_set_compression_threads(logger, 3) == 0 &&
+           "Choix des threads de compression a échoué");
+    status = hdf5_log_image(logger, "/big", "frame", big, BIG_WIDTH, BIG_HEIGHT, 3);
+    assert(status == 0 && "Log d'une grande image a échoué");
+
+    /* Image plus petite sous le même nom : les niveaux en trop disparaissent */
+    status = hdf5_log_image(logger, "/camera", "shrunk", rgb, 60, 40, 3);
+    assert(status == 0 && "Réécriture d'une image a échoué");
+
+    /* Mise à jour partielle : les niveaux suivent l'image */
+    unsigned char* before = malloc(area * 3);
+    memcpy(before, rgb, area * 3);
+    for (size_t y = 10; y < 50; y++) {
+        for (size_t x = 20; x < 90; x++) {
+            rgb[(y * WIDTH + x) * 3] = 255;
+        }
+    }
+    hdf5_image_rect_t rect = {20, 10, 70, 40};
+    status = hdf5_log_image_update(logger, "/camera", "rgb", rgb, WIDTH, HEIGHT, 3,
+                                   HDF5_DTYPE_UINT8, &rect, 1);
+    assert(status == 0 && "Mise à jour d'une image a échoué");
+
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+
+    /* 301 -> 151 -> 76 -> 38 -> 19 */
+    to_doubles_u8(rgb, area * 3, values);
+    check_pyramid(file_id, "/camera", "rgb", values, WIDTH, HEIGHT, 3, 1, 0, 4);
+    to_doubles_u8(before, area * 3, values);
+    check_pyramid(file_id, "/planar", "rgb", values, WIDTH, HEIGHT, 3, 1, 1, 4);
+
+    /* 60 -> 30 : un seul niveau, les suivants supprimés */
+    double* small = malloc(60 * 40 * 3 * sizeof(double));
+    to_doubles_u8(before, 60 * 40 * 3, small);
+    check_pyramid(file_id, "/camera", "shrunk", small, 60, 40, 3, 1, 0, 1);
+    free(small);
+
+    /* 301 -> 151 -> 76 -> 38 ; 64 -> 32 -> 16 -> 8 ; 33 -> 17 -> 9 -> 5 */
+    for (size_t i = 0; i < area; i++) {
+        values[i] = deep[i];
+    }
+    check_pyramid(file_id, "/deep", "gray16", values, WIDTH, HEIGHT, 1, 1, 0, 3);
+    for (size_t i = 0; i < 64 * 64; i++) {
+        values[i] = depth[i];
+    }
+    check_pyramid(file_id, "/depth", "depth", values, 64, 64, 1, 0, 0, 3);
+    for (size_t i = 0; i < 33 * 17 * 2; i++) {
+        values[i] = signed_pixels[i];
+    }
+    check_pyramid(file_id, "/depth", "signed", values, 33, 17, 2, 1, 0, 3);
+
+    assert(H5Lexists(file_id, "/plain/rgb_level1", H5P_DEFAULT) <= 0 &&
+           "Un groupe sans vignettes ne devrait pas en avoir");
+
+    /* Image lue avec un pas de ligne : niveaux de l'image dense */
+    unsigned char* original = malloc(area * 3);
+    for (size_t y = 0; y < HEIGHT; y++) {
+        memcpy(original + y * WIDTH * 3, pitched + y * (WIDTH * 3 + 13), WIDTH * 3);
+    }
+    to_doubles_u8(original, area * 3, values);
+    check_pyramid(file_id, "/deep", "pitched", values, WIDTH, HEIGHT, 3, 1, 0, 3);
+    free(original);
+
+    /* 2000 -> 1000 -> 500 -> 250 ; le premier niveau (1,8 Mo) garde des chunks de 128 */
+    to_doubles_u8(big, (size_t)BIG_WIDTH * BIG_HEIGHT * 3, values);
+    check_pyramid(file_id, "/big", "frame", values, BIG_WIDTH, BIG_HEIGHT, 3, 1, 0, 3);
+    hid_t dataset_id = H5Dopen2(file_id, "/big/frame_level1", H5P_DEFAULT);
+    hid_t plist_id = H5Dget_create_plist(dataset_id);
+    hsize_t chunk[3];
+    H5Pget_chunk(plist_id, 3, chunk);
+    assert(chunk[0] == 128 && chunk[1] == 128 && "Un grand niveau devrait garder ses chunks");
+    H5Pclose(plist_id);
+    H5Dclose(dataset_id);
+    dataset_id = H5Dopen2(file_id, "/big/frame_level2", H5P_DEFAULT);
+    plist_id = H5Dget_create_plist(dataset_id);
+    H5Pget_chunk(plist_id, 3, chunk);
+    assert(chunk[0] == 300 && chunk[1] == 500 && "Un niveau de 450 Ko devrait tenir en un chunk");
+    H5Pclose(plist_id);
+    H5Dclose(dataset_id);
+    H5Fclose(file_id);
+
+    // Déduplication : chaque image garde des niveaux qui la désignent
+    remove("test_pyramid_dedup.h5");
+    logger = hdf5_logger_init("test_pyramid_dedup.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+    assert(hdf5_logger_set_dedup(logger, 1) == 0 && "Activation de la déduplication a échoué");
+    assert(hdf5_logger_set_image_pyramid(logger, "/cam", 32) == 0 &&
+           hdf5_logger_set_image_pyramid(logger, "/wide", 100) == 0 &&
+           "Choix des vignettes a échoué");
+    status = hdf5_log_image(logger, "/cam", "a", rgb, WIDTH, HEIGHT, 3);
+    status |= hdf5_log_image(logger, "/cam", "b", rgb, WIDTH, HEIGHT, 3);
+    status |= hdf5_log_image(logger, "/wide", "c", rgb, WIDTH, HEIGHT, 3);
+    status |= hdf5_log_image(logger, "/plain", "d", rgb, WIDTH, HEIGHT, 3);
+    assert(status == 0 && "Log d'images identiques a échoué");
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    file_id = H5Fopen("test_pyramid_dedup.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    to_doubles_u8(rgb, area * 3, values);
+    check_pyramid(file_id, "/cam", "a", values, WIDTH, HEIGHT, 3, 1, 0, 4);
+    check_pyramid(file_id, "/cam", "b", values, WIDTH, HEIGHT, 3, 1, 0, 4);
+    check_pyramid(file_id, "/wide", "c", values, WIDTH, HEIGHT, 3, 1, 0, 2);
+    H5O_info_t info;
+    H5Oget_info_by_name(file_id, "/cam/b", &info, H5P_DEFAULT);
+    assert(info.rc == 2 && "Deux images de même pyramide devraient partager leur dataset");
+    dataset_id = H5Dopen2(file_id, "/plain/d", H5P_DEFAULT);
+    assert(H5Aexists(dataset_id, "pyramid_levels") == 0 &&
+           "Une image sans vignettes ne devrait pas en annoncer");
+    H5Dclose(dataset_id);
+    H5Fclose(file_id);
+
+    // Mode asynchrone : les niveaux sont calculés par le thread d'écriture
+    remove("test_pyramid_async.h5");
+    logger = hdf5_logger_init_async("test_pyramid_async.h5", NULL);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    assert(hdf5_logger_set_image_pyramid(logger, "/camera", 64) == 0 &&
+           "Choix des vignettes a échoué");
+    status = hdf5_log_image(logger, "/camera", "rgb", rgb, WIDTH, HEIGHT, 3);
+    assert(status == 0 && "Log d'une image a échoué");
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+
+    file_id = H5Fopen("test_pyramid_async.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    to_doubles_u8(rgb, area * 3, values);
+    check_pyramid(file_id, "/camera", "rgb", values, WIDTH, HEIGHT, 3, 1, 0, 3);
+    H5Fclose(file_id);
+
+    assert(hdf5_logger_set_image_pyramid(NULL, "/camera", 32) == -1 &&
+           "Un logger absent devrait être refusé");
+
+    free(rgb);
+    free(before);
+    free(deep);
+    free(depth);
+    free(signed_pixels);
+    free(big);
+    free(pitched);
+    free(values);
+    printf("Tests des vignettes d'images réussis!\n");
+    return 0;
+}
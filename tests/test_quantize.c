@@ -0,0 +1,269 @@
+/**
+ * @file test_quantize.c
+ * @brief Test de la quantification des tableaux flottants : chiffres significatifs, erreur absolue
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <float.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define ROWS 300
+#define COLS 257
+#define DEPTH 7
+#define SPECIALS 12
+#define FRAMES 10
+#define FRAME 1001
+
+/* Bits de mantisse gardés pour 3 chiffres significatifs : ceil(3 x log2(10)) */
+#define KEPT_BITS 10
+
+typedef struct {
+    float matrix[ROWS][COLS];
+    double cube[DEPTH][ROWS][COLS];
+    float specials[SPECIALS];
+    int32_t counts[ROWS];
+    float frames[FRAMES][FRAME];
+} samples_t;
+
+static void fill_samples(samples_t* s) {
+    unsigned int noise = 99;
+    for (int i = 0; i < ROWS; i++) {
+        for (int j = 0; j < COLS; j++) {
+            noise = noise * 1103515245u + 12345u;
+            s->matrix[i][j] = 50.0f * sinf(i * 0.05f + j * 0.01f) + (float)(noise >> 16) * 1e-6f;
+            for (int d = 0; d < DEPTH; d++) {
+                s->cube[d][i][j] = 1000.0 * cos(d + i * 0.002 + j * 0.003) + (noise >> 20) * 1e-9;
+            }
+        }
+        s->counts[i] = i * 7919;
+    }
+    float specials[SPECIALS] = {NAN, INFINITY, -INFINITY, FLT_MAX, -FLT_MAX, FLT_MIN,
+                                1e-40f, -0.0f, 0.0f, 1.0f, 123456.789f, -3.14159265f};
+    memcpy(s->specials, specials, sizeof(specials));
+    for (int f = 0; f < FRAMES; f++) {
+        for (int i = 0; i < FRAME; i++) {
+            s->frames[f][i] = 10.0f * sinf((f * FRAME + i) * 0.003f);
+        }
+    }
+}
+
+static void write_all(hdf5_logger_t* logger, const samples_t* s) {
+    hdf5_quantize_t digits = {HDF5_QUANTIZE_DIGITS, 3};
+    hdf5_quantize_t absolute = {HDF5_QUANTIZE_ABSOLUTE, 1e-3};
+    hdf5_quantize_t exact = {HDF5_QUANTIZE_NONE, 0};
+    int status = hdf5_logger_set_quantize(logger, "/q", NULL, &digits);
+    status |= hdf5_logger_set_quantize(logger, "/q", "cube", &absolute);
+    status |= hdf5_logger_set_quantize(logger, "/q", "exact", &exact);
+    assert(status == 0 && "Réglage de la quantification a échoué");
+
+    status = hdf5_log_array_2d(logger, "/q", "matrix", s->matrix, ROWS, COLS, HDF5_DTYPE_FLOAT32);
+    status |= hdf5_log_array_2d(logger, "/raw", "matrix", s->matrix, ROWS, COLS,
+                                HDF5_DTYPE_FLOAT32);
+    status |= hdf5_log_array_3d(logger, "/q", "cube", s->cube, DEPTH, ROWS, COLS,
+                                HDF5_DTYPE_FLOAT64);
+    status |= hdf5_log_array_1d(logger, "/q", "specials", s->specials, SPECIALS,
+                                HDF5_DTYPE_FLOAT32);
+    status |= hdf5_log_array_1d(logger, "/q", "exact", s->specials, SPECIALS, HDF5_DTYPE_FLOAT32);
+    status |= hdf5_log_array_1d(logger, "/q", "counts", s->counts, ROWS, HDF5_DTYPE_INT32);
+    assert(status == 0 && "Log des tableaux a échoué");
+
+    // Colonne d'une matrice, lue au travers de sa sélection puis quantifiée
+    hdf5_source_layout_t column = {{ROWS, COLS}, {0, 5}, {1, 1}};
+    size_t column_dims[2] = {ROWS, 1};
+    status = hdf5_log_array_strided(logger, "/q", "column", s->matrix, 2, column_dims,
+                                    HDF5_DTYPE_FLOAT32, &column, NULL);
+    assert(status == 0 && "Log d'une colonne a échoué");
+
+    for (int f = 0; f < FRAMES; f++) {
+        size_t dims[1] = {FRAME};
+        status = hdf5_log_array_append(logger, "/q", "series", s->frames[f], 1, dims,
+                                       HDF5_DTYPE_FLOAT32);
+        assert(status == 0 && "Ajout d'une trame a échoué");
+    }
+}
+
+static void* read_dataset(hid_t file_id, const char* path, hid_t mem_type_id, size_t bytes) {
+    void* values = malloc(bytes);
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Dataset introuvable");
+    assert(H5Dread(dataset_id, mem_type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, values) >= 0 &&
+           "Lecture du dataset a échoué");
+    H5Dclose(dataset_id);
+    return values;
+}
+
+static hsize_t storage_size(hid_t file_id, const char* path) {
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    hsize_t size = H5Dget_storage_size(dataset_id);
+    H5Dclose(dataset_id);
+    return size;
+}
+
+/* Vérifie qu'un float garde au plus KEPT_BITS bits de mantisse, à moins d'une demi-unité près
+ * (un dénormalisé a moins de bits significatifs : seule la mise à zéro est vérifiée) */
+static void check_digits(float stored, float exact) {
+    uint32_t bits;
+    memcpy(&bits, &stored, sizeof(bits));
+    assert((bits & ((1u << (23 - KEPT_BITS)) - 1)) == 0 && "Bits de mantisse non mis à zéro");
+    assert((fpclassify(exact) == FP_SUBNORMAL || fabsf(stored - exact) <= ldexpf(fabsf(exact), -(KEPT_BITS + 1))) &&
+           "Écart relatif hors de la précision demandée");
+}
+
+static void check_all(const char* filename, const samples_t* s, int frames) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+
+    float* matrix = read_dataset(file_id, "/q/matrix", H5T_NATIVE_FLOAT, sizeof(s->matrix));
+    for (int i = 0; i < ROWS; i++) {
+        for (int j = 0; j < COLS; j++) {
+            check_digits(matrix[i * COLS + j], s->matrix[i][j]);
+        }
+    }
+    free(matrix);
+    assert(storage_size(file_id, "/q/matrix") < storage_size(file_id, "/raw/matrix") * 3 / 4 &&
+           "La quantification devrait réduire le stockage");
+
+    double* cube = read_dataset(file_id, "/q/cube", H5T_NATIVE_DOUBLE, sizeof(s->cube));
+    const double* expected = &s->cube[0][0][0];
+    for (size_t i = 0; i < (size_t)DEPTH * ROWS * COLS; i++) {
+        assert(fabs(cube[i] - expected[i]) <= 1e-3 && "Erreur absolue dépassée");
+    }
+    free(cube);
+
+    float* column = read_dataset(file_id, "/q/column", H5T_NATIVE_FLOAT, ROWS * sizeof(float));
+    for (int i = 0; i < ROWS; i++) {
+        check_digits(column[i], s->matrix[i][5]);
+    }
+    free(column);
+
+    // Valeurs non finies gardées, plus grand fini tronqué plutôt qu'arrondi à l'infini
+    float* specials = read_dataset(file_id, "/q/specials", H5T_NATIVE_FLOAT, sizeof(s->specials));
+    assert(isnan(specials[0]) && specials[1] == INFINITY && specials[2] == -INFINITY &&
+           "Valeurs non finies modifiées");
+    assert(isfinite(specials[3]) && isfinite(specials[4]) && specials[3] > 3.39e38f &&
+           "Le plus grand fini devrait rester fini");
+    for (int i = 5; i < SPECIALS; i++) {
+        check_digits(specials[i], s->specials[i]);
+    }
+    assert(signbit(specials[7]) && "Le zéro négatif devrait être gardé");
+    free(specials);
+
+    float* exact = read_dataset(file_id, "/q/exact", H5T_NATIVE_FLOAT, sizeof(s->specials));
+    assert(memcmp(exact + 1, s->specials + 1, sizeof(s->specials) - sizeof(float)) == 0 &&
+           "Un dataset exclu devrait rester exact");
+    free(exact);
+
+    int32_t* counts = read_dataset(file_id, "/q/counts", H5T_NATIVE_INT32, sizeof(s->counts));
+    assert(memcmp(counts, s->counts, sizeof(s->counts)) == 0 && "Entiers modifiés");
+    free(counts);
+
+    float* series = read_dataset(file_id, "/q/series", H5T_NATIVE_FLOAT,
+                                 (size_t)frames * FRAME * sizeof(float));
+    for (int f = 0; f < frames; f++) {
+        for (int i = 0; i < FRAME; i++) {
+            check_digits(series[f * FRAME + i], s->frames[f % FRAMES][i]);
+        }
+    }
+    free(series);
+
+    // Précision notée dans les attributs
+    hid_t dataset_id = H5Dopen2(file_id, "/q/matrix", H5P_DEFAULT);
+    int digits = 0;
+    hid_t attr_id = H5Aopen(dataset_id, "quantize_significant_digits", H5P_DEFAULT);
+    assert(attr_id >= 0 && H5Aread(attr_id, H5T_NATIVE_INT, &digits) >= 0 && digits == 3 &&
+           "Attribut des chiffres significatifs incorrect");
+    H5Aclose(attr_id);
+    H5Dclose(dataset_id);
+
+    dataset_id = H5Dopen2(file_id, "/q/cube", H5P_DEFAULT);
+    double error = 0.0;
+    attr_id = H5Aopen(dataset_id, "quantize_max_error", H5P_DEFAULT);
+    assert(attr_id >= 0 && H5Aread(attr_id, H5T_NATIVE_DOUBLE, &error) >= 0 && error == 1e-3 &&
+           "Attribut de l'erreur absolue incorrect");
+    H5Aclose(attr_id);
+    H5Dclose(dataset_id);
+
+    dataset_id = H5Dopen2(file_id, "/q/series", H5P_DEFAULT);
+    assert(H5Aexists(dataset_id, "quantize_significant_digits") > 0 &&
+           "Attribut de la série manquant");
+    H5Dclose(dataset_id);
+    dataset_id = H5Dopen2(file_id, "/q/counts", H5P_DEFAULT);
+    assert(H5Aexists(dataset_id, "quantize_significant_digits") == 0 &&
+           "Un tableau entier ne devrait pas être quantifié");
+    H5Dclose(dataset_id);
+
+    H5Fclose(file_id);
+}
+
+int main() {
+    printf("Test de la quantification des flottants\n");
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    samples_t* s = malloc(sizeof(samples_t));
+    fill_samples(s);
+
+    // Mode synchrone, avec compression parallèle des chunks
+    remove("test_quantize.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_quantize.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+    assert(hdf5_logger_set_compression_threads(logger, 3) == 0 &&
+           "Démarrage des threads de compression a échoué");
+    write_all(logger, s);
+
+    // Précisions invalides refusées
+    hdf5_quantize_t invalid[] = {
+        {HDF5_QUANTIZE_DIGITS, 0}, {HDF5_QUANTIZE_DIGITS, 2.5}, {HDF5_QUANTIZE_DIGITS, 18},
+        {HDF5_QUANTIZE_ABSOLUTE, 0}, {HDF5_QUANTIZE_ABSOLUTE, -1}, {HDF5_QUANTIZE_ABSOLUTE, NAN},
+        {(hdf5_quantize_mode_t)7, 1}};
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        assert(hdf5_logger_set_quantize(logger, "/q", "bad", &invalid[i]) == -1 &&
+               "Une précision invalide devrait être refusée");
+    }
+    assert(hdf5_logger_set_quantize(logger, NULL, NULL, NULL) == -1 &&
+           "Un groupe absent devrait être refusé");
+
+    int status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    check_all("test_quantize.h5", s, FRAMES);
+
+    // Série prolongée sans réglage : elle garde la précision notée à sa création
+    logger = hdf5_logger_init("test_quantize.h5");
+    assert(logger != NULL && "La réouverture du logger a échoué");
+    size_t dims[1] = {FRAME};
+    for (int f = 0; f < FRAMES; f++) {
+        status = hdf5_log_array_append(logger, "/q", "series", s->frames[f], 1, dims,
+                                       HDF5_DTYPE_FLOAT32);
+        assert(status == 0 && "Prolongation d'une série a échoué");
+    }
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    hid_t file_id = H5Fopen("test_quantize.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    float* series = read_dataset(file_id, "/q/series", H5T_NATIVE_FLOAT,
+                                 2 * FRAMES * FRAME * sizeof(float));
+    for (int i = 0; i < FRAME; i++) {
+        check_digits(series[FRAMES * FRAME + i], s->frames[0][i]);
+    }
+    free(series);
+    H5Fclose(file_id);
+
+    // Mode asynchrone : la quantification est faite par le thread d'écriture
+    remove("test_quantize_async.h5");
+    logger = hdf5_logger_init_async("test_quantize_async.h5", NULL);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    write_all(logger, s);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+    check_all("test_quantize_async.h5", s, FRAMES);
+
+    free(s);
+    printf("Tests de la quantification réussis!\n");
+    return 0;
+}
@@ -0,0 +1,226 @@
+/**
+ * @file test_strided.c
+ * @brief Test des tampons source non contigus : sous-blocs, canaux entrelacés, lignes avec marge
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define ROWS 100
+#define COLS 80
+#define RGB_WIDTH 61
+#define RGB_HEIGHT 40
+#define RGB_PITCH 200
+#define BIG_SIDE 700
+#define BIG_BLOCK 512
+#define TILE_WIDTH 1100
+#define TILE_HEIGHT 1000
+#define TILE_PITCH (TILE_WIDTH * 4 + 64)
+
+/* Lit un dataset entier dans un tampon alloué */
+static void* read_dataset(hid_t file_id, const char* path, hid_t mem_type_id, size_t bytes) {
+    void* values = malloc(bytes);
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Dataset introuvable");
+    assert(H5Dread(dataset_id, mem_type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, values) >= 0 &&
+           "Lecture du dataset a échoué");
+    H5Dclose(dataset_id);
+    return values;
+}
+
+typedef struct {
+    double matrix[ROWS][COLS];
+    unsigned char rgb[RGB_HEIGHT * RGB_PITCH];
+    uint16_t mono[RGB_HEIGHT][RGB_WIDTH + 3];
+    float* big;
+    unsigned char* tiles;
+} sources_t;
+
+static void fill_sources(sources_t* src) {
+    for (int i = 0; i < ROWS; i++) {
+        for (int j = 0; j < COLS; j++) {
+            src->matrix[i][j] = i * 1000.0 + j;
+        }
+    }
+    memset(src->rgb, 0xEE, sizeof(src->rgb));
+    for (int y = 0; y < RGB_HEIGHT; y++) {
+        for (int x = 0; x < RGB_WIDTH * 3; x++) {
+            src->rgb[y * RGB_PITCH + x] = (unsigned char)(y * 5 + x);
+        }
+    }
+    for (int y = 0; y < RGB_HEIGHT; y++) {
+        for (int x = 0; x < RGB_WIDTH + 3; x++) {
+            src->mono[y][x] = (x < RGB_WIDTH) ? (uint16_t)(y * 100 + x) : 0xFFFF;
+        }
+    }
+    src->big = malloc((size_t)BIG_SIDE * BIG_SIDE * sizeof(float));
+    for (size_t i = 0; i < (size_t)BIG_SIDE * BIG_SIDE; i++) {
+        src->big[i] = (float)(i % 9973);
+    }
+    src->tiles = malloc((size_t)TILE_PITCH * TILE_HEIGHT);
+    for (size_t i = 0; i < (size_t)TILE_PITCH * TILE_HEIGHT; i++) {
+        src->tiles[i] = (unsigned char)(i % 251);
+    }
+}
+
+static void write_all(hdf5_logger_t* logger, const sources_t* src) {
+    // Sous-bloc [10, 40) x [5, 25) d'une matrice
+    hdf5_source_layout_t block = {{ROWS, COLS}, {10, 5}, {1, 1}};
+    size_t block_dims[2] = {30, 20};
+    int status = hdf5_log_array_strided(logger, "/views", "block", src->matrix, 2, block_dims,
+                                        HDF5_DTYPE_FLOAT64, &block, NULL);
+    assert(status == 0 && "Log d'un sous-bloc a échoué");
+
+    // Canal vert d'une image RGB entrelacée, lignes avec marge
+    hdf5_source_layout_t green = {{RGB_HEIGHT, RGB_PITCH}, {0, 1}, {1, 3}};
+    size_t green_dims[2] = {RGB_HEIGHT, RGB_WIDTH};
+    status = hdf5_log_array_strided(logger, "/views", "green", src->rgb, 2, green_dims,
+                                    HDF5_DTYPE_UINT8, &green, NULL);
+    assert(status == 0 && "Log d'un canal entrelacé a échoué");
+
+    // Grand sous-bloc une colonne sur deux : plusieurs chunks compressés en parallèle
+    hdf5_source_layout_t sparse = {{BIG_SIDE, BIG_SIDE}, {3, 1}, {1, 1}};
+    size_t sparse_dims[2] = {BIG_BLOCK, BIG_BLOCK / 2};
+    sparse.stride[1] = 2;
+    status = hdf5_log_array_strided(logger, "/views", "sparse", src->big, 2, sparse_dims,
+                                    HDF5_DTYPE_FLOAT32, &sparse, NULL);
+    assert(status == 0 && "Log d'un grand sous-bloc a échoué");
+
+    // Images avec marge en fin de ligne
+    status = hdf5_log_image_pitched(logger, "/camera", "rgb", src->rgb, RGB_WIDTH, RGB_HEIGHT,
+                                    3, HDF5_DTYPE_UINT8, RGB_PITCH);
+    assert(status == 0 && "Log d'une image avec marge a échoué");
+    status = hdf5_log_image_pitched(logger, "/camera", "mono", src->mono, RGB_WIDTH,
+                                    RGB_HEIGHT, 1, HDF5_DTYPE_UINT16, sizeof(src->mono[0]));
+    assert(status == 0 && "Log d'une image 16 bits avec marge a échoué");
+    for (int frame = 0; frame < 2; frame++) {
+        status = hdf5_log_image_frame_pitched(logger, "/camera", "video", src->rgb, RGB_WIDTH,
+                                              RGB_HEIGHT, 3, HDF5_DTYPE_UINT8, RGB_PITCH);
+        assert(status == 0 && "Ajout d'une image avec marge a échoué");
+    }
+
+    // Grande image découpée en tuiles, compressées en parallèle
+    status = hdf5_log_image_frame_pitched(logger, "/camera", "large", src->tiles, TILE_WIDTH,
+                                          TILE_HEIGHT, 4, HDF5_DTYPE_UINT8, TILE_PITCH);
+    assert(status == 0 && "Ajout d'une grande image avec marge a échoué");
+}
+
+static void check_all(const char* filename, const sources_t* src) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+
+    double* block = read_dataset(file_id, "/views/block", H5T_NATIVE_DOUBLE,
+                                 30 * 20 * sizeof(double));
+    for (int i = 0; i < 30; i++) {
+        for (int j = 0; j < 20; j++) {
+            assert(block[i * 20 + j] == src->matrix[10 + i][5 + j] && "Sous-bloc incorrect");
+        }
+    }
+    free(block);
+
+    unsigned char* green = read_dataset(file_id, "/views/green", H5T_NATIVE_UCHAR,
+                                        RGB_HEIGHT * RGB_WIDTH);
+    for (int y = 0; y < RGB_HEIGHT; y++) {
+        for (int x = 0; x < RGB_WIDTH; x++) {
+            assert(green[y * RGB_WIDTH + x] == src->rgb[y * RGB_PITCH + x * 3 + 1] &&
+                   "Canal entrelacé incorrect");
+        }
+    }
+    free(green);
+
+    float* sparse = read_dataset(file_id, "/views/sparse", H5T_NATIVE_FLOAT,
+                                 (size_t)BIG_BLOCK * (BIG_BLOCK / 2) * sizeof(float));
+    for (int i = 0; i < BIG_BLOCK; i++) {
+        for (int j = 0; j < BIG_BLOCK / 2; j++) {
+            assert(sparse[i * (BIG_BLOCK / 2) + j] ==
+                   src->big[(size_t)(3 + i) * BIG_SIDE + 1 + 2 * j] && "Grand sous-bloc incorrect");
+        }
+    }
+    free(sparse);
+
+    unsigned char* rgb = read_dataset(file_id, "/camera/rgb", H5T_NATIVE_UCHAR,
+                                      RGB_HEIGHT * RGB_WIDTH * 3);
+    unsigned char* video = read_dataset(file_id, "/camera/video", H5T_NATIVE_UCHAR,
+                                        2 * RGB_HEIGHT * RGB_WIDTH * 3);
+    for (int y = 0; y < RGB_HEIGHT; y++) {
+        const unsigned char* row = src->rgb + y * RGB_PITCH;
+        assert(memcmp(rgb + y * RGB_WIDTH * 3, row, RGB_WIDTH * 3) == 0 &&
+               "Image avec marge incorrecte");
+        assert(memcmp(video + (RGB_HEIGHT + y) * RGB_WIDTH * 3, row, RGB_WIDTH * 3) == 0 &&
+               "Image de séquence avec marge incorrecte");
+    }
+    free(video);
+    free(rgb);
+
+    uint16_t* mono = read_dataset(file_id, "/camera/mono", H5T_NATIVE_UINT16,
+                                  RGB_HEIGHT * RGB_WIDTH * sizeof(uint16_t));
+    for (int y = 0; y < RGB_HEIGHT; y++) {
+        assert(memcmp(mono + y * RGB_WIDTH, src->mono[y], RGB_WIDTH * sizeof(uint16_t)) == 0 &&
+               "Image 16 bits avec marge incorrecte");
+    }
+    free(mono);
+
+    unsigned char* large = read_dataset(file_id, "/camera/large", H5T_NATIVE_UCHAR,
+                                        (size_t)TILE_HEIGHT * TILE_WIDTH * 4);
+    for (int y = 0; y < TILE_HEIGHT; y++) {
+        assert(memcmp(large + (size_t)y * TILE_WIDTH * 4, src->tiles + (size_t)y * TILE_PITCH,
+                      TILE_WIDTH * 4) == 0 && "Grande image avec marge incorrecte");
+    }
+    free(large);
+
+    H5Fclose(file_id);
+}
+
+int main() {
+    printf("Test des tampons source non contigus\n");
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    sources_t* src = malloc(sizeof(sources_t));
+    fill_sources(src);
+
+    // Mode synchrone, avec compression parallèle des chunks
+    remove("test_strided.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_strided.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+    assert(hdf5_logger_set_compression_threads(logger, 3) == 0 &&
+           "Démarrage des threads de compression a échoué");
+    write_all(logger, src);
+
+    // Sélections invalides refusées
+    hdf5_source_layout_t outside = {{ROWS, COLS}, {90, 0}, {1, 1}};
+    size_t dims[2] = {20, 10};
+    assert(hdf5_log_array_strided(logger, "/views", "bad", src->matrix, 2, dims,
+                                  HDF5_DTYPE_FLOAT64, &outside, NULL) == -1 &&
+           "Une sélection hors du tampon devrait être refusée");
+    assert(hdf5_log_image_pitched(logger, "/camera", "bad", src->rgb, RGB_WIDTH, RGB_HEIGHT, 3,
+                                  HDF5_DTYPE_UINT8, RGB_WIDTH * 3 - 1) == -1 &&
+           "Un pas plus court qu'une ligne devrait être refusé");
+    assert(hdf5_log_image_pitched(logger, "/camera", "bad", src->mono, RGB_WIDTH, RGB_HEIGHT, 1,
+                                  HDF5_DTYPE_UINT16, 2 * RGB_WIDTH + 1) == -1 &&
+           "Un pas qui coupe un canal devrait être refusé");
+
+    int status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    check_all("test_strided.h5", src);
+
+    // Mode asynchrone : seuls les éléments sélectionnés sont recopiés dans la file
+    remove("test_strided_async.h5");
+    logger = hdf5_logger_init_async("test_strided_async.h5", NULL);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    write_all(logger, src);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+    check_all("test_strided_async.h5", src);
+
+    free(src->tiles);
+    free(src->big);
+    free(src);
+    printf("Tests des tampons non contigus réussis!\n");
+    return 0;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file test_submit.c
+ * @brief Test des dépôts sans copie : tampons empruntés et rendus par rappel
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define WIDTH 320
+#define HEIGHT 240
+#define CHANNELS 3
+#define BUFFERS 4
+#define FRAMES 64
+
+/* Tampons de l'appelant et leur état, modifié par le rappel */
+typedef struct {
+    unsigned char pixels[BUFFERS][HEIGHT * WIDTH * CHANNELS];
+    volatile int busy[BUFFERS];
+    volatile int returned;
+    volatile int failed;
+} buffer_pool_t;
+
+typedef struct {
+    buffer_pool_t* pool;
+    int index;
+} buffer_ref_t;
+
+static void on_written(void* user_data, int status) {
+    buffer_ref_t* ref = (buffer_ref_t*)user_data;
+    assert(ref->pool->busy[ref->index] && "Tampon rendu deux fois");
+    ref->pool->busy[ref->index] = 0;
+    ref->pool->returned++;
+    if (status < 0) {
+        ref->pool->failed++;
+    }
+}
+
+/* Rappel sans suivi de tampon : le même tableau, jamais modifié, est déposé plusieurs fois */
+static void on_counted(void* user_data, int status) {
+    buffer_pool_t* pool = (buffer_pool_t*)user_data;
+    pool->returned++;
+    if (status < 0) {
+        pool->failed++;
+    }
+}
+
+/* Rappel qui rappelle le logger depuis le thread d'écriture : dépôt, relecture et vidage */
+typedef struct {
+    hdf5_logger_t* logger;
+    volatile int returned;
+    volatile int failed;
+} reentrant_t;
+
+static int count_entry(const hdf5_text_entry_t* entry, void* user_data) {
+    (void)entry;
+    (*(int*)user_data)++;
+    return 0;
+}
+
+static void on_reentrant(void* user_data, int status) {
+    reentrant_t* state = (reentrant_t*)user_data;
+    int entries = 0;
+    if (status < 0 ||
+        hdf5_log_text_to_group(state->logger, "/callbacks", HDF5_LOG_INFO, "Tampon rendu") != 0 ||
+        hdf5_logger_read_text(state->logger, "/callbacks", count_entry, &entries) != 0 ||
+        hdf5_logger_flush(state->logger) != 0) {
+        state->failed++;
+    }
+    state->returned++;
+}
+
+static void fill_frame(unsigned char* pixels, int index) {
+    for (size_t i = 0; i < HEIGHT * WIDTH * CHANNELS; i++) {
+        pixels[i] = (unsigned char)((i / 5 + (size_t)index * 11) & 0xFF);
+    }
+}
+
+/* Dépose FRAMES images d'une séquence en réutilisant BUFFERS tampons */
+static void submit_frames(hdf5_logger_t* logger, buffer_pool_t* pool, buffer_ref_t* refs) {
+    for (int i = 0; i < FRAMES; i++) {
+        int index = i % BUFFERS;
+        while (pool->busy[index]) {
+            hdf5_logger_flush(logger);
+        }
+        fill_frame(pool->pixels[index], i);
+        pool->busy[index] = 1;
+        int status = hdf5_log_image_frame_submit(logger, "/camera", "video", pool->pixels[index],
+                                                 WIDTH, HEIGHT, CHANNELS, HDF5_DTYPE_UINT8,
+                                                 on_written, &refs[index]);
+        assert(status == 0 && "Dépôt sans copie a échoué");
+    }
+}
+
+static void check_video(const char* filename) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file_id >= 0 && "Ouverture du fichier a échoué");
+    hid_t dataset_id = H5Dopen2(file_id, "/camera/video", H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Ouverture de la séquence a échoué");
+
+    size_t frame_bytes = HEIGHT * WIDTH * CHANNELS;
+    unsigned char* values = malloc(FRAMES * frame_bytes);
+    herr_t status = H5Dread(dataset_id, H5T_NATIVE_UCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, values);
+    assert(status >= 0 && "Relecture des images a échoué");
+    unsigned char* expected = malloc(frame_bytes);
+    for (int i = 0; i < FRAMES; i++) {
+        fill_frame(expected, i);
+        assert(memcmp(values + (size_t)i * frame_bytes, expected, frame_bytes) == 0 &&
+               "Image écrite différente du tampon déposé");
+    }
+    free(expected);
+    free(values);
+    H5Dclose(dataset_id);
+    H5Fclose(file_id);
+}
+
+int main() {
+    printf("Test des dépôts sans copie\n");
+
+    buffer_pool_t* pool = calloc(1, sizeof(buffer_pool_t));
+    buffer_ref_t refs[BUFFERS];
+    for (int i = 0; i < BUFFERS; i++) {
+        refs[i].pool = pool;
+        refs[i].index = i;
+    }
+
+    // Mode synchrone : le tampon est rendu avant le retour de l'appel
+    remove("test_submit.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_submit.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+
+    double values[64];
+    for (int i = 0; i < 64; i++) {
+        values[i] = i * 0.5;
+    }
+    size_t dims[2] = {8, 8};
+    pool->busy[0] = 1;
+    int status = hdf5_log_array_submit(logger, "/arrays", "matrix", values, 2, dims, 1,
+                                       on_written, &refs[0]);
+    assert(status == 0 && pool->returned == 1 && !pool->busy[0] && pool->failed == 0 &&
+           "Le tampon devrait être rendu pendant l'appel");
+
+    // Arguments invalides : -1 et aucun rappel
+    assert(hdf5_log_array_submit(logger, "/arrays", "matrix", values, 2, dims, 1, NULL, NULL) == -1 &&
+           "Un dépôt sans rappel devrait être refusé");
+    assert(hdf5_log_image_submit(logger, "/images", "still", pool->pixels[0], 0, HEIGHT,
+                                 CHANNELS, HDF5_DTYPE_UINT8, on_written, &refs[0]) == -1 &&
+           "Une image vide devrait être refusée");
+    assert(pool->returned == 1 && "Aucun rappel attendu pour un dépôt refusé");
+
+    pool->busy[1] = 1;
+    fill_frame(pool->pixels[1], 0);
+    status = hdf5_log_image_submit(logger, "/images", "still", pool->pixels[1], WIDTH, HEIGHT,
+                                   CHANNELS, HDF5_DTYPE_UINT8, on_written, &refs[1]);
+    assert(status == 0 && pool->returned == 2 && "Image synchrone non rendue");
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    // Mode asynchrone : le thread d'écriture lit les tampons de l'appelant
+    pool->returned = 0;
+    remove("test_submit_async.h5");
+    logger = hdf5_logger_init_async("test_submit_async.h5", NULL);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    submit_frames(logger, pool, refs);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+    assert(pool->returned == FRAMES && pool->failed == 0 && "Chaque tampon devrait être rendu");
+    check_video("test_submit_async.h5");
+
+    // File pleine avec abandon : un tampon abandonné est rendu avec un échec
+    pool->returned = 0;
+    remove("test_submit_drop.h5");
+    hdf5_async_config_t config = {2, HDF5_ASYNC_DROP_OLDEST, HDF5_LOG_DEBUG};
+    logger = hdf5_logger_init_async("test_submit_drop.h5", &config);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    for (int i = 0; i < 200; i++) {
+        status = hdf5_log_array_submit(logger, "/arrays", "matrix", values, 2, dims, 1,
+                                       on_counted, pool);
+        assert(status == 0 && "Dépôt sans copie a échoué");
+    }
+    hdf5_async_stats_t stats;
+    hdf5_logger_get_async_stats(logger, &stats);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+    assert(pool->returned == 200 && (unsigned long long)pool->failed == stats.dropped_oldest &&
+           "Chaque dépôt, écrit ou abandonné, devrait être rendu une fois");
+
+    // Un rappel peut appeler le logger sans interblocage
+    remove("test_submit_reentrant.h5");
+    reentrant_t state = {NULL, 0, 0};
+    state.logger = hdf5_logger_init_async("test_submit_reentrant.h5", NULL);
+    assert(state.logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    status = hdf5_log_text_to_group(state.logger, "/callbacks", HDF5_LOG_INFO, "Début");
+    assert(status == 0 && "Log asynchrone a échoué");
+    for (int i = 0; i < 16; i++) {
+        status = hdf5_log_array_submit(state.logger, "/arrays", "matrix", values, 2, dims,
+                                       HDF5_DTYPE_FLOAT64, on_reentrant, &state);
+        assert(status == 0 && "Dépôt sans copie a échoué");
+    }
+    status = hdf5_logger_flush(state.logger);
+    assert(status == 0 && state.returned == 16 && state.failed == 0 &&
+           "Les rappels devraient pouvoir loguer, relire et vider");
+    status = hdf5_logger_close(state.logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+
+    int entries = 0;
+    status = hdf5_logger_read_text_file("test_submit_reentrant.h5", "/callbacks", count_entry,
+                                        &entries);
+    assert(status == 0 && entries == 17 && "Les logs des rappels devraient être écrits");
+
+    free(pool);
+    printf("Tests des dépôts sans copie réussis!\n");
+    return 0;
+}
@@ -7,8 +7,65 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include "hdf5.h"
 #include "../include/hdf5_logger.h"
 
+/* Statistiques de relecture d'un groupe */
+typedef struct {
+    size_t count;        /* Nombre d'entrées lues */
+    size_t max_length;   /* Longueur du plus long message */
+} read_stats_t;
+
+static int count_callback(const hdf5_text_entry_t* entry, void* user_data) {
+    read_stats_t* stats = (read_stats_t*)user_data;
+    size_t length = strlen(entry->message);
+    stats->count++;
+    if (length > stats->max_length) {
+        stats->max_length = length;
+    }
+    return 0;
+}
+
+/* Crée un groupe dans l'ancienne disposition (log_entries à message de 1024 octets) */
+static void create_legacy_group(const char* filename) {
+    typedef struct {
+        int log_level;
+        double timestamp;
+        char message[1024];
+    } legacy_entry_t;
+    
+    hid_t file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    hid_t group_id = H5Gcreate2(file_id, "/legacy", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    
+    hid_t datatype_id = H5Tcreate(H5T_COMPOUND, sizeof(legacy_entry_t));
+    H5Tinsert(datatype_id, "log_level", HOFFSET(legacy_entry_t, log_level), H5T_NATIVE_INT);
+    H5Tinsert(datatype_id, "timestamp", HOFFSET(legacy_entry_t, timestamp), H5T_NATIVE_DOUBLE);
+    hid_t string_type = H5Tcopy(H5T_C_S1);
+    H5Tset_size(string_type, 1024);
+    H5Tinsert(datatype_id, "message", HOFFSET(legacy_entry_t, message), string_type);
+    
+    legacy_entry_t entries[3];
+    memset(entries, 0, sizeof(entries));
+    for (int i = 0; i < 3; i++) {
+        entries[i].log_level = HDF5_LOG_INFO;
+        entries[i].timestamp = 1000.0 + i;
+        snprintf(entries[i].message, sizeof(entries[i].message), "Ancien message %d", i);
+    }
+    
+    hsize_t dims[1] = {3};
+    hid_t dataspace_id = H5Screate_simple(1, dims, NULL);
+    hid_t dataset_id = H5Dcreate2(group_id, "log_entries", datatype_id, dataspace_id,
+                                  H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Dwrite(dataset_id, datatype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, entries);
+    
+    H5Dclose(dataset_id);
+    H5Sclose(dataspace_id);
+    H5Tclose(string_type);
+    H5Tclose(datatype_id);
+    H5Gclose(group_id);
+    H5Fclose(file_id);
+}
+
 int main() {
     printf("Test des logs texte\n");
     
@@ -51,10 +108,84 @@ int main() {
     status = hdf5_log_text(logger, HDF5_LOG_INFO, long_message);
     assert(status == 0 && "Log avec message long a échoué");
     
+    // Test des canaux : un même chemin renvoie le même canal
+    hdf5_log_channel_t* channel = hdf5_logger_open_channel(logger, "/custom_logs/channel");
+    assert(channel != NULL && "Ouverture du canal a échoué");
+    assert(hdf5_logger_open_channel(logger, "/custom_logs/channel") == channel &&
+           "Le canal devrait être réutilisé");
+
+    for (int i = 0; i < 100; i++) {
+        status = hdf5_log_channel_text(channel, HDF5_LOG_INFO, "Message via canal");
+        assert(status == 0 && "Log via canal a échoué");
+    }
+
+    // Les appels par chemin passent par le même canal
+    status = hdf5_log_text_to_group(logger, "/custom_logs/channel", HDF5_LOG_INFO, "Par chemin");
+    assert(status == 0 && "Log par chemin sur un canal ouvert a échoué");
+
+    assert(hdf5_log_channel_text(NULL, HDF5_LOG_INFO, "x") != 0 && "Un canal NULL devrait échouer");
+
     // Fermeture
     status = hdf5_logger_close(logger);
     assert(status == 0 && "La fermeture du logger a échoué");
     
+    // Test de l'écriture par lots sur un fichier neuf
+    remove("test_text_batch.h5");
+    logger = hdf5_logger_init("test_text_batch.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+    
+    status = hdf5_logger_set_batch_policy(logger, 100, 0, 0.0);
+    assert(status == 0 && "Définition de la politique de lots a échoué");
+    assert(hdf5_logger_set_batch_policy(logger, 0, 0, 0.0) != 0 &&
+           "Une politique sans entrées devrait échouer");
+    
+    hdf5_text_entry_t entries[1000];
+    for (int i = 0; i < 1000; i++) {
+        entries[i].level = HDF5_LOG_INFO;
+        entries[i].timestamp = 0.0;
+        entries[i].message = "Message du lot";
+    }
+    status = hdf5_log_text_batch(logger, "/batch", entries, 1000);
+    assert(status == 0 && "Log par lot a échoué");
+    
+    for (int i = 0; i < 10; i++) {
+        status = hdf5_log_text_to_group(logger, "/batch", HDF5_LOG_INFO, "Message seul");
+        assert(status == 0 && "Log seul après un lot a échoué");
+    }
+    
+    status = hdf5_logger_flush(logger);
+    assert(status == 0 && "Vidage du logger a échoué");
+    
+    read_stats_t stats = {0, 0};
+    status = hdf5_logger_read_text(logger, "/batch", count_callback, &stats);
+    assert(status == 0 && stats.count == 1010 && "Le nombre d'entrées écrites est incorrect");
+    
+    // Les messages longs ne sont plus tronqués
+    status = hdf5_log_text_to_group(logger, "/long", HDF5_LOG_INFO, long_message);
+    assert(status == 0 && "Log avec message long a échoué");
+    memset(&stats, 0, sizeof(stats));
+    status = hdf5_logger_read_text(logger, "/long", count_callback, &stats);
+    assert(status == 0 && stats.max_length == strlen(long_message) &&
+           "Le message long devrait être conservé en entier");
+    
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    
+    // Un groupe de l'ancienne disposition reste lisible et accepte de nouvelles entrées
+    create_legacy_group("test_text_legacy.h5");
+    logger = hdf5_logger_init("test_text_legacy.h5");
+    assert(logger != NULL && "L'ouverture d'un fichier existant a échoué");
+    
+    status = hdf5_log_text_to_group(logger, "/legacy", HDF5_LOG_INFO, "Nouveau message");
+    assert(status == 0 && "Log dans un groupe ancien a échoué");
+    
+    memset(&stats, 0, sizeof(stats));
+    status = hdf5_logger_read_text(logger, "/legacy", count_callback, &stats);
+    assert(status == 0 && stats.count == 4 && "Les anciennes entrées devraient être lues");
+    
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    
     printf("Tests de logs texte réussis!\n");
     return 0;
 }
\ No newline at end of file
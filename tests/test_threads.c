@@ -0,0 +1,193 @@
+/**
+ * @file test_threads.c
+ * @brief Test des appels concurrents : plusieurs threads partagent un même logger
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define THREAD_COUNT 8
+#define ENTRIES_PER_THREAD 2000
+#define SHORT_THREADS 8
+#define SHORT_BATCH 16
+#define SHORT_ENTRIES (SHORT_BATCH - 1)
+
+typedef struct {
+    hdf5_logger_t* logger;
+    hdf5_log_channel_t* channel;
+    int index;
+    int status;
+} worker_t;
+
+/* Entrées relues : numéro de séquence indexé par thread et par rang d'entrée */
+static unsigned long long sequences[THREAD_COUNT][ENTRIES_PER_THREAD];
+static size_t read_count;
+
+static void* worker_main(void* arg) {
+    worker_t* worker = (worker_t*)arg;
+    char message[64];
+
+    for (int i = 0; i < ENTRIES_PER_THREAD; i++) {
+        snprintf(message, sizeof(message), "%d %d", worker->index, i);
+        /* Une entrée sur deux passe par le canal, l'autre par le chemin du groupe */
+        int status = (i % 2 == 0)
+            ? hdf5_log_text_to_group(worker->logger, "/threads/shared", HDF5_LOG_INFO, message)
+            : hdf5_log_channel_text(worker->channel, HDF5_LOG_INFO, message);
+        if (status != 0) {
+            worker->status = -1;
+        }
+    }
+    return NULL;
+}
+
+/* Les threads courts attendent d'avoir tous logué : chacun garde ainsi son propre tampon */
+static pthread_mutex_t gate_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gate_cond = PTHREAD_COND_INITIALIZER;
+static int gate_count;
+
+/* Thread de courte durée : moins d'entrées que le seuil, puis sortie sans vidage */
+static void* short_worker_main(void* arg) {
+    worker_t* worker = (worker_t*)arg;
+    for (int i = 0; i < SHORT_ENTRIES; i++) {
+        if (hdf5_log_text_to_group(worker->logger, "/threads/exits", HDF5_LOG_INFO,
+                                   "Entrée d'un thread court") != 0) {
+            worker->status = -1;
+        }
+    }
+
+    pthread_mutex_lock(&gate_mutex);
+    gate_count++;
+    pthread_cond_broadcast(&gate_cond);
+    while (gate_count < SHORT_THREADS) {
+        pthread_cond_wait(&gate_cond, &gate_mutex);
+    }
+    pthread_mutex_unlock(&gate_mutex);
+    return NULL;
+}
+
+static int collect_callback(const hdf5_text_entry_t* entry, void* user_data) {
+    (void)user_data;
+    int thread = -1;
+    int index = -1;
+    if (sscanf(entry->message, "%d %d", &thread, &index) != 2 ||
+        thread < 0 || thread >= THREAD_COUNT || index < 0 || index >= ENTRIES_PER_THREAD) {
+        return -1;
+    }
+    sequences[thread][index] = entry->sequence;
+    read_count++;
+    return 0;
+}
+
+static int compare_sequences(const void* a, const void* b) {
+    unsigned long long sa = *(const unsigned long long*)a;
+    unsigned long long sb = *(const unsigned long long*)b;
+    return (sa > sb) - (sa < sb);
+}
+
+int main() {
+    printf("Test des appels concurrents\n");
+
+    remove("test_threads.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_threads.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+
+    // Des seuils bas pour que les fusions se produisent pendant que les threads écrivent
+    int status = hdf5_logger_set_batch_policy(logger, 64, 0, 0.0);
+    assert(status == 0 && "Le réglage de la politique a échoué");
+
+    hdf5_log_channel_t* channel = hdf5_logger_open_channel(logger, "/threads/shared");
+    assert(channel != NULL && "Ouverture du canal a échoué");
+
+    pthread_t threads[THREAD_COUNT];
+    worker_t workers[THREAD_COUNT];
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        workers[t].logger = logger;
+        workers[t].channel = channel;
+        workers[t].index = t;
+        workers[t].status = 0;
+        assert(pthread_create(&threads[t], NULL, worker_main, &workers[t]) == 0 &&
+               "Création d'un thread a échoué");
+    }
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        pthread_join(threads[t], NULL);
+        assert(workers[t].status == 0 && "Un log concurrent a échoué");
+    }
+
+    // Toutes les entrées sont relues, chacune avec un numéro de séquence
+    status = hdf5_logger_read_text(logger, "/threads/shared", collect_callback, NULL);
+    assert(status == 0 && "La relecture a échoué");
+    assert(read_count == THREAD_COUNT * ENTRIES_PER_THREAD && "Nombre d'entrées relues incorrect");
+
+    // Dans un thread, les numéros suivent l'ordre des appels
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        for (int i = 1; i < ENTRIES_PER_THREAD; i++) {
+            assert(sequences[t][i] > sequences[t][i - 1] &&
+                   "Les numéros de séquence d'un thread devraient croître");
+        }
+    }
+
+    // Les numéros sont uniques et consécutifs : 1 à THREAD_COUNT * ENTRIES_PER_THREAD
+    unsigned long long* sorted = malloc(sizeof(sequences));
+    memcpy(sorted, sequences, sizeof(sequences));
+    qsort(sorted, THREAD_COUNT * ENTRIES_PER_THREAD, sizeof(unsigned long long), compare_sequences);
+    for (size_t i = 0; i < THREAD_COUNT * ENTRIES_PER_THREAD; i++) {
+        assert(sorted[i] == i + 1 && "Les numéros de séquence devraient être uniques et consécutifs");
+    }
+    free(sorted);
+
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    // Les numéros continuent après réouverture
+    logger = hdf5_logger_init("test_threads.h5");
+    assert(logger != NULL && "La réouverture du logger a échoué");
+    status = hdf5_log_text_to_group(logger, "/threads/shared", HDF5_LOG_INFO, "0 0");
+    assert(status == 0 && "Log après réouverture a échoué");
+
+    read_count = 0;
+    status = hdf5_logger_read_text(logger, "/threads/shared", collect_callback, NULL);
+    assert(status == 0 && read_count == THREAD_COUNT * ENTRIES_PER_THREAD + 1 &&
+           "La relecture après réouverture a échoué");
+    assert(sequences[0][0] == THREAD_COUNT * ENTRIES_PER_THREAD + 1 &&
+           "Le numéro de séquence devrait continuer celui de la session précédente");
+
+    // Des threads se terminent avec leurs entrées sous le seuil : chacun fusionne son tampon
+    // en sortant, et le canal est écrit par lots de SHORT_BATCH sans autre appel
+    status = hdf5_logger_set_batch_policy(logger, SHORT_BATCH, 0, 0.0);
+    assert(status == 0 && "Le réglage de la politique a échoué");
+    for (int t = 0; t < SHORT_THREADS; t++) {
+        workers[t].logger = logger;
+        workers[t].channel = NULL;
+        workers[t].index = t;
+        workers[t].status = 0;
+        assert(pthread_create(&threads[t], NULL, short_worker_main, &workers[t]) == 0 &&
+               "Création d'un thread a échoué");
+    }
+    for (int t = 0; t < SHORT_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+        assert(workers[t].status == 0 && "Un log depuis un thread court a échoué");
+    }
+
+    hid_t file_id = H5Fopen("test_threads.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t records_id = H5Dopen2(file_id, "/threads/exits/records", H5P_DEFAULT);
+    hid_t attribute_id = H5Aopen(records_id, "entry_count", H5P_DEFAULT);
+    hsize_t written = 0;
+    assert(attribute_id >= 0 && H5Aread(attribute_id, H5T_NATIVE_HSIZE, &written) >= 0 &&
+           "Lecture du nombre d'entrées écrites a échoué");
+    assert(written == SHORT_THREADS * SHORT_ENTRIES / SHORT_BATCH * SHORT_BATCH &&
+           "Les tampons des threads terminés devraient avoir été fusionnés");
+    H5Aclose(attribute_id);
+    H5Dclose(records_id);
+    H5Fclose(file_id);
+
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    printf("Tests des appels concurrents réussis!\n");
+    return 0;
+}
@@ -0,0 +1,243 @@
+/**
+ * @file test_tile.c
+ * @brief Test de la mise à jour des tuiles modifiées d'une image
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+#define WIDTH 1000
+#define HEIGHT 700
+#define CHANNELS 3
+#define TILE 128
+#define TILES_X ((WIDTH + TILE - 1) / TILE)
+#define TILES_Y ((HEIGHT + TILE - 1) / TILE)
+#define IMAGE_BYTES ((size_t)WIDTH * HEIGHT * CHANNELS)
+
+/* Adresse de chaque chunk de l'image dans le fichier */
+static void chunk_addresses(const char* filename, const char* path, haddr_t* addresses) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Dataset introuvable");
+    for (int ty = 0; ty < TILES_Y; ty++) {
+        for (int tx = 0; tx < TILES_X; tx++) {
+            hsize_t offset[3] = {(hsize_t)ty * TILE, (hsize_t)tx * TILE, 0};
+            unsigned filter_mask;
+            hsize_t size;
+            assert(H5Dget_chunk_info_by_coord(dataset_id, offset, &filter_mask,
+                                              &addresses[ty * TILES_X + tx], &size) >= 0 &&
+                   "Chunk introuvable");
+        }
+    }
+    H5Dclose(dataset_id);
+    H5Fclose(file_id);
+}
+
+static void check_image(const char* filename, const char* path, const unsigned char* expected) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t dataset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    assert(dataset_id >= 0 && "Dataset introuvable");
+    unsigned char* pixels = malloc(IMAGE_BYTES);
+    assert(H5Dread(dataset_id, H5T_NATIVE_UCHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, pixels) >= 0 &&
+           "Lecture de l'image a échoué");
+    assert(memcmp(pixels, expected, IMAGE_BYTES) == 0 && "Image relue différente");
+    free(pixels);
+    H5Dclose(dataset_id);
+    H5Fclose(file_id);
+}
+
+/* Vérifie que seules les tuiles marquées ont changé de place (réécrites) */
+static void check_untouched(const haddr_t* before, const haddr_t* after, const int* rewritten) {
+    for (int i = 0; i < TILES_X * TILES_Y; i++) {
+        if (!rewritten[i]) {
+            assert(before[i] == after[i] && "Une tuile inchangée a été réécrite");
+        }
+    }
+}
+
+static void paint(unsigned char* image, size_t x, size_t y, size_t w, size_t h,
+                  unsigned char value) {
+    for (size_t r = y; r < y + h; r++) {
+        for (size_t c = x; c < x + w; c++) {
+            for (int k = 0; k < CHANNELS; k++) {
+                image[(r * WIDTH + c) * CHANNELS + k] = (unsigned char)(value + k);
+            }
+        }
+    }
+}
+
+static void run_updates(hdf5_logger_t* logger, const char* filename, unsigned char* image) {
+    haddr_t before[TILES_X * TILES_Y];
+    haddr_t after[TILES_X * TILES_Y];
+    int rewritten[TILES_X * TILES_Y];
+
+    // Première mise à jour : image entière
+    int status = hdf5_log_image_update(logger, "/camera", "scene", image, WIDTH, HEIGHT, CHANNELS,
+                                       HDF5_DTYPE_UINT8, NULL, 0);
+    assert(status == 0 && "Première mise à jour a échoué");
+    hdf5_logger_flush(logger);
+    chunk_addresses(filename, "/camera/scene", before);
+
+    // Petit objet dans la tuile (2, 1), trouvé par comparaison
+    paint(image, 300, 200, 10, 10, 200);
+    status = hdf5_log_image_update(logger, "/camera", "scene", image, WIDTH, HEIGHT, CHANNELS,
+                                   HDF5_DTYPE_UINT8, NULL, 0);
+    assert(status == 0 && "Mise à jour par comparaison a échoué");
+    hdf5_logger_flush(logger);
+    check_image(filename, "/camera/scene", image);
+    chunk_addresses(filename, "/camera/scene", after);
+    memset(rewritten, 0, sizeof(rewritten));
+    rewritten[1 * TILES_X + 2] = 1;
+    check_untouched(before, after, rewritten);
+
+    // Image inchangée : aucune tuile réécrite
+    memcpy(before, after, sizeof(after));
+    status = hdf5_log_image_update(logger, "/camera", "scene", image, WIDTH, HEIGHT, CHANNELS,
+                                   HDF5_DTYPE_UINT8, NULL, 0);
+    assert(status == 0 && "Mise à jour sans changement a échoué");
+    hdf5_logger_flush(logger);
+    chunk_addresses(filename, "/camera/scene", after);
+    memset(rewritten, 0, sizeof(rewritten));
+    check_untouched(before, after, rewritten);
+
+    // Région fournie, à cheval sur quatre tuiles dont celles du bord droit et du bas
+    memcpy(before, after, sizeof(after));
+    paint(image, 900, 600, 100, 100, 50);
+    hdf5_image_rect_t rects[2] = {{900, 600, 100, 100}, {0, 0, 0, 0}};
+    status = hdf5_log_image_update(logger, "/camera", "scene", image, WIDTH, HEIGHT, CHANNELS,
+                                   HDF5_DTYPE_UINT8, rects, 2);
+    assert(status == 0 && "Mise à jour par régions a échoué");
+    hdf5_logger_flush(logger);
+    check_image(filename, "/camera/scene", image);
+    chunk_addresses(filename, "/camera/scene", after);
+    memset(rewritten, 0, sizeof(rewritten));
+    rewritten[4 * TILES_X + 7] = rewritten[5 * TILES_X + 7] = 1;
+    check_untouched(before, after, rewritten);
+
+    // Changement hors des régions déclarées : non écrit, puis trouvé par la comparaison suivante
+    unsigned char* written = malloc(IMAGE_BYTES);
+    memcpy(written, image, IMAGE_BYTES);
+    paint(image, 0, 0, 4, 4, 9);
+    paint(image, 500, 300, 4, 4, 90);
+    paint(written, 500, 300, 4, 4, 90);
+    hdf5_image_rect_t one = {500, 300, 4, 4};
+    status = hdf5_log_image_update(logger, "/camera", "scene", image, WIDTH, HEIGHT, CHANNELS,
+                                   HDF5_DTYPE_UINT8, &one, 1);
+    assert(status == 0 && "Mise à jour par région a échoué");
+    hdf5_logger_flush(logger);
+    check_image(filename, "/camera/scene", written);
+    status = hdf5_log_image_update(logger, "/camera", "scene", image, WIDTH, HEIGHT, CHANNELS,
+                                   HDF5_DTYPE_UINT8, NULL, 0);
+    assert(status == 0 && "Mise à jour par comparaison a échoué");
+    hdf5_logger_flush(logger);
+    check_image(filename, "/camera/scene", image);
+    free(written);
+
+    // Régions hors de l'image refusées
+    hdf5_image_rect_t outside = {990, 0, 11, 1};
+    assert(hdf5_log_image_update(logger, "/camera", "scene", image, WIDTH, HEIGHT, CHANNELS,
+                                 HDF5_DTYPE_UINT8, &outside, 1) == -1 &&
+           "Une région hors de l'image devrait être refusée");
+    assert(hdf5_log_image_update(logger, "/camera", "scene", image, WIDTH, HEIGHT, CHANNELS,
+                                 HDF5_DTYPE_UINT8, NULL, 3) == -1 &&
+           "Des régions absentes devraient être refusées");
+}
+
+int main() {
+    printf("Test de la mise à jour des tuiles d'une image\n");
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    unsigned char* image = malloc(IMAGE_BYTES);
+    unsigned char* initial = malloc(IMAGE_BYTES);
+    for (size_t i = 0; i < IMAGE_BYTES; i++) {
+        initial[i] = (unsigned char)((i * 7) ^ (i >> 11));
+    }
+
+    // Mode synchrone
+    remove("test_tile.h5");
+    hdf5_logger_t* logger = hdf5_logger_init("test_tile.h5");
+    assert(logger != NULL && "L'initialisation du logger a échoué");
+    memcpy(image, initial, IMAGE_BYTES);
+    run_updates(logger, "test_tile.h5", image);
+
+    // Dataset remplacé par hdf5_log_image : l'image gardée est oubliée et relue
+    int status = hdf5_log_image(logger, "/camera", "scene", initial, WIDTH, HEIGHT, CHANNELS);
+    memcpy(image, initial, IMAGE_BYTES);
+    paint(image, 10, 10, 1, 1, 1);
+    status |= hdf5_log_image_update(logger, "/camera", "scene", image, WIDTH, HEIGHT, CHANNELS,
+                                    HDF5_DTYPE_UINT8, NULL, 0);
+    assert(status == 0 && "Mise à jour après remplacement a échoué");
+    hdf5_logger_flush(logger);
+    check_image("test_tile.h5", "/camera/scene", image);
+
+    // Image partagée par la déduplication : l'autre nom garde son contenu
+    assert(hdf5_logger_set_dedup(logger, 1) == 0 && "Activation de la déduplication a échoué");
+    status = hdf5_log_image(logger, "/camera", "left", initial, WIDTH, HEIGHT, CHANNELS);
+    status |= hdf5_log_image(logger, "/camera", "right", initial, WIDTH, HEIGHT, CHANNELS);
+    status |= hdf5_log_image_update(logger, "/camera", "right", image, WIDTH, HEIGHT, CHANNELS,
+                                    HDF5_DTYPE_UINT8, NULL, 0);
+    assert(status == 0 && "Mise à jour d'une image partagée a échoué");
+    hdf5_logger_flush(logger);
+    check_image("test_tile.h5", "/camera/left", initial);
+    check_image("test_tile.h5", "/camera/right", image);
+
+    // Forme différente : dataset récrit en entier (niveaux de gris 16 bits)
+    uint16_t* gray = malloc((size_t)WIDTH * HEIGHT * sizeof(uint16_t));
+    for (size_t i = 0; i < (size_t)WIDTH * HEIGHT; i++) {
+        gray[i] = (uint16_t)(i * 13);
+    }
+    status = hdf5_log_image_update(logger, "/camera", "scene", gray, WIDTH, HEIGHT, 1,
+                                   HDF5_DTYPE_UINT16, NULL, 0);
+    gray[123456] ^= 0x8000;
+    status |= hdf5_log_image_update(logger, "/camera", "scene", gray, WIDTH, HEIGHT, 1,
+                                    HDF5_DTYPE_UINT16, NULL, 0);
+    assert(status == 0 && "Mise à jour d'une image 16 bits a échoué");
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+
+    hid_t file_id = H5Fopen("test_tile.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t dataset_id = H5Dopen2(file_id, "/camera/scene", H5P_DEFAULT);
+    uint16_t* read_back = malloc((size_t)WIDTH * HEIGHT * sizeof(uint16_t));
+    assert(H5Dread(dataset_id, H5T_NATIVE_UINT16, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                   read_back) >= 0 &&
+           memcmp(read_back, gray, (size_t)WIDTH * HEIGHT * sizeof(uint16_t)) == 0 &&
+           "Image 16 bits relue différente");
+    free(read_back);
+    H5Dclose(dataset_id);
+    H5Fclose(file_id);
+
+    // Nouvelle session : l'image précédente est relue du fichier
+    logger = hdf5_logger_init("test_tile.h5");
+    assert(logger != NULL && "La réouverture du logger a échoué");
+    memcpy(image, initial, IMAGE_BYTES);
+    paint(image, 10, 10, 1, 1, 1);
+    paint(image, 640, 500, 3, 3, 77);
+    status = hdf5_log_image_update(logger, "/camera", "right", image, WIDTH, HEIGHT, CHANNELS,
+                                   HDF5_DTYPE_UINT8, NULL, 0);
+    assert(status == 0 && "Mise à jour après réouverture a échoué");
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger a échoué");
+    check_image("test_tile.h5", "/camera/right", image);
+
+    // Mode asynchrone : comparaison et écriture faites par le thread d'écriture
+    remove("test_tile_async.h5");
+    logger = hdf5_logger_init_async("test_tile_async.h5", NULL);
+    assert(logger != NULL && "L'initialisation du logger asynchrone a échoué");
+    memcpy(image, initial, IMAGE_BYTES);
+    run_updates(logger, "test_tile_async.h5", image);
+    status = hdf5_logger_close(logger);
+    assert(status == 0 && "La fermeture du logger asynchrone a échoué");
+    check_image("test_tile_async.h5", "/camera/scene", image);
+
+    free(gray);
+    free(initial);
+    free(image);
+    printf("Tests de la mise à jour des tuiles réussis!\n");
+    return 0;
+}
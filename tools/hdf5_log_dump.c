@@ -0,0 +1,143 @@
+/**
+ * @file hdf5_log_dump.c
+ * @brief Affiche les logs texte d'un fichier, messages à formatage différé reconstitués
+ *
+ * Usage : hdf5_log_dump fichier.h5 [groupe...]
+ *
+ * Sans groupe, tous les groupes de logs texte du fichier sont affichés.
+ * Le fichier est ouvert en lecture seule et n'est jamais modifié.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdf5.h"
+#include "../include/hdf5_logger.h"
+
+/* Liste des groupes de logs texte trouvés dans le fichier */
+typedef struct {
+    char** paths;
+    size_t count;
+    size_t capacity;
+} group_list_t;
+
+static const char* level_name(hdf5_log_level_t level) {
+    switch (level) {
+        case HDF5_LOG_DEBUG:    return "DEBUG";
+        case HDF5_LOG_INFO:     return "INFO";
+        case HDF5_LOG_WARNING:  return "WARNING";
+        case HDF5_LOG_ERROR:    return "ERROR";
+        case HDF5_LOG_CRITICAL: return "CRITICAL";
+        default:                return "?";
+    }
+}
+
+static int print_entry(const hdf5_text_entry_t* entry, void* user_data) {
+    (void)user_data;
+    printf("%.6f %-8s #%llu %s\n", entry->timestamp, level_name(entry->level),
+           entry->sequence, entry->message);
+    return 0;
+}
+
+static int add_group(group_list_t* list, const char* path) {
+    if (list->count == list->capacity) {
+        size_t capacity = (list->capacity == 0) ? 8 : list->capacity * 2;
+        char** paths = realloc(list->paths, capacity * sizeof(char*));
+        if (paths == NULL) {
+            return -1;
+        }
+        list->paths = paths;
+        list->capacity = capacity;
+    }
+
+    /* H5Ovisit donne des noms relatifs à la racine */
+    size_t length = strlen(path);
+    char* copy = malloc(length + 2);
+    if (copy == NULL) {
+        return -1;
+    }
+    copy[0] = '/';
+    memcpy(copy + 1, path, length + 1);
+    list->paths[list->count++] = copy;
+    return 0;
+}
+
+/* Un sous-groupe segment_<n> appartient au groupe segmenté qui le contient */
+static int is_segment(hid_t object_id, const char* name) {
+    const char* slash = strrchr(name, '/');
+    if (slash == NULL) {
+        return 0;
+    }
+
+    char parent[1024];
+    snprintf(parent, sizeof(parent), "%.*s", (int)(slash - name), name);
+    return H5Aexists_by_name(object_id, parent, "segment_seconds", H5P_DEFAULT) > 0;
+}
+
+/* Un groupe de logs texte porte l'attribut de disposition ou l'ancien dataset */
+static herr_t visit_object(hid_t object_id, const char* name, const H5O_info_t* info,
+                           void* user_data) {
+    if (info->type != H5O_TYPE_GROUP || strcmp(name, ".") == 0 || is_segment(object_id, name)) {
+        return 0;
+    }
+
+    char legacy[1024];
+    snprintf(legacy, sizeof(legacy), "%s/log_entries", name);
+    if (H5Aexists_by_name(object_id, name, "text_layout_version", H5P_DEFAULT) > 0 ||
+        H5Lexists(object_id, legacy, H5P_DEFAULT) > 0) {
+        return add_group((group_list_t*)user_data, name) < 0 ? -1 : 0;
+    }
+    return 0;
+}
+
+static int find_groups(const char* filename, group_list_t* list) {
+    hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file_id < 0) {
+        return -1;
+    }
+
+    herr_t status = H5Ovisit(file_id, H5_INDEX_NAME, H5_ITER_INC, visit_object, list);
+    H5Fclose(file_id);
+    return status < 0 ? -1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage : %s fichier.h5 [groupe...]\n", argv[0]);
+        return 2;
+    }
+
+    const char* filename = argv[1];
+    if (H5Fis_hdf5(filename) <= 0) {
+        fprintf(stderr, "%s n'est pas un fichier HDF5\n", filename);
+        return 1;
+    }
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    group_list_t list = {NULL, 0, 0};
+    if (argc > 2) {
+        for (int i = 2; i < argc; i++) {
+            if (add_group(&list, argv[i][0] == '/' ? argv[i] + 1 : argv[i]) < 0) {
+                return 1;
+            }
+        }
+    } else if (find_groups(filename, &list) < 0) {
+        fprintf(stderr, "Lecture de %s impossible\n", filename);
+        return 1;
+    }
+
+    /* Le fichier est lu en lecture seule : ni création de groupes, ni purge */
+    int result = 0;
+    for (size_t i = 0; i < list.count; i++) {
+        printf("== %s\n", list.paths[i]);
+        if (hdf5_logger_read_text_file(filename, list.paths[i], print_entry, NULL) != 0) {
+            fprintf(stderr, "Lecture du groupe %s impossible\n", list.paths[i]);
+            result = 1;
+        }
+        free(list.paths[i]);
+    }
+    free(list.paths);
+
+    return result;
+}